@@ -15,6 +15,7 @@
 #endif
 #define LOG_PREFIX "api"
 #include "logging/logging.h"
+#include "logging/perfstats.h"
 
 #include "marfs.h"
 #include "datastream/datastream.h"
@@ -41,6 +42,42 @@
 #error "MarFS directory NS offset bit position is invalid!"
 #endif
 #define MARFS_DIR_NS_OFFSET_MASK (long)( 1L << MARFS_DIR_NS_OFFSET_BIT )
+#if MARFS_STAT_ALL != MDAL_STAT_ALL
+#error "MARFS_STAT_* mask values must match MDAL_STAT_* mask values"
+#endif
+#define MARFS_READDIRPLUS_BATCH 256 // max number of entries requested from the MDAL per readdirplus() call
+
+// maximum number of idle positional read cursors to be cached by each marfs_fhandle
+// ( each holds an open object handle, so we don't want to keep too many around )
+#define MARFS_PREAD_CURSORS 8
+
+// minimum size of the write-behind buffer of each create marfs_fhandle
+// ( the actual size is rounded up to a multiple of the erasure stripe width )
+#define MARFS_WRITEBUF_SIZE ( 1024 * 1024 )
+
+// count of shared CREATE_STREAMs, per marfs_ctxt, onto which the small files of concurrent
+// marfs_creat() callers may be packed ( see marfs_setpacking() )
+#define MARFS_PACK_STREAMS 4
+
+// count of creators which may queue for a single shared stream, before another is begun
+#define MARFS_PACK_QUEUE 8
+
+// outcome of a shared data stream, produced by packing the files of concurrent creators
+typedef struct marfs_packbatch_struct {
+   char               done; // set once the shared stream has been closed
+   int              result; // result of closing the shared stream
+   int              errnum; // errno value of a failed close
+   size_t             refs; // count of creators referencing this batch
+} marfs_packbatch;
+
+typedef struct marfs_packslot_struct {
+   DATASTREAM       stream; // shared CREATE_STREAM ( NULL if not yet begun )
+   char*              nsid; // NS of the stream
+   marfs_packbatch*  batch; // batch of files written to the current stream
+   size_t            files; // count of files written to the current stream
+   size_t           queued; // count of creators assigned to the slot, but not yet written
+   char               busy; // set while a creator is writing to the stream
+} marfs_packslot;
 
 typedef struct marfs_ctxt_struct {
    pthread_mutex_t        lock; // for serializing access to this structure (if necessary)
@@ -48,8 +85,23 @@ typedef struct marfs_ctxt_struct {
    marfs_interface       itype;
    marfs_position          pos;
    pthread_mutex_t erasurelock; // for serializing libNE erasure functions (if necessary)
+   pthread_mutex_t    packlock; // for serializing access to all packing state below
+   pthread_cond_t     packcond; // for signaling any change of packing state
+   size_t             packsize; // max size of a packed file ( zero if packing is disabled )
+   unsigned int     packlinger; // max msec to wait for further files to join a shared stream
+   size_t             packopen; // count of deferred create handles, not yet written out
+   marfs_packslot    packslots[MARFS_PACK_STREAMS];
 }* marfs_ctxt;
 
+// deferred creation info of a file to be packed via a shared stream
+typedef struct marfs_packinfo_struct {
+   marfs_ctxt         ctxt; // ctxt of the creating call ( owner of the shared streams )
+   char*           subpath; // NS subpath of the file
+   marfs_position      pos; // position of the file
+   mode_t             mode; // mode value of the file
+   size_t          maxsize; // size limit of the file, beyond which it will not be packed
+} marfs_packinfo;
+
 typedef struct marfs_fhandle_struct {
    pthread_mutex_t    lock; // for serializing access to this structure (if necessary)
    int               flags; // open flags for this file handle
@@ -58,6 +110,15 @@ typedef struct marfs_fhandle_struct {
    marfs_ns*            ns; // reference to the containing NS
    marfs_interface   itype; // itype of creating ctxt ( for perm checks )
    size_t    dataremaining; // available data quota
+   pthread_cond_t  preadcond; // for signaling completion of parallel positional reads
+   size_t          preaders; // count of positional reads currently in progress
+   size_t         curscount; // count of idle cursors cached for positional reads
+   DATASTREAM_CURSOR cursors[MARFS_PREAD_CURSORS]; // idle positional read cursors
+   void*              wbuf; // write-behind buffer, for coalescing small sequential writes
+   size_t         wbufsize; // allocated size of the write-behind buffer
+   size_t          wbuflen; // count of buffered bytes not yet passed to the datastream
+   int            wbuferrno; // errno value of a deferred write failure ( zero if none )
+   marfs_packinfo*    pack; // deferred creation info of a packed file ( NULL if not deferred )
 }* marfs_fhandle;
 
 typedef struct marfs_dhandle_struct {
@@ -131,6 +192,86 @@ void pathcleanup( char* subpath, marfs_position* oppos ) {
    if ( subpath ) { free( subpath ); }
 }
 
+/**
+ * Adjust MDAL stat values of a non-NS target, to reflect the MarFS file
+ * @param struct stat* buf : Stat struct to be adjusted
+ */
+void statadjust( struct stat* buf ) {
+   if ( S_ISREG( buf->st_mode ) ) {
+      // regular files may need link count adjusted to ignore ref path
+      if ( buf->st_nlink > 1 ) { buf->st_nlink--; }
+      if ( buf->st_size ) {
+         // assume allocated blocks, based on logical file size ( saves us having to pull an FTAG xattr )
+         blkcnt_t estblocks = ( buf->st_size / 512 ) + ( (buf->st_size % 512) ? 1 : 0 );
+         if ( estblocks > buf->st_blocks ) { buf->st_blocks = estblocks; }
+      }
+   }
+}
+
+/**
+ * Populate the subspace dirent of the given NS root dir handle with its next subspace entry
+ * NOTE -- Caller must hold the marfs_dhandle lock, and the handle must not have completed
+ *         its subspace listing
+ * @param marfs_dhandle dh : marfs_dhandle to iterate
+ * @param struct stat* st : Reference to be populated with subspace stat info ( may be NULL )
+ * @return int : One if the subspace dirent was populated, zero if no subspaces remain,
+ *               or -1 if a failure occurred
+ */
+int nextsubspace( marfs_dhandle dh, struct stat* st ) {
+   struct stat stval;
+   if ( st == NULL ) { st = &(stval); }
+   while ( dh->location < dh->ns->subnodecount ) {
+      // stat the subspace, to identify inode info
+      marfs_ns* tgtsubspace = (marfs_ns *)(dh->ns->subnodes[dh->location].content);
+      char* subspacepath = NULL;
+      if ( config_nsinfo( tgtsubspace->idstr, NULL, &(subspacepath) ) ) {
+         LOG( LOG_ERR, "Failed to identify NS path of subspace: \"%s\"\n",
+              tgtsubspace->idstr );
+         return -1;
+      }
+      // stat the subspace, to check for existence
+      MDAL tgtmdal = tgtsubspace->prepo->metascheme.mdal;
+      int stnsres = tgtmdal->statnamespace( tgtmdal->ctxt, subspacepath, st );
+      if ( stnsres  &&  errno != ENOENT ) {
+         LOG( LOG_ERR, "Failed to stat subspace root: \"%s\"\n", subspacepath );
+         free( subspacepath );
+         return -1;
+      }
+      free( subspacepath );
+      if ( stnsres == 0 ) {
+         // note subspaces in link count, just as marfs_stat() would
+         st->st_nlink += tgtsubspace->subnodecount;
+         // populate the subspace dirent
+         if ( snprintf( dh->subspcent.d_name, dh->subspcnamealloc, "%s", dh->ns->subnodes[dh->location].name ) >= dh->subspcnamealloc ) {
+            LOG( LOG_ERR, "Dirent struct does not have sufficient space to store subspace name: \"%s\" (%zu bytes available)\n", dh->ns->subnodes[dh->location].name, dh->subspcnamealloc );
+            errno = ENAMETOOLONG;
+            return -1;
+         }
+         dh->subspcent.d_ino = st->st_ino;
+         dh->subspcent.d_type = DT_DIR;
+         // increment our index
+         dh->location++;
+         if ( dh->location & MARFS_DIR_NS_OFFSET_MASK ) {
+            if ( dh->location != dh->ns->subnodecount ) {
+               // indicate that our location has become invalid
+               dh->location = MARFS_DIR_NS_OFFSET_MASK | 1L;
+               LOG( LOG_ERR, "This readdir op has resulted in an excessive dir handle location value\n" );
+            }
+            else {
+               // overwrite our location, to indicate that we have finished subspace listing
+               dh->location = MARFS_DIR_NS_OFFSET_MASK;
+            }
+         }
+         return 1;
+      }
+      // increment our index
+      dh->location++;
+   }
+   // overwrite our location, to indicate that we have finished subspace listing
+   dh->location = MARFS_DIR_NS_OFFSET_MASK;
+   return 0;
+}
+
 /**
  * Allocate and initialize a new struct marfs_fhandle_struct.
  */
@@ -146,10 +287,394 @@ marfs_fhandle new_marfs_fhandle( void ) {
       free( fh );
       return NULL;
    }
+   if ( pthread_cond_init( &(fh->preadcond), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize pread condition of new marfs_fhandle struct\n" );
+      pthread_mutex_destroy( &(fh->lock) );
+      free( fh );
+      return NULL;
+   }
 
    return fh;
 }
 
+/**
+ * Pass all content of the write-behind buffer of the given marfs_fhandle to its datastream
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be flushed
+ * @return int : Zero on success, or -1 if any buffered write has failed ( either now or
+ *               previously ), with errno set to that of the original failure
+ */
+int flush_writebuf( marfs_fhandle stream ) {
+   // the data of a deferred packed file is only ever written out by pack_commit()
+   if ( stream->pack ) { return 0; }
+   if ( stream->wbuflen ) {
+      if ( stream->datastream == NULL ) {
+         LOG( LOG_ERR, "Write-behind buffer holds %zu bytes, but no datastream remains\n", stream->wbuflen );
+         stream->wbuferrno = EBADFD;
+      }
+      else {
+         LOG( LOG_INFO, "Flushing %zu bytes of write-behind buffer\n", stream->wbuflen );
+         errno = 0;
+         ssize_t writeres = datastream_write( &(stream->datastream), stream->wbuf, stream->wbuflen );
+         if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
+         if ( writeres < 0  ||  (size_t)writeres != stream->wbuflen ) {
+            LOG( LOG_ERR, "Failed to flush write-behind buffer ( %zd of %zu bytes written )\n",
+                 writeres, stream->wbuflen );
+            stream->wbuferrno = (errno) ? errno : EIO;
+         }
+      }
+      stream->wbuflen = 0; // never reattempt a failed flush
+   }
+   if ( stream->wbuferrno ) {
+      errno = stream->wbuferrno;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Write to the datastream of the given create marfs_fhandle, via its write-behind buffer
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be written to
+ * @param const void* buf : Reference to the buffer containing data to be written
+ * @param size_t size : Number of bytes to be written
+ * @return ssize_t : Number of bytes accepted, or -1 on failure
+ */
+ssize_t buffered_write( marfs_fhandle stream, const void* buf, size_t size ) {
+   // lazily allocate our buffer, sized to a multiple of the erasure stripe width
+   if ( stream->wbuf == NULL ) {
+      const ne_erasure* erasure = &(stream->datastream->ns->prepo->datascheme.protection);
+      size_t stripesize = erasure->N * erasure->partsz;
+      if ( stripesize == 0 ) { stripesize = 1; }
+      stream->wbufsize = ( (MARFS_WRITEBUF_SIZE + stripesize - 1) / stripesize ) * stripesize;
+      if ( size < stream->wbufsize ) {
+         stream->wbuf = malloc( stream->wbufsize );
+         if ( stream->wbuf == NULL ) {
+            LOG( LOG_WARNING, "Failed to allocate a %zu byte write-behind buffer\n", stream->wbufsize );
+            stream->wbufsize = 0;
+         }
+      }
+   }
+   size_t accepted = 0;
+   while ( accepted < size ) {
+      // large writes bypass the buffer entirely, in buffer-sized increments
+      if ( stream->wbuflen == 0  &&  ( stream->wbuf == NULL  ||  (size - accepted) >= stream->wbufsize ) ) {
+         size_t towrite = size - accepted;
+         if ( stream->wbuf ) { towrite -= ( towrite % stream->wbufsize ); }
+         ssize_t writeres = datastream_write( &(stream->datastream), buf + accepted, towrite );
+         if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
+         if ( writeres < 0 ) { return (accepted) ? accepted : -1; }
+         accepted += writeres;
+         if ( (size_t)writeres != towrite ) { return accepted; }
+         continue;
+      }
+      // otherwise, copy as much as we can into the buffer
+      size_t tocopy = stream->wbufsize - stream->wbuflen;
+      if ( tocopy > (size - accepted) ) { tocopy = size - accepted; }
+      memcpy( stream->wbuf + stream->wbuflen, buf + accepted, tocopy );
+      stream->wbuflen += tocopy;
+      accepted += tocopy;
+      // pass along a full buffer
+      if ( stream->wbuflen == stream->wbufsize  &&  flush_writebuf( stream ) ) {
+         LOG( LOG_ERR, "Failed to flush a full write-behind buffer\n" );
+         return -1;
+      }
+   }
+   return accepted;
+}
+
+/**
+ * Wait for all in-progress positional reads of the given marfs_fhandle to complete
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be quiesced
+ * @param char releasecursors : If non-zero, also release all cached positional read cursors
+ *                              ( required prior to any close / release / retarget of the
+ *                              underlying datastream )
+ * @return int : Zero on success, or -1 if a cursor could not be cleanly released
+ */
+int quiesce_preads( marfs_fhandle stream, char releasecursors ) {
+   while ( stream->preaders ) {
+      LOG( LOG_INFO, "Waiting on %zu in-progress positional reads\n", stream->preaders );
+      pthread_cond_wait( &(stream->preadcond), &(stream->lock) );
+   }
+   int retval = 0;
+   if ( releasecursors ) {
+      while ( stream->curscount ) {
+         stream->curscount--;
+         // NOTE -- with no datastream remaining, this will simply abort the cursor's object handle
+         if ( datastream_releasecursor( stream->datastream, stream->cursors + stream->curscount ) ) {
+            LOG( LOG_ERR, "Failed to release positional read cursor %zu\n", stream->curscount );
+            retval = -1;
+         }
+      }
+   }
+   return retval;
+}
+
+/**
+ * Note the completion of a positional read of the given marfs_fhandle, waking any thread
+ * waiting to quiesce the handle
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be updated
+ */
+void pread_complete( marfs_fhandle stream ) {
+   stream->preaders--;
+   if ( stream->preaders == 0 ) {
+      pthread_cond_broadcast( &(stream->preadcond) );
+   }
+}
+
+/**
+ * Free the deferred creation info of the given marfs_fhandle
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be updated
+ * @param char written : Flag indicating that the file has already been written out
+ *                       ( and is therefore no longer counted as open by the ctxt )
+ */
+void pack_free( marfs_fhandle stream, char written ) {
+   marfs_packinfo* pack = stream->pack;
+   if ( !(written) ) {
+      pthread_mutex_lock( &(pack->ctxt->packlock) );
+      pack->ctxt->packopen--;
+      pthread_cond_broadcast( &(pack->ctxt->packcond) ); // may allow a waiting batch to close
+      pthread_mutex_unlock( &(pack->ctxt->packlock) );
+   }
+   pathcleanup( pack->subpath, &(pack->pos) );
+   free( pack );
+   stream->pack = NULL;
+}
+
+/**
+ * Create the deferred packed file of the given marfs_fhandle via a dedicated datastream,
+ * converting the handle into a standard create marfs_fhandle
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be converted
+ * @return int : Zero on success, or -1 on failure
+ */
+int pack_resolve( marfs_fhandle stream ) {
+   marfs_packinfo* pack = stream->pack;
+   LOG( LOG_INFO, "Creating deferred packed file \"%s\" via a dedicated datastream\n", pack->subpath );
+   int retval = datastream_create( &(stream->datastream), pack->subpath, &(pack->pos), pack->mode, pack->ctxt->config->ctag );
+   int origerrno = errno;
+   pack_free( stream, 0 );
+   if ( retval ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      stream->datastream = NULL;
+      stream->wbuflen = 0;
+      errno = origerrno;
+      return -1;
+   }
+   stream->metahandle = stream->datastream->files[stream->datastream->curfile].metahandle;
+   // pass along any deferred data, and allow the write-behind buffer to be resized normally
+   retval = flush_writebuf( stream );
+   free( stream->wbuf );
+   stream->wbuf = NULL;
+   stream->wbufsize = 0;
+   return retval;
+}
+
+/**
+ * Create the deferred packed file of the given marfs_fhandle, if any
+ * NOTE -- Caller must NOT hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be checked
+ * @return int : Zero on success, or -1 on failure
+ */
+int pack_lockresolve( marfs_fhandle stream ) {
+   if ( pthread_mutex_lock( &(stream->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_fhandle lock\n" );
+      return -1;
+   }
+   int retval = 0;
+   if ( stream->pack ) { retval = pack_resolve( stream ); }
+   pthread_mutex_unlock( &(stream->lock) );
+   return retval;
+}
+
+/**
+ * Write to the deferred packed file of the given marfs_fhandle, creating that file via a
+ * dedicated datastream if it outgrows the packing size limit
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be written to
+ * @param const void* buf : Reference to the buffer containing data to be written
+ * @param size_t size : Number of bytes to be written
+ * @return ssize_t : Number of bytes accepted, or -1 on failure
+ */
+ssize_t pack_write( marfs_fhandle stream, const void* buf, size_t size ) {
+   size_t packsize = stream->pack->maxsize;
+   if ( stream->wbuflen + size > packsize ) {
+      LOG( LOG_INFO, "Deferred packed file has outgrown the packing size limit\n" );
+      if ( pack_resolve( stream ) ) { return -1; }
+      return buffered_write( stream, buf, size );
+   }
+   // grow our buffer geometrically, up to the packing size limit
+   if ( stream->wbuflen + size > stream->wbufsize ) {
+      size_t newsize = ( stream->wbufsize ) ? stream->wbufsize * 2 : 4096;
+      if ( newsize < stream->wbuflen + size ) { newsize = stream->wbuflen + size; }
+      if ( newsize > packsize ) { newsize = packsize; }
+      void* newbuf = realloc( stream->wbuf, newsize );
+      if ( newbuf == NULL ) {
+         LOG( LOG_ERR, "Failed to expand deferred packed file buffer to %zu bytes\n", newsize );
+         return -1;
+      }
+      stream->wbuf = newbuf;
+      stream->wbufsize = newsize;
+   }
+   memcpy( stream->wbuf + stream->wbuflen, buf, size );
+   stream->wbuflen += size;
+   return size;
+}
+
+/**
+ * Write out the deferred packed file of the given marfs_fhandle via a shared stream of its
+ * ctxt, then wait for that stream to be closed ( by whichever creator closes it first )
+ * NOTE -- If any file of the batch cannot be written, or the shared stream cannot be closed,
+ *         the entire batch fails, and every creator removes its file again
+ * NOTE -- Caller must hold the marfs_fhandle lock
+ * @param marfs_fhandle stream : marfs_fhandle to be written out
+ * @return int : Zero on success ( the file is complete ), or -1 on failure
+ */
+int pack_commit( marfs_fhandle stream ) {
+   marfs_packinfo* pack = stream->pack;
+   marfs_ctxt ctxt = pack->ctxt;
+   size_t objfiles = stream->ns->prepo->datascheme.objfiles;
+   pthread_mutex_lock( &(ctxt->packlock) );
+   // join the least contended slot of our NS, only beginning another once all are well queued
+   marfs_packslot* slot = NULL;
+   while ( slot == NULL ) {
+      marfs_packslot* idle = NULL;
+      int index = 0;
+      for ( ; index < MARFS_PACK_STREAMS; index++ ) {
+         marfs_packslot* cur = ctxt->packslots + index;
+         if ( cur->stream == NULL  &&  cur->queued == 0 ) {
+            if ( idle == NULL ) { idle = cur; }
+         }
+         else if ( strcmp( cur->nsid, stream->ns->idstr ) == 0  &&
+                   ( slot == NULL  ||  cur->queued < slot->queued ) ) {
+            slot = cur;
+         }
+      }
+      if ( idle  &&  ( slot == NULL  ||  slot->queued >= MARFS_PACK_QUEUE ) ) {
+         char* nsid = strdup( stream->ns->idstr );
+         if ( nsid == NULL ) {
+            LOG( LOG_ERR, "Failed to duplicate NS ID of a new shared stream\n" );
+            pthread_mutex_unlock( &(ctxt->packlock) );
+            int origerrno = errno;
+            pack_free( stream, 0 );
+            errno = origerrno;
+            return -1;
+         }
+         free( idle->nsid );
+         idle->nsid = nsid;
+         slot = idle;
+      }
+      if ( slot == NULL ) { pthread_cond_wait( &(ctxt->packcond), &(ctxt->packlock) ); }
+   }
+   slot->queued++;
+   while ( slot->busy ) { pthread_cond_wait( &(ctxt->packcond), &(ctxt->packlock) ); }
+   if ( slot->batch == NULL  &&  (slot->batch = calloc( 1, sizeof( struct marfs_packbatch_struct ) )) == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new packing batch\n" );
+      slot->queued--;
+      pthread_cond_broadcast( &(ctxt->packcond) );
+      pthread_mutex_unlock( &(ctxt->packlock) );
+      int origerrno = errno;
+      pack_free( stream, 0 );
+      errno = origerrno;
+      return -1;
+   }
+   marfs_packbatch* batch = slot->batch;
+   batch->refs++;
+   slot->busy = 1;
+   pthread_mutex_unlock( &(ctxt->packlock) );
+
+   // append our file to the shared stream
+   LOG( LOG_INFO, "Writing out deferred packed file \"%s\" ( %zu bytes ) via shared stream %zu\n",
+        pack->subpath, stream->wbuflen, (size_t)(slot - ctxt->packslots) );
+   int retval = datastream_create( &(slot->stream), pack->subpath, &(pack->pos), pack->mode, ctxt->config->ctag );
+   int errnum = errno;
+   char created = ( retval == 0 ) ? 1 : 0;
+   if ( created  &&  stream->wbuflen ) {
+      errno = 0;
+      ssize_t writeres = datastream_write( &(slot->stream), stream->wbuf, stream->wbuflen );
+      if ( writeres < 0  ||  (size_t)writeres != stream->wbuflen ) {
+         LOG( LOG_ERR, "Failed to write deferred packed file ( %zd of %zu bytes written )\n",
+              writeres, stream->wbuflen );
+         errnum = (errno) ? errno : EIO;
+         retval = -1;
+         // the shared stream now holds an incomplete file, which must never be completed
+         if ( slot->stream  &&  datastream_release( &(slot->stream) ) ) {
+            LOG( LOG_WARNING, "Failed to release shared stream following a write failure\n" );
+         }
+         slot->stream = NULL;
+      }
+   }
+   stream->wbuflen = 0;
+
+   // wait for the shared stream to be closed, closing it ourself if no further files are expected
+   pthread_mutex_lock( &(ctxt->packlock) );
+   slot->busy = 0;
+   slot->queued--;
+   ctxt->packopen--;
+   if ( slot->stream == NULL ) {
+      // the shared stream has been lost, along with every file of the batch
+      LOG( LOG_ERR, "Shared stream %zu has been lost\n", (size_t)(slot - ctxt->packslots) );
+      slot->batch = NULL;
+      slot->files = 0;
+      batch->done = 1;
+      batch->result = -1;
+      batch->errnum = ( retval ) ? errnum : EBADFD;
+   }
+   else if ( created ) { slot->files++; }
+   pthread_cond_broadcast( &(ctxt->packcond) );
+   struct timespec deadline;
+   clock_gettime( CLOCK_REALTIME, &deadline );
+   deadline.tv_sec += ctxt->packlinger / 1000;
+   deadline.tv_nsec += ( ctxt->packlinger % 1000 ) * 1000000L;
+   if ( deadline.tv_nsec >= 1000000000L ) { deadline.tv_sec++; deadline.tv_nsec -= 1000000000L; }
+   char expired = 0;
+   while ( !(batch->done) ) {
+      if ( slot->batch == batch  &&  !(slot->busy)  &&
+           ( expired  ||  ctxt->packopen == 0  ||  ( objfiles  &&  slot->files >= objfiles ) ) ) {
+         // detach the stream, so that later creators may begin a fresh one
+         LOG( LOG_INFO, "Closing shared stream of %zu packed files\n", slot->files );
+         DATASTREAM closestream = slot->stream;
+         slot->stream = NULL;
+         slot->batch = NULL;
+         slot->files = 0;
+         pthread_mutex_unlock( &(ctxt->packlock) );
+         int closeres = datastream_close( &(closestream) );
+         int closeerrno = errno;
+         pthread_mutex_lock( &(ctxt->packlock) );
+         batch->done = 1;
+         batch->result = closeres;
+         batch->errnum = closeerrno;
+         pthread_cond_broadcast( &(ctxt->packcond) );
+         break;
+      }
+      if ( expired ) { pthread_cond_wait( &(ctxt->packcond), &(ctxt->packlock) ); }
+      else if ( pthread_cond_timedwait( &(ctxt->packcond), &(ctxt->packlock), &(deadline) ) == ETIMEDOUT ) {
+         expired = 1;
+      }
+   }
+   if ( retval == 0  &&  batch->result ) {
+      retval = -1;
+      errnum = batch->errnum;
+   }
+   batch->refs--;
+   if ( batch->refs == 0 ) { free( batch ); }
+   pthread_mutex_unlock( &(ctxt->packlock) );
+   // roll back our file of a failed batch, rather than leave it incomplete
+   if ( retval  &&  created ) {
+      LOG( LOG_INFO, "Removing packed file \"%s\" of a failed batch\n", pack->subpath );
+      MDAL curmdal = pack->pos.ns->prepo->metascheme.mdal;
+      if ( curmdal->unlink( pack->pos.ctxt, pack->subpath )  &&  errno != ENOENT ) {
+         LOG( LOG_WARNING, "Failed to remove packed file \"%s\" of a failed batch\n", pack->subpath );
+      }
+   }
+   pack_free( stream, 1 );
+   if ( retval ) { errno = errnum; }
+   return retval;
+}
+
 //   -------------   EXTERNAL FUNCTIONS    -------------
 
 // MARFS CONTEXT MGMT OPS
@@ -249,6 +774,26 @@ marfs_ctxt marfs_init( const char* configpath, marfs_interface type, pthread_mut
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return NULL;
    }
+   // initialize our packing state ( packing is disabled by default )
+   if ( pthread_mutex_init( &(ctxt->packlock), NULL ) ) {
+      LOG( LOG_ERR,"Failed to initialize packing lock for marfs_ctxt\n" );
+      pthread_mutex_destroy( &(ctxt->lock) );
+      rootmdal->destroyctxt( ctxt->pos.ctxt );
+      config_term( ctxt->config );
+      free( ctxt );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( pthread_cond_init( &(ctxt->packcond), NULL ) ) {
+      LOG( LOG_ERR,"Failed to initialize packing condition for marfs_ctxt\n" );
+      pthread_mutex_destroy( &(ctxt->packlock) );
+      pthread_mutex_destroy( &(ctxt->lock) );
+      rootmdal->destroyctxt( ctxt->pos.ctxt );
+      config_term( ctxt->config );
+      free( ctxt );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
    // all done
    LOG( LOG_INFO, "EXIT - Success\n" );
    return ctxt;
@@ -304,6 +849,44 @@ int marfs_setctag( marfs_ctxt ctxt, const char* ctag ) {
    return 0;
 }
 
+/**
+ * Enable or disable packing of the small files of concurrent creators
+ * While enabled, files produced by marfs_creat() calls with a NULL marfs_fhandle arg are
+ * not created immediately.  Instead, their data is retained by the returned handle until
+ * it is closed, at which point the file is written out to one of a small pool of data
+ * streams shared by all such handles of this ctxt.  Each shared stream is closed once no
+ * further files are expected ( all deferred handles have been closed, the per-object file
+ * limit of the repo has been reached, or 'linger' msec have elapsed ), producing objects
+ * which hold the files of many independent creators.
+ * NOTE -- marfs_close() of such a handle will only return once the shared stream has been
+ *         closed, and will report any failure of that stream.
+ * NOTE -- Until closed, the file of such a handle does not exist in the namespace, and any
+ *         errors of the creation itself ( EEXIST, ENOENT, etc. ) are reported by marfs_close().
+ *         Any op on the handle besides marfs_write/close/release, or a write beyond 'maxsize'
+ *         bytes, causes the file to be created immediately via a dedicated stream instead.
+ * @param marfs_ctxt ctxt : marfs_ctxt to be updated
+ * @param size_t maxsize : Maximum data size of a packed file, or zero to disable packing
+ * @param unsigned int linger : Maximum msec to wait for further files to join a shared stream
+ * @return int : Zero on success, or -1 on failure
+ */
+int marfs_setpacking( marfs_ctxt ctxt, size_t maxsize, unsigned int linger ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for invalid args
+   if ( ctxt == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_ctxt\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // update packing state ( affects only subsequently created handles )
+   pthread_mutex_lock( &(ctxt->packlock) );
+   ctxt->packsize = maxsize;
+   ctxt->packlinger = linger;
+   pthread_mutex_unlock( &(ctxt->packlock) );
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return 0;
+}
+
 /**
  * Populate the given string with the config version of the provided marfs_ctxt
  * @param marfs_ctxt ctxt : marfs_ctxt to retrieve version info from
@@ -368,6 +951,10 @@ int marfs_term( marfs_ctxt ctxt ) {
    pthread_mutex_unlock( &(ctxt->lock) );
    pthread_mutex_destroy( &(ctxt->lock) );
    pthread_mutex_destroy( &(ctxt->erasurelock) );
+   int index = 0;
+   for ( ; index < MARFS_PACK_STREAMS; index++ ) { free( ctxt->packslots[index].nsid ); }
+   pthread_cond_destroy( &(ctxt->packcond) );
+   pthread_mutex_destroy( &(ctxt->packlock) );
    free( ctxt );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
    else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
@@ -525,14 +1112,8 @@ int marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags )
       // note subspaces in link count
       buf->st_nlink += oppos.ns->subnodecount;
    }
-   else if ( tgtdepth != 0  &&  S_ISREG( buf->st_mode ) ) {
-      // regular files may need link count adjusted to ignore ref path
-      if ( buf->st_nlink > 1 ) { buf->st_nlink--; }
-      if ( buf->st_size ) {
-         // assume allocated blocks, based on logical file size ( saves us having to pull an FTAG xattr )
-         blkcnt_t estblocks = ( buf->st_size / 512 ) + ( (buf->st_size % 512) ? 1 : 0 );
-         if ( estblocks > buf->st_blocks ) { buf->st_blocks = estblocks; }
-      }
+   else if ( tgtdepth != 0  &&  retval == 0 ) {
+      statadjust( buf );
    }
    // cleanup references
    pathcleanup( subpath, &oppos );
@@ -1274,6 +1855,12 @@ int marfs_fstat( marfs_fhandle fh, struct stat* buf ) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( pack_lockresolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    int retval = fh->ns->prepo->metascheme.mdal->fstat( fh->metahandle, buf );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
@@ -1308,6 +1895,13 @@ int marfs_futimens(marfs_fhandle fh, const struct timespec times[2]) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( fh->pack  &&  pack_resolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(fh->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check NS perms
    if ( ( fh->itype != MARFS_INTERACTIVE  &&  !(fh->ns->bperms & NS_WRITEMETA) )  ||
         ( fh->itype != MARFS_BATCH        &&  !(fh->ns->iperms & NS_WRITEMETA) ) ) {
@@ -1364,6 +1958,12 @@ int marfs_fsetxattr(marfs_fhandle fh, const char* name, const void* value, size_
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( pack_lockresolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    int retval = fh->ns->prepo->metascheme.mdal->fsetxattr( fh->metahandle, 0, name, value, size, flags );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
@@ -1388,6 +1988,12 @@ ssize_t marfs_fgetxattr(marfs_fhandle fh, const char* name, void* value, size_t
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( pack_lockresolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    ssize_t retval = fh->ns->prepo->metascheme.mdal->fgetxattr( fh->metahandle, 0, name, value, size );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
@@ -1418,6 +2024,12 @@ int marfs_fremovexattr(marfs_fhandle fh, const char* name) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( pack_lockresolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    int retval = fh->ns->prepo->metascheme.mdal->fremovexattr( fh->metahandle, 0, name );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
@@ -1441,6 +2053,12 @@ ssize_t marfs_flistxattr(marfs_fhandle fh, char* buf, size_t size) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( pack_lockresolve( fh ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    ssize_t retval = fh->ns->prepo->metascheme.mdal->flistxattr( fh->metahandle, 0, buf, size );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
@@ -1582,60 +2200,18 @@ struct dirent *marfs_readdir(marfs_dhandle dh) {
    errno = 0;
    // potentially insert a subspace entry
    if ( dh->depth == 0  &&  dh->ns->subnodecount  &&  (dh->location & MARFS_DIR_NS_OFFSET_MASK) == 0 ) {
-      while ( dh->location < dh->ns->subnodecount ) {
-         // stat the subspace, to identify inode info
-         marfs_ns* tgtsubspace = (marfs_ns *)(dh->ns->subnodes[dh->location].content);
-         char* subspacepath = NULL;
-         if ( config_nsinfo( tgtsubspace->idstr, NULL, &(subspacepath) ) ) {
-            LOG( LOG_ERR, "Failed to identify NS path of subspace: \"%s\"\n",
-                 tgtsubspace->idstr );
-            pthread_mutex_unlock( &(dh->lock) );
-            LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-            return NULL;
-         }
-         // stat the subspace, to check for existence
-         MDAL tgtmdal = tgtsubspace->prepo->metascheme.mdal;
-         struct stat stval;
-         int stnsres = tgtmdal->statnamespace( tgtmdal->ctxt, subspacepath, &(stval) );
-         free( subspacepath );
-         if ( stnsres  &&  errno != ENOENT ) {
-            LOG( LOG_ERR, "Failed to stat subspace root: \"%s\"\n", subspacepath );
-            pthread_mutex_unlock( &(dh->lock) );
-            LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-            return NULL;
-         }
-         if ( stnsres == 0 ) {
-            // populate and return the subspace dirent
-            if ( snprintf( dh->subspcent.d_name, dh->subspcnamealloc, "%s", dh->ns->subnodes[dh->location].name ) >= dh->subspcnamealloc ) {
-               LOG( LOG_ERR, "Dirent struct does not have sufficient space to store subspace name: \"%s\" (%zu bytes available)\n", dh->ns->subnodes[dh->location].name, dh->subspcnamealloc );
-               pthread_mutex_unlock( &(dh->lock) );
-               errno = ENAMETOOLONG;
-               LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-               return NULL;
-            }
-            // increment our index
-            dh->location++;
-            if ( dh->location & MARFS_DIR_NS_OFFSET_MASK ) {
-               if ( dh->location != dh->ns->subnodecount ) {
-                  // indicate that our location has become invalid
-                  dh->location = MARFS_DIR_NS_OFFSET_MASK | 1L;
-                  LOG( LOG_ERR, "This readdir op has resulted in an excessive dir handle location value\n" );
-               }
-               else {
-                  // overwrite our location, to indicate that we have finished subspace listing
-                  dh->location = MARFS_DIR_NS_OFFSET_MASK;
-               }
-            }
-            pthread_mutex_unlock( &(dh->lock) );
-            LOG( LOG_INFO, "EXIT - Success\n" );
-            errno = cachederrno;
-            return &(dh->subspcent);
-         }
-         // increment our index
-         dh->location++;
+      int subres = nextsubspace( dh, NULL );
+      if ( subres < 0 ) {
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      if ( subres ) {
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Success\n" );
+         errno = cachederrno;
+         return &(dh->subspcent);
       }
-      // overwrite our location, to indicate that we have finished subspace listing
-      dh->location = MARFS_DIR_NS_OFFSET_MASK;
    }
    // check for an invalid location value
    if ( dh->location == (MARFS_DIR_NS_OFFSET_MASK | 1L) ) {
@@ -1664,19 +2240,19 @@ struct dirent *marfs_readdir(marfs_dhandle dh) {
 }
 
 /**
- * Identify the ( abstract ) location of an open directory handle
- * NOTE -- This 'location' can be used via marfs_seekdir() to allow for the repeating
- *         of marfs_readdir() results.  However, the 'location' value should be
- *         considered an opaque type, with no caller assumptions as to content,
- *         beyond error checking.
- * @param marfs_dhandle dh : marfs_dhandle to retrieve the location value of
- * @return long : Abstract location value, or -1 on error
+ * Iterate over the next entries of an open directory handle, retrieving the attributes of each
+ * NOTE -- This shares the position of the directory handle with marfs_readdir(), marfs_telldir(), etc.
+ * @param marfs_dhandle dh : marfs_dhandle to read from
+ * @param marfs_direntplus* ents : Array of entries to be populated
+ * @param size_t count : Length of the 'ents' array
+ * @return ssize_t : Number of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
  */
-long marfs_telldir(marfs_dhandle dh) {
+ssize_t marfs_readdirplus(marfs_dhandle dh, marfs_direntplus* ents, size_t count) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
-   if ( dh == NULL ) {
-      LOG( LOG_ERR, "Received a NULL marfs_dhandle arg\n" );
+   if ( dh == NULL  ||  (ents == NULL  &&  count) ) {
+      LOG( LOG_ERR, "Received a NULL marfs_dhandle or entry array arg\n" );
       errno = EINVAL;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
@@ -1687,42 +2263,240 @@ long marfs_telldir(marfs_dhandle dh) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
-   // check for an invalid location
-   if ( dh->depth == 0  &&  dh->ns->subnodecount  &&  dh->location == (MARFS_DIR_NS_OFFSET_MASK | 1L) ) {
+   MDAL curmdal = dh->ns->prepo->metascheme.mdal;
+   char nsroot = ( dh->depth == 0  &&  dh->ns->subnodecount ) ? 1 : 0;
+   size_t populated = 0;
+   // potentially insert subspace entries
+   while ( populated < count  &&  nsroot  &&  (dh->location & MARFS_DIR_NS_OFFSET_MASK) == 0 ) {
+      marfs_direntplus* tgtent = ents + populated;
+      int subres = nextsubspace( dh, &(tgtent->st) );
+      if ( subres < 0 ) {
+         if ( populated ) { break; } // report what we have, and let the next call report the error
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      if ( subres == 0 ) { break; } // subspace listing complete
+      memcpy( &(tgtent->ent), &(dh->subspcent), sizeof( struct dirent ) );
+      tgtent->sterr = 0;
+      tgtent->loc = dh->location;
+      if ( dh->location == MARFS_DIR_NS_OFFSET_MASK ) {
+         // final subspace entry, so the following location is that of the start of the MDAL dir
+         long mdalloc = curmdal->telldir( dh->metahandle );
+         tgtent->loc = ( mdalloc < 0 ) ? mdalloc : ( mdalloc | MARFS_DIR_NS_OFFSET_MASK );
+      }
+      populated++;
+   }
+   // check for an invalid location value
+   if ( populated == 0  &&  dh->location == (MARFS_DIR_NS_OFFSET_MASK | 1L) ) {
       pthread_mutex_unlock( &(dh->lock) );
       LOG( LOG_ERR, "Dir handle location value is invalid\n" );
       errno = EMSGSIZE;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
-   long retval = 0;
-   // check for a post-NS offset
-   if ( dh->depth != 0  ||  dh->ns->subnodecount == 0  ||  (dh->location & MARFS_DIR_NS_OFFSET_MASK) ) {
-      // get the location value of the underlying MDAL_DHANDLE
-      retval = dh->ns->prepo->metascheme.mdal->telldir( dh->metahandle );
-      // if we have subspaces, this value requires additional checks/modification
-      if ( dh->depth == 0  &&  dh->ns->subnodecount ) {
-         // check for value collision
-         if ( (retval & MARFS_DIR_NS_OFFSET_MASK) ) {
+   // populate remaining entries from the MDAL
+   MDAL_direntplus* batch = NULL;
+   if ( populated < count  &&  (!(nsroot)  ||  dh->location == MARFS_DIR_NS_OFFSET_MASK) ) {
+      size_t batchlen = ( (count - populated) < MARFS_READDIRPLUS_BATCH ) ? (count - populated) : MARFS_READDIRPLUS_BATCH;
+      batch = malloc( sizeof( MDAL_direntplus ) * batchlen );
+      if ( batch == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a batch of %zu MDAL entries\n", batchlen );
+         if ( populated == 0 ) {
             pthread_mutex_unlock( &(dh->lock) );
-            LOG( LOG_ERR, "MDAL handle location value collides with MarFS dir NS offset bit\n" );
-            errno = EDOM;
             LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
             return -1;
          }
-         // mark this as a post-NS value
-         retval |= MARFS_DIR_NS_OFFSET_MASK;
       }
-      pthread_mutex_unlock( &(dh->lock) );
-      if ( retval != -1 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
-      else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
-      return retval;
    }
-   // otherwise, just return our current subspace offset
-   pthread_mutex_unlock( &(dh->lock) );
-   LOG( LOG_INFO, "EXIT - Success\n" );
-   return dh->location;
-}
+   while ( batch  &&  populated < count ) {
+      size_t reqcnt = ( (count - populated) < MARFS_READDIRPLUS_BATCH ) ? (count - populated) : MARFS_READDIRPLUS_BATCH;
+      ssize_t res = curmdal->readdirplus( dh->metahandle, batch, reqcnt );
+      if ( res < 0 ) {
+         LOG( LOG_ERR, "Failed to read MDAL dir entries\n" );
+         if ( populated ) { break; } // report what we have, and let the next call report the error
+         free( batch );
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      if ( res == 0 ) { break; } // all entries have been read
+      ssize_t index;
+      for ( index = 0; index < res; index++ ) {
+         MDAL_direntplus* srcent = batch + index;
+         // filter out any restricted entries at the root of a NS
+         if ( dh->depth == 0  &&  curmdal->pathfilter( srcent->ent.d_name ) ) {
+            LOG( LOG_INFO, "Omitting hidden dirent: \"%s\"\n", srcent->ent.d_name );
+            continue;
+         }
+         marfs_direntplus* tgtent = ents + populated;
+         memcpy( &(tgtent->ent), &(srcent->ent), sizeof( struct dirent ) );
+         memcpy( &(tgtent->st), &(srcent->st), sizeof( struct stat ) );
+         tgtent->sterr = srcent->sterr;
+         if ( tgtent->sterr == 0 ) { statadjust( &(tgtent->st) ); }
+         tgtent->loc = srcent->loc;
+         if ( nsroot  &&  tgtent->loc >= 0 ) {
+            // check for value collision, just as marfs_telldir() would
+            if ( tgtent->loc & MARFS_DIR_NS_OFFSET_MASK ) {
+               LOG( LOG_ERR, "MDAL handle location value collides with MarFS dir NS offset bit\n" );
+               tgtent->loc = -1;
+            }
+            else { tgtent->loc |= MARFS_DIR_NS_OFFSET_MASK; }
+         }
+         populated++;
+      }
+   }
+   free( batch );
+   pthread_mutex_unlock( &(dh->lock) );
+   LOG( LOG_INFO, "EXIT - Success ( %zu entries )\n", populated );
+   return (ssize_t)populated;
+}
+
+/**
+ * Stat many entries of an open directory handle, as marfs_stat() w/ AT_SYMLINK_NOFOLLOW would
+ * NOTE -- This avoids the full path traversal of a marfs_stat() for each entry, and allows
+ *         the MDAL to skip retrieval of unneeded fields and to issue stats in parallel.
+ * @param marfs_dhandle dh : marfs_dhandle containing all entries
+ * @param size_t count : Number of entries to stat
+ * @param const char** names : Names of the entries to stat ( as produced by marfs_readdir(),
+ *                             NOT paths containing '/' )
+ * @param unsigned int mask : Bitwise OR of the MARFS_STAT_* fields required by the caller
+ *                            ( the value of all other stat fields is undefined )
+ * @param struct stat* sts : Array of stat structures to be populated
+ * @param int* errs : Array to be populated with the errno value of each stat ( zero on success )
+ * @param int threads : Maximum number of threads to stat with ( zero or one for the calling thread alone )
+ * @return ssize_t : Number of successfully stat'd entries, or -1 if a failure occurred
+ */
+ssize_t marfs_statx_many(marfs_dhandle dh, size_t count, const char** names, unsigned int mask,
+                         struct stat* sts, int* errs, int threads) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( dh == NULL  ||  ( count  &&  ( names == NULL  ||  sts == NULL  ||  errs == NULL ) ) ) {
+      LOG( LOG_ERR, "Received a NULL marfs_dhandle or array arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // our own stat adjustments depend upon file type, and block estimates upon file size
+   mask |= MARFS_STAT_TYPE;
+   if ( mask & MARFS_STAT_BLOCKS ) { mask |= MARFS_STAT_SIZE; }
+   // acquire directory lock
+   if ( pthread_mutex_lock( &(dh->lock) ) ) {
+      LOG( LOG_ERR, "Failed to aqcuire marfs_dhandle lock\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // stat all entries via the MDAL
+   MDAL curmdal = dh->ns->prepo->metascheme.mdal;
+   ssize_t successes = curmdal->statmany( dh->metahandle, count, names, mask, sts, errs, threads );
+   if ( successes < 0 ) {
+      LOG( LOG_ERR, "Failed to stat MDAL dir entries\n" );
+      pthread_mutex_unlock( &(dh->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   size_t index;
+   for ( index = 0; index < count; index++ ) {
+      if ( dh->depth == 0 ) {
+         // reserved entries at the root of a NS are never visible
+         if ( errs[index] == 0  &&  curmdal->pathfilter( names[index] ) ) {
+            LOG( LOG_INFO, "Omitting hidden entry: \"%s\"\n", names[index] );
+            errs[index] = ENOENT;
+            successes--;
+            continue;
+         }
+         // subspaces are not entries of the MDAL dir itself
+         size_t subindex;
+         for ( subindex = 0; subindex < dh->ns->subnodecount; subindex++ ) {
+            if ( strcmp( names[index], dh->ns->subnodes[subindex].name ) == 0 ) { break; }
+         }
+         if ( subindex < dh->ns->subnodecount ) {
+            marfs_ns* tgtsubspace = (marfs_ns *)(dh->ns->subnodes[subindex].content);
+            char* subspacepath = NULL;
+            int suberr = 0;
+            if ( config_nsinfo( tgtsubspace->idstr, NULL, &(subspacepath) ) ) {
+               LOG( LOG_ERR, "Failed to identify NS path of subspace: \"%s\"\n", tgtsubspace->idstr );
+               suberr = (errno) ? errno : ENOMSG;
+            }
+            else {
+               MDAL tgtmdal = tgtsubspace->prepo->metascheme.mdal;
+               if ( tgtmdal->statnamespace( tgtmdal->ctxt, subspacepath, sts + index ) ) { suberr = errno; }
+               else { sts[index].st_nlink += tgtsubspace->subnodecount; } // just as marfs_stat() would
+               free( subspacepath );
+            }
+            if ( errs[index] == 0  &&  suberr ) { successes--; }
+            else if ( errs[index]  &&  suberr == 0 ) { successes++; }
+            errs[index] = suberr;
+            continue;
+         }
+      }
+      if ( errs[index] == 0 ) { statadjust( sts + index ); }
+   }
+   pthread_mutex_unlock( &(dh->lock) );
+   LOG( LOG_INFO, "EXIT - Success ( %zd of %zu entries )\n", successes, count );
+   return successes;
+}
+
+/**
+ * Identify the ( abstract ) location of an open directory handle
+ * NOTE -- This 'location' can be used via marfs_seekdir() to allow for the repeating
+ *         of marfs_readdir() results.  However, the 'location' value should be
+ *         considered an opaque type, with no caller assumptions as to content,
+ *         beyond error checking.
+ * @param marfs_dhandle dh : marfs_dhandle to retrieve the location value of
+ * @return long : Abstract location value, or -1 on error
+ */
+long marfs_telldir(marfs_dhandle dh) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( dh == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_dhandle arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // acquire directory lock
+   if ( pthread_mutex_lock( &(dh->lock) ) ) {
+      LOG( LOG_ERR, "Failed to aqcuire marfs_dhandle lock\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // check for an invalid location
+   if ( dh->depth == 0  &&  dh->ns->subnodecount  &&  dh->location == (MARFS_DIR_NS_OFFSET_MASK | 1L) ) {
+      pthread_mutex_unlock( &(dh->lock) );
+      LOG( LOG_ERR, "Dir handle location value is invalid\n" );
+      errno = EMSGSIZE;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   long retval = 0;
+   // check for a post-NS offset
+   if ( dh->depth != 0  ||  dh->ns->subnodecount == 0  ||  (dh->location & MARFS_DIR_NS_OFFSET_MASK) ) {
+      // get the location value of the underlying MDAL_DHANDLE
+      retval = dh->ns->prepo->metascheme.mdal->telldir( dh->metahandle );
+      // if we have subspaces, this value requires additional checks/modification
+      if ( dh->depth == 0  &&  dh->ns->subnodecount ) {
+         // check for value collision
+         if ( (retval & MARFS_DIR_NS_OFFSET_MASK) ) {
+            pthread_mutex_unlock( &(dh->lock) );
+            LOG( LOG_ERR, "MDAL handle location value collides with MarFS dir NS offset bit\n" );
+            errno = EDOM;
+            LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+            return -1;
+         }
+         // mark this as a post-NS value
+         retval |= MARFS_DIR_NS_OFFSET_MASK;
+      }
+      pthread_mutex_unlock( &(dh->lock) );
+      if ( retval != -1 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
+      else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
+      return retval;
+   }
+   // otherwise, just return our current subspace offset
+   pthread_mutex_unlock( &(dh->lock) );
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return dh->location;
+}
 
 /**
  * Set the position of an open directory handle, for future marfs_readdir() calls
@@ -2055,6 +2829,7 @@ ssize_t marfs_dlistxattr(marfs_dhandle dh, char* buf, size_t size) {
  */
 marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, mode_t mode) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_CREAT );
    // check for NULL args
    if ( ctxt == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_ctxt arg\n" );
@@ -2151,6 +2926,30 @@ marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *pat
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
          return NULL;
       }
+      // positional readers must complete before we can retarget the handle
+      if ( quiesce_preads( stream, 1 ) ) {
+         LOG( LOG_WARNING, "Failed to cleanly release positional read cursors of the previous target\n" );
+      }
+      // a deferred packed file must be created before we can retarget the handle
+      if ( stream->pack  &&  pack_resolve( stream ) ) {
+         LOG( LOG_ERR, "Failed to create deferred packed file of the previous target\n" );
+         int origerrno = errno;
+         pthread_mutex_unlock( &(stream->lock) );
+         pathcleanup( subpath, &oppos );
+         errno = origerrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      // buffered data of the previous target must be passed along before we retarget the handle
+      if ( flush_writebuf( stream ) ) {
+         LOG( LOG_ERR, "Failed to flush write-behind buffer of the previous target\n" );
+         int origerrno = errno;
+         pthread_mutex_unlock( &(stream->lock) );
+         pathcleanup( subpath, &oppos );
+         errno = origerrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
       if ( stream->datastream == NULL  &&  stream->metahandle == NULL ) {
          // a double-NULL handle has been flushed or suffered a fatal error
          LOG( LOG_ERR, "Received a flushed marfs_fhandle\n" );
@@ -2184,6 +2983,28 @@ marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *pat
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return NULL;
    }
+   // the file of a fresh handle may instead be deferred, for packing via a shared stream
+   if ( newstream ) {
+      pthread_mutex_lock( &(ctxt->packlock) );
+      size_t packsize = ctxt->packsize;
+      if ( packsize  &&  (stream->pack = malloc( sizeof( struct marfs_packinfo_struct ) )) ) {
+         ctxt->packopen++;
+      }
+      pthread_mutex_unlock( &(ctxt->packlock) );
+      if ( stream->pack ) {
+         LOG( LOG_INFO, "Deferring creation of packed file\n" );
+         stream->pack->ctxt = ctxt;
+         stream->pack->subpath = subpath; // path info is now owned by the handle
+         stream->pack->pos = oppos;
+         stream->pack->mode = mode;
+         stream->pack->maxsize = packsize;
+         stream->flags = O_WRONLY | O_CREAT;
+         stream->ns = dupref;
+         stream->itype = ctxt->itype;
+         LOG( LOG_INFO, "EXIT - Success\n" );
+         return stream;
+      }
+   }
    // attempt the op
    char hadstream = 0;
    if ( stream->datastream ) { hadstream = 1; }
@@ -2260,6 +3081,7 @@ marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *pat
  */
 marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, int flags) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_OPEN );
    // check for NULL args
    if ( ctxt == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_ctxt arg\n" );
@@ -2320,6 +3142,7 @@ marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path
       if ( pthread_mutex_lock( &(stream->lock) ) ) {
          LOG( LOG_ERR, "Failed to acquire lock on new marfs_fhandle\n" );
          pthread_mutex_destroy( &(stream->lock) );
+         pthread_cond_destroy( &(stream->preadcond) );
          free( stream );
          pathcleanup( subpath, &oppos );
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
@@ -2334,6 +3157,30 @@ marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
          return NULL;
       }
+      // positional readers must complete before we can retarget the handle
+      if ( quiesce_preads( stream, 1 ) ) {
+         LOG( LOG_WARNING, "Failed to cleanly release positional read cursors of the previous target\n" );
+      }
+      // a deferred packed file must be created before we can retarget the handle
+      if ( stream->pack  &&  pack_resolve( stream ) ) {
+         LOG( LOG_ERR, "Failed to create deferred packed file of the previous target\n" );
+         int origerrno = errno;
+         pthread_mutex_unlock( &(stream->lock) );
+         pathcleanup( subpath, &oppos );
+         errno = origerrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      // buffered data of the previous target must be passed along before we retarget the handle
+      if ( flush_writebuf( stream ) ) {
+         LOG( LOG_ERR, "Failed to flush write-behind buffer of the previous target\n" );
+         int origerrno = errno;
+         pthread_mutex_unlock( &(stream->lock) );
+         pathcleanup( subpath, &oppos );
+         errno = origerrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
       if ( stream->datastream == NULL  &&  stream->metahandle == NULL ) {
          // a double-NULL handle has been flushed or suffered a fatal error
          LOG( LOG_ERR, "Received a flushed marfs_fhandle\n" );
@@ -2485,6 +3332,7 @@ marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path
  */
 int marfs_close(marfs_fhandle stream) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_CLOSE );
    // check for NULL args
    if ( stream == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
@@ -2498,20 +3346,35 @@ int marfs_close(marfs_fhandle stream) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // positional readers must complete before we can close the handle
+   int cursorres = quiesce_preads( stream, 1 );
+   int cursorerrno = errno;
+   // pass along any buffered data
+   int bufres = flush_writebuf( stream );
+   int buferrno = errno;
    // reject a flushed handle
-   if ( stream->metahandle == NULL  &&  stream->datastream == NULL ) {
+   if ( stream->metahandle == NULL  &&  stream->datastream == NULL  &&  stream->pack == NULL ) {
       LOG( LOG_ERR, "Received a flushed marfs_fhandle\n" );
       if ( stream->ns ) { config_destroynsref( stream->ns ); }
+      if ( stream->wbuf ) { free( stream->wbuf ); }
       pthread_mutex_unlock( &(stream->lock) );
       pthread_mutex_destroy( &(stream->lock) );
+      pthread_cond_destroy( &(stream->preadcond) );
       free( stream );
-      errno = EINVAL;
+      errno = (bufres) ? buferrno : EINVAL;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
    // check for datastream reference
    int retval = 0;
-   if ( stream->datastream == NULL ) {
+   if ( stream->pack ) {
+      // deferred packed file
+      LOG( LOG_INFO, "Writing out deferred packed file\n" );
+      if ( (retval = pack_commit( stream )) ) {
+         LOG( LOG_ERR, "Failed to write out deferred packed file\n" );
+      }
+   }
+   else if ( stream->datastream == NULL ) {
       // meta only reference
       LOG( LOG_INFO, "Closing meta-only marfs_fhandle\n" );
       MDAL curmdal = stream->ns->prepo->metascheme.mdal;
@@ -2521,16 +3384,37 @@ int marfs_close(marfs_fhandle stream) {
    }
    else {
       // datastream reference
-      LOG( LOG_INFO, "Closing datastream reference\n" );
-      if ( (retval = datastream_close( &(stream->datastream) )) ) {
-         LOG( LOG_ERR, "Failed to close datastream\n" );
+      if ( bufres ) {
+         // don't complete a file which is known to be missing data
+         LOG( LOG_INFO, "Releasing datastream reference, due to write-behind failure\n" );
+         if ( datastream_release( &(stream->datastream) ) ) {
+            LOG( LOG_ERR, "Failed to release datastream\n" );
+         }
+      }
+      else {
+         LOG( LOG_INFO, "Closing datastream reference\n" );
+         if ( (retval = datastream_close( &(stream->datastream) )) ) {
+            LOG( LOG_ERR, "Failed to close datastream\n" );
+         }
       }
    }
+   if ( bufres ) {
+      LOG( LOG_ERR, "Buffered write failure w/ \"%s\"\n", strerror(buferrno) );
+      errno = buferrno;
+      retval = -1;
+   }
+   if ( cursorres  &&  retval == 0 ) {
+      LOG( LOG_ERR, "Failed to release positional read cursors\n" );
+      errno = cursorerrno;
+      retval = -1;
+   }
    stream->metahandle = NULL;
    stream->datastream = NULL;
    if ( stream->ns ) { config_destroynsref( stream->ns ); }
+   if ( stream->wbuf ) { free( stream->wbuf ); }
    pthread_mutex_unlock( &(stream->lock) );
    pthread_mutex_destroy( &(stream->lock) );
+   pthread_cond_destroy( &(stream->preadcond) );
    free( stream );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
    else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
@@ -2550,6 +3434,7 @@ int marfs_close(marfs_fhandle stream) {
  */
 int marfs_release(marfs_fhandle stream) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_RELEASE );
    // check for NULL args
    if ( stream == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
@@ -2563,9 +3448,21 @@ int marfs_release(marfs_fhandle stream) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // positional readers must complete before we can release the handle
+   int cursorres = quiesce_preads( stream, 1 );
+   int cursorerrno = errno;
+   // pass along any buffered data
+   int bufres = flush_writebuf( stream );
+   int buferrno = errno;
    // check for datastream reference
    int retval = 0;
-   if ( stream->datastream ) {
+   if ( stream->pack ) {
+      // deferred packed file, which will now never be created
+      LOG( LOG_INFO, "Discarding deferred packed file\n" );
+      stream->wbuflen = 0;
+      pack_free( stream, 0 );
+   }
+   else if ( stream->datastream ) {
       // datastream reference
       LOG( LOG_INFO, "Releasing datastream reference\n" );
       if ( (retval = datastream_release( &(stream->datastream) )) ) {
@@ -2580,11 +3477,23 @@ int marfs_release(marfs_fhandle stream) {
          LOG( LOG_ERR, "Failed to close MDAL_FHANDLE\n" );
       }
    }
+   if ( bufres ) {
+      LOG( LOG_ERR, "Buffered write failure w/ \"%s\"\n", strerror(buferrno) );
+      errno = buferrno;
+      retval = -1;
+   }
+   if ( cursorres  &&  retval == 0 ) {
+      LOG( LOG_ERR, "Failed to release positional read cursors\n" );
+      errno = cursorerrno;
+      retval = -1;
+   }
    stream->metahandle = NULL;
    stream->datastream = NULL;
    if ( stream->ns ) { config_destroynsref( stream->ns ); }
+   if ( stream->wbuf ) { free( stream->wbuf ); }
    pthread_mutex_unlock( &(stream->lock) );
    pthread_mutex_destroy( &(stream->lock) );
+   pthread_cond_destroy( &(stream->preadcond) );
    free( stream );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
    else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
@@ -2619,13 +3528,35 @@ int marfs_flush(marfs_fhandle stream) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // positional readers must complete before we can complete the file
+   int cursorres = quiesce_preads( stream, 1 );
+   int cursorerrno = errno;
+   // pass along any buffered data
+   int bufres = flush_writebuf( stream );
+   int buferrno = errno;
    // check for datastream reference
    int retval = 0;
-   if ( stream->datastream ) {
+   if ( stream->pack ) {
+      // deferred packed file
+      LOG( LOG_INFO, "Writing out deferred packed file\n" );
+      if ( (retval = pack_commit( stream )) ) {
+         LOG( LOG_ERR, "Failed to write out deferred packed file\n" );
+      }
+   }
+   else if ( stream->datastream ) {
       // datastream reference
-      LOG( LOG_INFO, "Closing datastream reference\n" );
-      if ( (retval = datastream_close( &(stream->datastream) )) ) {
-         LOG( LOG_ERR, "Failed to close datastream\n" );
+      if ( bufres ) {
+         // don't complete a file which is known to be missing data
+         LOG( LOG_INFO, "Releasing datastream reference, due to write-behind failure\n" );
+         if ( datastream_release( &(stream->datastream) ) ) {
+            LOG( LOG_ERR, "Failed to release datastream\n" );
+         }
+      }
+      else {
+         LOG( LOG_INFO, "Closing datastream reference\n" );
+         if ( (retval = datastream_close( &(stream->datastream) )) ) {
+            LOG( LOG_ERR, "Failed to close datastream\n" );
+         }
       }
    }
    else if ( stream->metahandle ) {
@@ -2636,8 +3567,19 @@ int marfs_flush(marfs_fhandle stream) {
          LOG( LOG_ERR, "Failed to close MDAL_FHANDLE\n" );
       }
    }
+   if ( bufres ) {
+      LOG( LOG_ERR, "Buffered write failure w/ \"%s\"\n", strerror(buferrno) );
+      errno = buferrno;
+      retval = -1;
+   }
+   if ( cursorres  &&  retval == 0 ) {
+      LOG( LOG_ERR, "Failed to release positional read cursors\n" );
+      errno = cursorerrno;
+      retval = -1;
+   }
    stream->metahandle = NULL;
    stream->datastream = NULL;
+   if ( stream->wbuf ) { free( stream->wbuf ); stream->wbuf = NULL; }
    pthread_mutex_unlock( &(stream->lock) );
    if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
    else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
@@ -2677,6 +3619,13 @@ int marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* rec
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check for datastream reference
    if ( stream->datastream == NULL ) {
       LOG( LOG_ERR, "Received marfs_fhandle has no underlying datastream\n" );
@@ -2705,6 +3654,16 @@ int marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* rec
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // any buffered data must be passed along first, as recovery info may only change prior to writing
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer\n" );
+      int origerrno = errno;
+      pthread_mutex_unlock( &(stream->lock) );
+      pathcleanup( subpath, &oppos );
+      errno = origerrno;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // perform the op
    int retval = datastream_setrecoverypath( &(stream->datastream), subpath );
    pthread_mutex_unlock( &(stream->lock) );
@@ -2731,6 +3690,7 @@ int marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* rec
  */
 ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_READ );
    // check for NULL args
    if ( stream == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
@@ -2744,6 +3704,15 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // wait for any positional readers, as a sequential read may reposition the datastream
+   quiesce_preads( stream, 0 );
    // check NS perms
    if ( ( stream->itype != MARFS_INTERACTIVE  &&  !(stream->ns->bperms & NS_READDATA) )  ||
         ( stream->itype != MARFS_BATCH        &&  !(stream->ns->iperms & NS_READDATA) ) ) {
@@ -2758,6 +3727,7 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
       // read from datastream reference
       ssize_t retval = datastream_read( &(stream->datastream), buf, count );
       pthread_mutex_unlock( &(stream->lock) );
+      if ( retval > 0 ) { span.bytes = retval; }
       if ( retval >= 0 ) { LOG( LOG_INFO, "EXIT - Success (%zd bytes)\n", retval ); }
       else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
       return retval;
@@ -2784,6 +3754,12 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
 
 /**
  * Write to the file currently referenced by the given marfs_fhandle
+ * NOTE -- For handles produced by marfs_creat(), small writes are coalesced into a
+ *         per-handle write-behind buffer ( sized to a multiple of the erasure stripe ),
+ *         which is passed along when full, on any non-sequential seek, and by
+ *         marfs_close/release/flush.  As a result, a failure to store buffered data may
+ *         only be reported by a later write, seek, or ( most importantly ) by the
+ *         close/release/flush of the handle.
  * @param marfs_fhandle stream : marfs_fhandle to be written to
  * @param const void* buf : Reference to the buffer containing data to be written
  * @param size_t count : Number of bytes to be written
@@ -2796,6 +3772,7 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
  */
 ssize_t marfs_write(marfs_fhandle stream, const void* buf, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
+   PERF_SPAN( span, PERF_MARFS_WRITE );
    // check for NULL args
    if ( stream == NULL ) {
       LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
@@ -2818,12 +3795,35 @@ ssize_t marfs_write(marfs_fhandle stream, const void* buf, size_t size) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // check for a deferred packed file
+   if ( stream->pack ) {
+      ssize_t retval = pack_write( stream, buf, size );
+      pthread_mutex_unlock( &(stream->lock) );
+      if ( retval > 0 ) { span.bytes = retval; }
+      if ( retval >= 0 ) { LOG( LOG_INFO, "EXIT - Success (%zd bytes)\n", retval ); }
+      else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
+      return retval;
+   }
    // check for datastream reference
    if ( stream->datastream ) {
-      // write to the datastream reference
-      ssize_t retval = datastream_write( &(stream->datastream), buf, size );
-      if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
+      ssize_t retval;
+      if ( stream->wbuferrno ) {
+         // a previously buffered write has failed, so reject any further data
+         LOG( LOG_ERR, "Rejecting write due to a previous write-behind failure\n" );
+         errno = stream->wbuferrno;
+         retval = -1;
+      }
+      else if ( stream->datastream->type == CREATE_STREAM ) {
+         // coalesce small sequential writes via our write-behind buffer
+         retval = buffered_write( stream, buf, size );
+      }
+      else {
+         // write to the datastream reference
+         retval = datastream_write( &(stream->datastream), buf, size );
+         if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
+      }
       pthread_mutex_unlock( &(stream->lock) );
+      if ( retval > 0 ) { span.bytes = retval; }
       if ( retval >= 0 ) { LOG( LOG_INFO, "EXIT - Success (%zd bytes)\n", retval ); }
       else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
       return retval;
@@ -2864,6 +3864,31 @@ off_t marfs_seek(marfs_fhandle stream, off_t offset, int whence) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // wait for any positional readers, as a seek may reposition the datastream
+   quiesce_preads( stream, 0 );
+   // sequential seeks need not disturb the write-behind buffer
+   if ( stream->wbuflen ) {
+      off_t curoffset = (off_t)( stream->datastream->files[stream->datastream->curfile].ftag.bytes + stream->wbuflen );
+      if ( ( whence == SEEK_SET  &&  offset == curoffset )  ||  ( whence == SEEK_CUR  &&  offset == 0 ) ) {
+         pthread_mutex_unlock( &(stream->lock) );
+         LOG( LOG_INFO, "EXIT - Success (offset=%zd)\n", curoffset );
+         return curoffset;
+      }
+   }
+   // any other seek requires that buffered data be passed along first
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer prior to seek\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check for datastream reference
    if ( stream->datastream ) {
       LOG( LOG_INFO, "Seeking datastream\n" );
@@ -2899,6 +3924,11 @@ off_t marfs_seek(marfs_fhandle stream, off_t offset, int whence) {
  * Seek to the provided offset of the given marfs_fhandle AND read from that location
  * NOTE -- This function exists for the sole purpose of supporting the FUSE interface, 
  *         which performs reads, using this 'at-offset' format, in parallel
+ * NOTE -- For handles opened for read, this function does not hold the marfs_fhandle lock
+ *         while reading.  Each in-progress call instead uses its own cursor ( object handle
+ *         + position ), drawn from a small per-handle cache, allowing parallel reads of
+ *         distinct ranges to proceed concurrently.  This does not alter the position of
+ *         the handle, as seen by marfs_read() / marfs_seek().
  * @param marfs_fhandle stream : marfs_fhandle to seek and read
  * @param off_t offset : Offset for the seek
  *                       NOTE -- this is assumed to be relative to the start of the file
@@ -2927,6 +3957,13 @@ ssize_t marfs_read_at_offset(marfs_fhandle stream, off_t offset, void* buf, size
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check NS perms
    if ( ( stream->itype != MARFS_INTERACTIVE  &&  !(stream->ns->bperms & NS_READDATA) )  ||
         ( stream->itype != MARFS_BATCH        &&  !(stream->ns->iperms & NS_READDATA) ) ) {
@@ -2937,6 +3974,49 @@ ssize_t marfs_read_at_offset(marfs_fhandle stream, off_t offset, void* buf, size
       return -1;
    }
 
+   // READ streams support parallel positional reads, via per-reader cursors
+   if ( stream->datastream  &&  stream->datastream->type == READ_STREAM ) {
+      DATASTREAM dstream = stream->datastream;
+      DATASTREAM_CURSOR cursor = { .objno = 0, .offset = 0, .fileoffset = 0, .datahandle = NULL };
+      if ( stream->curscount ) {
+         // prefer a cursor left at our target offset by a previous read ( sequential reader ),
+         //    otherwise, just take the most recently used
+         size_t curindex = stream->curscount - 1;
+         size_t index = 0;
+         for ( ; index < stream->curscount; index++ ) {
+            if ( stream->cursors[index].fileoffset == offset ) { curindex = index; break; }
+         }
+         cursor = stream->cursors[curindex];
+         stream->curscount--;
+         stream->cursors[curindex] = stream->cursors[stream->curscount]; // fill the gap
+      }
+      stream->preaders++;
+      pthread_mutex_unlock( &(stream->lock) );
+      // perform the read, without holding the handle lock
+      LOG( LOG_INFO, "Reading %zu bytes from datastream at %zd offset\n", count, offset );
+      ssize_t retval = datastream_pread( dstream, &(cursor), offset, buf, count );
+      int origerrno = errno;
+      // return our cursor to the cache
+      if ( pthread_mutex_lock( &(stream->lock) ) ) {
+         // our completion could never be noted, leaving the handle impossible to quiesce
+         LOG( LOG_ERR, "Failed to reacquire marfs_fhandle lock\n" );
+         abort();
+      }
+      if ( cursor.datahandle  &&  stream->curscount < MARFS_PREAD_CURSORS ) {
+         stream->cursors[stream->curscount] = cursor;
+         stream->curscount++;
+      }
+      else if ( datastream_releasecursor( dstream, &(cursor) ) ) {
+         LOG( LOG_WARNING, "Failed to release excess positional read cursor\n" );
+      }
+      pread_complete( stream );
+      pthread_mutex_unlock( &(stream->lock) );
+      errno = origerrno;
+      if ( retval >= 0 ) { LOG( LOG_INFO, "EXIT - Success (%zd bytes)\n", retval ); }
+      else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
+      return retval;
+   }
+
    // seek to the requested offset
    off_t offval;
    // check for datastream reference
@@ -3018,6 +4098,20 @@ int marfs_chunkbounds(marfs_fhandle stream, int chunknum, off_t* offset, size_t*
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // any buffered data must be passed along first, as it may extend or add data chunks
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check for datastream reference
    if ( stream->datastream ) {
       // identify datastream reference chunkbounds
@@ -3057,6 +4151,13 @@ int marfs_ftruncate(marfs_fhandle stream, off_t length) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check NS perms
    if ( ( stream->itype != MARFS_INTERACTIVE  &&  !(stream->ns->bperms & NS_WRITEDATA) )  ||
         ( stream->itype != MARFS_BATCH        &&  !(stream->ns->iperms & NS_WRITEDATA) ) ) {
@@ -3066,10 +4167,19 @@ int marfs_ftruncate(marfs_fhandle stream, off_t length) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // wait for any positional readers, and pass along buffered data, prior to altering file size
+   quiesce_preads( stream, 0 );
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer prior to truncate\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check for datastream reference
    if ( stream->datastream ) {
       // truncate the datastream reference
       int retval = datastream_truncate( &(stream->datastream), length );
+      if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
       pthread_mutex_unlock( &(stream->lock) );
       if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
       else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
@@ -3126,6 +4236,20 @@ int marfs_extend(marfs_fhandle stream, off_t length) {
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return -1;
    }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // any buffered data must be passed along first, as extension is only possible prior to writing
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
    // check for datastream reference
    if ( stream->datastream ) {
       // extend the datastream reference
@@ -3144,4 +4268,162 @@ int marfs_extend(marfs_fhandle stream, off_t length) {
    return -1;
 }
 
+/**
+ * Begin a parallel write session of the file referenced by the given marfs_fhandle,
+ * extending that file to the specified total size
+ * The produced session string can be passed to any number of other procs, each of which
+ * may then open its own portion of the file via marfs_pwrite_open(), with no further
+ * metadata access.
+ * NOTE -- The provided marfs_fhandle becomes the owner of the session, and should be
+ *         passed to marfs_close() once all session writers have been released.  This
+ *         completes the file with a single metadata update.
+ *         This function can only be performed if no data has been written to the target
+ *         file via this handle.
+ * @param marfs_fhandle stream : marfs_fhandle to be extended
+ * @param off_t length : Target total file length to extend to
+ * @param int writers : Number of writers which will participate in the session
+ * @param char** session : Reference to be populated with the session string
+ *                         ( caller is responsible for freeing this string )
+ * @return int : Zero on success, or -1 on failure
+ *    NOTE -- In most failure conditions, any previous marfs_fhandle reference will be
+ *            preserved ( continue to reference whatever file it previously referenced ).
+ *            However, it is possible for certain catastrophic error conditions to occur.
+ *            In such a case, errno will be set to EBADFD and any subsequent operations 
+ *            against the provided marfs_fhandle will fail, besides marfs_release().
+ */
+int marfs_pwrite_begin(marfs_fhandle stream, off_t length, int writers, char** session) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( stream == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // acquire the lock for an existing stream
+   if ( pthread_mutex_lock( &(stream->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_fhandle lock\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // a deferred packed file must be created before it can be otherwise referenced
+   if ( stream->pack  &&  pack_resolve( stream ) ) {
+      LOG( LOG_ERR, "Failed to create deferred packed file\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // any buffered data must be passed along first, as extension is only possible prior to writing
+   if ( flush_writebuf( stream ) ) {
+      LOG( LOG_ERR, "Failed to flush write-behind buffer\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // check for datastream reference
+   if ( stream->datastream ) {
+      // begin the session via the datastream reference
+      int retval = datastream_pwrite_begin( &(stream->datastream), length, writers, session );
+      if ( stream->datastream == NULL ) { stream->metahandle = NULL; } // don't allow invalid meta handle to persist
+      pthread_mutex_unlock( &(stream->lock) );
+      if ( retval == 0 ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
+      else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
+      return retval;
+   }
+   // meta only reference ( this function does not apply )
+   LOG( LOG_ERR, "Cannot extend a meta-only reference\n" );
+   pthread_mutex_unlock( &(stream->lock) );
+   errno = EINVAL;
+   LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+   return -1;
+}
+
+/**
+ * Open a new marfs_fhandle for the given writer of a parallel write session
+ * Each writer is assigned a contiguous range of whole data objects of the file, and the
+ * new handle is positioned at the start of that range.  Writes beyond the range are
+ * truncated, and the handle must be passed to marfs_release() once the entire range has
+ * been written.
+ * NOTE -- No metadata access is performed for the target file itself.
+ * @param marfs_ctxt ctxt : marfs_ctxt to operate within
+ * @param const char* path : Path of the target file ( used only to identify its NS )
+ * @param const char* session : Session string, produced by marfs_pwrite_begin()
+ * @param int rank : Index of this writer within the session ( beginning at zero )
+ * @param off_t* offset : Reference to be populated with the file offset of the range
+ * @param size_t* size : Reference to be populated with the size of the range
+ *                       ( may be zero, if the session has more writers than data objects )
+ * @return marfs_fhandle : marfs_fhandle referencing the writer's range, or NULL on failure
+ */
+marfs_fhandle marfs_pwrite_open(marfs_ctxt ctxt, const char* path, const char* session, int rank, off_t* offset, size_t* size) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( ctxt == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_ctxt arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // identify the path target
+   marfs_position oppos = { .ns = NULL, .depth = 0, .ctxt = NULL };
+   char* subpath = NULL;
+   int tgtdepth = pathshift( ctxt, path, &(subpath), &(oppos), 1 );
+   if ( tgtdepth < 0 ) {
+      LOG( LOG_ERR, "Failed to identify target info for pwrite op\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // check NS perms
+   if ( ( ctxt->itype != MARFS_INTERACTIVE  &&  !(oppos.ns->bperms & NS_WRITEDATA) )  ||
+        ( ctxt->itype != MARFS_BATCH        &&  !(oppos.ns->iperms & NS_WRITEDATA) ) ) {
+      LOG( LOG_ERR, "NS perms do not allow a pwrite op\n" );
+      pathcleanup( subpath, &oppos );
+      errno = EPERM;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( tgtdepth == 0 ) {
+      LOG( LOG_ERR, "Cannot target a MarFS NS with a pwrite op\n" );
+      pathcleanup( subpath, &oppos );
+      errno = EISDIR;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // allocate a fresh handle
+   marfs_fhandle stream = new_marfs_fhandle();
+   if ( stream == NULL ) {
+      pathcleanup( subpath, &oppos );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   stream->ns = config_duplicatensref( oppos.ns );
+   if ( stream->ns == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate op NS reference\n" );
+      pthread_mutex_destroy( &(stream->lock) );
+      pthread_cond_destroy( &(stream->preadcond) );
+      free( stream );
+      pathcleanup( subpath, &oppos );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // open the writer's datastream
+   if ( datastream_pwrite_open( &(stream->datastream), session, &oppos, rank, offset, size ) ) {
+      LOG( LOG_ERR, "Failure of datastream_pwrite_open()\n" );
+      int origerrno = errno;
+      config_destroynsref( stream->ns );
+      pthread_mutex_destroy( &(stream->lock) );
+      pthread_cond_destroy( &(stream->preadcond) );
+      free( stream );
+      pathcleanup( subpath, &oppos );
+      errno = origerrno;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   stream->flags = O_WRONLY;
+   stream->metahandle = NULL; // session writers never reference file metadata
+   stream->itype = ctxt->itype;
+   pathcleanup( subpath, &oppos );
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return stream;
+}
+
 
@@ -16,6 +16,8 @@ extern "C"
  */
 
 #include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 
 
@@ -34,6 +36,28 @@ typedef struct marfs_dhandle_struct *marfs_dhandle;
 
 typedef struct marfs_fhandle_struct *marfs_fhandle;
 
+// Directory entry, including entry attributes, as produced by marfs_readdirplus()
+typedef struct marfs_direntplus_struct {
+   struct dirent ent;   // entry info, as would be produced by marfs_readdir()
+   struct stat   st;    // attributes of the entry, as would be produced by marfs_stat() w/ AT_SYMLINK_NOFOLLOW
+   int           sterr; // zero if 'st' is valid, otherwise the errno value of the failed stat
+   long          loc;   // location of the dir handle following this entry ( see marfs_telldir() )
+} marfs_direntplus;
+
+// Field mask values of marfs_statx_many() ( matching the corresponding STATX_* values of statx() )
+#define MARFS_STAT_TYPE   0x001U // st_mode & S_IFMT
+#define MARFS_STAT_MODE   0x002U // st_mode & ~S_IFMT
+#define MARFS_STAT_NLINK  0x004U // st_nlink
+#define MARFS_STAT_UID    0x008U // st_uid
+#define MARFS_STAT_GID    0x010U // st_gid
+#define MARFS_STAT_ATIME  0x020U // st_atim
+#define MARFS_STAT_MTIME  0x040U // st_mtim
+#define MARFS_STAT_CTIME  0x080U // st_ctim
+#define MARFS_STAT_INO    0x100U // st_ino
+#define MARFS_STAT_SIZE   0x200U // st_size
+#define MARFS_STAT_BLOCKS 0x400U // st_blocks
+#define MARFS_STAT_ALL    0x7ffU // all of the above
+
 typedef enum
 {
 	MARFS_INTERACTIVE,
@@ -72,6 +96,29 @@ marfs_ctxt marfs_init(const char* configpath, marfs_interface type, pthread_mute
  */
 int marfs_setctag(marfs_ctxt ctxt, const char* ctag);
 
+/**
+ * Enable or disable packing of the small files of concurrent creators
+ * While enabled, files produced by marfs_creat() calls with a NULL marfs_fhandle arg are
+ * not created immediately.  Instead, their data is retained by the returned handle until
+ * it is closed, at which point the file is written out to one of a small pool of data
+ * streams shared by all such handles of this ctxt.  Each shared stream is closed once no
+ * further files are expected ( all deferred handles have been closed, the per-object file
+ * limit of the repo has been reached, or 'linger' msec have elapsed ), producing objects
+ * which hold the files of many independent creators.
+ * NOTE -- marfs_close() of such a handle will only return once the shared stream has been
+ *         closed, and will report any failure of that stream.  A failure of the shared
+ *         stream fails every file written to it, and none of those files will remain.
+ * NOTE -- Until closed, the file of such a handle does not exist in the namespace, and any
+ *         errors of the creation itself ( EEXIST, ENOENT, etc. ) are reported by marfs_close().
+ *         Any op on the handle besides marfs_write/close/release, or a write beyond 'maxsize'
+ *         bytes, causes the file to be created immediately via a dedicated stream instead.
+ * @param marfs_ctxt ctxt : marfs_ctxt to be updated
+ * @param size_t maxsize : Maximum data size of a packed file, or zero to disable packing
+ * @param unsigned int linger : Maximum msec to wait for further files to join a shared stream
+ * @return int : Zero on success, or -1 on failure
+ */
+int marfs_setpacking(marfs_ctxt ctxt, size_t maxsize, unsigned int linger);
+
 /**
  * Populate the given string with the config version of the provided marfs_ctxt
  * @param marfs_ctxt ctxt : marfs_ctxt to retrieve version info from
@@ -339,6 +386,37 @@ marfs_dhandle marfs_opendir(marfs_ctxt ctxt, const char *path);
  */
 struct dirent *marfs_readdir(marfs_dhandle handle);
 
+/**
+ * Iterate over the next entries of an open directory handle, retrieving the attributes of each
+ * NOTE -- This avoids the full path traversal of a marfs_stat() for each listed entry.
+ *         It also shares the position of the directory handle with marfs_readdir(),
+ *         marfs_telldir(), etc.
+ * @param marfs_dhandle handle : marfs_dhandle to read from
+ * @param marfs_direntplus* ents : Array of entries to be populated
+ * @param size_t count : Length of the 'ents' array
+ * @return ssize_t : Number of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
+ */
+ssize_t marfs_readdirplus(marfs_dhandle handle, marfs_direntplus* ents, size_t count);
+
+/**
+ * Stat many entries of an open directory handle, as marfs_stat() w/ AT_SYMLINK_NOFOLLOW would
+ * NOTE -- This avoids the full path traversal of a marfs_stat() for each entry, and allows
+ *         the MDAL to skip retrieval of unneeded fields and to issue stats in parallel.
+ * @param marfs_dhandle handle : marfs_dhandle containing all entries
+ * @param size_t count : Number of entries to stat
+ * @param const char** names : Names of the entries to stat ( as produced by marfs_readdir(),
+ *                             NOT paths containing '/' )
+ * @param unsigned int mask : Bitwise OR of the MARFS_STAT_* fields required by the caller
+ *                            ( the value of all other stat fields is undefined )
+ * @param struct stat* sts : Array of stat structures to be populated
+ * @param int* errs : Array to be populated with the errno value of each stat ( zero on success )
+ * @param int threads : Maximum number of threads to stat with ( zero or one for the calling thread alone )
+ * @return ssize_t : Number of successfully stat'd entries, or -1 if a failure occurred
+ */
+ssize_t marfs_statx_many(marfs_dhandle handle, size_t count, const char** names, unsigned int mask,
+                         struct stat* sts, int* errs, int threads);
+
 /**
  * Identify the ( abstract ) location of an open directory handle
  * NOTE -- This 'location' can be used via marfs_seekdir() to allow for the repeating
@@ -587,6 +665,12 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t size);
 
 /**
  * Write to the file currently referenced by the given marfs_fhandle
+ * NOTE -- For handles produced by marfs_creat(), small writes are coalesced into a
+ *         per-handle write-behind buffer ( sized to a multiple of the erasure stripe ),
+ *         which is passed along when full, on any non-sequential seek, and by
+ *         marfs_close/release/flush.  As a result, a failure to store buffered data may
+ *         only be reported by a later write, seek, or ( most importantly ) by the
+ *         close/release/flush of the handle.
  * @param marfs_fhandle stream : marfs_fhandle to be written to
  * @param const void* buf : Reference to the buffer containing data to be written
  * @param size_t count : Number of bytes to be written
@@ -673,6 +757,49 @@ int marfs_ftruncate(marfs_fhandle stream, off_t length);
  */
 int marfs_extend(marfs_fhandle stream, off_t length);
 
+/**
+ * Begin a parallel write session of the file referenced by the given marfs_fhandle,
+ * extending that file to the specified total size
+ * The produced session string can be passed to any number of other procs, each of which
+ * may then open its own portion of the file via marfs_pwrite_open(), with no further
+ * metadata access.
+ * NOTE -- The provided marfs_fhandle becomes the owner of the session, and should be
+ *         passed to marfs_close() once all session writers have been released.  This
+ *         completes the file with a single metadata update.
+ *         This function can only be performed if no data has been written to the target
+ *         file via this handle.
+ * @param marfs_fhandle stream : marfs_fhandle to be extended
+ * @param off_t length : Target total file length to extend to
+ * @param int writers : Number of writers which will participate in the session
+ * @param char** session : Reference to be populated with the session string
+ *                         ( caller is responsible for freeing this string )
+ * @return int : Zero on success, or -1 on failure
+ *    NOTE -- In most failure conditions, any previous marfs_fhandle reference will be
+ *            preserved ( continue to reference whatever file it previously referenced ).
+ *            However, it is possible for certain catastrophic error conditions to occur.
+ *            In such a case, errno will be set to EBADFD and any subsequent operations 
+ *            against the provided marfs_fhandle will fail, besides marfs_release().
+ */
+int marfs_pwrite_begin(marfs_fhandle stream, off_t length, int writers, char** session);
+
+/**
+ * Open a new marfs_fhandle for the given writer of a parallel write session
+ * Each writer is assigned a contiguous range of whole data objects of the file, and the
+ * new handle is positioned at the start of that range.  Writes beyond the range are
+ * truncated, and the handle must be passed to marfs_release() once the entire range has
+ * been written.
+ * NOTE -- No metadata access is performed for the target file itself.
+ * @param marfs_ctxt ctxt : marfs_ctxt to operate within
+ * @param const char* path : Path of the target file ( used only to identify its NS )
+ * @param const char* session : Session string, produced by marfs_pwrite_begin()
+ * @param int rank : Index of this writer within the session ( beginning at zero )
+ * @param off_t* offset : Reference to be populated with the file offset of the range
+ * @param size_t* size : Reference to be populated with the size of the range
+ *                       ( may be zero, if the session has more writers than data objects )
+ * @return marfs_fhandle : marfs_fhandle referencing the writer's range, or NULL on failure
+ */
+marfs_fhandle marfs_pwrite_open(marfs_ctxt ctxt, const char* path, const char* session, int rank, off_t* offset, size_t* size);
+
 /*
 Note -- in the case of parallel writing the workflow can be thought of like this:
 	Initialization:	marfs_creat(...) -> ohandle
@@ -687,6 +814,17 @@ Note -- in the case of parallel writing the workflow can be thought of like this
 			marfs_close( fhandle )
 			   OR
 			marfs_creat( newpath, fhandle ... )
+
+Alternatively, a parallel write session avoids all per-writer metadata access:
+	Initialization:	marfs_creat(...) -> ohandle
+			marfs_pwrite_begin( ohandle, total_length, writer_count, &session )
+			( distribute 'session' to all writers )
+	Parallel Write:	marfs_pwrite_open( ... session, rank, &offset, &size ) -> phandle
+			marfs_write( phandle ... ) -- exactly 'size' bytes
+			marfs_release( phandle )
+			( wait for all writers to release )
+	Finalization:	marfs_utimens( ohandle ... )
+			marfs_close( ohandle )
 */
 
 
@@ -8,7 +8,10 @@
  */
 
 
+// route all datastream writes of marfs.c through a wrapper, so that failures may be injected
+#define datastream_write test_datastream_write
 #include "marfs.c" // include C file directly, to allow traversal of all structures
+#undef datastream_write
 #include "config/config.h" // for config validation, alone
 
 #include <ftw.h>
@@ -58,6 +61,167 @@ int deletefstree( const char* basepath ) {
 }
 
 
+// parallel positional read thread state
+typedef struct preadarg_struct {
+   marfs_fhandle   handle;
+   const char* refbuffer;
+   off_t           start;
+   size_t         length;
+   int            result;
+} preadarg;
+
+void* preadthread( void* arg ) {
+   preadarg* parg = (preadarg*)arg;
+   parg->result = -1;
+   char* readbuf = malloc( parg->length );
+   if ( readbuf == NULL ) {
+      printf( "failed to allocate a %zu byte pread buffer\n", parg->length );
+      return NULL;
+   }
+   // read our range in sub-chunks, to exercise cursor reuse
+   size_t chunksize = parg->length / 4;
+   off_t curoffset = parg->start;
+   while ( curoffset < parg->start + parg->length ) {
+      size_t toread = chunksize;
+      if ( curoffset + toread > parg->start + parg->length ) { toread = (parg->start + parg->length) - curoffset; }
+      if ( marfs_read_at_offset( parg->handle, curoffset, readbuf + (curoffset - parg->start), toread ) != toread ) {
+         printf( "failed to pread %zu bytes at offset %zd\n", toread, curoffset );
+         free( readbuf );
+         return NULL;
+      }
+      curoffset += toread;
+   }
+   if ( memcmp( readbuf, parg->refbuffer + parg->start, parg->length ) ) {
+      printf( "unexpected content from pread range %zd - %zd\n", parg->start, parg->start + parg->length );
+      free( readbuf );
+      return NULL;
+   }
+   free( readbuf );
+   parg->result = 0;
+   return NULL;
+}
+
+
+// parallel write session writer thread state
+#define PWRITE_WRITERS 3
+#define PWRITE_LENGTH 712400
+typedef struct pwritearg_struct {
+   marfs_ctxt          ctxt;
+   const char*      session;
+   const char*    refbuffer;
+   int                 rank;
+   off_t             offset;
+   size_t              size;
+   int               result;
+} pwritearg;
+
+void* pwritethread( void* arg ) {
+   pwritearg* parg = (pwritearg*)arg;
+   parg->result = -1;
+   marfs_fhandle handle = marfs_pwrite_open( parg->ctxt, "gransom-allocation/sessionfile", parg->session,
+                                             parg->rank, &(parg->offset), &(parg->size) );
+   if ( handle == NULL ) {
+      printf( "failed to open session writer %d\n", parg->rank );
+      return NULL;
+   }
+   if ( parg->offset + parg->size + 100 > 1048576 ) {
+      printf( "range of session writer %d exceeds buffer limits\n", parg->rank );
+      return NULL;
+   }
+   // writes beyond our range should be truncated
+   if ( marfs_write( handle, parg->refbuffer + parg->offset, parg->size + 100 ) != parg->size ) {
+      printf( "failed to write %zu bytes via session writer %d\n", parg->size, parg->rank );
+      return NULL;
+   }
+   if ( marfs_release( handle ) ) {
+      printf( "failed to release session writer %d\n", parg->rank );
+      return NULL;
+   }
+   parg->result = 0;
+   return NULL;
+}
+
+
+// concurrent packed creator thread state
+#define PACK_THREADS 4
+#define PACK_ROUNDS 16
+typedef struct packarg_struct {
+   marfs_ctxt          ctxt;
+   pthread_barrier_t* barrier;
+   const char*   refbuffer;
+   int                 tnum;
+   int               result;
+} packarg;
+
+void* packthread( void* arg ) {
+   packarg* parg = (packarg*)arg;
+   parg->result = -1;
+   int round = 0;
+   for ( ; round < PACK_ROUNDS; round++ ) {
+      char fname[1024];
+      snprintf( fname, 1024, "gransom-allocation/concurrent-packed/cpfile%d-%d", parg->tnum, round );
+      marfs_fhandle handle = marfs_creat( parg->ctxt, NULL, fname, 0700 );
+      if ( handle == NULL ) {
+         printf( "failed to create '%s'\n", fname );
+         return NULL;
+      }
+      size_t length = 10 + ( ( parg->tnum * PACK_ROUNDS + round ) * 97 ) % 3000;
+      // write in two pieces, to exercise accumulation of deferred data
+      if ( marfs_write( handle, parg->refbuffer + parg->tnum, length / 2 ) != length / 2  ||
+           marfs_write( handle, parg->refbuffer + parg->tnum + length / 2, length - (length / 2) ) != length - (length / 2) ) {
+         printf( "failed to write to '%s'\n", fname );
+         return NULL;
+      }
+      // close all files of this round at once, so that they may share a single object
+      pthread_barrier_wait( parg->barrier );
+      if ( marfs_close( handle ) ) {
+         printf( "failed to close '%s'\n", fname );
+         return NULL;
+      }
+   }
+   parg->result = 0;
+   return NULL;
+}
+
+// packed creator thread which will fail its write to a shared stream
+#define PACK_FAILTNUM 2
+ssize_t datastream_write( DATASTREAM* stream, const void* buf, size_t count );
+__thread char failwrites = 0;
+ssize_t test_datastream_write( DATASTREAM* stream, const void* buf, size_t count ) {
+   if ( failwrites  &&  count > 1 ) {
+      // leave a partial write in the stream, as a failing object would
+      ssize_t writeres = datastream_write( stream, buf, count / 2 );
+      errno = EIO;
+      return writeres;
+   }
+   return datastream_write( stream, buf, count );
+}
+
+void* packfailthread( void* arg ) {
+   packarg* parg = (packarg*)arg;
+   char fname[1024];
+   snprintf( fname, 1024, "gransom-allocation/concurrent-packed/cpfail%d", parg->tnum );
+   marfs_fhandle handle = marfs_creat( parg->ctxt, NULL, fname, 0700 );
+   if ( handle == NULL ) {
+      printf( "failed to create '%s'\n", fname );
+      return NULL;
+   }
+   if ( marfs_write( handle, parg->refbuffer + parg->tnum, 1000 ) != 1000 ) {
+      printf( "failed to write to '%s'\n", fname );
+      return NULL;
+   }
+   if ( parg->tnum == PACK_FAILTNUM ) { failwrites = 1; }
+   pthread_barrier_wait( parg->barrier );
+   errno = 0;
+   parg->result = ( marfs_close( handle ) ) ? 1 : 0;
+   if ( parg->result  &&  parg->tnum == PACK_FAILTNUM  &&  errno != EIO ) {
+      printf( "unexpected errno of failed packed file '%s' ( %s )\n", fname, strerror(errno) );
+      parg->result = 2;
+   }
+   failwrites = 0;
+   return NULL;
+}
+
 int main( int argc, char** argv ) {
 
    // NOTE -- I'm ignoring memory leaks for error conditions
@@ -248,6 +412,43 @@ int main( int argc, char** argv ) {
       printf( "failed to close 'hpdstream'\n" );
       return -1;
    }
+   // create a file via many small, explicitly positioned writes ( as FUSE would issue them )
+   marfs_fhandle swstream = marfs_creat( batchctxt, NULL, "gransom-allocation/gasubdir/smallwrites", 0700 );
+   if ( swstream == NULL ) {
+      printf( "failed to create 'smallwrites'\n" );
+      return -1;
+   }
+   off_t swoffset = 0;
+   for ( ; swoffset < 1048576; swoffset += 4096 ) {
+      if ( marfs_seek( swstream, swoffset, SEEK_SET ) != swoffset ) {
+         printf( "failed to seek 'smallwrites' to offset %zd\n", swoffset );
+         return -1;
+      }
+      if ( marfs_write( swstream, oneMBbuffer + swoffset, 4096 ) != 4096 ) {
+         printf( "failed to write 4096 bytes to 'smallwrites' @ offset %zd\n", swoffset );
+         return -1;
+      }
+   }
+   // a non-sequential seek should flush buffered data and zero-fill the gap
+   if ( marfs_seek( swstream, 1048576 + 1000, SEEK_SET ) != 1048576 + 1000 ) {
+      printf( "failed to seek 'smallwrites' past a 1000 byte gap\n" );
+      return -1;
+   }
+   if ( marfs_write( swstream, oneMBbuffer, 5000 ) != 5000 ) {
+      printf( "failed to write tail of 'smallwrites'\n" );
+      return -1;
+   }
+   // chunk bounds lookup must pass along, and not lose, any still-buffered data
+   off_t swchunkoff = -1;
+   size_t swchunksize = 0;
+   if ( marfs_chunkbounds( swstream, 0, &(swchunkoff), &(swchunksize) )  ||  swchunkoff != 0 ) {
+      printf( "failed to identify chunk bounds of 'smallwrites'\n" );
+      return -1;
+   }
+   if ( marfs_close( swstream ) ) {
+      printf( "failed to close 'smallwrites'\n" );
+      return -1;
+   }
 
    // create a couple of files in the GhostNS
    marfs_fhandle ghoststream = marfs_creat( batchctxt, NULL, "ghost-gransom/gfile1", 0621 );
@@ -492,6 +693,97 @@ int main( int argc, char** argv ) {
    }
 
 
+   // write out a file via a parallel write session
+   marfs_fhandle shandle = marfs_creat( batchctxt, NULL, "gransom-allocation/sessionfile", 0600 );
+   if ( shandle == NULL ) {
+      printf( "failed to create 'sessionfile'\n" );
+      return -1;
+   }
+   char* session = NULL;
+   if ( marfs_pwrite_begin( shandle, PWRITE_LENGTH, PWRITE_WRITERS, &(session) ) ) {
+      printf( "failed to begin a parallel write session of 'sessionfile'\n" );
+      return -1;
+   }
+   off_t soffset = 0;
+   size_t ssize = 0;
+   errno = 0;
+   if ( marfs_pwrite_open( batchctxt, "gransom-allocation/sessionfile", session, PWRITE_WRITERS, &(soffset), &(ssize) )  ||
+        errno != EINVAL ) {
+      printf( "session writer rank beyond the writer count was not rejected\n" );
+      return -1;
+   }
+   pthread_t pwritethreads[PWRITE_WRITERS];
+   pwritearg pwriteargs[PWRITE_WRITERS];
+   for ( index = 0; index < PWRITE_WRITERS; index++ ) {
+      pwriteargs[index].ctxt = batchctxt;
+      pwriteargs[index].session = session;
+      pwriteargs[index].refbuffer = oneMBbuffer;
+      pwriteargs[index].rank = index;
+      pwriteargs[index].result = -1;
+      if ( pthread_create( pwritethreads + index, NULL, pwritethread, pwriteargs + index ) ) {
+         printf( "failed to create session writer thread %d\n", index );
+         return -1;
+      }
+   }
+   for ( index = 0; index < PWRITE_WRITERS; index++ ) {
+      if ( pthread_join( pwritethreads[index], NULL ) ) {
+         printf( "failed to join session writer thread %d\n", index );
+         return -1;
+      }
+      if ( pwriteargs[index].result ) {
+         printf( "session writer %d failed\n", index );
+         return -1;
+      }
+   }
+   free( session );
+   // writer ranges should exactly cover the file, in rank order
+   soffset = 0;
+   for ( index = 0; index < PWRITE_WRITERS; index++ ) {
+      if ( pwriteargs[index].offset != soffset ) {
+         printf( "range of session writer %d begins at %zd, rather than %zd\n", index, pwriteargs[index].offset, soffset );
+         return -1;
+      }
+      soffset += pwriteargs[index].size;
+   }
+   if ( soffset != PWRITE_LENGTH ) {
+      printf( "session writer ranges cover %zd bytes, rather than %d\n", soffset, PWRITE_LENGTH );
+      return -1;
+   }
+   if ( marfs_close( shandle ) ) {
+      printf( "failed to close the owner of the 'sessionfile' session\n" );
+      return -1;
+   }
+   if ( marfs_stat( interctxt, "/campaign/gransom-allocation/sessionfile", &(stval), 0 )  ||
+        stval.st_size != PWRITE_LENGTH ) {
+      printf( "unexpected stat info of 'sessionfile'\n" );
+      return -1;
+   }
+   shandle = marfs_open( batchctxt, NULL, "gransom-allocation/sessionfile", O_RDONLY );
+   if ( shandle == NULL ) {
+      printf( "failed to open 'sessionfile' for read\n" );
+      return -1;
+   }
+   char* sreadbuf = malloc( PWRITE_LENGTH );
+   if ( sreadbuf == NULL ) {
+      printf( "failed to allocate a read buffer for 'sessionfile'\n" );
+      return -1;
+   }
+   if ( marfs_read( shandle, sreadbuf, PWRITE_LENGTH ) != PWRITE_LENGTH  ||
+        memcmp( sreadbuf, oneMBbuffer, PWRITE_LENGTH ) ) {
+      printf( "unexpected content of 'sessionfile'\n" );
+      return -1;
+   }
+   free( sreadbuf );
+   if ( marfs_close( shandle ) ) {
+      printf( "failed to close read handle of 'sessionfile'\n" );
+      return -1;
+   }
+   if ( marfs_unlink( batchctxt, "gransom-allocation/sessionfile" ) ) {
+      printf( "failed to unlink 'sessionfile'\n" );
+      return -1;
+   }
+
+
    // read back written files
    void* oneMBreadbuf = calloc( 1024, 1024 );
    if ( oneMBreadbuf == NULL ) {
@@ -610,6 +902,45 @@ int main( int argc, char** argv ) {
       printf( "104857 bytes of 'file1' @ offset 600000 do not match expectations\n" );
       return -1;
    }
+   // perform parallel positional reads of distinct ranges
+   pthread_t preadthreads[4];
+   preadarg preadargs[4];
+   for ( index = 0; index < 4; index++ ) {
+      preadargs[index].handle = phandle;
+      preadargs[index].refbuffer = oneMBbuffer;
+      preadargs[index].start = index * (1048576 / 4);
+      preadargs[index].length = (1048576 / 4) - ( (index == 3) ? 17 : 0 );
+      preadargs[index].result = -1;
+      if ( pthread_create( preadthreads + index, NULL, preadthread, preadargs + index ) ) {
+         printf( "failed to create pread thread %d\n", index );
+         return -1;
+      }
+   }
+   for ( index = 0; index < 4; index++ ) {
+      if ( pthread_join( preadthreads[index], NULL ) ) {
+         printf( "failed to join pread thread %d\n", index );
+         return -1;
+      }
+      if ( preadargs[index].result ) {
+         printf( "pread thread %d reported failure\n", index );
+         return -1;
+      }
+   }
+   // positional reads at and beyond EOF should produce zero bytes
+   if ( marfs_read_at_offset( phandle, 1048576, oneMBreadbuf, 1024 ) != 0 ) {
+      printf( "unexpected result of 'file1' pread at EOF\n" );
+      return -1;
+   }
+   // positional reads should not have altered the handle position
+   bzero( oneMBreadbuf, 1048576 );
+   if ( marfs_read( phandle, oneMBreadbuf, 1000 ) != 1000 ) {
+      printf( "failed to read 1000 bytes from 'file1' @ offset 704857\n" );
+      return -1;
+   }
+   if ( memcmp( oneMBreadbuf, oneMBbuffer + 704857, 1000 ) ) {
+      printf( "1000 bytes of 'file1' @ offset 704857 do not match expectations\n" );
+      return -1;
+   }
    if ( marfs_close( phandle ) ) {
       printf( "failed to close 'file1' read handle\n" );
       return -1;
@@ -633,6 +964,329 @@ int main( int argc, char** argv ) {
       printf( "failed to close 'file2' read handle\n" );
       return -1;
    }
+   // verify the content of 'smallwrites'
+   phandle = marfs_open( interctxt, NULL, "../gasubdir/smallwrites", O_RDONLY );
+   if ( phandle == NULL ) {
+      printf( "failed to open 'smallwrites' for read\n" );
+      return -1;
+   }
+   bzero( oneMBreadbuf, 1048576 );
+   if ( marfs_read( phandle, oneMBreadbuf, 1048576 ) != 1048576 ) {
+      printf( "failed to read first 1MB of 'smallwrites'\n" );
+      return -1;
+   }
+   if ( memcmp( oneMBreadbuf, oneMBbuffer, 1048576 ) ) {
+      printf( "unexpected content of first 1MB of 'smallwrites'\n" );
+      return -1;
+   }
+   memset( oneMBreadbuf, 1, 6000 );
+   if ( marfs_read( phandle, oneMBreadbuf, 1048576 ) != 6000 ) {
+      printf( "failed to read tail of 'smallwrites'\n" );
+      return -1;
+   }
+   for ( index = 0; index < 1000; index++ ) {
+      if ( ((char*)oneMBreadbuf)[index] ) {
+         printf( "unexpected non-zero byte at offset %d of 'smallwrites' gap\n", index );
+         return -1;
+      }
+   }
+   if ( memcmp( oneMBreadbuf + 1000, oneMBbuffer, 5000 ) ) {
+      printf( "unexpected content of 'smallwrites' tail\n" );
+      return -1;
+   }
+   if ( marfs_close( phandle ) ) {
+      printf( "failed to close 'smallwrites' read handle\n" );
+      return -1;
+   }
+
+   // enable packing of concurrent creators, and produce many small files in parallel
+   if ( marfs_mkdir( batchctxt, "gransom-allocation/concurrent-packed", 0700 ) ) {
+      printf( "failed to create 'gransom-allocation/concurrent-packed'\n" );
+      return -1;
+   }
+   if ( marfs_setpacking( batchctxt, 4096, 10000 ) ) {
+      printf( "failed to enable packing of concurrent creators\n" );
+      return -1;
+   }
+   pthread_barrier_t packbarrier;
+   if ( pthread_barrier_init( &packbarrier, NULL, PACK_THREADS ) ) {
+      printf( "failed to initialize packing barrier\n" );
+      return -1;
+   }
+   pthread_t packthreads[PACK_THREADS];
+   packarg packargs[PACK_THREADS];
+   for ( index = 0; index < PACK_THREADS; index++ ) {
+      packargs[index].ctxt = batchctxt;
+      packargs[index].barrier = &packbarrier;
+      packargs[index].refbuffer = oneMBbuffer;
+      packargs[index].tnum = index;
+      packargs[index].result = -1;
+      if ( pthread_create( packthreads + index, NULL, packthread, packargs + index ) ) {
+         printf( "failed to create packing thread %d\n", index );
+         return -1;
+      }
+   }
+   for ( index = 0; index < PACK_THREADS; index++ ) {
+      if ( pthread_join( packthreads[index], NULL ) ) {
+         printf( "failed to join packing thread %d\n", index );
+         return -1;
+      }
+      if ( packargs[index].result ) {
+         printf( "packing thread %d reported failure\n", index );
+         return -1;
+      }
+   }
+   pthread_barrier_destroy( &packbarrier );
+   // a released deferred file should never be created
+   phandle = marfs_creat( batchctxt, NULL, "gransom-allocation/concurrent-packed/released", 0700 );
+   if ( phandle == NULL  ||  marfs_release( phandle ) ) {
+      printf( "failed to create and release 'released'\n" );
+      return -1;
+   }
+   // a single failed write should fail its own file, and remove any file sharing its stream
+   if ( pthread_barrier_init( &packbarrier, NULL, PACK_THREADS ) ) {
+      printf( "failed to initialize packing barrier\n" );
+      return -1;
+   }
+   for ( index = 0; index < PACK_THREADS; index++ ) {
+      packargs[index].result = -1;
+      if ( pthread_create( packthreads + index, NULL, packfailthread, packargs + index ) ) {
+         printf( "failed to create packing thread %d\n", index );
+         return -1;
+      }
+   }
+   for ( index = 0; index < PACK_THREADS; index++ ) {
+      if ( pthread_join( packthreads[index], NULL ) ) {
+         printf( "failed to join packing thread %d\n", index );
+         return -1;
+      }
+   }
+   pthread_barrier_destroy( &packbarrier );
+   for ( index = 0; index < PACK_THREADS; index++ ) {
+      char fname[1024];
+      snprintf( fname, 1024, "gransom-allocation/concurrent-packed/cpfail%d", index );
+      if ( packargs[index].result < 0  ||  packargs[index].result > 1  ||
+           ( index == PACK_FAILTNUM  &&  packargs[index].result == 0 ) ) {
+         printf( "unexpected close result of '%s' ( %d )\n", fname, packargs[index].result );
+         return -1;
+      }
+      errno = 0;
+      phandle = marfs_open( batchctxt, NULL, fname, O_RDONLY );
+      if ( packargs[index].result ) {
+         if ( phandle  ||  errno != ENOENT ) {
+            printf( "failed packed file '%s' was not removed\n", fname );
+            return -1;
+         }
+         continue;
+      }
+      bzero( oneMBreadbuf, 4096 );
+      if ( phandle == NULL  ||  marfs_read( phandle, oneMBreadbuf, 4096 ) != 1000  ||
+           memcmp( oneMBreadbuf, oneMBbuffer + index, 1000 ) ) {
+         printf( "unexpected content of '%s'\n", fname );
+         return -1;
+      }
+      if ( marfs_close( phandle )  ||  marfs_unlink( batchctxt, fname ) ) {
+         printf( "failed to close and unlink '%s'\n", fname );
+         return -1;
+      }
+   }
+   if ( marfs_setpacking( batchctxt, 0, 0 ) ) {
+      printf( "failed to disable packing of concurrent creators\n" );
+      return -1;
+   }
+   // verify the content of all packed files, and that each round shared a single object
+   char* packstreams[PACK_ROUNDS];
+   for ( index = 0; index < PACK_ROUNDS * PACK_THREADS; index++ ) {
+      int tnum = index % PACK_THREADS;
+      int round = index / PACK_THREADS;
+      char fname[1024];
+      snprintf( fname, 1024, "gransom-allocation/concurrent-packed/cpfile%d-%d", tnum, round );
+      size_t length = 10 + ( ( tnum * PACK_ROUNDS + round ) * 97 ) % 3000;
+      phandle = marfs_open( batchctxt, NULL, fname, O_RDONLY );
+      if ( phandle == NULL ) {
+         printf( "failed to open '%s' for read\n", fname );
+         return -1;
+      }
+      bzero( oneMBreadbuf, 4096 );
+      if ( marfs_read( phandle, oneMBreadbuf, 4096 ) != length  ||
+           memcmp( oneMBreadbuf, oneMBbuffer + tnum, length ) ) {
+         printf( "unexpected content of '%s'\n", fname );
+         return -1;
+      }
+      FTAG* ftag = &(phandle->datastream->files[phandle->datastream->curfile].ftag);
+      if ( tnum == 0 ) { packstreams[round] = strdup( ftag->streamid ); }
+      else if ( strcmp( packstreams[round], ftag->streamid ) ) {
+         printf( "'%s' was not packed with the other files of its round\n", fname );
+         return -1;
+      }
+      if ( marfs_close( phandle ) ) {
+         printf( "failed to close '%s' read handle\n", fname );
+         return -1;
+      }
+      if ( marfs_unlink( batchctxt, fname ) ) {
+         printf( "failed to unlink '%s'\n", fname );
+         return -1;
+      }
+   }
+   for ( index = 0; index < PACK_ROUNDS; index++ ) { free( packstreams[index] ); }
+   errno = 0;
+   if ( marfs_unlink( batchctxt, "gransom-allocation/concurrent-packed/released" ) == 0  ||  errno != ENOENT ) {
+      printf( "released deferred file unexpectedly exists\n" );
+      return -1;
+   }
+   if ( marfs_rmdir( batchctxt, "gransom-allocation/concurrent-packed" ) ) {
+      printf( "failed to rmdir 'gransom-allocation/concurrent-packed'\n" );
+      return -1;
+   }
+
+   // list packed files via readdirplus, comparing against marfs_readdir() / marfs_stat() results
+   marfs_dhandle pfdhandle = marfs_opendir( batchctxt, "gransom-allocation/packed-files" );
+   if ( pfdhandle == NULL ) {
+      printf( "failed to open 'gransom-allocation/packed-files'\n" );
+      return -1;
+   }
+   marfs_direntplus* plusents = calloc( 100, sizeof( marfs_direntplus ) );
+   if ( plusents == NULL ) {
+      printf( "failed to allocate readdirplus entries\n" );
+      return -1;
+   }
+   int pfilecount = 0;
+   long seekloc = -1;
+   char seekfollower[256] = {0};
+   ssize_t plusres;
+   while ( (plusres = marfs_readdirplus( pfdhandle, plusents, 100 )) > 0 ) {
+      for ( index = 0; index < plusres; index++ ) {
+         marfs_direntplus* pent = plusents + index;
+         if ( seekloc >= 0  &&  seekfollower[0] == '\0' ) {
+            snprintf( seekfollower, 256, "%s", pent->ent.d_name );
+         }
+         if ( strncmp( pent->ent.d_name, "pfile", 5 ) ) { continue; } // skip '.' and '..'
+         if ( pent->sterr ) {
+            printf( "readdirplus failed to stat \"%s\" ( %s )\n", pent->ent.d_name, strerror(pent->sterr) );
+            return -1;
+         }
+         if ( pfilecount % 512 == 0 ) {
+            char fname[1024];
+            snprintf( fname, 1024, "gransom-allocation/packed-files/%s", pent->ent.d_name );
+            struct stat pstval;
+            if ( marfs_stat( batchctxt, fname, &(pstval), AT_SYMLINK_NOFOLLOW ) ) {
+               printf( "failed to stat \"%s\"\n", fname );
+               return -1;
+            }
+            if ( pstval.st_ino != pent->st.st_ino  ||  pstval.st_size != pent->st.st_size  ||
+                 pstval.st_nlink != pent->st.st_nlink  ||  pstval.st_blocks != pent->st.st_blocks  ||
+                 pstval.st_mode != pent->st.st_mode ) {
+               printf( "readdirplus stat of \"%s\" does not match marfs_stat() values\n", fname );
+               return -1;
+            }
+            if ( seekloc < 0 ) { seekloc = pent->loc; }
+         }
+         pfilecount++;
+      }
+   }
+   if ( plusres < 0 ) {
+      printf( "failed to readdirplus 'gransom-allocation/packed-files'\n" );
+      return -1;
+   }
+   if ( pfilecount != 4096 ) {
+      printf( "readdirplus produced %d packed files, rather than the expected 4096\n", pfilecount );
+      return -1;
+   }
+   // entry locations should be valid seek targets for marfs_readdir()
+   if ( marfs_seekdir( pfdhandle, seekloc ) ) {
+      printf( "failed to seek to readdirplus entry location\n" );
+      return -1;
+   }
+   struct dirent* pfdent = marfs_readdir( pfdhandle );
+   if ( pfdent == NULL  ||  strcmp( pfdent->d_name, seekfollower ) ) {
+      printf( "readdir following seek produced \"%s\", rather than \"%s\"\n",
+              (pfdent) ? pfdent->d_name : "NULL", seekfollower );
+      return -1;
+   }
+   // bulk stat many packed files, plus a couple of invalid entries
+   char** statnames = calloc( 258, sizeof( char* ) );
+   struct stat* statsts = calloc( 258, sizeof( struct stat ) );
+   int* staterrs = calloc( 258, sizeof( int ) );
+   if ( statnames == NULL  ||  statsts == NULL  ||  staterrs == NULL ) {
+      printf( "failed to allocate bulk stat arrays\n" );
+      return -1;
+   }
+   for ( index = 0; index < 256; index++ ) {
+      statnames[index] = malloc( sizeof(char) * 32 );
+      if ( statnames[index] == NULL ) {
+         printf( "failed to allocate bulk stat name\n" );
+         return -1;
+      }
+      snprintf( statnames[index], 32, "pfile%d", index * 16 );
+   }
+   statnames[256] = "nonexistent";
+   statnames[257] = "../packed-files/pfile0";
+   if ( marfs_statx_many( pfdhandle, 258, (const char**)statnames, MARFS_STAT_SIZE | MARFS_STAT_NLINK | MARFS_STAT_MTIME,
+                          statsts, staterrs, 4 ) != 256 ) {
+      printf( "bulk stat of packed files produced an unexpected success count\n" );
+      return -1;
+   }
+   if ( staterrs[256] != ENOENT  ||  staterrs[257] != EINVAL ) {
+      printf( "bulk stat of invalid entries produced unexpected errors ( %d, %d )\n", staterrs[256], staterrs[257] );
+      return -1;
+   }
+   for ( index = 0; index < 256; index += 37 ) {
+      char fname[1024];
+      snprintf( fname, 1024, "gransom-allocation/packed-files/%s", statnames[index] );
+      struct stat pstval;
+      if ( marfs_stat( batchctxt, fname, &(pstval), AT_SYMLINK_NOFOLLOW ) ) {
+         printf( "failed to stat \"%s\"\n", fname );
+         return -1;
+      }
+      if ( staterrs[index]  ||  pstval.st_size != statsts[index].st_size  ||  pstval.st_nlink != statsts[index].st_nlink  ||
+           pstval.st_mtim.tv_sec != statsts[index].st_mtim.tv_sec  ||  !(S_ISREG( statsts[index].st_mode )) ) {
+         printf( "bulk stat of \"%s\" does not match marfs_stat() values\n", fname );
+         return -1;
+      }
+   }
+   for ( index = 0; index < 256; index++ ) { free( statnames[index] ); }
+   free( statnames );
+   free( statsts );
+   free( staterrs );
+   if ( marfs_closedir( pfdhandle ) ) {
+      printf( "failed to close 'gransom-allocation/packed-files'\n" );
+      return -1;
+   }
+   // subspaces should be listed, as directories, at the root of a NS
+   pfdhandle = marfs_opendir( batchctxt, "gransom-allocation" );
+   if ( pfdhandle == NULL ) {
+      printf( "failed to open 'gransom-allocation'\n" );
+      return -1;
+   }
+   plusres = marfs_readdirplus( pfdhandle, plusents, 100 );
+   char foundsubspace = 0;
+   for ( index = 0; index < plusres; index++ ) {
+      if ( strcmp( plusents[index].ent.d_name, "read-only-data" ) == 0 ) {
+         if ( plusents[index].sterr  ||  !(S_ISDIR( plusents[index].st.st_mode )) ) {
+            printf( "readdirplus of subspace 'read-only-data' produced invalid stat info\n" );
+            return -1;
+         }
+         foundsubspace = 1;
+      }
+   }
+   if ( !(foundsubspace) ) {
+      printf( "readdirplus of 'gransom-allocation' did not list subspace 'read-only-data'\n" );
+      return -1;
+   }
+   // bulk stat at the root of a NS should report subspaces, but hide reserved entries
+   const char* rootnames[2] = { "read-only-data", "MDAL_reference" };
+   struct stat rootsts[2];
+   int rooterrs[2];
+   if ( marfs_statx_many( pfdhandle, 2, rootnames, MARFS_STAT_TYPE, rootsts, rooterrs, 0 ) != 1  ||
+        rooterrs[0]  ||  !(S_ISDIR( rootsts[0].st_mode ))  ||  rooterrs[1] != ENOENT ) {
+      printf( "unexpected bulk stat results at the root of 'gransom-allocation'\n" );
+      return -1;
+   }
+   if ( marfs_closedir( pfdhandle ) ) {
+      printf( "failed to close 'gransom-allocation'\n" );
+      return -1;
+   }
+   free( plusents );
 
 
    // free buffers
@@ -671,6 +1325,10 @@ int main( int argc, char** argv ) {
       printf( "failed to unlink 'gransom-allocation/gasubdir/file2'\n" );
       return -1;
    }
+   if ( marfs_unlink( batchctxt, "gransom-allocation/gasubdir/smallwrites" ) ) {
+      printf( "failed to unlink 'gransom-allocation/gasubdir/smallwrites'\n" );
+      return -1;
+   }
    if ( marfs_unlink( batchctxt, "ghost-gransom/gfile1" ) ) {
       printf( "failed to unlink 'ghost-gransom/gfile1'\n" );
       return -1;
@@ -0,0 +1,105 @@
+#ifndef __MARFS_COPYRIGHT_H__
+#define __MARFS_COPYRIGHT_H__
+
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#endif
+
+#include "marfs_auto_config.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+
+#define PROGNAME "marfs-compileconf"
+#define OUTPREFX PROGNAME ": "
+
+
+int main(int argc, const char** argv) {
+   errno = 0; // init to zero (apparently not guaranteed)
+   char* config_path = getenv( "MARFS_CONFIG_PATH" ); // check for config env var
+   char* snap_path = NULL;
+
+   // parse all position-independent arguments
+   char pr_usage = 0;
+   int c;
+   while ((c = getopt(argc, (char* const*)argv, "c:o:h")) != -1) {
+      switch (c) {
+      case 'c':
+         config_path = optarg;
+         break;
+      case 'o':
+         snap_path = optarg;
+         break;
+      case '?':
+         printf( OUTPREFX "ERROR: Unrecognized cmdline argument: \'%c\'\n", optopt );
+      case 'h':
+         pr_usage = 1;
+         break;
+      default:
+         printf("ERROR: Failed to parse command line options\n");
+         return -1;
+      }
+   }
+
+   // check if we need to print usage info
+   if (pr_usage) {
+      printf(OUTPREFX "Usage info --\n");
+      printf(OUTPREFX "%s [-c configpath] [-o snapshotpath] [-h]\n", PROGNAME);
+      printf(OUTPREFX "   -c : Path of the MarFS config file ( will use MARFS_CONFIG_PATH env var, if omitted )\n");
+      printf(OUTPREFX "   -o : Path of the snapshot to be produced ( will use \"<configpath>.snap\", if omitted )\n");
+      printf(OUTPREFX "   -h : Print this usage info\n");
+      printf(OUTPREFX "Any snapshot at \"<configpath>.snap\" ( or at the MARFS_CONFIG_SNAPSHOT env var path ) will be\n");
+      printf(OUTPREFX "loaded in place of the config file, so long as the config file remains unmodified.\n");
+      return -1;
+   }
+
+   // verify that a config was defined
+   if (config_path == NULL) {
+      printf(OUTPREFX "ERROR: no config path defined ( '-c' arg or MARFS_CONFIG_PATH env var )\n");
+      return -1;
+   }
+
+   // identify the default snapshot path
+   char* def_path = NULL;
+   if ( snap_path == NULL ) {
+      def_path = malloc( sizeof(char) * ( strlen( config_path ) + 6 ) );
+      if ( def_path == NULL ) {
+         printf(OUTPREFX "ERROR: Failed to allocate snapshot path\n");
+         return -1;
+      }
+      sprintf( def_path, "%s.snap", config_path );
+      snap_path = def_path;
+   }
+
+   // compile the marfs config
+   pthread_mutex_t erasurelock;
+   if ( pthread_mutex_init( &erasurelock, NULL ) ) {
+      printf( OUTPREFX "ERROR: failed to initialize erasure lock\n" );
+      if ( def_path ) { free( def_path ); }
+      return -1;
+   }
+   int retval = 0;
+   if ( config_compile( config_path, snap_path, &erasurelock ) ) {
+      printf(OUTPREFX "ERROR: Failed to compile config \"%s\" into snapshot \"%s\" ( %s )\n",
+             config_path, snap_path, strerror(errno));
+      retval = -1;
+   }
+   else {
+      printf(OUTPREFX "Compiled config \"%s\" into snapshot \"%s\"\n", config_path, snap_path);
+   }
+   pthread_mutex_destroy( &erasurelock );
+   if ( def_path ) { free( def_path ); }
+   return retval;
+}
@@ -121,6 +121,12 @@
 #include "general_include/numdigits.h"
 #include "general_include/restrictedchars.h"
 
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <libxml/tree.h>
 
 #ifndef LIBXML_TREE_ENABLED
@@ -1523,12 +1529,12 @@ int create_namespace( HASH_NODE* nsnode, marfs_ns* pnamespace, marfs_repo* prepo
 }
 
 /**
- * Create a new HASH_TABLE, based on the content of the given distribution node
- * @param int* count : Integer to be populated with the count of distribution targets
+ * Parse the node list of a distribution table, based on the content of the given distribution node
+ * @param size_t* count : Reference to be populated with the count of distribution targets
  * @param xmlNode* distroot : Xml node containing distribution info
- * @return HASH_TABLE : Newly created HASH_TABLE, or NULL if a failure occurred
+ * @return HASH_NODE* : Newly allocated node list, or NULL if a failure occurred
  */
-HASH_TABLE create_distribution_table( int* count, xmlNode* distroot ) {
+HASH_NODE* parse_distribution( size_t* count, xmlNode* distroot ) {
    // iterate over attributes, looking for cnt and dweight values
    int dweight = 1;
    size_t nodecount = 0;
@@ -1728,11 +1734,22 @@ HASH_TABLE create_distribution_table( int* count, xmlNode* distroot ) {
       return NULL;
    }
 
-   // finally, initialize the hash table
+   // populate the provided count value
+   *count = nodecount;
+   return nodelist;
+}
+
+/**
+ * Create a new distribution HASH_TABLE from the given node list, freeing the list on failure
+ * @param HASH_NODE* nodelist : Node list of the distribution, as produced by parse_distribution()
+ * @param size_t nodecount : Count of nodes in the list
+ * @return HASH_TABLE : Newly created HASH_TABLE, or NULL if a failure occurred
+ */
+HASH_TABLE init_distribution_table( HASH_NODE* nodelist, size_t nodecount ) {
    HASH_TABLE table = hash_init( nodelist, nodecount, 0 ); // NOT a lookup table
    // verify success
    if ( table == NULL ) {
-      LOG( LOG_ERR, "failed to initialize hash table for %s distribution\n", (char*)distroot->name );
+      LOG( LOG_ERR, "failed to initialize hash table for distribution of %zu nodes\n", nodecount );
       // free all name strings
       size_t freenode;
       for ( freenode = 0; freenode < nodecount; freenode++ ) {
@@ -1742,7 +1759,21 @@ HASH_TABLE create_distribution_table( int* count, xmlNode* distroot ) {
       free( nodelist );
       return NULL;
    }
+   return table;
+}
 
+/**
+ * Create a new HASH_TABLE, based on the content of the given distribution node
+ * @param int* count : Integer to be populated with the count of distribution targets
+ * @param xmlNode* distroot : Xml node containing distribution info
+ * @return HASH_TABLE : Newly created HASH_TABLE, or NULL if a failure occurred
+ */
+HASH_TABLE create_distribution_table( int* count, xmlNode* distroot ) {
+   size_t nodecount = 0;
+   HASH_NODE* nodelist = parse_distribution( &(nodecount), distroot );
+   if ( nodelist == NULL ) { return NULL; }
+   HASH_TABLE table = init_distribution_table( nodelist, nodecount );
+   if ( table == NULL ) { return NULL; }
    // populate the provided count value
    *count = (int)nodecount;
    // return the created table
@@ -1808,6 +1839,14 @@ int free_repo( marfs_repo* repo ) {
       if ( target == 0 ) { ttable = repo->datascheme.podtable; }
       else if ( target == 1 ) { ttable = repo->datascheme.captable; }
       else { ttable = repo->datascheme.scattertable; }
+      // free the node list of any table which was never created
+      if ( ttable == NULL  &&  repo->datascheme.distnodes[target] ) {
+         size_t nodeindex = 0;
+         for( ; nodeindex < repo->datascheme.distcounts[target]; nodeindex++ ) {
+            free( repo->datascheme.distnodes[target][nodeindex].name );
+         }
+         free( repo->datascheme.distnodes[target] );
+      }
       // skip this table if it was never allocated
       if ( ttable == NULL ) { continue; }
       // otherwise, free the table
@@ -1825,11 +1864,40 @@ int free_repo( marfs_repo* repo ) {
       }
    }
 
+   if ( repo->datascheme.dalxml ) { free( repo->datascheme.dalxml ); }
+   if ( repo->datascheme.erasurelock ) { pthread_mutex_destroy( &(repo->datascheme.initlock) ); }
+
    free( repo->name );
 
    return retval;
 }
 
+/**
+ * Initialize the lazy initialization state of the given datascheme
+ * @param marfs_ds* ds : Datascheme to be initialized
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return int : Zero on success, or -1 on failure
+ */
+int init_dslazystate( marfs_ds* ds, pthread_mutex_t* erasurelock ) {
+   int target;
+   for ( target = 0; target < 3; target++ ) {
+      ds->distnodes[target] = NULL;
+      ds->distcounts[target] = 0;
+   }
+   ds->maxloc.pod = 0;
+   ds->maxloc.cap = 0;
+   ds->maxloc.scatter = 0;
+   ds->dalxml = NULL;
+   ds->initialized = 0;
+   ds->erasurelock = NULL;
+   if ( pthread_mutex_init( &(ds->initlock), NULL ) ) {
+      LOG( LOG_ERR, "failed to initialize datascheme init lock\n" );
+      return -1;
+   }
+   ds->erasurelock = erasurelock;
+   return 0;
+}
+
 /**
  * Parse the given datascheme xml node to populate the given datascheme structure
  * @param marfs_ds* ds : Datascheme to be populated
@@ -1839,7 +1907,11 @@ int free_repo( marfs_repo* repo ) {
  */
 int parse_datascheme( marfs_ds* ds, xmlNode* dataroot, pthread_mutex_t* erasurelock ) {
    xmlNode* dalnode = NULL;
-   ne_location maxloc = { .pod = 0, .cap = 0, .scatter = 0 };
+   // distribution tables and the NE context are only materialized on first use
+   if ( init_dslazystate( ds, erasurelock ) ) {
+      LOG( LOG_ERR, "failed to initialize lazy datascheme state\n" );
+      return -1;
+   }
    // iterate over nodes at this level
    for ( ; dataroot; dataroot = dataroot->next ) {
       // check for unknown xml node type
@@ -2001,37 +2073,37 @@ int parse_datascheme( marfs_ds* ds, xmlNode* dataroot, pthread_mutex_t* erasurel
                return -1;
             }
             if ( strncmp( (char*)subnode->name, "pods", 5 ) == 0 ) {
-               if ( ds->podtable ) {
+               if ( ds->distnodes[0] ) {
                   LOG( LOG_ERR, "Encountered duplicate 'pods' distribution subnode\n" );
                   return -1;
                }
-               if ( (ds->podtable = create_distribution_table( &(maxloc.pod), subnode )) == NULL ) {
-                  LOG( LOG_ERR, "failed to create 'pods' distribution table\n" );
+               if ( (ds->distnodes[0] = parse_distribution( ds->distcounts + 0, subnode )) == NULL ) {
+                  LOG( LOG_ERR, "failed to parse 'pods' distribution\n" );
                   return -1;
                }
-               maxloc.pod--; // decrement node count to get actual max value
+               ds->maxloc.pod = (int)ds->distcounts[0] - 1; // decrement node count to get actual max value
             }
             else if ( strncmp( (char*)subnode->name, "caps", 5 ) == 0 ) {
-               if ( ds->captable ) {
+               if ( ds->distnodes[1] ) {
                   LOG( LOG_ERR, "Encountered duplicate 'caps' distribution subnode\n" );
                   return -1;
                }
-               if ( (ds->captable = create_distribution_table( &(maxloc.cap), subnode )) == NULL ) {
-                  LOG( LOG_ERR, "failed to create 'caps' distribution table\n" );
+               if ( (ds->distnodes[1] = parse_distribution( ds->distcounts + 1, subnode )) == NULL ) {
+                  LOG( LOG_ERR, "failed to parse 'caps' distribution\n" );
                   return -1;
                }
-               maxloc.cap--; // decrement node count to get actual max value
+               ds->maxloc.cap = (int)ds->distcounts[1] - 1; // decrement node count to get actual max value
             }
             else if ( strncmp( (char*)subnode->name, "scatters", 9 ) == 0 ) {
-               if ( ds->scattertable ) {
+               if ( ds->distnodes[2] ) {
                   LOG( LOG_ERR, "Encountered duplicate 'scatters' distribution subnode\n" );
                   return -1;
                }
-               if ( (ds->scattertable = create_distribution_table( &(maxloc.scatter), subnode )) == NULL ) {
-                  LOG( LOG_ERR, "failed to create 'scatters' distribution table\n" );
+               if ( (ds->distnodes[2] = parse_distribution( ds->distcounts + 2, subnode )) == NULL ) {
+                  LOG( LOG_ERR, "failed to parse 'scatters' distribution\n" );
                   return -1;
                }
-               maxloc.scatter--; // decrement node count to get actual max value
+               ds->maxloc.scatter = (int)ds->distcounts[2] - 1; // decrement node count to get actual max value
             }
             else {
                LOG( LOG_ERR, "encountered an unrecognized \"%s\" node within a 'distribution' definition\n", (char*)subnode->name );
@@ -2049,11 +2121,19 @@ int parse_datascheme( marfs_ds* ds, xmlNode* dataroot, pthread_mutex_t* erasurel
       LOG( LOG_ERR, "failed to locate a DAL definition\n" );
       return -1;
    }
-   // attempt to create our NE context
-   if ( (ds->nectxt = ne_init( dalnode, maxloc, ds->protection.N + ds->protection.E, erasurelock )) == NULL ) {
-      LOG( LOG_ERR, "failed to initialize an NE context\n" );
+   // retain the DAL definition, for creation of our NE context on first use
+   xmlBufferPtr xmlbuf = xmlBufferCreate();
+   if ( xmlbuf == NULL ) {
+      LOG( LOG_ERR, "failed to allocate an XML output buffer\n" );
       return -1;
    }
+   if ( xmlNodeDump( xmlbuf, dalnode->doc, dalnode, 0, 0 ) < 0  ||
+        (ds->dalxml = strdup( (const char*)xmlBufferContent( xmlbuf ) )) == NULL ) {
+      LOG( LOG_ERR, "failed to retain the DAL definition\n" );
+      xmlBufferFree( xmlbuf );
+      return -1;
+   }
+   xmlBufferFree( xmlbuf );
 
    return 0;
 }
@@ -2333,6 +2413,11 @@ int create_repo( marfs_repo* repo, xmlNode* reporoot, pthread_mutex_t* erasurelo
    repo->datascheme.podtable = NULL;
    repo->datascheme.captable = NULL;
    repo->datascheme.scattertable = NULL;
+   repo->datascheme.distnodes[0] = NULL;
+   repo->datascheme.distnodes[1] = NULL;
+   repo->datascheme.distnodes[2] = NULL;
+   repo->datascheme.dalxml = NULL;
+   repo->datascheme.erasurelock = NULL;
    repo->metascheme.mdal = NULL;
    repo->metascheme.directread = 0;
    repo->metascheme.refbreadth = 0;
@@ -2370,7 +2455,7 @@ int create_repo( marfs_repo* repo, xmlNode* reporoot, pthread_mutex_t* erasurelo
          LOG( LOG_WARNING, "Encountered unrecognized \"%s\" subnode of \"%s\" repo\n", children->name, repo->name );
       }
    }
-   if ( repo->datascheme.nectxt == NULL  ||  repo->metascheme.mdal == NULL ) {
+   if ( repo->datascheme.dalxml == NULL  ||  repo->metascheme.mdal == NULL ) {
       LOG( LOG_ERR, "\"%s\" repo is missing required data/meta definitions\n", repo->name );
       free_repo( repo );
       return -1;
@@ -2629,15 +2714,859 @@ int establish_nsrefs( marfs_config* config ) {
 }
 
 
-//   -------------   EXTERNAL FUNCTIONS    -------------
+/**
+ * Locate the first element node of the given name, among the given node and its siblings
+ * @param xmlNode* node : First node to be checked
+ * @param const char* tag : Name of the element to locate
+ * @return xmlNode* : Reference to the located element, or NULL if none exists
+ */
+xmlNode* find_element( xmlNode* node, const char* tag ) {
+   for ( ; node; node = node->next ) {
+      if ( node->type == XML_ELEMENT_NODE  &&  strcmp( (char*)node->name, tag ) == 0 ) { return node; }
+   }
+   return NULL;
+}
 
 /**
- * Initialize memory structures based on the given config file
+ * Create any missing pod/cap/scatter distribution tables of the given datascheme
+ * NOTE -- The caller must hold the datascheme initlock, or otherwise ensure exclusive access.
+ * @param marfs_ds* ds : Datascheme to be updated
+ * @return int : Zero on success, or -1 on failure
+ */
+int fortify_distribution_tables( marfs_ds* ds ) {
+   HASH_TABLE* tables[3] = { &(ds->podtable), &(ds->captable), &(ds->scattertable) };
+   int target;
+   for ( target = 0; target < 3; target++ ) {
+      if ( *(tables[target]) != NULL  ||  ds->distnodes[target] == NULL ) { continue; }
+      if ( (*(tables[target]) = hash_init( ds->distnodes[target], ds->distcounts[target], 0 )) == NULL ) {
+         LOG( LOG_ERR, "failed to initialize hash table for distribution %d\n", target );
+         return -1;
+      }
+   }
+   return 0;
+}
+
+
+//   -------------   SNAPSHOT FUNCTIONS    -------------
+
+// A config snapshot consists of a fixed header, followed by a payload of 8-byte aligned records.
+// The payload captures every repo and namespace tree as parsed, prior to the linking of remote and
+// ghost namespaces ( which is always repeated at load time ), along with the virtual node rings of
+// every hash table.  DAL and MDAL definitions are retained as XML text, as their contexts must be
+// initialized at load time regardless.
+#define CONFIG_SNAPSHOT_MAGIC     "MARFSCFG"
+#define CONFIG_SNAPSHOT_VERSION   1
+#define CONFIG_SNAPSHOT_BYTEORDER 0x0102030405060708ULL
+#define CONFIG_SNAPSHOT_SUFFIX    ".snap"
+
+typedef struct config_snapheader_struct {
+   char     magic[8];    // CONFIG_SNAPSHOT_MAGIC ( without NULL terminator )
+   uint64_t byteorder;   // CONFIG_SNAPSHOT_BYTEORDER, in the byte order of the producing host
+   uint64_t version;     // CONFIG_SNAPSHOT_VERSION of the producing code
+   uint64_t srcsize;     // size of the XML config at the time of compilation
+   uint64_t srcmtime;    // modification time of the XML config ( seconds )
+   uint64_t srcmtimens;  // modification time of the XML config ( nanoseconds )
+   uint64_t length;      // length of the payload following this header
+   uint64_t checksum;    // checksum of the payload
+} config_snapheader;
+
+typedef struct config_snapbuf_struct {
+   char*  data;
+   size_t length;
+   size_t alloc;
+} config_snapbuf;
+
+typedef struct config_snapcursor_struct {
+   const char* data;
+   size_t      length;
+   size_t      offset;
+} config_snapcursor;
+
+// namespace record types
+enum {
+   SNAP_NS = 0,
+   SNAP_RNS,
+   SNAP_GNS
+};
+
+/**
+ * Produce a checksum of the given snapshot payload ( FNV-1a, over 8-byte words )
+ * @param const void* data : Payload to be checksummed
+ * @param size_t length : Length of the payload ( a multiple of 8 bytes )
+ * @return uint64_t : Checksum value
+ */
+uint64_t snap_checksum( const void* data, size_t length ) {
+   const char* words = (const char*)data;
+   uint64_t sum = 0xcbf29ce484222325ULL;
+   for ( ; length >= sizeof(uint64_t); length -= sizeof(uint64_t), words += sizeof(uint64_t) ) {
+      uint64_t word;
+      memcpy( &(word), words, sizeof(uint64_t) );
+      sum ^= word;
+      sum *= 0x100000001b3ULL;
+   }
+   return sum;
+}
+
+/**
+ * Append the given bytes to a snapshot buffer, padding to an 8-byte boundary
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param const void* src : Bytes to be appended ( if NULL, zero-fill instead )
+ * @param size_t length : Count of bytes to be appended
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_put( config_snapbuf* buf, const void* src, size_t length ) {
+   size_t padded = ( length + 7 ) & ~((size_t)7);
+   if ( buf->length + padded > buf->alloc ) {
+      size_t newalloc = ( buf->alloc ) ? buf->alloc : 4096;
+      while ( buf->length + padded > newalloc ) { newalloc *= 2; }
+      char* newdata = realloc( buf->data, newalloc );
+      if ( newdata == NULL ) {
+         LOG( LOG_ERR, "Failed to expand snapshot buffer to %zu bytes\n", newalloc );
+         return -1;
+      }
+      buf->data = newdata;
+      buf->alloc = newalloc;
+   }
+   if ( src ) { memcpy( buf->data + buf->length, src, length ); }
+   else { memset( buf->data + buf->length, 0, length ); }
+   memset( buf->data + buf->length + length, 0, padded - length );
+   buf->length += padded;
+   return 0;
+}
+
+/**
+ * Append the given integer value to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param uint64_t value : Value to be appended
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putval( config_snapbuf* buf, uint64_t value ) {
+   return snap_put( buf, &(value), sizeof(uint64_t) );
+}
+
+/**
+ * Append the given string to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param const char* str : String to be appended
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putstr( config_snapbuf* buf, const char* str ) {
+   if ( str == NULL ) {
+      LOG( LOG_ERR, "Received a NULL string value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // strings are stored as a length ( including NULL terminator ), followed by content
+   size_t length = strlen( str ) + 1;
+   if ( snap_putval( buf, length ) ) { return -1; }
+   return snap_put( buf, str, length );
+}
+
+/**
+ * Append the virtual node ring of the given table to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param HASH_TABLE table : Table to be serialized
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putring( config_snapbuf* buf, HASH_TABLE table ) {
+   size_t length = hash_export( table, NULL, 0 );
+   if ( length == 0 ) {
+      LOG( LOG_ERR, "Failed to identify the serialized length of a hash table\n" );
+      return -1;
+   }
+   if ( snap_putval( buf, length ) ) { return -1; }
+   // reserve space, then export directly into the buffer
+   size_t offset = buf->length;
+   if ( snap_put( buf, NULL, length ) ) { return -1; }
+   if ( hash_export( table, buf->data + offset, length ) != length ) {
+      LOG( LOG_ERR, "Failed to serialize a hash table\n" );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Append the given table ( node names, weights, and virtual node ring ) to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param HASH_TABLE table : Table to be serialized ( may be NULL )
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_puttable( config_snapbuf* buf, HASH_TABLE table ) {
+   // tables are stored as a node count ( zero for no table ), each node name and weight, and then the ring
+   if ( table == NULL ) { return snap_putval( buf, 0 ); }
+   HASH_NODE* node;
+   uint64_t nodecount = 0;
+   int iterres;
+   hash_reset( table );
+   while ( (iterres = hash_iterate( table, &(node) )) > 0 ) { nodecount++; }
+   if ( iterres < 0  ||  snap_putval( buf, nodecount ) ) { return -1; }
+   hash_reset( table );
+   while ( (iterres = hash_iterate( table, &(node) )) > 0 ) {
+      if ( snap_putstr( buf, node->name )  ||  snap_putval( buf, node->weight ) ) { return -1; }
+   }
+   hash_reset( table );
+   if ( iterres < 0 ) { return -1; }
+   return snap_putring( buf, table );
+}
+
+/**
+ * Append the given XML node ( as text ) to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param xmlNode* node : XML node to be serialized
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putxml( config_snapbuf* buf, xmlNode* node ) {
+   xmlBufferPtr xmlbuf = xmlBufferCreate();
+   if ( xmlbuf == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate an XML output buffer\n" );
+      return -1;
+   }
+   if ( xmlNodeDump( xmlbuf, node->doc, node, 0, 0 ) < 0 ) {
+      LOG( LOG_ERR, "Failed to output \"%s\" XML node\n", (char*)node->name );
+      xmlBufferFree( xmlbuf );
+      errno = EINVAL;
+      return -1;
+   }
+   int retval = snap_putstr( buf, (const char*)xmlBufferContent( xmlbuf ) );
+   xmlBufferFree( xmlbuf );
+   return retval;
+}
+
+/**
+ * Append the given namespace ( and all subspaces ) to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param HASH_NODE* nsnode : HASH_NODE referencing the namespace to be serialized
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putns( config_snapbuf* buf, HASH_NODE* nsnode ) {
+   marfs_ns* ns = (marfs_ns*)nsnode->content;
+   uint64_t type = SNAP_NS;
+   if ( ns->prepo == NULL ) { type = SNAP_RNS; }
+   else if ( ns->ghtarget == ns ) { type = SNAP_GNS; }
+   if ( snap_putstr( buf, nsnode->name )  ||
+        snap_putval( buf, type )  ||
+        snap_putstr( buf, ns->idstr )  ||
+        snap_putval( buf, ns->fquota )  ||
+        snap_putval( buf, ns->dquota )  ||
+        snap_putval( buf, ns->iperms )  ||
+        snap_putval( buf, ns->bperms )  ||
+        snap_putval( buf, ns->subnodecount ) ) {
+      LOG( LOG_ERR, "Failed to serialize NS \"%s\"\n", nsnode->name );
+      return -1;
+   }
+   size_t subindex = 0;
+   for ( ; subindex < ns->subnodecount; subindex++ ) {
+      if ( snap_putns( buf, ns->subnodes + subindex ) ) { return -1; }
+   }
+   if ( ns->subnodecount  &&  snap_putring( buf, ns->subspaces ) ) {
+      LOG( LOG_ERR, "Failed to serialize subspace table of NS \"%s\"\n", nsnode->name );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Append the given repo to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param marfs_repo* repo : Repo to be serialized
+ * @param xmlNode* reporoot : Xml node from which the repo was parsed
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putrepo( config_snapbuf* buf, marfs_repo* repo, xmlNode* reporoot ) {
+   // locate the MDAL definition, which will be stored as XML text
+   xmlNode* mdalnode = find_element( reporoot->children, "meta" );
+   if ( mdalnode ) { mdalnode = find_element( mdalnode->children, "MDAL" ); }
+   if ( mdalnode == NULL ) {
+      LOG( LOG_ERR, "Failed to locate MDAL definition of repo \"%s\"\n", repo->name );
+      errno = EINVAL;
+      return -1;
+   }
+   marfs_ds* ds = &(repo->datascheme);
+   marfs_ms* ms = &(repo->metascheme);
+   // distribution tables must exist, in order to store their rings
+   if ( fortify_distribution_tables( ds ) ) {
+      LOG( LOG_ERR, "Failed to create distribution tables of repo \"%s\"\n", repo->name );
+      return -1;
+   }
+   if ( snap_putstr( buf, repo->name )  ||
+        snap_putval( buf, ds->protection.N )  ||
+        snap_putval( buf, ds->protection.E )  ||
+        snap_putval( buf, ds->protection.O )  ||
+        snap_putval( buf, ds->protection.partsz )  ||
+        snap_putval( buf, ds->objfiles )  ||
+        snap_putval( buf, ds->objsize )  ||
+        snap_puttable( buf, ds->podtable )  ||
+        snap_puttable( buf, ds->captable )  ||
+        snap_puttable( buf, ds->scattertable )  ||
+        snap_putstr( buf, ds->dalxml )  ||
+        snap_putval( buf, ms->directread )  ||
+        snap_putval( buf, ms->refbreadth )  ||
+        snap_putval( buf, ms->refdepth )  ||
+        snap_putval( buf, ms->refdigits )  ||
+        snap_puttable( buf, ms->reftable )  ||
+        snap_putval( buf, ms->nscount ) ) {
+      LOG( LOG_ERR, "Failed to serialize repo \"%s\"\n", repo->name );
+      return -1;
+   }
+   int nsindex = 0;
+   for ( ; nsindex < ms->nscount; nsindex++ ) {
+      if ( snap_putns( buf, ms->nslist + nsindex ) ) {
+         LOG( LOG_ERR, "Failed to serialize NS %d of repo \"%s\"\n", nsindex, repo->name );
+         return -1;
+      }
+   }
+   if ( snap_putxml( buf, mdalnode ) ) {
+      LOG( LOG_ERR, "Failed to serialize MDAL definition of repo \"%s\"\n", repo->name );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Append the given config to a snapshot buffer
+ * @param config_snapbuf* buf : Buffer to be appended to
+ * @param marfs_config* config : Config to be serialized ( prior to establish_nsrefs() )
+ * @param xmlNode* root_element : Root 'marfs_config' xml node from which the config was parsed
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_putconfig( config_snapbuf* buf, marfs_config* config, xmlNode* root_element ) {
+   if ( snap_putstr( buf, config->version )  ||
+        snap_putstr( buf, config->mountpoint )  ||
+        snap_putval( buf, config->repocount ) ) {
+      return -1;
+   }
+   // repos were parsed from 'repo' nodes in order
+   xmlNode* reporoot = find_element( root_element->children, "repo" );
+   int repoindex = 0;
+   for ( ; repoindex < config->repocount; repoindex++ ) {
+      if ( reporoot == NULL ) {
+         LOG( LOG_ERR, "Failed to locate xml node of repo %d\n", repoindex );
+         errno = EFAULT;
+         return -1;
+      }
+      if ( snap_putrepo( buf, config->repolist + repoindex, reporoot ) ) { return -1; }
+      reporoot = find_element( reporoot->next, "repo" );
+   }
+   return 0;
+}
+
+/**
+ * Retrieve an integer value from a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param uint64_t* value : Reference to be populated with the value
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_getval( config_snapcursor* cursor, uint64_t* value ) {
+   if ( cursor->length - cursor->offset < sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Snapshot is truncated at offset %zu\n", cursor->offset );
+      errno = EINVAL;
+      return -1;
+   }
+   memcpy( value, cursor->data + cursor->offset, sizeof(uint64_t) );
+   cursor->offset += sizeof(uint64_t);
+   return 0;
+}
+
+/**
+ * Retrieve a reference to the given number of bytes of a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param size_t length : Count of bytes to retrieve
+ * @return const void* : Reference to the bytes, or NULL on failure
+ */
+const void* snap_getbytes( config_snapcursor* cursor, size_t length ) {
+   size_t padded = ( length + 7 ) & ~((size_t)7);
+   if ( padded < length  ||  cursor->length - cursor->offset < padded ) {
+      LOG( LOG_ERR, "Snapshot is truncated at offset %zu\n", cursor->offset );
+      errno = EINVAL;
+      return NULL;
+   }
+   const void* bytes = cursor->data + cursor->offset;
+   cursor->offset += padded;
+   return bytes;
+}
+
+/**
+ * Retrieve a string value from a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param char** str : Reference to be populated with a newly allocated string
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_getstr( config_snapcursor* cursor, char** str ) {
+   uint64_t length;
+   if ( snap_getval( cursor, &(length) ) ) { return -1; }
+   const char* content = ( length ) ? snap_getbytes( cursor, length ) : NULL;
+   if ( content == NULL ) { errno = EINVAL; return -1; }
+   if ( content[length - 1] != '\0' ) {
+      LOG( LOG_ERR, "Encountered an unterminated string at offset %zu\n", cursor->offset );
+      errno = EINVAL;
+      return -1;
+   }
+   *str = strdup( content );
+   if ( *str == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate a snapshot string\n" );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Retrieve a hash table, based on a virtual node ring within a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param HASH_NODE* nodes : Node list of the table
+ * @param size_t count : Count of nodes in the list
+ * @return HASH_TABLE : Newly created HASH_TABLE, or NULL on failure
+ */
+HASH_TABLE snap_getring( config_snapcursor* cursor, HASH_NODE* nodes, size_t count ) {
+   uint64_t length;
+   if ( snap_getval( cursor, &(length) ) ) { return NULL; }
+   const void* ring = snap_getbytes( cursor, length );
+   if ( ring == NULL ) { return NULL; }
+   return hash_import( nodes, count, ring, length );
+}
+
+/**
+ * Retrieve a table ( node names, weights, and virtual node ring ) from a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param HASH_TABLE* table : Reference to be populated with the table ( NULL, if none was stored )
+ * @param HASH_NODE** nodelist : Reference to be populated with the table node list
+ * @param size_t* nodecount : Reference to be populated with the count of table nodes
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_gettable( config_snapcursor* cursor, HASH_TABLE* table, HASH_NODE** nodelist, size_t* nodecount ) {
+   uint64_t count;
+   *table = NULL;
+   *nodelist = NULL;
+   *nodecount = 0;
+   if ( snap_getval( cursor, &(count) ) ) { return -1; }
+   if ( count == 0 ) { return 0; }
+   // every node requires at least two values, so reject any count which cannot possibly fit
+   if ( count > ( cursor->length - cursor->offset ) / ( 2 * sizeof(uint64_t) ) ) {
+      LOG( LOG_ERR, "Table node count of %zu exceeds snapshot bounds\n", (size_t)count );
+      errno = EINVAL;
+      return -1;
+   }
+   HASH_NODE* nodes = malloc( sizeof(HASH_NODE) * count );
+   if ( nodes == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a list of %zu table nodes\n", (size_t)count );
+      return -1;
+   }
+   size_t curnode = 0;
+   for ( ; curnode < count; curnode++ ) {
+      uint64_t weight;
+      nodes[curnode].content = NULL;
+      if ( snap_getstr( cursor, &(nodes[curnode].name) ) ) { break; }
+      if ( snap_getval( cursor, &(weight) )  ||  weight >= INT_MAX ) {
+         LOG( LOG_ERR, "Failed to retrieve weight of table node \"%s\"\n", nodes[curnode].name );
+         free( nodes[curnode].name );
+         errno = EINVAL;
+         break;
+      }
+      nodes[curnode].weight = (int)weight;
+   }
+   if ( curnode == count ) {
+      *table = snap_getring( cursor, nodes, count );
+   }
+   if ( *table == NULL ) {
+      LOG( LOG_ERR, "Failed to retrieve table of %zu nodes\n", (size_t)count );
+      while ( curnode ) {
+         curnode--;
+         free( nodes[curnode].name );
+      }
+      free( nodes );
+      return -1;
+   }
+   *nodelist = nodes;
+   *nodecount = count;
+   return 0;
+}
+
+/**
+ * Retrieve a namespace ( and all subspaces ) from a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param HASH_NODE* nsnode : HASH_NODE to be populated with NS info
+ * @param marfs_ns* pnamespace : Parent namespace reference of the new namespace
+ * @param marfs_repo* prepo : Parent repo reference of the new namespace
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_getns( config_snapcursor* cursor, HASH_NODE* nsnode, marfs_ns* pnamespace, marfs_repo* prepo ) {
+   char* nsname = NULL;
+   if ( snap_getstr( cursor, &(nsname) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the name of a subspace of NS \"%s\"\n",
+                    ( pnamespace ) ? pnamespace->idstr : prepo->name );
+      return -1;
+   }
+   marfs_ns* ns = malloc( sizeof( marfs_ns ) );
+   if ( ns == NULL ) {
+      LOG( LOG_ERR, "failed to allocate space for namespace \"%s\"\n", nsname );
+      free( nsname );
+      return -1;
+   }
+   ns->idstr = NULL;
+   uint64_t type, fquota, dquota, iperms, bperms, subcount;
+   if ( snap_getval( cursor, &(type) )  ||
+        snap_getstr( cursor, &(ns->idstr) )  ||
+        snap_getval( cursor, &(fquota) )  ||
+        snap_getval( cursor, &(dquota) )  ||
+        snap_getval( cursor, &(iperms) )  ||
+        snap_getval( cursor, &(bperms) )  ||
+        snap_getval( cursor, &(subcount) )  ||
+        type > SNAP_GNS  ||  iperms > NS_FULLACCESS  ||  bperms > NS_FULLACCESS  ||
+        ( subcount  &&  type != SNAP_NS )  ||
+        subcount > ( cursor->length - cursor->offset ) / sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Failed to retrieve values of NS \"%s\"\n", nsname );
+      if ( ns->idstr ) { free( ns->idstr ); }
+      free( ns );
+      free( nsname );
+      errno = EINVAL;
+      return -1;
+   }
+   ns->fquota = fquota;
+   ns->dquota = dquota;
+   ns->iperms = (ns_perms)iperms;
+   ns->bperms = (ns_perms)bperms;
+   ns->prepo = ( type == SNAP_RNS ) ? NULL : prepo; // remote namespaces are indicated by a NULL prepo
+   ns->pnamespace = pnamespace;
+   ns->subspaces = NULL;
+   ns->subnodes = NULL;
+   ns->subnodecount = 0;
+   ns->ghtarget = ( type == SNAP_GNS ) ? ns : NULL; // ghosts are indicated by a self-referential ghtarget
+   ns->ghsource = NULL;
+   if ( subcount ) {
+      HASH_NODE* subspacelist = malloc( sizeof( HASH_NODE ) * subcount );
+      if ( subspacelist == NULL ) {
+         LOG( LOG_ERR, "failed to allocate space for subspace list of NS \"%s\"\n", nsname );
+         free( ns->idstr );
+         free( ns );
+         free( nsname );
+         return -1;
+      }
+      size_t allocsubspaces = 0;
+      for ( ; allocsubspaces < subcount; allocsubspaces++ ) {
+         if ( snap_getns( cursor, subspacelist + allocsubspaces, ns, prepo ) ) { break; }
+      }
+      if ( allocsubspaces == subcount ) {
+         ns->subspaces = snap_getring( cursor, subspacelist, subcount );
+      }
+      if ( ns->subspaces == NULL ) {
+         LOG( LOG_ERR, "failed to retrieve subspaces of NS \"%s\"\n", nsname );
+         while ( allocsubspaces ) {
+            allocsubspaces--;
+            free_namespace( subspacelist + allocsubspaces );
+         }
+         free( subspacelist );
+         free( ns->idstr );
+         free( ns );
+         free( nsname );
+         return -1;
+      }
+      ns->subnodes = subspacelist;
+      ns->subnodecount = subcount;
+   }
+   nsnode->name = nsname;
+   nsnode->weight = 0;
+   nsnode->content = ns;
+   return 0;
+}
+
+/**
+ * Retrieve an XML definition from a snapshot
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param const char* tag : Expected element name of the definition
+ * @return xmlDoc* : Newly parsed XML document, with a root element of the definition, or NULL on failure
+ */
+xmlDoc* snap_getxml( config_snapcursor* cursor, const char* tag ) {
+   char* content = NULL;
+   if ( snap_getstr( cursor, &(content) ) ) { return NULL; }
+   xmlDoc* doc = xmlReadMemory( content, strlen( content ), NULL, NULL, XML_PARSE_NOBLANKS );
+   free( content );
+   xmlNode* root = ( doc ) ? xmlDocGetRootElement( doc ) : NULL;
+   if ( root == NULL  ||  strcmp( (char*)root->name, tag ) ) {
+      LOG( LOG_ERR, "Failed to parse stored '%s' definition\n", tag );
+      if ( doc ) { xmlFreeDoc( doc ); }
+      errno = EINVAL;
+      return NULL;
+   }
+   return doc;
+}
+
+/**
+ * Retrieve a repo from a snapshot, initializing its DAL / MDAL
+ * @param config_snapcursor* cursor : Current snapshot position
+ * @param marfs_repo* repo : Reference to the marfs_repo to be populated
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return int : Zero on success, or -1 on failure
+ */
+int snap_getrepo( config_snapcursor* cursor, marfs_repo* repo, pthread_mutex_t* erasurelock ) {
+   // populate default values, so that free_repo() can handle a partially populated repo
+   repo->name = NULL;
+   repo->datascheme.nectxt = NULL;
+   repo->datascheme.podtable = NULL;
+   repo->datascheme.captable = NULL;
+   repo->datascheme.scattertable = NULL;
+   repo->metascheme.mdal = NULL;
+   repo->metascheme.reftable = NULL;
+   repo->metascheme.refnodes = NULL;
+   repo->metascheme.refnodecount = 0;
+   repo->metascheme.nscount = 0;
+   repo->metascheme.nslist = NULL;
+   if ( init_dslazystate( &(repo->datascheme), erasurelock ) ) {
+      LOG( LOG_ERR, "Failed to initialize lazy datascheme state\n" );
+      return -1;
+   }
+   if ( snap_getstr( cursor, &(repo->name) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve repo name\n" );
+      return -1;
+   }
+   marfs_ds* ds = &(repo->datascheme);
+   marfs_ms* ms = &(repo->metascheme);
+   uint64_t N, E, O, partsz, objfiles, objsize, directread, refbreadth, refdepth, refdigits, nscount;
+   if ( snap_getval( cursor, &(N) )  ||
+        snap_getval( cursor, &(E) )  ||
+        snap_getval( cursor, &(O) )  ||
+        snap_getval( cursor, &(partsz) )  ||
+        snap_getval( cursor, &(objfiles) )  ||
+        snap_getval( cursor, &(objsize) )  ||
+        N >= INT_MAX  ||  E >= INT_MAX  ||  O >= INT_MAX  ||
+        snap_gettable( cursor, &(ds->podtable), ds->distnodes, ds->distcounts )  ||
+        snap_gettable( cursor, &(ds->captable), ds->distnodes + 1, ds->distcounts + 1 )  ||
+        snap_gettable( cursor, &(ds->scattertable), ds->distnodes + 2, ds->distcounts + 2 )  ||
+        snap_getstr( cursor, &(ds->dalxml) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve datascheme of repo \"%s\"\n", repo->name );
+      free_repo( repo );
+      errno = EINVAL;
+      return -1;
+   }
+   ds->protection.N = (int)N;
+   ds->protection.E = (int)E;
+   ds->protection.O = (int)O;
+   ds->protection.partsz = partsz;
+   ds->objfiles = objfiles;
+   ds->objsize = objsize;
+   // the NE context is only created on first use ( see config_fortifydatascheme() )
+   ds->maxloc.pod = ( ds->distcounts[0] ) ? (int)ds->distcounts[0] - 1 : 0;
+   ds->maxloc.cap = ( ds->distcounts[1] ) ? (int)ds->distcounts[1] - 1 : 0;
+   ds->maxloc.scatter = ( ds->distcounts[2] ) ? (int)ds->distcounts[2] - 1 : 0;
+   if ( snap_getval( cursor, &(directread) )  ||
+        snap_getval( cursor, &(refbreadth) )  ||
+        snap_getval( cursor, &(refdepth) )  ||
+        snap_getval( cursor, &(refdigits) )  ||
+        refbreadth >= INT_MAX  ||  refdepth >= INT_MAX  ||  refdigits >= INT_MAX  ||
+        snap_gettable( cursor, &(ms->reftable), &(ms->refnodes), &(ms->refnodecount) )  ||
+        snap_getval( cursor, &(nscount) )  ||
+        nscount > ( cursor->length - cursor->offset ) / sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Failed to retrieve metascheme of repo \"%s\"\n", repo->name );
+      free_repo( repo );
+      errno = EINVAL;
+      return -1;
+   }
+   ms->directread = ( directread ) ? 1 : 0;
+   ms->refbreadth = (int)refbreadth;
+   ms->refdepth = (int)refdepth;
+   ms->refdigits = (int)refdigits;
+   if ( nscount ) {
+      ms->nslist = malloc( sizeof(HASH_NODE) * nscount );
+      if ( ms->nslist == NULL ) {
+         LOG( LOG_ERR, "failed to allocate space for namespaces of repo \"%s\"\n", repo->name );
+         free_repo( repo );
+         return -1;
+      }
+      for ( ; ms->nscount < nscount; ms->nscount++ ) {
+         if ( snap_getns( cursor, ms->nslist + ms->nscount, NULL, repo ) ) {
+            LOG( LOG_ERR, "Failed to retrieve NS %d of repo \"%s\"\n", ms->nscount, repo->name );
+            free_repo( repo );
+            return -1;
+         }
+      }
+   }
+   // initialize our MDAL
+   xmlDoc* mdaldoc = snap_getxml( cursor, "MDAL" );
+   if ( mdaldoc == NULL ) {
+      LOG( LOG_ERR, "Failed to retrieve MDAL definition of repo \"%s\"\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   ms->mdal = init_mdal( xmlDocGetRootElement( mdaldoc ) );
+   xmlFreeDoc( mdaldoc );
+   if ( ms->mdal == NULL ) {
+      LOG( LOG_ERR, "failed to initialize MDAL of repo \"%s\"\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Produce a config, based on the given snapshot content
+ * @param const char* cpath : Path of the XML config file from which the snapshot was compiled
+ * @param const void* snapshot : Snapshot content
+ * @param size_t size : Length of the snapshot content
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return marfs_config* : Reference to the newly populated config structures, or NULL on failure
+ *                         ( errno of ESTALE indicates a snapshot which no longer matches its config file )
+ */
+marfs_config* snap_getconfig( const char* cpath, const void* snapshot, size_t size, pthread_mutex_t* erasurelock ) {
+   // validate the snapshot header
+   config_snapheader header;
+   if ( size < sizeof( config_snapheader ) ) {
+      LOG( LOG_ERR, "Snapshot is too short to contain a header\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   memcpy( &(header), snapshot, sizeof( config_snapheader ) );
+   if ( memcmp( header.magic, CONFIG_SNAPSHOT_MAGIC, sizeof( header.magic ) )  ||
+        header.byteorder != CONFIG_SNAPSHOT_BYTEORDER ) {
+      LOG( LOG_ERR, "Snapshot has an unrecognized header ( or a foreign byte order )\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( header.version != CONFIG_SNAPSHOT_VERSION ) {
+      LOG( LOG_ERR, "Snapshot has an incompatible version: %zu\n", (size_t)header.version );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( header.length != size - sizeof( config_snapheader )  ||  header.length % sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Snapshot payload length of %zu does not match file size of %zu\n", (size_t)header.length, size );
+      errno = EINVAL;
+      return NULL;
+   }
+   // verify that the snapshot still reflects the current config file
+   struct stat srcstat;
+   if ( stat( cpath, &(srcstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat config file: \"%s\"\n", cpath );
+      return NULL;
+   }
+   if ( header.srcsize != (uint64_t)srcstat.st_size  ||
+        header.srcmtime != (uint64_t)srcstat.st_mtim.tv_sec  ||
+        header.srcmtimens != (uint64_t)srcstat.st_mtim.tv_nsec ) {
+      LOG( LOG_WARNING, "Snapshot is stale relative to config file: \"%s\"\n", cpath );
+      errno = ESTALE;
+      return NULL;
+   }
+   config_snapcursor cursor = {
+      .data = (const char*)snapshot + sizeof( config_snapheader ),
+      .length = header.length,
+      .offset = 0
+   };
+   if ( snap_checksum( cursor.data, cursor.length ) != header.checksum ) {
+      LOG( LOG_ERR, "Snapshot payload does not match its checksum\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+
+   // allocate the top-level config struct
+   marfs_config* config = malloc( sizeof( struct marfs_config_struct ) );
+   if ( config == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new marfs_config struct\n" );
+      return NULL;
+   }
+   config->version = NULL;
+   config->mountpoint = NULL;
+   config->ctag = strdup( "UNKNOWN" ); // default to unknown client
+   config->rootns = NULL;
+   config->repocount = 0;
+   config->repolist = NULL;
+   uint64_t repocount;
+   if ( config->ctag == NULL  ||
+        snap_getstr( &(cursor), &(config->version) )  ||
+        snap_getstr( &(cursor), &(config->mountpoint) )  ||
+        snap_getval( &(cursor), &(repocount) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve required config values\n" );
+      config_term( config );
+      return NULL;
+   }
+   if ( repocount < 1  ||  repocount > ( cursor.length - cursor.offset ) / sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Snapshot has an invalid repo count: %zu\n", (size_t)repocount );
+      config_term( config );
+      errno = EINVAL;
+      return NULL;
+   }
+   config->repolist = malloc( sizeof( struct marfs_repo_struct ) * repocount );
+   if ( config->repolist == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a list of %zu repos\n", (size_t)repocount );
+      config_term( config );
+      return NULL;
+   }
+   for ( ; config->repocount < repocount; config->repocount++ ) {
+      if ( snap_getrepo( &(cursor), config->repolist + config->repocount, erasurelock ) ) {
+         LOG( LOG_ERR, "Failed to retrieve repo %d\n", config->repocount );
+         config_term( config );
+         return NULL;
+      }
+   }
+   if ( cursor.offset != cursor.length ) {
+      LOG( LOG_ERR, "Snapshot has %zu bytes of trailing data\n", cursor.length - cursor.offset );
+      config_term( config );
+      errno = EINVAL;
+      return NULL;
+   }
+
+   // iterate over all namespaces and establish hierarchy
+   if ( establish_nsrefs( config ) ) {
+      LOG( LOG_ERR, "Failed to establish all NS references\n" );
+      config_term( config );
+      return NULL;
+   }
+   return config;
+}
+
+/**
+ * Initialize memory structures based on the given config snapshot
+ * @param const char* cpath : Path of the XML config file from which the snapshot was compiled
+ * @param const char* snappath : Path of the snapshot file
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return marfs_config* : Reference to the newly populated config structures, or NULL on failure
+ *                         ( errno of ENOENT indicates a missing snapshot, and ESTALE indicates a 
+ *                           snapshot which no longer matches its config file )
+ */
+marfs_config* config_loadsnapshot( const char* cpath, const char* snappath, pthread_mutex_t* erasurelock ) {
+   int fd = open( snappath, O_RDONLY );
+   if ( fd < 0 ) {
+      LOG( LOG_INFO, "Failed to open config snapshot: \"%s\" ( %s )\n", snappath, strerror(errno) );
+      return NULL;
+   }
+   struct stat snapstat;
+   if ( fstat( fd, &(snapstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat config snapshot: \"%s\"\n", snappath );
+      close( fd );
+      return NULL;
+   }
+   if ( snapstat.st_size < sizeof( config_snapheader ) ) {
+      LOG( LOG_ERR, "Config snapshot is too short to be valid: \"%s\"\n", snappath );
+      close( fd );
+      errno = EINVAL;
+      return NULL;
+   }
+   void* snapshot = mmap( NULL, snapstat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+   if ( snapshot == MAP_FAILED ) {
+      LOG( LOG_ERR, "Failed to map config snapshot: \"%s\"\n", snappath );
+      return NULL;
+   }
+
+   LIBXML_TEST_VERSION
+
+   marfs_config* config = snap_getconfig( cpath, snapshot, snapstat.st_size, erasurelock );
+   int origerr = errno;
+   munmap( snapshot, snapstat.st_size );
+   xmlCleanupParser();
+   if ( config == NULL ) {
+      LOG( LOG_ERR, "Failed to load config snapshot: \"%s\"\n", snappath );
+      errno = origerr;
+      return NULL;
+   }
+   LOG( LOG_INFO, "Loaded config snapshot: \"%s\"\n", snappath );
+   return config;
+}
+
+/**
+ * Parse the given XML config file
  * @param const char* cpath : Path of the config file to be parsed
  * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @param config_snapbuf* snapshot : Snapshot buffer to be populated with the parsed config
+ *                                   ( may be NULL, if no snapshot is required )
  * @return marfs_config* : Reference to the newly populated config structures
  */
-marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock ) {
+marfs_config* parse_config( const char* cpath, pthread_mutex_t* erasurelock, config_snapbuf* snapshot ) {
    // Initialize the libxml library and check potential API mismatches between
    // the version it was compiled for and the actual shared library used.
    LIBXML_TEST_VERSION
@@ -2763,6 +3692,15 @@ marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock ) {
       }
    }
 
+   // serialize the parsed repos, prior to establishing NS links, if a snapshot was requested
+   if ( snapshot  &&  snap_putconfig( snapshot, config, root_element ) ) {
+      LOG( LOG_ERR, "Failed to serialize config snapshot\n" );
+      config_term( config );
+      xmlFreeDoc(doc);
+      xmlCleanupParser();
+      return NULL;
+   }
+
    /* Free the xml Doc */
    xmlFreeDoc(doc);
    /*
@@ -2781,6 +3719,131 @@ marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock ) {
    return config;
 }
 
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Initialize memory structures based on the given config file
+ * @param const char* cpath : Path of the config file to be parsed
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return marfs_config* : Reference to the newly populated config structures
+ */
+marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock ) {
+   // check for a precompiled snapshot of this config ( see config_compile() )
+   const char* snappath = getenv( "MARFS_CONFIG_SNAPSHOT" );
+   char* defsnappath = NULL;
+   if ( snappath == NULL  &&  cpath != NULL ) {
+      defsnappath = malloc( sizeof(char) * ( strlen( cpath ) + strlen( CONFIG_SNAPSHOT_SUFFIX ) + 1 ) );
+      if ( defsnappath ) {
+         sprintf( defsnappath, "%s%s", cpath, CONFIG_SNAPSHOT_SUFFIX );
+         snappath = defsnappath;
+      }
+   }
+   if ( cpath  &&  snappath  &&  *snappath != '\0' ) {
+      marfs_config* config = config_loadsnapshot( cpath, snappath, erasurelock );
+      if ( config ) {
+         if ( defsnappath ) { free( defsnappath ); }
+         return config;
+      }
+      if ( errno != ENOENT ) {
+         LOG( LOG_WARNING, "Falling back to XML parse of \"%s\", as snapshot \"%s\" is unusable ( %s )\n",
+                           cpath, snappath, strerror(errno) );
+      }
+   }
+   if ( defsnappath ) { free( defsnappath ); }
+   return parse_config( cpath, erasurelock, NULL );
+}
+
+/**
+ * Compile the given config file into a binary snapshot, for rapid loading by config_init()
+ * @param const char* cpath : Path of the config file to be compiled
+ * @param const char* snappath : Path of the snapshot file to be produced ( atomically replaced, if present )
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return int : Zero on success, or -1 on failure
+ */
+int config_compile( const char* cpath, const char* snappath, pthread_mutex_t* erasurelock ) {
+   // check for invalid args
+   if ( cpath == NULL  ||  snappath == NULL ) {
+      LOG( LOG_ERR, "Received a NULL config or snapshot path\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // note the state of the config file prior to parsing it, so that any concurrent change invalidates the snapshot
+   struct stat srcstat;
+   if ( stat( cpath, &(srcstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat config file: \"%s\"\n", cpath );
+      return -1;
+   }
+   // reserve space for the header, then parse the config into the payload
+   config_snapbuf snapshot = { .data = NULL, .length = 0, .alloc = 0 };
+   if ( snap_put( &(snapshot), NULL, sizeof( config_snapheader ) ) ) {
+      LOG( LOG_ERR, "Failed to allocate a snapshot buffer\n" );
+      return -1;
+   }
+   marfs_config* config = parse_config( cpath, erasurelock, &(snapshot) );
+   if ( config == NULL ) {
+      LOG( LOG_ERR, "Failed to parse config file: \"%s\"\n", cpath );
+      free( snapshot.data );
+      return -1;
+   }
+   if ( config_term( config ) ) {
+      LOG( LOG_WARNING, "Failed to terminate parsed config\n" );
+   }
+   // populate the header
+   config_snapheader header;
+   memcpy( header.magic, CONFIG_SNAPSHOT_MAGIC, sizeof( header.magic ) );
+   header.byteorder = CONFIG_SNAPSHOT_BYTEORDER;
+   header.version = CONFIG_SNAPSHOT_VERSION;
+   header.srcsize = srcstat.st_size;
+   header.srcmtime = srcstat.st_mtim.tv_sec;
+   header.srcmtimens = srcstat.st_mtim.tv_nsec;
+   header.length = snapshot.length - sizeof( config_snapheader );
+   header.checksum = snap_checksum( snapshot.data + sizeof( config_snapheader ), header.length );
+   memcpy( snapshot.data, &(header), sizeof( config_snapheader ) );
+   // output to a temporary file, then rename into place, so that readers never encounter a partial snapshot
+   int tmplen = snprintf( NULL, 0, "%s.%d.tmp", snappath, (int)getpid() );
+   char* tmppath = malloc( sizeof(char) * ( tmplen + 1 ) );
+   if ( tmppath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a temporary snapshot path\n" );
+      free( snapshot.data );
+      return -1;
+   }
+   snprintf( tmppath, tmplen + 1, "%s.%d.tmp", snappath, (int)getpid() );
+   int fd = open( tmppath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+   if ( fd < 0 ) {
+      LOG( LOG_ERR, "Failed to open temporary snapshot file: \"%s\"\n", tmppath );
+      free( tmppath );
+      free( snapshot.data );
+      return -1;
+   }
+   size_t written = 0;
+   while ( written < snapshot.length ) {
+      ssize_t writeres = write( fd, snapshot.data + written, snapshot.length - written );
+      if ( writeres < 0 ) {
+         if ( errno == EINTR ) { continue; }
+         break;
+      }
+      written += writeres;
+   }
+   free( snapshot.data );
+   char writefail = ( written != snapshot.length  ||  fsync( fd ) );
+   if ( close( fd ) ) { writefail = 1; }
+   if ( writefail ) {
+      LOG( LOG_ERR, "Failed to write out temporary snapshot file: \"%s\"\n", tmppath );
+      unlink( tmppath );
+      free( tmppath );
+      return -1;
+   }
+   if ( rename( tmppath, snappath ) ) {
+      LOG( LOG_ERR, "Failed to rename temporary snapshot file into place: \"%s\"\n", snappath );
+      unlink( tmppath );
+      free( tmppath );
+      return -1;
+   }
+   free( tmppath );
+   LOG( LOG_INFO, "Compiled \"%s\" into %zu byte snapshot: \"%s\"\n", cpath, snapshot.length, snappath );
+   return 0;
+}
+
 /**
  * Destroy the given config structures
  * @param marfs_config* config : Reference to the config to be destroyed
@@ -2810,6 +3873,61 @@ int config_term( marfs_config* config ) {
    return retval;
 }
 
+/**
+ * Ensure that the given datascheme has been fully initialized, creating its pod/cap/scatter 
+ * distribution tables and its LibNE context ( and therefore DAL ) on first use
+ * NOTE -- This function is thread safe, and cheap for all calls after the first success.
+ * @param marfs_ds* ds : Reference to the datascheme to be initialized
+ * @return int : Zero on success, or -1 on failure
+ */
+int config_fortifydatascheme( marfs_ds* ds ) {
+   // check for NULL ds ref
+   if ( ds == NULL ) {
+      LOG( LOG_ERR, "Received a NULL datascheme reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // check for an already initialized datascheme, without locking
+   if ( __atomic_load_n( &(ds->initialized), __ATOMIC_ACQUIRE ) ) { return 0; }
+   if ( ds->erasurelock == NULL ) {
+      LOG( LOG_ERR, "Datascheme has no lazy initialization state\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   pthread_mutex_lock( &(ds->initlock) );
+   // recheck, in case of a racing initialization
+   if ( ds->initialized ) {
+      pthread_mutex_unlock( &(ds->initlock) );
+      return 0;
+   }
+   if ( fortify_distribution_tables( ds ) ) {
+      pthread_mutex_unlock( &(ds->initlock) );
+      return -1;
+   }
+   if ( ds->nectxt == NULL ) {
+      LOG( LOG_INFO, "Initializing NE context ( maxloc = %d/%d/%d )\n", ds->maxloc.pod, ds->maxloc.cap, ds->maxloc.scatter );
+      xmlDoc* daldoc = xmlReadMemory( ds->dalxml, strlen( ds->dalxml ), NULL, NULL, XML_PARSE_NOBLANKS );
+      xmlNode* dalnode = ( daldoc ) ? xmlDocGetRootElement( daldoc ) : NULL;
+      if ( dalnode == NULL  ||  strcmp( (char*)dalnode->name, "DAL" ) ) {
+         LOG( LOG_ERR, "Failed to parse retained DAL definition\n" );
+         if ( daldoc ) { xmlFreeDoc( daldoc ); }
+         pthread_mutex_unlock( &(ds->initlock) );
+         errno = EINVAL;
+         return -1;
+      }
+      ds->nectxt = ne_init( dalnode, ds->maxloc, ds->protection.N + ds->protection.E, ds->erasurelock );
+      xmlFreeDoc( daldoc );
+      if ( ds->nectxt == NULL ) {
+         LOG( LOG_ERR, "failed to initialize an NE context\n" );
+         pthread_mutex_unlock( &(ds->initlock) );
+         return -1;
+      }
+   }
+   __atomic_store_n( &(ds->initialized), 1, __ATOMIC_RELEASE );
+   pthread_mutex_unlock( &(ds->initlock) );
+   return 0;
+}
+
 /**
  * Duplicate the reference to a given NS
  * @param marfs_ns* ns : NS ref to duplicate
@@ -3311,7 +4429,10 @@ int config_verify( marfs_config* config, const char* tgtNS, int flags ) {
             }
          }
          if ( checklibne ) {
-            int verres = ne_verify( pos.ns->prepo->datascheme.nectxt, flags );
+            int verres = -1;
+            if ( config_fortifydatascheme( &(pos.ns->prepo->datascheme) ) == 0 ) {
+               verres = ne_verify( pos.ns->prepo->datascheme.nectxt, flags );
+            }
             if ( verres < 0 ) {
                LOG( LOG_ERR, "Failed to verify ne_ctxt of repo: \"%s\" (%s)\n",
                              pos.ns->prepo->name, strerror(errno) );
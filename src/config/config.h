@@ -57,6 +57,15 @@ typedef struct marfs_datascheme_struct {
    HASH_TABLE podtable;      // hash table for object POD postion
    HASH_TABLE captable;      // hash table for object CAP position
    HASH_TABLE scattertable;  // hash table for object SCATTER position
+   // Lazy initialization state -- the NE context and pod/cap/scatter tables above are NULL until 
+   //                              the first config_fortifydatascheme() call against this struct
+   HASH_NODE*  distnodes[3];    // pod / cap / scatter node lists ( shared with tables, once created )
+   size_t      distcounts[3];   // counts of pod / cap / scatter nodes
+   ne_location maxloc;          // maximum pod / cap / scatter location values
+   char*       dalxml;          // DAL definition, for creation of the NE context
+   pthread_mutex_t* erasurelock;   // LibNE erasure synchronization lock ( NULL if no lazy state )
+   pthread_mutex_t  initlock;      // lock serializing initialization
+   char        initialized;     // flag indicating completed initialization ( accessed atomically )
 } marfs_ds;
 
 
@@ -110,9 +119,24 @@ enum {
  * @param const char* cpath : Path of the config file to be parsed
  * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
  * @return marfs_config* : Reference to the newly populated config structures
+ * NOTE -- If a snapshot of the config file exists ( see config_compile() ), it will be loaded in 
+ *         place of the XML.  The snapshot is expected at "<cpath>.snap", unless an alternate path 
+ *         is specified via the MARFS_CONFIG_SNAPSHOT env var ( an empty value disables snapshots ).
+ *         Any snapshot which is stale ( config file size / mtime differ from those at compile time ) 
+ *         or otherwise invalid will be ignored, in favor of the XML.
  */
 marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock );
 
+/**
+ * Compile the given config file into a binary snapshot, for rapid loading by config_init()
+ * @param const char* cpath : Path of the config file to be compiled
+ * @param const char* snappath : Path of the snapshot file to be produced ( atomically replaced, if present )
+ * @param pthread_mutex_t* erasurelock : Reference to the libne erasure synchronization lock
+ * @return int : Zero on success, or -1 on failure
+ * NOTE -- The config is fully parsed, including initialization of all DAL / MDAL contexts.
+ */
+int config_compile( const char* cpath, const char* snappath, pthread_mutex_t* erasurelock );
+
 /**
  * Destroy the given config structures
  * @param marfs_config* config : Reference to the config to be destroyed
@@ -120,6 +144,17 @@ marfs_config* config_init( const char* cpath, pthread_mutex_t* erasurelock );
  */
 int config_term( marfs_config* config );
 
+/**
+ * Ensure that the given datascheme has been fully initialized, creating its pod/cap/scatter 
+ * distribution tables and its LibNE context ( and therefore DAL ) on first use
+ * NOTE -- This function is thread safe, and cheap for all calls after the first success.
+ *         Only data access requires these structures, so config_init() defers their creation 
+ *         until a process actually touches object data of a given repo.
+ * @param marfs_ds* ds : Reference to the datascheme to be initialized
+ * @return int : Zero on success, or -1 on failure
+ */
+int config_fortifydatascheme( marfs_ds* ds );
+
 /**
  * Duplicate the reference to a given NS
  * @param marfs_ns* ns : NS ref to duplicate
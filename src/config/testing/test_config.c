@@ -376,8 +376,8 @@ int main(int argc, char **argv)
       printf( "unexpected protection values for datascheme: (N=%d,E=%d,psz=%zu)\n", ds->protection.N, ds->protection.E, ds->protection.partsz );
       return -1;
    }
-   if ( ds->nectxt == NULL ) {
-      printf( "datascheme has NULL nectxt\n" );
+   if ( ds->nectxt != NULL  ||  ds->initialized ) {
+      printf( "datascheme was eagerly initialized\n" );
       return -1;
    }
    if ( ds->objfiles != 4096 ) {
@@ -388,6 +388,19 @@ int main(int argc, char **argv)
       printf( "unexpected objsize value for datascheme: %zu\n", ds->objsize );
       return -1;
    }
+   if ( ds->podtable != NULL  ||  ds->captable != NULL  ||  ds->scattertable != NULL ) {
+      printf( "pod/cap/scatter tables were eagerly initialized for datascheme\n" );
+      return -1;
+   }
+   // materialize the datascheme ( repeated calls should be a no-op )
+   if ( config_fortifydatascheme( ds )  ||  config_fortifydatascheme( ds ) ) {
+      printf( "failed to fortify datascheme\n" );
+      return -1;
+   }
+   if ( ds->nectxt == NULL  ||  !(ds->initialized) ) {
+      printf( "datascheme has NULL nectxt\n" );
+      return -1;
+   }
    if ( ds->podtable == NULL  ||  ds->captable == NULL  ||  ds->scattertable == NULL ) {
       printf( "not all pod/cap/scatter tables were initialized for datascheme\n" );
       return -1;
@@ -504,6 +517,137 @@ int main(int argc, char **argv)
    }
 
 
+   // compile a config snapshot, and verify that it reproduces the parsed config
+   if ( config_compile( "./testing/config.xml", "./test_config_topdir/config.snap", &erasurelock ) ) {
+      printf( "failed to compile a config snapshot\n" );
+      return -1;
+   }
+   marfs_config* snapconfig = config_loadsnapshot( "./testing/config.xml", "./test_config_topdir/config.snap", &erasurelock );
+   if ( snapconfig == NULL ) {
+      printf( "failed to load the config snapshot\n" );
+      return -1;
+   }
+   if ( strcmp( snapconfig->version, config->version )  ||  strcmp( snapconfig->mountpoint, config->mountpoint )  ||
+        strcmp( snapconfig->ctag, config->ctag )  ||  snapconfig->repocount != config->repocount ) {
+      printf( "snapshot config values differ from parsed config\n" );
+      return -1;
+   }
+   if ( snapconfig->rootns == NULL  ||  strcmp( snapconfig->rootns->idstr, config->rootns->idstr )  ||
+        snapconfig->rootns->subnodecount != config->rootns->subnodecount ) {
+      printf( "snapshot root NS differs from parsed config\n" );
+      return -1;
+   }
+   int snaprepo = 0;
+   for ( ; snaprepo < config->repocount; snaprepo++ ) {
+      marfs_repo* orepo = config->repolist + snaprepo;
+      marfs_repo* srepo = snapconfig->repolist + snaprepo;
+      if ( config_fortifydatascheme( &(orepo->datascheme) )  ||
+           config_fortifydatascheme( &(srepo->datascheme) ) ) {
+         printf( "failed to fortify datascheme of repo %d\n", snaprepo );
+         return -1;
+      }
+      if ( strcmp( orepo->name, srepo->name )  ||
+           orepo->datascheme.protection.N != srepo->datascheme.protection.N  ||
+           orepo->datascheme.protection.E != srepo->datascheme.protection.E  ||
+           orepo->datascheme.protection.partsz != srepo->datascheme.protection.partsz  ||
+           orepo->datascheme.objfiles != srepo->datascheme.objfiles  ||
+           orepo->datascheme.objsize != srepo->datascheme.objsize  ||
+           orepo->metascheme.directread != srepo->metascheme.directread  ||
+           orepo->metascheme.refnodecount != srepo->metascheme.refnodecount  ||
+           orepo->metascheme.nscount != srepo->metascheme.nscount  ||
+           srepo->datascheme.nectxt == NULL  ||  srepo->metascheme.mdal == NULL ) {
+         printf( "snapshot repo %d differs from parsed config\n", snaprepo );
+         return -1;
+      }
+      // verify that every hash table produces identical lookup results
+      int lookupcnt = 0;
+      for ( ; lookupcnt < 1000; lookupcnt++ ) {
+         snprintf( xmlbuffer, 1024, "some-object-id-%d", lookupcnt );
+         HASH_TABLE otables[4] = { orepo->datascheme.podtable, orepo->datascheme.captable,
+                                   orepo->datascheme.scattertable, orepo->metascheme.reftable };
+         HASH_TABLE stables[4] = { srepo->datascheme.podtable, srepo->datascheme.captable,
+                                   srepo->datascheme.scattertable, srepo->metascheme.reftable };
+         int tindex = 0;
+         for ( ; tindex < 4; tindex++ ) {
+            if ( otables[tindex] == NULL  &&  stables[tindex] == NULL ) { continue; }
+            HASH_NODE* onode = NULL;
+            HASH_NODE* snode = NULL;
+            if ( otables[tindex] == NULL  ||  stables[tindex] == NULL  ||
+                 hash_lookup( otables[tindex], xmlbuffer, &(onode) ) < 0  ||
+                 hash_lookup( stables[tindex], xmlbuffer, &(snode) ) < 0  ||
+                 strcmp( onode->name, snode->name ) ) {
+               printf( "snapshot table %d of repo %d produced a differing lookup of \"%s\"\n", tindex, snaprepo, xmlbuffer );
+               return -1;
+            }
+         }
+      }
+   }
+   HASH_NODE* snapnsnode = NULL;
+   HASH_NODE* confnsnode = NULL;
+   if ( hash_lookup( snapconfig->rootns->subspaces, "gransom-allocation", &(snapnsnode) )  ||
+        hash_lookup( config->rootns->subspaces, "gransom-allocation", &(confnsnode) )  ||
+        strcmp( ((marfs_ns*)snapnsnode->content)->idstr, ((marfs_ns*)confnsnode->content)->idstr ) ) {
+      printf( "failed to locate 'gransom-allocation' subspace of snapshot root NS\n" );
+      return -1;
+   }
+   if ( config_term( snapconfig ) ) {
+      printf( "failed to terminate the snapshot config\n" );
+      return -1;
+   }
+   // a snapshot with a mismatched config stamp should be rejected as stale
+   int snapfd = open( "./test_config_topdir/config.snap", O_RDWR );
+   if ( snapfd < 0 ) {
+      printf( "failed to open the config snapshot\n" );
+      return -1;
+   }
+   config_snapheader snapheader;
+   if ( pread( snapfd, &(snapheader), sizeof( snapheader ), 0 ) != sizeof( snapheader ) ) {
+      printf( "failed to read the config snapshot header\n" );
+      return -1;
+   }
+   snapheader.srcmtime++;
+   if ( pwrite( snapfd, &(snapheader), sizeof( snapheader ), 0 ) != sizeof( snapheader ) ) {
+      printf( "failed to alter the config snapshot header\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( config_loadsnapshot( "./testing/config.xml", "./test_config_topdir/config.snap", &erasurelock )  ||  errno != ESTALE ) {
+      printf( "stale config snapshot was not rejected as such\n" );
+      return -1;
+   }
+   // a snapshot with a corrupted payload should be rejected
+   snapheader.srcmtime--;
+   char corruptbyte = 0;
+   if ( pwrite( snapfd, &(snapheader), sizeof( snapheader ), 0 ) != sizeof( snapheader )  ||
+        pread( snapfd, &(corruptbyte), 1, sizeof( snapheader ) + 20 ) != 1 ) {
+      printf( "failed to restore the config snapshot header\n" );
+      return -1;
+   }
+   corruptbyte ^= 0x1;
+   if ( pwrite( snapfd, &(corruptbyte), 1, sizeof( snapheader ) + 20 ) != 1 ) {
+      printf( "failed to corrupt the config snapshot\n" );
+      return -1;
+   }
+   close( snapfd );
+   errno = 0;
+   if ( config_loadsnapshot( "./testing/config.xml", "./test_config_topdir/config.snap", &erasurelock )  ||  errno != EINVAL ) {
+      printf( "corrupt config snapshot was not rejected\n" );
+      return -1;
+   }
+   // config_init() should fall back to the XML, when presented with an invalid snapshot
+   setenv( "MARFS_CONFIG_SNAPSHOT", "./test_config_topdir/config.snap", 1 );
+   snapconfig = config_init( "./testing/config.xml", &erasurelock );
+   unsetenv( "MARFS_CONFIG_SNAPSHOT" );
+   if ( snapconfig == NULL  ||  snapconfig->repocount != config->repocount ) {
+      printf( "failed to fall back to XML parsing of an invalid config snapshot\n" );
+      return -1;
+   }
+   if ( config_term( snapconfig ) ) {
+      printf( "failed to terminate the fallback config\n" );
+      return -1;
+   }
+   unlink( "./test_config_topdir/config.snap" );
+
    // prepare for full path traversal by actually creating config namespaces
    int flags = CFG_FIX | CFG_OWNERCHECK | CFG_MDALCHECK | CFG_DALCHECK | CFG_RECURSE;
    if ( config_verify(config,"/campaign/",flags ) ) {
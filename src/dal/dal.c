@@ -19,6 +19,7 @@
 #include "dal.h"
 
 #include <ctype.h>
+#include <libxml/parser.h>
 
 // Function to provide specific DAL initialization calls based on name
 DAL init_dal(xmlNode *dal_conf_root, DAL_location max_loc)
@@ -40,6 +41,15 @@ DAL init_dal(xmlNode *dal_conf_root, DAL_location max_loc)
       {
          typetxt = type->children;
       }
+      else if (type->type == XML_ATTRIBUTE_NODE && strncmp((char *)type->name, "numa", 5) == 0)
+      {
+         // NUMA placement is handled by LibNE ( see ne_init() ), not by the DAL itself
+      }
+      else if (type->type == XML_ATTRIBUTE_NODE && (strncmp((char *)type->name, "qdepth", 7) == 0 ||
+                                                    strncmp((char *)type->name, "qdepthmax", 10) == 0))
+      {
+         // ioqueue depth is handled by LibNE ( see ne_init() ), not by the DAL itself
+      }
       else
       {
          LOG(LOG_WARNING, "encountered unrecognized or redundant DAL attribute: \"%s\"\n", (char *)type->name);
@@ -95,3 +105,119 @@ DAL init_dal(xmlNode *dal_conf_root, DAL_location max_loc)
    errno = ENODEV;
    return NULL;
 }
+
+// Function to locate a DAL definition node within a config file
+xmlNode *find_dal_config(char *config_spec, xmlDoc **docref)
+{
+   // separate the file path from the node path
+   char *fields = strstr(config_spec, ":/");
+   if (fields == NULL)
+   {
+      LOG(LOG_ERR, "config spec \"%s\" does not specify a path to the DAL node\n", config_spec);
+      errno = EINVAL;
+      return NULL;
+   }
+   *fields = '\0';
+   fields += 2;
+
+   // this initializes the library and checks potential ABI mismatches
+   LIBXML_TEST_VERSION
+
+   xmlDoc *doc = xmlReadFile(config_spec, NULL, XML_PARSE_NOBLANKS);
+   if (doc == NULL)
+   {
+      LOG(LOG_ERR, "could not parse config file \"%s\"\n", config_spec);
+      errno = EINVAL;
+      return NULL;
+   }
+   xmlNode *root = xmlDocGetRootElement(doc);
+
+   char *tag = NULL;
+   char *attr = NULL;
+   char *val = NULL;
+   int last = 0;
+   while (root)
+   {
+      // get details for the next node to find within the config structure
+      if (!tag)
+      {
+         char *next = strchr(fields, '/');
+         if (next == NULL)
+         {
+            next = strchr(fields + 1, '\0');
+            last = 1;
+         }
+         *next = '\0';
+         if ((attr = strchr(fields, ' ')))
+         {
+            *attr = '\0';
+            attr++;
+            if (!(val = strchr(attr, '=')))
+            {
+               LOG(LOG_ERR, "could not find a value for attribute \"%s\" in field with tag \"%s\"\n", attr, fields);
+               xmlFreeDoc(doc);
+               errno = EINVAL;
+               return NULL;
+            }
+            *val = '\0';
+            val++;
+         }
+         tag = fields;
+         fields = next + 1;
+      }
+      // find that node
+      if (root->type == XML_ELEMENT_NODE && !strcmp((char *)root->name, tag))
+      {
+         if (val)
+         {
+            xmlAttr *props = root->properties;
+            while (props)
+            {
+               if (props->type == XML_ATTRIBUTE_NODE && !strcmp((char *)props->name, attr) &&
+                   props->children->type == XML_TEXT_NODE && !strcmp((char *)props->children->content, val))
+               {
+                  if (!last)
+                  {
+                     root = root->children;
+                  }
+                  tag = NULL;
+                  attr = NULL;
+                  val = NULL;
+                  break;
+               }
+               props = props->next;
+            }
+            if (!props)
+            {
+               root = root->next;
+            }
+            if (last)
+            {
+               break;
+            }
+         }
+         else
+         {
+            if (last)
+            {
+               break;
+            }
+            root = root->children;
+            tag = NULL;
+         }
+      }
+      else
+      {
+         root = root->next;
+      }
+   }
+   if (root == NULL)
+   {
+      LOG(LOG_ERR, "could not find DAL in config file \"%s\"\n", config_spec);
+      xmlFreeDoc(doc);
+      errno = ENOENT;
+      return NULL;
+   }
+   *docref = doc;
+   return root;
+}
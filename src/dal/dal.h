@@ -171,6 +171,38 @@ typedef struct DAL_struct
    //  Zero on success, Non-zero if the operation could not be completed
 } * DAL;
 
+// DAL functions tracked by the timer DAL
+typedef enum timer_dal_op_enum
+{
+   TIMER_DAL_VERIFY = 0,
+   TIMER_DAL_MIGRATE,
+   TIMER_DAL_DEL,
+   TIMER_DAL_STAT,
+   TIMER_DAL_CLEANUP,
+   TIMER_DAL_OPEN,
+   TIMER_DAL_SET_META,
+   TIMER_DAL_GET_META,
+   TIMER_DAL_PUT,
+   TIMER_DAL_GET,
+   TIMER_DAL_ABORT,
+   TIMER_DAL_CLOSE,
+   TIMER_DAL_OPCOUNT // not a real op, just a count of them
+} timer_dal_op;
+
+// Latency summary of a single DAL function ( all times in seconds )
+typedef struct timer_dal_stats_struct
+{
+   const char *name; // name of the DAL function
+   size_t count;     // number of calls recorded
+   double min;
+   double mean;
+   double max;
+   double p50;
+   double p90;
+   double p99;
+   double p999;
+} timer_dal_stats;
+
 // Forward decls of specific DAL initializations
 DAL posix_dal_init(xmlNode *posix_dal_conf_root, DAL_location max_loc);
 DAL fuzzing_dal_init(xmlNode *fuzzing_dal_conf_root, DAL_location max_loc);
@@ -180,7 +212,17 @@ DAL noop_dal_init(xmlNode *noop_dal_conf_root, DAL_location max_loc);
 #ifdef RECURSION
 DAL rec_dal_init(xmlNode *rec_dal_conf_root, DAL_location max_loc);
 #endif
+// Take a live snapshot of the latency percentiles of a timer DAL
+//  'stats' must reference an array of TIMER_DAL_OPCOUNT elements ( indexed by timer_dal_op ).
+//  This is safe to call while other threads are using the DAL.
+//  Returns zero on success, or -1 on failure ( e.g. 'dal' is not a timer DAL )
+int timer_dal_snapshot(DAL dal, timer_dal_stats *stats);
 // Function to provide specific DAL initialization calls based on name
 DAL init_dal(xmlNode *dal_conf_root, DAL_location max_loc);
+// Locate the DAL definition node described by a "<file_path>:/<tag>[ <attribute>=<value>]/..." config spec
+//  NOTE -- 'config_spec' is modified by this function, and the xmlDoc returned via 'docref' must be freed
+//          by the caller once the DAL node is no longer needed
+//  Returns a reference to the DAL node, or NULL on failure ( with errno set )
+xmlNode *find_dal_config(char *config_spec, xmlDoc **docref);
 
 #endif
@@ -22,12 +22,19 @@
 #include "metainfo.h"
 
 #include <sys/stat.h>
+#include <sys/ioctl.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <pwd.h>
 #include <unistd.h>
 #include <stdint.h>
 #include <stdlib.h>
+#ifdef HAVE_LINUX_FS_H
+#include <linux/fs.h> // for FICLONE
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
 
 //   -------------    POSIX DEFINITIONS    -------------
 
@@ -38,6 +45,7 @@
 #define META_SFX ".meta"       // 5 characters (in ADDITION to other suffixes!)
 
 #define IO_SIZE 1048576 // Preferred I/O Size
+#define COPY_SIZE 67108864 // Size of individual kernel-side copy ops during migration
 
 #define MAX_LOC_BUF 1048576 // Default Location Buffer Size
 
@@ -863,16 +871,121 @@ int posix_del(DAL_CTXT ctxt, DAL_location location, const char *objID);
 
 BLOCK_CTXT posix_open(DAL_CTXT ctxt, DAL_MODE mode, DAL_location location, const char *objID);
 
-int posix_put(BLOCK_CTXT ctxt, const void *buf, size_t size);
-
-ssize_t posix_get(BLOCK_CTXT ctxt, void *buf, size_t size, off_t offset);
-
 int posix_abort(BLOCK_CTXT ctxt);
 
 int posix_close(BLOCK_CTXT ctxt);
 
 /** (INTERNAL HELPER FUNCTION)
- * Attempt to manually migrate an object from one location to another using put/get/set_meta/get_meta dal functions..
+ * Duplicate all data of one open file into another, avoiding passing data through user space whenever possible.
+ * In order of preference: reflink ( shared extents, no data movement at all ), copy_file_range() ( in-kernel or
+ * server-side copy ), sendfile() ( in-kernel copy, across filesystems ), and finally a read/write loop.
+ * @param int srcfd : File descriptor of the source file ( at offset zero )
+ * @param int destfd : File descriptor of the destination file ( empty, at offset zero )
+ * @param const char* srcpath : Path of the source file ( for logging only )
+ * @return int : Zero on success, -1 on failure
+ */
+static int copy_data(int srcfd, int destfd, const char *srcpath)
+{
+#ifdef FICLONE
+   // attempt to share all extents of the source file
+   if (ioctl(destfd, FICLONE, srcfd) == 0)
+   {
+      LOG(LOG_INFO, "reflinked data of \"%s\"\n", srcpath);
+      return 0;
+   }
+   LOG(LOG_INFO, "failed to reflink data of \"%s\", falling back to copy (%s)\n", srcpath, strerror(errno));
+#endif
+
+   // identify the total data volume to be copied
+   struct stat stval;
+   if (fstat(srcfd, &stval))
+   {
+      LOG(LOG_ERR, "failed to stat source data file \"%s\" (%s)\n", srcpath, strerror(errno));
+      return -1;
+   }
+   off_t off = 0;
+   ssize_t res;
+
+#ifdef HAVE_COPY_FILE_RANGE
+   // attempt an in-kernel copy ( potentially offloaded to the underlying storage )
+   while (off < stval.st_size)
+   {
+      size_t copysize = (stval.st_size - off > COPY_SIZE) ? COPY_SIZE : (size_t)(stval.st_size - off);
+      res = copy_file_range(srcfd, NULL, destfd, NULL, copysize, 0);
+      if (res <= 0)
+      {
+         break;
+      }
+      off += res;
+   }
+   if (off >= stval.st_size)
+   {
+      LOG(LOG_INFO, "copied %zd bytes of \"%s\" via copy_file_range()\n", off, srcpath);
+      return 0;
+   }
+   if (off)
+   {
+      // partial progress indicates a real error, rather than a lack of support
+      LOG(LOG_ERR, "copy_file_range() of \"%s\" failed at offset %zd (%s)\n", srcpath, off, strerror(errno));
+      return -1;
+   }
+   LOG(LOG_INFO, "failed to copy_file_range() \"%s\", falling back to sendfile (%s)\n", srcpath, strerror(errno));
+#endif
+
+#ifdef HAVE_SYS_SENDFILE_H
+   // attempt an in-kernel copy between filesystems
+   while (off < stval.st_size)
+   {
+      size_t copysize = (stval.st_size - off > COPY_SIZE) ? COPY_SIZE : (size_t)(stval.st_size - off);
+      res = sendfile(destfd, srcfd, NULL, copysize);
+      if (res <= 0)
+      {
+         break;
+      }
+      off += res;
+   }
+   if (off >= stval.st_size)
+   {
+      LOG(LOG_INFO, "copied %zd bytes of \"%s\" via sendfile()\n", off, srcpath);
+      return 0;
+   }
+   if (off)
+   {
+      LOG(LOG_ERR, "sendfile() of \"%s\" failed at offset %zd (%s)\n", srcpath, off, strerror(errno));
+      return -1;
+   }
+   LOG(LOG_INFO, "failed to sendfile() \"%s\", falling back to read/write (%s)\n", srcpath, strerror(errno));
+#endif
+
+   // fall back to bouncing data through a user buffer
+   void *data_buf = malloc(IO_SIZE);
+   if (data_buf == NULL)
+   {
+      return -1;
+   }
+   do
+   {
+      res = read(srcfd, data_buf, IO_SIZE);
+      if (res < 0)
+      {
+         LOG(LOG_ERR, "failed to read source data file \"%s\" (%s)\n", srcpath, strerror(errno));
+         free(data_buf);
+         return -1;
+      }
+      if (write(destfd, data_buf, res) != res)
+      {
+         LOG(LOG_ERR, "failed to write data of \"%s\" to destination (%s)\n", srcpath, strerror(errno));
+         free(data_buf);
+         return -1;
+      }
+   } while (res > 0);
+   free(data_buf);
+
+   return 0;
+}
+
+/** (INTERNAL HELPER FUNCTION)
+ * Attempt to manually migrate an object from one location to another, copying data kernel-side where possible
  * @param POSIX_DAL_CTXT dctxt : Context reference of the current POSIX DAL
  * @param const char* objID : Object ID reference of object to be migraded
  * @param DAL_location src : Source location of the object to be migrated
@@ -882,16 +995,10 @@ int posix_close(BLOCK_CTXT ctxt);
  */
 int manual_migrate(POSIX_DAL_CTXT dctxt, const char *objID, DAL_location src, DAL_location dest)
 {
-   // allocate buffers to transfer between locations
-   void *data_buf = malloc(IO_SIZE);
-   if (data_buf == NULL)
-   {
-      return -1;
-   }
+   // allocate a buffer to transfer meta info between locations
    char *meta_buf = malloc(IO_SIZE);
    if (meta_buf == NULL)
    {
-      free(data_buf);
       return -1;
    }
 
@@ -899,7 +1006,6 @@ int manual_migrate(POSIX_DAL_CTXT dctxt, const char *objID, DAL_location src, DA
    POSIX_BLOCK_CTXT src_ctxt = (POSIX_BLOCK_CTXT)posix_open((DAL_CTXT)dctxt, DAL_READ, src, objID);
    if (src_ctxt == NULL)
    {
-      free(data_buf);
       free(meta_buf);
       return -1;
    }
@@ -907,46 +1013,27 @@ int manual_migrate(POSIX_DAL_CTXT dctxt, const char *objID, DAL_location src, DA
    if (dest_ctxt == NULL)
    {
       posix_abort((BLOCK_CTXT)src_ctxt);
-      free(data_buf);
       free(meta_buf);
       return -1;
    }
 
    // move data file from source location to destination location
-   ssize_t res;
-   off_t off = 0;
-   do
+   if (copy_data(src_ctxt->fd, dest_ctxt->fd, src_ctxt->filepath))
    {
-      res = posix_get((BLOCK_CTXT)src_ctxt, data_buf, IO_SIZE, off);
-      if (res < 0)
-      {
-         posix_abort((BLOCK_CTXT)src_ctxt);
-         block_delete(dest_ctxt, 0);  // delete any in-progress output
-         posix_abort((BLOCK_CTXT)dest_ctxt);
-         free(data_buf);
-         free(meta_buf);
-         return -1;
-      }
-      off += res;
-      if (posix_put((BLOCK_CTXT)dest_ctxt, data_buf, res))
-      {
-         posix_abort((BLOCK_CTXT)src_ctxt);
-         block_delete(dest_ctxt, 0);  // delete any in-progress output
-         posix_abort((BLOCK_CTXT)dest_ctxt);
-         free(data_buf);
-         free(meta_buf);
-         return -1;
-      }
-   } while (res > 0);
+      posix_abort((BLOCK_CTXT)src_ctxt);
+      block_delete(dest_ctxt, 0);  // delete any in-progress output
+      posix_abort((BLOCK_CTXT)dest_ctxt);
+      free(meta_buf);
+      return -1;
+   }
 
    // move meta file from source location to destination location
-   res = posix_get_meta_internal((BLOCK_CTXT)src_ctxt, meta_buf, IO_SIZE);
+   ssize_t res = posix_get_meta_internal((BLOCK_CTXT)src_ctxt, meta_buf, IO_SIZE);
    if (res < 0)
    {
       posix_abort((BLOCK_CTXT)src_ctxt);
       block_delete(dest_ctxt, 0);  // delete any in-progress output
       posix_abort((BLOCK_CTXT)dest_ctxt);
-      free(data_buf);
       free(meta_buf);
       return -1;
    }
@@ -955,12 +1042,10 @@ int manual_migrate(POSIX_DAL_CTXT dctxt, const char *objID, DAL_location src, DA
       posix_abort((BLOCK_CTXT)src_ctxt);
       block_delete(dest_ctxt, 0);  // delete any in-progress output
       posix_abort((BLOCK_CTXT)dest_ctxt);
-      free(data_buf);
       free(meta_buf);
       return -1;
    }
 
-   free(data_buf);
    free(meta_buf);
 
    // close both locations
@@ -187,6 +187,34 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  // Take a live snapshot of our timing data
+  timer_dal_stats stats[TIMER_DAL_OPCOUNT];
+  if (timer_dal_snapshot(dal, stats))
+  {
+    printf("error: failed to snapshot timing data: %s\n", strerror(errno));
+    return -1;
+  }
+  if (stats[TIMER_DAL_PUT].count != 1024 || stats[TIMER_DAL_OPEN].count != 2 ||
+      stats[TIMER_DAL_CLOSE].count != 2 || stats[TIMER_DAL_GET].count != 1 ||
+      stats[TIMER_DAL_DEL].count != 1 || stats[TIMER_DAL_ABORT].count != 0)
+  {
+    printf("error: unexpected timing data counts ( put=%zu, open=%zu, close=%zu, get=%zu, del=%zu, abort=%zu )\n",
+           stats[TIMER_DAL_PUT].count, stats[TIMER_DAL_OPEN].count, stats[TIMER_DAL_CLOSE].count,
+           stats[TIMER_DAL_GET].count, stats[TIMER_DAL_DEL].count, stats[TIMER_DAL_ABORT].count);
+    return -1;
+  }
+  if (strcmp(stats[TIMER_DAL_PUT].name, "put") ||
+      stats[TIMER_DAL_PUT].min > stats[TIMER_DAL_PUT].p50 ||
+      stats[TIMER_DAL_PUT].p50 > stats[TIMER_DAL_PUT].p99 ||
+      stats[TIMER_DAL_PUT].p99 > stats[TIMER_DAL_PUT].p999 ||
+      stats[TIMER_DAL_PUT].p999 > stats[TIMER_DAL_PUT].max)
+  {
+    printf("error: inconsistent put percentiles ( min=%.9f, p50=%.9f, p99=%.9f, p999=%.9f, max=%.9f )\n",
+           stats[TIMER_DAL_PUT].min, stats[TIMER_DAL_PUT].p50, stats[TIMER_DAL_PUT].p99,
+           stats[TIMER_DAL_PUT].p999, stats[TIMER_DAL_PUT].max);
+    return -1;
+  }
+
   // Free the DAL
   if (dal->cleanup(dal))
   {
@@ -194,6 +222,14 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  // Check for the timing summary
+  if (access("./timing_test_data_TMP/percentiles.csv", R_OK) ||
+      access("./timing_test_data_TMP/put.hist", R_OK))
+  {
+    printf("error: missing timing data output\n");
+    return -1;
+  }
+
   /*free the document */
   free(writebuffer);
   free(readbuffer);
@@ -21,341 +21,392 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <sys/time.h>
+#include <time.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
 
-#define NODE_SIZE 1024 * 1024 // Buffer size for each timing data node
+// Latency histograms are log-linear ( HDR-style ): values below 2^SUBBITS ns get a bucket
+// each, and every further power of two is split into HALF linear sub-buckets, bounding the
+// relative error of any reported value to 1/HALF
+#define TIMER_HIST_SUBBITS 5
+#define TIMER_HIST_HALF (1 << (TIMER_HIST_SUBBITS - 1))
+#define TIMER_HIST_BUCKETS ((64 - TIMER_HIST_SUBBITS + 2) * TIMER_HIST_HALF)
 
 //   -------------    TIMER CONTEXT    -------------
 
-// Linked list node containing timing data (Nodes should never be directly
-// accessed)
-typedef struct time_node
-{
-  char *data;
-  int remaining;
-  struct time_node *next;
-} * node;
+static const char *timer_op_names[TIMER_DAL_OPCOUNT] = {
+    "verify", "migrate", "del", "stat", "cleanup", "open",
+    "set_meta", "get_meta", "put", "get", "abort", "close"};
 
-// Linked list containing timing data
-typedef struct time_list
+// Latency histogram of a single DAL function
+typedef struct timer_hist_struct
+{
+  uint64_t count;
+  uint64_t sum; // all values in nanoseconds
+  uint64_t min;
+  uint64_t max;
+  uint64_t buckets[TIMER_HIST_BUCKETS];
+} timer_hist;
+
+// Per-thread set of histograms (Each slab is only ever written by the one thread which has
+// claimed it, so updates are plain relaxed atomic load/store pairs.  The atomics only exist
+// so that snapshots can safely be taken while the DAL is in use.)
+typedef struct timer_slab_struct
 {
-  node start;
-  node end;
-  pthread_mutex_t mtx;
-} * list;
+  timer_hist hists[TIMER_DAL_OPCOUNT];
+  int inuse;                      // non-zero while claimed by a live thread
+  struct timer_slab_struct *next; // slabs are never unlinked before DAL cleanup
+} * slab;
 
 typedef struct timer_dal_context_struct
 {
-  DAL under_dal; // Underlying DAL
-  int dump_fd;   // Directory to export timing data to upon close
-  list verify;   // Linked lists containing the timing data of each DAL function
-  list migrate;
-  list del;
-  list stat;
-  list cleanup;
-  list open;
-  list set_meta;
-  list get_meta;
-  list put;
-  list get;
-  list abort;
-  list close;
+  DAL under_dal;        // Underlying DAL
+  int dump_fd;          // Directory to export timing data to upon close
+  pthread_key_t slabkey; // Per-thread reference to a claimed slab
+  slab slabs;           // List of all slabs, appended to without locking
 } * TIMER_DAL_CTXT;
 
 typedef struct timer_block_context_struct
 {
   TIMER_DAL_CTXT global_ctxt; // Global context
   BLOCK_CTXT bctxt;           // Block context to be passed to underlying DAL
-  list set_meta;              // List containing timing data of each DAL data
-  list get_meta;              // access function performed since the handle was
-  list put;                   // opened.
-  list get;
 } * TIMER_BLOCK_CTXT;
 
 //   -------------    TIMER INTERNAL FUNCTIONS    -------------
 
 /** (INTERNAL HELPER FUNCTION)
- * Initializes and returns a timing data list
- * @return list : An empty list if it could be successfully initialized,
- * otherwise NULL.
+ * Identify the histogram bucket of a value
+ * @param uint64_t value : Value to be recorded (ns)
+ * @return int : Index of the corresponding bucket
  */
-list list_init()
+static int hist_index(uint64_t value)
 {
-  // allocate space for a new list
-  list lst = malloc(sizeof(struct time_list));
-  if (lst == NULL)
+  if (value < (1ULL << TIMER_HIST_SUBBITS))
   {
-    return NULL;
+    return (int)value;
   }
+  int shift = (63 - __builtin_clzll(value)) - (TIMER_HIST_SUBBITS - 1);
+  return (shift * TIMER_HIST_HALF) + (int)(value >> shift);
+}
 
-  // ensure that the list is empty
-  lst->start = NULL;
-  lst->end = NULL;
-
-  // intitialize the list's lock
-  if (pthread_mutex_init(&lst->mtx, NULL))
+/** (INTERNAL HELPER FUNCTION)
+ * Identify the highest value which maps to the given histogram bucket
+ * @param int index : Index of the bucket
+ * @return uint64_t : Highest value of the bucket (ns)
+ */
+static uint64_t hist_highvalue(int index)
+{
+  if (index < (1 << TIMER_HIST_SUBBITS))
   {
-    free(lst);
-    return NULL;
+    return (uint64_t)index;
   }
-  return lst;
+  int shift = (index / TIMER_HIST_HALF) - 1;
+  uint64_t low = (uint64_t)(index - (shift * TIMER_HIST_HALF)) << shift;
+  return low + ((1ULL << shift) - 1);
 }
 
 /** (INTERNAL HELPER FUNCTION)
- * Append data to the end of a timing data list
- * @param list lst : List to add data to
- * @param char *str : Data to be added
- * @return int : Zero if the data is added successfully, -1 otherwise
+ * Release a slab claimed by an exiting thread, so that a later thread may reuse it
+ * @param void *arg : Slab to be released
  */
-int list_add(list lst, char *str)
+static void slab_release(void *arg)
 {
-  pthread_mutex_lock(&lst->mtx);
+  slab s = (slab)arg;
+  __atomic_store_n(&s->inuse, 0, __ATOMIC_RELEASE);
+}
 
-  // Allocate a first node if the list is empty before beginning
-  if (lst->start == NULL)
+/** (INTERNAL HELPER FUNCTION)
+ * Retrieve the slab of the calling thread, claiming an idle or new one if necessary
+ * @param TIMER_DAL_CTXT dctxt : Context to retrieve a slab from
+ * @return slab : Reference to the thread's slab, or NULL on failure
+ */
+static slab slab_get(TIMER_DAL_CTXT dctxt)
+{
+  slab s = pthread_getspecific(dctxt->slabkey);
+  if (s)
   {
-    lst->start = malloc(sizeof(struct time_node));
-    if (lst->start == NULL)
-    {
-      pthread_mutex_unlock(&lst->mtx);
-      return -1;
-    }
-    lst->start->data = malloc(sizeof(char) * NODE_SIZE);
-    *lst->start->data = '\0';
-    if (lst->start->data == NULL)
+    return s;
+  }
+  // attempt to reuse the slab of an exited thread, keeping its values
+  for (s = __atomic_load_n(&dctxt->slabs, __ATOMIC_ACQUIRE); s; s = s->next)
+  {
+    int idle = 0;
+    if (__atomic_load_n(&s->inuse, __ATOMIC_RELAXED) == 0 &&
+        __atomic_compare_exchange_n(&s->inuse, &idle, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
     {
-      free(lst->start);
-      pthread_mutex_unlock(&lst->mtx);
-      return -1;
+      break;
     }
-    lst->start->remaining = NODE_SIZE;
-    lst->start->next = NULL;
-    lst->end = lst->start;
   }
-
-  // Allocate a new node if the last node cannot fit the new data
-  if (strlen(str) > lst->end->remaining)
+  if (s == NULL)
   {
-    lst->end->next = malloc(sizeof(struct time_node));
-    if (lst->end->next == NULL)
+    s = calloc(1, sizeof(struct timer_slab_struct));
+    if (s == NULL)
     {
-      pthread_mutex_unlock(&lst->mtx);
-      return -1;
+      LOG(LOG_ERR, "failed to allocate a timing data slab\n");
+      return NULL;
     }
-    lst->end->next->data = malloc(sizeof(char) * NODE_SIZE);
-    *lst->end->next->data = '\0';
-    if (lst->end->next->data == NULL)
+    int op;
+    for (op = 0; op < TIMER_DAL_OPCOUNT; op++)
     {
-      free(lst->end->next);
-      pthread_mutex_unlock(&lst->mtx);
-      return -1;
+      s->hists[op].min = UINT64_MAX;
     }
-    lst->end->next->remaining = NODE_SIZE;
-    lst->end->next->next = NULL;
-    lst->end = lst->end->next;
+    s->inuse = 1;
+    // push onto the slab list
+    s->next = __atomic_load_n(&dctxt->slabs, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&dctxt->slabs, &s->next, s, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+      ;
   }
-
-  // Add new data to last node in list
-  strcat(lst->end->data, str);
-  lst->end->remaining -= strlen(str);
-  pthread_mutex_unlock(&lst->mtx);
-
-  return 0;
+  if (pthread_setspecific(dctxt->slabkey, s))
+  {
+    LOG(LOG_ERR, "failed to associate a timing data slab with this thread\n");
+    slab_release(s);
+    return NULL;
+  }
+  return s;
 }
 
 /** (INTERNAL HELPER FUNCTION)
- * Move the timing data from one list onto another, removing the data from the
- * source list
- * @param list dest : List to move the data to
- * @param list src : List to move the data from (NOTE: This list should
- * only every be accessed from one thread, as this function does not perform
- * locking on it)
- * @return int Zero if the data is migrated successfully, -1 otherwise
+ * Record the time elapsed since the given start time against a DAL function
+ * @param TIMER_DAL_CTXT dctxt : Context to record the value in
+ * @param timer_dal_op op : DAL function the value is associated with
+ * @param struct timespec *beg : Start time of the operation
  */
-int list_migrate(list dest, list src)
+static void timer_record(TIMER_DAL_CTXT dctxt, timer_dal_op op, struct timespec *beg)
 {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  uint64_t elapsed = ((uint64_t)(end.tv_sec - beg->tv_sec) * 1000000000ULL) + end.tv_nsec - beg->tv_nsec;
 
-  // If there's nothing to migrate, return
-  if (src->start == NULL)
+  slab s = slab_get(dctxt);
+  if (s == NULL)
   {
-    return 0;
+    return; // timing data is best effort
   }
-
-  // Only acquire destination lock (source should be from a block and only
-  // accessed by one thread)
-  pthread_mutex_lock(&dest->mtx);
-
-  // Append the source list to the end of the destination list
-  if (dest->start == NULL)
+  timer_hist *h = &s->hists[op];
+  uint64_t *bucket = &h->buckets[hist_index(elapsed)];
+  __atomic_store_n(bucket, __atomic_load_n(bucket, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&h->sum, __atomic_load_n(&h->sum, __ATOMIC_RELAXED) + elapsed, __ATOMIC_RELAXED);
+  if (elapsed < __atomic_load_n(&h->min, __ATOMIC_RELAXED))
   {
-    dest->start = src->start;
+    __atomic_store_n(&h->min, elapsed, __ATOMIC_RELAXED);
   }
-  else
+  if (elapsed > __atomic_load_n(&h->max, __ATOMIC_RELAXED))
   {
-    dest->end->next = src->start;
+    __atomic_store_n(&h->max, elapsed, __ATOMIC_RELAXED);
   }
-  dest->end = src->end;
-
-  // Remove all nodes from source list
-  src->start = NULL;
-  src->end = NULL;
-
-  pthread_mutex_unlock(&dest->mtx);
-  return 0;
+  __atomic_store_n(&h->count, __atomic_load_n(&h->count, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
 }
 
 /** (INTERNAL HELPER FUNCTION)
- * Write the timing data from a list into a file, removing the data from the
- * list as it is written
- * @param list lst : List to export data from
- * @param int dir_fd : Directory that contains file where data will be written
- * @param char *fname : Path of file relative to dir_fd to write data to
- * @return int : Zero if the data is exported successfully, -1 otherwise
+ * Merge the per-thread histograms of a DAL function
+ * @param TIMER_DAL_CTXT dctxt : Context containing timing data
+ * @param timer_dal_op op : DAL function to merge histograms of
+ * @param timer_hist *merged : Histogram to be populated with the merged values
  */
-int list_export(list lst, int dir_fd, char *fname)
+static void hist_merge(TIMER_DAL_CTXT dctxt, timer_dal_op op, timer_hist *merged)
 {
-  // Open the file we will be writing to
-  int fd = openat(dir_fd, fname, O_CREAT | O_WRONLY | O_APPEND, 0666);
-  if (fd < 0)
+  memset(merged, 0, sizeof(timer_hist));
+  merged->min = UINT64_MAX;
+  slab s;
+  for (s = __atomic_load_n(&dctxt->slabs, __ATOMIC_ACQUIRE); s; s = s->next)
+  {
+    timer_hist *h = &s->hists[op];
+    int i;
+    for (i = 0; i < TIMER_HIST_BUCKETS; i++)
+    {
+      merged->buckets[i] += __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+    }
+    merged->count += __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+    merged->sum += __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+    uint64_t min = __atomic_load_n(&h->min, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    if (min < merged->min)
+    {
+      merged->min = min;
+    }
+    if (max > merged->max)
+    {
+      merged->max = max;
+    }
+  }
+  // a live snapshot may catch a bucket update without its count update (or vice versa)
+  uint64_t total = 0;
+  int i;
+  for (i = 0; i < TIMER_HIST_BUCKETS; i++)
   {
-    return -1;
+    total += merged->buckets[i];
   }
-
-  pthread_mutex_lock(&lst->mtx);
-
-  // If the list is empty, we have nothing to export
-  if (lst->start == NULL)
+  merged->count = total;
+  if (total == 0)
   {
-    pthread_mutex_unlock(&lst->mtx);
-    return close(fd);
+    merged->min = 0;
   }
+}
 
-  // Write out all data to the file, node by node
-  int ret;
-  do
+/** (INTERNAL HELPER FUNCTION)
+ * Calculate a percentile value of a merged histogram
+ * @param timer_hist *h : Histogram to calculate the percentile of
+ * @param double fraction : Percentile, as a fraction (e.g. 0.999 for p999)
+ * @return uint64_t : Highest value equivalent to the percentile (ns)
+ */
+static uint64_t hist_percentile(timer_hist *h, double fraction)
+{
+  if (h->count == 0)
+  {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(fraction * h->count + 0.5);
+  if (rank < 1)
   {
-    ret = write(fd, lst->start->data, strlen(lst->start->data));
-    if (ret < 0)
+    rank = 1;
+  }
+  uint64_t seen = 0;
+  int i;
+  for (i = 0; i < TIMER_HIST_BUCKETS; i++)
+  {
+    seen += h->buckets[i];
+    if (seen >= rank)
     {
-      LOG(LOG_ERR, "failed to write timing data to %s (%s)\n", fname, strerror(errno));
       break;
     }
-
-    node next = lst->start->next;
-    free(lst->start->data);
-    free(lst->start);
-    lst->start = next;
-  } while (lst->start != NULL);
-
-  pthread_mutex_unlock(&lst->mtx);
-
-  if (close(fd))
+  }
+  uint64_t value = hist_highvalue(i);
+  if (value > h->max)
   {
-    return -1;
+    value = h->max;
   }
-
-  return ret;
+  if (value < h->min)
+  {
+    value = h->min;
+  }
+  return value;
 }
 
 /** (INTERNAL HELPER FUNCTION)
- * Release all resorces associated with a list
- * @param list lst : List to be destroyed
- * @return int : Zero if list is successfully destroyed, -1 otherwise
+ * Populate summary statistics from a merged histogram
+ * @param timer_hist *h : Histogram to summarize
+ * @param timer_dal_op op : DAL function the histogram is associated with
+ * @param timer_dal_stats *stats : Reference to the stats to be populated
  */
-int list_destroy(list lst)
+static void hist_summarize(timer_hist *h, timer_dal_op op, timer_dal_stats *stats)
 {
-  pthread_mutex_lock(&lst->mtx);
-
-  // Release every node, one at a time
-  node n = lst->start;
-  while (n)
-  {
-    node next = n->next;
-    free(n->data);
-    free(n);
-    n = next;
-  }
-
-  // Release general resources associated with the list
-  pthread_mutex_unlock(&lst->mtx);
-  pthread_mutex_destroy(&lst->mtx);
-  free(lst);
-  return 0;
+  stats->name = timer_op_names[op];
+  stats->count = h->count;
+  stats->min = h->min * 1e-9;
+  stats->mean = (h->count) ? ((double)h->sum / h->count) * 1e-9 : 0.0;
+  stats->max = h->max * 1e-9;
+  stats->p50 = hist_percentile(h, 0.50) * 1e-9;
+  stats->p90 = hist_percentile(h, 0.90) * 1e-9;
+  stats->p99 = hist_percentile(h, 0.99) * 1e-9;
+  stats->p999 = hist_percentile(h, 0.999) * 1e-9;
 }
 
 /** (INTERNAL HELPER FUNCTION)
- * Write out all timing data
- * @param TIMER_DAL_CTXT dctxt : Context containing timing data and export
- * location
- * @return int : Zero on success, the number of lists that could failed to be
- * written otherwise
+ * Write the non-empty buckets of a histogram into a file, one "low,high,count" line each
+ * @param timer_hist *h : Histogram to export
+ * @param int dir_fd : Directory that contains file where data will be written
+ * @param char *fname : Path of file relative to dir_fd to write data to
+ * @return int : Zero if the data is exported successfully, -1 otherwise
  */
-int dump_times(TIMER_DAL_CTXT dctxt)
+static int hist_export(timer_hist *h, int dir_fd, const char *fname)
 {
-  // Export every list, counting how many fail
-  int ret = 0;
-  if (list_export(dctxt->verify, dctxt->dump_fd, "verify") < 0)
-  {
-    LOG(LOG_ERR, "failed to export verify timing data (%s)\n", strerror(errno));
-    ret++;
-  }
-  if (list_export(dctxt->migrate, dctxt->dump_fd, "migrate") < 0)
-  {
-    LOG(LOG_ERR, "failed to export migrate timing data (%s)\n", strerror(errno));
-    ret++;
-  }
-  if (list_export(dctxt->del, dctxt->dump_fd, "del") < 0)
+  int fd = openat(dir_fd, fname, O_CREAT | O_WRONLY | O_TRUNC, 0666);
+  if (fd < 0)
   {
-    LOG(LOG_ERR, "failed to export del timing data (%s)\n", strerror(errno));
-    ret++;
+    return -1;
   }
-  if (list_export(dctxt->stat, dctxt->dump_fd, "stat") < 0)
+  FILE *out = fdopen(fd, "w");
+  if (out == NULL)
   {
-    LOG(LOG_ERR, "failed to export stat timing data (%s)\n", strerror(errno));
-    ret++;
+    close(fd);
+    return -1;
   }
-  if (list_export(dctxt->cleanup, dctxt->dump_fd, "cleanup") < 0)
+  int ret = 0;
+  if (fprintf(out, "low_s,high_s,count\n") < 0)
   {
-    LOG(LOG_ERR, "failed to export cleanup timing data (%s)\n", strerror(errno));
-    ret++;
+    ret = -1;
   }
-  if (list_export(dctxt->open, dctxt->dump_fd, "open") < 0)
+  int i;
+  for (i = 0; i < TIMER_HIST_BUCKETS && ret == 0; i++)
   {
-    LOG(LOG_ERR, "failed to export open timing data (%s)\n", strerror(errno));
-    ret++;
+    if (h->buckets[i] == 0)
+    {
+      continue;
+    }
+    uint64_t low = (i) ? hist_highvalue(i - 1) + 1 : 0;
+    if (fprintf(out, "%.9f,%.9f,%llu\n", low * 1e-9, hist_highvalue(i) * 1e-9,
+                (unsigned long long)h->buckets[i]) < 0)
+    {
+      ret = -1;
+    }
   }
-  if (list_export(dctxt->set_meta, dctxt->dump_fd, "set_meta") < 0)
+  if (fclose(out))
   {
-    LOG(LOG_ERR, "failed to export set_meta timing data (%s)\n", strerror(errno));
-    ret++;
+    ret = -1;
   }
-  if (list_export(dctxt->get_meta, dctxt->dump_fd, "get_meta") < 0)
+  return ret;
+}
+
+/** (INTERNAL HELPER FUNCTION)
+ * Write out all timing data, as a 'percentiles.csv' summary plus a '<function>.hist' bucket
+ * file for each DAL function
+ * @param TIMER_DAL_CTXT dctxt : Context containing timing data and export
+ * location
+ * @return int : Zero on success, the number of files that failed to be
+ * written otherwise
+ */
+int dump_times(TIMER_DAL_CTXT dctxt)
+{
+  timer_hist *merged = malloc(sizeof(timer_hist));
+  if (merged == NULL)
   {
-    LOG(LOG_ERR, "failed to export get_meta timing data (%s)\n", strerror(errno));
-    ret++;
+    LOG(LOG_ERR, "failed to allocate space for a merged histogram\n");
+    return TIMER_DAL_OPCOUNT + 1;
   }
-  if (list_export(dctxt->put, dctxt->dump_fd, "put") < 0)
+  int ret = 0;
+  FILE *summary = NULL;
+  int fd = openat(dctxt->dump_fd, "percentiles.csv", O_CREAT | O_WRONLY | O_TRUNC, 0666);
+  if (fd < 0 || (summary = fdopen(fd, "w")) == NULL)
   {
-    LOG(LOG_ERR, "failed to export put timing data (%s)\n", strerror(errno));
+    LOG(LOG_ERR, "failed to open timing summary file (%s)\n", strerror(errno));
+    if (fd >= 0)
+    {
+      close(fd);
+    }
     ret++;
   }
-  if (list_export(dctxt->get, dctxt->dump_fd, "get") < 0)
+  else
   {
-    LOG(LOG_ERR, "failed to export get timing data (%s)\n", strerror(errno));
-    ret++;
+    fprintf(summary, "function,count,min_s,mean_s,max_s,p50_s,p90_s,p99_s,p999_s\n");
   }
-  if (list_export(dctxt->abort, dctxt->dump_fd, "abort") < 0)
+
+  int op;
+  for (op = 0; op < TIMER_DAL_OPCOUNT; op++)
   {
-    LOG(LOG_ERR, "failed to export abort timing data (%s)\n", strerror(errno));
-    ret++;
+    hist_merge(dctxt, op, merged);
+    if (summary)
+    {
+      timer_dal_stats stats;
+      hist_summarize(merged, op, &stats);
+      fprintf(summary, "%s,%zu,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f\n", stats.name, stats.count,
+              stats.min, stats.mean, stats.max, stats.p50, stats.p90, stats.p99, stats.p999);
+    }
+    char fname[32];
+    snprintf(fname, sizeof(fname), "%s.hist", timer_op_names[op]);
+    if (hist_export(merged, dctxt->dump_fd, fname))
+    {
+      LOG(LOG_ERR, "failed to export %s timing data (%s)\n", timer_op_names[op], strerror(errno));
+      ret++;
+    }
   }
-  if (list_export(dctxt->close, dctxt->dump_fd, "close") < 0)
+  if (summary && fclose(summary))
   {
-    LOG(LOG_ERR, "failed to export close timing data (%s)\n", strerror(errno));
+    LOG(LOG_ERR, "failed to write timing summary file (%s)\n", strerror(errno));
     ret++;
   }
+  free(merged);
   return ret;
 }
 
@@ -363,90 +414,20 @@ int dump_times(TIMER_DAL_CTXT dctxt)
  * Free a DAL context and any allocated resources asssociated with it.
  * @param TIMER_DAL_CTXT dctxt : Context to be freed
  */
-void try_free_dctxt(TIMER_DAL_CTXT dctxt)
+void free_dctxt(TIMER_DAL_CTXT dctxt)
 {
-  // Free any lists that have already been initialized
-  if (dctxt->verify)
-  {
-    list_destroy(dctxt->verify);
-  }
-  if (dctxt->migrate)
+  pthread_key_delete(dctxt->slabkey);
+  slab s = dctxt->slabs;
+  while (s)
   {
-    list_destroy(dctxt->migrate);
+    slab next = s->next;
+    free(s);
+    s = next;
   }
-  if (dctxt->del)
-  {
-    list_destroy(dctxt->del);
-  }
-  if (dctxt->stat)
-  {
-    list_destroy(dctxt->stat);
-  }
-  if (dctxt->cleanup)
-  {
-    list_destroy(dctxt->cleanup);
-  }
-  if (dctxt->open)
-  {
-    list_destroy(dctxt->open);
-  }
-  if (dctxt->set_meta)
-  {
-    list_destroy(dctxt->set_meta);
-  }
-  if (dctxt->get_meta)
-  {
-    list_destroy(dctxt->get_meta);
-  }
-  if (dctxt->put)
-  {
-    list_destroy(dctxt->put);
-  }
-  if (dctxt->get)
-  {
-    list_destroy(dctxt->get);
-  }
-  if (dctxt->abort)
-  {
-    list_destroy(dctxt->abort);
-  }
-  if (dctxt->close)
-  {
-    list_destroy(dctxt->close);
-  }
-
   close(dctxt->dump_fd);
-  dctxt->under_dal->cleanup(dctxt->under_dal);
   free(dctxt);
 }
 
-/** (INTERNAL HELPER FUNCTION)
- * Free a block context and any allocated resources asssociated with it.
- * @param TIMER_BLOCK_CTXT dctxt : Context to be freed
- */
-void try_free_bctxt(TIMER_BLOCK_CTXT bctxt)
-{
-  // Free any lists that have already been initialized
-  if (bctxt->set_meta)
-  {
-    list_destroy(bctxt->set_meta);
-  }
-  if (bctxt->get_meta)
-  {
-    list_destroy(bctxt->get_meta);
-  }
-  if (bctxt->put)
-  {
-    list_destroy(bctxt->put);
-  }
-  if (bctxt->get)
-  {
-    list_destroy(bctxt->get);
-  }
-
-  free(bctxt);
-}
-
 //   -------------    TIMER IMPLEMENTATION    -------------
 
 int timer_verify(DAL_CTXT ctxt, int flags)
@@ -460,20 +441,13 @@ int timer_verify(DAL_CTXT ctxt, int flags)
   TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)ctxt; // Should have been passed a timer context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = dctxt->under_dal->verify(dctxt->under_dal->ctxt, flags);
 
-  // get end time
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->verify, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_VERIFY, &beg);
 
   return ret;
 }
@@ -489,19 +463,13 @@ int timer_migrate(DAL_CTXT ctxt, const char *objID, DAL_location src, DAL_locati
   TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)ctxt; // Should have been passed a timer context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = dctxt->under_dal->migrate(dctxt->under_dal->ctxt, objID, src, dest, offline);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->migrate, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_MIGRATE, &beg);
 
   return ret;
 }
@@ -517,19 +485,13 @@ int timer_del(DAL_CTXT ctxt, DAL_location location, const char *objID)
   TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)ctxt; // Should have been passed a timer context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = dctxt->under_dal->del(dctxt->under_dal->ctxt, location, objID);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->del, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_DEL, &beg);
 
   return ret;
 }
@@ -545,19 +507,13 @@ int timer_stat(DAL_CTXT ctxt, DAL_location location, const char *objID)
   TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)ctxt; // Should have been passed a timer context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = dctxt->under_dal->stat(dctxt->under_dal->ctxt, location, objID);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->stat, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_STAT, &beg);
 
   return ret;
 }
@@ -573,19 +529,13 @@ int timer_cleanup(DAL dal)
   TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)dal->ctxt; // Should have been passed a DAL
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = dctxt->under_dal->cleanup(dctxt->under_dal);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->cleanup, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_CLEANUP, &beg);
 
   if (ret)
   {
@@ -594,21 +544,7 @@ int timer_cleanup(DAL dal)
 
   dump_times(dctxt);
 
-  list_destroy(dctxt->verify);
-  list_destroy(dctxt->migrate);
-  list_destroy(dctxt->del);
-  list_destroy(dctxt->stat);
-  list_destroy(dctxt->cleanup);
-  list_destroy(dctxt->open);
-  list_destroy(dctxt->set_meta);
-  list_destroy(dctxt->get_meta);
-  list_destroy(dctxt->put);
-  list_destroy(dctxt->get);
-  list_destroy(dctxt->abort);
-  list_destroy(dctxt->close);
-
-  close(dctxt->dump_fd);
-  free(dctxt);
+  free_dctxt(dctxt);
   free(dal);
   return 0;
 }
@@ -632,46 +568,14 @@ BLOCK_CTXT timer_open(DAL_CTXT ctxt, DAL_MODE mode, DAL_location location, const
 
   bctxt->global_ctxt = dctxt;
 
-  // Initialize timing data lists
-  if ((bctxt->set_meta = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize set_meta timing data list(%s)\n", strerror(errno));
-    try_free_bctxt(bctxt);
-    return NULL;
-  }
-  if ((bctxt->get_meta = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize get_meta timing data list(%s)\n", strerror(errno));
-    try_free_bctxt(bctxt);
-    return NULL;
-  }
-  if ((bctxt->put = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize put timing data list(%s)\n", strerror(errno));
-    try_free_bctxt(bctxt);
-    return NULL;
-  }
-  if ((bctxt->get = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize get timing data list(%s)\n", strerror(errno));
-    try_free_bctxt(bctxt);
-    return NULL;
-  }
-
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   bctxt->bctxt = dctxt->under_dal->open(dctxt->under_dal->ctxt, mode, location, objID);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(dctxt->open, tmp);
+  // record the elapsed time
+  timer_record(dctxt, TIMER_DAL_OPEN, &beg);
 
   if (bctxt->bctxt == NULL)
   {
@@ -693,19 +597,13 @@ int timer_set_meta(BLOCK_CTXT ctxt, const meta_info* source)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a timer context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = bctxt->global_ctxt->under_dal->set_meta(bctxt->bctxt, source);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->set_meta, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_SET_META, &beg);
 
   return ret;
 }
@@ -721,19 +619,13 @@ int timer_get_meta(BLOCK_CTXT ctxt, meta_info* target)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a block context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   ssize_t ret = bctxt->global_ctxt->under_dal->get_meta(bctxt->bctxt, target);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->get_meta, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_GET_META, &beg);
 
   return ret;
 }
@@ -749,19 +641,13 @@ int timer_put(BLOCK_CTXT ctxt, const void *buf, size_t size)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a block context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = bctxt->global_ctxt->under_dal->put(bctxt->bctxt, buf, size);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->put, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_PUT, &beg);
 
   return ret;
 }
@@ -777,19 +663,13 @@ ssize_t timer_get(BLOCK_CTXT ctxt, void *buf, size_t size, off_t offset)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a block context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   ssize_t ret = bctxt->global_ctxt->under_dal->get(bctxt->bctxt, buf, size, offset);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->get, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_GET, &beg);
 
   return ret;
 }
@@ -805,31 +685,20 @@ int timer_abort(BLOCK_CTXT ctxt)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a block context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = bctxt->global_ctxt->under_dal->abort(bctxt->bctxt);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->global_ctxt->abort, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_ABORT, &beg);
 
   if (ret)
   {
     return ret;
   }
 
-  list_migrate(bctxt->global_ctxt->set_meta, bctxt->set_meta);
-  list_migrate(bctxt->global_ctxt->get_meta, bctxt->get_meta);
-  list_migrate(bctxt->global_ctxt->put, bctxt->put);
-  list_migrate(bctxt->global_ctxt->get, bctxt->get);
-
-  try_free_bctxt(bctxt);
+  free(bctxt);
   return 0;
 }
 
@@ -844,31 +713,54 @@ int timer_close(BLOCK_CTXT ctxt)
   TIMER_BLOCK_CTXT bctxt = (TIMER_BLOCK_CTXT)ctxt; // Should have been passed a block context
 
   // get start time
-  struct timeval beg;
-  gettimeofday(&beg, NULL);
+  struct timespec beg;
+  clock_gettime(CLOCK_MONOTONIC, &beg);
 
   int ret = bctxt->global_ctxt->under_dal->close(bctxt->bctxt);
 
-  // get end time
-  struct timeval end;
-  gettimeofday(&end, NULL);
-
-  // add interval to list
-  char tmp[20];
-  sprintf(tmp, "%.6f\n", (end.tv_sec - beg.tv_sec) + (end.tv_usec + beg.tv_usec) * 1e-6);
-  list_add(bctxt->global_ctxt->close, tmp);
+  // record the elapsed time
+  timer_record(bctxt->global_ctxt, TIMER_DAL_CLOSE, &beg);
 
   if (ret)
   {
     return ret;
   }
 
-  list_migrate(bctxt->global_ctxt->set_meta, bctxt->set_meta);
-  list_migrate(bctxt->global_ctxt->get_meta, bctxt->get_meta);
-  list_migrate(bctxt->global_ctxt->put, bctxt->put);
-  list_migrate(bctxt->global_ctxt->get, bctxt->get);
+  free(bctxt);
+  return 0;
+}
+
+//   -------------    TIMER SNAPSHOT    -------------
+
+int timer_dal_snapshot(DAL dal, timer_dal_stats *stats)
+{
+  if (dal == NULL || stats == NULL)
+  {
+    LOG(LOG_ERR, "received a NULL dal or stats reference!\n");
+    errno = EINVAL;
+    return -1;
+  }
+  if (dal->name == NULL || strcmp(dal->name, "timer"))
+  {
+    LOG(LOG_ERR, "received a non-timer dal!\n");
+    errno = EINVAL;
+    return -1;
+  }
 
-  try_free_bctxt(bctxt);
+  TIMER_DAL_CTXT dctxt = (TIMER_DAL_CTXT)dal->ctxt;
+  timer_hist *merged = malloc(sizeof(timer_hist));
+  if (merged == NULL)
+  {
+    LOG(LOG_ERR, "failed to allocate space for a merged histogram\n");
+    return -1;
+  }
+  int op;
+  for (op = 0; op < TIMER_DAL_OPCOUNT; op++)
+  {
+    hist_merge(dctxt, op, merged);
+    hist_summarize(merged, op, &stats[op]);
+  }
+  free(merged);
   return 0;
 }
 
@@ -914,77 +806,14 @@ DAL timer_dal_init(xmlNode *root, DAL_location max_loc)
     return NULL;
   }
 
-  // Initialize timing data lists
-  if ((dctxt->verify = list_init()) == NULL)
+  // Initialize per-thread timing data
+  dctxt->slabs = NULL;
+  if (pthread_key_create(&dctxt->slabkey, slab_release))
   {
-    LOG(LOG_ERR, "failed to initialize verify timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->migrate = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize migrate timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->del = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize dal timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->stat = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize stat timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->cleanup = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize cleanup timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->open = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize open timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->set_meta = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize set_meta timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->get_meta = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize get_meta timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->put = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize put timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->get = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize get timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->abort = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize abort timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
-    return NULL;
-  }
-  if ((dctxt->close = list_init()) == NULL)
-  {
-    LOG(LOG_ERR, "failed to initialize close timing data list(%s)\n", strerror(errno));
-    try_free_dctxt(dctxt);
+    LOG(LOG_ERR, "failed to create a timing data thread key\n");
+    close(dctxt->dump_fd);
+    dctxt->under_dal->cleanup(dctxt->under_dal);
+    free(dctxt);
     return NULL;
   }
 
@@ -993,7 +822,8 @@ DAL timer_dal_init(xmlNode *root, DAL_location max_loc)
   if (tdal == NULL)
   {
     LOG(LOG_ERR, "failed to allocate space for a DAL_struct\n");
-    try_free_dctxt(dctxt);
+    dctxt->under_dal->cleanup(dctxt->under_dal);
+    free_dctxt(dctxt);
     return NULL;
   }
   tdal->name = "timer";
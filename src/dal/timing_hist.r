@@ -1,12 +1,16 @@
 #! /usr/bin/env Rscript
-getmode <- function(d){
-  uniqd <- unique(d)
-  uniqd[which.max(tabulate(match(d, uniqd)))]
-}
+# Plots a '<function>.hist' bucket file ( "low_s,high_s,count" lines ) produced by the timer DAL
 
 args <- commandArgs(trailingOnly = TRUE)
 filename <- args[1]
-d<-scan(filename, quiet=TRUE)
+d <- read.csv(filename)
+
+mids <- (d$low_s + d$high_s) / 2
+total <- sum(d$count)
+cumulative <- cumsum(d$count)
+pct <- function(p){ d$high_s[which(cumulative >= p * total)[1]] }
 
 png(paste(basename(args[1]), ".png", sep=""), width = 960, height = 480)
-h <- hist(d, plot=TRUE, main = paste("total:", round(length(d), digits=6), ", min:", round(min(d), digits=6), "s, max:", round(max(d), digits=6), "s, median:", round(median(d), digits=6), "s, mode:", round(getmode(d), digits=6), "s, mean:", round(mean(d), digits=6), "s, variance:", round(var(d), digits=6), "s\n", sep=""), xlab = paste(basename(args[1]), "(s)"))
+barplot(d$count, names.arg = signif(mids, digits=3), las = 2,
+        main = paste("total:", total, ", min:", round(min(d$low_s), digits=6), "s, max:", round(max(d$high_s), digits=6), "s, mean:", round(sum(mids * d$count) / total, digits=6), "s\np50:", round(pct(0.5), digits=6), "s, p99:", round(pct(0.99), digits=6), "s, p999:", round(pct(0.999), digits=6), "s", sep=""),
+        xlab = paste(basename(args[1]), "(s)"), ylab = "count")
@@ -16,6 +16,7 @@
 #define LOG_PREFIX "datastream"
 
 #include "logging/logging.h"
+#include "logging/perfstats.h"
 #include "datastream.h"
 #include "general_include/numdigits.h"
 
@@ -28,6 +29,13 @@
 #define INITIAL_FILE_ALLOC 64
 #define FILE_ALLOC_MULT     2
 
+// prefix of a parallel write session string ( "PWRITE(<writers>|<ftaglen>)<FTAG><FINFO>" )
+#define PWRITE_SESSION_HEAD "PWRITE("
+
+// umask() is process-wide, so background object closes must not interleave their refdir
+// creation with that of any other thread
+static pthread_mutex_t umasklock = PTHREAD_MUTEX_INITIALIZER;
+
 
 typedef struct datastream_position_struct {
    size_t totaloffset;      // offset from beginning of file ( SEEK_SET w/ this val would be no-op; includes 'fake' data )
@@ -44,6 +52,23 @@ typedef struct datastream_position_struct {
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
+int drain_closers(DATASTREAM stream);
+
+// number of seconds a background closer thread will wait for work before exiting
+#define CLOSEPOOL_IDLE_SECONDS 10
+
+// process-wide pool of threads which close data objects in the background, on behalf of all streams
+static struct closepool_struct {
+   pthread_mutex_t    lock;
+   pthread_cond_t     queued;   // signaled whenever a closer is queued
+   pthread_cond_t     complete; // broadcast whenever a closer completes
+   DATASTREAM_CLOSER* head;     // oldest closer awaiting a thread
+   DATASTREAM_CLOSER* tail;     // newest closer awaiting a thread
+   int                threads;  // number of running pool threads
+   int                idle;     // number of pool threads waiting for work
+} closepool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0 };
+int putindex(DATASTREAM stream);
+
 /**
  * Generate a repack marker path for a file
  * @param const char* rpath : Reference path of the repacked file ( can be left NULL, if unknown )
@@ -105,6 +130,10 @@ char* repackmarkertgt( const char* rpath, FTAG* ftag, const marfs_ms* ms ) {
 void freestream(DATASTREAM stream) {
    // shorthand references
    const marfs_ms* ms = &(stream->ns->prepo->metascheme);
+   // wait for any background object closes
+   if (drain_closers(stream)) {
+      LOG(LOG_WARNING, "Background close failure of previous stream object\n");
+   }
    // abort any data handle
    if (stream->datahandle && ne_abort(stream->datahandle)) {
       LOG(LOG_WARNING, "Failed to abort stream datahandle\n");
@@ -125,6 +154,9 @@ void freestream(DATASTREAM stream) {
    if (stream->finfostr) {
       free(stream->finfostr);
    }
+   if (stream->objindex) {
+      free(stream->objindex);
+   }
    if (stream->finfo.path) {
       free(stream->finfo.path);
    }
@@ -920,14 +952,70 @@ int open_repack_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt) {
    return 0;
 }
 
+/**
+ * Open a READ handle against the given data object of the file referenced by the given DATASTREAM
+ * NOTE -- This function does not modify the DATASTREAM itself, and is therefore safe to call
+ *         in parallel with other read-only DATASTREAM references ( see datastream_pread() )
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param size_t objno : Number of the data object to be opened
+ * @param size_t offset : Offset within the data object to seek the new handle to
+ * @return ne_handle : Newly opened handle, or NULL on failure
+ */
+ne_handle open_read_obj(DATASTREAM stream, size_t objno, size_t offset) {
+   // shorthand references
+   marfs_ds* ds = &(stream->ns->prepo->datascheme);
+
+   // find the length of the current object name
+   FTAG tgttag = stream->files[stream->curfile].ftag;
+   tgttag.objno = objno; // we actually want the stream object number
+   tgttag.offset = offset;
+
+   // identify current object target
+   char* objname = NULL;
+   ne_erasure erasure;
+   ne_location location;
+   if (datastream_objtarget(&(tgttag), ds, &(objname), &(erasure), &(location))) {
+      LOG(LOG_ERR, "Failed to identify the current object target\n");
+      return NULL;
+   }
+
+   // open a handle for the object
+   LOG(LOG_INFO, "Opening object for READ: \"%s\"\n", objname);
+   ne_handle handle = ne_open(ds->nectxt, objname, location, erasure, NE_RDALL);
+   if (handle == NULL) {
+      LOG(LOG_ERR, "Failed to open object \"%s\"\n", objname);
+      free(objname);
+      return NULL;
+   }
+   free(objname); // done with object name
+
+   // we may need to seek to a specific offset
+   if (offset) {
+      LOG(LOG_INFO, "Seeking to offset %zd of object %zu\n", offset, objno);
+      if (offset != ne_seek(handle, offset)) {
+         LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n", offset, objno);
+         ne_abort(handle);
+         return NULL;
+      }
+   }
+
+   return handle;
+}
+
 /**
  * Open the current data object of the given DATASTREAM
  * @param DATASTREAM stream : Current DATASTREAM
  * @return int : Zero on success, or -1 on failure
  */
 int open_current_obj(DATASTREAM stream) {
+   // read streams have no recovery info to output
+   if (stream->type == READ_STREAM) {
+      stream->datahandle = open_read_obj(stream, stream->objno, stream->offset);
+      return (stream->datahandle == NULL) ? -1 : 0;
+   }
+
    // shorthand references
-   const marfs_ds* ds = &(stream->ns->prepo->datascheme);
+   marfs_ds* ds = &(stream->ns->prepo->datascheme);
 
    // find the length of the current object name
    FTAG tgttag = stream->files[stream->curfile].ftag;
@@ -944,25 +1032,20 @@ int open_current_obj(DATASTREAM stream) {
    }
 
    // open a handle for the new object
-   if (stream->type == READ_STREAM) {
-      LOG(LOG_INFO, "Opening object for READ: \"%s\"\n", objname);
-      stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_RDALL);
-   }
-   else {
-      if (stream->type == CREATE_STREAM  ||  stream->type == REPACK_STREAM) {
-         // need to update file bytes and/or datastate
-         STREAMFILE* curfile = stream->files + stream->curfile;
-         if ((curfile->ftag.state & FTAG_DATASTATE) < FTAG_SIZED) {
-            curfile->ftag.state = FTAG_SIZED | (curfile->ftag.state & ~(FTAG_DATASTATE));
-         }
-         if (putftag(stream, curfile)) {
-            LOG(LOG_ERR, "Failed to update FTAG of file %zu\n", curfile->ftag.fileno);
-            return -1;
-         }
+   if (stream->type == CREATE_STREAM  ||  stream->type == REPACK_STREAM) {
+      // need to update file bytes and/or datastate
+      STREAMFILE* curfile = stream->files + stream->curfile;
+      if ((curfile->ftag.state & FTAG_DATASTATE) < FTAG_SIZED) {
+         curfile->ftag.state = FTAG_SIZED | (curfile->ftag.state & ~(FTAG_DATASTATE));
+      }
+      if (putftag(stream, curfile)) {
+         LOG(LOG_ERR, "Failed to update FTAG of file %zu\n", curfile->ftag.fileno);
+         free(objname);
+         return -1;
       }
-      LOG(LOG_INFO, "Opening object for WRITE: \"%s\"\n", objname);
-      stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_WRALL);
    }
+   LOG(LOG_INFO, "Opening object for WRITE: \"%s\"\n", objname);
+   stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_WRALL);
    if (stream->datahandle == NULL) {
       LOG(LOG_ERR, "Failed to open object \"%s\"\n", objname);
       free(objname);
@@ -970,76 +1053,66 @@ int open_current_obj(DATASTREAM stream) {
    }
    free(objname); // done with object name
 
-   if (stream->type == READ_STREAM) {
-      // if we're reading, we may need to seek to a specific offset
-      if (stream->offset) {
-         LOG(LOG_INFO, "Seeking to offset %zd of object %zu\n",
-            stream->offset, stream->objno);
-         if (stream->offset != ne_seek(stream->datahandle, stream->offset)) {
-            LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n", stream->offset, stream->objno);
-            ne_abort(stream->datahandle);
-            stream->datahandle = NULL;
-            return -1;
-         }
-      }
+   // our offset value should match the recovery header length
+   if (stream->offset != stream->recoveryheaderlen) {
+      LOG(LOG_ERR, "Stream offset does not match recovery header length of %zu\n",
+         stream->recoveryheaderlen);
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL;
+      return -1;
    }
-   else {
-      // our offset value should match the recovery header length
-      if (stream->offset != stream->recoveryheaderlen) {
-         LOG(LOG_ERR, "Stream offset does not match recovery header length of %zu\n",
-            stream->recoveryheaderlen);
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         return -1;
-      }
 
-      // if we're writing out a new object, output a recovery header
-      RECOVERY_HEADER header =
-      {
-         .majorversion = RECOVERY_CURRENT_MAJORVERSION,
-         .minorversion = RECOVERY_CURRENT_MINORVERSION,
-         .ctag = stream->ctag,
-         .streamid = stream->streamid
-      };
-      char* recovheader = malloc(sizeof(char) * (stream->recoveryheaderlen + 1));
-      if (recovheader == NULL) {
-         LOG(LOG_ERR, "Failed to allocate space for recovery header string\n");
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         return -1;
-      }
-      if (recovery_headertostr(&(header), recovheader, stream->recoveryheaderlen + 1) != stream->recoveryheaderlen) {
-         LOG(LOG_ERR, "Recovery header string has inconsistent length (expected %zu)\n",
-            stream->recoveryheaderlen);
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         free(recovheader);
-         errno = EFAULT;
-         return -1;
-      }
-      if (ne_write(stream->datahandle, recovheader, stream->recoveryheaderlen) != stream->recoveryheaderlen) {
-         LOG(LOG_ERR, "Failed to write recovery header to new data object\n");
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         free(recovheader);
-         return -1;
-      }
-      free(recovheader); // done with recovery header string
+   // if we're writing out a new object, output a recovery header
+   RECOVERY_HEADER header =
+   {
+      .majorversion = RECOVERY_CURRENT_MAJORVERSION,
+      .minorversion = RECOVERY_CURRENT_MINORVERSION,
+      .ctag = stream->ctag,
+      .streamid = stream->streamid
+   };
+   char* recovheader = malloc(sizeof(char) * (stream->recoveryheaderlen + 1));
+   if (recovheader == NULL) {
+      LOG(LOG_ERR, "Failed to allocate space for recovery header string\n");
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL;
+      return -1;
+   }
+   if (recovery_headertostr(&(header), recovheader, stream->recoveryheaderlen + 1) != stream->recoveryheaderlen) {
+      LOG(LOG_ERR, "Recovery header string has inconsistent length (expected %zu)\n",
+         stream->recoveryheaderlen);
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL;
+      free(recovheader);
+      errno = EFAULT;
+      return -1;
+   }
+   if (ne_write(stream->datahandle, recovheader, stream->recoveryheaderlen) != stream->recoveryheaderlen) {
+      LOG(LOG_ERR, "Failed to write recovery header to new data object\n");
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL;
+      free(recovheader);
+      return -1;
    }
+   free(recovheader); // done with recovery header string
+   stream->objindexcount = 0; // no content has yet been written to this object
 
    return 0;
 }
 
 /**
- * Close the current DATASTERAM object reference, potentially populating a rebuild string
+ * Close the given object handle of a DATASTREAM, potentially populating a rebuild string
+ * NOTE -- This function does not modify the DATASTREAM itself, and is therefore safe to call
+ *         in parallel with other read-only DATASTREAM references ( see datastream_pread() )
  * @param DATASTREAM stream : Current DATASTREAM
- * @param FTAG* curftag : Reference to the FTAG value associated with the current object
+ * @param ne_handle handle : Object handle to be closed ( may be NULL )
+ * @param FTAG* curftag : Reference to the FTAG value associated with the object
  *                        ( used to generate the rebuild marker path )
  * @param MDAL_CTXT mdalctxt : Optional reference to an MDAL_CTXT for the current NS
  *                             ( to avoid generating a new one for rebuild marker creation )
  * @return int : Zero on success, or -1 on failure
  */
-int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+int close_obj(DATASTREAM stream, ne_handle handle, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   PERF_SPAN( span, PERF_DATASTREAM_OBJCLOSE );
    RTAG rtag;
    bzero( &(rtag), sizeof(RTAG) );
    MDAL mdal = stream->ns->prepo->metascheme.mdal;
@@ -1049,12 +1122,12 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
    rtag.stripewidth = curftag->protection.N + curftag->protection.E;
    if ( rtag_alloc( &(rtag) ) ) {
       LOG(LOG_ERR, "Failed to allocate data object status arrays\n");
+      if (handle != NULL) { ne_abort(handle); }
       return -1;
    }
    int closeres = 0;
-   if (stream->datahandle != NULL) {
-      closeres = ne_close(stream->datahandle, NULL, &(rtag.stripestate));
-      stream->datahandle = NULL; // never reattempt this process
+   if (handle != NULL) {
+      closeres = ne_close(handle, NULL, &(rtag.stripestate));
    }
    if (closeres > 0) {
       // object synced, but with errors
@@ -1134,6 +1207,7 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       }
 
       // create parent paths, as necessary
+      pthread_mutex_lock( &(umasklock) );
       mode_t oldmask = umask(0); // blow away umask, to avoid improper refdir perms
       char* rpathparse = rpath;
       while ( *rpathparse != '\0' ) {
@@ -1151,6 +1225,7 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
                      mdal->destroyctxt(mdalctxt);
                   }
                   umask(oldmask); //restore orig umask
+                  pthread_mutex_unlock( &(umasklock) );
                   errno = EFAULT;
                   return -1;
                }
@@ -1162,6 +1237,7 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          else { rpathparse++; }
       }
       umask(oldmask); //restore orig umask
+      pthread_mutex_unlock( &(umasklock) );
 
       // identify the rpath of the problem file
       char* filerpath = datastream_genrpath( curftag, stream->ns->prepo->metascheme.reftable, NULL, NULL );
@@ -1316,21 +1392,41 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
 }
 
 /**
- * Generate a new DATASTREAM of the given type and the given initial target file
+ * Close the current DATASTERAM object reference, potentially populating a rebuild string
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param FTAG* curftag : Reference to the FTAG value associated with the current object
+ *                        ( used to generate the rebuild marker path )
+ * @param MDAL_CTXT mdalctxt : Optional reference to an MDAL_CTXT for the current NS
+ *                             ( to avoid generating a new one for rebuild marker creation )
+ * @return int : Zero on success, or -1 on failure
+ */
+int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   // all previous objects must be finalized before this one
+   if (drain_closers(stream)) {
+      LOG(LOG_ERR, "Background close failure of previous stream object\n");
+      if (stream->datahandle) { ne_abort(stream->datahandle); }
+      stream->datahandle = NULL; // never reattempt this process
+      return -1;
+   }
+   if (stream->datahandle && putindex(stream)) {
+      LOG(LOG_ERR, "Failed to output recovery index of the current object\n");
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL; // never reattempt this process
+      return -1;
+   }
+   ne_handle handle = stream->datahandle;
+   stream->datahandle = NULL; // never reattempt this process
+   return close_obj(stream, handle, curftag, mdalctxt);
+}
+
+/**
+ * Allocate a new DATASTREAM of the given type, populated with default values and a single
+ * STREAMFILE reference ( but with no target file )
  * @param STREAM_TYPE type : Type of the DATASTREAM to be created
- * @param const char* path : Path of the initial file target
- * @param char rpathflag : If zero, treat 'path' as a user path
- *                         If non-zero, treat 'path' as a reference path
- *                         NOTE -- ALL datastream_*() functions should use USER PATHS ONLY
- *                                 This flag is intended to provide options to specific
- *                                 administrator programs ( see streamwalker.c, for example )
- * @param mode_t mode : Mode of the target file ( only used if type == CREATE_STREAM )
- * @param const char* ctag : Current MarFS ctag string ( only used if type == CREATE_STREAM )
- * @param MDAL_FHANDLE* phandle : Reference to be populated with a preserved meta handle
- *                                ( if no FTAG value exists; specific to READ streams )
- * @return DATASTREAM : Created DATASTREAM, or NULL on failure
+ * @param marfs_position* pos : Reference to the marfs_position value of the stream
+ * @return DATASTREAM : Allocated DATASTREAM, or NULL on failure
  */
-DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_position* pos, mode_t mode, const char* ctag, MDAL_FHANDLE* phandle) {
+DATASTREAM allocstream(STREAM_TYPE type, marfs_position* pos) {
    // create some shorthand references
    marfs_ds* ds = &(pos->ns->prepo->datascheme);
    marfs_ms* ms = &(pos->ns->prepo->metascheme);
@@ -1356,6 +1452,13 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
    stream->offset = 0; // redefined below
    stream->excessoffset = 0;
    stream->datahandle = NULL;
+   stream->objindex = NULL;
+   stream->objindexcount = 0;
+   stream->objindexalloc = 0;
+   stream->closerhead = 0;
+   stream->closercount = 0;
+   stream->pwriters = 0;
+   stream->pwriteend = 0;
    stream->files = NULL; // redefined below
    stream->curfile = 0;
    stream->filealloc = 0; // redefined below
@@ -1422,6 +1525,31 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
    curfile->times[1].tv_nsec = 0;
    curfile->dotimes = 0;
 
+   return stream;
+}
+
+/**
+ * Generate a new DATASTREAM of the given type and the given initial target file
+ * @param STREAM_TYPE type : Type of the DATASTREAM to be created
+ * @param const char* path : Path of the initial file target
+ * @param char rpathflag : If zero, treat 'path' as a user path
+ *                         If non-zero, treat 'path' as a reference path
+ *                         NOTE -- ALL datastream_*() functions should use USER PATHS ONLY
+ *                                 This flag is intended to provide options to specific
+ *                                 administrator programs ( see streamwalker.c, for example )
+ * @param mode_t mode : Mode of the target file ( only used if type == CREATE_STREAM )
+ * @param const char* ctag : Current MarFS ctag string ( only used if type == CREATE_STREAM )
+ * @param MDAL_FHANDLE* phandle : Reference to be populated with a preserved meta handle
+ *                                ( if no FTAG value exists; specific to READ streams )
+ * @return DATASTREAM : Created DATASTREAM, or NULL on failure
+ */
+DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_position* pos, mode_t mode, const char* ctag, MDAL_FHANDLE* phandle) {
+   // allocate the new datastream and populate default values
+   DATASTREAM stream = allocstream(type, pos);
+   if (stream == NULL) {
+      return NULL;
+   }
+
    // perform type-dependent initialization
    if (type == CREATE_STREAM  ||  type == REPACK_STREAM) {
       // set the ctag value
@@ -1657,8 +1785,69 @@ int putfinfo(DATASTREAM stream) {
       LOG(LOG_ERR, "Failed to store file recovery info to data object\n");
       return -1;
    }
-   stream->offset += recoverybytes; // update our object offset
    LOG(LOG_INFO, "Wrote out RECOVERY_FINFO: \"%s\"\n", stream->finfostr);
+   if (DATASTREAM_RECOVERY_INDEX) {
+      // record the FINFO and the file data preceding it in the object index
+      if (stream->objindexcount == stream->objindexalloc) {
+         size_t newalloc = (stream->objindexalloc) ? stream->objindexalloc * 2 : INITIAL_FILE_ALLOC;
+         RECOVERY_INDEX* newindex = realloc(stream->objindex, sizeof(RECOVERY_INDEX) * newalloc);
+         if (newindex == NULL) {
+            LOG(LOG_ERR, "Failed to allocate %zu object index entries\n", newalloc);
+            return -1;
+         }
+         stream->objindex = newindex;
+         stream->objindexalloc = newalloc;
+      }
+      RECOVERY_INDEX* entry = stream->objindex + stream->objindexcount;
+      entry->dataoffset = stream->recoveryheaderlen;
+      if (stream->objindexcount) {
+         entry->dataoffset = (entry - 1)->finfooffset + (entry - 1)->finfolength;
+      }
+      entry->datalength = stream->offset - entry->dataoffset;
+      entry->finfooffset = stream->offset;
+      entry->finfolength = recoverybytes;
+      stream->objindexcount++;
+   }
+   stream->offset += recoverybytes; // update our object offset
+   return 0;
+}
+
+/**
+ * Output the RECOVERY_INDEX string representation of the current object content
+ * NOTE -- The index follows the final FINFO string of the object, and is not included in
+ *         the object data bounds ( the stream offset is left unaltered ).
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @return int : Zero on success, or -1 on failure
+ */
+int putindex(DATASTREAM stream) {
+   size_t indexcount = stream->objindexcount;
+   stream->objindexcount = 0; // never reattempt for this object
+   if (indexcount == 0) {
+      return 0; // nothing to index ( or indexing is disabled )
+   }
+   size_t indexlen = recovery_indextostr(stream->objindex, indexcount, NULL, 0);
+   if (indexlen == 0) {
+      LOG(LOG_ERR, "Failed to calculate recovery index size of %zu entries\n", indexcount);
+      return -1;
+   }
+   char* indexstr = malloc(sizeof(char) * (indexlen + 1));
+   if (indexstr == NULL) {
+      LOG(LOG_ERR, "Failed to allocate space for recovery index string\n");
+      return -1;
+   }
+   if (recovery_indextostr(stream->objindex, indexcount, indexstr, indexlen + 1) != indexlen) {
+      LOG(LOG_ERR, "Recovery index string has inconsistent length (expected %zu)\n", indexlen);
+      free(indexstr);
+      errno = EFAULT;
+      return -1;
+   }
+   if (ne_write(stream->datahandle, indexstr, indexlen) != indexlen) {
+      LOG(LOG_ERR, "Failed to store recovery index to data object\n");
+      free(indexstr);
+      return -1;
+   }
+   LOG(LOG_INFO, "Wrote out RECOVERY_INDEX of %zu entries\n", indexcount);
+   free(indexstr);
    return 0;
 }
 
@@ -1733,9 +1922,9 @@ int completefile(DATASTREAM stream, STREAMFILE* file) {
    }
    // shorthand references
    const marfs_ms* ms = &(stream->ns->prepo->metascheme);
-   // check for an extended file from a create stream
+   // check for an extended file from a create stream ( other than a parallel write session owner )
    if ((file->ftag.state & FTAG_WRITEABLE) && 
-       ( stream->type == CREATE_STREAM  ||  stream->type == REPACK_STREAM ) ) {
+       ( (stream->type == CREATE_STREAM  &&  stream->pwriters == 0)  ||  stream->type == REPACK_STREAM ) ) {
       LOG(LOG_ERR, "Cannot complete extended file from the creating stream\n");
       ms->mdal->close(file->metahandle);
       file->metahandle = NULL; // NULL out this handle, so that we never double close()
@@ -1920,6 +2109,232 @@ int completefile(DATASTREAM stream, STREAMFILE* file) {
    return 0;
 }
 
+/**
+ * Close a single data object of a stream, recording the result in its DATASTREAM_CLOSER
+ * @param DATASTREAM_CLOSER* closer : Reference to the DATASTREAM_CLOSER describing the object
+ */
+void closer_run(DATASTREAM_CLOSER* closer) {
+   errno = 0;
+   // a fresh MDAL_CTXT is generated if a rebuild marker is required, as no
+   //    caller ctxt can be safely shared with a background thread
+   closer->result = close_obj(closer->stream, closer->handle, &(closer->ftag), NULL);
+   closer->error = errno;
+   closer->handle = NULL;
+}
+
+/**
+ * Background thread routine, closing queued data objects of any stream until idle for
+ * CLOSEPOOL_IDLE_SECONDS
+ * @param void* arg : Unused
+ * @return void* : Always NULL ( results are recorded in each DATASTREAM_CLOSER )
+ */
+void* closer_thread(void* arg) {
+   pthread_mutex_lock(&(closepool.lock));
+   while (1) {
+      while (closepool.head == NULL) {
+         struct timespec idleuntil;
+         clock_gettime(CLOCK_REALTIME, &(idleuntil));
+         idleuntil.tv_sec += CLOSEPOOL_IDLE_SECONDS;
+         closepool.idle++;
+         int waitres = pthread_cond_timedwait(&(closepool.queued), &(closepool.lock), &(idleuntil));
+         closepool.idle--;
+         if (waitres == ETIMEDOUT && closepool.head == NULL) {
+            closepool.threads--;
+            pthread_mutex_unlock(&(closepool.lock));
+            return NULL;
+         }
+      }
+      DATASTREAM_CLOSER* closer = closepool.head;
+      closepool.head = closer->next;
+      if (closepool.head == NULL) {
+         closepool.tail = NULL;
+      }
+      pthread_mutex_unlock(&(closepool.lock));
+      closer_run(closer);
+      pthread_mutex_lock(&(closepool.lock));
+      closer->pending = 0;
+      pthread_cond_broadcast(&(closepool.complete));
+   }
+}
+
+/**
+ * Queue the given DATASTREAM_CLOSER for a background thread, launching a new thread if
+ * none are idle and the pool has not reached DATASTREAM_CLOSE_THREADS
+ * NOTE -- If no background thread is available at all, the close is performed inline
+ * @param DATASTREAM_CLOSER* closer : Reference to the DATASTREAM_CLOSER to be queued
+ */
+void closepool_submit(DATASTREAM_CLOSER* closer) {
+   pthread_mutex_lock(&(closepool.lock));
+   closer->pending = 1;
+   closer->next = NULL;
+   if (closepool.tail) {
+      closepool.tail->next = closer;
+   }
+   else {
+      closepool.head = closer;
+   }
+   closepool.tail = closer;
+   if (closepool.idle) {
+      pthread_cond_signal(&(closepool.queued));
+      pthread_mutex_unlock(&(closepool.lock));
+      return;
+   }
+   if (closepool.threads < DATASTREAM_CLOSE_THREADS) {
+      pthread_t thread;
+      pthread_attr_t attr;
+      int createres = pthread_attr_init(&(attr));
+      if (createres == 0) {
+         pthread_attr_setdetachstate(&(attr), PTHREAD_CREATE_DETACHED);
+         createres = pthread_create(&(thread), &(attr), closer_thread, NULL);
+         pthread_attr_destroy(&(attr));
+      }
+      if (createres == 0) {
+         closepool.threads++;
+      }
+      else if (closepool.threads == 0) {
+         // with no thread to service the queue, it can only hold this closer
+         LOG(LOG_WARNING, "Failed to launch a closer thread, closing object %zu inline\n", closer->ftag.objno);
+         closepool.head = NULL;
+         closepool.tail = NULL;
+         closer->pending = 0;
+         pthread_mutex_unlock(&(closepool.lock));
+         closer_run(closer);
+         return;
+      }
+   }
+   pthread_mutex_unlock(&(closepool.lock));
+}
+
+/**
+ * Wait for the oldest background close of the given stream, then complete all files
+ * which ended within that object
+ * @param DATASTREAM stream : DATASTREAM to reap a closing object from
+ * @return int : Zero on success, or -1 on failure ( either of the close or of file completion )
+ */
+int reap_closer(DATASTREAM stream) {
+   if (stream->closercount == 0) {
+      return 0;
+   }
+   const marfs_ms* ms = &(stream->ns->prepo->metascheme);
+   DATASTREAM_CLOSER* closer = stream->closers + stream->closerhead;
+   stream->closerhead = (stream->closerhead + 1) % DATASTREAM_MAX_CLOSING;
+   stream->closercount--;
+   int retval = 0;
+   pthread_mutex_lock(&(closepool.lock));
+   while (closer->pending) {
+      pthread_cond_wait(&(closepool.complete), &(closepool.lock));
+   }
+   pthread_mutex_unlock(&(closepool.lock));
+   if (closer->result) {
+      LOG(LOG_ERR, "Failed to close data object %zu\n", closer->ftag.objno);
+      retval = -1;
+   }
+   // complete ( or, on failure, just close ) all files that ended within the object
+   size_t fileindex = 0;
+   for (; fileindex < closer->filecount; fileindex++) {
+      STREAMFILE* file = closer->files + fileindex;
+      if (retval) {
+         if (file->metahandle && ms->mdal->close(file->metahandle)) {
+            LOG(LOG_WARNING, "Failed to close meta handle for file %zu\n", file->ftag.fileno);
+         }
+         file->metahandle = NULL;
+      }
+      else if (completefile(stream, file)) {
+         LOG(LOG_ERR, "Failed to complete file %zu\n", file->ftag.fileno);
+         closer->error = errno;
+         retval = -1;
+      }
+   }
+   if (closer->files) {
+      free(closer->files);
+   }
+   closer->files = NULL;
+   closer->filecount = 0;
+   if (retval) {
+      errno = closer->error;
+   }
+   return retval;
+}
+
+/**
+ * Wait for all background object closes of the given stream
+ * @param DATASTREAM stream : DATASTREAM to drain
+ * @return int : Zero on success, or -1 if any close or file completion failed
+ */
+int drain_closers(DATASTREAM stream) {
+   int retval = 0;
+   int olderrno = 0;
+   while (stream->closercount) {
+      if (reap_closer(stream)) {
+         retval = -1;
+         olderrno = errno;
+      }
+   }
+   if (retval) {
+      errno = olderrno;
+   }
+   return retval;
+}
+
+/**
+ * Hand off the current data object of a CREATE/EDIT/REPACK stream to a background thread
+ * for closing, along with all previous files which ended within that object
+ * NOTE -- If the maximum number of objects are already closing, this will first wait for
+ *         the oldest of those to complete.  Failures of a background close are reported
+ *         by a subsequent reap_closer()/drain_closers() call.
+ * @param DATASTREAM stream : DATASTREAM to close the current object of
+ * @param FTAG* curftag : Reference to the FTAG value associated with the current object
+ * @return int : Zero on success, or -1 on failure
+ */
+int close_current_obj_async(DATASTREAM stream, FTAG* curftag) {
+   // respect our limit on closing objects
+   if (stream->closercount == DATASTREAM_MAX_CLOSING && reap_closer(stream)) {
+      LOG(LOG_ERR, "Background close failure of previous stream object\n");
+      if (stream->datahandle) { ne_abort(stream->datahandle); }
+      stream->datahandle = NULL; // never reattempt this process
+      return -1;
+   }
+   if (stream->datahandle && putindex(stream)) {
+      LOG(LOG_ERR, "Failed to output recovery index of the current object\n");
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL; // never reattempt this process
+      return -1;
+   }
+   DATASTREAM_CLOSER* closer = stream->closers +
+      ((stream->closerhead + stream->closercount) % DATASTREAM_MAX_CLOSING);
+   closer->stream = stream;
+   closer->handle = stream->datahandle;
+   stream->datahandle = NULL; // never reattempt this process
+   closer->ftag = *curftag;
+   closer->files = NULL;
+   closer->filecount = 0;
+   closer->result = 0;
+   closer->error = 0;
+   // take ownership of all previous files, which may only be completed once this object is synced
+   if ((stream->type == CREATE_STREAM || stream->type == REPACK_STREAM) && stream->curfile) {
+      closer->files = malloc(sizeof(STREAMFILE) * stream->curfile);
+      if (closer->files == NULL) {
+         LOG(LOG_ERR, "Failed to allocate a list of %zu pending files\n", stream->curfile);
+         if (closer->handle) { ne_abort(closer->handle); }
+         closer->handle = NULL;
+         return -1;
+      }
+      memcpy(closer->files, stream->files, sizeof(STREAMFILE) * stream->curfile);
+      closer->filecount = stream->curfile;
+      size_t fileindex = 0;
+      for (; fileindex < stream->curfile; fileindex++) {
+         stream->files[fileindex].metahandle = NULL;
+      }
+      // shift the current file reference to the front of the list
+      stream->files[0] = stream->files[stream->curfile];
+      stream->files[stream->curfile].metahandle = NULL;
+      stream->curfile = 0;
+   }
+   stream->closercount++;
+   closepool_submit(closer); // result is reaped in order, regardless of completion order
+   return 0;
+}
+
 
 //   -------------   EXTERNAL FUNCTIONS    -------------
 
@@ -2084,6 +2499,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
    free(refname); // done with this tmp string
 
    if ( mdal  &&  ctxt ) {
+      pthread_mutex_lock( &(umasklock) );
       mode_t oldmask = umask(0); // blow away umask, to avoid improper refdir perms
       // create parent paths, as necessary
       char* rpathparse = rpath;
@@ -2098,6 +2514,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
                   LOG(LOG_ERR, "Failed to create refdir parent \"%s\" for rebuild marker\n", rpath);
                   free(rpath);
                   umask(oldmask); //restore orig umask
+                  pthread_mutex_unlock( &(umasklock) );
                   errno = EFAULT;
                   return NULL;
                }
@@ -2109,6 +2526,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
          else { rpathparse++; }
       }
       umask(oldmask); //restore orig umask
+      pthread_mutex_unlock( &(umasklock) );
    }
 
    return rpath;
@@ -2117,7 +2535,8 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
 /**
  * Generate data object target info based on the given FTAG and datascheme references
  * @param FTAG* ftag : Reference to the FTAG value to generate target info for
- * @param const marfs_ds* ds : Reference to the current MarFS data scheme
+ * @param marfs_ds* ds : Reference to the current MarFS data scheme
+ *                      ( materialized on first use, see config_fortifydatascheme() )
  * @param char** objectname : Reference to a char* to be populated with the object name
  * @param ne_erasure* erasure : Reference to an ne_erasure struct to be populated with
  *                              object erasure info
@@ -2125,7 +2544,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
  *                                object location info
  * @return int : Zero on success, or -1 on failure
  */
-int datastream_objtarget(FTAG* ftag, const marfs_ds* ds, char** objectname, ne_erasure* erasure, ne_location* location) {
+int datastream_objtarget(FTAG* ftag, marfs_ds* ds, char** objectname, ne_erasure* erasure, ne_location* location) {
    // check for invalid args
    if (ftag == NULL) {
       LOG(LOG_ERR, "Received a NULL FTAG reference\n");
@@ -2152,6 +2571,11 @@ int datastream_objtarget(FTAG* ftag, const marfs_ds* ds, char** objectname, ne_e
       errno = EINVAL;
       return -1;
    }
+   // object placement requires the distribution tables ( and, for callers, the NE context )
+   if (config_fortifydatascheme(ds)) {
+      LOG(LOG_ERR, "Failed to initialize the MarFS data scheme\n");
+      return -1;
+   }
    // find the length of the current object name
    ssize_t objnamelen = ftag_datatgt(ftag, NULL, 0);
    if (objnamelen <= 0) {
@@ -2241,6 +2665,7 @@ int datastream_objtarget(FTAG* ftag, const marfs_ds* ds, char** objectname, ne_e
  *            to NULL, and errno set to EBADFD.
  */
 int datastream_create(DATASTREAM* stream, const char* path, marfs_position* pos, mode_t mode, const char* ctag) {
+   PERF_SPAN( span, PERF_DATASTREAM_CREATE );
    // check for a NULL path arg
    if (path == NULL) {
       LOG(LOG_ERR, "Received a NULL path argument\n");
@@ -2268,6 +2693,11 @@ int datastream_create(DATASTREAM* stream, const char* path, marfs_position* pos,
          errno = EINVAL;
          return -1;
       }
+      if (newstream->pwriters) {
+         LOG(LOG_ERR, "Received stream is the owner of a parallel write session\n");
+         errno = EINVAL;
+         return -1;
+      }
       if ( strcmp( newstream->ns->idstr, pos->ns->idstr ) ) {
          LOG(LOG_INFO, "Received datastream has different NS target: \"%s\"\n",
             newstream->ns->idstr);
@@ -2394,6 +2824,7 @@ int datastream_create(DATASTREAM* stream, const char* path, marfs_position* pos,
  *            to NULL, and errno set to EBADFD.
  */
 int datastream_open(DATASTREAM* stream, STREAM_TYPE type, const char* path, marfs_position* pos, MDAL_FHANDLE* phandle) {
+   PERF_SPAN( span, PERF_DATASTREAM_OPEN );
    // check for invalid args
    if (type != EDIT_STREAM &&
       type != READ_STREAM) {
@@ -3144,6 +3575,7 @@ int datastream_repack_cleanup(const char* refpath, marfs_position* pos) {
  * @return int : Zero on success, or -1 on failure
  */
 int datastream_release(DATASTREAM* stream) {
+   PERF_SPAN( span, PERF_DATASTREAM_RELEASE );
    // check for invalid args
    if (stream == NULL || *stream == NULL) {
       LOG(LOG_ERR, "Received a NULL stream reference\n");
@@ -3162,6 +3594,33 @@ int datastream_release(DATASTREAM* stream) {
    // shorthand references
    const marfs_ms* ms = &(tgtstream->ns->prepo->metascheme);
    STREAMFILE* curfile = tgtstream->files + tgtstream->curfile;
+   // parallel write session writers must have written their entire range
+   if (tgtstream->type == EDIT_STREAM  &&  tgtstream->pwriters) {
+      DATASTREAM_POSITION streampos = {
+         .totaloffset = 0,
+         .dataremaining = 0,
+         .excessremaining = 0,
+         .objno = 0,
+         .offset = 0,
+         .excessoffset = 0,
+         .dataperobj = 0
+      };
+      if (gettargets(tgtstream, 0, SEEK_CUR, &(streampos))) {
+         LOG(LOG_ERR, "Failed to identify position vals of file %zu\n", curfile->ftag.fileno);
+         freestream(tgtstream);
+         *stream = NULL; // unsafe to reuse this stream
+         return -1;
+      }
+      if (streampos.totaloffset != tgtstream->pwriteend) {
+         // abort the current object, rather than leave it with an incomplete range
+         LOG(LOG_ERR, "Session writer is releasing at offset %zu, short of its range end ( %zu )\n",
+            streampos.totaloffset, tgtstream->pwriteend);
+         freestream(tgtstream);
+         *stream = NULL;
+         errno = ENODATA;
+         return -1;
+      }
+   }
    // create/edit streams require extra attention
    if (tgtstream->type == CREATE_STREAM  ||  tgtstream->type == REPACK_STREAM) {
       // make sure we're releasing a file that actually got extended
@@ -3200,6 +3659,10 @@ int datastream_release(DATASTREAM* stream) {
       LOG(LOG_ERR, "Close failure for object %zu\n", tgtstream->objno);
       abortflag = 1;
    }
+   // session writers have no metadata to update
+   else if (curfile->metahandle == NULL) {
+      LOG(LOG_INFO, "Released session writer, covering offsets up to %zu\n", tgtstream->pwriteend);
+   }
    // for create streams, update the ftag to a finalizd state
    else if ((tgtstream->type == CREATE_STREAM  ||  tgtstream->type == REPACK_STREAM) &&
             putftag(tgtstream, curfile)) {
@@ -3232,6 +3695,7 @@ int datastream_release(DATASTREAM* stream) {
  * @return int : Zero on success, or -1 on failure
  */
 int datastream_close(DATASTREAM* stream) {
+   PERF_SPAN( span, PERF_DATASTREAM_CLOSE );
    // check for invalid args
    if (stream == NULL || *stream == NULL) {
       LOG(LOG_ERR, "Received a NULL stream reference\n");
@@ -3252,7 +3716,8 @@ int datastream_close(DATASTREAM* stream) {
    // create/edit streams require extra attention
    if (tgtstream->type == CREATE_STREAM  ||  tgtstream->type == REPACK_STREAM) {
       // make sure we're closing a file that did not get extended
-      if (curfile->ftag.state & FTAG_WRITEABLE) {
+      //  ( unless we are the owner of a parallel write session, completing its file )
+      if ((curfile->ftag.state & FTAG_WRITEABLE) && tgtstream->pwriters == 0) {
          LOG(LOG_ERR, "Cannot close extended file reference\n");
          freestream(tgtstream);
          *stream = NULL;
@@ -3269,6 +3734,14 @@ int datastream_close(DATASTREAM* stream) {
       curfile->ftag.endofstream = 1; // indicate that the stream ends with this file
    }
    else if (tgtstream->type == EDIT_STREAM) {
+      // parallel write session writers cannot complete the file
+      if (tgtstream->pwriters) {
+         LOG(LOG_ERR, "Session writers must be released, rather than closed\n");
+         freestream(tgtstream);
+         *stream = NULL;
+         errno = EINVAL;
+         return -1;
+      }
       // make sure we're closing a writeable and finalized file
       if (!(curfile->ftag.state & FTAG_WRITEABLE) ||
          (curfile->ftag.state & FTAG_DATASTATE) != FTAG_FIN) {
@@ -3348,6 +3821,7 @@ int datastream_close(DATASTREAM* stream) {
  *            to NULL, and errno set to EBADFD.
  */
 ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
+   PERF_SPAN( span, PERF_DATASTREAM_READ );
    // check for invalid args
    if (stream == NULL || *stream == NULL) {
       LOG(LOG_ERR, "Received a NULL stream reference\n");
@@ -3458,9 +3932,203 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
       tgtstream->excessoffset += zerotailbytes;
    }
 
+   span.bytes = readbytes;
    return readbytes;
 }
 
+/**
+ * Read from the given offset of the file currently referenced by the given READ DATASTREAM,
+ * using and updating the object position of the provided cursor
+ * NOTE -- This function never modifies the DATASTREAM itself.  Multiple threads may issue
+ *         parallel calls against the same DATASTREAM, so long as each provides a distinct
+ *         cursor and no other datastream_*() function is called against the stream until
+ *         all such reads have returned.
+ * @param DATASTREAM stream : DATASTREAM to be read from
+ * @param DATASTREAM_CURSOR* cursor : Reference to the cursor to be used for the read
+ *                                    ( a zero-filled cursor is valid, and references no object )
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+ssize_t datastream_pread(DATASTREAM stream, DATASTREAM_CURSOR* cursor, off_t offset, void* buf, size_t count) {
+   // check for invalid args
+   if (stream == NULL  ||  cursor == NULL) {
+      LOG(LOG_ERR, "Received a NULL stream or cursor reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (stream->type != READ_STREAM) {
+      LOG(LOG_ERR, "Provided stream does not support reading\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (count > SSIZE_MAX) {
+      LOG(LOG_ERR, "Provided byte count exceeds max return value: %zu\n", count);
+      errno = EINVAL;
+      return -1;
+   }
+   if (offset < 0) {
+      LOG(LOG_ERR, "Offset value extends prior to beginning of file\n");
+      errno = EINVAL;
+      return -1;
+   }
+   // reads at or beyond EOF are a no-op
+   if ((size_t)offset >= stream->finfo.size) {
+      LOG(LOG_INFO, "Offset %zd is at or beyond EOF ( returning zero bytes )\n", offset);
+      return 0;
+   }
+   // identify target position info ( SEEK_SET targets are independent of stream position )
+   DATASTREAM_POSITION streampos = {
+      .totaloffset = 0,
+      .dataremaining = 0,
+      .excessremaining = 0,
+      .objno = 0,
+      .offset = 0,
+      .excessoffset = 0,
+      .dataperobj = 0
+   };
+   if (gettargets(stream, offset, SEEK_SET, &(streampos))) {
+      LOG(LOG_ERR, "Failed to identify position vals of file %zu\n", stream->files[stream->curfile].ftag.fileno);
+      return -1;
+   }
+
+   // reduce read request to account for file limits
+   size_t zerotailbytes = 0;
+   if (count > streampos.dataremaining + streampos.excessremaining) {
+      count = streampos.dataremaining + streampos.excessremaining;
+      LOG(LOG_INFO, "Read request exceeds file bounds, resizing to %zu bytes\n", count);
+   }
+   if (count > streampos.dataremaining) {
+      zerotailbytes = count - streampos.dataremaining;
+      count = streampos.dataremaining;
+      LOG(LOG_INFO, "Read request exceeds data content, appending %zu tailing zero bytes\n",
+         zerotailbytes);
+   }
+
+   // shift the cursor to the target position, only reopening or reseeking as necessary
+   if (cursor->datahandle != NULL  &&  count) {
+      if (cursor->objno != streampos.objno) {
+         if (datastream_releasecursor(stream, cursor)) {
+            LOG(LOG_ERR, "Failed to close previous cursor data object\n");
+            return -1;
+         }
+      }
+      else if (cursor->offset != streampos.offset) {
+         LOG(LOG_INFO, "Seeking cursor from offset %zu to %zu of object %zu\n",
+            cursor->offset, streampos.offset, streampos.objno);
+         if (ne_seek(cursor->datahandle, streampos.offset) != streampos.offset) {
+            LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n",
+               streampos.offset, streampos.objno);
+            ne_abort(cursor->datahandle);
+            cursor->datahandle = NULL;
+            return -1;
+         }
+      }
+   }
+   if (count) {
+      cursor->objno = streampos.objno;
+      cursor->offset = streampos.offset;
+   }
+
+   // retrieve data until we no longer can
+   size_t readbytes = 0;
+   while (count) {
+      // calculate how much data we can read from the current data object
+      size_t toread = streampos.dataperobj - (cursor->offset - stream->recoveryheaderlen);
+      if (toread == 0) {
+         // close the previous data handle
+         if (datastream_releasecursor(stream, cursor)) {
+            LOG(LOG_ERR, "Failed to close previous cursor data object\n");
+            return (readbytes) ? readbytes : -1;
+         }
+         // progress to the next data object
+         cursor->objno++;
+         cursor->offset = stream->recoveryheaderlen;
+         toread = streampos.dataperobj;
+         LOG(LOG_INFO, "Progressing cursor read into object %zu ( offset = %zu )\n",
+            cursor->objno, cursor->offset);
+      }
+      // limit our data read to the actual request size
+      if (toread > count) {
+         toread = count;
+      }
+      // open the current data object, if necessary
+      if (cursor->datahandle == NULL) {
+         LOG(LOG_INFO, "Opening object %zu for cursor\n", cursor->objno);
+         cursor->datahandle = open_read_obj(stream, cursor->objno, cursor->offset);
+         if (cursor->datahandle == NULL) {
+            LOG(LOG_ERR, "Failed to open data object %zu\n", cursor->objno);
+            return (readbytes) ? readbytes : -1;
+         }
+      }
+      // perform the actual read op
+      LOG(LOG_INFO, "Reading %zu bytes from object %zu\n", toread, cursor->objno);
+      ssize_t readres = ne_read(cursor->datahandle, buf, toread);
+      if (readres <= 0) {
+         LOG(LOG_ERR, "Read failure in object %zu at offset %zu ( res = %zd )\n",
+            cursor->objno, cursor->offset, readres);
+         return (readbytes) ? readbytes : -1;
+      }
+      LOG(LOG_INFO, "Read op returned %zd bytes\n", readres);
+      // adjust all offsets and byte counts
+      buf += readres;
+      count -= readres;
+      readbytes += readres;
+      cursor->offset += readres;
+   }
+
+   // append zero bytes to account for file truncated beyond data length
+   if (zerotailbytes) {
+      bzero(buf, zerotailbytes);
+      readbytes += zerotailbytes;
+   }
+   cursor->fileoffset = offset + readbytes;
+
+   return readbytes;
+}
+
+/**
+ * Release any object reference held by the given cursor of a READ DATASTREAM
+ * NOTE -- Every cursor used with datastream_pread() must be released prior to closing,
+ *         releasing, or otherwise retargeting the associated DATASTREAM
+ * @param DATASTREAM stream : DATASTREAM with which the cursor was used
+ * @param DATASTREAM_CURSOR* cursor : Reference to the cursor to be released
+ * @return int : Zero on success, or -1 on failure
+ */
+int datastream_releasecursor(DATASTREAM stream, DATASTREAM_CURSOR* cursor) {
+   // check for invalid args
+   if (cursor == NULL) {
+      LOG(LOG_ERR, "Received a NULL cursor reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (cursor->datahandle == NULL) {
+      return 0; // nothing to be done
+   }
+   if (stream == NULL) {
+      // with no stream left to close against, the object handle can only be aborted
+      ne_handle handle = cursor->datahandle;
+      cursor->datahandle = NULL;
+      if (ne_abort(handle)) {
+         LOG(LOG_ERR, "Failed to abort cursor reference to object %zu\n", cursor->objno);
+         return -1;
+      }
+      return 0;
+   }
+   // close the cursor object, just as we would the stream's own
+   FTAG curftag = stream->files[stream->curfile].ftag;
+   curftag.objno = cursor->objno;
+   curftag.offset = cursor->offset;
+   ne_handle handle = cursor->datahandle;
+   cursor->datahandle = NULL; // never reattempt this process
+   if (close_obj(stream, handle, &(curftag), NULL)) {
+      LOG(LOG_ERR, "Failed to close cursor reference to object %zu\n", cursor->objno);
+      return -1;
+   }
+   return 0;
+}
+
 /**
  * Write to the file currently referenced by the given EDIT or CREATE DATASTREAM
  * @param DATASTREAM* stream : Reference to the DATASTREAM to be written to
@@ -3474,6 +4142,7 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
  *            to NULL, and errno set to EBADFD.
  */
 ssize_t datastream_write(DATASTREAM* stream, const void* buf, size_t count) {
+   PERF_SPAN( span, PERF_DATASTREAM_WRITE );
    // check for invalid args
    if (stream == NULL || *stream == NULL) {
       LOG(LOG_ERR, "Received a NULL stream reference\n");
@@ -3532,6 +4201,12 @@ ssize_t datastream_write(DATASTREAM* stream, const void* buf, size_t count) {
       count = streampos.dataremaining;
       LOG(LOG_INFO, "Write request exceeds file bounds, resizing to %zu bytes\n", count);
    }
+   // session writers are further limited to their assigned range
+   if (tgtstream->type == EDIT_STREAM && tgtstream->pwriters &&
+       streampos.totaloffset + count > tgtstream->pwriteend) {
+      count = (tgtstream->pwriteend > streampos.totaloffset) ? tgtstream->pwriteend - streampos.totaloffset : 0;
+      LOG(LOG_INFO, "Write request exceeds session range, resizing to %zu bytes\n", count);
+   }
 
    // write all provided data until we no longer can
    size_t writtenbytes = 0;
@@ -3547,43 +4222,19 @@ ssize_t datastream_write(DATASTREAM* stream, const void* buf, size_t count) {
             errno = EBADFD;
             return -1;
          }
-         // close the previous data handle
+         // hand off the previous data handle to be closed in the background
+         //    ( all previous files are completed once that close succeeds )
          FTAG curftag = curfile->ftag;
          curftag.objno = tgtstream->objno;
          curftag.offset = tgtstream->offset;
-         if (close_current_obj(tgtstream, &(curftag), NULL)) {
+         if (close_current_obj_async(tgtstream, &(curftag))) {
             LOG(LOG_ERR, "Failed to close previous data object\n");
             freestream(tgtstream);
             *stream = NULL; // unsafe to continue with previous handle
             errno = EBADFD;
             return -1;
          }
-         // we (may) need to mark all previous files as complete
-         if (tgtstream->type == CREATE_STREAM  ||  tgtstream->type == REPACK_STREAM) {
-            size_t curfilepos = tgtstream->curfile;
-            char abortflag = 0;
-            while (tgtstream->curfile) {
-               tgtstream->curfile--;
-               if (completefile(tgtstream, tgtstream->files + tgtstream->curfile)) {
-                  LOG(LOG_ERR, "Failed to complete file %zu\n",
-                     (tgtstream->files + tgtstream->curfile)->ftag.fileno);
-                  abortflag = 1;
-               }
-            }
-            // check for any errors
-            if (abortflag) {
-               LOG(LOG_INFO, "Terminating datastream due to previous errors\n");
-               freestream(tgtstream);
-               *stream = NULL; // unsafe to reuse this stream
-               errno = EBADFD;
-               return -1;
-            }
-            if (curfilepos != tgtstream->curfile) {
-               // shift the new file reference to the front of the list
-               tgtstream->files[0] = tgtstream->files[curfilepos];
-               curfile = tgtstream->files;
-            }
-         }
+         curfile = tgtstream->files + tgtstream->curfile;
 
          // progress to the next data object
          tgtstream->objno++;
@@ -3626,6 +4277,7 @@ ssize_t datastream_write(DATASTREAM* stream, const void* buf, size_t count) {
       tgtstream->finfo.eof = 1;
    }
 
+   span.bytes = writtenbytes;
    return writtenbytes;
 }
 
@@ -3692,6 +4344,14 @@ int datastream_setrecoverypath(DATASTREAM* stream, const char* recovpath) {
          return -1;
       }
    }
+   else if (tgtstream->pwriters) {
+      // session writers have already been handed the current recovery length
+      LOG(LOG_ERR, "Cannot alter the recovery path of a parallel write session file\n");
+      free(tgtstream->finfo.path);
+      tgtstream->finfo.path = oldpath;
+      errno = EINVAL;
+      return -1;
+   }
    else { // implies type == CREATE
       // for create streams, we actually need to update our FTAG
       size_t oldrecovbytes = curfile->ftag.recoverybytes;
@@ -3934,6 +4594,11 @@ int datastream_extend(DATASTREAM* stream, off_t length) {
       errno = EINVAL;
       return -1;
    }
+   if (tgtstream->pwriters) {
+      LOG(LOG_ERR, "Cannot extend the file of a parallel write session\n");
+      errno = EINVAL;
+      return -1;
+   }
    if (curfile->ftag.bytes != 0 && tgtstream->datahandle != NULL) {
       LOG(LOG_ERR, "Cannot extend a file which has already been written to\n");
       errno = EINVAL;
@@ -4038,6 +4703,278 @@ int datastream_extend(DATASTREAM* stream, off_t length) {
    return 0;
 }
 
+/**
+ * Begin a parallel write session of the file referenced by the given CREATE DATASTREAM,
+ * extending that file to the specified total size and producing a session string which
+ * allows any number of writers to each open their own range of the file, without any
+ * metadata access.
+ * NOTE -- The given DATASTREAM becomes the owner of the session.  It should be passed to
+ *         datastream_close() once all session writers have been released, which completes
+ *         the file with a single metadata update.  Releasing the owner instead leaves the
+ *         file in the same state as a released datastream_extend() stream.
+ *         This function can only be performed if no data has been written to the target
+ *         file via this DATASTREAM.
+ * @param DATASTREAM* stream : Reference to the DATASTREAM to be extended
+ * @param off_t length : Target total file length to extend to
+ * @param int writers : Number of writers which will participate in the session
+ * @param char** session : Reference to be populated with the session string
+ *                         ( caller is responsible for freeing this string )
+ * @return int : Zero on success, or -1 on failure
+ *    NOTE -- In most failure conditions, any previous DATASTREAM reference will be
+ *            preserved ( continue to reference whatever file they previously referenced ).
+ *            However, it is possible for certain catastrophic error conditions to occur.
+ *            In such a case, the DATASTREAM will be destroyed, the 'stream' reference set
+ *            to NULL, and errno set to EBADFD.
+ */
+int datastream_pwrite_begin(DATASTREAM* stream, off_t length, int writers, char** session) {
+   // check for invalid args
+   if (stream == NULL || *stream == NULL) {
+      LOG(LOG_ERR, "Received a NULL stream reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (writers < 1) {
+      LOG(LOG_ERR, "Received an invalid writer count: %d\n", writers);
+      errno = EINVAL;
+      return -1;
+   }
+   if (session == NULL) {
+      LOG(LOG_ERR, "Received a NULL session reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   // extend the file, making it sized and writable by other procs
+   //  ( this also verifies the stream type and file state )
+   DATASTREAM tgtstream = *stream;
+   if (datastream_extend(stream, length)) {
+      LOG(LOG_ERR, "Failed to extend the target file to %zd bytes\n", length);
+      return -1;
+   }
+   STREAMFILE* curfile = tgtstream->files + tgtstream->curfile;
+   // session writers are handed the FTAG value of the file, as it will be once all data
+   //  has been written ( allowing access to all data objects, including the final one )
+   FTAG sessionftag = curfile->ftag;
+   sessionftag.state = (sessionftag.state & ~(FTAG_DATASTATE)) | FTAG_FIN;
+   sessionftag.availbytes = sessionftag.bytes;
+   sessionftag.endofstream = 1;
+   // calculate the length of each session string component
+   size_t ftaglen = ftag_tostr(&(sessionftag), NULL, 0);
+   size_t finfolen = recovery_finfotostr(&(tgtstream->finfo), NULL, 0);
+   int headlen = snprintf(NULL, 0, "%s%d|%zu)", PWRITE_SESSION_HEAD, writers, ftaglen);
+   if (ftaglen == 0 || finfolen == 0 || headlen < 1) {
+      LOG(LOG_ERR, "Failed to calculate the length of the session string\n");
+      return -1;
+   }
+   // populate the session string
+   char* sessionstr = malloc(sizeof(char) * (headlen + ftaglen + finfolen + 1));
+   if (sessionstr == NULL) {
+      LOG(LOG_ERR, "Failed to allocate space for the session string\n");
+      return -1;
+   }
+   char* output = sessionstr;
+   snprintf(output, headlen + 1, "%s%d|%zu)", PWRITE_SESSION_HEAD, writers, ftaglen);
+   output += headlen;
+   if (ftag_tostr(&(sessionftag), output, ftaglen + 1) != ftaglen) {
+      LOG(LOG_ERR, "Session FTAG string has an inconsistent length\n");
+      free(sessionstr);
+      errno = EFAULT;
+      return -1;
+   }
+   output += ftaglen;
+   if (recovery_finfotostr(&(tgtstream->finfo), output, finfolen + 1) != finfolen) {
+      LOG(LOG_ERR, "Session FINFO string has an inconsistent length\n");
+      free(sessionstr);
+      errno = EFAULT;
+      return -1;
+   }
+   // this stream now owns the session
+   tgtstream->pwriters = writers;
+   *session = sessionstr;
+   LOG(LOG_INFO, "Began parallel write session of %d writers for file %zu\n", writers, curfile->ftag.fileno);
+   return 0;
+}
+
+/**
+ * Open a new EDIT DATASTREAM for the given writer of a parallel write session
+ * Each writer is assigned a contiguous range of whole data objects of the file, and the
+ * new stream is positioned at the start of that range.  Writes are limited to the range,
+ * and the stream must be released via datastream_release() once the entire range has
+ * been written ( the release will fail if any of the range remains unwritten ).
+ * NOTE -- Unlike datastream_open(), this function performs no metadata access at all.
+ * @param DATASTREAM* stream : Reference to be populated with the new DATASTREAM
+ *                             ( must reference a NULL value )
+ * @param const char* session : Session string, produced by datastream_pwrite_begin()
+ * @param marfs_position* pos : Reference to the marfs_position value of the target file
+ * @param int rank : Index of this writer within the session ( beginning at zero )
+ * @param off_t* offset : Reference to be populated with the file offset of the range
+ * @param size_t* size : Reference to be populated with the size of the range
+ *                       ( may be zero, if the session has more writers than objects )
+ * @return int : Zero on success, or -1 on failure
+ */
+int datastream_pwrite_open(DATASTREAM* stream, const char* session, marfs_position* pos, int rank, off_t* offset, size_t* size) {
+   // check for invalid args
+   if (stream == NULL || *stream != NULL) {
+      LOG(LOG_ERR, "Received a NULL or non-empty stream reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (session == NULL || pos == NULL) {
+      LOG(LOG_ERR, "Received a NULL session and/or position argument\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (offset == NULL || size == NULL) {
+      LOG(LOG_ERR, "Received NULL offset and/or size references\n");
+      errno = EINVAL;
+      return -1;
+   }
+   // parse the session header
+   size_t headlen = strlen(PWRITE_SESSION_HEAD);
+   if (strncmp(session, PWRITE_SESSION_HEAD, headlen)) {
+      LOG(LOG_ERR, "Received an invalid session string: \"%s\"\n", session);
+      errno = EINVAL;
+      return -1;
+   }
+   const char* parse = session + headlen;
+   char* endptr = NULL;
+   unsigned long long parseval = strtoull(parse, &(endptr), 10);
+   if (endptr == parse || *endptr != '|' || parseval == 0 || parseval > INT_MAX) {
+      LOG(LOG_ERR, "Failed to parse the writer count of session string: \"%s\"\n", session);
+      errno = EINVAL;
+      return -1;
+   }
+   int writers = (int)parseval;
+   parse = endptr + 1;
+   parseval = strtoull(parse, &(endptr), 10);
+   if (endptr == parse || *endptr != ')' || strnlen(endptr + 1, parseval + 1) <= parseval) {
+      LOG(LOG_ERR, "Failed to parse the FTAG length of session string: \"%s\"\n", session);
+      errno = EINVAL;
+      return -1;
+   }
+   size_t ftaglen = (size_t)parseval;
+   parse = endptr + 1;
+   if (rank < 0 || rank >= writers) {
+      LOG(LOG_ERR, "Writer rank %d is outside of the session writer count ( %d )\n", rank, writers);
+      errno = EINVAL;
+      return -1;
+   }
+   // allocate a new edit stream, with no file metadata reference
+   DATASTREAM newstream = allocstream(EDIT_STREAM, pos);
+   if (newstream == NULL) {
+      LOG(LOG_ERR, "Failed to allocate a new session writer stream\n");
+      return -1;
+   }
+   newstream->pwriters = writers;
+   STREAMFILE* curfile = newstream->files;
+   // parse the session FTAG
+   if (ftaglen >= newstream->ftagstrsize) {
+      free(newstream->ftagstr);
+      newstream->ftagstrsize = 0;
+      newstream->ftagstr = malloc(sizeof(char) * (ftaglen + 1));
+      if (newstream->ftagstr == NULL) {
+         LOG(LOG_ERR, "Failed to allocate space for ftag string\n");
+         freestream(newstream);
+         return -1;
+      }
+      newstream->ftagstrsize = ftaglen + 1;
+   }
+   memcpy(newstream->ftagstr, parse, ftaglen);
+   *(newstream->ftagstr + ftaglen) = '\0';
+   if (ftag_initstr(&(curfile->ftag), newstream->ftagstr)) {
+      LOG(LOG_ERR, "Failed to parse the FTAG value of the session string\n");
+      freestream(newstream);
+      errno = EINVAL;
+      return -1;
+   }
+   // the stream inherits string values from the FTAG
+   newstream->ctag = curfile->ftag.ctag;
+   newstream->streamid = curfile->ftag.streamid;
+   if ((curfile->ftag.state & FTAG_WRITEABLE) == 0 ||
+       (curfile->ftag.state & FTAG_DATASTATE) != FTAG_FIN) {
+      LOG(LOG_ERR, "Session FTAG value does not describe a sized, writable file\n");
+      freestream(newstream);
+      errno = EINVAL;
+      return -1;
+   }
+   // parse the session FINFO
+   char* finfostr = strdup(parse + ftaglen);
+   if (finfostr == NULL) {
+      LOG(LOG_ERR, "Failed to duplicate the FINFO value of the session string\n");
+      freestream(newstream);
+      return -1;
+   }
+   if (recovery_finfofromstr(&(newstream->finfo), finfostr, strlen(finfostr))) {
+      LOG(LOG_ERR, "Failed to parse the FINFO value of the session string\n");
+      free(finfostr);
+      freestream(newstream);
+      errno = EINVAL;
+      return -1;
+   }
+   free(finfostr);
+   // calculate the recovery header length
+   RECOVERY_HEADER header =
+   {
+      .majorversion = RECOVERY_CURRENT_MAJORVERSION,
+      .minorversion = RECOVERY_CURRENT_MINORVERSION,
+      .ctag = newstream->ctag,
+      .streamid = newstream->streamid
+   };
+   newstream->recoveryheaderlen = recovery_headertostr(&(header), NULL, 0);
+   if (newstream->recoveryheaderlen < 1) {
+      LOG(LOG_ERR, "Failed to identify length of stream recov header\n");
+      freestream(newstream);
+      return -1;
+   }
+   // the stream also inherits position values from the FTAG
+   newstream->fileno = curfile->ftag.fileno;
+   newstream->objno = curfile->ftag.objno;
+   newstream->offset = curfile->ftag.offset;
+   // identify the data chunks of the file
+   DATASTREAM_POSITION streampos = {
+      .totaloffset = 0,
+      .dataremaining = 0,
+      .excessremaining = 0,
+      .objno = 0,
+      .offset = 0,
+      .excessoffset = 0,
+      .dataperobj = 0
+   };
+   if (gettargets(newstream, 0, SEEK_SET, &(streampos))) {
+      LOG(LOG_ERR, "Failed to identify position vals of file %zu\n", curfile->ftag.fileno);
+      freestream(newstream);
+      return -1;
+   }
+   size_t filesize = streampos.dataremaining;
+   size_t firstchunk = streampos.dataperobj - (streampos.offset - newstream->recoveryheaderlen);
+   size_t chunkcount = 1;
+   if (filesize > firstchunk) {
+      chunkcount += ((filesize - firstchunk) + (streampos.dataperobj - 1)) / streampos.dataperobj;
+   }
+   // assign this writer an even share of those chunks
+   size_t startchunk = (chunkcount * rank) / writers;
+   size_t endchunk = (chunkcount * (rank + 1)) / writers;
+   size_t startoff = (startchunk) ? firstchunk + ((startchunk - 1) * streampos.dataperobj) : 0;
+   size_t endoff = (endchunk) ? firstchunk + ((endchunk - 1) * streampos.dataperobj) : 0;
+   if (startoff > filesize) { startoff = filesize; }
+   if (endoff > filesize || endchunk == chunkcount) { endoff = filesize; }
+   // position the stream at the start of the range
+   if (gettargets(newstream, startoff, SEEK_SET, &(streampos))) {
+      LOG(LOG_ERR, "Failed to identify position vals of offset %zu\n", startoff);
+      freestream(newstream);
+      return -1;
+   }
+   newstream->objno = streampos.objno;
+   newstream->offset = streampos.offset;
+   newstream->excessoffset = streampos.excessoffset;
+   newstream->pwriteend = endoff;
+   LOG(LOG_INFO, "Session writer %d of %d assigned chunks %zu to %zu ( offsets %zu to %zu )\n",
+      rank, writers, startchunk, endchunk, startoff, endoff);
+   *offset = (off_t)startoff;
+   *size = endoff - startoff;
+   *stream = newstream;
+   return 0;
+}
+
 /**
  * Truncate the file referenced by the given EDIT DATASTREAM to the specified length
  * NOTE -- This operation can only be performed on completed data files
@@ -4119,6 +5056,11 @@ int datastream_utimens(DATASTREAM* stream, const struct timespec times[2]) {
    }
    // verify that the current file is in an appropriate state
    STREAMFILE* curfile = tgtstream->files + tgtstream->curfile;
+   if (curfile->metahandle == NULL) {
+      LOG(LOG_ERR, "Cannot set times via a parallel write session writer\n");
+      errno = EINVAL;
+      return -1;
+   }
    if ((curfile->ftag.state & FTAG_DATASTATE) != FTAG_COMP &&
       tgtstream->type != CREATE_STREAM &&
       (curfile->ftag.state & FTAG_WRITEABLE) == 0) {
@@ -13,6 +13,23 @@
 #include "recovery.h"
 #include "tagging.h"
 
+#include <pthread.h>
+
+// maximum number of data objects a single stream may be finalizing in the background
+#ifndef DATASTREAM_MAX_CLOSING
+#define DATASTREAM_MAX_CLOSING 2
+#endif
+
+// maximum number of threads, shared by all streams, which finalize data objects in the background
+#ifndef DATASTREAM_CLOSE_THREADS
+#define DATASTREAM_CLOSE_THREADS 4
+#endif
+
+// if non-zero, written data objects terminate with a RECOVERY_INDEX of their content
+#ifndef DATASTREAM_RECOVERY_INDEX
+#define DATASTREAM_RECOVERY_INDEX 1
+#endif
+
 typedef enum {
    CREATE_STREAM,
    EDIT_STREAM,
@@ -27,6 +44,18 @@ typedef struct streamfile_struct {
    char            dotimes;
 } STREAMFILE;
 
+typedef struct datastream_closer_struct {
+   char        pending;   // non-zero while the close is queued or in progress
+   struct datastream_closer_struct* next; // next closer awaiting a background thread
+   struct datastream_struct* stream;
+   ne_handle   handle;    // handle of the data object being closed
+   FTAG        ftag;      // FTAG value associated with the closing object
+   STREAMFILE* files;     // files ending within the closing object ( completed once it is synced )
+   size_t      filecount;
+   int         result;    // result of the background close_obj() call
+   int         error;     // errno value associated with a close_obj() failure
+} DATASTREAM_CLOSER;
+
 typedef struct datastream_struct {
    // Stream Info
    STREAM_TYPE type;
@@ -40,6 +69,18 @@ typedef struct datastream_struct {
    size_t      offset;
    size_t      excessoffset;
    ne_handle   datahandle;
+   // Object Index Info
+   RECOVERY_INDEX* objindex;    // FINFO / data regions written to the current object
+   size_t      objindexcount;
+   size_t      objindexalloc;
+   // Object Finalization Info
+   DATASTREAM_CLOSER closers[DATASTREAM_MAX_CLOSING]; // ring of objects closing in the background
+   size_t      closerhead;  // index of the oldest closing object
+   size_t      closercount; // number of objects currently closing
+   // Parallel Write Session Info
+   int         pwriters;    // writer count of the parallel write session this stream is part of
+                            //  ( zero, if none; see datastream_pwrite_begin() )
+   size_t      pwriteend;   // end of the file range assigned to a session writer
    // Per-File Info
    STREAMFILE* files;
    size_t      curfile;
@@ -52,6 +93,14 @@ typedef struct datastream_struct {
    size_t      finfostrlen;
 }*DATASTREAM;
 
+typedef struct datastream_cursor_struct {
+   // Cursor Position Info
+   size_t      objno;       // currently referenced data object number
+   size_t      offset;      // current offset within the referenced data object
+   size_t      fileoffset;  // file offset corresponding to the above position
+   ne_handle   datahandle;  // NULL if no object is currently open
+} DATASTREAM_CURSOR;
+
 /**
  * Calculates the final data object number referenced by the given FTAG of a MarFS file
  * @param const FTAG* ftag : FTAG value associated with the target file
@@ -88,7 +137,8 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
 /**
  * Generate data object target info based on the given FTAG and datascheme references
  * @param FTAG* ftag : Reference to the FTAG value to generate target info for
- * @param const marfs_ds* ds : Reference to the current MarFS data scheme
+ * @param marfs_ds* ds : Reference to the current MarFS data scheme
+ *                      ( materialized on first use, see config_fortifydatascheme() )
  * @param char** objectname : Reference to a char* to be populated with the object name
  * @param ne_erasure* erasure : Reference to an ne_erasure struct to be populated with
  *                              object erasure info
@@ -96,7 +146,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable, MDAL mdal, MDAL_CTXT
  *                                object location info
  * @return int : Zero on success, or -1 on failure
  */
-int datastream_objtarget(FTAG* ftag, const marfs_ds* ds, char** objname, ne_erasure* erasure, ne_location* location);
+int datastream_objtarget(FTAG* ftag, marfs_ds* ds, char** objname, ne_erasure* erasure, ne_location* location);
 
 /**
  * Create a new file associated with a CREATE stream
@@ -216,6 +266,35 @@ int datastream_close(DATASTREAM* stream);
  */
 ssize_t datastream_read(DATASTREAM* stream, void* buffer, size_t count);
 
+/**
+ * Read from the given offset of the file currently referenced by the given READ DATASTREAM,
+ * using and updating the object position of the provided cursor
+ * NOTE -- This function never modifies the DATASTREAM itself.  Multiple threads may issue
+ *         parallel calls against the same DATASTREAM, so long as each provides a distinct
+ *         cursor and no other datastream_*() function is called against the stream until
+ *         all such reads have returned.
+ * @param DATASTREAM stream : DATASTREAM to be read from
+ * @param DATASTREAM_CURSOR* cursor : Reference to the cursor to be used for the read
+ *                                    ( a zero-filled cursor is valid, and references no object )
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+ssize_t datastream_pread(DATASTREAM stream, DATASTREAM_CURSOR* cursor, off_t offset, void* buf, size_t count);
+
+/**
+ * Release any object reference held by the given cursor of a READ DATASTREAM
+ * NOTE -- Every cursor used with datastream_pread() must be released prior to closing,
+ *         releasing, or otherwise retargeting the associated DATASTREAM
+ * @param DATASTREAM stream : DATASTREAM with which the cursor was used
+ *                            ( if NULL, e.g. following a stream failure, any object
+ *                            reference of the cursor is simply aborted )
+ * @param DATASTREAM_CURSOR* cursor : Reference to the cursor to be released
+ * @return int : Zero on success, or -1 on failure
+ */
+int datastream_releasecursor(DATASTREAM stream, DATASTREAM_CURSOR* cursor);
+
 /**
  * Write to the file currently referenced by the given EDIT or CREATE DATASTREAM
  * @param DATASTREAM* stream : Reference to the DATASTREAM to be written to
@@ -284,6 +363,50 @@ int datastream_chunkbounds(DATASTREAM* stream, int chunknum, off_t* offset, size
  */
 int datastream_extend(DATASTREAM* stream, off_t length);
 
+/**
+ * Begin a parallel write session of the file referenced by the given CREATE DATASTREAM,
+ * extending that file to the specified total size and producing a session string which
+ * allows any number of writers to each open their own range of the file, without any
+ * metadata access.
+ * NOTE -- The given DATASTREAM becomes the owner of the session.  It should be passed to
+ *         datastream_close() once all session writers have been released, which completes
+ *         the file with a single metadata update.  Releasing the owner instead leaves the
+ *         file in the same state as a released datastream_extend() stream.
+ *         This function can only be performed if no data has been written to the target
+ *         file via this DATASTREAM.
+ * @param DATASTREAM* stream : Reference to the DATASTREAM to be extended
+ * @param off_t length : Target total file length to extend to
+ * @param int writers : Number of writers which will participate in the session
+ * @param char** session : Reference to be populated with the session string
+ *                         ( caller is responsible for freeing this string )
+ * @return int : Zero on success, or -1 on failure
+ *    NOTE -- In most failure conditions, any previous DATASTREAM reference will be
+ *            preserved ( continue to reference whatever file they previously referenced ).
+ *            However, it is possible for certain catastrophic error conditions to occur.
+ *            In such a case, the DATASTREAM will be destroyed, the 'stream' reference set
+ *            to NULL, and errno set to EBADFD.
+ */
+int datastream_pwrite_begin(DATASTREAM* stream, off_t length, int writers, char** session);
+
+/**
+ * Open a new EDIT DATASTREAM for the given writer of a parallel write session
+ * Each writer is assigned a contiguous range of whole data objects of the file, and the
+ * new stream is positioned at the start of that range.  Writes are limited to the range,
+ * and the stream must be released via datastream_release() once the entire range has
+ * been written ( the release will fail if any of the range remains unwritten ).
+ * NOTE -- Unlike datastream_open(), this function performs no metadata access at all.
+ * @param DATASTREAM* stream : Reference to be populated with the new DATASTREAM
+ *                             ( must reference a NULL value )
+ * @param const char* session : Session string, produced by datastream_pwrite_begin()
+ * @param marfs_position* pos : Reference to the marfs_position value of the target file
+ * @param int rank : Index of this writer within the session ( beginning at zero )
+ * @param off_t* offset : Reference to be populated with the file offset of the range
+ * @param size_t* size : Reference to be populated with the size of the range
+ *                       ( may be zero, if the session has more writers than objects )
+ * @return int : Zero on success, or -1 on failure
+ */
+int datastream_pwrite_open(DATASTREAM* stream, const char* session, marfs_position* pos, int rank, off_t* offset, size_t* size);
+
 /**
  * Truncate the file referenced by the given EDIT DATASTREAM to the specified length
  * NOTE -- This operation can only be performed on completed data files
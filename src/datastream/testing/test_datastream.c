@@ -734,6 +734,22 @@ int main(int argc, char **argv)
       printf( "Failed to close handle for data object(%s)\n", strerror(errno) );
       return -1;
    }
+   // the packed object should terminate with an index of its content
+   size_t rindextail = recovery_indextaillen();
+   size_t rindexlen = ( datasize > rindextail ) ?
+                      recovery_indexlength( databuf + ( datasize - rindextail ), rindextail ) : 0;
+   RECOVERY_INDEX* rindex = NULL;
+   size_t rindexcount = 0;
+   if ( rindexlen == 0  ||  rindexlen > datasize  ||
+        recovery_indexfromstr( &(rindex), &(rindexcount), databuf + ( datasize - rindexlen ), rindexlen ) ) {
+      printf( "Failed to locate recovery index of data object: \"%s\"\n", objname );
+      return -1;
+   }
+   if ( rindexcount != 3 ) {
+      printf( "Unexpected recovery index entry count for data object: %zu\n", rindexcount );
+      return -1;
+   }
+   free( rindex );
    RECOVERY_HEADER rheader = {
       .majorversion = 0,
       .minorversion = 0,
@@ -1210,6 +1226,276 @@ int main(int argc, char **argv)
    free( objname3 );
 
 
+   // parallel write session, spanning three data objects
+   if ( datastream_create( &(stream), "file3", &(pos), 0666, NULL ) ) {
+      printf( "create failure for 'file3' of pwrite session\n" );
+      return -1;
+   }
+   rpath = datastream_genrpath( &(stream->files->ftag), stream->ns->prepo->metascheme.reftable, NULL, NULL );
+   if ( rpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify the rpath of pwrite session 'file3' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   char* session = NULL;
+   if ( datastream_pwrite_begin( &(stream), 10 * 1024, 2, &(session) ) ) {
+      printf( "failed to begin pwrite session for 'file3'\n" );
+      return -1;
+   }
+   // the owner cannot progress to another file while the session is active
+   if ( datastream_create( &(stream), "file4", &(pos), 0666, NULL ) == 0  ||  errno != EINVAL ) {
+      printf( "unexpected success of create from the owner of pwrite session\n" );
+      return -1;
+   }
+   // writers must fall within the session writer count
+   DATASTREAM wstream[3] = { NULL, NULL, NULL };
+   off_t  woffset[3] = { 0, 0, 0 };
+   size_t wsize[3] = { 0, 0, 0 };
+   if ( datastream_pwrite_open( wstream + 2, session, &(pos), 2, woffset + 2, wsize + 2 ) == 0 ) {
+      printf( "unexpected success of pwrite session open for writer 2 of 2\n" );
+      return -1;
+   }
+   int writer = 0;
+   for ( ; writer < 2; writer++ ) {
+      if ( datastream_pwrite_open( wstream + writer, session, &(pos), writer, woffset + writer, wsize + writer ) ) {
+         printf( "failed to open pwrite session writer %d\n", writer );
+         return -1;
+      }
+   }
+   // three chunks, split between the writers
+   size_t dataperobj = 4096 - (wstream[0]->recoveryheaderlen + wstream[0]->files->ftag.recoverybytes);
+   if ( woffset[0]  ||  wsize[0] != dataperobj  ||
+        woffset[1] != dataperobj  ||  wsize[1] != (10 * 1024) - dataperobj ) {
+      printf( "unexpected pwrite session ranges: ( o=%zd, s=%zu ), ( o=%zd, s=%zu )\n",
+              woffset[0], wsize[0], woffset[1], wsize[1] );
+      return -1;
+   }
+   // keep track of all three data objects
+   tgttag = wstream[0]->files->ftag;
+   if ( datastream_objtarget( &(tgttag), &(stream->ns->prepo->datascheme), &(objname), &(objerasure), &(objlocation) ) ) {
+      LOG( LOG_ERR, "Failed to identify data object of pwrite session 'file3' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   tgttag.objno++;
+   if ( datastream_objtarget( &(tgttag), &(stream->ns->prepo->datascheme), &(objname2), &(objerasure2), &(objlocation2) ) ) {
+      LOG( LOG_ERR, "Failed to identify data object of pwrite session 'file3' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   tgttag.objno++;
+   if ( datastream_objtarget( &(tgttag), &(stream->ns->prepo->datascheme), &(objname3), &(objerasure3), &(objlocation3) ) ) {
+      LOG( LOG_ERR, "Failed to identify data object of pwrite session 'file3' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   // writers cannot complete the file, nor be released short of their range end
+   if ( datastream_pwrite_open( wstream + 2, session, &(pos), 1, woffset + 2, wsize + 2 ) ) {
+      printf( "failed to open duplicate pwrite session writer 1\n" );
+      return -1;
+   }
+   if ( datastream_close( wstream + 2 ) == 0  ||  wstream[2] != NULL ) {
+      printf( "unexpected close success of pwrite session writer\n" );
+      return -1;
+   }
+   if ( datastream_pwrite_open( wstream + 2, session, &(pos), 1, woffset + 2, wsize + 2 ) ) {
+      printf( "failed to open duplicate pwrite session writer 1\n" );
+      return -1;
+   }
+   if ( datastream_release( wstream + 2 ) == 0  ||  errno != ENODATA ) {
+      printf( "unexpected release success of pwrite session writer with an unwritten range\n" );
+      return -1;
+   }
+   free( session );
+   // write out each range, in reverse order, with excess data truncated at the range end
+   size_t byteindex = 0;
+   for ( ; byteindex < 10 * 1024; byteindex++ ) { *((char*)databuf + byteindex) = (char)( byteindex % 251 ); }
+   for ( writer = 1; writer >= 0; writer-- ) {
+      iores = datastream_write( wstream + writer, databuf + woffset[writer], wsize[writer] + 100 );
+      if ( iores != wsize[writer] ) {
+         printf( "unexpected write res for pwrite session writer %d: %zd\n", writer, iores );
+         return -1;
+      }
+      if ( datastream_release( wstream + writer ) ) {
+         printf( "release failure for pwrite session writer %d\n", writer );
+         return -1;
+      }
+   }
+   // complete the file via the session owner
+   if ( datastream_close( &(stream) ) ) {
+      printf( "close failure for owner of pwrite session\n" );
+      return -1;
+   }
+   // read back the written file
+   if ( datastream_open( &(stream), READ_STREAM, "file3", &(pos), NULL ) ) {
+      printf( "failed to open 'file3' of pwrite session for read\n" );
+      return -1;
+   }
+   iores = datastream_read( &(stream), databuf + (10 * 1024), 12345 );
+   if ( iores != 10 * 1024 ) {
+      printf( "unexpected read res for 'file3' of pwrite session: %zd (%s)\n", iores, strerror(errno) );
+      return -1;
+   }
+   if ( memcmp( databuf, databuf + (10 * 1024), iores ) ) {
+      printf( "unexpected content of 'file3' of pwrite session\n" );
+      return -1;
+   }
+   if ( datastream_release( &(stream) ) ) {
+      printf( "failed to close pwrite session read stream\n" );
+      return -1;
+   }
+   // cleanup 'file3' refs
+   if ( pos.ns->prepo->metascheme.mdal->unlink( pos.ctxt, "file3" ) ) {
+      printf( "Failed to unlink pwrite session \"file3\"\n" );
+      return -1;
+   }
+   if ( pos.ns->prepo->metascheme.mdal->unlinkref( pos.ctxt, rpath ) ) {
+      printf( "Failed to unlink rpath: \"%s\"\n", rpath );
+      return -1;
+   }
+   free( rpath );
+   if ( ne_delete( pos.ns->prepo->datascheme.nectxt, objname, objlocation ) ) {
+      printf( "Failed to delete data object: \"%s\"\n", objname );
+      return -1;
+   }
+   free( objname );
+   if ( ne_delete( pos.ns->prepo->datascheme.nectxt, objname2, objlocation2 ) ) {
+      printf( "Failed to delete data object: \"%s\"\n", objname2 );
+      return -1;
+   }
+   free( objname2 );
+   if ( ne_delete( pos.ns->prepo->datascheme.nectxt, objname3, objlocation3 ) ) {
+      printf( "Failed to delete data object: \"%s\"\n", objname3 );
+      return -1;
+   }
+   free( objname3 );
+
+
+   // write a file spanning many objects, each closed in the background
+   if ( datastream_create( &(stream), "file5", &(pos), 0666, NULL ) ) {
+      printf( "create failure for 'file5'\n" );
+      return -1;
+   }
+   rpath = datastream_genrpath( &(stream->files->ftag), stream->ns->prepo->metascheme.reftable, NULL, NULL );
+   if ( rpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify the rpath of 'file5' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   for ( byteindex = 0; byteindex < 20 * 4096; byteindex++ ) { *((char*)databuf + byteindex) = (char)( byteindex % 241 ); }
+   for ( byteindex = 0; byteindex < 20 * 4096; byteindex += 4096 ) {
+      if ( datastream_write( &(stream), databuf + byteindex, 4096 ) != 4096 ) {
+         printf( "failed to write 'file5' at offset %zu\n", byteindex );
+         return -1;
+      }
+      // background closes, and the threads performing them, must remain within limits
+      if ( stream->closercount > DATASTREAM_MAX_CLOSING  ||  closepool.threads > DATASTREAM_CLOSE_THREADS ) {
+         printf( "exceeded background close limits: %zu closing objects, %d closer threads\n",
+                 stream->closercount, closepool.threads );
+         return -1;
+      }
+   }
+   if ( stream->objno < DATASTREAM_MAX_CLOSING + 1  ||  stream->closercount != DATASTREAM_MAX_CLOSING ) {
+      printf( "unexpected background close state of 'file5': objno = %zu, closercount = %zu\n",
+              stream->objno, stream->closercount );
+      return -1;
+   }
+   if ( datastream_close( &(stream) ) ) {
+      printf( "close failure for 'file5'\n" );
+      return -1;
+   }
+   if ( datastream_open( &(stream), READ_STREAM, "file5", &(pos), NULL ) ) {
+      printf( "failed to open 'file5' for read\n" );
+      return -1;
+   }
+   iores = datastream_read( &(stream), databuf + (20 * 4096), 21 * 4096 );
+   if ( iores != 20 * 4096  ||  memcmp( databuf, databuf + (20 * 4096), iores ) ) {
+      printf( "unexpected read of 'file5': %zd bytes (%s)\n", iores, strerror(errno) );
+      return -1;
+   }
+   // identify all data objects of the file, while its FTAG strings remain valid
+   tgttag = stream->files->ftag;
+   size_t finalobj = datastream_filebounds( &(tgttag) );
+   char* file5objs[32];
+   ne_location file5locs[32];
+   size_t file5objcnt = 0;
+   for ( ; tgttag.objno <= finalobj  &&  file5objcnt < 32; tgttag.objno++ ) {
+      if ( datastream_objtarget( &(tgttag), &(pos.ns->prepo->datascheme), file5objs + file5objcnt, &(objerasure), file5locs + file5objcnt ) ) {
+         printf( "Failed to identify data object %zu of 'file5'\n", tgttag.objno );
+         return -1;
+      }
+      file5objcnt++;
+   }
+   if ( datastream_release( &(stream) ) ) {
+      printf( "failed to release 'file5' read stream\n" );
+      return -1;
+   }
+   if ( pos.ns->prepo->metascheme.mdal->unlink( pos.ctxt, "file5" ) ) {
+      printf( "Failed to unlink \"file5\"\n" );
+      return -1;
+   }
+   if ( pos.ns->prepo->metascheme.mdal->unlinkref( pos.ctxt, rpath ) ) {
+      printf( "Failed to unlink rpath: \"%s\"\n", rpath );
+      return -1;
+   }
+   free( rpath );
+   while ( file5objcnt ) {
+      file5objcnt--;
+      if ( ne_delete( pos.ns->prepo->datascheme.nectxt, file5objs[file5objcnt], file5locs[file5objcnt] ) ) {
+         printf( "Failed to delete data object: \"%s\"\n", file5objs[file5objcnt] );
+         return -1;
+      }
+      free( file5objs[file5objcnt] );
+   }
+
+   // a failed background close must be reported by the stream close
+   if ( datastream_create( &(stream), "file6", &(pos), 0666, NULL ) ) {
+      printf( "create failure for 'file6'\n" );
+      return -1;
+   }
+   rpath = datastream_genrpath( &(stream->files->ftag), stream->ns->prepo->metascheme.reftable, NULL, NULL );
+   if ( rpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify the rpath of 'file6' (%s)\n", strerror(errno) );
+      return -1;
+   }
+   if ( datastream_write( &(stream), databuf, 100 ) != 100 ) {
+      printf( "failed to write 'file6'\n" );
+      return -1;
+   }
+   tgttag = stream->files->ftag;
+   if ( datastream_objtarget( &(tgttag), &(pos.ns->prepo->datascheme), &(objname), &(objerasure), &(objlocation) ) ) {
+      printf( "Failed to identify data object of 'file6'\n" );
+      return -1;
+   }
+   // hide the pod of the data object, such that the object cannot be synced
+   char poddir[128];
+   char hiddenpoddir[128];
+   snprintf( poddir, 128, "./test_datastream_topdir/dal_root/pod%d", objlocation.pod );
+   snprintf( hiddenpoddir, 128, "./test_datastream_topdir/dal_root/hidden-pod%d", objlocation.pod );
+   if ( rename( poddir, hiddenpoddir ) ) {
+      printf( "failed to hide DAL pod dir: \"%s\"\n", poddir );
+      return -1;
+   }
+   if ( close_current_obj_async( stream, &(tgttag) )  ||  stream->closercount != 1 ) {
+      printf( "failed to hand off 'file6' object for background close\n" );
+      return -1;
+   }
+   if ( datastream_close( &(stream) ) == 0  ||  stream != NULL ) {
+      printf( "unexpected close success for 'file6' following a failed background close\n" );
+      return -1;
+   }
+   if ( rename( hiddenpoddir, poddir ) ) {
+      printf( "failed to restore DAL pod dir: \"%s\"\n", poddir );
+      return -1;
+   }
+   if ( pos.ns->prepo->metascheme.mdal->unlink( pos.ctxt, "file6" ) ) {
+      printf( "Failed to unlink \"file6\"\n" );
+      return -1;
+   }
+   if ( pos.ns->prepo->metascheme.mdal->unlinkref( pos.ctxt, rpath ) ) {
+      printf( "Failed to unlink rpath: \"%s\"\n", rpath );
+      return -1;
+   }
+   free( rpath );
+   ne_delete( pos.ns->prepo->datascheme.nectxt, objname, objlocation ); // may not exist at all
+   free( objname );
+
+
    // cleanup our data buffer
    free( databuf );
 
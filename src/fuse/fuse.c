@@ -623,6 +623,8 @@ int fuse_read(const char *path, char *buf, size_t size, off_t offset, struct fus
   return ret;
 }
 
+#define FUSE_READDIR_BATCH 64 // number of entries retrieved per marfs_readdirplus() call
+
 int fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offset, struct fuse_file_info *ffi)
 {
   LOG(LOG_INFO, "%s\n", path);
@@ -633,7 +635,7 @@ int fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offs
     return -EBADF;
   }
 
-  struct dirent *de;
+  marfs_direntplus ents[FUSE_READDIR_BATCH];
 
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
@@ -658,25 +660,31 @@ int fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offs
     }
   }
 
+  // list entries, with attributes, in batches
   errno = 0;
-  while ((de = marfs_readdir((marfs_dhandle)ffi->fh)) != NULL)
+  ssize_t entcnt;
+  char full = 0;
+  while ( !(full)  &&  (entcnt = marfs_readdirplus((marfs_dhandle)ffi->fh, ents, FUSE_READDIR_BATCH)) > 0 )
   {
-    long posval = marfs_telldir((marfs_dhandle)ffi->fh);
-    if ( posval == -1 ) {
-      LOG(LOG_ERR, "%s\n", strerror(errno) );
-      ret = (errno) ? -errno : -ENOMSG;
-      exit_user(&u_ctxt);
-      return ret;
-    }
-    int fillret = filler(buf, de->d_name, NULL, (off_t)posval);
-    if ( fillret < 0 )
+    ssize_t index;
+    for ( index = 0; index < entcnt; index++ )
     {
-      LOG(LOG_ERR, "%s: %s\n", path, strerror(ENOMEM));
-      exit_user(&u_ctxt);
-      return -ENOMEM;
+      if ( ents[index].loc == -1 ) {
+        LOG(LOG_ERR, "%s: Invalid location of entry \"%s\"\n", path, ents[index].ent.d_name );
+        exit_user(&u_ctxt);
+        return -ENOMSG;
+      }
+      int fillret = filler(buf, ents[index].ent.d_name, (ents[index].sterr) ? NULL : &(ents[index].st), (off_t)ents[index].loc);
+      if ( fillret < 0 )
+      {
+        LOG(LOG_ERR, "%s: %s\n", path, strerror(ENOMEM));
+        exit_user(&u_ctxt);
+        return -ENOMEM;
+      }
+      else if ( fillret ) { full = 1; break; } // the next call will seek back to the unfilled entry
     }
-    else if ( fillret ) { break; }
   }
+  if ( entcnt >= 0 ) { errno = 0; }
   if ( errno != 0 ) {
     LOG( LOG_ERR, "%s: Detected errno value post-readdir (%s)\n", path, strerror(errno) );
     ret = -errno;
@@ -32,6 +32,11 @@
 
 #define TARGET_NODE_COUNT 50000
 
+// the direct index divides the ID space into 2^N equal buckets, by leading ID bits
+#define DIRECT_INDEX_RATIO    4           // target count of direct index buckets per vnode
+#define DIRECT_INDEX_MAXBITS  20          // upper bound on direct index size ( 2^N buckets )
+#define DIRECT_INDEX_NODE     0x80000000U // flags a bucket as directly referencing a real node
+
 typedef struct virtual_node_struct {
    uint64_t   id[2];             // ID value of this virtual node
    size_t     nodenum;           // location of the real node, which this virtual node corresponds to
@@ -45,6 +50,8 @@ typedef struct hash_table_struct {
    VIRTUAL_NODE*  vnodes;        // array of virtual node pointers
    size_t         curnode;       // position of the next node ( for iterating )
    size_t         iterated;      // number of nodes returned so far ( for iterating )
+   uint32_t*      directindex;   // per-bucket node number ( flagged ) or first vnode position
+   unsigned int   directshift;   // shift producing a bucket number from an ID value
 }* HASH_TABLE;
 
 
@@ -96,6 +103,51 @@ static int compare_nodes(const void *a, const void *b) {
    }
 }
 
+// populate the direct index of a table, allowing most lookups to bypass the vnode search
+// NOTE -- this only accelerates lookups, the resulting node of every lookup is unchanged
+static int build_direct_index( HASH_TABLE table ) {
+   table->directindex = NULL;
+   table->directshift = 0;
+   // tables beyond the bounds of our index values just fall back to a full vnode search
+   if ( table->vnodecount == 0  ||  table->vnodecount >= DIRECT_INDEX_NODE  ||
+        table->nodecount >= DIRECT_INDEX_NODE ) {
+      LOG( LOG_INFO, "Omitting direct index for table of %zu vnodes\n", table->vnodecount );
+      return 0;
+   }
+   unsigned int bits = 1;
+   while ( bits < DIRECT_INDEX_MAXBITS  &&
+           ( (size_t)1 << bits ) < ( table->vnodecount * DIRECT_INDEX_RATIO ) ) { bits++; }
+   size_t bucketcount = (size_t)1 << bits;
+   uint32_t* directindex = malloc( sizeof(uint32_t) * bucketcount );
+   if ( directindex == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a direct index of %zu buckets\n", bucketcount );
+      return -1;
+   }
+   unsigned int shift = 64 - bits;
+   size_t curvnode = 0;
+   size_t bucket = 0;
+   for ( ; bucket < bucketcount; bucket++ ) {
+      // vnodes are sorted, so the first remaining vnode is the successor of every ID in this bucket
+      size_t firstvnode = curvnode;
+      while ( curvnode < table->vnodecount  &&  ( table->vnodes[curvnode].id[0] >> shift ) == bucket ) {
+         curvnode++;
+      }
+      if ( curvnode == firstvnode ) {
+         // no vnode falls within this bucket, so every ID maps to the same node
+         size_t successor = ( firstvnode == table->vnodecount ) ? 0 : firstvnode;
+         directindex[bucket] = DIRECT_INDEX_NODE | (uint32_t)( table->vnodes[successor].nodenum );
+      }
+      else {
+         // lookups within this bucket must still search its vnodes
+         directindex[bucket] = (uint32_t)firstvnode;
+      }
+   }
+   LOG( LOG_INFO, "Created direct index of %zu buckets for %zu vnodes\n", bucketcount, table->vnodecount );
+   table->directindex = directindex;
+   table->directshift = shift;
+   return 0;
+}
+
 
 //   -------------   EXTERNAL FUNCTIONS    -------------
 
@@ -255,6 +307,14 @@ HASH_TABLE hash_init( HASH_NODE* nodes, size_t count, char directlookup ) {
    table->curnode = 0;
    table->iterated = 0;
 
+   // index the sorted vnodes
+   if ( build_direct_index( table ) ) {
+      LOG( LOG_ERR, "Failed to build direct index of virtual nodes\n" );
+      free( table->vnodes );
+      free( table );
+      return NULL;
+   }
+
    return table;
 }
 
@@ -281,6 +341,7 @@ int hash_term( HASH_TABLE table, HASH_NODE** nodes, size_t* count ) {
    if ( nodes ) { *nodes = table->nodes; }
    if ( count ) { *count = table->nodecount; }
    // cleanup memory structures
+   if ( table->directindex ) { free( table->directindex ); }
    free( table->vnodes );
    free( table );
    return 0;
@@ -304,6 +365,9 @@ int hash_term( HASH_TABLE table, HASH_NODE** nodes, size_t* count ) {
  *         generate this HASH_TABLE was zero ( NO support for direct lookups ), there is no
  *         guarantee that a hash_lookup() of a string matching the node name will map to that
  *         same node.
+ *         Each table includes a direct index of its virtual node ring, so that most lookups
+ *         cost only a hash and a single index load ( the ring is searched only for targets
+ *         near a virtual node boundary ).  Results are identical to a full search of the ring.
  */
 int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node ) {
    // check for a NULL table
@@ -326,6 +390,25 @@ int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node ) {
    identifier( target, tid );
    int retval = 1; // assume an approximate match
 
+   // consult the direct index, to either skip or narrow our vnode search
+   size_t min = 0;                 // minimum is an INCLUSIVE bound
+   size_t max = table->vnodecount; // maximum is an EXCLUSIVE bound (until the final iteration)
+   if ( table->directindex ) {
+      size_t bucket = (size_t)( tid[0] >> table->directshift );
+      uint32_t entry = table->directindex[bucket];
+      if ( entry & DIRECT_INDEX_NODE ) {
+         // no vnode ID falls within this bucket, so an exact match is impossible
+         *node = table->nodes + ( entry & ~(DIRECT_INDEX_NODE) );
+         return retval;
+      }
+      // only vnodes within this bucket can match or succeed the target ID
+      min = entry;
+      max = min;
+      while ( max < table->vnodecount  &&  ( table->vnodes[max].id[0] >> table->directshift ) == bucket ) {
+         max++;
+      }
+   }
+
    // perform a binary search of the vnode ring for a matching ID value
    // NOTE -- the builtin bsearch() function is not ideal for this, as it is looking only 
    //         for an exact match.  While our function prefers an exact match, we will settle 
@@ -333,9 +416,7 @@ int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node ) {
    //         Additionally, we consider our vnode array a 'ring'.  ID values beyond the end of 
    //         the array will loop back to the beginning.  This means that EVERY hash_lookup() 
    //         will produce a node entry, just not necessarily one which matches exactly.
-   size_t curnode = table->vnodecount / 2;
-   size_t min = 0;                 // minimum is an INCLUSIVE bound
-   size_t max = table->vnodecount; // maximum is an EXCLUSIVE bound (until the final iteration)
+   size_t curnode = min + ( ( max - min ) / 2 );
    while ( min != max ) {
       int comparison = compareID( table->vnodes[curnode].id, tid );
       if ( comparison > 0 ) {
@@ -475,6 +556,115 @@ int hash_reset( HASH_TABLE table ) {
 }
 
 
+/**
+ * Serialize the virtual node ring of the given HASH_TABLE, for later reconstruction via hash_import()
+ * @param HASH_TABLE table : HASH_TABLE to be serialized
+ * @param void* buffer : Buffer to be populated with the serialized ring ( may be NULL, if size is zero )
+ * @param size_t size : Size of the provided buffer
+ * @return size_t : Byte length of the serialized ring, or zero if a failure occurred
+ *                  Note -- The buffer is only populated if this length does not exceed 'size'.
+ */
+size_t hash_export( HASH_TABLE table, void* buffer, size_t size ) {
+   // check for a NULL table
+   if ( table == NULL ) {
+      LOG( LOG_ERR, "Received a NULL HASH_TABLE reference\n" );
+      errno = EINVAL;
+      return 0;
+   }
+   // ring is stored as a vnode count, followed by ( id[0], id[1], nodenum ) for every vnode
+   size_t length = sizeof(uint64_t) * ( 1 + ( 3 * table->vnodecount ) );
+   if ( buffer == NULL  ||  size < length ) { return length; }
+   uint64_t* output = (uint64_t*)buffer;
+   uint64_t value = table->vnodecount;
+   memcpy( output, &(value), sizeof(uint64_t) );
+   output++;
+   size_t curvnode = 0;
+   for ( ; curvnode < table->vnodecount; curvnode++ ) {
+      memcpy( output, table->vnodes[curvnode].id, sizeof(uint64_t) * 2 );
+      value = table->vnodes[curvnode].nodenum;
+      memcpy( output + 2, &(value), sizeof(uint64_t) );
+      output += 3;
+   }
+   return length;
+}
+
+/**
+ * Create a HASH_TABLE from a virtual node ring produced by hash_export(), skipping all hashing 
+ * and sorting of virtual nodes
+ * @param HASH_NODE* nodes : List of hash nodes to be included in the table
+ *                           ( must match the node list of the exported table )
+ * @param size_t count : Count of HASH_NODEs in the 'nodes' arg
+ * @param const void* buffer : Serialized ring content
+ * @param size_t size : Byte length of the serialized ring
+ * @return HASH_TABLE : Reference to the newly produced HASH_TABLE, or NULL if a failure occurred
+ */
+HASH_TABLE hash_import( HASH_NODE* nodes, size_t count, const void* buffer, size_t size ) {
+   // check for invalid args
+   if ( nodes == NULL  ||  buffer == NULL  ||  size < sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Received an invalid node list or ring buffer\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   const uint64_t* input = (const uint64_t*)buffer;
+   uint64_t vnodecount;
+   memcpy( &(vnodecount), input, sizeof(uint64_t) );
+   input++;
+   if ( vnodecount == 0  ||  ( size - sizeof(uint64_t) ) / ( 3 * sizeof(uint64_t) ) != vnodecount  ||
+        ( size - sizeof(uint64_t) ) % ( 3 * sizeof(uint64_t) ) ) {
+      LOG( LOG_ERR, "Ring length of %zu bytes does not match vnode count of %zu\n", size, (size_t)vnodecount );
+      errno = EINVAL;
+      return NULL;
+   }
+   LOG( LOG_INFO, "Importing HT ( %zu nodes / %zu vnodes )\n", count, (size_t)vnodecount );
+   HASH_TABLE table = malloc( sizeof( struct hash_table_struct ) );
+   if ( table == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for HASH_TABLE\n" );
+      return NULL;
+   }
+   table->vnodes = malloc( sizeof( struct virtual_node_struct ) * vnodecount );
+   if ( table->vnodes == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for virtual nodes\n" );
+      free( table );
+      return NULL;
+   }
+   // populate all vnodes, verifying that they reference real nodes and retain their sort order
+   size_t curvnode = 0;
+   for ( ; curvnode < vnodecount; curvnode++ ) {
+      uint64_t nodenum;
+      memcpy( table->vnodes[curvnode].id, input, sizeof(uint64_t) * 2 );
+      memcpy( &(nodenum), input + 2, sizeof(uint64_t) );
+      input += 3;
+      if ( nodenum >= count ) {
+         LOG( LOG_ERR, "Vnode %zu references nonexistent node %zu\n", curvnode, (size_t)nodenum );
+         break;
+      }
+      table->vnodes[curvnode].nodenum = nodenum;
+      if ( curvnode  &&  compare_nodes( table->vnodes + (curvnode - 1), table->vnodes + curvnode ) > 0 ) {
+         LOG( LOG_ERR, "Vnode %zu is out of order\n", curvnode );
+         break;
+      }
+   }
+   if ( curvnode != vnodecount ) {
+      free( table->vnodes );
+      free( table );
+      errno = EINVAL;
+      return NULL;
+   }
+   table->nodecount = count;
+   table->nodes = nodes;
+   table->vnodecount = vnodecount;
+   table->curnode = 0;
+   table->iterated = 0;
+   if ( build_direct_index( table ) ) {
+      LOG( LOG_ERR, "Failed to build direct index of imported virtual nodes\n" );
+      free( table->vnodes );
+      free( table );
+      return NULL;
+   }
+   return table;
+}
+
+
 // POLYHASH implementation
 // NOTE -- not currently in use, just here for potential future reference
 //
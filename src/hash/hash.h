@@ -85,6 +85,9 @@ int hash_term( HASH_TABLE table, HASH_NODE** nodes, size_t* count );
  *         generate this HASH_TABLE was zero ( NO support for direct lookups ), there is no 
  *         guarantee that a hash_lookup() of a string matching the node name will map to that 
  *         same node.
+ *         Each table includes a direct index of its virtual node ring, so that most lookups
+ *         cost only a hash and a single index load ( the ring is searched only for targets
+ *         near a virtual node boundary ).  Results are identical to a full search of the ring.
  */
 int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node );
 
@@ -109,5 +112,29 @@ int hash_iterate( HASH_TABLE table, HASH_NODE** node );
  */
 int hash_reset( HASH_TABLE table );
 
+/**
+ * Serialize the virtual node ring of the given HASH_TABLE, for later reconstruction via hash_import()
+ * @param HASH_TABLE table : HASH_TABLE to be serialized
+ * @param void* buffer : Buffer to be populated with the serialized ring ( may be NULL, if size is zero )
+ * @param size_t size : Size of the provided buffer
+ * @return size_t : Byte length of the serialized ring, or zero if a failure occurred
+ *                  Note -- The buffer is only populated if this length does not exceed 'size'.
+ */
+size_t hash_export( HASH_TABLE table, void* buffer, size_t size );
+
+/**
+ * Create a HASH_TABLE from a virtual node ring produced by hash_export(), skipping all hashing 
+ * and sorting of virtual nodes
+ * @param HASH_NODE* nodes : List of hash nodes to be included in the table
+ *                           ( must match the node list of the exported table )
+ * @param size_t count : Count of HASH_NODEs in the 'nodes' arg
+ * @param const void* buffer : Serialized ring content
+ * @param size_t size : Byte length of the serialized ring
+ * @return HASH_TABLE : Reference to the newly produced HASH_TABLE, or NULL if a failure occurred
+ * Note -- The serialized ring is stored in host byte order, and is only valid for import on a 
+ *         host of matching endianness.
+ */
+HASH_TABLE hash_import( HASH_NODE* nodes, size_t count, const void* buffer, size_t size );
+
 #endif // _HASH_H
 
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <time.h>
+// directly including the C file allows more flexibility for these tests
+#include "hash/hash.c"
+
+#define TARGET_COUNT 200000
+#define PASS_COUNT   5
+
+// elapsed nanoseconds between two timespec values
+static double elapsed_ns( struct timespec* start, struct timespec* end ) {
+   return ( (double)( end->tv_sec - start->tv_sec ) * 1e9 ) + (double)( end->tv_nsec - start->tv_nsec );
+}
+
+// time PASS_COUNT lookups of every target, populating the result list and returning ns per lookup
+static double time_lookups( HASH_TABLE table, char** targets, HASH_NODE** results ) {
+   struct timespec start, end;
+   clock_gettime( CLOCK_MONOTONIC, &(start) );
+   int pass = 0;
+   for ( ; pass < PASS_COUNT; pass++ ) {
+      size_t tnum = 0;
+      for ( ; tnum < TARGET_COUNT; tnum++ ) {
+         if ( hash_lookup( table, targets[tnum], results + tnum ) < 0 ) {
+            printf( "failed lookup of target %zu\n", tnum );
+            return -1.0;
+         }
+      }
+   }
+   clock_gettime( CLOCK_MONOTONIC, &(end) );
+   return elapsed_ns( &(start), &(end) ) / ( (double)TARGET_COUNT * PASS_COUNT );
+}
+
+int main(int argc, char **argv)
+{
+   // NOTE -- I'm ignoring memory leaks for error conditions which result in immediate termination
+
+   // generate a weighted node list, resembling a set of pods or caps
+   size_t nodecount = 16;
+   size_t totalweight = 0;
+   HASH_NODE* nodelist = malloc( sizeof(HASH_NODE) * nodecount );
+   size_t* lcounts = calloc( nodecount, sizeof(size_t) );
+   if ( nodelist == NULL  ||  lcounts == NULL ) {
+      printf( "failed to allocate node list\n" );
+      return -1;
+   }
+   size_t i = 0;
+   for ( ; i < nodecount; i++ ) {
+      nodelist[i].name = malloc( sizeof(char) * 60 );
+      if ( nodelist[i].name == NULL ) {
+         printf( "failed to allocate name string for node %zu\n", i );
+         return -1;
+      }
+      snprintf( nodelist[i].name, 60, "pod%zu", i );
+      nodelist[i].weight = ( i % 4 ) + 1;
+      nodelist[i].content = lcounts + i;
+      totalweight += nodelist[i].weight;
+   }
+   HASH_TABLE table = hash_init( nodelist, nodecount, 0 );
+   if ( table == NULL  ||  table->directindex == NULL ) {
+      printf( "failed to initialize an indexed distribution table\n" );
+      return -1;
+   }
+
+   // generate all lookup targets up front, resembling object names
+   char** targets = malloc( sizeof(char*) * TARGET_COUNT );
+   HASH_NODE** indexresults = malloc( sizeof(HASH_NODE*) * TARGET_COUNT );
+   HASH_NODE** ringresults = malloc( sizeof(HASH_NODE*) * TARGET_COUNT );
+   if ( targets == NULL  ||  indexresults == NULL  ||  ringresults == NULL ) {
+      printf( "failed to allocate target lists\n" );
+      return -1;
+   }
+   for ( i = 0; i < TARGET_COUNT; i++ ) {
+      targets[i] = malloc( sizeof(char) * 128 );
+      if ( targets[i] == NULL ) {
+         printf( "failed to allocate target string %zu\n", i );
+         return -1;
+      }
+      snprintf( targets[i], 128, "ctag-example|1634567890.123456789|%zu|0", i );
+   }
+
+   // time the hash computation alone, as a lower bound on lookup cost
+   struct timespec start, end;
+   uint64_t idsum = 0;
+   clock_gettime( CLOCK_MONOTONIC, &(start) );
+   int pass = 0;
+   for ( ; pass < PASS_COUNT; pass++ ) {
+      for ( i = 0; i < TARGET_COUNT; i++ ) {
+         uint64_t tid[2];
+         identifier( targets[i], tid );
+         idsum += tid[0];
+      }
+   }
+   clock_gettime( CLOCK_MONOTONIC, &(end) );
+   double hashns = elapsed_ns( &(start), &(end) ) / ( (double)TARGET_COUNT * PASS_COUNT );
+
+   // time lookups via the direct index, and via a full search of the vnode ring
+   double indexns = time_lookups( table, targets, indexresults );
+   uint32_t* directindex = table->directindex;
+   table->directindex = NULL;
+   double ringns = time_lookups( table, targets, ringresults );
+   table->directindex = directindex;
+   if ( indexns < 0  ||  ringns < 0 ) { return -1; }
+   printf( "%zu vnodes / %zu index buckets ( %zu KiB ) ( idsum %llu )\n", table->vnodecount,
+           (size_t)1 << ( 64 - table->directshift ),
+           ( sizeof(uint32_t) << ( 64 - table->directshift ) ) / 1024, (unsigned long long)idsum );
+   printf( "hash only:      %8.1f ns per target\n", hashns );
+   printf( "direct index:   %8.1f ns per lookup\n", indexns );
+   printf( "ring search:    %8.1f ns per lookup\n", ringns );
+
+   // both lookup methods must produce identical results
+   for ( i = 0; i < TARGET_COUNT; i++ ) {
+      if ( indexresults[i] != ringresults[i] ) {
+         printf( "direct index result for \"%s\" differs from ring search ( %s vs %s )\n",
+                 targets[i], indexresults[i]->name, ringresults[i]->name );
+         return -1;
+      }
+      size_t* lcount = indexresults[i]->content;
+      (*lcount)++;
+   }
+
+   // report the distribution, relative to node weight
+   double maxdeviation = 0.0;
+   for ( i = 0; i < nodecount; i++ ) {
+      double expected = ( (double)TARGET_COUNT * nodelist[i].weight ) / totalweight;
+      double deviation = ( (double)lcounts[i] - expected ) / expected;
+      if ( deviation < 0 ) { deviation = -deviation; }
+      if ( deviation > maxdeviation ) { maxdeviation = deviation; }
+   }
+   printf( "max deviation from weighted share: %.2f%%\n", maxdeviation * 100.0 );
+   if ( maxdeviation > 0.10 ) {
+      printf( "lookup distribution deviates excessively from node weights\n" );
+      return -1;
+   }
+
+   // cleanup
+   for ( i = 0; i < TARGET_COUNT; i++ ) { free( targets[i] ); }
+   free( targets );
+   free( indexresults );
+   free( ringresults );
+   if ( hash_term( table, NULL, NULL ) ) {
+      printf( "failed to terminate hash table\n" );
+      return -1;
+   }
+   for ( i = 0; i < nodecount; i++ ) { free( nodelist[i].name ); }
+   free( nodelist );
+   free( lcounts );
+
+   return 0;
+}
@@ -103,6 +103,28 @@ int main(int argc, char **argv)
       }
    }
 
+   // verify that direct index lookups match full searches of the vnode ring
+   uint32_t* directindex = disttable->directindex;
+   if ( directindex == NULL ) {
+      printf( "distribution table lacks a direct index\n" );
+      return -1;
+   }
+   for ( lnum = 0; lnum < lookuptotal; lnum++ ) {
+      snprintf( nodename, 128, "consistent-section-%zu-consistent-section", lnum );
+      HASH_NODE* indexref = NULL;
+      HASH_NODE* ringref = NULL;
+      disttable->directindex = directindex;
+      int indexres = hash_lookup( disttable, nodename, &(indexref) );
+      disttable->directindex = NULL;
+      int ringres = hash_lookup( disttable, nodename, &(ringref) );
+      if ( indexres != ringres  ||  indexref != ringref ) {
+         printf( "direct index lookup %zu differs from ring search ( %s vs %s )\n", lnum,
+                 (indexref) ? indexref->name : "NULL", (ringref) ? ringref->name : "NULL" );
+         return -1;
+      }
+   }
+   disttable->directindex = directindex;
+
    // terminate the hash table
    size_t retcount = 0;
    if ( hash_term( disttable, &(noderef), &(retcount) ) ) {
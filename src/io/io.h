@@ -21,7 +21,8 @@ extern "C"
 #include <pthread.h>
 #include <stdint.h>
 
-#define SUPER_BLOCK_CNT 4
+#define SUPER_BLOCK_CNT 4 // default ioqueue depth ( ioblocks per queue )
+#define IOQUEUE_MAX_DEPTH 64 // upper limit on the depth of any ioqueue
 #define CRC_BYTES 4 // DO NOT decrease without adjusting CRC gen and block creation code!
 
 /* ------------------------------   IO QUEUE   ------------------------------ */
@@ -35,13 +36,29 @@ typedef struct ioblock_struct
 } ioblock;
 
 // Queue of IOBlocks for thread communication
+// NOTE -- ioblocks are handed out and returned in ring order.  An adaptive queue ( maxdepth > mindepth )
+//         inserts a new ioblock at the head of the ring whenever a reservation has to wait for one, and
+//         drops unused ioblocks again, down to mindepth, when the system runs low on memory.
 typedef struct ioqueue_struct
 {
    pthread_mutex_t qlock;               // lock for queue manipulation
    pthread_cond_t avail_block;          // condition for awaiting an available block
    int head;                            // integer indicating location of the next available block
-   int depth;                           // current depth of the queue
-   ioblock block_list[SUPER_BLOCK_CNT]; // list of ioblocks
+   int depth;                           // current count of available blocks
+   int blockcnt;                        // current count of blocks in the ring
+   int mindepth;                        // initial ( and minimum ) count of blocks
+   int maxdepth;                        // maximum count of blocks
+   int peakdepth;                       // greatest count of blocks ever in the ring
+   ioblock* block_pool;                 // ioblock structs ( maxdepth entries, unused if buff == NULL )
+   ioblock** block_list;                // ring of ioblock references ( blockcnt entries in use )
+   int numa_node;                       // NUMA node of ioblock buffers ( negative for no binding )
+   unsigned int reservations;           // reservations since the last check for memory pressure
+
+   // stall counters
+   uint64_t stalls;                     // count of reservations which waited for an available block
+   uint64_t stallns;                    // total time spent waiting for available blocks
+   unsigned int grows;                  // count of blocks added to the ring
+   unsigned int shrinks;                // count of blocks removed from the ring
 
    //size_t          fill_threshold;
    size_t split_threshold;
@@ -52,13 +69,28 @@ typedef struct ioqueue_struct
    size_t blocksz; // size of each ioblock buffer
 } ioqueue;
 
+// Snapshot of IOQueue behavior, for tuning of queue depth
+typedef struct ioqueue_stats_struct
+{
+   uint64_t stalls;       // count of reservations which waited for an available block
+   uint64_t stallns;      // total time spent waiting for available blocks
+   unsigned int grows;    // count of blocks added to the queue
+   unsigned int shrinks;  // count of blocks removed from the queue
+   int depth;             // current count of blocks in the queue
+   int peakdepth;         // greatest count of blocks ever held by the queue
+} ioqueue_stats;
+
 /**
  * Creates a new IOQueue
  * @param size_t iosz : Byte size of each IO to be performed
  * @param size_t partsz : Byte size of each erasure part
+ * @param DAL_MODE mode : Mode of the IO to be performed
+ * @param int depth : Initial ( and minimum ) count of ioblocks ( SUPER_BLOCK_CNT, if <= 0 )
+ * @param int maxdepth : Maximum count of ioblocks, to which the queue may grow if reservations
+ *                       stall ( no growth, if <= depth )
  * @return ioqueue* : Reference to the newly created IOQueue
  */
-ioqueue *create_ioqueue(size_t iosz, size_t partsz, DAL_MODE mode);
+ioqueue *create_ioqueue(size_t iosz, size_t partsz, DAL_MODE mode, int depth, int maxdepth);
 
 /**
  * Destroys an existing IOQueue
@@ -74,6 +106,22 @@ int destroy_ioqueue(ioqueue *ioq);
  */
 ssize_t ioqueue_maxdata(ioqueue *ioq);
 
+/**
+ * Populate a snapshot of the stall counters and depth of the given IOQueue
+ * @param ioqueue* ioq : IOQueue to retrieve stats for
+ * @param ioqueue_stats* stats : Reference to the ioqueue_stats struct to be populated
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int ioqueue_getstats(ioqueue *ioq, ioqueue_stats *stats);
+
+/**
+ * Release all unused ioblocks gained through growth of an adaptive IOQueue ( never below its initial depth )
+ * NOTE -- this is done automatically when the system runs low on memory
+ * @param ioqueue* ioq : IOQueue to be trimmed
+ * @return int : Count of released ioblocks, or -1 if an error occurred
+ */
+int trim_ioqueue(ioqueue *ioq);
+
 /**
  * Sets ioblock fill level such that a specific data split will occur (used to align ioblock to a specific offset)
  * @param ioblock* iob : Current ioblock
@@ -139,6 +187,31 @@ size_t ioblock_get_fill(ioblock *block);
  */
 int release_ioblock(ioqueue *ioq);
 
+/**
+ * Request that all ioblock buffers of the given IOQueue be placed on the specified NUMA node
+ * NOTE -- this is only a placement preference, and will have no effect on systems lacking NUMA support
+ * @param ioqueue* ioq : Reference to the ioqueue struct to be bound
+ * @param int node : NUMA node to bind to
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int bind_ioqueue(ioqueue *ioq, int node);
+
+/* ------------------------------   NUMA PLACEMENT   ------------------------------ */
+
+/**
+ * Identify the number of NUMA nodes of this system
+ * @return int : One greater than the highest online NUMA node, or zero if no topology is available
+ */
+int io_numa_nodes(void);
+
+/**
+ * Bind the calling thread to the CPUs of the specified NUMA node, within its current affinity
+ *    NOTE -- intended to be called once, as a thread starts; the binding is never reverted
+ * @param int node : NUMA node to bind to
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int io_numa_bind(int node);
+
 /* ------------------------------   THREAD BEHAVIOR   ------------------------------ */
 
 // This struct contains all info read threads should need
@@ -154,7 +227,10 @@ typedef struct global_state_struct
    char meta_error;
    char data_error;
    ioqueue *ioq;
+   int qdepth;    // initial depth of the ioqueue
+   int qdepthmax; // maximum depth of the ioqueue
    pthread_mutex_t* erasurelock;
+   int numa_node; // NUMA node to run on ( negative for no binding )
 } gthread_state;
 
 // Write thread internal state struct
@@ -63,6 +63,7 @@ underlying skt_etc() functions.
 #endif
 #define LOG_PREFIX "ioqueue"
 #include "logging/logging.h"
+#include "logging/perfstats.h"
 
 #include "io/io.h"
 
@@ -75,6 +76,16 @@ underlying skt_etc() functions.
 #include <unistd.h>
 #include <errno.h>
 #include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+
+// mbind() values, as defined by the kernel ( avoids a dependency on libnuma's numaif.h )
+#define MPOL_PREFERRED 1
+#define MPOL_MF_MOVE (1<<1)
+#define NUMA_MASK_LONGS 16 // supports up to 1024 NUMA nodes
+
+#define IOQUEUE_LOWMEM_PCT 5 // available memory percentage, below which ioqueues will not grow
+#define IOQUEUE_LOWMEM_INTERVAL 64 // reservations between checks for memory pressure, while a queue is grown
 
 
 
@@ -82,13 +93,114 @@ underlying skt_etc() functions.
 /* ------------------------------   IO QUEUE/BLOCK INTERACTION   ------------------------------ */
 
 
+/**
+ * Request that the given ioblock buffer be placed on the specified NUMA node
+ * @param void* buff : Buffer to be bound
+ * @param size_t blocksz : Size of the buffer
+ * @param int node : NUMA node to bind to
+ * @return int : Zero on success and -1 if an error occurred
+ */
+static int bind_buffer( void* buff, size_t blocksz, int node ) {
+#ifdef SYS_mbind
+   unsigned long nodemask[NUMA_MASK_LONGS] = {0};
+   nodemask[ node / (8 * sizeof(unsigned long)) ] = 1UL << ( node % (8 * sizeof(unsigned long)) );
+   long pagesz = sysconf( _SC_PAGESIZE );
+   if ( pagesz <= 0 ) { pagesz = 4096; }
+   // buffers are page aligned, but their length must be rounded up to a page boundary
+   size_t len = ( (blocksz + pagesz - 1) / pagesz ) * pagesz;
+   // NOTE -- MPOL_MF_MOVE relocates any pages which have already been touched
+   if ( syscall( SYS_mbind, buff, len, MPOL_PREFERRED,
+                 nodemask, NUMA_MASK_LONGS * 8 * sizeof(unsigned long), MPOL_MF_MOVE ) ) {
+      return -1;
+   }
+#endif
+   return 0;
+}
+
+
+/**
+ * Determine if the system is running low on memory, such that ioqueues should not grow
+ * @return int : Non-zero if available memory is below IOQUEUE_LOWMEM_PCT of the total, and zero otherwise
+ */
+static int ioqueue_lowmem( void ) {
+   FILE* meminfo = fopen( "/proc/meminfo", "r" );
+   if ( meminfo == NULL ) {
+      return 0; // no way to tell, so assume all is well
+   }
+   unsigned long long total = 0;
+   unsigned long long avail = 0;
+   char line[128];
+   while ( fgets( line, sizeof(line), meminfo ) != NULL  &&  ( total == 0  ||  avail == 0 ) ) {
+      unsigned long long value;
+      if ( sscanf( line, "MemTotal: %llu kB", &value ) == 1 ) { total = value; }
+      else if ( sscanf( line, "MemAvailable: %llu kB", &value ) == 1 ) { avail = value; }
+   }
+   fclose( meminfo );
+   if ( total == 0  ||  avail == 0 ) {
+      return 0; // kernel too old to report available memory
+   }
+   return ( avail < ( total / 100 ) * IOQUEUE_LOWMEM_PCT );
+}
+
+
+/**
+ * Add a new ioblock to the head of the ring of the given IOQueue
+ * NOTE -- only the reserving thread inserts ioblocks, so the ring position is always valid
+ * @param ioqueue* ioq : Reference to the ioqueue struct to grow
+ * @return int : Zero on success, or -1 if no ioblock could be added
+ */
+static int grow_ioqueue( ioqueue* ioq ) {
+   void* buff = NULL;
+   // allocate outside of the queue lock, so as not to hold up the consumer
+   int allocres = posix_memalign( &(buff), 4096, sizeof( char ) * ioq->blocksz );
+   if ( allocres  ||  buff == NULL ) {
+      LOG( LOG_WARNING, "Failed to allocate an additional ioblock ( %s )\n", strerror(allocres) );
+      return -1;
+   }
+   if ( pthread_mutex_lock(&ioq->qlock) ) { // aquire the queue lock
+      LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
+      free( buff );
+      return -1;
+   }
+   if ( ioq->blockcnt >= ioq->maxdepth ) {
+      pthread_mutex_unlock(&ioq->qlock);
+      free( buff );
+      return -1;
+   }
+   if ( ioq->numa_node >= 0  &&  bind_buffer( buff, ioq->blocksz, ioq->numa_node ) ) {
+      LOG( LOG_WARNING, "Failed to bind new ioblock to NUMA node %d ( %s )\n", ioq->numa_node, strerror(errno) );
+   }
+   // locate an unused ioblock struct
+   ioblock* block = ioq->block_pool;
+   while ( block->buff != NULL ) { block++; }
+   block->buff = buff;
+   block->data_size = 0;
+   block->error_end = 0;
+   // the new ioblock becomes the next to be reserved, preserving ring order of all others
+   memmove( ioq->block_list + ioq->head + 1, ioq->block_list + ioq->head,
+            sizeof( ioblock* ) * ( ioq->blockcnt - ioq->head ) );
+   ioq->block_list[ioq->head] = block;
+   ioq->blockcnt++;
+   ioq->depth++;
+   ioq->grows++;
+   if ( ioq->blockcnt > ioq->peakdepth ) { ioq->peakdepth = ioq->blockcnt; }
+   LOG( LOG_INFO, "Grew ioqueue to %d ioblocks\n", ioq->blockcnt );
+   pthread_mutex_unlock(&ioq->qlock);
+   return 0;
+}
+
+
 /**
  * Creates a new IOQueue
  * @param size_t iosz : Byte size of each IO to be performed
  * @param size_t partsz : Byte size of each erasure part
+ * @param DAL_MODE mode : Mode of the IO to be performed
+ * @param int depth : Initial ( and minimum ) count of ioblocks ( SUPER_BLOCK_CNT, if <= 0 )
+ * @param int maxdepth : Maximum count of ioblocks, to which the queue may grow if reservations
+ *                       stall ( no growth, if <= depth )
  * @return ioqueue* : Reference to the newly created IOQueue
  */
-ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
+ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode, int depth, int maxdepth ) {
    LOG( LOG_INFO, "Creating IOQueue with IOSZ=%zu, PARTSZ=%zu, MODE=%s\n", iosz, partsz, ( mode == DAL_READ ) ? "read" : "write" );
    // sanity check that our IO Size is sufficient to at least do something
    if ( iosz <= CRC_BYTES ) {
@@ -100,6 +212,15 @@ ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
       LOG( LOG_ERR, "PartSz %zu is invalid!\n", partsz );
       return NULL;
    }
+   // sanity check depth values
+   if ( depth <= 0 ) { depth = SUPER_BLOCK_CNT; }
+   if ( maxdepth < depth ) { maxdepth = depth; }
+   if ( depth < 2  ||  maxdepth > IOQUEUE_MAX_DEPTH ) {
+      LOG( LOG_ERR, "IOQueue depth values ( %d - %d ) are outside the supported range ( 2 - %d )!\n",
+           depth, maxdepth, IOQUEUE_MAX_DEPTH );
+      errno = EINVAL;
+      return NULL;
+   }
    size_t subsz = (mode == DAL_READ) ? (iosz - CRC_BYTES) : partsz;
    int    partcnt = (int) ( (iosz - CRC_BYTES) / partsz); // number of complete parts per IO
    if ( partsz > (iosz - CRC_BYTES) ) {
@@ -112,9 +233,20 @@ ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
       LOG( LOG_ERR, "failed to allocate memory for an ioqueue_struct!\n" );
       return NULL;
    }
+   ioq->block_pool = calloc( maxdepth, sizeof( ioblock ) );
+   ioq->block_list = calloc( maxdepth, sizeof( ioblock* ) );
+   if ( ioq->block_pool == NULL  ||  ioq->block_list == NULL ) {
+      LOG( LOG_ERR, "failed to allocate memory for %d ioblock structs!\n", maxdepth );
+      if ( ioq->block_pool ) { free( ioq->block_pool ); }
+      if ( ioq->block_list ) { free( ioq->block_list ); }
+      free( ioq );
+      return NULL;
+   }
    // intialize all ioqueue values
    if ( pthread_mutex_init( &(ioq->qlock), NULL ) ) {
       LOG( LOG_ERR, "failed to initialize the ioqueue lock!\n" );
+      free( ioq->block_list );
+      free( ioq->block_pool );
       free( ioq );
       return NULL;
    }
@@ -122,6 +254,8 @@ ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
    if ( pthread_cond_init( &(ioq->avail_block), NULL ) ) {
       LOG( LOG_ERR, "failed to initialize the ioqueue avail_block conditional var!\n" );
       pthread_mutex_destroy( &(ioq->qlock) );
+      free( ioq->block_list );
+      free( ioq->block_pool );
       free( ioq );
       return NULL;
    }
@@ -135,7 +269,12 @@ ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
    ioq->iosz = iosz;
    ioq->partcnt = partcnt;
    ioq->head = 0;
-   ioq->depth = SUPER_BLOCK_CNT;
+   ioq->depth = depth;
+   ioq->blockcnt = depth;
+   ioq->mindepth = depth;
+   ioq->maxdepth = maxdepth;
+   ioq->peakdepth = depth;
+   ioq->numa_node = -1;
    // calculate the blocksz we must allocate to allways fit written data
    // NOTE -- assuming perfect IOSZ and PARTSZ alignment, we will need space for a full buffer plus
    //         room for trailing CRC bytes.
@@ -154,25 +293,28 @@ ioqueue* create_ioqueue( size_t iosz, size_t partsz, DAL_MODE mode ) {
    //   LOG( LOG_INFO, "Post spillage fill %zu does not cleanly align with subsz of %zu\n", ioq->fill_threshold - spillage, subsz );
    //   overflow = 1;
    //}
-   LOG( LOG_INFO, "Using ioblock size of %zu\n", ioq->blocksz );
+   LOG( LOG_INFO, "Using ioblock size of %zu, with depth %d ( max %d )\n", ioq->blocksz, depth, maxdepth );
    int i;
-   for ( i = 0; i < SUPER_BLOCK_CNT; i++ ) {
+   for ( i = 0; i < depth; i++ ) {
       // initialize state and struct for each ioblock
-      int allocres = posix_memalign( &(ioq->block_list[i].buff), 4096, sizeof( char ) * ioq->blocksz );
-      if ( allocres  ||  ioq->block_list[i].buff == NULL ) {
+      int allocres = posix_memalign( &(ioq->block_pool[i].buff), 4096, sizeof( char ) * ioq->blocksz );
+      if ( allocres  ||  ioq->block_pool[i].buff == NULL ) {
          // we've messed up, time to try to clean everything up
          LOG( LOG_ERR, "failed to allocate space for ioblock %d!\n", i );
          for ( i -= 1; i >= 0; i-- ) {
-            free( ioq->block_list[i].buff );
+            free( ioq->block_pool[i].buff );
          }
          pthread_cond_destroy( &(ioq->avail_block) );
          pthread_mutex_destroy( &(ioq->qlock) );
+         free( ioq->block_list );
+         free( ioq->block_pool );
          free( ioq );
          errno = allocres; // posix_memalign() does not set errno for us
          return NULL;
       }
-      ioq->block_list[i].data_size   = 0;
-      ioq->block_list[i].error_end   = 0;
+      ioq->block_pool[i].data_size   = 0;
+      ioq->block_pool[i].error_end   = 0;
+      ioq->block_list[i] = ioq->block_pool + i;
    }
    return ioq;
 }
@@ -192,18 +334,24 @@ int destroy_ioqueue( ioqueue* ioq ) {
       LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
       return -1;
    }
-   if ( ioq->depth != SUPER_BLOCK_CNT ) {
+   if ( ioq->depth != ioq->blockcnt ) {
       LOG( LOG_ERR, "Cannot destroy ioqueue struct while ioblocks are in use!\n" );
       pthread_mutex_unlock(&ioq->qlock);
       return -1;
    }
+   if ( ioq->stalls ) {
+      LOG( LOG_INFO, "IOQueue stalled %llu times ( %llu ns ), and ended with %d of at most %d ioblocks\n",
+           (unsigned long long)ioq->stalls, (unsigned long long)ioq->stallns, ioq->blockcnt, ioq->maxdepth );
+   }
    int i;
-   for ( i = 0; i < SUPER_BLOCK_CNT; i++ ) {
-      free( ioq->block_list[i].buff );
+   for ( i = 0; i < ioq->maxdepth; i++ ) {
+      if ( ioq->block_pool[i].buff ) { free( ioq->block_pool[i].buff ); }
    }
    pthread_cond_destroy( &(ioq->avail_block) );
    pthread_mutex_unlock(&ioq->qlock);
    pthread_mutex_destroy( &(ioq->qlock) );
+   free( ioq->block_list );
+   free( ioq->block_pool );
    free( ioq );
    LOG( LOG_INFO, "IOQueue successfully destroyed\n" );
    return 0;
@@ -220,7 +368,79 @@ ssize_t ioqueue_maxdata( ioqueue* ioq ) {
       LOG( LOG_ERR, "Received NULL ioqueue reference!\n" );
       return -1;
    }
-   return ( SUPER_BLOCK_CNT * ioq->split_threshold );
+   if ( pthread_mutex_lock(&ioq->qlock) ) { // aquire the queue lock
+      LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
+      return -1;
+   }
+   ssize_t maxdata = ioq->blockcnt * ioq->split_threshold;
+   pthread_mutex_unlock(&ioq->qlock);
+   return maxdata;
+}
+
+
+/**
+ * Populate a snapshot of the stall counters and depth of the given IOQueue
+ * @param ioqueue* ioq : IOQueue to retrieve stats for
+ * @param ioqueue_stats* stats : Reference to the ioqueue_stats struct to be populated
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int ioqueue_getstats( ioqueue* ioq, ioqueue_stats* stats ) {
+   if ( ioq == NULL  ||  stats == NULL ) {
+      LOG( LOG_ERR, "Received NULL ioqueue or stats reference!\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( pthread_mutex_lock(&ioq->qlock) ) { // aquire the queue lock
+      LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
+      return -1;
+   }
+   stats->stalls = ioq->stalls;
+   stats->stallns = ioq->stallns;
+   stats->grows = ioq->grows;
+   stats->shrinks = ioq->shrinks;
+   stats->depth = ioq->blockcnt;
+   stats->peakdepth = ioq->peakdepth;
+   pthread_mutex_unlock(&ioq->qlock);
+   return 0;
+}
+
+
+/**
+ * Release all unused ioblocks gained through growth of an adaptive IOQueue ( never below its initial depth )
+ * NOTE -- this is done automatically when the system runs low on memory
+ * @param ioqueue* ioq : IOQueue to be trimmed
+ * @return int : Count of released ioblocks, or -1 if an error occurred
+ */
+int trim_ioqueue( ioqueue* ioq ) {
+   if ( ioq == NULL ) {
+      LOG( LOG_ERR, "Received NULL ioqueue reference!\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   void* freelist[IOQUEUE_MAX_DEPTH];
+   int freecnt = 0;
+   if ( pthread_mutex_lock(&ioq->qlock) ) { // aquire the queue lock
+      LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
+      return -1;
+   }
+   // only available ioblocks can be removed, beginning with the next to be reserved
+   while ( ioq->blockcnt > ioq->mindepth  &&  ioq->depth > 0 ) {
+      ioblock* block = ioq->block_list[ioq->head];
+      freelist[freecnt++] = block->buff;
+      block->buff = NULL;
+      memmove( ioq->block_list + ioq->head, ioq->block_list + ioq->head + 1,
+               sizeof( ioblock* ) * ( ioq->blockcnt - ioq->head - 1 ) );
+      ioq->blockcnt--;
+      ioq->depth--;
+      ioq->shrinks++;
+      if ( ioq->head == ioq->blockcnt ) { ioq->head = 0; }
+   }
+   pthread_mutex_unlock(&ioq->qlock);
+   // free buffers outside of the queue lock
+   int i;
+   for ( i = 0; i < freecnt; i++ ) { free( freelist[i] ); }
+   if ( freecnt ) { LOG( LOG_INFO, "Released %d unused ioblocks\n", freecnt ); }
+   return freecnt;
 }
 
 
@@ -312,18 +532,47 @@ int reserve_ioblock( ioblock** cur_block, ioblock** push_block, ioqueue* ioq ) {
       return -1;
    }
    // wait for a block to be available for use
-   while ( ioq->depth == 0 ) {
+   char stalled = 0;
+   if ( ioq->depth == 0 ) {
       LOG( LOG_INFO, "Waiting for ioblock to become available\n" );
-      pthread_cond_wait( &ioq->avail_block, &ioq->qlock );
+      stalled = 1;
+      uint64_t perfbegin = perf_begin();
+      struct timespec start, end;
+      clock_gettime( CLOCK_MONOTONIC, &(start) );
+      while ( ioq->depth == 0 ) {
+         pthread_cond_wait( &ioq->avail_block, &ioq->qlock );
+      }
+      clock_gettime( CLOCK_MONOTONIC, &(end) );
+      ioq->stalls++;
+      ioq->stallns += ( (uint64_t)( end.tv_sec - start.tv_sec ) * 1000000000ULL ) + end.tv_nsec - start.tv_nsec;
+      perf_end( PERF_IOQ_STALL, perfbegin, 0 );
    }
    // update the current block to the new reference
-   (*cur_block) = &(ioq->block_list[ioq->head]);
+   (*cur_block) = ioq->block_list[ioq->head];
    // update queue values to reflect the block being in use
    ioq->depth--;
    ioq->head += 1;
-   if ( ioq->head == SUPER_BLOCK_CNT ) { ioq->head = 0; }
+   if ( ioq->head == ioq->blockcnt ) { ioq->head = 0; }
+   // adaptive queues periodically check for memory pressure, while they hold additional blocks
+   char checkmem = 0;
+   if ( ioq->blockcnt > ioq->mindepth  &&  ++(ioq->reservations) >= IOQUEUE_LOWMEM_INTERVAL ) {
+      ioq->reservations = 0;
+      checkmem = 1;
+   }
+   char grow = ( stalled  &&  ioq->blockcnt < ioq->maxdepth );
    pthread_mutex_unlock(&ioq->qlock);
 
+   // a stalled reservation implies that the queue is too shallow to hide IO latency
+   if ( grow  ||  checkmem ) {
+      if ( ioqueue_lowmem() ) {
+         LOG( LOG_WARNING, "Available memory is low, trimming ioqueue rather than growing it\n" );
+         trim_ioqueue( ioq );
+      }
+      else if ( grow ) {
+         grow_ioqueue( ioq );
+      }
+   }
+
    // clear any old values in this newly reserved block
    (*cur_block)->data_size   = 0;
    (*cur_block)->error_end   = 0;
@@ -423,17 +672,50 @@ int release_ioblock( ioqueue* ioq ) {
       LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
       return -1;
    }
-   if ( ioq->depth == SUPER_BLOCK_CNT ) {
+   if ( ioq->depth == ioq->blockcnt ) {
       LOG( LOG_ERR, "No outstanding ioblocks to be released!\n" );
       pthread_mutex_unlock(&ioq->qlock);
       return -1;
    }
    ioq->depth++;
-   LOG( LOG_INFO, "%d out of %d ioblocks available\n", ioq->depth, SUPER_BLOCK_CNT );
+   LOG( LOG_INFO, "%d out of %d ioblocks available\n", ioq->depth, ioq->blockcnt );
    pthread_cond_signal(&ioq->avail_block);
    pthread_mutex_unlock(&ioq->qlock);
    return 0;
 }
 
 
-
+/**
+ * Request that all ioblock buffers of the given IOQueue be placed on the specified NUMA node
+ * NOTE -- this is only a placement preference, and will have no effect on systems lacking NUMA support
+ * @param ioqueue* ioq : Reference to the ioqueue struct to be bound
+ * @param int node : NUMA node to bind to
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int bind_ioqueue( ioqueue* ioq, int node ) {
+   if ( node < 0  ||  node >= NUMA_MASK_LONGS * 8 * (int)sizeof(unsigned long) ) {
+      LOG( LOG_ERR, "Invalid NUMA node value: %d\n", node );
+      errno = EINVAL;
+      return -1;
+   }
+#ifdef SYS_mbind
+   if ( pthread_mutex_lock(&ioq->qlock) ) { // aquire the queue lock
+      LOG( LOG_ERR, "Failed to aquire ioqueue lock!\n" );
+      return -1;
+   }
+   ioq->numa_node = node; // any blocks added later will be bound as well
+   int i;
+   for ( i = 0; i < ioq->blockcnt; i++ ) {
+      if ( bind_buffer( ioq->block_list[i]->buff, ioq->blocksz, node ) ) {
+         LOG( LOG_WARNING, "Failed to bind ioblock %d to NUMA node %d ( %s )\n", i, node, strerror(errno) );
+         pthread_mutex_unlock(&ioq->qlock);
+         return -1;
+      }
+   }
+   LOG( LOG_INFO, "Bound %d ioblocks to NUMA node %d\n", ioq->blockcnt, node );
+   pthread_mutex_unlock(&ioq->qlock);
+#else
+   LOG( LOG_INFO, "No mbind() support, ignoring NUMA node %d\n", node );
+#endif
+   return 0;
+}
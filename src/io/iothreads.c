@@ -49,6 +49,7 @@ underlying skt_etc() functions.
 
 --------------------------------------------------------------------------- */
 
+#define _GNU_SOURCE // for CPU affinity
 #include "marfs_auto_config.h"
 #ifdef DEBUG_IO
 #define DEBUG DEBUG_IO
@@ -57,6 +58,7 @@ underlying skt_etc() functions.
 #endif
 #define LOG_PREFIX "iothreads"
 #include "logging/logging.h"
+#include "logging/perfstats.h"
 
 #include "io/io.h"
 #include "thread_queue/thread_queue.h"
@@ -76,6 +78,133 @@ underlying skt_etc() functions.
 #include <assert.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <sched.h>
+#include <ctype.h>
+
+#define NUMA_SYSFS "/sys/devices/system/node"
+#define NUMA_MAX_NODES 64 // nodes beyond this limit are ignored
+
+
+/* ------------------------------   NUMA PLACEMENT   ------------------------------ */
+
+static pthread_once_t numa_once = PTHREAD_ONCE_INIT;
+static int numa_count = 0;
+static cpu_set_t numa_cpus[NUMA_MAX_NODES];
+
+/**
+ * Parse a sysfs list string ( e.g. "0-3,8,10-11" ) into a cpu_set_t
+ * @param FILE* input : Stream to read the list from
+ * @param cpu_set_t* set : Set to be populated
+ * @return int : Number of elements parsed, or -1 on failure
+ */
+static int parse_sysfs_list(FILE* input, cpu_set_t* set) {
+   char buf[4096];
+   if (fgets(buf, sizeof(buf), input) == NULL) {
+      return -1;
+   }
+   CPU_ZERO(set);
+   int count = 0;
+   char* parse = buf;
+   while (isdigit(*parse)) {
+      char* end = NULL;
+      unsigned long low = strtoul(parse, &end, 10);
+      unsigned long high = low;
+      if (*end == '-') {
+         parse = end + 1;
+         high = strtoul(parse, &end, 10);
+      }
+      for (; low <= high && low < CPU_SETSIZE; low++) {
+         CPU_SET(low, set);
+         count++;
+      }
+      parse = end;
+      if (*parse == ',') { parse++; }
+   }
+   return count;
+}
+
+/**
+ * Populate our NUMA topology info from sysfs ( called only once )
+ */
+static void numa_discover(void) {
+   FILE* input = fopen(NUMA_SYSFS "/online", "r");
+   if (input == NULL) {
+      LOG(LOG_INFO, "No NUMA topology available ( %s )\n", strerror(errno));
+      return;
+   }
+   cpu_set_t nodes;
+   int res = parse_sysfs_list(input, &nodes);
+   fclose(input);
+   if (res <= 0) {
+      LOG(LOG_WARNING, "Failed to parse the list of online NUMA nodes\n");
+      return;
+   }
+   int node;
+   for (node = 0; node < NUMA_MAX_NODES; node++) {
+      CPU_ZERO(&(numa_cpus[node]));
+      if (!CPU_ISSET(node, &nodes)) { continue; }
+      char path[128];
+      snprintf(path, sizeof(path), NUMA_SYSFS "/node%d/cpulist", node);
+      input = fopen(path, "r");
+      if (input == NULL) {
+         LOG(LOG_WARNING, "Failed to open \"%s\" ( %s )\n", path, strerror(errno));
+         continue;
+      }
+      res = parse_sysfs_list(input, &(numa_cpus[node]));
+      fclose(input);
+      LOG(LOG_INFO, "NUMA node %d has %d CPUs\n", node, res);
+      numa_count = node + 1;
+   }
+}
+
+/**
+ * Identify the number of NUMA nodes of this system
+ * @return int : One greater than the highest online NUMA node, or zero if no topology is available
+ */
+int io_numa_nodes(void) {
+   pthread_once(&numa_once, numa_discover);
+   return numa_count;
+}
+
+/**
+ * Bind the calling thread to the CPUs of the specified NUMA node, within its current affinity
+ * @param int node : NUMA node to bind to
+ * @return int : Zero on success and -1 if an error occurred
+ */
+int io_numa_bind(int node) {
+   if (node < 0 || node >= io_numa_nodes()) {
+      LOG(LOG_ERR, "NUMA node %d is not available\n", node);
+      errno = EINVAL;
+      return -1;
+   }
+   if (CPU_COUNT(&(numa_cpus[node])) == 0) {
+      // memory-only nodes have no CPUs to run on
+      LOG(LOG_WARNING, "NUMA node %d has no CPUs\n", node);
+      errno = ENOENT;
+      return -1;
+   }
+   // never widen an affinity mask imposed on us ( e.g. by taskset or a cgroup cpuset )
+   cpu_set_t cpus;
+   int res = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &(cpus));
+   if (res) {
+      LOG(LOG_ERR, "Failed to retrieve the current CPU affinity ( %s )\n", strerror(res));
+      errno = res;
+      return -1;
+   }
+   CPU_AND(&(cpus), &(cpus), &(numa_cpus[node]));
+   if (CPU_COUNT(&(cpus)) == 0) {
+      LOG(LOG_WARNING, "None of the CPUs of NUMA node %d are within our current affinity\n", node);
+      errno = ENOENT;
+      return -1;
+   }
+   res = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &(cpus));
+   if (res) {
+      LOG(LOG_ERR, "Failed to bind to the CPUs of NUMA node %d ( %s )\n", node, strerror(res));
+      errno = res;
+      return -1;
+   }
+   return 0;
+}
 
 
 /* ------------------------------   THREAD BEHAVIOR FUNCTIONS   ------------------------------ */
@@ -117,8 +246,15 @@ int write_init(unsigned int tID, void* global_state, void** state) {
    tstate->crcsumchk = 0;
    tstate->continuous = 1;
 
+   // run on our assigned NUMA node, if any ( failure just costs locality )
+   if (gstate->numa_node >= 0 && io_numa_bind(gstate->numa_node)) {
+      LOG(LOG_WARNING, "Block %d failed to bind to NUMA node %d\n", gstate->location.block, gstate->numa_node);
+   }
+
    // open a handle for this block
+   uint64_t perfbegin = perf_begin();
    tstate->handle = dal->open(dal->ctxt, gstate->dmode, gstate->location, gstate->objID);
+   perf_end(PERF_DAL_OPEN, perfbegin, 0);
    if (tstate->handle == NULL) {
       LOG(LOG_ERR, "failed to open handle for block %d!\n", gstate->location.block);
       gstate->data_error = 1;
@@ -165,8 +301,15 @@ int read_init(unsigned int tID, void* global_state, void** state) {
       tstate->continuous = 0;
    }
 
+   // run on our assigned NUMA node, if any ( failure just costs locality )
+   if (gstate->numa_node >= 0 && io_numa_bind(gstate->numa_node)) {
+      LOG(LOG_WARNING, "Block %d failed to bind to NUMA node %d\n", gstate->location.block, gstate->numa_node);
+   }
+
    // open a handle for this block
+   uint64_t perfbegin = perf_begin();
    tstate->handle = dal->open(dal->ctxt, gstate->dmode, gstate->location, gstate->objID);
+   perf_end(PERF_DAL_OPEN, perfbegin, 0);
    if (tstate->handle == NULL) {
       LOG(LOG_WARNING, "failed to open handle for block %d, attempting meta only access\n", gstate->location.block);
       gstate->data_error = 1;
@@ -180,7 +323,10 @@ int read_init(unsigned int tID, void* global_state, void** state) {
    // skip setting minfo values if they already appear to be set
    if (gstate->minfo.totsz == 0) {
       // populate our minfo struct with obj meta values
-      if (dal->get_meta(tstate->handle, &gstate->minfo) != 0) {
+      perfbegin = perf_begin();
+      int metares = dal->get_meta(tstate->handle, &gstate->minfo);
+      perf_end(PERF_DAL_GET_META, perfbegin, 0);
+      if (metares != 0) {
          LOG(LOG_ERR, "Failed to populate all expected meta_info values!\n");
          gstate->meta_error = 1;
       }
@@ -230,7 +376,9 @@ int write_consume(void** state, void** work_todo) {
          return -1;
       }
       // calculate a CRC for this data and append it to the buffer
+      uint64_t perfbegin = perf_begin();
       *(uint32_t*)(datasrc + datasz) = crc32_ieee(CRC_SEED, datasrc, datasz);
+      perf_end(PERF_IO_CRC, perfbegin, datasz);
       // exiting critical section
       if ( pthread_mutex_unlock( gstate->erasurelock ) ) {
          LOG(LOG_ERR, "Block %d failed to release erasurelock\n", gstate->location.block);
@@ -244,11 +392,14 @@ int write_consume(void** state, void** work_todo) {
       gstate->minfo.blocksz += datasz;
 
       // write data out via the DAL, but only if we have not yet encoutered a write error
+      perfbegin = perf_begin();
       if ((gstate->data_error == 0) && gstate->dal->put(tstate->handle, datasrc, datasz)) {
+         perf_end(PERF_DAL_PUT, perfbegin, 0);
          LOG(LOG_ERR, "Failed to write %zu bytes to block %d!\n", datasz, gstate->location.block);
          gstate->data_error = 1;
          // don't bother to abort yet, we'll do that on close
       }
+      else { perf_end(PERF_DAL_PUT, perfbegin, datasz); }
    }
 
    // regardless of success, we need to free up our ioblock
@@ -331,8 +482,10 @@ int read_produce(void** state, void** work_tofill) {
       void* store_tgt = ioblock_write_target(tstate->iob);
       char data_err = 0;
       LOG(LOG_INFO, "Reading %zd bytes from offset %zu of block %d\n", to_read, tstate->offset, gstate->location.block);
-      if ((read_data = gstate->dal->get(tstate->handle, store_tgt, to_read, tstate->offset)) <
-         to_read) {
+      uint64_t perfbegin = perf_begin();
+      read_data = gstate->dal->get(tstate->handle, store_tgt, to_read, tstate->offset);
+      perf_end(PERF_DAL_GET, perfbegin, (read_data > 0) ? read_data : 0);
+      if (read_data < to_read) {
          LOG(LOG_ERR, "Expected read return value of %zd for block %d, but recieved: %zd\n",
             to_read, gstate->location.block, read_data);
          gstate->data_error = 1;
@@ -351,7 +504,9 @@ int read_produce(void** state, void** work_tofill) {
             data_err = 1;
          }
          else {
+            perfbegin = perf_begin();
             crc = crc32_ieee(CRC_SEED, store_tgt, to_read);
+            perf_end(PERF_IO_CRC, perfbegin, to_read);
             // exiting critical section
             if ( pthread_mutex_unlock( gstate->erasurelock ) ) {
                LOG(LOG_ERR, "Block %d failed to release erasurelock\n", gstate->location.block);
@@ -413,11 +568,14 @@ int read_resume(void** state, void** prev_work) {
    // check for a NULL ioq and create one if so (TODO: unnecessary?)
    if (gstate->ioq == NULL) {
       LOG(LOG_INFO, "Creating own ioqueue for block %d\n", gstate->location.block);
-      gstate->ioq = create_ioqueue(gstate->minfo.versz, gstate->minfo.partsz, gstate->dmode);
+      gstate->ioq = create_ioqueue(gstate->minfo.versz, gstate->minfo.partsz, gstate->dmode, gstate->qdepth, gstate->qdepthmax);
       if (gstate->ioq == NULL) {
          LOG(LOG_ERR, "Failed to create ioqueue!\n");
          return -1;
       }
+      if (gstate->numa_node >= 0) {
+         bind_ioqueue(gstate->ioq, gstate->numa_node); // failure only costs locality
+      }
    }
    // check for a NON-NULL work package, and release the block if so
    if (*prev_work != NULL) {
@@ -523,7 +681,10 @@ void write_term(void** state, void** prev_work, TQ_Control_Flags flg) {
    }
 
    // attempt to write out meta info
-   if (gstate->dal->set_meta(tstate->handle, &(gstate->minfo))) {
+   uint64_t perfbegin = perf_begin();
+   int metares = gstate->dal->set_meta(tstate->handle, &(gstate->minfo));
+   perf_end(PERF_DAL_SET_META, perfbegin, 0);
+   if (metares) {
       LOG(LOG_ERR, "Failed to set meta value for block %d!\n", gstate->location.block);
       gstate->meta_error = 1;
    }
@@ -537,13 +698,18 @@ void write_term(void** state, void** prev_work, TQ_Control_Flags flg) {
       // just in case, be CERTAIN to note this as a failure
       gstate->meta_error = 1;
       gstate->data_error = 1;
+      perfbegin = perf_begin();
       if (tstate->handle  &&  gstate->dal->abort(tstate->handle)) {
          LOG(LOG_ERR, "Abort of block %d failed!\n", gstate->location.block);
          // not really much to do besides complain
       }
+      perf_end(PERF_DAL_ABORT, perfbegin, 0);
    }
    else if ( tstate->handle ) { // attempt to close our block
-      if ( gstate->dal->close(tstate->handle) ) {
+      perfbegin = perf_begin();
+      int closeres = gstate->dal->close(tstate->handle);
+      perf_end(PERF_DAL_CLOSE, perfbegin, 0);
+      if ( closeres ) {
          LOG(LOG_ERR, "Failed to close block %d!\n", gstate->location.block);
          gstate->data_error = 1;
          if (gstate->dal->abort(tstate->handle)) {
@@ -592,7 +758,10 @@ void read_term(void** state, void** prev_work, TQ_Control_Flags flg) {
    }
 
    // close our DAL handle
-   if (gstate->dal->close(tstate->handle)) {
+   uint64_t perfbegin = perf_begin();
+   int closeres = gstate->dal->close(tstate->handle);
+   perf_end(PERF_DAL_CLOSE, perfbegin, 0);
+   if (closeres) {
       // pessimistically call this a data erorr ( may not be necessary )
       gstate->data_error = 1;
       LOG(LOG_ERR, "Failed to close read handle for block %d!\n", gstate->location.block);
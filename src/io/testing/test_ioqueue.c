@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 
 // sentinel values to ensure good data transfer
@@ -183,7 +184,7 @@ size_t verify_data( size_t prev_ver, size_t partsz, size_t buffsz, void* buffer,
 int test_values( size_t iosz, size_t partsz, DAL_MODE mode ) {
    printf( "\nTesting queue with iosz=%zu / partsz=%zu / mode=%s\n", iosz, partsz, (mode == DAL_READ) ? "read" : "write" );
    // create a new ioqueue
-   ioqueue* ioq = create_ioqueue( iosz, partsz, mode );
+   ioqueue* ioq = create_ioqueue( iosz, partsz, mode, 0, 0 );
    if ( ioq == NULL ) {
       printf( "ERROR: Failed to create new ioqueue with iosz=%zu and partsz=%zu\n", iosz, partsz );
       return -1;
@@ -298,6 +299,119 @@ int test_values( size_t iosz, size_t partsz, DAL_MODE mode ) {
 
 
 
+void* delayed_release( void* arg ) {
+   ioqueue* ioq = (ioqueue*)arg;
+   usleep( 20000 );
+   if ( release_ioblock( ioq ) ) {
+      printf( "ERROR: delayed release of ioblock failed!\n" );
+   }
+   return NULL;
+}
+
+
+
+int test_adaptive( size_t iosz, size_t partsz ) {
+   printf( "\nTesting adaptive queue with iosz=%zu / partsz=%zu\n", iosz, partsz );
+   ioqueue* ioq = create_ioqueue( iosz, partsz, DAL_WRITE, 2, 4 );
+   if ( ioq == NULL ) {
+      printf( "ERROR: Failed to create new adaptive ioqueue\n" );
+      return -1;
+   }
+   if ( ioq->blockcnt != 2  ||  ioq->maxdepth != 4 ) {
+      printf( "ERROR: Unexpected initial depth of adaptive ioqueue ( %d of %d )\n", ioq->blockcnt, ioq->maxdepth );
+      return -1;
+   }
+   // reserve and fill both blocks of the queue
+   ioblock* cur_block = NULL;
+   ioblock* push_block = NULL;
+   if ( reserve_ioblock( &cur_block, &push_block, ioq ) ) {
+      printf( "ERROR: unexpected return value for initial ioblock reservation!\n" );
+      return -1;
+   }
+   ioblock* first = cur_block;
+   ioblock_update_fill( cur_block, ioq->split_threshold, 0 );
+   if ( reserve_ioblock( &cur_block, &push_block, ioq ) != 1  ||  push_block != first ) {
+      printf( "ERROR: unexpected result of second ioblock reservation!\n" );
+      return -1;
+   }
+   ioblock* second = cur_block;
+   ioblock_update_fill( cur_block, ioq->split_threshold, 0 );
+   // the next reservation must stall, until the first block is released
+   pthread_t releaser;
+   if ( pthread_create( &releaser, NULL, delayed_release, ioq ) ) {
+      printf( "ERROR: failed to start releaser thread\n" );
+      return -1;
+   }
+   if ( reserve_ioblock( &cur_block, &push_block, ioq ) != 1  ||  push_block != second  ||  cur_block != first ) {
+      printf( "ERROR: unexpected result of stalled ioblock reservation!\n" );
+      return -1;
+   }
+   pthread_join( releaser, NULL );
+   ioqueue_stats stats;
+   if ( ioqueue_getstats( ioq, &stats ) ) {
+      printf( "ERROR: failed to retrieve ioqueue stats\n" );
+      return -1;
+   }
+   printf( "Queue stalled %llu times ( %llu ns ), grew %u times\n",
+           (unsigned long long)stats.stalls, (unsigned long long)stats.stallns, stats.grows );
+   if ( stats.stalls != 1  ||  stats.stallns == 0  ||  stats.depth != 2 + (int)stats.grows  ||  stats.grows > 1 ) {
+      printf( "ERROR: unexpected stats following a stalled reservation!\n" );
+      return -1;
+   }
+   if ( stats.grows ) {
+      // the new block must be next in line, ahead of the block still in use
+      ioblock_update_fill( cur_block, ioq->split_threshold, 0 );
+      if ( reserve_ioblock( &cur_block, &push_block, ioq ) != 1  ||  push_block != first  ||
+           cur_block == first  ||  cur_block == second  ||  cur_block->buff == NULL ) {
+         printf( "ERROR: unexpected result of reservation from a grown ioqueue!\n" );
+         return -1;
+      }
+      if ( ioqueue_maxdata( ioq ) != 3 * ioq->split_threshold ) {
+         printf( "ERROR: unexpected maxdata value for a grown ioqueue!\n" );
+         return -1;
+      }
+   }
+   // release all outstanding blocks
+   while ( release_ioblock( ioq ) == 0 ) {}
+   if ( ioq->depth != ioq->blockcnt ) {
+      printf( "ERROR: ioblocks remain in use after release!\n" );
+      return -1;
+   }
+   // trimming must return the queue to its initial depth
+   if ( trim_ioqueue( ioq ) != (int)stats.grows  ||  ioq->blockcnt != 2  ||  ioq->depth != 2 ) {
+      printf( "ERROR: unexpected result of ioqueue trim!\n" );
+      return -1;
+   }
+   // the remaining blocks must still cycle through the ring
+   cur_block = NULL;
+   int i;
+   for ( i = 0; i < 4; i++ ) {
+      ioblock* prev = cur_block;
+      if ( cur_block ) { ioblock_update_fill( cur_block, ioq->split_threshold, 0 ); }
+      if ( reserve_ioblock( &cur_block, &push_block, ioq ) < 0  ||  cur_block->buff == NULL  ||  cur_block == prev ) {
+         printf( "ERROR: unexpected reservation from a trimmed ioqueue!\n" );
+         return -1;
+      }
+      if ( prev  &&  release_ioblock( ioq ) ) {
+         printf( "ERROR: unexpected return from release_ioblock!\n" );
+         return -1;
+      }
+   }
+   if ( release_ioblock( ioq )  ||  destroy_ioqueue( ioq ) ) {
+      printf( "ERROR: failed to cleanup trimmed ioqueue!\n" );
+      return -1;
+   }
+   // a fixed depth queue must never grow
+   ioq = create_ioqueue( iosz, partsz, DAL_WRITE, 3, 2 );
+   if ( ioq == NULL  ||  ioq->blockcnt != 3  ||  ioq->maxdepth != 3  ||  destroy_ioqueue( ioq ) ) {
+      printf( "ERROR: unexpected depth values of a fixed depth ioqueue!\n" );
+      return -1;
+   }
+   return 0;
+}
+
+
+
 int main( int argc, char** argv ) {
    // Test read IOQueue with a small partsz and larger, aligned iosz
    size_t iosz = 8196;
@@ -332,6 +446,10 @@ int main( int argc, char** argv ) {
    mode = DAL_WRITE;
    if ( test_values( iosz, partsz, mode ) ) { return -1; }
 
+   // Test growth and trimming of an adaptive IOQueue
+   iosz = 8196;
+   if ( test_adaptive( iosz, partsz ) ) { return -1; }
+
    return 0;
 }
 
@@ -84,9 +84,10 @@ int main( int argc, char** argv ) {
    gstate.minfo.totsz = 0;
    gstate.meta_error = 0;
    gstate.data_error = 0;
+   gstate.numa_node = -1;
 
    // create an ioqueue for our data blocks
-   gstate.ioq = create_ioqueue( gstate.minfo.versz, gstate.minfo.partsz, gstate.dmode );
+   gstate.ioq = create_ioqueue( gstate.minfo.versz, gstate.minfo.partsz, gstate.dmode, 0, 0 );
    if ( gstate.ioq == NULL ) {
       printf( "Failed to create IOQueue for write thread!\n" );
       return -1;
@@ -196,7 +197,7 @@ int main( int argc, char** argv ) {
    printf( "done\n" );
 
    // create our ioqueue (based on minfo values gathered by the read thread)
-   gstate.ioq = create_ioqueue( gstate.minfo.versz, gstate.minfo.partsz, gstate.dmode );
+   gstate.ioq = create_ioqueue( gstate.minfo.versz, gstate.minfo.partsz, gstate.dmode, 0, 0 );
    if ( gstate.ioq == NULL ) {
       printf( "Failed to create ioqueue for read!\n" );
       return -1;
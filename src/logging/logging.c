@@ -2,8 +2,343 @@
 
 #include <stdlib.h>             // malloc()
 #include <string.h>
+#include <strings.h>            // strcasecmp()
+#include <errno.h>
+#include <time.h>
+#include <sched.h>              // sched_yield()
 #include <assert.h>
 
+// NOTE -- This source is linked into several of our libraries.  All state is kept in
+//         the single, non-static log_state struct, so that the dynamic linker resolves
+//         every copy to one instance.
+//
+// Messages are formatted by the logging thread into a ring of fixed-size slots owned by
+// that thread ( single producer, single consumer ), then output to stderr by a background
+// drain thread.  A thread only blocks if its own ring is full.  Ordering is preserved per
+// thread, but messages of different threads may interleave differently than they were
+// logged.  Buffered messages are lost if the process dies abnormally, so set
+// MARFS_LOG_SYNC in the environment to fall back to immediate, synchronous output.
+
+#define LOG_RING_SLOTS   64     // depth of each per-thread ring
+#define LOG_SLOT_SIZE    1024   // max length of a single message ( longer are truncated )
+#define LOG_DRAIN_MSEC   10     // max delay of the drain thread between passes
+
+typedef struct log_ring_struct {
+   size_t head;   // next slot to fill  ( written only by the owning thread )
+   size_t tail;   // next slot to drain ( written only by the drain thread )
+   int    inuse;  // non-zero while claimed by a live thread
+   struct log_ring_struct* next; // rings are never freed
+   unsigned short lens[LOG_RING_SLOTS];
+   char   slots[LOG_RING_SLOTS][LOG_SLOT_SIZE];
+} log_ring;
+
+// verbosity override, from MARFS_LOG_LEVELS or log_setlevel() ( later rules take precedence )
+typedef struct log_rule_struct {
+   char* name; // subsystem name, or NULL for all
+   int   level;
+   struct log_rule_struct* next;
+} log_rule;
+
+struct log_state_struct {
+   pthread_once_t  once;
+   pthread_mutex_t lock;    // guards all members below, save 'rings'
+   pthread_cond_t  wake;    // signals the drain thread
+   pthread_cond_t  drained; // signaled on completion of each drain pass
+   pthread_key_t   ringkey;
+   int             keyvalid;
+   log_ring*       rings;
+   log_subsys*     subsystems;
+   log_rule*       rules;
+   pthread_t       drainer;
+   char            running;
+   char            stop;
+   char            pending;
+   unsigned long   passes;
+   char            finalized;
+} log_state = {
+   .once = PTHREAD_ONCE_INIT,
+   .lock = PTHREAD_MUTEX_INITIALIZER,
+   .wake = PTHREAD_COND_INITIALIZER,
+   .drained = PTHREAD_COND_INITIALIZER,
+   .keyvalid = 0,
+   .rings = NULL,
+   .subsystems = NULL,
+   .rules = NULL,
+   .running = 0,
+   .stop = 0,
+   .pending = 0,
+   .passes = 0,
+   .finalized = 0
+};
+
+
+//   -------------   INTERNAL FUNCTIONS    -------------
+
+/**
+ * Parse a syslog priority, either by name ( e.g. "warning" ) or by value ( e.g. "4" )
+ * @param const char* str : String to be parsed
+ * @param size_t len : Length of the string
+ * @return int : Parsed priority, or -1 if unrecognized
+ */
+int log_parselevel( const char* str, size_t len ) {
+   static const char* names[] = { "emerg", "alert", "crit", "err", "warning", "notice", "info", "debug" };
+   if ( len == 1  &&  *str >= '0'  &&  *str <= '7' ) { return *str - '0'; }
+   int level = 0;
+   for ( ; level <= LOG_DEBUG; level++ ) {
+      if ( strlen( names[level] ) == len  &&  strncasecmp( str, names[level], len ) == 0 ) { return level; }
+   }
+   if ( len == 5  &&  strncasecmp( str, "error", 5 ) == 0 ) { return LOG_ERR; }
+   return -1;
+}
+
+/**
+ * Append a verbosity rule, replacing any prior rule for the same name
+ * NOTE -- caller must hold log_state.lock
+ * @param const char* name : Subsystem name, or NULL for all subsystems
+ * @param size_t len : Length of the subsystem name
+ * @param int level : Verbosity of the rule
+ * @return int : Zero on success, or -1 on failure
+ */
+int log_addrule( const char* name, size_t len, int level ) {
+   log_rule* rule = malloc( sizeof( struct log_rule_struct ) );
+   if ( rule == NULL ) { return -1; }
+   rule->name = NULL;
+   if ( name  &&  (rule->name = strndup( name, len )) == NULL ) { free( rule ); return -1; }
+   rule->level = level;
+   rule->next = NULL;
+   // a global rule overrides every prior rule, and a named rule overrides prior ones of that name
+   log_rule** prev = &(log_state.rules);
+   while ( *prev ) {
+      log_rule* cur = *prev;
+      if ( name == NULL  ||  ( cur->name  &&  strcmp( cur->name, rule->name ) == 0 ) ) {
+         *prev = cur->next;
+         free( cur->name );
+         free( cur );
+         continue;
+      }
+      prev = &(cur->next);
+   }
+   *prev = rule;
+   return 0;
+}
+
+/**
+ * Identify the configured verbosity of the given subsystem
+ * NOTE -- caller must hold log_state.lock
+ * @param log_subsys* subsys : Subsystem to check
+ * @return int : Configured verbosity
+ */
+int log_lookuplevel( log_subsys* subsys ) {
+   int level = subsys->deflevel;
+   log_rule* rule = log_state.rules;
+   for ( ; rule; rule = rule->next ) {
+      if ( rule->name == NULL  ||  strcmp( rule->name, subsys->name ) == 0 ) { level = rule->level; }
+   }
+   return level;
+}
+
+/**
+ * Output all buffered messages of every ring
+ * NOTE -- only to be called by the drain thread, or once it has terminated
+ */
+void log_drainrings( void ) {
+   log_ring* ring = __atomic_load_n( &(log_state.rings), __ATOMIC_ACQUIRE );
+   int wrote = 0;
+   for ( ; ring; ring = ring->next ) {
+      size_t tail = ring->tail;
+      size_t head = __atomic_load_n( &(ring->head), __ATOMIC_ACQUIRE );
+      for ( ; tail != head; tail++ ) {
+         size_t slot = tail % LOG_RING_SLOTS;
+         fwrite( ring->slots[slot], 1, ring->lens[slot], stderr );
+         wrote = 1;
+      }
+      __atomic_store_n( &(ring->tail), tail, __ATOMIC_RELEASE );
+   }
+   if ( wrote ) { fflush( stderr ); }
+}
+
+/**
+ * Background drain thread, outputting buffered messages until told to stop
+ * @param void* arg : Unused
+ * @return void* : Always NULL
+ */
+void* log_drainthread( void* arg ) {
+   pthread_mutex_lock( &(log_state.lock) );
+   while ( 1 ) {
+      if ( !(log_state.pending)  &&  !(log_state.stop) ) {
+         struct timespec deadline;
+         clock_gettime( CLOCK_REALTIME, &deadline );
+         deadline.tv_nsec += LOG_DRAIN_MSEC * 1000000L;
+         if ( deadline.tv_nsec >= 1000000000L ) { deadline.tv_sec++; deadline.tv_nsec -= 1000000000L; }
+         pthread_cond_timedwait( &(log_state.wake), &(log_state.lock), &deadline );
+      }
+      char stop = log_state.stop;
+      log_state.pending = 0;
+      pthread_mutex_unlock( &(log_state.lock) );
+      log_drainrings();
+      pthread_mutex_lock( &(log_state.lock) );
+      log_state.passes++;
+      pthread_cond_broadcast( &(log_state.drained) );
+      if ( stop ) { break; }
+   }
+   pthread_mutex_unlock( &(log_state.lock) );
+   return NULL;
+}
+
+/**
+ * Release the ring of an exiting thread, so that a later thread may reuse it
+ * @param void* arg : Ring to be released
+ */
+void log_releasering( void* arg ) {
+   log_ring* ring = (log_ring*)arg;
+   __atomic_store_n( &(ring->inuse), 0, __ATOMIC_RELEASE );
+}
+
+/**
+ * Retrieve the ring of the calling thread, claiming an idle or new one if necessary
+ * @return log_ring* : Reference to the thread's ring, or NULL on failure
+ */
+log_ring* log_getring( void ) {
+   if ( !(log_state.keyvalid) ) { return NULL; }
+   log_ring* ring = pthread_getspecific( log_state.ringkey );
+   if ( ring ) { return ring; }
+   // attempt to reuse the ring of an exited thread ( any messages it left are still drained in order )
+   for ( ring = __atomic_load_n( &(log_state.rings), __ATOMIC_ACQUIRE ); ring; ring = ring->next ) {
+      int idle = 0;
+      if ( __atomic_load_n( &(ring->inuse), __ATOMIC_RELAXED ) == 0  &&
+           __atomic_compare_exchange_n( &(ring->inuse), &(idle), 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) {
+         break;
+      }
+   }
+   if ( ring == NULL ) {
+      ring = calloc( 1, sizeof( struct log_ring_struct ) );
+      if ( ring == NULL ) { return NULL; }
+      ring->inuse = 1;
+      ring->next = __atomic_load_n( &(log_state.rings), __ATOMIC_RELAXED );
+      while ( !__atomic_compare_exchange_n( &(log_state.rings), &(ring->next), ring, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED ) ) {}
+   }
+   if ( pthread_setspecific( log_state.ringkey, ring ) ) {
+      __atomic_store_n( &(ring->inuse), 0, __ATOMIC_RELEASE );
+      return NULL;
+   }
+   return ring;
+}
+
+/**
+ * Fork handler, reverting the child to synchronous output ( it has no drain thread )
+ */
+void log_atforkchild( void ) {
+   pthread_mutex_init( &(log_state.lock), NULL );
+   pthread_cond_init( &(log_state.wake), NULL );
+   pthread_cond_init( &(log_state.drained), NULL );
+   log_state.running = 0;
+}
+
+/**
+ * One-time initialization, parsing the environment and starting the drain thread
+ * NOTE -- must never produce log output ( or call any public function of this file )
+ */
+void log_init( void ) {
+   pthread_mutex_lock( &(log_state.lock) );
+   // parse MARFS_LOG_LEVELS, of the form "<name>=<level>[,<name>=<level>...]" ( name '*' for all )
+   const char* levels = getenv( "MARFS_LOG_LEVELS" );
+   while ( levels  &&  *levels ) {
+      const char* end = strchr( levels, ',' );
+      if ( end == NULL ) { end = levels + strlen( levels ); }
+      const char* sep = memchr( levels, '=', end - levels );
+      if ( sep ) {
+         int level = log_parselevel( sep + 1, end - (sep + 1) );
+         if ( level >= 0 ) {
+            if ( sep - levels == 1  &&  *levels == '*' ) { log_addrule( NULL, 0, level ); }
+            else { log_addrule( levels, sep - levels, level ); }
+         }
+      }
+      levels = ( *end ) ? end + 1 : end;
+   }
+   // start the drain thread, unless synchronous output was requested
+   const char* sync = getenv( "MARFS_LOG_SYNC" );
+   if ( ( sync == NULL  ||  strcmp( sync, "0" ) == 0 )  &&
+        pthread_key_create( &(log_state.ringkey), log_releasering ) == 0 ) {
+      log_state.keyvalid = 1;
+      if ( pthread_create( &(log_state.drainer), NULL, log_drainthread, NULL ) == 0 ) {
+         log_state.running = 1;
+         pthread_atfork( NULL, NULL, log_atforkchild );
+      }
+   }
+   pthread_mutex_unlock( &(log_state.lock) );
+}
+
+__attribute__((destructor))
+void log_fini( void ) {
+   // every library copy registers this destructor, but only the first should act
+   if ( __atomic_exchange_n( &(log_state.finalized), 1, __ATOMIC_ACQ_REL ) ) { return; }
+   pthread_mutex_lock( &(log_state.lock) );
+   char running = log_state.running;
+   log_state.running = 0;
+   log_state.stop = 1;
+   pthread_cond_signal( &(log_state.wake) );
+   pthread_mutex_unlock( &(log_state.lock) );
+   if ( running ) { pthread_join( log_state.drainer, NULL ); }
+   // output anything logged while the drain thread was exiting
+   log_drainrings();
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+int log_register( log_subsys* subsys ) {
+   pthread_once( &(log_state.once), log_init );
+   pthread_mutex_lock( &(log_state.lock) );
+   int level = subsys->level;
+   if ( level < 0 ) {
+      subsys->next = log_state.subsystems;
+      log_state.subsystems = subsys;
+      level = log_lookuplevel( subsys );
+      __atomic_store_n( &(subsys->level), level, __ATOMIC_RELAXED );
+   }
+   pthread_mutex_unlock( &(log_state.lock) );
+   return level;
+}
+
+int log_setlevel( const char* prefix, int level ) {
+   if ( level < LOG_EMERG  ||  level > LOG_DEBUG ) {
+      errno = EINVAL;
+      return -1;
+   }
+   pthread_once( &(log_state.once), log_init );
+   pthread_mutex_lock( &(log_state.lock) );
+   if ( log_addrule( prefix, (prefix) ? strlen( prefix ) : 0, level ) ) {
+      pthread_mutex_unlock( &(log_state.lock) );
+      errno = ENOMEM;
+      return -1;
+   }
+   log_subsys* subsys = log_state.subsystems;
+   for ( ; subsys; subsys = subsys->next ) {
+      if ( prefix == NULL  ||  strcmp( prefix, subsys->name ) == 0 ) {
+         __atomic_store_n( &(subsys->level), level, __ATOMIC_RELAXED );
+      }
+   }
+   pthread_mutex_unlock( &(log_state.lock) );
+   return 0;
+}
+
+void log_flush( void ) {
+   pthread_once( &(log_state.once), log_init );
+   pthread_mutex_lock( &(log_state.lock) );
+   if ( log_state.running ) {
+      // a pass already in progress may have missed our messages, so wait for the one after it
+      unsigned long target = log_state.passes + 2;
+      while ( log_state.running  &&  log_state.passes < target ) {
+         log_state.pending = 1;
+         pthread_cond_signal( &(log_state.wake) );
+         pthread_cond_wait( &(log_state.drained), &(log_state.lock) );
+      }
+   }
+   pthread_mutex_unlock( &(log_state.lock) );
+   fflush( stderr );
+}
+
 // only defined/used when not USE_SYSLOG
 //
 // QUESTION: Do we really want fuse to abort routines with error-codes
@@ -14,31 +349,54 @@ ssize_t printf_log(size_t prio, const char* format, ...) {
    va_list list;
    va_start(list, format);
 
-#if 0
-   // COMMENTED OUT.  This is now handled in the LOG() macro
-   ssize_t written;
-   if (prio <= LOG_ERR) {
-      const char*  stand_out = "*** ERROR ";
-      const size_t stand_out_len = strlen(stand_out);
-      const size_t format_len = strlen(format);
-
-      char* tmp_buf = malloc(format_len + stand_out_len +1);
-      assert(tmp_buf);
-
-      memcpy(tmp_buf, stand_out, stand_out_len);
-      memcpy(tmp_buf + stand_out_len, format, format_len);
-      tmp_buf[stand_out_len + format_len] = 0;
+   pthread_once( &(log_state.once), log_init );
+   log_ring* ring = NULL;
+   if ( __atomic_load_n( &(log_state.running), __ATOMIC_RELAXED ) ) { ring = log_getring(); }
+   if ( ring == NULL ) {
+      // synchronous output
+      ssize_t written = vfprintf(stderr, format, list);
+      va_end(list);
+      fflush(stderr);
+      return written;
+   }
 
-      written = vfprintf(stderr, tmp_buf, list);
-      free(tmp_buf);
+   // wait for a free slot in our ring
+   size_t head = ring->head;
+   while ( head - __atomic_load_n( &(ring->tail), __ATOMIC_ACQUIRE ) >= LOG_RING_SLOTS ) {
+      pthread_mutex_lock( &(log_state.lock) );
+      char running = log_state.running;
+      log_state.pending = 1;
+      pthread_cond_signal( &(log_state.wake) );
+      pthread_mutex_unlock( &(log_state.lock) );
+      if ( !(running) ) {
+         // the drain thread is gone ( process exit ), so output directly
+         ssize_t written = vfprintf(stderr, format, list);
+         va_end(list);
+         fflush(stderr);
+         return written;
+      }
+      sched_yield();
    }
-   else {
-      written = vfprintf(stderr, format, list);
+
+   size_t slot = head % LOG_RING_SLOTS;
+   int written = vsnprintf( ring->slots[slot], LOG_SLOT_SIZE, format, list );
+   va_end(list);
+   if ( written < 0 ) { return written; }
+   size_t len = written;
+   if ( len >= LOG_SLOT_SIZE ) {
+      // truncated, but keep the line terminated
+      len = LOG_SLOT_SIZE - 1;
+      ring->slots[slot][len - 1] = '\n';
    }
-#else
-   ssize_t written = vfprintf(stderr, format, list);
-#endif
+   ring->lens[slot] = (unsigned short)len;
+   __atomic_store_n( &(ring->head), head + 1, __ATOMIC_RELEASE );
 
-   fflush(stderr);
+   // get errors out promptly
+   if ( prio <= LOG_ERR ) {
+      pthread_mutex_lock( &(log_state.lock) );
+      log_state.pending = 1;
+      pthread_cond_signal( &(log_state.wake) );
+      pthread_mutex_unlock( &(log_state.lock) );
+   }
    return written;
 }
@@ -42,22 +42,66 @@ extern "C" {
 // size of longest file-name string, plus some
 #define LOG_FNAME_SIZE 20
 
+// padding following the file-name, resolved at compile-time
+#define LOG_FNAME_PAD  (LOG_FNAME_SIZE - (int)(sizeof(__FILE__) - 1))
 
 
+
+// Every translation unit with DEBUG enabled gets its own subsystem reference, named by
+// LOG_PREFIX, with a verbosity that can be adjusted at runtime via log_setlevel() or via
+// a MARFS_LOG_LEVELS environment variable ( e.g. "datastream=7,ne=3,*=4" ).  The default
+// level of each subsystem reflects its DEBUG value ( 1 = all, 2 = warnings, else errors ).
+typedef struct log_subsys_struct {
+   const char* name;
+   int         level;    // current verbosity, or -1 if not yet registered
+   int         deflevel; // verbosity to use if none is configured
+   struct log_subsys_struct* next;
+} log_subsys;
+
+   int log_register(log_subsys* subsys);
+
+   static inline int log_level(log_subsys* subsys) {
+      int level = __atomic_load_n(&(subsys->level), __ATOMIC_RELAXED);
+      if ( __builtin_expect(level < 0, 0) ) { level = log_register(subsys); }
+      return level;
+   }
+
+   /**
+    * Adjust the verbosity of a logging subsystem at runtime
+    * @param const char* prefix : LOG_PREFIX of the subsystem, or NULL for all subsystems
+    * @param int level : New maximum priority to output ( e.g. LOG_INFO )
+    * @return int : Zero on success, or -1 on failure
+    */
+   int log_setlevel(const char* prefix, int level);
+
+   /**
+    * Wait for all buffered log messages to be output
+    */
+   void log_flush(void);
+
+   ssize_t printf_log(size_t prio, const char* format, ...);
+
+#if (DEBUG)
+static log_subsys log_local_subsys __attribute__((unused)) = {
+   .name = LOG_PREFIX,
+   .level = -1,
+   .deflevel = ( DEBUG == 1 ) ? LOG_DEBUG : ( ( DEBUG == 2 ) ? LOG_WARNING : LOG_ERR ),
+   .next = NULL
+};
+#endif
+
 #if (DEBUG) && (defined USE_SYSLOG)
 // calling syslog() as a regular user on rrz seems to be an expensive no-op
 // #  define INIT_LOG()  openlog(LOG_PREFIX, LOG_CONS|LOG_PERROR, LOG_USER)
 #  define INIT_LOG()  openlog(LOG_PREFIX, LOG_CONS|LOG_PID, LOG_USER)
 
 #  define LOG(PRIO, FMT, ...)                                              \
-   if ( DEBUG == 1  ||                                                     \
-        ( DEBUG == 2  &&  PRIO <= LOG_WARNING )  ||                        \
-        ( PRIO <= LOG_ERR ) ) {                                            \
+   if ( (PRIO) <= log_level(&log_local_subsys) ) {                         \
       syslog((PRIO), xFMT FMT,                                             \
              LOG_PREFIX,                                                   \
              (unsigned int)pthread_self(),                                 \
              __FILE__, __LINE__,                                           \
-             LOG_FNAME_SIZE-(int)strlen(__FILE__), "",                     \
+             LOG_FNAME_PAD, "",                                            \
              __func__,                                                     \
              (((PRIO)<=LOG_ERR) ? "#ERR " : ""), ## __VA_ARGS__);          \
    }
@@ -65,23 +109,21 @@ extern "C" {
 #elif (DEBUG)
 // must start fuse with '-f' in order to allow stdout/stderr to work
 // NOTE: print_log call merges LOG_PREFIX w/ user format at compile-time
+//       Messages are formatted into a per-thread buffer and output by a background
+//       thread ( set MARFS_LOG_SYNC in the environment to write them immediately ).
 #  define INIT_LOG()
 
 #  define LOG(PRIO, FMT, ...)                                              \
-   if ( DEBUG == 1  ||                                                     \
-        ( DEBUG == 2  &&  PRIO <= LOG_WARNING )  ||                        \
-        ( PRIO <= LOG_ERR ) ) {                                            \
+   if ( (PRIO) <= log_level(&log_local_subsys) ) {                         \
       printf_log((PRIO), xFMT FMT,                                         \
                  LOG_PREFIX,                                               \
                  (unsigned int)pthread_self(),                             \
                  __FILE__, __LINE__,                                       \
-                 LOG_FNAME_SIZE-(int)strlen(__FILE__), "",                 \
+                 LOG_FNAME_PAD, "",                                        \
                  __func__,                                                 \
                  (((PRIO)<=LOG_ERR) ? "#ERR " : ""), ## __VA_ARGS__);      \
    }
 
-   ssize_t printf_log(size_t prio, const char* format, ...);
-
 #else
 // Without DEBUG, these become no-ops
 #  define INIT_LOG()
@@ -0,0 +1,462 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "logging/perfstats.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+// NOTE -- This source is linked into several of our libraries.  All state is kept in
+//         the single, non-static perf_state struct, so that the dynamic linker resolves
+//         every copy to one instance.
+
+#define PERF_TRACE_EVENTS 4096 // depth of each per-thread trace buffer
+#define PERF_DEFAULT_INTERVAL 10
+
+static const char* perf_names[PERF_PROBE_COUNT] = {
+   "marfs_creat", "marfs_open", "marfs_read", "marfs_write", "marfs_close", "marfs_release",
+   "datastream_create", "datastream_open", "datastream_read", "datastream_write",
+   "datastream_close", "datastream_release", "datastream_objclose",
+   "ne_open", "ne_write", "read_stripes", "ne_close", "erasure_encode", "erasure_decode", "crc", "ioq_stall",
+   "dal_open", "dal_put", "dal_get", "dal_set_meta", "dal_get_meta", "dal_close", "dal_abort"
+};
+
+static const char* perf_categories[PERF_PROBE_COUNT] = {
+   "api", "api", "api", "api", "api", "api",
+   "datastream", "datastream", "datastream", "datastream", "datastream", "datastream", "datastream",
+   "ne", "ne", "ne", "ne", "ne", "ne", "io", "io",
+   "dal", "dal", "dal", "dal", "dal", "dal", "dal"
+};
+
+typedef struct perf_event_struct {
+   uint64_t   begin;
+   uint64_t   end;
+   perf_probe probe;
+} perf_event;
+
+// Per-thread counters and trace buffer
+//    Counters are only ever written by the one thread which has claimed the slab ( plain
+//    relaxed atomic load/store pairs ), allowing snapshots while the process is running.
+//    The trace buffer is only touched when tracing, and is guarded by 'eventlock'.
+typedef struct perf_slab_struct {
+   uint64_t        calls[PERF_PROBE_COUNT];
+   uint64_t        nsecs[PERF_PROBE_COUNT];
+   uint64_t        bytes[PERF_PROBE_COUNT];
+   pthread_mutex_t eventlock;
+   perf_event      events[PERF_TRACE_EVENTS];
+   size_t          eventcount;
+   unsigned int    tid;
+   int             inuse; // non-zero while claimed by a live thread
+   struct perf_slab_struct* next; // slabs are never freed
+} perf_slab;
+
+struct perf_state_struct {
+   pthread_once_t  once;
+   pthread_key_t   slabkey;
+   int             keyvalid;
+   perf_slab*      slabs;
+   // trace output
+   pthread_mutex_t tracelock;
+   FILE*           trace;
+   char            tracefirst;
+   // stats output
+   pthread_mutex_t statsctllock; // serializes start / stop of the stats thread ( held across joins )
+   pthread_mutex_t statslock;
+   pthread_cond_t  statscond;
+   pthread_t       statsthread;
+   char            statsrunning;
+   char            statsstop;
+   char*           statspath;
+   unsigned int    interval;
+   char            finalized;
+} perf_state = {
+   .once = PTHREAD_ONCE_INIT,
+   .keyvalid = 0,
+   .slabs = NULL,
+   .tracelock = PTHREAD_MUTEX_INITIALIZER,
+   .trace = NULL,
+   .tracefirst = 1,
+   .statsctllock = PTHREAD_MUTEX_INITIALIZER,
+   .statslock = PTHREAD_MUTEX_INITIALIZER,
+   .statscond = PTHREAD_COND_INITIALIZER,
+   .statsrunning = 0,
+   .statsstop = 0,
+   .statspath = NULL,
+   .interval = PERF_DEFAULT_INTERVAL,
+   .finalized = 0
+};
+
+int perf_flags = 0;
+
+
+//   -------------   INTERNAL FUNCTIONS    -------------
+
+/**
+ * Output all buffered trace events of the given slab
+ * NOTE -- caller must hold the slab's eventlock
+ * @param perf_slab* slab : Slab to output the events of
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_flushslab( perf_slab* slab ) {
+   int retval = 0;
+   pthread_mutex_lock( &(perf_state.tracelock) );
+   if ( perf_state.trace ) {
+      pid_t pid = getpid();
+      size_t index = 0;
+      for ( ; index < slab->eventcount; index++ ) {
+         perf_event* event = slab->events + index;
+         if ( fprintf( perf_state.trace,
+                       "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                       (perf_state.tracefirst) ? "\n" : ",\n",
+                       perf_names[event->probe], perf_categories[event->probe], (int)pid, slab->tid,
+                       event->begin / 1000.0, (event->end - event->begin) / 1000.0 ) < 0 ) {
+            retval = -1;
+            break;
+         }
+         perf_state.tracefirst = 0;
+      }
+   }
+   pthread_mutex_unlock( &(perf_state.tracelock) );
+   slab->eventcount = 0;
+   return retval;
+}
+
+/**
+ * Release the slab of an exiting thread, so that a later thread may reuse it
+ * @param void* arg : Slab to be released
+ */
+void perf_releaseslab( void* arg ) {
+   perf_slab* slab = (perf_slab*)arg;
+   pthread_mutex_lock( &(slab->eventlock) );
+   perf_flushslab( slab );
+   pthread_mutex_unlock( &(slab->eventlock) );
+   __atomic_store_n( &(slab->inuse), 0, __ATOMIC_RELEASE );
+}
+
+/**
+ * Retrieve the slab of the calling thread, claiming an idle or new one if necessary
+ * @return perf_slab* : Reference to the thread's slab, or NULL on failure
+ */
+perf_slab* perf_getslab( void ) {
+   if ( !(perf_state.keyvalid) ) { return NULL; }
+   perf_slab* slab = pthread_getspecific( perf_state.slabkey );
+   if ( slab ) { return slab; }
+   // attempt to reuse the slab of an exited thread, keeping its counts
+   for ( slab = __atomic_load_n( &(perf_state.slabs), __ATOMIC_ACQUIRE ); slab; slab = slab->next ) {
+      int idle = 0;
+      if ( __atomic_load_n( &(slab->inuse), __ATOMIC_RELAXED ) == 0  &&
+           __atomic_compare_exchange_n( &(slab->inuse), &(idle), 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) {
+         break;
+      }
+   }
+   if ( slab == NULL ) {
+      slab = calloc( 1, sizeof( struct perf_slab_struct ) );
+      if ( slab == NULL ) { return NULL; }
+      pthread_mutex_init( &(slab->eventlock), NULL );
+      slab->inuse = 1;
+      slab->next = __atomic_load_n( &(perf_state.slabs), __ATOMIC_RELAXED );
+      while ( !__atomic_compare_exchange_n( &(perf_state.slabs), &(slab->next), slab, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED ) ) {}
+   }
+   slab->tid = (unsigned int)syscall( SYS_gettid );
+   if ( pthread_setspecific( perf_state.slabkey, slab ) ) {
+      __atomic_store_n( &(slab->inuse), 0, __ATOMIC_RELEASE );
+      return NULL;
+   }
+   return slab;
+}
+
+/**
+ * Rewrite the stats file ( via a temporary file and rename, so readers never see a partial file )
+ * @param const char* path : Path of the stats file
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_writestats( const char* path ) {
+   size_t tmplen = strlen( path ) + 5;
+   char* tmppath = malloc( tmplen );
+   if ( tmppath == NULL ) { return -1; }
+   snprintf( tmppath, tmplen, "%s.tmp", path );
+   FILE* out = fopen( tmppath, "w" );
+   if ( out == NULL ) { free( tmppath ); return -1; }
+   int retval = perf_report( out );
+   if ( fclose( out ) ) { retval = -1; }
+   if ( retval == 0  &&  rename( tmppath, path ) ) { retval = -1; }
+   free( tmppath );
+   return retval;
+}
+
+/**
+ * Background stats thread, rewriting the stats file at the configured interval
+ * @param void* arg : Unused
+ * @return void* : Always NULL
+ */
+void* perf_statsthread( void* arg ) {
+   pthread_mutex_lock( &(perf_state.statslock) );
+   while ( !(perf_state.statsstop) ) {
+      struct timespec deadline;
+      clock_gettime( CLOCK_REALTIME, &(deadline) );
+      deadline.tv_sec += perf_state.interval;
+      while ( !(perf_state.statsstop)  &&
+              pthread_cond_timedwait( &(perf_state.statscond), &(perf_state.statslock), &(deadline) ) != ETIMEDOUT ) {}
+      perf_writestats( perf_state.statspath );
+   }
+   pthread_mutex_unlock( &(perf_state.statslock) );
+   return NULL;
+}
+
+/**
+ * Stop any running stats thread
+ * NOTE -- caller must hold the statsctllock
+ */
+void perf_stopstats_locked( void ) {
+   pthread_mutex_lock( &(perf_state.statslock) );
+   if ( !(perf_state.statsrunning) ) {
+      pthread_mutex_unlock( &(perf_state.statslock) );
+      return;
+   }
+   perf_state.statsstop = 1;
+   pthread_cond_signal( &(perf_state.statscond) );
+   pthread_mutex_unlock( &(perf_state.statslock) );
+   // the stats thread never takes the statsctllock, so we may safely join while holding it
+   pthread_join( perf_state.statsthread, NULL );
+   pthread_mutex_lock( &(perf_state.statslock) );
+   perf_state.statsrunning = 0;
+   perf_state.statsstop = 0;
+   pthread_mutex_unlock( &(perf_state.statslock) );
+}
+
+/**
+ * Stop any running stats thread
+ */
+void perf_stopstats( void ) {
+   pthread_mutex_lock( &(perf_state.statsctllock) );
+   perf_stopstats_locked();
+   pthread_mutex_unlock( &(perf_state.statsctllock) );
+}
+
+/**
+ * Apply new instrumentation flags ( see perf_setflags() )
+ */
+int perf_applyflags( int flags ) {
+   if ( flags & ~(PERF_COUNTERS | PERF_TRACE) ) {
+      errno = EINVAL;
+      return -1;
+   }
+   pthread_mutex_lock( &(perf_state.tracelock) );
+   char notrace = ( perf_state.trace == NULL );
+   pthread_mutex_unlock( &(perf_state.tracelock) );
+   if ( (flags & PERF_TRACE)  &&  notrace ) {
+      errno = EINVAL;
+      return -1;
+   }
+   __atomic_store_n( &(perf_flags), flags, __ATOMIC_RELAXED );
+   return 0;
+}
+
+/**
+ * Open a new trace output file ( see perf_settrace() )
+ */
+int perf_opentrace( const char* path ) {
+   FILE* trace = fopen( path, "w" );
+   if ( trace == NULL ) { return -1; }
+   fprintf( trace, "[" );
+   // flush events into any previous output, before swapping it out
+   perf_flush();
+   pthread_mutex_lock( &(perf_state.tracelock) );
+   FILE* oldtrace = perf_state.trace;
+   perf_state.trace = trace;
+   perf_state.tracefirst = 1;
+   pthread_mutex_unlock( &(perf_state.tracelock) );
+   if ( oldtrace ) {
+      fprintf( oldtrace, "\n]\n" );
+      fclose( oldtrace );
+   }
+   return 0;
+}
+
+/**
+ * Start a new stats output thread ( see perf_setstats() )
+ */
+int perf_startstats( const char* path, unsigned int interval ) {
+   if ( path == NULL  ||  interval == 0 ) {
+      errno = EINVAL;
+      return -1;
+   }
+   char* newpath = strdup( path );
+   if ( newpath == NULL ) { return -1; }
+   pthread_mutex_lock( &(perf_state.statsctllock) );
+   perf_stopstats_locked();
+   pthread_mutex_lock( &(perf_state.statslock) );
+   if ( perf_state.statspath ) { free( perf_state.statspath ); }
+   perf_state.statspath = newpath;
+   perf_state.interval = interval;
+   int retval = 0;
+   if ( pthread_create( &(perf_state.statsthread), NULL, perf_statsthread, NULL ) ) {
+      retval = -1;
+   }
+   else {
+      perf_state.statsrunning = 1;
+   }
+   pthread_mutex_unlock( &(perf_state.statslock) );
+   pthread_mutex_unlock( &(perf_state.statsctllock) );
+   return retval;
+}
+
+/**
+ * One-time initialization, parsing MARFS_PERF* environment variables
+ */
+void perf_init( void ) {
+   if ( pthread_key_create( &(perf_state.slabkey), perf_releaseslab ) == 0 ) {
+      perf_state.keyvalid = 1;
+   }
+   int flags = 0;
+   const char* envval = getenv( "MARFS_PERF" );
+   if ( envval ) {
+      if ( strstr( envval, "counters" )  ||  strstr( envval, "all" ) ) { flags |= PERF_COUNTERS; }
+      if ( strstr( envval, "trace" )  ||  strstr( envval, "all" ) ) { flags |= PERF_TRACE; }
+   }
+   envval = getenv( "MARFS_PERF_TRACE" );
+   if ( envval  &&  perf_opentrace( envval ) ) {
+      fprintf( stderr, "perfstats: failed to open trace output \"%s\" (%s)\n", envval, strerror(errno) );
+      flags &= ~(PERF_TRACE);
+   }
+   envval = getenv( "MARFS_PERF_STATS" );
+   if ( envval ) {
+      unsigned int interval = PERF_DEFAULT_INTERVAL;
+      const char* intervalstr = getenv( "MARFS_PERF_INTERVAL" );
+      if ( intervalstr  &&  atoi( intervalstr ) > 0 ) { interval = (unsigned int)atoi( intervalstr ); }
+      if ( perf_startstats( envval, interval ) ) {
+         fprintf( stderr, "perfstats: failed to start stats output to \"%s\"\n", envval );
+      }
+   }
+   if ( flags  &&  perf_applyflags( flags ) ) {
+      fprintf( stderr, "perfstats: failed to enable instrumentation flags %d\n", flags );
+   }
+}
+
+__attribute__((constructor))
+void perf_construct( void ) {
+   pthread_once( &(perf_state.once), perf_init );
+}
+
+__attribute__((destructor))
+void perf_destruct( void ) {
+   // every library copy registers this destructor, but only the first should act
+   if ( __atomic_exchange_n( &(perf_state.finalized), 1, __ATOMIC_ACQ_REL ) ) { return; }
+   perf_stopstats();
+   perf_flush();
+   pthread_mutex_lock( &(perf_state.tracelock) );
+   if ( perf_state.trace ) {
+      fprintf( perf_state.trace, "\n]\n" );
+      fclose( perf_state.trace );
+      perf_state.trace = NULL;
+   }
+   pthread_mutex_unlock( &(perf_state.tracelock) );
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+int perf_setflags( int flags ) {
+   pthread_once( &(perf_state.once), perf_init );
+   return perf_applyflags( flags );
+}
+
+int perf_settrace( const char* path ) {
+   pthread_once( &(perf_state.once), perf_init );
+   return perf_opentrace( path );
+}
+
+int perf_setstats( const char* path, unsigned int interval ) {
+   pthread_once( &(perf_state.once), perf_init );
+   return perf_startstats( path, interval );
+}
+
+void perf_snapshot( perf_counter* counters ) {
+   int probe;
+   for ( probe = 0; probe < PERF_PROBE_COUNT; probe++ ) {
+      counters[probe].name = perf_names[probe];
+      counters[probe].calls = 0;
+      counters[probe].nsecs = 0;
+      counters[probe].bytes = 0;
+   }
+   perf_slab* slab;
+   for ( slab = __atomic_load_n( &(perf_state.slabs), __ATOMIC_ACQUIRE ); slab; slab = slab->next ) {
+      for ( probe = 0; probe < PERF_PROBE_COUNT; probe++ ) {
+         counters[probe].calls += __atomic_load_n( &(slab->calls[probe]), __ATOMIC_RELAXED );
+         counters[probe].nsecs += __atomic_load_n( &(slab->nsecs[probe]), __ATOMIC_RELAXED );
+         counters[probe].bytes += __atomic_load_n( &(slab->bytes[probe]), __ATOMIC_RELAXED );
+      }
+   }
+}
+
+int perf_report( FILE* out ) {
+   perf_counter counters[PERF_PROBE_COUNT];
+   perf_snapshot( counters );
+   if ( fprintf( out, "probe,calls,total_s,mean_us,bytes,MiB_per_s\n" ) < 0 ) { return -1; }
+   int probe;
+   for ( probe = 0; probe < PERF_PROBE_COUNT; probe++ ) {
+      double seconds = counters[probe].nsecs / 1e9;
+      if ( fprintf( out, "%s,%llu,%.6f,%.3f,%llu,%.3f\n", counters[probe].name,
+                    (unsigned long long)counters[probe].calls, seconds,
+                    (counters[probe].calls) ? (counters[probe].nsecs / 1e3) / counters[probe].calls : 0.0,
+                    (unsigned long long)counters[probe].bytes,
+                    (seconds > 0) ? (counters[probe].bytes / 1048576.0) / seconds : 0.0 ) < 0 ) {
+         return -1;
+      }
+   }
+   return 0;
+}
+
+int perf_flush( void ) {
+   int retval = 0;
+   perf_slab* slab;
+   for ( slab = __atomic_load_n( &(perf_state.slabs), __ATOMIC_ACQUIRE ); slab; slab = slab->next ) {
+      pthread_mutex_lock( &(slab->eventlock) );
+      if ( slab->eventcount  &&  perf_flushslab( slab ) ) { retval = -1; }
+      pthread_mutex_unlock( &(slab->eventlock) );
+   }
+   pthread_mutex_lock( &(perf_state.tracelock) );
+   if ( perf_state.trace  &&  fflush( perf_state.trace ) ) { retval = -1; }
+   pthread_mutex_unlock( &(perf_state.tracelock) );
+   return retval;
+}
+
+uint64_t perf_now( void ) {
+   struct timespec now;
+   clock_gettime( CLOCK_MONOTONIC, &(now) );
+   return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+void perf_record( perf_probe probe, uint64_t begin, size_t bytes ) {
+   uint64_t end = perf_now();
+   int flags = __atomic_load_n( &(perf_flags), __ATOMIC_RELAXED );
+   perf_slab* slab = perf_getslab();
+   if ( slab == NULL  ||  probe < 0  ||  probe >= PERF_PROBE_COUNT ) { return; } // best effort
+   if ( flags & PERF_COUNTERS ) {
+      __atomic_store_n( &(slab->calls[probe]), __atomic_load_n( &(slab->calls[probe]), __ATOMIC_RELAXED ) + 1, __ATOMIC_RELAXED );
+      __atomic_store_n( &(slab->nsecs[probe]), __atomic_load_n( &(slab->nsecs[probe]), __ATOMIC_RELAXED ) + (end - begin), __ATOMIC_RELAXED );
+      __atomic_store_n( &(slab->bytes[probe]), __atomic_load_n( &(slab->bytes[probe]), __ATOMIC_RELAXED ) + bytes, __ATOMIC_RELAXED );
+   }
+   if ( flags & PERF_TRACE ) {
+      pthread_mutex_lock( &(slab->eventlock) );
+      if ( slab->eventcount == PERF_TRACE_EVENTS ) { perf_flushslab( slab ); }
+      perf_event* event = slab->events + slab->eventcount;
+      event->begin = begin;
+      event->end = end;
+      event->probe = probe;
+      slab->eventcount++;
+      pthread_mutex_unlock( &(slab->eventlock) );
+   }
+}
@@ -0,0 +1,166 @@
+#ifndef _MARFS_PERFSTATS_H
+#define _MARFS_PERFSTATS_H
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+// ---------------------------------------------------------------------------
+// Process-wide performance counters and span tracing.
+//
+// Each instrumented region ( a 'probe' ) accumulates a call count, total time, and
+// byte count into a slab owned by the calling thread, so counter updates never take a
+// lock.  While tracing, each event is appended under a per-thread lock of that slab
+// ( contended only by perf_flush() ).
+// Instrumentation is disabled by default and costs a single relaxed load per probe
+// until enabled, either at runtime via perf_setflags() or at process start via:
+//
+//    MARFS_PERF=counters[,trace]    -- enable counters and/or span tracing
+//    MARFS_PERF_STATS=<path>        -- periodically rewrite a stats file ( CSV )
+//    MARFS_PERF_INTERVAL=<seconds>  -- period of stats file output ( default 10 )
+//    MARFS_PERF_TRACE=<path>        -- output trace events as Chrome trace JSON
+//                                      ( viewable via chrome://tracing or Perfetto )
+// ---------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#  ifdef __cplusplus
+extern "C" {
+#  endif
+
+typedef enum {
+   // api
+   PERF_MARFS_CREAT = 0,
+   PERF_MARFS_OPEN,
+   PERF_MARFS_READ,
+   PERF_MARFS_WRITE,
+   PERF_MARFS_CLOSE,
+   PERF_MARFS_RELEASE,
+   // datastream
+   PERF_DATASTREAM_CREATE,
+   PERF_DATASTREAM_OPEN,
+   PERF_DATASTREAM_READ,
+   PERF_DATASTREAM_WRITE,
+   PERF_DATASTREAM_CLOSE,
+   PERF_DATASTREAM_RELEASE,
+   PERF_DATASTREAM_OBJCLOSE,
+   // ne
+   PERF_NE_OPEN,
+   PERF_NE_WRITE,
+   PERF_NE_READ_STRIPES,
+   PERF_NE_CLOSE,
+   PERF_NE_ENCODE,
+   PERF_NE_DECODE,
+   PERF_IO_CRC,
+   PERF_IOQ_STALL,
+   // dal
+   PERF_DAL_OPEN,
+   PERF_DAL_PUT,
+   PERF_DAL_GET,
+   PERF_DAL_SET_META,
+   PERF_DAL_GET_META,
+   PERF_DAL_CLOSE,
+   PERF_DAL_ABORT,
+   PERF_PROBE_COUNT // not a real probe, just a count of them
+} perf_probe;
+
+// flag values for perf_setflags()
+#define PERF_COUNTERS 0x1
+#define PERF_TRACE    0x2
+
+typedef struct perf_counter_struct {
+   const char* name;  // name of the probe
+   uint64_t    calls; // number of completed calls
+   uint64_t    nsecs; // total time spent in the probe
+   uint64_t    bytes; // total data volume reported by the probe
+} perf_counter;
+
+// current instrumentation flags ( do not modify directly, see perf_setflags() )
+extern int perf_flags;
+
+/**
+ * Enable/disable instrumentation at runtime
+ * @param int flags : Bitwise OR of PERF_COUNTERS / PERF_TRACE, or zero to disable
+ * @return int : Zero on success, or -1 on failure ( e.g. no trace output was configured )
+ */
+int perf_setflags( int flags );
+
+/**
+ * Direct trace events to the given Chrome trace JSON file
+ * @param const char* path : Path of the trace file ( truncated )
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_settrace( const char* path );
+
+/**
+ * Start ( or restart ) a background thread, rewriting a stats file at the given interval
+ * @param const char* path : Path of the stats file
+ * @param unsigned int interval : Seconds between stats file updates
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_setstats( const char* path, unsigned int interval );
+
+/**
+ * Populate a live snapshot of all process-wide counters
+ * @param perf_counter* counters : Array of PERF_PROBE_COUNT elements, indexed by perf_probe
+ */
+void perf_snapshot( perf_counter* counters );
+
+/**
+ * Output all process-wide counters in CSV format
+ * @param FILE* out : Stream to output to
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_report( FILE* out );
+
+/**
+ * Output all buffered trace events of every thread
+ * @return int : Zero on success, or -1 on failure
+ */
+int perf_flush( void );
+
+/**
+ * Get the current time for use as a probe start value, if instrumentation is enabled
+ * @return uint64_t : Monotonic time in ns, or zero if instrumentation is disabled
+ */
+uint64_t perf_now( void );
+static inline uint64_t perf_begin( void ) {
+   if ( __builtin_expect( __atomic_load_n( &perf_flags, __ATOMIC_RELAXED ) == 0, 1 ) ) { return 0; }
+   return perf_now();
+}
+
+/**
+ * Record completion of a probe
+ * @param perf_probe probe : Completed probe
+ * @param uint64_t begin : Start value of the probe, from perf_begin()
+ * @param size_t bytes : Data volume processed by the probe ( may be zero )
+ */
+void perf_record( perf_probe probe, uint64_t begin, size_t bytes );
+static inline void perf_end( perf_probe probe, uint64_t begin, size_t bytes ) {
+   if ( begin ) { perf_record( probe, begin, bytes ); }
+}
+
+// Scoped probe, recorded automatically when NAME leaves scope
+//    ( set NAME.bytes prior to returning, to report a data volume )
+typedef struct perf_span_struct {
+   uint64_t   begin;
+   perf_probe probe;
+   size_t     bytes;
+} perf_span;
+static inline void perf_span_end( perf_span* span ) {
+   perf_end( span->probe, span->begin, span->bytes );
+}
+#define PERF_SPAN( NAME, PROBE ) \
+   perf_span NAME __attribute__((cleanup(perf_span_end))) = { perf_begin(), (PROBE), 0 }
+
+#  ifdef __cplusplus
+}
+#  endif
+
+#endif // _MARFS_PERFSTATS_H
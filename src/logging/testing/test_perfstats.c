@@ -0,0 +1,212 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "logging/perfstats.c" // include C file directly, to allow access to internal state
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_THREADS 4
+#define TEST_RECORDS ( PERF_TRACE_EVENTS + 100 ) // enough to overflow each trace buffer once
+#define TEST_BYTES 512
+#define TEST_TRACEFILE "./test_perfstats_trace.json"
+#define TEST_TRACEFILE2 "./test_perfstats_trace2.json"
+#define TEST_STATSFILE "./test_perfstats_stats.csv"
+
+void* record_thread( void* arg ) {
+   int record;
+   for ( record = 0; record < TEST_RECORDS; record++ ) {
+      PERF_SPAN( span, PERF_DAL_PUT );
+      span.bytes = TEST_BYTES;
+   }
+   return NULL;
+}
+
+int run_threads( void ) {
+   pthread_t threads[TEST_THREADS];
+   int index;
+   for ( index = 0; index < TEST_THREADS; index++ ) {
+      if ( pthread_create( threads + index, NULL, record_thread, NULL ) ) {
+         printf( "ERROR: failed to create record thread %d\n", index );
+         return -1;
+      }
+   }
+   for ( index = 0; index < TEST_THREADS; index++ ) {
+      if ( pthread_join( threads[index], NULL ) ) {
+         printf( "ERROR: failed to join record thread %d\n", index );
+         return -1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * Count the occurrences of a string within a file
+ */
+ssize_t count_occurrences( const char* path, const char* str, char* lastchar ) {
+   FILE* in = fopen( path, "r" );
+   if ( in == NULL ) { return -1; }
+   size_t matched = 0;
+   ssize_t count = 0;
+   int c;
+   while ( (c = fgetc( in )) != EOF ) {
+      if ( !isspace( c ) ) { *lastchar = (char)c; }
+      if ( c == str[matched] ) {
+         matched++;
+         if ( str[matched] == '\0' ) { count++; matched = 0; }
+      }
+      else { matched = ( c == str[0] ) ? 1 : 0; }
+   }
+   fclose( in );
+   return count;
+}
+
+void* restart_thread( void* arg ) {
+   int iter;
+   for ( iter = 0; iter < 20; iter++ ) {
+      if ( iter % 2 ) { perf_stopstats(); }
+      else if ( perf_setstats( TEST_STATSFILE, 1 ) ) { return (void*)1; }
+   }
+   return NULL;
+}
+
+int main( int argc, char** argv ) {
+   // nothing should be recorded while instrumentation is disabled
+   if ( run_threads() ) { return -1; }
+   perf_counter counters[PERF_PROBE_COUNT];
+   perf_snapshot( counters );
+   if ( counters[PERF_DAL_PUT].calls ) {
+      printf( "ERROR: recorded %llu calls while disabled\n", (unsigned long long)counters[PERF_DAL_PUT].calls );
+      return -1;
+   }
+   // tracing cannot be enabled without a trace output
+   if ( perf_setflags( PERF_TRACE ) == 0  ||  errno != EINVAL ) {
+      printf( "ERROR: enabled tracing without a trace output\n" );
+      return -1;
+   }
+
+   // counters should reflect every call of every thread
+   if ( perf_setflags( PERF_COUNTERS ) ) {
+      printf( "ERROR: failed to enable counters\n" );
+      return -1;
+   }
+   if ( run_threads() ) { return -1; }
+   perf_snapshot( counters );
+   if ( strcmp( counters[PERF_DAL_PUT].name, "dal_put" )  ||
+        counters[PERF_DAL_PUT].calls != (uint64_t)TEST_THREADS * TEST_RECORDS  ||
+        counters[PERF_DAL_PUT].bytes != (uint64_t)TEST_THREADS * TEST_RECORDS * TEST_BYTES  ||
+        counters[PERF_DAL_GET].calls ) {
+      printf( "ERROR: unexpected counter values: %s calls = %llu, bytes = %llu\n", counters[PERF_DAL_PUT].name,
+              (unsigned long long)counters[PERF_DAL_PUT].calls, (unsigned long long)counters[PERF_DAL_PUT].bytes );
+      return -1;
+   }
+   // exited threads should leave their slabs available for reuse
+   int slabcount = 0;
+   perf_slab* slab;
+   for ( slab = perf_state.slabs; slab; slab = slab->next ) { slabcount++; }
+   if ( slabcount > TEST_THREADS + 1 ) {
+      printf( "ERROR: slabs of exited threads were not reused ( %d slabs )\n", slabcount );
+      return -1;
+   }
+
+   // the report should contain a header and one line per probe
+   FILE* report = tmpfile();
+   if ( report == NULL  ||  perf_report( report ) ) {
+      printf( "ERROR: failed to produce a counter report\n" );
+      return -1;
+   }
+   rewind( report );
+   char line[256];
+   int linecount = 0;
+   char foundput = 0;
+   while ( fgets( line, 256, report ) ) {
+      if ( linecount == 0  &&  strncmp( line, "probe,calls,", 12 ) ) {
+         printf( "ERROR: unexpected report header: %s", line );
+         return -1;
+      }
+      if ( strncmp( line, "dal_put,", 8 ) == 0 ) {
+         unsigned long long calls = 0;
+         if ( sscanf( line + 8, "%llu,", &(calls) ) != 1  ||  calls != (unsigned long long)TEST_THREADS * TEST_RECORDS ) {
+            printf( "ERROR: unexpected report line: %s", line );
+            return -1;
+         }
+         foundput = 1;
+      }
+      linecount++;
+   }
+   fclose( report );
+   if ( linecount != PERF_PROBE_COUNT + 1  ||  !(foundput) ) {
+      printf( "ERROR: unexpected report length ( %d lines )\n", linecount );
+      return -1;
+   }
+
+   // every traced event should be output, even those beyond a full per-thread buffer
+   if ( perf_settrace( TEST_TRACEFILE )  ||  perf_setflags( PERF_COUNTERS | PERF_TRACE ) ) {
+      printf( "ERROR: failed to enable tracing\n" );
+      return -1;
+   }
+   if ( run_threads() ) { return -1; }
+   if ( perf_setflags( PERF_COUNTERS ) ) {
+      printf( "ERROR: failed to disable tracing\n" );
+      return -1;
+   }
+   // switching trace outputs should flush and terminate the previous one
+   if ( perf_settrace( TEST_TRACEFILE2 ) ) {
+      printf( "ERROR: failed to switch trace output\n" );
+      return -1;
+   }
+   char lastchar = '\0';
+   ssize_t eventcount = count_occurrences( TEST_TRACEFILE, "\"name\":\"dal_put\"", &(lastchar) );
+   if ( eventcount != (ssize_t)TEST_THREADS * TEST_RECORDS  ||  lastchar != ']' ) {
+      printf( "ERROR: trace output holds %zd of %d events ( final char '%c' )\n", eventcount, TEST_THREADS * TEST_RECORDS, lastchar );
+      return -1;
+   }
+   perf_snapshot( counters );
+   if ( counters[PERF_DAL_PUT].calls != (uint64_t)TEST_THREADS * TEST_RECORDS * 2 ) {
+      printf( "ERROR: counters were not maintained while tracing\n" );
+      return -1;
+   }
+
+   // the stats thread should output the report, and tolerate concurrent restarts / stops
+   if ( perf_setstats( TEST_STATSFILE, 1 ) ) {
+      printf( "ERROR: failed to start stats output\n" );
+      return -1;
+   }
+   sleep( 2 );
+   ssize_t putlines = count_occurrences( TEST_STATSFILE, "dal_put,", &(lastchar) );
+   if ( putlines != 1 ) {
+      printf( "ERROR: stats output holds %zd 'dal_put' lines\n", putlines );
+      return -1;
+   }
+   pthread_t restarters[TEST_THREADS];
+   int index;
+   for ( index = 0; index < TEST_THREADS; index++ ) {
+      if ( pthread_create( restarters + index, NULL, restart_thread, NULL ) ) {
+         printf( "ERROR: failed to create restart thread %d\n", index );
+         return -1;
+      }
+   }
+   int failures = 0;
+   for ( index = 0; index < TEST_THREADS; index++ ) {
+      void* tres = NULL;
+      if ( pthread_join( restarters[index], &(tres) )  ||  tres ) { failures++; }
+   }
+   perf_stopstats();
+   if ( failures  ||  perf_state.statsrunning  ||  perf_state.statsstop ) {
+      printf( "ERROR: concurrent stats restarts left an inconsistent state\n" );
+      return -1;
+   }
+
+   unlink( TEST_TRACEFILE );
+   unlink( TEST_TRACEFILE2 );
+   unlink( TEST_STATSFILE );
+   printf( "perfstats tests completed successfully\n" );
+   return 0;
+}
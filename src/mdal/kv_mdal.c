@@ -0,0 +1,4577 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_MDAL
+#define DEBUG DEBUG_MDAL
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "kv_mdal"
+#include "logging/logging.h"
+
+#include "mdal.h"
+#include "kvstore.h"
+#include "config/config.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * The KV MDAL stores all MarFS metadata within an embedded key-value store ( see kvstore.h ),
+ * located beneath a single local directory.  Every file, directory, symlink, xattr, and usage
+ * value is represented by one or more keys, rather than by a filesystem object, such that each
+ * MDAL operation costs only an in-memory index update and a share of a batched log write.
+ *
+ * Key layout ( all integer components are big-endian, so that keys sort numerically ) :
+ *    'S'                        -> superblock           ( kvmdal_super )
+ *    'I' <ino>                  -> inode                ( kvmdal_inode )
+ *    'N' <dir ino> <name>       -> directory entry      ( kvmdal_dentry )
+ *    'E' <dir ino> <cookie>     -> readdir entry        ( kvmdal_dirent, followed by the entry name )
+ *    'X' <ino> <xattr name>     -> xattr value
+ *    'L' <ino>                  -> symlink target
+ *    'B' <ino> <block number>   -> file data block      ( up to KMDAL_BLOCKSIZE bytes )
+ *    'M' <NS ino>               -> namespace record     ( kvmdal_nsrec, followed by the NS name )
+ *    'U' <parent NS ino> <name> -> subspace entry       ( ino of the child NS )
+ *    'O' <ino>                  -> unlinked inode, still held open ( no value )
+ * All values are stored in host byte order, so a store directory is not portable between
+ * architectures.
+ *
+ * Each namespace is identified by the inode of its user directory tree, with a separate
+ * directory inode as the root of its reference tree.  Neither root has a parent, so paths can
+ * never escape the tree they are interpreted within.
+ *
+ * Permissions are enforced against the effective uid/gid of the calling process, following the
+ * rules the kernel applies to the posix MDAL : each path element requires search access to its
+ * directory, entry creation / removal requires write and search access to the parent directory
+ * ( honoring the sticky bit ), opens and xattr ops require read / write access to the target, and
+ * mode, owner, and timestamp changes require ownership of the target ( or root ).  Namespace paths
+ * themselves are not subject to traversal checks.  Modes are applied exactly as provided, without
+ * any umask.
+ *
+ * A store directory can only be opened by a single process at a time.
+ */
+
+
+//   -------------    KV DEFINITIONS    -------------
+
+#define KMDAL_PREFX "MDAL_"
+#define KMDAL_XATTR "user."KMDAL_PREFX
+#define KMDAL_BLOCKSIZE 4096      // data block size ( also the reported st_blksize )
+#define KMDAL_WRITECHUNK 256      // max data blocks modified by any single write transaction
+#define KMDAL_MAXSYMLINKS 40      // max symlinks followed by any single path traversal
+#define KMDAL_ROOTINO 1           // inode of the root NS
+#define KMDAL_VERSION 1           // version of the key layout
+#define KMDAL_KEYMAX ( 1 + 8 + NAME_MAX + 1 ) // max length of any key
+#define KMDAL_XATTRMAX 65536      // max length of any xattr value
+
+// key type prefixes
+#define KMDAL_KEY_SUPER  'S'
+#define KMDAL_KEY_INODE  'I'
+#define KMDAL_KEY_DENTRY 'N'
+#define KMDAL_KEY_DIRENT 'E'
+#define KMDAL_KEY_XATTR  'X'
+#define KMDAL_KEY_LINK   'L'
+#define KMDAL_KEY_BLOCK  'B'
+#define KMDAL_KEY_NS     'M'
+#define KMDAL_KEY_SUBSP  'U'
+#define KMDAL_KEY_ORPHAN 'O'
+
+
+//   -------------    KV STRUCTURES    -------------
+
+typedef struct kvmdal_super_struct {
+   uint64_t version;
+   uint64_t nextino;  // next inode number to be allocated
+} kvmdal_super;
+
+typedef struct kvmdal_inode_struct {
+   uint32_t mode;
+   uint32_t uid;
+   uint32_t gid;
+   uint32_t nlink;
+   uint64_t size;
+   uint64_t blocks;     // number of stored data blocks
+   uint64_t rdev;
+   uint64_t parent;     // parent inode of a directory ( zero for NS and reference tree roots )
+   uint64_t nextcookie; // readdir cookie of the next entry to be added to a directory
+   int64_t  atime[2];
+   int64_t  mtime[2];
+   int64_t  ctime[2];
+} kvmdal_inode;
+
+typedef struct kvmdal_dentry_struct {
+   uint64_t ino;
+   uint64_t cookie;     // readdir position of this entry
+   uint32_t mode;       // type of the target inode
+   uint32_t unused;
+} kvmdal_dentry;
+
+typedef struct kvmdal_dirent_struct {
+   uint64_t ino;
+   uint32_t mode;       // type of the target inode
+   uint32_t unused;
+} kvmdal_dirent;
+
+typedef struct kvmdal_nsrec_struct {
+   uint64_t parent;     // ino of the parent NS ( zero for the root NS )
+   uint64_t refroot;    // ino of the root of the reference tree ( zero, if not yet created )
+   int64_t  datausage;
+   int64_t  inodeusage;
+} kvmdal_nsrec;
+
+typedef struct kvmdal_nsinfo_struct {
+   kvmdal_nsrec rec;
+   char         name[NAME_MAX + 1];
+   size_t       namelen;
+} kvmdal_nsinfo;
+
+typedef struct kvmdal_openfile_struct {
+   uint64_t ino;
+   size_t   count;
+} kvmdal_openfile;
+
+typedef struct kvmdal_store_struct {
+   KVSTORE           kvs;
+   int               dirfd;     // store directory
+   dev_t             dev;       // device of the store directory ( reported as st_dev )
+   ino_t             ino;       // inode of the store directory
+   size_t            refs;      // count of MDAL_CTXTs and handles referencing this store
+                                // ( protected by kvmdal_registrylock )
+   pthread_mutex_t   openlock;
+   kvmdal_openfile*  open;      // inodes with open file handles ( protected by 'openlock' )
+   size_t            opencount;
+   size_t            openalloc;
+   struct kvmdal_store_struct* next;
+}* KVMDAL_STORE;
+
+// every store opened by this process, allowing multiple MDAL instances to share a store
+static pthread_mutex_t kvmdal_registrylock = PTHREAD_MUTEX_INITIALIZER;
+static KVMDAL_STORE kvmdal_registry = NULL;
+
+typedef struct kv_mdal_context_struct {
+   KVMDAL_STORE store;
+   uint64_t pathns;   // NS targeted by user path ops ( or zero, if NS hasn't been set )
+   uint64_t pathdir;  // dir which user paths are interpreted relative to
+   uint64_t refns;    // NS targeted by reference path ops
+   uint64_t refdir;   // root of the reference tree of 'refns'
+}* KV_MDAL_CTXT;
+
+typedef struct kvmdal_file_handle_struct {
+   KVMDAL_STORE store;
+   uint64_t ino;
+   int      flags;
+   off_t    offset;
+}* KV_FHANDLE;
+
+typedef struct kvmdal_directory_handle_struct {
+   KVMDAL_STORE  store;
+   uint64_t      ino;
+   long          loc;   // 0 -> '.' entry, 1 -> '..' entry, N -> first entry with cookie >= N - 2
+   struct dirent ent;
+}* KV_DHANDLE;
+
+typedef struct kvmdal_directory_handle_struct* KV_SCANNER;
+
+typedef struct kvmdal_walk_result_struct {
+   uint64_t      parent;   // dir containing the final path element ( zero for a '.' or '..' element )
+   uint64_t      ino;      // inode of the final path element ( zero, if it does not exist )
+   kvmdal_dentry dent;     // directory entry of the final element ( valid only if parent and ino are set )
+   char          name[NAME_MAX + 1]; // name of the final element
+   size_t        namelen;
+   char          trailing; // the path ends with a '/' char
+} kvmdal_walkres;
+
+
+//   -------------    KV INTERNAL FUNCTIONS    -------------
+
+/**
+ * Abort the given transaction, preserving errno
+ * @param KVTXN txn : Transaction to be aborted
+ * @return int : Always -1
+ */
+static int kvmdal_abort( KVTXN txn ) {
+   int olderrno = errno;
+   kvtxn_abort( txn );
+   errno = olderrno;
+   return -1;
+}
+
+/**
+ * Populate the given timestamp with the current time
+ */
+static void kvmdal_now( int64_t* ts ) {
+   struct timespec now;
+   clock_gettime( CLOCK_REALTIME, &(now) );
+   ts[0] = now.tv_sec;
+   ts[1] = now.tv_nsec;
+}
+
+static void kvmdal_putu64( char* buf, uint64_t val ) {
+   int index = 7;
+   for ( ; index >= 0; index-- ) { buf[index] = (char)( val & 0xFF ); val >>= 8; }
+}
+
+static uint64_t kvmdal_getu64( const char* buf ) {
+   uint64_t val = 0;
+   int index = 0;
+   for ( ; index < 8; index++ ) { val = ( val << 8 ) | (unsigned char)buf[index]; }
+   return val;
+}
+
+/**
+ * Produce a key of the given type
+ * @param char* key : Buffer of at least KMDAL_KEYMAX bytes, to be populated
+ * @param char type : Key type prefix
+ * @param uint64_t id : Inode value of the key
+ * @param const char* suffix : Trailing name component of the key ( may be NULL, if sufflen is zero )
+ * @param size_t sufflen : Length of the trailing name component
+ * @return size_t : Length of the produced key
+ */
+static size_t kvmdal_key( char* key, char type, uint64_t id, const char* suffix, size_t sufflen ) {
+   key[0] = type;
+   kvmdal_putu64( key + 1, id );
+   if ( sufflen ) { memcpy( key + 9, suffix, sufflen ); }
+   return 9 + sufflen;
+}
+
+/**
+ * Produce a key of the given type, with a trailing numeric component
+ * @return size_t : Length of the produced key
+ */
+static size_t kvmdal_numkey( char* key, char type, uint64_t id, uint64_t num ) {
+   key[0] = type;
+   kvmdal_putu64( key + 1, id );
+   kvmdal_putu64( key + 9, num );
+   return 17;
+}
+
+/**
+ * Locate the next key following the given key, so long as it shares the given prefix
+ * @param KVTXN txn : Transaction to search within
+ * @param const char* key : Key to search from ( the prefix itself, to locate the first match )
+ * @param size_t keylen : Length of the search key
+ * @param size_t prefixlen : Length of the required prefix of the search key
+ * @param const char** nextkey : Reference to be populated with the located key
+ * @param size_t* nextkeylen : Reference to be populated with the length of the located key
+ * @param const void** value : Reference to be populated with the value of the located key
+ * @param size_t* vallen : Reference to be populated with the length of that value
+ * @return int : 1 if a key was located, 0 if no matching keys remain, or -1 on failure
+ */
+static int kvmdal_nextprefix( KVTXN txn, const char* key, size_t keylen, size_t prefixlen,
+                              const char** nextkey, size_t* nextkeylen, const void** value, size_t* vallen ) {
+   const void* found = NULL;
+   int res = kvtxn_next( txn, key, keylen, 0, &(found), nextkeylen, value, vallen );
+   if ( res <= 0 ) { return res; }
+   if ( *nextkeylen < prefixlen  ||  memcmp( found, key, prefixlen ) ) { return 0; }
+   *nextkey = found;
+   return 1;
+}
+
+/**
+ * Retrieve the given inode
+ * @return int : Zero on success, or -1 w/ errno=ENOENT if the inode does not exist
+ */
+static int kvmdal_getinode( KVTXN txn, uint64_t ino, kvmdal_inode* inode ) {
+   char key[KMDAL_KEYMAX];
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_INODE, ino, NULL, 0 ), &(vallen) );
+   if ( val == NULL  ||  vallen != sizeof( kvmdal_inode ) ) {
+      if ( val ) { LOG( LOG_ERR, "Inode %llu has an invalid length of %zu\n", (unsigned long long)ino, vallen ); }
+      errno = ( val ) ? EIO : ENOENT;
+      return -1;
+   }
+   memcpy( inode, val, sizeof( kvmdal_inode ) );
+   return 0;
+}
+
+static int kvmdal_putinode( KVTXN txn, uint64_t ino, const kvmdal_inode* inode ) {
+   char key[KMDAL_KEYMAX];
+   return kvtxn_put( txn, key, kvmdal_key( key, KMDAL_KEY_INODE, ino, NULL, 0 ), inode, sizeof( kvmdal_inode ) );
+}
+
+/**
+ * Retrieve the record of the given NS
+ * @return int : Zero on success, or -1 w/ errno=ENOENT if the NS does not exist
+ */
+static int kvmdal_getns( KVTXN txn, uint64_t nsino, kvmdal_nsinfo* info ) {
+   char key[KMDAL_KEYMAX];
+   size_t vallen = 0;
+   const char* val = kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_NS, nsino, NULL, 0 ), &(vallen) );
+   if ( val == NULL  ||  vallen < sizeof( kvmdal_nsrec )  ||  vallen > sizeof( kvmdal_nsrec ) + NAME_MAX ) {
+      if ( val ) { LOG( LOG_ERR, "NS record %llu has an invalid length of %zu\n", (unsigned long long)nsino, vallen ); }
+      errno = ( val ) ? EIO : ENOENT;
+      return -1;
+   }
+   memcpy( &(info->rec), val, sizeof( kvmdal_nsrec ) );
+   info->namelen = vallen - sizeof( kvmdal_nsrec );
+   memcpy( info->name, val + sizeof( kvmdal_nsrec ), info->namelen );
+   info->name[info->namelen] = '\0';
+   return 0;
+}
+
+static int kvmdal_putns( KVTXN txn, uint64_t nsino, const kvmdal_nsinfo* info ) {
+   char key[KMDAL_KEYMAX];
+   char val[sizeof( kvmdal_nsrec ) + NAME_MAX];
+   memcpy( val, &(info->rec), sizeof( kvmdal_nsrec ) );
+   memcpy( val + sizeof( kvmdal_nsrec ), info->name, info->namelen );
+   return kvtxn_put( txn, key, kvmdal_key( key, KMDAL_KEY_NS, nsino, NULL, 0 ), val,
+                     sizeof( kvmdal_nsrec ) + info->namelen );
+}
+
+/**
+ * Retrieve the directory entry of the given name
+ * @return int : Zero on success, or -1 w/ errno=ENOENT if the entry does not exist
+ */
+static int kvmdal_lookup( KVTXN txn, uint64_t dir, const char* name, size_t namelen, kvmdal_dentry* dent ) {
+   char key[KMDAL_KEYMAX];
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_DENTRY, dir, name, namelen ), &(vallen) );
+   if ( val == NULL  ||  vallen != sizeof( kvmdal_dentry ) ) {
+      if ( val ) { LOG( LOG_ERR, "Entry \"%.*s\" has an invalid length of %zu\n", (int)namelen, name, vallen ); }
+      errno = ( val ) ? EIO : ENOENT;
+      return -1;
+   }
+   memcpy( dent, val, sizeof( kvmdal_dentry ) );
+   return 0;
+}
+
+/**
+ * Add a new entry to the given directory
+ * NOTE -- caller is responsible for storing the updated directory inode
+ * @param KVTXN txn : Write transaction to operate within
+ * @param uint64_t dirino : Inode of the directory
+ * @param kvmdal_inode* dir : Directory inode, to be updated
+ * @param const char* name : Name of the new entry
+ * @param size_t namelen : Length of the entry name
+ * @param uint64_t ino : Inode targeted by the new entry
+ * @param uint32_t mode : Mode of the targeted inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_addentry( KVTXN txn, uint64_t dirino, kvmdal_inode* dir, const char* name, size_t namelen,
+                            uint64_t ino, uint32_t mode ) {
+   char key[KMDAL_KEYMAX];
+   kvmdal_dentry dent = { .ino = ino, .cookie = dir->nextcookie, .mode = mode & S_IFMT, .unused = 0 };
+   char entval[sizeof( kvmdal_dirent ) + NAME_MAX];
+   kvmdal_dirent dirent = { .ino = ino, .mode = mode & S_IFMT, .unused = 0 };
+   memcpy( entval, &(dirent), sizeof( kvmdal_dirent ) );
+   memcpy( entval + sizeof( kvmdal_dirent ), name, namelen );
+   if ( kvtxn_put( txn, key, kvmdal_key( key, KMDAL_KEY_DENTRY, dirino, name, namelen ), &(dent), sizeof( kvmdal_dentry ) )  ||
+        kvtxn_put( txn, key, kvmdal_numkey( key, KMDAL_KEY_DIRENT, dirino, dent.cookie ), entval,
+                   sizeof( kvmdal_dirent ) + namelen ) ) {
+      LOG( LOG_ERR, "Failed to stage new directory entry: \"%.*s\"\n", (int)namelen, name );
+      return -1;
+   }
+   dir->nextcookie++;
+   kvmdal_now( dir->mtime );
+   memcpy( dir->ctime, dir->mtime, sizeof( dir->ctime ) );
+   return 0;
+}
+
+/**
+ * Remove an entry from the given directory
+ * NOTE -- caller is responsible for storing the updated directory inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_delentry( KVTXN txn, uint64_t dirino, kvmdal_inode* dir, const char* name, size_t namelen,
+                            uint64_t cookie ) {
+   char key[KMDAL_KEYMAX];
+   if ( kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_DENTRY, dirino, name, namelen ) )  ||
+        kvtxn_delete( txn, key, kvmdal_numkey( key, KMDAL_KEY_DIRENT, dirino, cookie ) ) ) {
+      LOG( LOG_ERR, "Failed to stage removal of directory entry: \"%.*s\"\n", (int)namelen, name );
+      return -1;
+   }
+   kvmdal_now( dir->mtime );
+   memcpy( dir->ctime, dir->mtime, sizeof( dir->ctime ) );
+   return 0;
+}
+
+/**
+ * Determine if the given directory contains any entries
+ * @return int : 1 if the dir is empty, 0 if not, or -1 if a failure occurred
+ */
+static int kvmdal_dirempty( KVTXN txn, uint64_t dirino ) {
+   char key[KMDAL_KEYMAX];
+   size_t keylen = kvmdal_key( key, KMDAL_KEY_DIRENT, dirino, NULL, 0 );
+   const char* nextkey;
+   size_t nextkeylen;
+   const void* val;
+   size_t vallen;
+   int res = kvmdal_nextprefix( txn, key, keylen, keylen, &(nextkey), &(nextkeylen), &(val), &(vallen) );
+   if ( res < 0 ) { return -1; }
+   return !(res);
+}
+
+/**
+ * Allocate and store a new inode
+ * @param KVTXN txn : Write transaction to operate within
+ * @param mode_t mode : Mode of the new inode ( including type )
+ * @param dev_t rdev : Device value of the new inode
+ * @param uint64_t parent : Parent directory of the new inode
+ * @param uint64_t* ino : Reference to be populated with the new inode number
+ * @param kvmdal_inode* inode : Reference to be populated with the new inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_newinode( KVTXN txn, mode_t mode, dev_t rdev, uint64_t parent, uint64_t* ino, kvmdal_inode* inode ) {
+   char key[KMDAL_KEYMAX];
+   key[0] = KMDAL_KEY_SUPER; // the superblock key has no inode component
+   size_t keylen = 1;
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, keylen, &(vallen) );
+   if ( val == NULL  ||  vallen != sizeof( kvmdal_super ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the store superblock\n" );
+      errno = EIO;
+      return -1;
+   }
+   kvmdal_super super;
+   memcpy( &(super), val, sizeof( kvmdal_super ) );
+   *ino = super.nextino;
+   super.nextino++;
+   if ( kvtxn_put( txn, key, keylen, &(super), sizeof( kvmdal_super ) ) ) {
+      LOG( LOG_ERR, "Failed to stage superblock update\n" );
+      return -1;
+   }
+   memset( inode, 0, sizeof( kvmdal_inode ) );
+   inode->mode = mode;
+   inode->uid = geteuid();
+   inode->gid = getegid();
+   inode->nlink = ( S_ISDIR( mode ) ) ? 2 : 1;
+   inode->size = ( S_ISDIR( mode ) ) ? KMDAL_BLOCKSIZE : 0;
+   inode->rdev = rdev;
+   inode->parent = ( S_ISDIR( mode ) ) ? parent : 0;
+   kvmdal_now( inode->atime );
+   memcpy( inode->mtime, inode->atime, sizeof( inode->mtime ) );
+   memcpy( inode->ctime, inode->atime, sizeof( inode->ctime ) );
+   if ( kvmdal_putinode( txn, *ino, inode ) ) {
+      LOG( LOG_ERR, "Failed to stage new inode %llu\n", (unsigned long long)*ino );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Create a new inode, linked into the given directory
+ * NOTE -- caller is responsible for storing the updated directory inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_create( KVTXN txn, uint64_t dirino, kvmdal_inode* dir, const char* name, size_t namelen,
+                          mode_t mode, dev_t rdev, uint64_t* ino, kvmdal_inode* inode ) {
+   if ( kvmdal_newinode( txn, mode, rdev, dirino, ino, inode ) ) { return -1; }
+   if ( kvmdal_addentry( txn, dirino, dir, name, namelen, *ino, mode ) ) { return -1; }
+   if ( S_ISDIR( mode ) ) { dir->nlink++; }
+   return 0;
+}
+
+/**
+ * Delete every key with the given prefix
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_purgeprefix( KVTXN txn, char type, uint64_t ino ) {
+   char key[KMDAL_KEYMAX];
+   size_t prefixlen = kvmdal_key( key, type, ino, NULL, 0 );
+   const char* nextkey = key;
+   size_t nextkeylen = prefixlen;
+   const void* val;
+   size_t vallen;
+   int res;
+   // NOTE -- the search only includes committed keys, so staged deletions don't affect it
+   while ( (res = kvmdal_nextprefix( txn, nextkey, nextkeylen, prefixlen, &(nextkey), &(nextkeylen), &(val), &(vallen) )) > 0 ) {
+      if ( kvtxn_delete( txn, nextkey, nextkeylen ) ) { return -1; }
+   }
+   return res;
+}
+
+/**
+ * Delete the given inode, along with all associated content
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_purge( KVTXN txn, uint64_t ino ) {
+   char key[KMDAL_KEYMAX];
+   LOG( LOG_INFO, "Purging inode %llu\n", (unsigned long long)ino );
+   if ( kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_INODE, ino, NULL, 0 ) )  ||
+        kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_LINK, ino, NULL, 0 ) )  ||
+        kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_ORPHAN, ino, NULL, 0 ) )  ||
+        kvmdal_purgeprefix( txn, KMDAL_KEY_XATTR, ino )  ||
+        kvmdal_purgeprefix( txn, KMDAL_KEY_BLOCK, ino ) ) {
+      LOG( LOG_ERR, "Failed to stage purge of inode %llu\n", (unsigned long long)ino );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Identify if the given inode is held open by any file handle
+ * @return size_t : Count of open handles referencing the inode
+ */
+static size_t kvmdal_opencount( KVMDAL_STORE store, uint64_t ino ) {
+   size_t count = 0;
+   pthread_mutex_lock( &(store->openlock) );
+   size_t index = 0;
+   for ( ; index < store->opencount; index++ ) {
+      if ( store->open[index].ino == ino ) { count = store->open[index].count; break; }
+   }
+   pthread_mutex_unlock( &(store->openlock) );
+   return count;
+}
+
+/**
+ * Record a new open file handle for the given inode
+ * NOTE -- caller must hold a transaction, to exclude concurrent unlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_openinode( KVMDAL_STORE store, uint64_t ino ) {
+   pthread_mutex_lock( &(store->openlock) );
+   size_t index = 0;
+   for ( ; index < store->opencount; index++ ) {
+      if ( store->open[index].ino == ino ) {
+         store->open[index].count++;
+         pthread_mutex_unlock( &(store->openlock) );
+         return 0;
+      }
+   }
+   if ( store->opencount == store->openalloc ) {
+      size_t newalloc = ( store->openalloc ) ? store->openalloc * 2 : 64;
+      kvmdal_openfile* newopen = realloc( store->open, sizeof( kvmdal_openfile ) * newalloc );
+      if ( newopen == NULL ) {
+         pthread_mutex_unlock( &(store->openlock) );
+         LOG( LOG_ERR, "Failed to expand the open inode table to %zu entries\n", newalloc );
+         return -1;
+      }
+      store->open = newopen;
+      store->openalloc = newalloc;
+   }
+   store->open[store->opencount].ino = ino;
+   store->open[store->opencount].count = 1;
+   store->opencount++;
+   pthread_mutex_unlock( &(store->openlock) );
+   return 0;
+}
+
+/**
+ * Release an open file handle reference to the given inode
+ * @return size_t : Count of open handles still referencing the inode
+ */
+static size_t kvmdal_closeinode( KVMDAL_STORE store, uint64_t ino ) {
+   size_t count = 0;
+   pthread_mutex_lock( &(store->openlock) );
+   size_t index = 0;
+   for ( ; index < store->opencount; index++ ) {
+      if ( store->open[index].ino == ino ) {
+         count = --(store->open[index].count);
+         if ( count == 0 ) {
+            // fill the gap with the final table entry
+            store->opencount--;
+            store->open[index] = store->open[store->opencount];
+         }
+         break;
+      }
+   }
+   pthread_mutex_unlock( &(store->openlock) );
+   return count;
+}
+
+/**
+ * Drop a link to the given inode, purging it once no links or open handles remain
+ * NOTE -- caller is responsible for removing the directory entry
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_droplink( KVTXN txn, KVMDAL_STORE store, uint64_t ino, kvmdal_inode* inode ) {
+   if ( S_ISDIR( inode->mode ) ) { inode->nlink = 0; }
+   else if ( inode->nlink ) { inode->nlink--; }
+   if ( inode->nlink ) {
+      kvmdal_now( inode->ctime );
+      return kvmdal_putinode( txn, ino, inode );
+   }
+   if ( kvmdal_opencount( store, ino ) == 0 ) { return kvmdal_purge( txn, ino ); }
+   // the final close() of the inode will perform the purge
+   char key[KMDAL_KEYMAX];
+   kvmdal_now( inode->ctime );
+   if ( kvmdal_putinode( txn, ino, inode )  ||
+        kvtxn_put( txn, key, kvmdal_key( key, KMDAL_KEY_ORPHAN, ino, NULL, 0 ), NULL, 0 ) ) {
+      LOG( LOG_ERR, "Failed to stage orphan record for inode %llu\n", (unsigned long long)ino );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Populate a stat struct from the given inode
+ */
+static void kvmdal_fillstat( KVMDAL_STORE store, uint64_t ino, const kvmdal_inode* inode, struct stat* st ) {
+   memset( st, 0, sizeof( struct stat ) );
+   st->st_dev = store->dev;
+   st->st_ino = (ino_t)ino;
+   st->st_mode = inode->mode;
+   st->st_nlink = inode->nlink;
+   st->st_uid = inode->uid;
+   st->st_gid = inode->gid;
+   st->st_rdev = (dev_t)inode->rdev;
+   st->st_size = (off_t)inode->size;
+   st->st_blksize = KMDAL_BLOCKSIZE;
+   st->st_blocks = (blkcnt_t)( inode->blocks * ( KMDAL_BLOCKSIZE / 512 ) );
+   st->st_atim.tv_sec = inode->atime[0];
+   st->st_atim.tv_nsec = inode->atime[1];
+   st->st_mtim.tv_sec = inode->mtime[0];
+   st->st_mtim.tv_nsec = inode->mtime[1];
+   st->st_ctim.tv_sec = inode->ctime[0];
+   st->st_ctim.tv_nsec = inode->ctime[1];
+}
+
+/**
+ * Check whether the calling process is a member of the given group
+ * @param gid_t primary : Primary gid of the caller ( real or effective, as appropriate )
+ * @param gid_t gid : Group to check membership of
+ * @return char : Non-zero if the caller is a member of the group, zero if not
+ */
+static char kvmdal_ingroup( gid_t primary, gid_t gid ) {
+   if ( primary == gid ) { return 1; }
+   gid_t groups[NGROUPS_MAX];
+   int groupcount = getgroups( NGROUPS_MAX, groups );
+   int index = 0;
+   for ( ; index < groupcount; index++ ) {
+      if ( groups[index] == gid ) { return 1; }
+   }
+   return 0;
+}
+
+/**
+ * Check the given access mode against the given inode
+ * @param const kvmdal_inode* inode : Inode to check access to
+ * @param int mode : F_OK, or a bitwise OR of R_OK / W_OK / X_OK
+ * @param int flags : If AT_EACCESS is set, checks are performed using the effective uid/gid
+ * @return int : Zero if access is permitted, or -1 w/ errno=EACCES if not
+ */
+static int kvmdal_checkaccess( const kvmdal_inode* inode, int mode, int flags ) {
+   if ( mode == F_OK ) { return 0; }
+   uid_t uid = ( flags & AT_EACCESS ) ? geteuid() : getuid();
+   gid_t gid = ( flags & AT_EACCESS ) ? getegid() : getgid();
+   mode_t perms;
+   if ( uid == 0 ) {
+      // root is only limited in execute access
+      perms = S_IRWXO & ~S_IXOTH;
+      if ( ( inode->mode & ( S_IXUSR | S_IXGRP | S_IXOTH ) )  ||  S_ISDIR( inode->mode ) ) { perms |= S_IXOTH; }
+   }
+   else if ( inode->uid == uid ) { perms = ( inode->mode & S_IRWXU ) >> 6; }
+   else if ( kvmdal_ingroup( gid, inode->gid ) ) { perms = ( inode->mode & S_IRWXG ) >> 3; }
+   else { perms = inode->mode & S_IRWXO; }
+   if ( ( ( mode & R_OK )  &&  !( perms & S_IROTH ) )  ||
+        ( ( mode & W_OK )  &&  !( perms & S_IWOTH ) )  ||
+        ( ( mode & X_OK )  &&  !( perms & S_IXOTH ) ) ) {
+      errno = EACCES;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check the given access mode against the specified inode, as the calling process
+ * @param KVTXN txn : Transaction to operate within
+ * @param uint64_t ino : Inode to check access to
+ * @param int mode : Bitwise OR of R_OK / W_OK / X_OK
+ * @return int : Zero if access is permitted, or -1 if not ( errno=EACCES ) or if a failure occurred
+ */
+static int kvmdal_permit( KVTXN txn, uint64_t ino, int mode ) {
+   kvmdal_inode inode;
+   if ( kvmdal_getinode( txn, ino, &(inode) ) ) { return -1; }
+   return kvmdal_checkaccess( &(inode), mode, AT_EACCESS );
+}
+
+/**
+ * Check that the calling process may remove ( or replace ) an entry of the given directory
+ * NOTE -- within a sticky directory, only the owner of the dir or of the entry may do so
+ * @param const kvmdal_inode* dir : Directory containing the entry
+ * @param const kvmdal_inode* inode : Inode referenced by the entry
+ * @return int : Zero if removal is permitted, or -1 w/ errno=EACCES or EPERM if not
+ */
+static int kvmdal_permitremove( const kvmdal_inode* dir, const kvmdal_inode* inode ) {
+   if ( kvmdal_checkaccess( dir, W_OK | X_OK, AT_EACCESS ) ) { return -1; }
+   uid_t uid = geteuid();
+   if ( ( dir->mode & S_ISVTX )  &&  uid != 0  &&  uid != dir->uid  &&  uid != inode->uid ) {
+      errno = EPERM;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check that the calling process owns the given inode ( or is root )
+ * @return int : Zero if the caller is the owner, or -1 w/ errno=EPERM if not
+ */
+static int kvmdal_permitowner( const kvmdal_inode* inode ) {
+   uid_t uid = geteuid();
+   if ( uid != 0  &&  uid != inode->uid ) {
+      errno = EPERM;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check that the calling process may apply the given ownership values to an inode
+ * NOTE -- as with chown(), only root may change the owner, and the owner may only change
+ *         the group to one that they are a member of
+ * @return int : Zero if the change is permitted, or -1 w/ errno=EPERM if not
+ */
+static int kvmdal_permitchown( const kvmdal_inode* inode, uid_t owner, gid_t group ) {
+   if ( geteuid() == 0 ) { return 0; }
+   if ( kvmdal_permitowner( inode ) ) { return -1; }
+   if ( ( owner != (uid_t)-1  &&  owner != inode->uid )  ||
+        ( group != (gid_t)-1  &&  group != inode->gid  &&  !(kvmdal_ingroup( getegid(), group )) ) ) {
+      errno = EPERM;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check that the calling process may apply the given timestamp values to an inode
+ * NOTE -- as with utimensat(), setting explicit values requires ownership, while setting the
+ *         current time only requires write access
+ * @return int : Zero if the change is permitted, or -1 w/ errno=EPERM or EACCES if not
+ */
+static int kvmdal_permittimes( const kvmdal_inode* inode, const struct timespec times[2] ) {
+   char explicit = 0;
+   if ( times ) {
+      if ( times[0].tv_nsec == UTIME_OMIT  &&  times[1].tv_nsec == UTIME_OMIT ) { return 0; }
+      int index = 0;
+      for ( ; index < 2; index++ ) {
+         if ( times[index].tv_nsec != UTIME_OMIT  &&  times[index].tv_nsec != UTIME_NOW ) { explicit = 1; }
+      }
+   }
+   if ( kvmdal_permitowner( inode ) == 0 ) { return 0; }
+   if ( explicit ) { return -1; }
+   return kvmdal_checkaccess( inode, W_OK, AT_EACCESS );
+}
+
+/**
+ * Traverse the given path
+ * NOTE -- a missing final path element is not considered an error ( res->ino will be zero )
+ * @param KVTXN txn : Transaction to operate within
+ * @param uint64_t start : Directory to interpret the path relative to
+ * @param const char* path : Path to traverse
+ * @param char follow : If non-zero, a symlink final path element will be followed
+ * @param kvmdal_walkres* res : Reference to be populated with the traversal result
+ * @param int* links : Reference to a count of symlinks followed, so far
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_walk( KVTXN txn, uint64_t start, const char* path, char follow, kvmdal_walkres* res, int* links ) {
+   if ( path == NULL  ||  *path == '\0' ) {
+      LOG( LOG_ERR, "Received a NULL or empty path\n" );
+      errno = ( path ) ? ENOENT : EINVAL;
+      return -1;
+   }
+   if ( *path == '/' ) {
+      LOG( LOG_ERR, "Absolute paths cannot be used: \"%s\"\n", path );
+      errno = EXDEV;
+      return -1;
+   }
+   uint64_t cur = start;
+   const char* parse = path;
+   while ( 1 ) {
+      // identify the next path element
+      const char* elem = parse;
+      while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+      size_t elemlen = parse - elem;
+      while ( *parse == '/' ) { parse++; }
+      char last = ( *parse == '\0' );
+      if ( elemlen > NAME_MAX ) {
+         LOG( LOG_ERR, "Path element exceeds max length: \"%.*s\"\n", (int)elemlen, elem );
+         errno = ENAMETOOLONG;
+         return -1;
+      }
+      // as with kernel path resolution, every element requires search access to its directory
+      if ( kvmdal_permit( txn, cur, X_OK ) ) {
+         LOG( LOG_INFO, "Search access denied for element \"%.*s\" of path \"%s\"\n", (int)elemlen, elem, path );
+         return -1;
+      }
+      if ( elemlen == 1  &&  *elem == '.' ) {
+         if ( last ) {
+            res->parent = 0;
+            res->ino = cur;
+            break;
+         }
+         continue;
+      }
+      if ( elemlen == 2  &&  elem[0] == '.'  &&  elem[1] == '.' ) {
+         kvmdal_inode dir;
+         if ( kvmdal_getinode( txn, cur, &(dir) ) ) { return -1; }
+         if ( dir.parent == 0 ) {
+            LOG( LOG_ERR, "Path traverses above its root: \"%s\"\n", path );
+            errno = EXDEV;
+            return -1;
+         }
+         cur = dir.parent;
+         if ( last ) {
+            res->parent = 0;
+            res->ino = cur;
+            break;
+         }
+         continue;
+      }
+      kvmdal_dentry dent;
+      if ( kvmdal_lookup( txn, cur, elem, elemlen, &(dent) ) ) {
+         if ( errno != ENOENT  ||  !(last) ) { return -1; }
+         // the final element may be missing
+         res->parent = cur;
+         res->ino = 0;
+         memcpy( res->name, elem, elemlen );
+         res->name[elemlen] = '\0';
+         res->namelen = elemlen;
+         break;
+      }
+      if ( S_ISLNK( dent.mode )  &&  ( !(last)  ||  follow  ||  elem[elemlen] == '/' ) ) {
+         // traverse the symlink target, relative to the current dir
+         if ( ++(*links) > KMDAL_MAXSYMLINKS ) {
+            LOG( LOG_ERR, "Encountered too many symlinks while traversing: \"%s\"\n", path );
+            errno = ELOOP;
+            return -1;
+         }
+         char key[KMDAL_KEYMAX];
+         size_t tgtlen = 0;
+         const char* tgt = kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_LINK, dent.ino, NULL, 0 ), &(tgtlen) );
+         if ( tgt == NULL ) {
+            LOG( LOG_ERR, "Failed to retrieve the target of symlink: \"%.*s\"\n", (int)elemlen, elem );
+            errno = EIO;
+            return -1;
+         }
+         char* target = strndup( tgt, tgtlen );
+         if ( target == NULL ) {
+            LOG( LOG_ERR, "Failed to allocate a symlink target string\n" );
+            return -1;
+         }
+         kvmdal_walkres lres;
+         int walkres = kvmdal_walk( txn, cur, target, 1, &(lres), links );
+         free( target );
+         if ( walkres ) { return -1; }
+         if ( last ) {
+            *res = lres;
+            break;
+         }
+         if ( lres.ino == 0 ) {
+            errno = ENOENT;
+            return -1;
+         }
+         dent.ino = lres.ino;
+         dent.mode = S_IFDIR;
+         if ( lres.parent ) { dent.mode = lres.dent.mode; }
+      }
+      if ( last ) {
+         res->parent = cur;
+         res->ino = dent.ino;
+         res->dent = dent;
+         memcpy( res->name, elem, elemlen );
+         res->name[elemlen] = '\0';
+         res->namelen = elemlen;
+         break;
+      }
+      if ( !(S_ISDIR( dent.mode )) ) {
+         LOG( LOG_ERR, "Path element is not a directory: \"%.*s\"\n", (int)elemlen, elem );
+         errno = ENOTDIR;
+         return -1;
+      }
+      cur = dent.ino;
+   }
+   res->trailing = ( path[ strlen(path) - 1 ] == '/' );
+   if ( res->trailing  &&  res->ino  &&  res->parent  &&  !(S_ISDIR( res->dent.mode )) ) {
+      LOG( LOG_ERR, "Path with trailing '/' does not target a directory: \"%s\"\n", path );
+      errno = ENOTDIR;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Traverse the given path, requiring that the final path element exists
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_resolve( KVTXN txn, uint64_t start, const char* path, char follow, kvmdal_walkres* res ) {
+   int links = 0;
+   if ( kvmdal_walk( txn, start, path, follow, res, &(links) ) ) { return -1; }
+   if ( res->ino == 0 ) {
+      LOG( LOG_INFO, "Target does not exist: \"%s\"\n", path );
+      errno = ENOENT;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Traverse the given path, requiring that the final path element does not exist
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_resolvenew( KVTXN txn, uint64_t start, const char* path, kvmdal_walkres* res ) {
+   int links = 0;
+   if ( kvmdal_walk( txn, start, path, 0, res, &(links) ) ) { return -1; }
+   if ( res->ino ) {
+      LOG( LOG_INFO, "Target already exists: \"%s\"\n", path );
+      errno = EEXIST;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Resolve the given NS path
+ * @param KVTXN txn : Transaction to operate within ( must be a write transaction, if 'create' is set )
+ * @param KV_MDAL_CTXT kctxt : MDAL_CTXT to interpret the NS path relative to
+ * @param const char* ns : NS path to resolve
+ * @param char create : If non-zero, any missing namespaces will be created
+ * @param uint64_t* nsino : Reference to be populated with the inode of the resolved NS
+ * @param kvmdal_nsinfo* info : Reference to be populated with the record of the resolved NS
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_resolvens( KVTXN txn, KV_MDAL_CTXT kctxt, const char* ns, char create, uint64_t* nsino, kvmdal_nsinfo* info ) {
+   if ( ns == NULL ) {
+      LOG( LOG_ERR, "Received a NULL NS path arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   uint64_t cur;
+   const char* parse = ns;
+   if ( *parse == '/' ) {
+      // ensure the ctxt has no NS target
+      if ( kctxt->pathns ) {
+         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
+         errno = EINVAL;
+         return -1;
+      }
+      cur = KMDAL_ROOTINO;
+   }
+   else {
+      // ensure the ctxt has a NS target
+      if ( kctxt->pathns == 0 ) {
+         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
+         errno = EINVAL;
+         return -1;
+      }
+      // relative paths are interpreted from the reference NS
+      cur = kctxt->refns;
+   }
+   if ( kvmdal_getns( txn, cur, info ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the record of the starting NS of \"%s\"\n", ns );
+      return -1;
+   }
+   int elemcount = 0;
+   while ( 1 ) {
+      // identify the next path element
+      while ( *parse == '/' ) { parse++; }
+      if ( *parse == '\0' ) { break; }
+      const char* elem = parse;
+      while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+      size_t elemlen = parse - elem;
+      elemcount++;
+      if ( elemlen == 1  &&  *elem == '.' ) { continue; }
+      if ( elemlen == 2  &&  elem[0] == '.'  &&  elem[1] == '.' ) {
+         if ( info->rec.parent == 0 ) {
+            LOG( LOG_ERR, "NS path traverses above the root NS: \"%s\"\n", ns );
+            errno = ENOENT;
+            return -1;
+         }
+         cur = info->rec.parent;
+         if ( kvmdal_getns( txn, cur, info ) ) {
+            LOG( LOG_ERR, "Failed to retrieve the record of a parent NS of \"%s\"\n", ns );
+            return -1;
+         }
+         continue;
+      }
+      if ( elemlen > NAME_MAX ) {
+         LOG( LOG_ERR, "NS path element exceeds max length: \"%.*s\"\n", (int)elemlen, elem );
+         errno = ENAMETOOLONG;
+         return -1;
+      }
+      char key[KMDAL_KEYMAX];
+      size_t keylen = kvmdal_key( key, KMDAL_KEY_SUBSP, cur, elem, elemlen );
+      size_t vallen = 0;
+      const void* val = kvtxn_get( txn, key, keylen, &(vallen) );
+      if ( val ) {
+         if ( vallen != sizeof( uint64_t ) ) {
+            LOG( LOG_ERR, "Subspace entry \"%.*s\" has an invalid length of %zu\n", (int)elemlen, elem, vallen );
+            errno = EIO;
+            return -1;
+         }
+         memcpy( &(cur), val, sizeof( uint64_t ) );
+         if ( kvmdal_getns( txn, cur, info ) ) {
+            LOG( LOG_ERR, "Failed to retrieve the record of subspace \"%.*s\"\n", (int)elemlen, elem );
+            return -1;
+         }
+         continue;
+      }
+      if ( !(create) ) {
+         LOG( LOG_INFO, "NS \"%.*s\" of NS path \"%s\" does not exist\n", (int)elemlen, elem, ns );
+         errno = ENOENT;
+         return -1;
+      }
+      // as with a mkdir of the NS root dir, creation requires write and search access to the parent NS
+      if ( kvmdal_permit( txn, cur, W_OK | X_OK ) ) {
+         LOG( LOG_ERR, "Access denied for creation of NS \"%.*s\"\n", (int)elemlen, elem );
+         return -1;
+      }
+      // create the missing NS ( all intermediate NSes allow global traversal )
+      while ( *parse == '/' ) { parse++; }
+      mode_t mode = S_IFDIR | S_IRWXU;
+      if ( *parse != '\0' ) { mode |= S_IXOTH; }
+      uint64_t newns;
+      kvmdal_inode nsinode;
+      if ( kvmdal_newinode( txn, mode, 0, 0, &(newns), &(nsinode) ) ) {
+         LOG( LOG_ERR, "Failed to create a root dir for NS \"%.*s\"\n", (int)elemlen, elem );
+         return -1;
+      }
+      memset( &(info->rec), 0, sizeof( kvmdal_nsrec ) );
+      info->rec.parent = cur;
+      memcpy( info->name, elem, elemlen );
+      info->name[elemlen] = '\0';
+      info->namelen = elemlen;
+      if ( kvmdal_putns( txn, newns, info )  ||  kvtxn_put( txn, key, keylen, &(newns), sizeof( uint64_t ) ) ) {
+         LOG( LOG_ERR, "Failed to stage records of new NS \"%.*s\"\n", (int)elemlen, elem );
+         return -1;
+      }
+      LOG( LOG_INFO, "Created NS \"%.*s\" ( ino %llu )\n", (int)elemlen, elem, (unsigned long long)newns );
+      cur = newns;
+   }
+   if ( elemcount == 0 ) {
+      LOG( LOG_ERR, "NS path has no elements: \"%s\"\n", ns );
+      errno = EINVAL;
+      return -1;
+   }
+   *nsino = cur;
+   return 0;
+}
+
+/**
+ * Resolve the given NS path, requiring that the NS has a reference tree
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_resolvensref( KVTXN txn, KV_MDAL_CTXT kctxt, const char* ns, uint64_t* nsino, kvmdal_nsinfo* info ) {
+   if ( kvmdal_resolvens( txn, kctxt, ns, 0, nsino, info ) ) { return -1; }
+   if ( info->rec.refroot == 0 ) {
+      LOG( LOG_ERR, "NS \"%s\" has no reference tree\n", ns );
+      errno = ENOENT;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Initialize the content of a new store, and purge any orphaned inodes of a previous process
+ * @param KVMDAL_STORE store : Store to be initialized
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_bootstrap( KVMDAL_STORE store ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   char key[KMDAL_KEYMAX];
+   key[0] = KMDAL_KEY_SUPER;
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, 1, &(vallen) );
+   if ( val ) {
+      kvmdal_super super;
+      if ( vallen != sizeof( kvmdal_super ) ) {
+         LOG( LOG_ERR, "Store superblock has an invalid length of %zu\n", vallen );
+         kvtxn_abort( txn );
+         errno = EIO;
+         return -1;
+      }
+      memcpy( &(super), val, sizeof( kvmdal_super ) );
+      if ( super.version != KMDAL_VERSION ) {
+         LOG( LOG_ERR, "Store has an unrecognized version value: %llu\n", (unsigned long long)super.version );
+         kvtxn_abort( txn );
+         errno = EIO;
+         return -1;
+      }
+   }
+   else {
+      // populate the superblock and the root NS
+      LOG( LOG_INFO, "Initializing a new store\n" );
+      kvmdal_super super = { .version = KMDAL_VERSION, .nextino = KMDAL_ROOTINO };
+      if ( kvtxn_put( txn, key, 1, &(super), sizeof( kvmdal_super ) ) ) {
+         LOG( LOG_ERR, "Failed to stage the store superblock\n" );
+         return kvmdal_abort( txn );
+      }
+      uint64_t rootino;
+      kvmdal_inode rootinode;
+      kvmdal_nsinfo rootinfo;
+      memset( &(rootinfo), 0, sizeof( kvmdal_nsinfo ) );
+      if ( kvmdal_newinode( txn, S_IFDIR | S_IRWXU, 0, 0, &(rootino), &(rootinode) )  ||
+           kvmdal_putns( txn, rootino, &(rootinfo) ) ) {
+         LOG( LOG_ERR, "Failed to stage the root NS\n" );
+         return kvmdal_abort( txn );
+      }
+   }
+   // purge any inodes left open by a previous process
+   key[0] = KMDAL_KEY_ORPHAN;
+   size_t prefixlen = 1;
+   const char* nextkey = key;
+   size_t nextkeylen = prefixlen;
+   int res;
+   while ( (res = kvmdal_nextprefix( txn, nextkey, nextkeylen, prefixlen, &(nextkey), &(nextkeylen), &(val), &(vallen) )) > 0 ) {
+      if ( nextkeylen == 9  &&  kvmdal_purge( txn, kvmdal_getu64( nextkey + 1 ) ) ) { return kvmdal_abort( txn ); }
+   }
+   if ( res < 0 ) {
+      LOG( LOG_ERR, "Failed to scan for orphaned inodes\n" );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Open the store beneath the given directory, or take a reference to it if already opened
+ * @param const char* path : Path of the store directory
+ * @param int flags : kvstore_open() flags
+ * @return KVMDAL_STORE : Reference to the store, or NULL if a failure occurred
+ */
+static KVMDAL_STORE kvmdal_openstore( const char* path, int flags ) {
+   errno = 0;
+   if ( mkdir( path, S_IRWXU )  &&  errno != EEXIST ) {
+      LOG( LOG_ERR, "Failed to create store directory: \"%s\"\n", path );
+      return NULL;
+   }
+   int dirfd = open( path, O_RDONLY | O_DIRECTORY );
+   if ( dirfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open store directory: \"%s\"\n", path );
+      return NULL;
+   }
+   struct stat dirstat;
+   if ( fstat( dirfd, &(dirstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat store directory: \"%s\"\n", path );
+      close( dirfd );
+      return NULL;
+   }
+   pthread_mutex_lock( &(kvmdal_registrylock) );
+   // check for an existing reference to the same store
+   KVMDAL_STORE store = kvmdal_registry;
+   for ( ; store; store = store->next ) {
+      if ( store->dev == dirstat.st_dev  &&  store->ino == dirstat.st_ino ) {
+         store->refs++;
+         pthread_mutex_unlock( &(kvmdal_registrylock) );
+         LOG( LOG_INFO, "Using previously opened store: \"%s\"\n", path );
+         close( dirfd );
+         return store;
+      }
+   }
+   store = calloc( 1, sizeof( struct kvmdal_store_struct ) );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a store structure\n" );
+      pthread_mutex_unlock( &(kvmdal_registrylock) );
+      close( dirfd );
+      return NULL;
+   }
+   store->dirfd = dirfd;
+   store->dev = dirstat.st_dev;
+   store->ino = dirstat.st_ino;
+   store->refs = 1;
+   pthread_mutex_init( &(store->openlock), NULL );
+   store->kvs = kvstore_open( path, flags );
+   if ( store->kvs == NULL  ||  kvmdal_bootstrap( store ) ) {
+      int olderrno = errno;
+      LOG( LOG_ERR, "Failed to open store: \"%s\"\n", path );
+      pthread_mutex_unlock( &(kvmdal_registrylock) );
+      if ( store->kvs ) { kvstore_close( store->kvs ); }
+      pthread_mutex_destroy( &(store->openlock) );
+      close( dirfd );
+      free( store );
+      errno = olderrno;
+      return NULL;
+   }
+   store->next = kvmdal_registry;
+   kvmdal_registry = store;
+   pthread_mutex_unlock( &(kvmdal_registrylock) );
+   return store;
+}
+
+/**
+ * Take an additional reference to the given store
+ */
+static void kvmdal_holdstore( KVMDAL_STORE store ) {
+   pthread_mutex_lock( &(kvmdal_registrylock) );
+   store->refs++;
+   pthread_mutex_unlock( &(kvmdal_registrylock) );
+}
+
+/**
+ * Release a reference to the given store, closing it once no references remain
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_dropstore( KVMDAL_STORE store ) {
+   pthread_mutex_lock( &(kvmdal_registrylock) );
+   if ( --(store->refs) ) {
+      pthread_mutex_unlock( &(kvmdal_registrylock) );
+      return 0;
+   }
+   KVMDAL_STORE* ref = &(kvmdal_registry);
+   while ( *ref != store ) { ref = &((*ref)->next); }
+   *ref = store->next;
+   pthread_mutex_unlock( &(kvmdal_registrylock) );
+   int retval = 0;
+   if ( kvstore_close( store->kvs ) ) {
+      LOG( LOG_ERR, "Failed to close store\n" );
+      retval = -1;
+   }
+   if ( close( store->dirfd ) ) {
+      LOG( LOG_WARNING, "Failed to close store directory\n" );
+   }
+   pthread_mutex_destroy( &(store->openlock) );
+   free( store->open );
+   free( store );
+   return retval;
+}
+
+/**
+ * Identify if the given xattr name is targeting a reserved value
+ * @param const char* name : Xattr name string
+ * @param char hidden : If zero, reserved names are not acceptable
+ *                      If non-zero, only reserved names are acceptable
+ * @return : Zero if the name is acceptable, -1 if not
+ */
+static int kvmdal_xattrfilter( const char* name, char hidden ) {
+   int match = ( strncmp( name, KMDAL_XATTR, strlen(KMDAL_XATTR) ) == 0 );
+   if ( hidden ) { return ( match ) ? 0 : -1; }
+   return ( match ) ? -1 : 0;
+}
+
+/**
+ * Produce the key of the given xattr
+ * @param char* key : Buffer of at least KMDAL_KEYMAX bytes, to be populated
+ * @param uint64_t ino : Inode of the xattr
+ * @param char hidden : If non-zero, the name is of a 'hidden' MDAL value
+ * @param const char* name : Name of the xattr
+ * @return size_t : Length of the produced key, or zero if the name is invalid
+ */
+static size_t kvmdal_xattrkey( char* key, uint64_t ino, char hidden, const char* name ) {
+   if ( name == NULL ) {
+      LOG( LOG_ERR, "Received a NULL xattr name\n" );
+      errno = EINVAL;
+      return 0;
+   }
+   if ( !(hidden)  &&  kvmdal_xattrfilter( name, hidden ) ) {
+      LOG( LOG_ERR, "Xattr has a reserved name string: \"%s\"\n", name );
+      errno = EPERM;
+      return 0;
+   }
+   size_t prefixlen = ( hidden ) ? strlen( KMDAL_XATTR ) : 0;
+   size_t namelen = strlen( name );
+   if ( namelen == 0  ||  prefixlen + namelen > NAME_MAX ) {
+      LOG( LOG_ERR, "Xattr name has an invalid length: \"%s\"\n", name );
+      errno = ( namelen ) ? ERANGE : EINVAL;
+      return 0;
+   }
+   size_t keylen = kvmdal_key( key, KMDAL_KEY_XATTR, ino, KMDAL_XATTR, prefixlen );
+   memcpy( key + keylen, name, namelen );
+   return keylen + namelen;
+}
+
+/**
+ * Set the specified xattr of the given inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_setxattr( KVMDAL_STORE store, uint64_t ino, char hidden, const char* name,
+                            const void* value, size_t size, int flags ) {
+   char key[KMDAL_KEYMAX];
+   size_t keylen = kvmdal_xattrkey( key, ino, hidden, name );
+   if ( keylen == 0 ) { return -1; }
+   if ( size > KMDAL_XATTRMAX ) {
+      LOG( LOG_ERR, "Xattr value exceeds max size: %zu\n", size );
+      errno = E2BIG;
+      return -1;
+   }
+   if ( flags & ~(XATTR_CREATE | XATTR_REPLACE) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_inode inode;
+   if ( kvmdal_getinode( txn, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the inode of the target\n" );
+      return kvmdal_abort( txn );
+   }
+   if ( kvmdal_checkaccess( &(inode), W_OK, AT_EACCESS ) ) {
+      LOG( LOG_ERR, "Access denied for set of xattr: \"%s\"\n", name );
+      return kvmdal_abort( txn );
+   }
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, keylen, &(vallen) );
+   if ( val  &&  ( flags & XATTR_CREATE ) ) {
+      LOG( LOG_ERR, "Xattr already exists: \"%s\"\n", name );
+      kvtxn_abort( txn );
+      errno = EEXIST;
+      return -1;
+   }
+   if ( val == NULL  &&  ( flags & XATTR_REPLACE ) ) {
+      LOG( LOG_ERR, "Xattr does not exist: \"%s\"\n", name );
+      kvtxn_abort( txn );
+      errno = ENODATA;
+      return -1;
+   }
+   kvmdal_now( inode.ctime );
+   if ( kvtxn_put( txn, key, keylen, value, size )  ||  kvmdal_putinode( txn, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to stage xattr value: \"%s\"\n", name );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Retrieve the specified xattr of the given inode
+ * @return ssize_t : Size of the xattr value, or -1 if a failure occurred
+ */
+static ssize_t kvmdal_getxattr( KVMDAL_STORE store, uint64_t ino, char hidden, const char* name, void* value, size_t size ) {
+   char key[KMDAL_KEYMAX];
+   size_t keylen = kvmdal_xattrkey( key, ino, hidden, name );
+   if ( keylen == 0 ) { return -1; }
+   KVTXN txn = kvstore_begin( store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   if ( kvmdal_permit( txn, ino, R_OK ) ) {
+      LOG( LOG_ERR, "Access denied for retrieval of xattr: \"%s\"\n", name );
+      return kvmdal_abort( txn );
+   }
+   size_t vallen = 0;
+   const void* val = kvtxn_get( txn, key, keylen, &(vallen) );
+   if ( val == NULL ) {
+      LOG( LOG_INFO, "Xattr does not exist: \"%s\"\n", name );
+      kvtxn_abort( txn );
+      errno = ENODATA;
+      return -1;
+   }
+   if ( size ) {
+      if ( vallen > size ) {
+         LOG( LOG_ERR, "Xattr value exceeds the provided buffer size: \"%s\"\n", name );
+         kvtxn_abort( txn );
+         errno = ERANGE;
+         return -1;
+      }
+      memcpy( value, val, vallen );
+   }
+   kvtxn_abort( txn );
+   return (ssize_t)vallen;
+}
+
+/**
+ * Remove the specified xattr of the given inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_removexattr( KVMDAL_STORE store, uint64_t ino, char hidden, const char* name ) {
+   char key[KMDAL_KEYMAX];
+   size_t keylen = kvmdal_xattrkey( key, ino, hidden, name );
+   if ( keylen == 0 ) { return -1; }
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   size_t vallen = 0;
+   kvmdal_inode inode;
+   if ( kvtxn_get( txn, key, keylen, &(vallen) ) == NULL ) {
+      LOG( LOG_INFO, "Xattr does not exist: \"%s\"\n", name );
+      kvtxn_abort( txn );
+      errno = ENODATA;
+      return -1;
+   }
+   if ( kvmdal_getinode( txn, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the inode of the target\n" );
+      return kvmdal_abort( txn );
+   }
+   if ( kvmdal_checkaccess( &(inode), W_OK, AT_EACCESS ) ) {
+      LOG( LOG_ERR, "Access denied for removal of xattr: \"%s\"\n", name );
+      return kvmdal_abort( txn );
+   }
+   kvmdal_now( inode.ctime );
+   if ( kvtxn_delete( txn, key, keylen )  ||  kvmdal_putinode( txn, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to stage xattr removal: \"%s\"\n", name );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * List the xattrs of the given inode
+ * @return ssize_t : Size of the xattr name list, or -1 if a failure occurred
+ */
+static ssize_t kvmdal_listxattr( KVMDAL_STORE store, uint64_t ino, char hidden, char* buf, size_t size ) {
+   KVTXN txn = kvstore_begin( store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   if ( kvmdal_permit( txn, ino, R_OK ) ) {
+      LOG( LOG_ERR, "Access denied for listing of xattrs\n" );
+      return kvmdal_abort( txn );
+   }
+   char key[KMDAL_KEYMAX];
+   size_t prefixlen = kvmdal_key( key, KMDAL_KEY_XATTR, ino, NULL, 0 );
+   size_t skiplen = ( hidden ) ? strlen( KMDAL_XATTR ) : 0;
+   const char* nextkey = key;
+   size_t nextkeylen = prefixlen;
+   const void* val;
+   size_t vallen;
+   size_t listlen = 0;
+   int res;
+   while ( (res = kvmdal_nextprefix( txn, nextkey, nextkeylen, prefixlen, &(nextkey), &(nextkeylen), &(val), &(vallen) )) > 0 ) {
+      char name[NAME_MAX + 1];
+      size_t namelen = nextkeylen - prefixlen;
+      memcpy( name, nextkey + prefixlen, namelen );
+      name[namelen] = '\0';
+      if ( kvmdal_xattrfilter( name, hidden ) ) { continue; }
+      namelen -= skiplen;
+      if ( size ) {
+         if ( listlen + namelen + 1 > size ) {
+            LOG( LOG_ERR, "Xattr list exceeds the provided buffer size\n" );
+            bzero( buf, size );
+            kvtxn_abort( txn );
+            errno = ERANGE;
+            return -1;
+         }
+         memcpy( buf + listlen, name + skiplen, namelen + 1 );
+      }
+      listlen += namelen + 1;
+   }
+   kvtxn_abort( txn );
+   if ( res < 0 ) {
+      LOG( LOG_ERR, "Failed to iterate over xattrs\n" );
+      return -1;
+   }
+   return (ssize_t)listlen;
+}
+
+/**
+ * Allocate a new directory handle for the given inode
+ * @return KV_DHANDLE : New directory handle, or NULL if a failure occurred
+ */
+static KV_DHANDLE kvmdal_newdhandle( KVMDAL_STORE store, uint64_t ino ) {
+   KV_DHANDLE dh = calloc( 1, sizeof( struct kvmdal_directory_handle_struct ) );
+   if ( dh == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new directory handle\n" );
+      return NULL;
+   }
+   kvmdal_holdstore( store );
+   dh->store = store;
+   dh->ino = ino;
+   dh->loc = 0;
+   return dh;
+}
+
+/**
+ * Open a directory handle for the given path
+ * @return KV_DHANDLE : New directory handle, or NULL if a failure occurred
+ */
+static KV_DHANDLE kvmdal_opendirat( KVMDAL_STORE store, uint64_t start, const char* path ) {
+   KVTXN txn = kvstore_begin( store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return NULL;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   if ( kvmdal_resolve( txn, start, path, 1, &(res) )  ||  kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+      LOG( LOG_INFO, "Failed to locate the target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      kvmdal_abort( txn );
+      return NULL;
+   }
+   kvtxn_abort( txn );
+   if ( !(S_ISDIR( inode.mode )) ) {
+      LOG( LOG_ERR, "Target is not a directory: \"%s\"\n", path );
+      errno = ENOTDIR;
+      return NULL;
+   }
+   if ( kvmdal_checkaccess( &(inode), R_OK, AT_EACCESS ) ) {
+      LOG( LOG_ERR, "Access denied for read of directory: \"%s\"\n", path );
+      return NULL;
+   }
+   return kvmdal_newdhandle( store, res.ino );
+}
+
+/**
+ * Populate the dirent of the given directory handle with its next entry
+ * @param KVTXN txn : Transaction to operate within
+ * @param KV_DHANDLE dh : Directory handle to read from
+ * @return int : 1 if an entry was produced, 0 if no entries remain, or -1 if a failure occurred
+ */
+static int kvmdal_nextdirent( KVTXN txn, KV_DHANDLE dh ) {
+   if ( dh->loc < 2 ) {
+      // produce the '.' and '..' entries
+      uint64_t ino = dh->ino;
+      if ( dh->loc == 1 ) {
+         kvmdal_inode dir;
+         if ( kvmdal_getinode( txn, dh->ino, &(dir) ) ) {
+            LOG( LOG_ERR, "Failed to retrieve the inode of the open directory\n" );
+            return -1;
+         }
+         if ( dir.parent ) { ino = dir.parent; }
+      }
+      dh->ent.d_ino = (ino_t)ino;
+      dh->ent.d_type = DT_DIR;
+      snprintf( dh->ent.d_name, sizeof( dh->ent.d_name ), ( dh->loc ) ? ".." : "." );
+      dh->loc++;
+   }
+   else {
+      char key[KMDAL_KEYMAX];
+      size_t keylen = kvmdal_numkey( key, KMDAL_KEY_DIRENT, dh->ino, (uint64_t)( dh->loc - 2 ) );
+      const void* found = NULL;
+      size_t nextkeylen;
+      const void* val;
+      size_t vallen;
+      // the entry at the current location itself may be produced
+      int res = kvtxn_next( txn, key, keylen, 1, &(found), &(nextkeylen), &(val), &(vallen) );
+      if ( res <= 0 ) { return res; }
+      const char* nextkey = found;
+      if ( nextkeylen != 17  ||  memcmp( nextkey, key, 9 ) ) { return 0; }
+      if ( vallen <= sizeof( kvmdal_dirent )  ||  vallen > sizeof( kvmdal_dirent ) + NAME_MAX ) {
+         LOG( LOG_ERR, "Encountered a readdir entry with an invalid length of %zu\n", vallen );
+         errno = EIO;
+         return -1;
+      }
+      kvmdal_dirent dirent;
+      memcpy( &(dirent), val, sizeof( kvmdal_dirent ) );
+      dh->ent.d_ino = (ino_t)dirent.ino;
+      dh->ent.d_type = IFTODT( dirent.mode );
+      size_t namelen = vallen - sizeof( kvmdal_dirent );
+      memcpy( dh->ent.d_name, (const char*)val + sizeof( kvmdal_dirent ), namelen );
+      dh->ent.d_name[namelen] = '\0';
+      dh->loc = (long)kvmdal_getu64( nextkey + 9 ) + 3;
+   }
+   dh->ent.d_off = dh->loc;
+   dh->ent.d_reclen = sizeof( struct dirent );
+   return 1;
+}
+
+/**
+ * Truncate the given file inode to the specified length
+ * NOTE -- caller is responsible for storing the updated inode
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_truncate( KVTXN txn, uint64_t ino, kvmdal_inode* inode, uint64_t length ) {
+   if ( length < inode->size ) {
+      // drop all blocks entirely beyond the new length
+      uint64_t firstdrop = ( length + KMDAL_BLOCKSIZE - 1 ) / KMDAL_BLOCKSIZE;
+      char key[KMDAL_KEYMAX];
+      const char* nextkey = key;
+      size_t nextkeylen = ( firstdrop ) ? kvmdal_numkey( key, KMDAL_KEY_BLOCK, ino, firstdrop - 1 ) :
+                                          kvmdal_key( key, KMDAL_KEY_BLOCK, ino, NULL, 0 );
+      const void* val;
+      size_t vallen;
+      int res;
+      while ( (res = kvmdal_nextprefix( txn, nextkey, nextkeylen, 9, &(nextkey), &(nextkeylen), &(val), &(vallen) )) > 0 ) {
+         if ( kvtxn_delete( txn, nextkey, nextkeylen ) ) { return -1; }
+         if ( inode->blocks ) { inode->blocks--; }
+      }
+      if ( res < 0 ) {
+         LOG( LOG_ERR, "Failed to iterate over the data blocks of inode %llu\n", (unsigned long long)ino );
+         return -1;
+      }
+      // trim the final, partial block
+      if ( length % KMDAL_BLOCKSIZE ) {
+         size_t keylen = kvmdal_numkey( key, KMDAL_KEY_BLOCK, ino, length / KMDAL_BLOCKSIZE );
+         val = kvtxn_get( txn, key, keylen, &(vallen) );
+         if ( val  &&  vallen > length % KMDAL_BLOCKSIZE  &&
+              kvtxn_put( txn, key, keylen, val, length % KMDAL_BLOCKSIZE ) ) { return -1; }
+      }
+   }
+   inode->size = length;
+   kvmdal_now( inode->mtime );
+   memcpy( inode->ctime, inode->mtime, sizeof( inode->ctime ) );
+   return 0;
+}
+
+/**
+ * Begin an attribute update of the given target
+ * @param KVMDAL_STORE store : Store to operate on
+ * @param uint64_t start : Directory to interpret the path relative to
+ * @param const char* path : Path of the target ( or NULL, to target the 'start' inode itself )
+ * @param char follow : If non-zero, a symlink target will be followed
+ * @param uint64_t* ino : Reference to be populated with the target inode number
+ * @param kvmdal_inode* inode : Reference to be populated with the target inode
+ * @return KVTXN : Write transaction to complete via kvmdal_attrcommit(), or NULL on failure
+ */
+static KVTXN kvmdal_attrbegin( KVMDAL_STORE store, uint64_t start, const char* path, char follow,
+                               uint64_t* ino, kvmdal_inode* inode ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return NULL;
+   }
+   *ino = start;
+   if ( path ) {
+      kvmdal_walkres res;
+      if ( kvmdal_resolve( txn, start, path, follow, &(res) ) ) {
+         LOG( LOG_INFO, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+         kvmdal_abort( txn );
+         return NULL;
+      }
+      *ino = res.ino;
+   }
+   if ( kvmdal_getinode( txn, *ino, inode ) ) {
+      LOG( LOG_ERR, "Failed to retrieve target inode %llu\n", (unsigned long long)*ino );
+      kvmdal_abort( txn );
+      return NULL;
+   }
+   return txn;
+}
+
+/**
+ * Complete an attribute update of the given target
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_attrcommit( KVTXN txn, uint64_t ino, kvmdal_inode* inode ) {
+   kvmdal_now( inode->ctime );
+   if ( kvmdal_putinode( txn, ino, inode ) ) {
+      LOG( LOG_ERR, "Failed to stage update of inode %llu\n", (unsigned long long)ino );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Apply the given timestamp values to an inode
+ * @param kvmdal_inode* inode : Inode to be updated
+ * @param const struct timespec times[2] : New atime and mtime values ( or NULL, for the current time )
+ */
+static void kvmdal_settimes( kvmdal_inode* inode, const struct timespec times[2] ) {
+   int64_t now[2];
+   kvmdal_now( now );
+   int64_t* tgts[2] = { inode->atime, inode->mtime };
+   int index = 0;
+   for ( ; index < 2; index++ ) {
+      if ( times == NULL  ||  times[index].tv_nsec == UTIME_NOW ) { memcpy( tgts[index], now, sizeof( now ) ); }
+      else if ( times[index].tv_nsec != UTIME_OMIT ) {
+         tgts[index][0] = times[index].tv_sec;
+         tgts[index][1] = times[index].tv_nsec;
+      }
+   }
+}
+
+/**
+ * Stat the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_statat( KVMDAL_STORE store, uint64_t start, const char* path, char follow, struct stat* st ) {
+   KVTXN txn = kvstore_begin( store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   if ( kvmdal_resolve( txn, start, path, follow, &(res) )  ||  kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+      LOG( LOG_INFO, "Failed to stat the target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   if ( st ) { kvmdal_fillstat( store, res.ino, &(inode), st ); }
+   return 0;
+}
+
+/**
+ * Create a directory at the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_mkdirat( KVMDAL_STORE store, uint64_t start, const char* path, mode_t mode ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode parent;
+   uint64_t ino;
+   kvmdal_inode inode;
+   if ( kvmdal_resolvenew( txn, start, path, &(res) )  ||  kvmdal_getinode( txn, res.parent, &(parent) )  ||
+        kvmdal_checkaccess( &(parent), W_OK | X_OK, AT_EACCESS )  ||
+        kvmdal_create( txn, res.parent, &(parent), res.name, res.namelen, S_IFDIR | ( mode & 07777 ), 0, &(ino), &(inode) )  ||
+        kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to mkdir target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Remove the directory at the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_rmdirat( KVMDAL_STORE store, uint64_t start, const char* path ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   kvmdal_inode parent;
+   if ( kvmdal_resolve( txn, start, path, 0, &(res) ) ) {
+      LOG( LOG_ERR, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( res.parent == 0 ) {
+      LOG( LOG_ERR, "Cannot remove a '.' or '..' path: \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( kvmdal_getinode( txn, res.ino, &(inode) )  ||  kvmdal_getinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve inodes of target path: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   if ( !(S_ISDIR( inode.mode )) ) {
+      LOG( LOG_ERR, "Target is not a directory: \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = ENOTDIR;
+      return -1;
+   }
+   if ( kvmdal_permitremove( &(parent), &(inode) ) ) {
+      LOG( LOG_ERR, "Access denied for removal of directory: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   int empty = kvmdal_dirempty( txn, res.ino );
+   if ( empty <= 0 ) {
+      LOG( LOG_ERR, "Target directory is not empty: \"%s\"\n", path );
+      if ( empty == 0 ) { errno = ENOTEMPTY; }
+      return kvmdal_abort( txn );
+   }
+   parent.nlink--;
+   if ( kvmdal_delentry( txn, res.parent, &(parent), res.name, res.namelen, res.dent.cookie )  ||
+        kvmdal_droplink( txn, store, res.ino, &(inode) )  ||  kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to stage removal of directory: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Unlink the non-directory at the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_unlinkat( KVMDAL_STORE store, uint64_t start, const char* path ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   kvmdal_inode parent;
+   if ( kvmdal_resolve( txn, start, path, 0, &(res) ) ) {
+      LOG( LOG_INFO, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( res.parent == 0  ||  S_ISDIR( res.dent.mode ) ) {
+      LOG( LOG_ERR, "Cannot unlink a directory: \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = EISDIR;
+      return -1;
+   }
+   if ( kvmdal_getinode( txn, res.ino, &(inode) )  ||  kvmdal_getinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve inodes of target path: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   if ( kvmdal_permitremove( &(parent), &(inode) ) ) {
+      LOG( LOG_ERR, "Access denied for unlink of target path: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   if ( kvmdal_delentry( txn, res.parent, &(parent), res.name, res.namelen, res.dent.cookie )  ||
+        kvmdal_droplink( txn, store, res.ino, &(inode) )  ||  kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to stage unlink of target path: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Create a hardlink to the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_linkat( KVMDAL_STORE store, uint64_t oldstart, const char* oldpath,
+                          uint64_t newstart, const char* newpath, char follow ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres oldres;
+   kvmdal_walkres newres;
+   kvmdal_inode inode;
+   kvmdal_inode parent;
+   if ( kvmdal_resolve( txn, oldstart, oldpath, follow, &(oldres) )  ||  kvmdal_getinode( txn, oldres.ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to resolve link target: \"%s\" ( %s )\n", oldpath, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( S_ISDIR( inode.mode ) ) {
+      LOG( LOG_ERR, "Cannot hardlink a directory: \"%s\"\n", oldpath );
+      kvtxn_abort( txn );
+      errno = EPERM;
+      return -1;
+   }
+   if ( kvmdal_resolvenew( txn, newstart, newpath, &(newres) ) ) {
+      LOG( LOG_ERR, "Failed to resolve new link path: \"%s\" ( %s )\n", newpath, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( newres.trailing ) {
+      LOG( LOG_ERR, "New link path cannot target a directory: \"%s\"\n", newpath );
+      kvtxn_abort( txn );
+      errno = ENOENT;
+      return -1;
+   }
+   if ( kvmdal_getinode( txn, newres.parent, &(parent) ) ) { return kvmdal_abort( txn ); }
+   if ( kvmdal_checkaccess( &(parent), W_OK | X_OK, AT_EACCESS ) ) {
+      LOG( LOG_ERR, "Access denied for creation of new link: \"%s\"\n", newpath );
+      return kvmdal_abort( txn );
+   }
+   inode.nlink++;
+   kvmdal_now( inode.ctime );
+   if ( kvmdal_addentry( txn, newres.parent, &(parent), newres.name, newres.namelen, oldres.ino, inode.mode )  ||
+        kvmdal_putinode( txn, oldres.ino, &(inode) )  ||  kvmdal_putinode( txn, newres.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to stage new link: \"%s\"\n", newpath );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Rename the given path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_renameat( KVMDAL_STORE store, uint64_t fromstart, const char* from, uint64_t tostart, const char* to ) {
+   KVTXN txn = kvstore_begin( store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres fres;
+   kvmdal_walkres tres;
+   int links = 0;
+   if ( kvmdal_resolve( txn, fromstart, from, 0, &(fres) )  ||  kvmdal_walk( txn, tostart, to, 0, &(tres), &(links) ) ) {
+      LOG( LOG_ERR, "Failed to resolve rename paths: \"%s\" -> \"%s\" ( %s )\n", from, to, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( fres.parent == 0  ||  tres.parent == 0 ) {
+      LOG( LOG_ERR, "Cannot rename a '.' or '..' path: \"%s\" -> \"%s\"\n", from, to );
+      kvtxn_abort( txn );
+      errno = EBUSY;
+      return -1;
+   }
+   if ( fres.ino == tres.ino ) {
+      // both paths reference the same inode, so there is nothing to be done
+      return kvtxn_abort( txn );
+   }
+   kvmdal_inode src;
+   kvmdal_inode dst;
+   if ( kvmdal_getinode( txn, fres.ino, &(src) )  ||  ( tres.ino  &&  kvmdal_getinode( txn, tres.ino, &(dst) ) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve inodes of rename paths: \"%s\" -> \"%s\"\n", from, to );
+      return kvmdal_abort( txn );
+   }
+   if ( !(S_ISDIR( src.mode ))  &&  tres.ino == 0  &&  tres.trailing ) {
+      LOG( LOG_ERR, "Cannot rename a non-directory to a directory path: \"%s\" -> \"%s\"\n", from, to );
+      kvtxn_abort( txn );
+      errno = ENOTDIR;
+      return -1;
+   }
+   if ( tres.ino ) {
+      // verify that the destination can be replaced
+      int err = 0;
+      if ( S_ISDIR( src.mode )  &&  !(S_ISDIR( dst.mode )) ) { err = ENOTDIR; }
+      else if ( !(S_ISDIR( src.mode ))  &&  S_ISDIR( dst.mode ) ) { err = EISDIR; }
+      else if ( S_ISDIR( dst.mode ) ) {
+         int empty = kvmdal_dirempty( txn, tres.ino );
+         if ( empty < 0 ) { return kvmdal_abort( txn ); }
+         if ( empty == 0 ) { err = ENOTEMPTY; }
+      }
+      if ( err ) {
+         LOG( LOG_ERR, "Cannot replace rename destination: \"%s\" ( %s )\n", to, strerror(err) );
+         kvtxn_abort( txn );
+         errno = err;
+         return -1;
+      }
+   }
+   if ( S_ISDIR( src.mode ) ) {
+      // a directory cannot be moved beneath itself
+      uint64_t ancestor = tres.parent;
+      while ( ancestor ) {
+         if ( ancestor == fres.ino ) {
+            LOG( LOG_ERR, "Cannot move a directory beneath itself: \"%s\" -> \"%s\"\n", from, to );
+            kvtxn_abort( txn );
+            errno = EINVAL;
+            return -1;
+         }
+         kvmdal_inode anode;
+         if ( kvmdal_getinode( txn, ancestor, &(anode) ) ) { return kvmdal_abort( txn ); }
+         ancestor = anode.parent;
+      }
+   }
+   kvmdal_inode fparent;
+   kvmdal_inode tparentbuf;
+   kvmdal_inode* tparent = &(fparent);
+   if ( kvmdal_getinode( txn, fres.parent, &(fparent) ) ) { return kvmdal_abort( txn ); }
+   if ( tres.parent != fres.parent ) {
+      tparent = &(tparentbuf);
+      if ( kvmdal_getinode( txn, tres.parent, tparent ) ) { return kvmdal_abort( txn ); }
+   }
+   // as with rename(), relocating a directory also requires write access to it ( to update '..' )
+   if ( kvmdal_permitremove( &(fparent), &(src) )  ||
+        ( tres.ino  &&  kvmdal_permitremove( tparent, &(dst) ) )  ||
+        ( tres.ino == 0  &&  kvmdal_checkaccess( tparent, W_OK | X_OK, AT_EACCESS ) )  ||
+        ( S_ISDIR( src.mode )  &&  tres.parent != fres.parent  &&  kvmdal_checkaccess( &(src), W_OK, AT_EACCESS ) ) ) {
+      LOG( LOG_ERR, "Access denied for rename: \"%s\" -> \"%s\"\n", from, to );
+      return kvmdal_abort( txn );
+   }
+   // replace any existing destination
+   if ( tres.ino ) {
+      if ( S_ISDIR( dst.mode ) ) { tparent->nlink--; }
+      if ( kvmdal_delentry( txn, tres.parent, tparent, tres.name, tres.namelen, tres.dent.cookie )  ||
+           kvmdal_droplink( txn, store, tres.ino, &(dst) ) ) {
+         LOG( LOG_ERR, "Failed to stage removal of rename destination: \"%s\"\n", to );
+         return kvmdal_abort( txn );
+      }
+   }
+   if ( kvmdal_delentry( txn, fres.parent, &(fparent), fres.name, fres.namelen, fres.dent.cookie )  ||
+        kvmdal_addentry( txn, tres.parent, tparent, tres.name, tres.namelen, fres.ino, src.mode ) ) {
+      LOG( LOG_ERR, "Failed to stage rename entries: \"%s\" -> \"%s\"\n", from, to );
+      return kvmdal_abort( txn );
+   }
+   if ( S_ISDIR( src.mode )  &&  tres.parent != fres.parent ) {
+      fparent.nlink--;
+      tparent->nlink++;
+      src.parent = tres.parent;
+   }
+   kvmdal_now( src.ctime );
+   if ( kvmdal_putinode( txn, fres.ino, &(src) )  ||  kvmdal_putinode( txn, fres.parent, &(fparent) )  ||
+        ( tparent != &(fparent)  &&  kvmdal_putinode( txn, tres.parent, tparent ) ) ) {
+      LOG( LOG_ERR, "Failed to stage rename inode updates: \"%s\" -> \"%s\"\n", from, to );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Open the file at the given path
+ * @param KVMDAL_STORE store : Store to operate on
+ * @param uint64_t start : Directory to interpret the path relative to
+ * @param const char* path : Path of the target file
+ * @param int flags : open() flags
+ * @param mode_t mode : Mode of the file, if created
+ * @return KV_FHANDLE : New file handle, or NULL if a failure occurred
+ */
+static KV_FHANDLE kvmdal_openat( KVMDAL_STORE store, uint64_t start, const char* path, int flags, mode_t mode ) {
+   char writable = ( ( flags & O_ACCMODE ) != O_RDONLY );
+   char modify = ( flags & O_CREAT )  ||  ( writable  &&  ( flags & O_TRUNC ) );
+   KV_FHANDLE fh = calloc( 1, sizeof( struct kvmdal_file_handle_struct ) );
+   if ( fh == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new file handle\n" );
+      return NULL;
+   }
+   KVTXN txn = kvstore_begin( store->kvs, modify );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      free( fh );
+      return NULL;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   char created = 0;
+   if ( flags & O_CREAT ) {
+      // an exclusive create never follows a final symlink
+      int links = 0;
+      if ( kvmdal_walk( txn, start, path, !( flags & O_EXCL ), &(res), &(links) ) ) {
+         LOG( LOG_ERR, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+         kvmdal_abort( txn );
+         free( fh );
+         return NULL;
+      }
+      if ( res.ino  &&  ( flags & O_EXCL ) ) {
+         LOG( LOG_ERR, "Target of exclusive create already exists: \"%s\"\n", path );
+         kvtxn_abort( txn );
+         free( fh );
+         errno = EEXIST;
+         return NULL;
+      }
+      if ( res.ino == 0 ) {
+         kvmdal_inode parent;
+         if ( res.trailing ) { errno = EISDIR; }
+         if ( res.trailing  ||  kvmdal_getinode( txn, res.parent, &(parent) )  ||
+              kvmdal_checkaccess( &(parent), W_OK | X_OK, AT_EACCESS )  ||
+              kvmdal_create( txn, res.parent, &(parent), res.name, res.namelen, S_IFREG | ( mode & 07777 ), 0, &(res.ino), &(inode) )  ||
+              kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+            LOG( LOG_ERR, "Failed to create target file: \"%s\" ( %s )\n", path, strerror(errno) );
+            kvmdal_abort( txn );
+            free( fh );
+            return NULL;
+         }
+         created = 1;
+      }
+   }
+   else if ( kvmdal_resolve( txn, start, path, !( flags & O_NOFOLLOW ), &(res) ) ) {
+      LOG( LOG_INFO, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      kvmdal_abort( txn );
+      free( fh );
+      return NULL;
+   }
+   if ( !(created)  &&  kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the inode of target path: \"%s\"\n", path );
+      kvmdal_abort( txn );
+      free( fh );
+      return NULL;
+   }
+   if ( S_ISLNK( inode.mode )  ||  S_ISDIR( inode.mode ) ) {
+      LOG( LOG_ERR, "Target is a %s: \"%s\"\n", ( S_ISDIR( inode.mode ) ) ? "directory" : "symlink", path );
+      kvtxn_abort( txn );
+      free( fh );
+      errno = ( S_ISDIR( inode.mode ) ) ? EISDIR : ELOOP;
+      return NULL;
+   }
+   // as with open(), the creator of a file is not subject to its mode
+   int amode = ( ( flags & O_ACCMODE ) == O_WRONLY ) ? 0 : R_OK;
+   if ( writable  ||  ( flags & O_TRUNC ) ) { amode |= W_OK; }
+   if ( !(created)  &&  kvmdal_checkaccess( &(inode), amode, AT_EACCESS ) ) {
+      LOG( LOG_ERR, "Access denied for open of target file: \"%s\"\n", path );
+      kvmdal_abort( txn );
+      free( fh );
+      return NULL;
+   }
+   if ( !(created)  &&  writable  &&  ( flags & O_TRUNC )  &&  inode.size ) {
+      if ( kvmdal_truncate( txn, res.ino, &(inode), 0 )  ||  kvmdal_putinode( txn, res.ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to stage truncation of target file: \"%s\"\n", path );
+         kvmdal_abort( txn );
+         free( fh );
+         return NULL;
+      }
+   }
+   // record the open while still holding our transaction, to exclude any concurrent unlink
+   if ( kvmdal_openinode( store, res.ino ) ) {
+      kvmdal_abort( txn );
+      free( fh );
+      return NULL;
+   }
+   int commitres = ( modify ) ? kvtxn_commit( txn ) : kvtxn_abort( txn );
+   if ( commitres ) {
+      LOG( LOG_ERR, "Failed to commit open of target file: \"%s\"\n", path );
+      int olderrno = errno;
+      kvmdal_closeinode( store, res.ino );
+      free( fh );
+      errno = olderrno;
+      return NULL;
+   }
+   kvmdal_holdstore( store );
+   fh->store = store;
+   fh->ino = res.ino;
+   fh->flags = flags;
+   fh->offset = 0;
+   return fh;
+}
+
+
+//   -------------    KV IMPLEMENTATION    -------------
+
+// forward declarations of functions reused within this implementation
+struct dirent* kvmdal_readdir( MDAL_DHANDLE dh );
+int kvmdal_closedir( MDAL_DHANDLE dh );
+
+// Path Filter
+
+/**
+ * Identify and reject any paths targeting reserved names
+ * NOTE -- This MDAL stores nothing within the user tree, but reserves the same names as the
+ *         posix MDAL, so that namespace content remains portable between MDAL types.
+ * @param const char* path : Path to verify
+ * @return : Zero if the path is acceptable, -1 if not
+ */
+int kvmdal_pathfilter( const char* path ) {
+   size_t complen = strlen( KMDAL_PREFX );
+   const char* parse = path;
+   while ( *parse != '\0' ) {
+      // compare the start of each path element against the reserved prefix
+      if ( strncmp( parse, KMDAL_PREFX, complen ) == 0 ) { return -1; }
+      while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+      while ( *parse == '/' ) { parse++; }
+   }
+   return 0;
+}
+
+
+// Context Functions
+
+/**
+ * Destroy a given MDAL_CTXT ( such as following a dupctxt call )
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to be freed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_destroyctxt ( MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVMDAL_STORE store = kctxt->store;
+   free( kctxt );
+   return kvmdal_dropstore( store );
+}
+
+/**
+ * Duplicate the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to duplicate
+ * @return MDAL_CTXT : Reference to the duplicate MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT kvmdal_dupctxt ( const MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT dupctxt = malloc( sizeof(struct kv_mdal_context_struct) );
+   if ( !(dupctxt) ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new kv MDAL_CTXT\n" );
+      return NULL;
+   }
+   *dupctxt = *( (KV_MDAL_CTXT) ctxt );
+   kvmdal_holdstore( dupctxt->store );
+   return (MDAL_CTXT) dupctxt;
+}
+
+
+// Management Functions
+
+/**
+ * Cleanup all structes and state associated with the given kv MDAL
+ * @param MDAL mdal : MDAL to be freed
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_cleanup( MDAL mdal ) {
+   // check for NULL mdal
+   if ( !(mdal) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // destroy the MDAL_CTXT struct ( closing the store, if no other references remain )
+   int retval = 0;
+   if ( kvmdal_destroyctxt( mdal->ctxt ) ) {
+      LOG( LOG_ERR, "Failed to destroy the MDAL_CTXT reference\n" );
+      retval = -1;
+   }
+   free( mdal );
+   return retval;
+}
+
+/**
+ * Verify security of the given MDAL_CTXT
+ * NOTE -- All content is held beneath the store directory, so only that dir is verified.
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT for which to verify security
+ *                               NOTE -- this ctxt CANNOT be associated with a NS target
+ *                                       ( it must be freshly initialized )
+ * @param int flags : currently uses CFG_FIX (correct any problems if true)
+ *                    and CFG_OWNERCHECK (check that UID of the store dir
+ *                                        matches current user if true)
+ * @return int : A count of uncorrected security issues, or -1 if a failure occurred
+ */
+int kvmdal_checksec( const MDAL_CTXT ctxt, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // verify that this CTXT doesn't have a NS target
+   if ( kctxt->pathns ) {
+      LOG( LOG_ERR, "Cannot verify the security of a CTXT after it has been associated with a NS target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   struct stat dirstat;
+   if ( fstat( kctxt->store->dirfd, &(dirstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat the store directory\n" );
+      return -1;
+   }
+   uid_t uid = geteuid();
+   if ( (dirstat.st_mode & (S_IRWXG | S_IRWXO)) == 0  &&  ( !(flags & CFG_OWNERCHECK)  ||  dirstat.st_uid == uid ) ) {
+      LOG( LOG_INFO, "Detected that the store dir has appropriate perms\n" );
+      return 0;
+   }
+   if ( !(flags & CFG_FIX) ) { return 1; }
+   LOG( LOG_INFO, "Chowning the store dir to current UID/GID\n" );
+   if ( fchown( kctxt->store->dirfd, uid, getegid() ) ) {
+      LOG( LOG_ERR, "Failed to chown the store dir to current UID/GID\n" );
+      return 1;
+   }
+   LOG( LOG_INFO, "Chmoding the store dir to 0700 mode\n" );
+   if ( fchmod( kctxt->store->dirfd, 0700 ) ) {
+      LOG( LOG_ERR, "Failed to chmod the store dir to 0700 mode\n" );
+      return 1;
+   }
+   return 0;
+}
+
+
+// Namespace Functions
+
+/**
+ * Set the namespace of the given MDAL_CTXT
+ * @param MDAL_CTXT ctxt : Context to set the namespace of
+ * @param const char* ns : Name of the namespace to set
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   uint64_t nsino;
+   kvmdal_nsinfo info;
+   if ( kvmdal_resolvensref( txn, kctxt, ns, &(nsino), &(info) ) ) {
+      LOG( LOG_ERR, "Failed to resolve NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   kctxt->pathns = nsino;
+   kctxt->pathdir = nsino;
+   kctxt->refns = nsino;
+   kctxt->refdir = info.rec.refroot;
+   return 0;
+}
+
+/**
+ * Create a new MDAL_CTXT reference, targeting the specified NS
+ * @param const char* ns : Name of the namespace for the new MDAL_CTXT to target
+ * @param const MDAL_CTXT basectxt : The new MDAL_CTXT will be created relative to this one
+ * @return MDAL_CTXT : Reference to the new MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT kvmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
+   // check for NULL basectxt
+   if ( !(basectxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   MDAL_CTXT newctxt = kvmdal_dupctxt( basectxt );
+   if ( newctxt == NULL ) { return NULL; }
+   if ( kvmdal_setnamespace( newctxt, ns ) ) {
+      int olderrno = errno;
+      kvmdal_destroyctxt( newctxt );
+      errno = olderrno;
+      return NULL;
+   }
+   return newctxt;
+}
+
+/**
+ * Create a new MDAL_CTXT reference, targeting one NS for user path operations and a different
+ *  NS for reference path creation
+ * @param const char* pathns : Namespace for the new MDAL_CTXT to target for user path ops
+ * @param const MDAL_CTXT pathctxt : The pathns will be interpreted relative to this CTXT
+ * @param const char* refns : Namespace for the new MDAL_CTXT to target for ref path ops
+ * @param const MDAL_CTXT refctxt : The refns will be interpreted relative to this CTXT
+ * @return MDAL_CTXT : Reference to the new MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT kvmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt, const char* refns, const MDAL_CTXT refctxt ) {
+   // check for NULL args
+   if ( !(pathctxt)  ||  !(refctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( !(pathns)  ||  !(refns) ) {
+      LOG( LOG_ERR, "Received a NULL namespace path\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kpathctxt = (KV_MDAL_CTXT) pathctxt;
+   KV_MDAL_CTXT krefctxt = (KV_MDAL_CTXT) refctxt;
+   // both namespaces must reside within the same store
+   if ( kpathctxt->store != krefctxt->store ) {
+      LOG( LOG_ERR, "Cross-Device CTXT split detected\n" );
+      errno = EXDEV;
+      return NULL;
+   }
+   KVTXN txn = kvstore_begin( kpathctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return NULL;
+   }
+   uint64_t pathino;
+   uint64_t refino;
+   kvmdal_nsinfo info;
+   if ( kvmdal_resolvens( txn, kpathctxt, pathns, 0, &(pathino), &(info) )  ||
+        kvmdal_resolvensref( txn, krefctxt, refns, &(refino), &(info) ) ) {
+      LOG( LOG_ERR, "Failed to resolve split NS targets: \"%s\" / \"%s\"\n", pathns, refns );
+      kvmdal_abort( txn );
+      return NULL;
+   }
+   kvtxn_abort( txn );
+   KV_MDAL_CTXT newctxt = malloc( sizeof(struct kv_mdal_context_struct) );
+   if ( !(newctxt) ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new kv MDAL_CTXT\n" );
+      return NULL;
+   }
+   kvmdal_holdstore( kpathctxt->store );
+   newctxt->store = kpathctxt->store;
+   newctxt->pathns = pathino;
+   newctxt->pathdir = pathino;
+   newctxt->refns = refino;
+   newctxt->refdir = info.rec.refroot;
+   return (MDAL_CTXT) newctxt;
+}
+
+/**
+ * Create the specified namespace root structures ( reference tree is not created by this func! )
+ * @param MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace to be created
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_createnamespace( MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   // create any missing namespaces along the path
+   uint64_t nsino;
+   kvmdal_nsinfo info;
+   if ( kvmdal_resolvens( txn, kctxt, ns, 1, &(nsino), &(info) ) ) {
+      LOG( LOG_ERR, "Failed to create path to NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   // here, we actually want to report EEXIST
+   if ( info.rec.refroot ) {
+      LOG( LOG_ERR, "NS ref tree already exists: \"%s\"\n", ns );
+      kvtxn_abort( txn );
+      errno = EEXIST;
+      return -1;
+   }
+   kvmdal_inode refinode;
+   if ( kvmdal_newinode( txn, S_IFDIR | S_IRWXU | S_IRWXG | S_IRWXO, 0, 0, &(info.rec.refroot), &(refinode) )  ||
+        kvmdal_putns( txn, nsino, &(info) ) ) {
+      LOG( LOG_ERR, "Failed to create NS ref tree: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Destroy the specified namespace root structures
+ * NOTE -- This operation will fail with errno=ENOTEMPTY if files/dirs persist in the 
+ *         namespace or if inode / data usage values are non-zero for the namespace.
+ *         This includes files/dirs within the reference tree.
+ *         The root NS itself cannot be removed, but its reference tree will be.
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace to be deleted
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_destroynamespace ( const MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   uint64_t nsino;
+   kvmdal_nsinfo info;
+   if ( kvmdal_resolvensref( txn, kctxt, ns, &(nsino), &(info) ) ) {
+      LOG( LOG_ERR, "Failed to resolve NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   // as with an rmdir of the NS root dir, removal requires write and search access to the parent NS
+   //    ( or to the root NS itself, which only loses its reference tree )
+   if ( kvmdal_permit( txn, ( nsino == KMDAL_ROOTINO ) ? nsino : info.rec.parent, W_OK | X_OK ) ) {
+      LOG( LOG_ERR, "Access denied for removal of NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   // check for any remaining subspaces
+   char key[KMDAL_KEYMAX];
+   size_t prefixlen = kvmdal_key( key, KMDAL_KEY_SUBSP, nsino, NULL, 0 );
+   const char* nextkey;
+   size_t nextkeylen;
+   const void* val;
+   size_t vallen;
+   int subspaces = kvmdal_nextprefix( txn, key, prefixlen, prefixlen, &(nextkey), &(nextkeylen), &(val), &(vallen) );
+   int refempty = kvmdal_dirempty( txn, info.rec.refroot );
+   int userempty = kvmdal_dirempty( txn, nsino );
+   if ( subspaces < 0  ||  refempty < 0  ||  userempty < 0 ) {
+      LOG( LOG_ERR, "Failed to verify that NS is empty: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   if ( subspaces  ||  !(refempty)  ||  !(userempty)  ||  info.rec.datausage  ||  info.rec.inodeusage ) {
+      LOG( LOG_ERR, "NS is not empty: \"%s\"\n", ns );
+      kvtxn_abort( txn );
+      errno = ENOTEMPTY;
+      return -1;
+   }
+   if ( kvmdal_purge( txn, info.rec.refroot ) ) { return kvmdal_abort( txn ); }
+   if ( nsino == KMDAL_ROOTINO ) {
+      info.rec.refroot = 0;
+      if ( kvmdal_putns( txn, nsino, &(info) ) ) { return kvmdal_abort( txn ); }
+   }
+   else if ( kvmdal_purge( txn, nsino )  ||
+             kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_NS, nsino, NULL, 0 ) )  ||
+             kvtxn_delete( txn, key, kvmdal_key( key, KMDAL_KEY_SUBSP, info.rec.parent, info.name, info.namelen ) ) ) {
+      LOG( LOG_ERR, "Failed to stage removal of NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Resolve the root inode of the specified NS
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvmdal_nsinode( KV_MDAL_CTXT kctxt, const char* ns, uint64_t* nsino ) {
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_nsinfo info;
+   if ( kvmdal_resolvens( txn, kctxt, ns, 0, nsino, &(info) ) ) {
+      LOG( LOG_ERR, "Failed to resolve NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   return 0;
+}
+
+/**
+ * Open a directory handle for the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @return MDAL_DHANDLE : Open directory handle, or NULL if a failure occurred
+ */
+MDAL_DHANDLE kvmdal_opendirnamespace( const MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   uint64_t nsino;
+   if ( kvmdal_nsinode( kctxt, ns, &(nsino) ) ) { return NULL; }
+   return (MDAL_DHANDLE) kvmdal_newdhandle( kctxt->store, nsino );
+}
+
+/**
+ * Check access to the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param int mode : F_OK - check for file existence
+ *                      or a bitwise OR of the following...
+ *                   R_OK - check for read access
+ *                   W_OK - check for write access
+ *                   X_OK - check for execute access
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_EACCESS - Perform access checks using effective uid/gid
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_accessnamespace (const MDAL_CTXT ctxt, const char* ns, int mode, int flags) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   uint64_t nsino;
+   kvmdal_nsinfo info;
+   kvmdal_inode inode;
+   if ( kvmdal_resolvens( txn, kctxt, ns, 0, &(nsino), &(info) )  ||  kvmdal_getinode( txn, nsino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to resolve NS: \"%s\"\n", ns );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   return kvmdal_checkaccess( &(inode), mode, flags );
+}
+
+/**
+ * Stat the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param struct stat* st : Stat structure to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_statnamespace (const MDAL_CTXT ctxt, const char* ns, struct stat *buf) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   uint64_t nsino;
+   kvmdal_nsinfo info;
+   kvmdal_inode inode;
+   if ( kvmdal_resolvens( txn, kctxt, ns, 0, &(nsino), &(info) )  ||  kvmdal_getinode( txn, nsino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to stat NS: \"%s\" (%s)\n", ns, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   kvmdal_fillstat( kctxt->store, nsino, &(inode), buf );
+   return 0;
+}
+
+/**
+ * Edit the mode of the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param mode_t mode : New mode value for the NS (see inode man page)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_chmodnamespace (const MDAL_CTXT ctxt, const char* ns, mode_t mode) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   uint64_t nsino;
+   kvmdal_inode inode;
+   if ( kvmdal_nsinode( kctxt, ns, &(nsino) ) ) { return -1; }
+   // NOTE -- a concurrent destroy of the NS will cause the inode retrieval to fail
+   KVTXN txn = kvmdal_attrbegin( kctxt->store, nsino, NULL, 0, &(nsino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_permitowner( &(inode) ) ) {
+      LOG( LOG_ERR, "Only the owner of NS \"%s\" may change its mode\n", ns );
+      return kvmdal_abort( txn );
+   }
+   inode.mode = ( inode.mode & S_IFMT ) | ( mode & 07777 );
+   return kvmdal_attrcommit( txn, nsino, &(inode) );
+}
+
+/**
+ * Edit the ownership and group of the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param uid_t owner : New owner
+ * @param gid_t group : New group
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_chownnamespace (const MDAL_CTXT ctxt, const char* ns, uid_t uid, gid_t gid) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   uint64_t nsino;
+   kvmdal_inode inode;
+   if ( kvmdal_nsinode( kctxt, ns, &(nsino) ) ) { return -1; }
+   KVTXN txn = kvmdal_attrbegin( kctxt->store, nsino, NULL, 0, &(nsino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_permitchown( &(inode), uid, gid ) ) {
+      LOG( LOG_ERR, "Ownership change of NS \"%s\" is not permitted\n", ns );
+      return kvmdal_abort( txn );
+   }
+   if ( uid != (uid_t)-1 ) { inode.uid = uid; }
+   if ( gid != (gid_t)-1 ) { inode.gid = gid; }
+   return kvmdal_attrcommit( txn, nsino, &(inode) );
+}
+
+
+// Usage Functions
+
+/**
+ * Set a usage value of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @param char data : If non-zero, the data usage value is set, otherwise the inode usage value
+ * @param off_t value : New usage value
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+static int kvmdal_setusage( MDAL_CTXT ctxt, char data, off_t value ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( value < 0 ) {
+      LOG( LOG_ERR, "Received a negative usage value: %zd\n", value );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_nsinfo info;
+   if ( kvmdal_getns( txn, kctxt->refns, &(info) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the record of the current NS\n" );
+      return kvmdal_abort( txn );
+   }
+   if ( data ) { info.rec.datausage = value; }
+   else { info.rec.inodeusage = value; }
+   if ( kvmdal_putns( txn, kctxt->refns, &(info) ) ) {
+      LOG( LOG_ERR, "Failed to stage usage update\n" );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Retrieve a usage value of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @param char data : If non-zero, the data usage value is retrieved, otherwise the inode usage value
+ * @return off_t : Usage value, or -1 if a failure occurred
+ */
+static off_t kvmdal_getusage( MDAL_CTXT ctxt, char data ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_nsinfo info;
+   if ( kvmdal_getns( txn, kctxt->refns, &(info) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the record of the current NS\n" );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   return ( data ) ? (off_t)info.rec.datausage : (off_t)info.rec.inodeusage;
+}
+
+/**
+ * Set data usage value for the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @param off_t bytes : Number of bytes used by the namespace
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_setdatausage( MDAL_CTXT ctxt, off_t bytes ) {
+   return kvmdal_setusage( ctxt, 1, bytes );
+}
+
+/**
+ * Retrieve the data usage value of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @return off_t : Number of bytes used by the namespace
+ */
+off_t kvmdal_getdatausage( MDAL_CTXT ctxt ) {
+   return kvmdal_getusage( ctxt, 1 );
+}
+
+/**
+ * Set the inode usage value of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @param off_t files : Number of inodes used by the namespace
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_setinodeusage( MDAL_CTXT ctxt, off_t files ) {
+   return kvmdal_setusage( ctxt, 0, files );
+}
+
+/**
+ * Retrieve the inode usage value of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @return off_t : Number of inodes used by the namespace
+ */
+off_t kvmdal_getinodeusage( MDAL_CTXT ctxt ) {
+   return kvmdal_getusage( ctxt, 0 );
+}
+
+
+// Reference Path Functions
+
+/**
+ * Create the specified reference directory
+ * @param const MDAL_CTXT ctxt : Current MDAL_CTXT, associated with a target namespace
+ * @param const char* refdir : Path of the reference dir to be created
+ * @param mode_t mode : Mode value of the new directory (see inode man page)
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_createrefdir ( const MDAL_CTXT ctxt, const char* refdir, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_mkdirat( kctxt->store, kctxt->refdir, refdir, mode );
+}
+
+/**
+ * Destroy the specified reference directory
+ * NOTE -- This operation will fail with errno=ENOTEMPTY if files/dirs persist in the dir.
+ * @param const MDAL_CTXT ctxt : Current MDAL_CTXT, associated with a target namespace
+ * @param const char* refdir : Path of the reference dir to be destroyed
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_destroyrefdir ( const MDAL_CTXT ctxt, const char* refdir ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_rmdirat( kctxt->store, kctxt->refdir, refdir );
+}
+
+/**
+ * Hardlink the specified reference path to the specified user-visible path
+ * @param const MDAL_CTXT ctxt : Current MDAL_CTXT, associated with a target namespace
+ * @param char interref : If zero, 'newpath' is interpreted as a user-visible path
+ *                        If non-zero, 'newpath' is interpreted as another reference path
+ * @param const char* oldrpath : Reference path of the existing file target
+ * @param const char* newpath : Path at which to create the hardlink
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_linkref ( const MDAL_CTXT ctxt, char interref, const char* oldrpath, const char* newpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_linkat( kctxt->store, kctxt->refdir, oldrpath,
+                         ( interref ) ? kctxt->refdir : kctxt->pathdir, newpath, 0 );
+}
+
+/**
+ * Rename the specified reference path to a new reference path
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* from : String path of the reference
+ * @param const char* to : Destination string reference path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_renameref ( const MDAL_CTXT ctxt, const char* from, const char* to ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved an MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_renameat( kctxt->store, kctxt->refdir, from, kctxt->refdir, to );
+}
+
+/**
+ * Unlink the specified file reference path
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* rpath : String reference path of the target file
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_unlinkref ( const MDAL_CTXT ctxt, const char* rpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_unlinkat( kctxt->store, kctxt->refdir, rpath );
+}
+
+/**
+ * Stat the target reference path
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* rpath : String reference path of the target
+ * @param struct stat* buf : Stat buffer to be populated
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_statref ( const MDAL_CTXT ctxt, const char* rpath, struct stat* buf ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_statat( kctxt->store, kctxt->refdir, rpath, 1, buf );
+}
+
+/**
+ * Open the specified reference path
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* rpath : String reference path of the target file
+ * @param int flags : Flags specifying behavior (see the 'open()' syscall 'flags' value for full info)
+ * @param mode_t mode : Mode value for file creation (see the 'open()' syscall 'mode' value for full info)
+ * @return MDAL_FHANDLE : An MDAL_READ handle for the target file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE kvmdal_openref ( const MDAL_CTXT ctxt, const char* rpath, int flags, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   return (MDAL_FHANDLE) kvmdal_openat( kctxt->store, kctxt->refdir, rpath, flags, mode );
+}
+
+
+// Scanner Functions
+
+/**
+ * Open a reference scanner for the given location of the current namespace
+ * @param MDAL_CTXT ctxt : Current MDAL_CTXT, associated with the target namespace
+ * @param const char* rpath : Target reference dir location
+ * @return MDAL_SCANNER : Newly opened reference scanner
+ */
+MDAL_SCANNER kvmdal_openscanner( MDAL_CTXT ctxt, const char* rpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   return (MDAL_SCANNER) kvmdal_opendirat( kctxt->store, kctxt->refdir, rpath );
+}
+
+/**
+ * Close a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to be closed
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_closescanner ( MDAL_SCANNER scanner ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_SCANNER kscan = (KV_SCANNER) scanner;
+   KVMDAL_STORE store = kscan->store;
+   free( kscan );
+   return kvmdal_dropstore( store );
+}
+
+/**
+ * Iterate to the next entry of a reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to retrieve an entry from
+ * @return struct dirent* : Reference to the next dirent struct, or NULL w/ errno unset if all 
+ *                          entries have been read, or NULL w/ errno set if a failure occurred
+ */
+struct dirent* kvmdal_scan( MDAL_SCANNER scanner ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   return kvmdal_readdir( (MDAL_DHANDLE) scanner );
+}
+
+/**
+ * Open a file, relative to a given reference scanner
+ * NOTE -- this is implicitly an open for READ
+ * @param MDAL_SCANNER scanner : Reference scanner to open relative to
+ * @param const char* path : Relative path of the target file from the scanner
+ * @return MDAL_FHANDLE : An MDAL_READ handle for the target file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE kvmdal_sopen( MDAL_SCANNER scanner, const char* path ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_SCANNER kscan = (KV_SCANNER) scanner;
+   return (MDAL_FHANDLE) kvmdal_openat( kscan->store, kscan->ino, path, O_RDONLY, 0 );
+}
+
+/**
+ * Unlink a file, relative to a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to unlink relative to
+ * @param const char* path : Relative path of the target file from the scanner
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_sunlink( MDAL_SCANNER scanner, const char* path ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_SCANNER kscan = (KV_SCANNER) scanner;
+   return kvmdal_unlinkat( kscan->store, kscan->ino, path );
+}
+
+/**
+ * Stat the target, relative to a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to operate relative to
+ * @param const char* spath : String reference path of the target
+ * @param struct stat* buf : Stat buffer to be populated
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int kvmdal_sstat ( MDAL_SCANNER scanner, const char* spath, struct stat* buf ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_SCANNER kscan = (KV_SCANNER) scanner;
+   return kvmdal_statat( kscan->store, kscan->ino, spath, 1, buf );
+}
+
+
+// DHANDLE Functions
+
+/**
+ * Open a directory, relative to the given MDAL_CTXT
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : Relative path of the target directory from the ctxt
+ * @return MDAL_DHANDLE : Open directory handle, or NULL if a failure occurred
+ */
+MDAL_DHANDLE kvmdal_opendir( MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   return (MDAL_DHANDLE) kvmdal_opendirat( kctxt->store, kctxt->pathdir, path );
+}
+
+/**
+ * Edit the given MDAL_CTXT to reference the given MDAL_DHANDLE for all path operations
+ * NOTE -- this operation will destroy the provided MDAL_DHANDLE
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to update
+ * @param MDAL_DHANDLE dh : Directory handle to be used by the MDAL_CTXT
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_chdir( MDAL_CTXT ctxt, MDAL_DHANDLE dh ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   if ( kdh->store != kctxt->store ) {
+      LOG( LOG_ERR, "Provided directory handle references a different store\n" );
+      errno = EXDEV;
+      return -1;
+   }
+   // as with fchdir(), the new working dir requires search access
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   if ( kvmdal_permit( txn, kdh->ino, X_OK ) ) {
+      LOG( LOG_ERR, "Search access denied for the provided directory handle\n" );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   // update the context struct, then close the provided dir handle
+   kctxt->pathdir = kdh->ino;
+   if ( kvmdal_closedir( dh ) ) {
+      LOG( LOG_WARNING, "Failed to close the provided directory handle\n" );
+   }
+   return 0;
+}
+
+/**
+ * Set the specified xattr on the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle for which to set the xattr
+ * @param char hidden : A non-zero value indicates to store this as a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to set
+ * @param const void* value : Buffer containing the value of the xattr
+ * @param size_t size : Size of the value buffer
+ * @param int flags : Zero value    - create or replace the xattr
+ *                    XATTR_CREATE  - create the xattr only (fail if xattr exists)
+ *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_dsetxattr( MDAL_DHANDLE dh, char hidden, const char* name, const void* value, size_t size, int flags ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   return kvmdal_setxattr( kdh->store, kdh->ino, hidden, name, value, size, flags );
+}
+
+/**
+ * Retrieve the specified xattr from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle for which to retrieve the xattr
+ * @param char hidden : A non-zero value indicates to retrieve a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to retrieve
+ * @param void* value : Buffer to be populated with the xattr value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
+ */
+ssize_t kvmdal_dgetxattr( MDAL_DHANDLE dh, char hidden, const char* name, void* value, size_t size ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   return kvmdal_getxattr( kdh->store, kdh->ino, hidden, name, value, size );
+}
+
+/**
+ * Remove the specified xattr from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle for which to remove the xattr
+ * @param char hidden : A non-zero value indicates to remove a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to remove
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_dremovexattr( MDAL_DHANDLE dh, char hidden, const char* name ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   return kvmdal_removexattr( kdh->store, kdh->ino, hidden, name );
+}
+
+/**
+ * List all xattr names from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle for which to list xattrs
+ * @param char hidden : A non-zero value indicates to list only 'hidden' MDAL values 
+ *                      ( otherwise, only non-hidden values are listed )
+ * @param char* buf : Buffer to be populated with xattr names
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
+ */
+ssize_t kvmdal_dlistxattr( MDAL_DHANDLE dh, char hidden, char* buf, size_t size ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   return kvmdal_listxattr( kdh->store, kdh->ino, hidden, buf, size );
+}
+
+/**
+ * Iterate to the next entry of an open directory handle
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @return struct dirent* : Reference to the next dirent struct, or NULL w/ errno unset if all 
+ *                          entries have been read, or NULL w/ errno set if a failure occurred
+ */
+struct dirent* kvmdal_readdir( MDAL_DHANDLE dh ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   int olderrno = errno;
+   KVTXN txn = kvstore_begin( kdh->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return NULL;
+   }
+   int res = kvmdal_nextdirent( txn, kdh );
+   if ( res < 0 ) {
+      LOG( LOG_ERR, "Failed to read the next dir entry ( %s )\n", strerror(errno) );
+      kvmdal_abort( txn );
+      return NULL;
+   }
+   kvtxn_abort( txn );
+   if ( res == 0 ) { errno = olderrno; return NULL; }
+   return &(kdh->ent);
+}
+
+/**
+ * Iterate over the next entries of an open directory handle, retrieving the attributes of each
+ * NOTE -- This shares the position of the directory handle with readdir(), telldir(), etc.
+ *         All entries are retrieved within a single store transaction.
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @param MDAL_direntplus* ents : Array of entries to be populated
+ * @param size_t count : Length of the 'ents' array
+ * @return ssize_t : Number of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
+ */
+ssize_t kvmdal_readdirplus( MDAL_DHANDLE dh, MDAL_direntplus* ents, size_t count ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   KVTXN txn = kvstore_begin( kdh->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   // as with fstatat(), entry attributes require search access to the dir
+   int sterr = ( kvmdal_permit( txn, kdh->ino, X_OK ) ) ? errno : 0;
+   size_t populated = 0;
+   while ( populated < count ) {
+      int res = kvmdal_nextdirent( txn, kdh );
+      if ( res <= 0 ) {
+         if ( res < 0 ) {
+            LOG( LOG_ERR, "Failed to read the next dir entry ( %s )\n", strerror(errno) );
+            // report what we have, and let the next call report the error
+            if ( populated == 0 ) { return kvmdal_abort( txn ); }
+         }
+         break;
+      }
+      MDAL_direntplus* tgtent = ents + populated;
+      tgtent->ent = kdh->ent;
+      tgtent->sterr = sterr;
+      kvmdal_inode inode;
+      if ( sterr ) { LOG( LOG_INFO, "Cannot stat dir entry \"%s\" ( %s )\n", kdh->ent.d_name, strerror(sterr) ); }
+      else if ( kvmdal_getinode( txn, (uint64_t)kdh->ent.d_ino, &(inode) ) ) {
+         LOG( LOG_INFO, "Failed to stat dir entry \"%s\" ( %s )\n", kdh->ent.d_name, strerror(errno) );
+         tgtent->sterr = errno;
+      }
+      else { kvmdal_fillstat( kdh->store, (uint64_t)kdh->ent.d_ino, &(inode), &(tgtent->st) ); }
+      tgtent->loc = kdh->loc;
+      populated++;
+   }
+   kvtxn_abort( txn );
+   return (ssize_t)populated;
+}
+
+/**
+ * Stat many entries of an open directory handle ( symlinks are NOT followed )
+ * NOTE -- All entries are retrieved within a single store transaction, at a cost far below
+ *         that of thread creation, so 'threads' is ignored.  All stat fields are populated,
+ *         regardless of 'mask'.
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE containing all entries
+ * @param size_t count : Number of entries to stat
+ * @param const char** names : Names of the entries to stat
+ * @param unsigned int mask : Bitwise OR of the MDAL_STAT_* fields required by the caller
+ * @param struct stat* sts : Array of stat structures to be populated
+ * @param int* errs : Array to be populated with the errno value of each stat ( zero on success )
+ * @param int threads : Ignored
+ * @return ssize_t : Number of successfully stat'd entries, or -1 if a failure occurred
+ */
+ssize_t kvmdal_statmany( MDAL_DHANDLE dh, size_t count, const char** names, unsigned int mask,
+                         struct stat* sts, int* errs, int threads ) {
+   // check for NULL args
+   if ( !(dh)  ||  ( count  &&  ( !(names)  ||  !(sts)  ||  !(errs) ) ) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE or array reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   KVTXN txn = kvstore_begin( kdh->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   size_t successes = 0;
+   size_t index = 0;
+   for ( ; index < count; index++ ) {
+      errs[index] = 0;
+      const char* name = names[index];
+      kvmdal_walkres res;
+      kvmdal_inode inode;
+      if ( name == NULL  ||  *name == '\0'  ||  strchr( name, '/' ) ) {
+         LOG( LOG_ERR, "Invalid entry name at index %zu: \"%s\"\n", index, (name) ? name : "NULL" );
+         errs[index] = EINVAL;
+      }
+      else if ( kvmdal_resolve( txn, kdh->ino, name, 0, &(res) )  ||  kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+         LOG( LOG_INFO, "Failed to stat entry \"%s\" ( %s )\n", name, strerror(errno) );
+         errs[index] = errno;
+      }
+      else {
+         kvmdal_fillstat( kdh->store, res.ino, &(inode), sts + index );
+         successes++;
+      }
+   }
+   kvtxn_abort( txn );
+   LOG( LOG_INFO, "Stat'd %zu of %zu entries\n", successes, count );
+   return (ssize_t)successes;
+}
+
+/**
+ * Identify the ( abstract ) location of an open directory handle
+ * NOTE -- This 'location' can be used via seekdir() to allow for the repeating
+ *         of readdir() results.  However, the 'location' value should be
+ *         considered an opaque type, with no caller assumptions as to content,
+ *         beyond error checking.
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to retrieve the location value of
+ * @return long : Abstract location value, or -1 on error
+ */
+long kvmdal_telldir( MDAL_DHANDLE dh ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   return kdh->loc;
+}
+
+/**
+ * Set the position of an open directory handle, for future readdir() calls
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to seek
+ * @param long loc : Location value to seek to
+ *                   NOTE -- this value *must* come from a previous telldir()
+ * @return int : Zero on success, or -1 on failure
+ */
+int kvmdal_seekdir( MDAL_DHANDLE dh, long loc ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( loc < 0 ) {
+      LOG( LOG_ERR, "Received an invalid location value: %ld\n", loc );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   kdh->loc = loc;
+   return 0;
+}
+
+/**
+ * Reset the position of an open directory handle, for future readdir() calls, to the
+ * beginning of the dir
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to rewind
+ * @return int : Zero on success, or -1 on failure
+ */
+int kvmdal_rewinddir( MDAL_DHANDLE dh ) {
+   return kvmdal_seekdir( dh, 0 );
+}
+
+/**
+ * Close the given directory handle
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to close
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_closedir( MDAL_DHANDLE dh ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_DHANDLE kdh = (KV_DHANDLE) dh;
+   KVMDAL_STORE store = kdh->store;
+   free( kdh );
+   return kvmdal_dropstore( store );
+}
+
+
+// FHANDLE Functions
+
+/**
+ * Open a file, relative to the given MDAL_CTXT
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : Relative path to the target file from the ctxt
+ * @param int flags : Flags specifying behavior (see the 'open()' syscall 'flags' value for full info)
+ *                    Note -- MDAL_CTXT file handles cannot be used to create new files ( no O_CREAT )
+ * @return MDAL_FHANDLE : An MDAL_READ handle for the target file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE kvmdal_open( MDAL_CTXT ctxt, const char* path, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // reject the O_CREAT flag
+   if ( flags & O_CREAT ) {
+      LOG( LOG_ERR, "Received disallowed O_CREAT flag\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   return (MDAL_FHANDLE) kvmdal_openat( kctxt->store, kctxt->pathdir, path, flags, 0 );
+}
+
+/**
+ * Close the given MDAL_FHANDLE
+ * NOTE -- The final close of a file which has since been unlinked will purge its content.
+ * @param fh : File handle to be closed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_close( MDAL_FHANDLE fh ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   KVMDAL_STORE store = kfh->store;
+   uint64_t ino = kfh->ino;
+   free( kfh );
+   int retval = 0;
+   if ( kvmdal_closeinode( store, ino ) == 0 ) {
+      // check for an orphan record, left by an unlink of the open file
+      char key[KMDAL_KEYMAX];
+      size_t keylen = kvmdal_key( key, KMDAL_KEY_ORPHAN, ino, NULL, 0 );
+      size_t vallen;
+      KVTXN txn = kvstore_begin( store->kvs, 0 );
+      if ( txn == NULL ) {
+         LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+         retval = -1;
+      }
+      else {
+         char orphan = ( kvtxn_get( txn, key, keylen, &(vallen) ) != NULL );
+         kvtxn_abort( txn );
+         if ( orphan ) {
+            LOG( LOG_INFO, "Purging unlinked inode %llu on final close\n", (unsigned long long)ino );
+            txn = kvstore_begin( store->kvs, 1 );
+            if ( txn == NULL ) {
+               LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+               retval = -1;
+            }
+            else if ( kvtxn_get( txn, key, keylen, &(vallen) )  &&  kvmdal_opencount( store, ino ) == 0 ) {
+               // NOTE -- any failure here leaves the orphan record, for purging by the next process
+               if ( kvmdal_purge( txn, ino ) ) { retval = kvmdal_abort( txn ); }
+               else { retval = kvtxn_commit( txn ); }
+            }
+            else { kvtxn_abort( txn ); }
+         }
+      }
+   }
+   if ( kvmdal_dropstore( store ) ) { retval = -1; }
+   return retval;
+}
+
+/**
+ * Write data to the given MDAL_WRITE, MDAL_DIRECT file handle
+ * NOTE -- Large writes are divided into multiple transactions.  A failure partway through will
+ *         result in a short write count, as with a write() syscall.
+ * @param MDAL_FHANDLE fh : File handle to be written to
+ * @param const void* buf : Buffer containing the data to be written
+ * @param size_t count : Number of data bytes contained within the buffer
+ * @return ssize_t : Number of bytes written, or -1 if a failure occurred
+ */
+ssize_t kvmdal_write( MDAL_FHANDLE fh, const void* buf, size_t count ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   if ( ( kfh->flags & O_ACCMODE ) == O_RDONLY ) {
+      LOG( LOG_ERR, "File handle is not open for writing\n" );
+      errno = EBADF;
+      return -1;
+   }
+   if ( count > SSIZE_MAX ) { count = SSIZE_MAX; }
+   const char* data = buf;
+   size_t written = 0;
+   while ( written < count ) {
+      KVTXN txn = kvstore_begin( kfh->store->kvs, 1 );
+      if ( txn == NULL ) {
+         LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+         break;
+      }
+      kvmdal_inode inode;
+      if ( kvmdal_getinode( txn, kfh->ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to retrieve the inode of the target file\n" );
+         kvmdal_abort( txn );
+         break;
+      }
+      uint64_t offset = ( kfh->flags & O_APPEND ) ? inode.size : (uint64_t)kfh->offset;
+      if ( offset > (uint64_t)( LLONG_MAX - ( count - written ) ) ) {
+         LOG( LOG_ERR, "Write would exceed the max file size\n" );
+         kvtxn_abort( txn );
+         errno = EFBIG;
+         break;
+      }
+      // limit each transaction to a bounded number of data blocks
+      size_t chunk = count - written;
+      uint64_t chunkend = ( ( offset / KMDAL_BLOCKSIZE ) + KMDAL_WRITECHUNK ) * KMDAL_BLOCKSIZE;
+      if ( offset + chunk > chunkend ) { chunk = chunkend - offset; }
+      size_t done = 0;
+      while ( done < chunk ) {
+         uint64_t blocknum = ( offset + done ) / KMDAL_BLOCKSIZE;
+         size_t blockoff = ( offset + done ) % KMDAL_BLOCKSIZE;
+         size_t copy = KMDAL_BLOCKSIZE - blockoff;
+         if ( copy > chunk - done ) { copy = chunk - done; }
+         char key[KMDAL_KEYMAX];
+         size_t keylen = kvmdal_numkey( key, KMDAL_KEY_BLOCK, kfh->ino, blocknum );
+         char block[KMDAL_BLOCKSIZE];
+         size_t blocklen = 0;
+         const void* val = kvtxn_get( txn, key, keylen, &(blocklen) );
+         if ( val == NULL ) { blocklen = 0; inode.blocks++; }
+         else if ( blocklen > KMDAL_BLOCKSIZE ) {
+            LOG( LOG_ERR, "Data block %llu of inode %llu has an invalid length of %zu\n",
+                 (unsigned long long)blocknum, (unsigned long long)kfh->ino, blocklen );
+            errno = EIO;
+            break;
+         }
+         else { memcpy( block, val, blocklen ); }
+         // zero-fill any gap between the existing block content and the new data
+         if ( blockoff > blocklen ) { memset( block + blocklen, 0, blockoff - blocklen ); }
+         memcpy( block + blockoff, data + written + done, copy );
+         if ( blockoff + copy > blocklen ) { blocklen = blockoff + copy; }
+         if ( kvtxn_put( txn, key, keylen, block, blocklen ) ) {
+            LOG( LOG_ERR, "Failed to stage data block %llu of inode %llu\n",
+                 (unsigned long long)blocknum, (unsigned long long)kfh->ino );
+            break;
+         }
+         done += copy;
+      }
+      if ( done < chunk ) { kvmdal_abort( txn ); break; }
+      if ( offset + chunk > inode.size ) { inode.size = offset + chunk; }
+      kvmdal_now( inode.mtime );
+      memcpy( inode.ctime, inode.mtime, sizeof( inode.ctime ) );
+      if ( kvmdal_putinode( txn, kfh->ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to stage update of inode %llu\n", (unsigned long long)kfh->ino );
+         kvmdal_abort( txn );
+         break;
+      }
+      if ( kvtxn_commit( txn ) ) {
+         LOG( LOG_ERR, "Failed to commit write to inode %llu\n", (unsigned long long)kfh->ino );
+         break;
+      }
+      kfh->offset = (off_t)( offset + chunk );
+      written += chunk;
+   }
+   if ( written == 0  &&  count ) { return -1; }
+   return (ssize_t)written;
+}
+
+/**
+ * Read data from the given MDAL_READ, MDAL_DIRECT file handle
+ * NOTE -- This MDAL does not update atime values on read.
+ * @param MDAL_FHANDLE fh : File handle to be read from
+ * @param void* buf : Buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 if a failure occurred
+ */
+ssize_t kvmdal_read( MDAL_FHANDLE fh, void* buf, size_t count ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   if ( ( kfh->flags & O_ACCMODE ) == O_WRONLY ) {
+      LOG( LOG_ERR, "File handle is not open for reading\n" );
+      errno = EBADF;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kfh->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_inode inode;
+   if ( kvmdal_getinode( txn, kfh->ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the inode of the target file\n" );
+      return kvmdal_abort( txn );
+   }
+   uint64_t offset = (uint64_t)kfh->offset;
+   if ( offset >= inode.size ) { kvtxn_abort( txn ); return 0; }
+   if ( count > inode.size - offset ) { count = inode.size - offset; }
+   if ( count > SSIZE_MAX ) { count = SSIZE_MAX; }
+   char* data = buf;
+   size_t done = 0;
+   while ( done < count ) {
+      uint64_t blocknum = ( offset + done ) / KMDAL_BLOCKSIZE;
+      size_t blockoff = ( offset + done ) % KMDAL_BLOCKSIZE;
+      size_t copy = KMDAL_BLOCKSIZE - blockoff;
+      if ( copy > count - done ) { copy = count - done; }
+      char key[KMDAL_KEYMAX];
+      size_t blocklen = 0;
+      const char* val = kvtxn_get( txn, key, kvmdal_numkey( key, KMDAL_KEY_BLOCK, kfh->ino, blocknum ), &(blocklen) );
+      // any absent content is a hole, and reads as zeroes
+      size_t present = 0;
+      if ( val  &&  blocklen > blockoff ) {
+         present = blocklen - blockoff;
+         if ( present > copy ) { present = copy; }
+         memcpy( data + done, val + blockoff, present );
+      }
+      if ( present < copy ) { memset( data + done + present, 0, copy - present ); }
+      done += copy;
+   }
+   kvtxn_abort( txn );
+   kfh->offset = (off_t)( offset + count );
+   return (ssize_t)count;
+}
+
+/**
+ * Truncate the file referenced by the given MDAL_WRITE, MDAL_DIRECT file handle
+ * @param MDAL_FHANDLE fh : File handle to be truncated
+ * @param off_t length : File length to truncate to
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_ftruncate( MDAL_FHANDLE fh, off_t length ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   if ( ( kfh->flags & O_ACCMODE ) == O_RDONLY  ||  length < 0 ) {
+      LOG( LOG_ERR, "Invalid truncate of a %s handle to length %lld\n",
+           ( ( kfh->flags & O_ACCMODE ) == O_RDONLY ) ? "read-only" : "writable", (long long)length );
+      errno = EINVAL;
+      return -1;
+   }
+   uint64_t ino;
+   kvmdal_inode inode;
+   KVTXN txn = kvmdal_attrbegin( kfh->store, kfh->ino, NULL, 0, &(ino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_truncate( txn, ino, &(inode), (uint64_t)length ) ) {
+      LOG( LOG_ERR, "Failed to stage truncation of inode %llu\n", (unsigned long long)ino );
+      return kvmdal_abort( txn );
+   }
+   return kvmdal_attrcommit( txn, ino, &(inode) );
+}
+
+/**
+ * Seek to the specified position in the file referenced by the given MDAL_DIRECT file handle
+ * @param MDAL_FHANDLE fh : File handle to seek
+ * @param off_t offset : Number of bytes to seek over
+ * @param int whence : SEEK_SET - seek from the beginning of the file
+ *                     SEEK_CUR - seek from the current location
+ *                     SEEK_END - seek from the end of the file
+ * @return off_t : Resulting offset within the file, or -1 if a failure occurred
+ */
+off_t kvmdal_lseek( MDAL_FHANDLE fh, off_t offset, int whence ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   off_t base = 0;
+   if ( whence == SEEK_CUR ) { base = kfh->offset; }
+   else if ( whence == SEEK_END ) {
+      KVTXN txn = kvstore_begin( kfh->store->kvs, 0 );
+      if ( txn == NULL ) {
+         LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+         return -1;
+      }
+      kvmdal_inode inode;
+      if ( kvmdal_getinode( txn, kfh->ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to retrieve the inode of the target file\n" );
+         return kvmdal_abort( txn );
+      }
+      kvtxn_abort( txn );
+      base = (off_t)inode.size;
+   }
+   else if ( whence != SEEK_SET ) {
+      LOG( LOG_ERR, "Received an unrecognized whence value: %d\n", whence );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( ( offset > 0  &&  base > LLONG_MAX - offset )  ||  base + offset < 0 ) {
+      LOG( LOG_ERR, "Seek would result in an invalid offset\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   kfh->offset = base + offset;
+   return kfh->offset;
+}
+
+/**
+ * Set the specified xattr on the file referenced by the given MDAL_WRITE file handle
+ * @param MDAL_FHANDLE fh : File handle for which to set the xattr
+ * @param char hidden : A non-zero value indicates to store this as a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to set
+ * @param const void* value : Buffer containing the value of the xattr
+ * @param size_t size : Size of the value buffer
+ * @param int flags : Zero value    - create or replace the xattr
+ *                    XATTR_CREATE  - create the xattr only (fail if xattr exists)
+ *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_fsetxattr( MDAL_FHANDLE fh, char hidden, const char* name, const void* value, size_t size, int flags ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   return kvmdal_setxattr( kfh->store, kfh->ino, hidden, name, value, size, flags );
+}
+
+/**
+ * Retrieve the specified xattr from the file referenced by the given MDAL_READ file handle
+ * @param MDAL_FHANDLE fh : File handle for which to retrieve the xattr
+ * @param char hidden : A non-zero value indicates to retrieve a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to retrieve
+ * @param void* value : Buffer to be populated with the xattr value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
+ */
+ssize_t kvmdal_fgetxattr( MDAL_FHANDLE fh, char hidden, const char* name, void* value, size_t size ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   return kvmdal_getxattr( kfh->store, kfh->ino, hidden, name, value, size );
+}
+
+/**
+ * Remove the specified xattr from the file referenced by the given MDAL_WRITE file handle
+ * @param MDAL_FHANDLE fh : File handle for which to remove the xattr
+ * @param char hidden : A non-zero value indicates to remove a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to remove
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_fremovexattr( MDAL_FHANDLE fh, char hidden, const char* name ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   return kvmdal_removexattr( kfh->store, kfh->ino, hidden, name );
+}
+
+/**
+ * List all xattr names from the file referenced by the given MDAL_READ file handle
+ * @param MDAL_FHANDLE fh : File handle for which to list xattrs
+ * @param char hidden : A non-zero value indicates to list only 'hidden' MDAL values 
+ *                      ( otherwise, only non-hidden values are listed )
+ * @param char* buf : Buffer to be populated with xattr names
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
+ */
+ssize_t kvmdal_flistxattr( MDAL_FHANDLE fh, char hidden, char* buf, size_t size ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   return kvmdal_listxattr( kfh->store, kfh->ino, hidden, buf, size );
+}
+
+/**
+ * Perform a stat operation on the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to stat
+ * @param struct stat* buf : Reference to a stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_fstat ( MDAL_FHANDLE fh, struct stat* buf ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   KVTXN txn = kvstore_begin( kfh->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_inode inode;
+   if ( kvmdal_getinode( txn, kfh->ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve the inode of the target file\n" );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   kvmdal_fillstat( kfh->store, kfh->ino, &(inode), buf );
+   return 0;
+}
+
+/**
+ * Update the timestamps of the target file
+ * @param MDAL_FHANDLE fh : File handle on which to set timestamps
+ * @param const struct timespec times[2] : Struct references for new times
+ *                                         times[0] - atime values
+ *                                         times[1] - mtime values
+ *                                         (see man utimensat for struct reference)
+ * @return int : Zero value on success, or -1 if a failure occurred
+ */
+int kvmdal_futimens ( MDAL_FHANDLE fh, const struct timespec times[2] ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_FHANDLE kfh = (KV_FHANDLE) fh;
+   uint64_t ino;
+   kvmdal_inode inode;
+   KVTXN txn = kvmdal_attrbegin( kfh->store, kfh->ino, NULL, 0, &(ino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_permittimes( &(inode), times ) ) {
+      LOG( LOG_ERR, "Timestamp update of inode %llu is not permitted\n", (unsigned long long)ino );
+      return kvmdal_abort( txn );
+   }
+   kvmdal_settimes( &(inode), times );
+   return kvmdal_attrcommit( txn, ino, &(inode) );
+}
+
+
+// Path Functions
+
+/**
+ * Check access to the specified file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param int mode : F_OK - check for file existance
+ *                      or a bitwise OR of the following...
+ *                   R_OK - check for read access
+ *                   W_OK - check for write access
+ *                   X_OK - check for execute access
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_EACCESS - Perform access checks using effective uid/gid
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_access( MDAL_CTXT ctxt, const char* path, int mode, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_EACCESS | AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   if ( kvmdal_resolve( txn, kctxt->pathdir, path, !( flags & AT_SYMLINK_NOFOLLOW ), &(res) )  ||
+        kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+      LOG( LOG_INFO, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   kvtxn_abort( txn );
+   return kvmdal_checkaccess( &(inode), mode, flags );
+}
+
+/**
+ * Create a filesystem node
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target node
+ * @param mode_t mode : Mode value for the created node (see inode man page)
+ * @param dev_t dev : S_IFREG  - regular file
+ *                    S_IFCHR  - character special file
+ *                    S_IFBLK  - block special file
+ *                    S_IFIFO  - FIFO
+ *                    S_IFSOCK - socket
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_mknod( MDAL_CTXT ctxt, const char* path, mode_t mode, dev_t dev ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // as with mknod(), a zero file type indicates a regular file
+   mode_t type = mode & S_IFMT;
+   if ( type == 0 ) { type = S_IFREG; }
+   if ( type != S_IFREG  &&  type != S_IFCHR  &&  type != S_IFBLK  &&  type != S_IFIFO  &&  type != S_IFSOCK ) {
+      LOG( LOG_ERR, "Received an unsupported file type: %o\n", (unsigned int)type );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode parent;
+   uint64_t ino;
+   kvmdal_inode inode;
+   if ( kvmdal_resolvenew( txn, kctxt->pathdir, path, &(res) ) ) {
+      LOG( LOG_ERR, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( res.trailing ) {
+      LOG( LOG_ERR, "Non-directory target path has a trailing '/': \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = ENOENT;
+      return -1;
+   }
+   if ( kvmdal_getinode( txn, res.parent, &(parent) )  ||  kvmdal_checkaccess( &(parent), W_OK | X_OK, AT_EACCESS )  ||
+        kvmdal_create( txn, res.parent, &(parent), res.name, res.namelen, type | ( mode & 07777 ),
+                       ( type == S_IFCHR  ||  type == S_IFBLK ) ? dev : 0, &(ino), &(inode) )  ||
+        kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to create target node: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Edit the mode of the specified file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param mode_t mode : New mode value for the file (see inode man page)
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_chmod( MDAL_CTXT ctxt, const char* path, mode_t mode, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   uint64_t ino;
+   kvmdal_inode inode;
+   KVTXN txn = kvmdal_attrbegin( kctxt->store, kctxt->pathdir, path, !( flags & AT_SYMLINK_NOFOLLOW ), &(ino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   // as with fchmodat(), the mode of a symlink itself cannot be changed
+   if ( S_ISLNK( inode.mode ) ) {
+      LOG( LOG_ERR, "Cannot change the mode of a symlink: \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = EOPNOTSUPP;
+      return -1;
+   }
+   if ( kvmdal_permitowner( &(inode) ) ) {
+      LOG( LOG_ERR, "Only the owner of the target may change its mode: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   inode.mode = ( inode.mode & S_IFMT ) | ( mode & 07777 );
+   return kvmdal_attrcommit( txn, ino, &(inode) );
+}
+
+/**
+ * Edit the ownership and group of the specified file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param uid_t owner : New owner ( or -1, to leave unchanged )
+ * @param gid_t group : New group ( or -1, to leave unchanged )
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_chown( MDAL_CTXT ctxt, const char* path, uid_t owner, gid_t group, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   uint64_t ino;
+   kvmdal_inode inode;
+   KVTXN txn = kvmdal_attrbegin( kctxt->store, kctxt->pathdir, path, !( flags & AT_SYMLINK_NOFOLLOW ), &(ino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_permitchown( &(inode), owner, group ) ) {
+      LOG( LOG_ERR, "Ownership change of the target is not permitted: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   if ( owner != (uid_t)-1 ) { inode.uid = owner; }
+   if ( group != (gid_t)-1 ) { inode.gid = group; }
+   return kvmdal_attrcommit( txn, ino, &(inode) );
+}
+
+/**
+ * Stat the specified file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param struct stat* st : Stat structure to be populated
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_stat( MDAL_CTXT ctxt, const char* path, struct stat* st, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_statat( kctxt->store, kctxt->pathdir, path, !( flags & AT_SYMLINK_NOFOLLOW ), st );
+}
+
+
+/**
+ * Create a hardlink
+ * @param MDAL_CTXT oldctxt : MDAL_CTXT to operate relative to for 'oldpath'
+ * @param const char* oldpath : String path of the target file
+ * @param MDAL_CTXT newctxt : MDAL_CTXT to operate relative to for 'newpath'
+ * @param const char* newpath : String path of the new hardlink
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_link( MDAL_CTXT oldctxt, const char* oldpath, MDAL_CTXT newctxt, const char* newpath, int flags ) {
+   // check for NULL ctxt
+   if ( !(oldctxt)  ||  !(newctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT koldctxt = (KV_MDAL_CTXT) oldctxt;
+   KV_MDAL_CTXT knewctxt = (KV_MDAL_CTXT) newctxt;
+   // check for a valid NS target
+   if ( koldctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved an 'old' MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( knewctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved an 'new' MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( koldctxt->store != knewctxt->store ) {
+      LOG( LOG_ERR, "Cannot link between distinct stores\n" );
+      errno = EXDEV;
+      return -1;
+   }
+   // as with linkat() lacking AT_SYMLINK_FOLLOW, a symlink target is never dereferenced
+   return kvmdal_linkat( koldctxt->store, koldctxt->pathdir, oldpath, knewctxt->pathdir, newpath, 0 );
+}
+
+
+/**
+ * Create the specified directory
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the new directory
+ * @param mode_t mode : Mode value of the new directory (see inode man page)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_mkdir( MDAL_CTXT ctxt, const char* path, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_mkdirat( kctxt->store, kctxt->pathdir, path, mode );
+}
+
+
+/**
+ * Delete the specified directory
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target directory
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_rmdir( MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_rmdirat( kctxt->store, kctxt->pathdir, path );
+}
+
+
+/**
+ * Read the target path of the specified symlink
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target symlink
+ * @param char* buf : Buffer to be populated with the link value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the link target string, or -1 if a failure occurred
+ */
+ssize_t kvmdal_readlink( MDAL_CTXT ctxt, const char* path, char* buf, size_t size ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 0 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode inode;
+   if ( kvmdal_resolve( txn, kctxt->pathdir, path, 0, &(res) )  ||  kvmdal_getinode( txn, res.ino, &(inode) ) ) {
+      LOG( LOG_INFO, "Failed to resolve target path: \"%s\" ( %s )\n", path, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( !(S_ISLNK( inode.mode )) ) {
+      LOG( LOG_ERR, "Target is not a symlink: \"%s\"\n", path );
+      kvtxn_abort( txn );
+      errno = EINVAL;
+      return -1;
+   }
+   char key[KMDAL_KEYMAX];
+   size_t linklen = 0;
+   const void* linkval = kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_LINK, res.ino, NULL, 0 ), &(linklen) );
+   if ( linkval == NULL ) {
+      LOG( LOG_ERR, "Symlink inode %llu is missing a target value\n", (unsigned long long)res.ino );
+      kvtxn_abort( txn );
+      errno = EIO;
+      return -1;
+   }
+   // as with readlink(), the result is truncated to the buffer size, without a NULL terminator
+   if ( linklen > size ) { linklen = size; }
+   memcpy( buf, linkval, linklen );
+   kvtxn_abort( txn );
+   return (ssize_t)linklen;
+}
+
+
+/**
+ * Rename the specified target to a new path
+ * @param MDAL_CTXT fromctxt : MDAL_CTXT to operate relative to for the 'from' path
+ * @param const char* from : String path of the target
+ * @param MDAL_CTXT toctxt : MDAL_CTXT to operate relative to for the 'to' path
+ * @param const char* to : Destination string path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_rename( MDAL_CTXT fromctxt, const char* from, MDAL_CTXT toctxt, const char* to ) {
+   // check for NULL ctxt
+   if ( !(fromctxt)  ||  !(toctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kfromctxt = (KV_MDAL_CTXT) fromctxt;
+   KV_MDAL_CTXT ktoctxt = (KV_MDAL_CTXT) toctxt;
+   // check for a valid NS target
+   if ( kfromctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a 'from' MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( ktoctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a 'to' MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( kfromctxt->store != ktoctxt->store ) {
+      LOG( LOG_ERR, "Cannot rename between distinct stores\n" );
+      errno = EXDEV;
+      return -1;
+   }
+   return kvmdal_renameat( kfromctxt->store, kfromctxt->pathdir, from, ktoctxt->pathdir, to );
+}
+
+/**
+ * Return statvfs info for the current namespace
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to retrieve info for
+ * @param struct statvfs* buf : Reference to the statvfs structure to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_statvfs( MDAL_CTXT ctxt, struct statvfs* buf ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // all namespaces share the filesystem backing the store directory
+   return fstatvfs( kctxt->store->dirfd, buf );
+}
+
+/**
+ * Create a symlink
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* target : String path for the link to target
+ * @param const char* linkname : String path of the new link
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_symlink( MDAL_CTXT ctxt, const char* target, const char* linkname ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // as with symlink(), reject an empty target
+   size_t targetlen = ( target ) ? strlen( target ) : 0;
+   if ( targetlen == 0  ||  targetlen >= PATH_MAX ) {
+      LOG( LOG_ERR, "Received an invalid symlink target\n" );
+      errno = ( targetlen ) ? ENAMETOOLONG : ENOENT;
+      return -1;
+   }
+   KVTXN txn = kvstore_begin( kctxt->store->kvs, 1 );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to begin a store transaction\n" );
+      return -1;
+   }
+   kvmdal_walkres res;
+   kvmdal_inode parent;
+   uint64_t ino;
+   kvmdal_inode inode;
+   if ( kvmdal_resolvenew( txn, kctxt->pathdir, linkname, &(res) ) ) {
+      LOG( LOG_ERR, "Failed to resolve link path: \"%s\" ( %s )\n", linkname, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   if ( res.trailing ) {
+      LOG( LOG_ERR, "Link path has a trailing '/': \"%s\"\n", linkname );
+      kvtxn_abort( txn );
+      errno = ENOENT;
+      return -1;
+   }
+   char key[KMDAL_KEYMAX];
+   if ( kvmdal_getinode( txn, res.parent, &(parent) )  ||  kvmdal_checkaccess( &(parent), W_OK | X_OK, AT_EACCESS )  ||
+        kvmdal_create( txn, res.parent, &(parent), res.name, res.namelen, S_IFLNK | 0777, 0, &(ino), &(inode) )  ||
+        kvmdal_putinode( txn, res.parent, &(parent) ) ) {
+      LOG( LOG_ERR, "Failed to create symlink: \"%s\" ( %s )\n", linkname, strerror(errno) );
+      return kvmdal_abort( txn );
+   }
+   inode.size = targetlen;
+   if ( kvmdal_putinode( txn, ino, &(inode) )  ||
+        kvtxn_put( txn, key, kvmdal_key( key, KMDAL_KEY_LINK, ino, NULL, 0 ), target, targetlen ) ) {
+      LOG( LOG_ERR, "Failed to stage target of symlink: \"%s\"\n", linkname );
+      return kvmdal_abort( txn );
+   }
+   return kvtxn_commit( txn );
+}
+
+/**
+ * Unlink the specified file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvmdal_unlink( MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvmdal_unlinkat( kctxt->store, kctxt->pathdir, path );
+}
+
+/**
+ * Update the timestamps of the target file
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param const struct timespec times[2] : Struct references for new times
+ *                                         times[0] - atime values
+ *                                         times[1] - mtime values
+ *                                         (see man utimensat for struct reference)
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference symlinks
+ * @return int : Zero value on success, or -1 if a failure occurred
+ */
+int kvmdal_utimens ( MDAL_CTXT ctxt, const char* path, const struct timespec times[2], int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KV_MDAL_CTXT kctxt = (KV_MDAL_CTXT) ctxt;
+   // check for a valid NS target
+   if ( kctxt->pathns == 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // reject any unsupported flag values
+   if ( flags & ~(AT_SYMLINK_NOFOLLOW) ) {
+      LOG( LOG_ERR, "Detected unsupported flag value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   uint64_t ino;
+   kvmdal_inode inode;
+   KVTXN txn = kvmdal_attrbegin( kctxt->store, kctxt->pathdir, path, !( flags & AT_SYMLINK_NOFOLLOW ), &(ino), &(inode) );
+   if ( txn == NULL ) { return -1; }
+   if ( kvmdal_permittimes( &(inode), times ) ) {
+      LOG( LOG_ERR, "Timestamp update of the target is not permitted: \"%s\"\n", path );
+      return kvmdal_abort( txn );
+   }
+   kvmdal_settimes( &(inode), times );
+   return kvmdal_attrcommit( txn, ino, &(inode) );
+}
+
+
+//   -------------    KV INITIALIZATION    -------------
+
+MDAL kv_mdal_init( xmlNode* root ) {
+   // check for NULL root
+   if ( !(root) ) {
+      LOG( LOG_ERR, "Received a NULL root XML node\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // parse all config elements
+   char* nsrootpath = NULL;
+   int storeflags = 0;
+   for ( ; root; root = root->next ) {
+      if ( root->type != XML_ELEMENT_NODE ) { continue; }
+      // make sure the node contains a text element within it
+      if ( root->children == NULL  ||  root->children->type != XML_TEXT_NODE ) {
+         LOG( LOG_ERR, "the \"%s\" node is expected to contain a text value\n", (char*)root->name );
+         errno = EINVAL;
+         return NULL;
+      }
+      if ( strncmp( (char*)root->name, "ns_root", 8 ) == 0 ) {
+         nsrootpath = (char*)root->children->content;
+      }
+      else if ( strncmp( (char*)root->name, "sync", 5 ) == 0 ) {
+         if ( strncasecmp( (char*)root->children->content, "no", 3 ) == 0 ) { storeflags |= KVSTORE_NOSYNC; }
+         else if ( strncasecmp( (char*)root->children->content, "yes", 4 ) ) {
+            LOG( LOG_ERR, "the \"sync\" node is expected to contain \"yes\" or \"no\"\n" );
+            errno = EINVAL;
+            return NULL;
+         }
+      }
+      else { LOG( LOG_WARNING, "encountered unrecognized config element: \"%s\"\n", (char*)root->name ); }
+   }
+   if ( nsrootpath == NULL ) {
+      LOG( LOG_ERR, "config is expected to include a \"ns_root\" node\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+
+   // open the store beneath the specified directory
+   KVMDAL_STORE store = kvmdal_openstore( nsrootpath, storeflags );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to open a store beneath the 'ns_root' directory: \"%s\"\n", nsrootpath );
+      return NULL;
+   }
+   // allocate space for our context struct, indicating no NS target
+   KV_MDAL_CTXT kctxt = calloc( 1, sizeof( struct kv_mdal_context_struct ) );
+   if ( kctxt == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate context struct\n" );
+      int olderrno = errno;
+      kvmdal_dropstore( store );
+      errno = olderrno;
+      return NULL;
+   }
+   kctxt->store = store;
+
+   // allocate and populate a new MDAL structure
+   MDAL kmdal = calloc( 1, sizeof( struct MDAL_struct ) );
+   if ( kmdal == NULL ) {
+      LOG( LOG_ERR, "failed to allocate space for an MDAL_struct\n" );
+      kvmdal_destroyctxt( kctxt );
+      return NULL;
+   }
+   kmdal->name = "kv";
+   kmdal->ctxt = (MDAL_CTXT) kctxt;
+   kmdal->pathfilter = kvmdal_pathfilter;
+   kmdal->destroyctxt = kvmdal_destroyctxt;
+   kmdal->dupctxt = kvmdal_dupctxt;
+   kmdal->cleanup = kvmdal_cleanup;
+   kmdal->checksec = kvmdal_checksec;
+   kmdal->setnamespace = kvmdal_setnamespace;
+   kmdal->newctxt = kvmdal_newctxt;
+   kmdal->newsplitctxt = kvmdal_newsplitctxt;
+   kmdal->createnamespace = kvmdal_createnamespace;
+   kmdal->destroynamespace = kvmdal_destroynamespace;
+   kmdal->opendirnamespace = kvmdal_opendirnamespace;
+   kmdal->accessnamespace = kvmdal_accessnamespace;
+   kmdal->statnamespace = kvmdal_statnamespace;
+   kmdal->chmodnamespace = kvmdal_chmodnamespace;
+   kmdal->chownnamespace = kvmdal_chownnamespace;
+   kmdal->setdatausage = kvmdal_setdatausage;
+   kmdal->getdatausage = kvmdal_getdatausage;
+   kmdal->setinodeusage = kvmdal_setinodeusage;
+   kmdal->getinodeusage = kvmdal_getinodeusage;
+   kmdal->createrefdir = kvmdal_createrefdir;
+   kmdal->destroyrefdir = kvmdal_destroyrefdir;
+   kmdal->linkref = kvmdal_linkref;
+   kmdal->renameref = kvmdal_renameref;
+   kmdal->unlinkref = kvmdal_unlinkref;
+   kmdal->statref = kvmdal_statref;
+   kmdal->openref = kvmdal_openref;
+   kmdal->openscanner = kvmdal_openscanner;
+   kmdal->closescanner = kvmdal_closescanner;
+   kmdal->scan = kvmdal_scan;
+   kmdal->sopen = kvmdal_sopen;
+   kmdal->sunlink = kvmdal_sunlink;
+   kmdal->sstat = kvmdal_sstat;
+   kmdal->opendir = kvmdal_opendir;
+   kmdal->chdir = kvmdal_chdir;
+   kmdal->dsetxattr = kvmdal_dsetxattr;
+   kmdal->dgetxattr = kvmdal_dgetxattr;
+   kmdal->dremovexattr = kvmdal_dremovexattr;
+   kmdal->dlistxattr = kvmdal_dlistxattr;
+   kmdal->readdir = kvmdal_readdir;
+   kmdal->readdirplus = kvmdal_readdirplus;
+   kmdal->statmany = kvmdal_statmany;
+   kmdal->telldir = kvmdal_telldir;
+   kmdal->seekdir = kvmdal_seekdir;
+   kmdal->rewinddir = kvmdal_rewinddir;
+   kmdal->closedir = kvmdal_closedir;
+   kmdal->open = kvmdal_open;
+   kmdal->close = kvmdal_close;
+   kmdal->write = kvmdal_write;
+   kmdal->read = kvmdal_read;
+   kmdal->ftruncate = kvmdal_ftruncate;
+   kmdal->lseek = kvmdal_lseek;
+   kmdal->fsetxattr = kvmdal_fsetxattr;
+   kmdal->fgetxattr = kvmdal_fgetxattr;
+   kmdal->fremovexattr = kvmdal_fremovexattr;
+   kmdal->flistxattr = kvmdal_flistxattr;
+   kmdal->fstat = kvmdal_fstat;
+   kmdal->futimens = kvmdal_futimens;
+   kmdal->access = kvmdal_access;
+   kmdal->mknod = kvmdal_mknod;
+   kmdal->chmod = kvmdal_chmod;
+   kmdal->chown = kvmdal_chown;
+   kmdal->stat = kvmdal_stat;
+   kmdal->link = kvmdal_link;
+   kmdal->mkdir = kvmdal_mkdir;
+   kmdal->rmdir = kvmdal_rmdir;
+   kmdal->readlink = kvmdal_readlink;
+   kmdal->rename = kvmdal_rename;
+   kmdal->statvfs = kvmdal_statvfs;
+   kmdal->symlink = kvmdal_symlink;
+   kmdal->unlink = kvmdal_unlink;
+   kmdal->utimens = kvmdal_utimens;
+   return kmdal;
+}
+
@@ -0,0 +1,1265 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_MDAL
+#define DEBUG DEBUG_MDAL
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "kvstore"
+#include "logging/logging.h"
+
+#include "kvstore.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+
+//   -------------    KVSTORE DEFINITIONS    -------------
+
+#define KVSTORE_LOCKFILE "LOCK"
+#define KVSTORE_LOGPREFX "LOG."
+#define KVSTORE_TMPSUFFX ".tmp"
+#define KVSTORE_NAMELEN  32 // max length of any log segment name
+
+// log segment layout :  [ SEGMAGIC ( 8 bytes ) ][ generation ( 8 bytes ) ][ frame ][ frame ]...
+//   frame layout :      [ FRAMEMAGIC ( 4 bytes ) ][ payload length ( 4 bytes ) ][ payload crc32 ( 4 bytes ) ][ payload ]
+//   payload layout :    [ op ( 1 byte ) ][ key length ( 4 bytes ) ][ value length ( 4 bytes ) ][ key ][ value ]...
+// NOTE -- all length values are stored in host byte order
+#define KVSTORE_SEGMAGIC   "MARFSKV1"
+#define KVSTORE_SEGHEAD    16
+#define KVSTORE_FRAMEMAGIC 0x4b56464dU
+#define KVSTORE_FRAMEHEAD  12
+#define KVSTORE_OPHEAD     9
+#define KVSTORE_OP_PUT     1
+#define KVSTORE_OP_DEL     2
+#define KVSTORE_MAXFRAME   ( 1UL << 31 ) // upper bound on the payload length of any single frame
+#define KVSTORE_MAXTXN     ( 1UL << 28 ) // upper bound on the serialized length of any single transaction
+
+#define KVSTORE_SNAPFRAME     ( 1UL << 20 )        // target payload length of each frame of a compacted log
+#define KVSTORE_COMPACT_MIN   ( (off_t)16 << 20 )  // never compact a log smaller than this
+#define KVSTORE_COMPACT_RATIO 2                    // compact once the log exceeds this multiple of live content
+#define KVSTORE_PENDING_INIT  ( 64UL << 10 )       // initial allocation of each pending batch buffer
+#define KVSTORE_SCANBUF       ( 64UL << 10 )       // read size used to verify the unwritten tail of a log
+
+#define KVSTORE_MAXLEVEL 24 // skiplist levels ( supports ~4^24 entries, at a branching factor of 4 )
+
+
+//   -------------    KVSTORE STRUCTURES    -------------
+
+typedef struct kvstore_entry_struct {
+   char*    data;   // key, immediately followed by value
+   size_t   keylen;
+   size_t   vallen;
+   int      level;  // number of skiplist levels including this entry
+   struct kvstore_entry_struct* next[]; // successor entry at each level
+} kvstore_entry;
+
+struct kvstore_struct {
+   // log state ( only modified while holding 'commitlock' w/ 'flushing' set, or while holding both locks )
+   int               dirfd;        // store directory
+   int               lockfd;       // lock file ( holding an exclusive flock() )
+   int               logfd;        // active log segment
+   uint64_t          loggen;       // generation number of the active log segment
+   off_t             logsize;      // current length of the active log segment
+   int               flags;        // kvstore_open() flags
+   // index state ( protected by 'lock' )
+   pthread_rwlock_t  lock;
+   kvstore_entry*    head;         // skiplist head entry ( no content )
+   int               level;        // current number of skiplist levels in use
+   uint64_t          randstate;    // skiplist level generator state
+   size_t            count;        // number of live entries
+   size_t            livebytes;    // serialized length of all live entries
+   // commit state ( protected by 'commitlock' )
+   pthread_mutex_t   commitlock;
+   pthread_cond_t    committed;    // signaled whenever a batch completes
+   char*             pending;      // serialized ops of the open batch, following a reserved frame header
+   size_t            pendinglen;
+   size_t            pendingalloc;
+   char*             spare;        // secondary batch buffer, swapped with 'pending' by each flush
+   size_t            sparealloc;
+   uint64_t          openbatch;    // ID of the batch accumulating in 'pending'
+   uint64_t          durablebatch; // ID of the most recently persisted batch
+   uint64_t          appliedbatch; // ID of the most recent batch with ops applied to the index
+   char              flushing;     // a thread is currently writing out a batch
+   off_t             compactsize;  // log size at which compaction should next be considered
+   int               failure;      // errno of a failed log write ( no further commits are allowed )
+};
+
+typedef struct kvtxn_op_struct {
+   char     op;
+   size_t   keylen;
+   size_t   vallen;
+   char*    data;   // key, immediately followed by value
+} kvtxn_op;
+
+struct kvtxn_struct {
+   KVSTORE     store;
+   char        write;
+   kvtxn_op*   ops;
+   size_t      opcount;
+   size_t      opalloc;
+};
+
+
+//   -------------    KVSTORE INTERNAL FUNCTIONS    -------------
+
+static uint32_t crctable[256];
+static pthread_once_t crconce = PTHREAD_ONCE_INIT;
+
+static void kvstore_crcinit( void ) {
+   uint32_t index = 0;
+   for ( ; index < 256; index++ ) {
+      uint32_t crc = index;
+      int bit = 0;
+      for ( ; bit < 8; bit++ ) {
+         crc = ( crc & 1 ) ? ( 0xEDB88320U ^ ( crc >> 1 ) ) : ( crc >> 1 );
+      }
+      crctable[index] = crc;
+   }
+}
+
+/**
+ * Calculate the CRC32 of the given buffer
+ * @param const void* buf : Buffer to checksum
+ * @param size_t len : Length of the buffer
+ * @return uint32_t : CRC32 value
+ */
+static uint32_t kvstore_crc( const void* buf, size_t len ) {
+   pthread_once( &(crconce), kvstore_crcinit );
+   const unsigned char* parse = (const unsigned char*)buf;
+   uint32_t crc = 0xFFFFFFFFU;
+   for ( ; len; len--, parse++ ) {
+      crc = crctable[ ( crc ^ *parse ) & 0xFF ] ^ ( crc >> 8 );
+   }
+   return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * Compare two keys
+ * @return int : Negative, zero, or positive, if key 'a' sorts before, equal to, or after key 'b'
+ */
+static int kvstore_keycmp( const char* a, size_t alen, const char* b, size_t blen ) {
+   int res = memcmp( a, b, ( alen < blen ) ? alen : blen );
+   if ( res ) { return res; }
+   return ( alen > blen ) - ( alen < blen );
+}
+
+/**
+ * Locate the first index entry with a key at or following the given key
+ * @param KVSTORE store : Store to search
+ * @param const void* key : Key to search for
+ * @param size_t keylen : Length of the key
+ * @param kvstore_entry** preds : Array of KVSTORE_MAXLEVEL references, to be populated with the last
+ *                                entry preceding the key at each level in use ( ignored if NULL )
+ * @return kvstore_entry* : Located entry, or NULL if no entry follows the key
+ */
+static kvstore_entry* kvstore_seek( KVSTORE store, const void* key, size_t keylen, kvstore_entry** preds ) {
+   kvstore_entry* cur = store->head;
+   int level = store->level - 1;
+   for ( ; level >= 0; level-- ) {
+      while ( cur->next[level]  &&
+              kvstore_keycmp( cur->next[level]->data, cur->next[level]->keylen, key, keylen ) < 0 ) {
+         cur = cur->next[level];
+      }
+      if ( preds ) { preds[level] = cur; }
+   }
+   return cur->next[0];
+}
+
+/**
+ * Apply the given op to the index of the given store
+ * NOTE -- caller must hold the store lock for writing
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_apply( KVSTORE store, char op, const char* key, size_t keylen, const char* value, size_t vallen ) {
+   kvstore_entry* preds[KVSTORE_MAXLEVEL];
+   kvstore_entry* entry = kvstore_seek( store, key, keylen, preds );
+   char match = ( entry  &&  kvstore_keycmp( entry->data, entry->keylen, key, keylen ) == 0 );
+   if ( op == KVSTORE_OP_DEL ) {
+      if ( !(match) ) { return 0; } // nothing to do
+      int level = 0;
+      for ( ; level < entry->level; level++ ) { preds[level]->next[level] = entry->next[level]; }
+      while ( store->level > 1  &&  store->head->next[store->level - 1] == NULL ) { store->level--; }
+      store->count--;
+      store->livebytes -= KVSTORE_OPHEAD + entry->keylen + entry->vallen;
+      free( entry->data );
+      free( entry );
+      return 0;
+   }
+   // produce a copy of the new content
+   char* data = malloc( keylen + vallen + 1 );
+   if ( data == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a %zu byte index entry\n", keylen + vallen );
+      return -1;
+   }
+   memcpy( data, key, keylen );
+   if ( vallen ) { memcpy( data + keylen, value, vallen ); }
+   if ( match ) {
+      // just replace the content of the existing entry
+      store->livebytes += vallen;
+      store->livebytes -= entry->vallen;
+      free( entry->data );
+      entry->data = data;
+      entry->vallen = vallen;
+      return 0;
+   }
+   // select a random height for the new entry
+   int newlevel = 1;
+   store->randstate ^= store->randstate << 13;
+   store->randstate ^= store->randstate >> 7;
+   store->randstate ^= store->randstate << 17;
+   uint64_t randval = store->randstate;
+   while ( newlevel < KVSTORE_MAXLEVEL  &&  ( randval & 3 ) == 0 ) { newlevel++; randval >>= 2; }
+   entry = malloc( sizeof( struct kvstore_entry_struct ) + ( sizeof(kvstore_entry*) * newlevel ) );
+   if ( entry == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new index entry\n" );
+      free( data );
+      return -1;
+   }
+   entry->data = data;
+   entry->keylen = keylen;
+   entry->vallen = vallen;
+   entry->level = newlevel;
+   for ( ; store->level < newlevel; store->level++ ) { preds[store->level] = store->head; }
+   int level = 0;
+   for ( ; level < newlevel; level++ ) {
+      entry->next[level] = preds[level]->next[level];
+      preds[level]->next[level] = entry;
+   }
+   store->count++;
+   store->livebytes += KVSTORE_OPHEAD + keylen + vallen;
+   return 0;
+}
+
+/**
+ * Write the entire given buffer to the given file offset
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_pwrite( int fd, const char* buf, size_t len, off_t offset ) {
+   while ( len ) {
+      ssize_t wres = pwrite( fd, buf, len, offset );
+      if ( wres < 0 ) {
+         if ( errno == EINTR ) { continue; }
+         return -1;
+      }
+      buf += wres;
+      len -= wres;
+      offset += wres;
+   }
+   return 0;
+}
+
+/**
+ * Read up to the given length from the given file offset
+ * @return ssize_t : Number of bytes read ( short only at EOF ), or -1 if a failure occurred
+ */
+static ssize_t kvstore_pread( int fd, char* buf, size_t len, off_t offset ) {
+   size_t total = 0;
+   while ( total < len ) {
+      ssize_t rres = pread( fd, buf + total, len - total, offset + total );
+      if ( rres < 0 ) {
+         if ( errno == EINTR ) { continue; }
+         return -1;
+      }
+      if ( rres == 0 ) { break; }
+      total += rres;
+   }
+   return (ssize_t)total;
+}
+
+/**
+ * Populate the header of the given frame and append it to the given log segment
+ * @param int fd : Log segment to write to
+ * @param off_t* offset : Reference to the current length of the segment, to be updated
+ * @param char* frame : Frame buffer, beginning with KVSTORE_FRAMEHEAD reserved bytes
+ * @param size_t framelen : Total length of the frame
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_writeframe( int fd, off_t* offset, char* frame, size_t framelen ) {
+   uint32_t head[3] = { KVSTORE_FRAMEMAGIC, (uint32_t)( framelen - KVSTORE_FRAMEHEAD ),
+                        kvstore_crc( frame + KVSTORE_FRAMEHEAD, framelen - KVSTORE_FRAMEHEAD ) };
+   memcpy( frame, head, KVSTORE_FRAMEHEAD );
+   if ( kvstore_pwrite( fd, frame, framelen, *offset ) ) {
+      LOG( LOG_ERR, "Failed to write a %zu byte log frame at offset %zd ( %s )\n",
+           framelen, *offset, strerror(errno) );
+      return -1;
+   }
+   *offset += framelen;
+   return 0;
+}
+
+/**
+ * Serialize a single op into the given buffer
+ * @return size_t : Length of the serialized op
+ */
+static size_t kvstore_packop( char* buf, char op, const char* key, size_t keylen, const char* value, size_t vallen ) {
+   uint32_t lens[2] = { (uint32_t)keylen, (uint32_t)vallen };
+   *buf = op;
+   memcpy( buf + 1, lens, sizeof(lens) );
+   memcpy( buf + KVSTORE_OPHEAD, key, keylen );
+   if ( vallen ) { memcpy( buf + KVSTORE_OPHEAD + keylen, value, vallen ); }
+   return KVSTORE_OPHEAD + keylen + vallen;
+}
+
+/**
+ * Produce the file name of the given log segment
+ */
+static void kvstore_segname( char* name, uint64_t gen, char tmp ) {
+   snprintf( name, KVSTORE_NAMELEN, KVSTORE_LOGPREFX"%016llx%s", (unsigned long long)gen,
+             ( tmp ) ? KVSTORE_TMPSUFFX : "" );
+}
+
+/**
+ * Create a new log segment, populated with a snapshot of the current index content
+ * NOTE -- caller must hold the store lock, and must ensure that no other thread is writing to the log
+ * @param KVSTORE store : Store to snapshot
+ * @param uint64_t gen : Generation number of the new segment
+ * @param off_t* size : Reference to be populated with the length of the new segment
+ * @return int : FD of the new segment ( synced and in place ), or -1 if a failure occurred
+ */
+static int kvstore_snapshot( KVSTORE store, uint64_t gen, off_t* size ) {
+   char tmpname[KVSTORE_NAMELEN];
+   char name[KVSTORE_NAMELEN];
+   kvstore_segname( tmpname, gen, 1 );
+   kvstore_segname( name, gen, 0 );
+   // the snapshot is written to a temporary name, so that it can only become visible once complete
+   int fd = openat( store->dirfd, tmpname, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR );
+   if ( fd < 0 ) {
+      LOG( LOG_ERR, "Failed to create new log segment: \"%s\" ( %s )\n", tmpname, strerror(errno) );
+      return -1;
+   }
+   size_t bufalloc = KVSTORE_FRAMEHEAD + KVSTORE_SNAPFRAME;
+   char* buf = malloc( bufalloc );
+   if ( buf == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a snapshot frame buffer\n" );
+      close( fd );
+      unlinkat( store->dirfd, tmpname, 0 );
+      return -1;
+   }
+   // write the segment header
+   off_t offset = 0;
+   uint64_t genval = gen;
+   memcpy( buf, KVSTORE_SEGMAGIC, 8 );
+   memcpy( buf + 8, &(genval), sizeof(uint64_t) );
+   int failure = kvstore_pwrite( fd, buf, KVSTORE_SEGHEAD, offset );
+   offset += KVSTORE_SEGHEAD;
+   // write every index entry, packed into frames
+   size_t buflen = KVSTORE_FRAMEHEAD;
+   kvstore_entry* entry = store->head->next[0];
+   for ( ; entry  &&  !(failure); entry = entry->next[0] ) {
+      size_t oplen = KVSTORE_OPHEAD + entry->keylen + entry->vallen;
+      if ( buflen > KVSTORE_FRAMEHEAD  &&  buflen + oplen > KVSTORE_FRAMEHEAD + KVSTORE_SNAPFRAME ) {
+         failure = kvstore_writeframe( fd, &(offset), buf, buflen );
+         buflen = KVSTORE_FRAMEHEAD;
+         if ( failure ) { break; }
+      }
+      if ( buflen + oplen > bufalloc ) {
+         // oversized entries simply occupy a frame of their own
+         char* newbuf = realloc( buf, buflen + oplen );
+         if ( newbuf == NULL ) {
+            LOG( LOG_ERR, "Failed to expand snapshot frame buffer to %zu bytes\n", buflen + oplen );
+            failure = -1;
+            break;
+         }
+         buf = newbuf;
+         bufalloc = buflen + oplen;
+      }
+      buflen += kvstore_packop( buf + buflen, KVSTORE_OP_PUT, entry->data, entry->keylen,
+                                entry->data + entry->keylen, entry->vallen );
+   }
+   if ( !(failure)  &&  buflen > KVSTORE_FRAMEHEAD ) {
+      failure = kvstore_writeframe( fd, &(offset), buf, buflen );
+   }
+   free( buf );
+   // the snapshot must be durable before it replaces any previous segment
+   if ( failure  ||  fdatasync( fd )  ||  renameat( store->dirfd, tmpname, store->dirfd, name ) ) {
+      LOG( LOG_ERR, "Failed to produce log segment: \"%s\" ( %s )\n", name, strerror(errno) );
+      close( fd );
+      unlinkat( store->dirfd, tmpname, 0 );
+      return -1;
+   }
+   if ( fsync( store->dirfd ) ) {
+      LOG( LOG_WARNING, "Failed to sync the store directory following creation of \"%s\"\n", name );
+   }
+   *size = offset;
+   return fd;
+}
+
+/**
+ * Replace the active log segment with a snapshot of the index, if the log has grown sufficiently
+ * @param KVSTORE store : Store to compact
+ * @param char force : If non-zero, compact regardless of the current log size
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_compactlog( KVSTORE store, char force ) {
+   // holding the store lock excludes all writers, while allowing readers to proceed
+   pthread_rwlock_rdlock( &(store->lock) );
+   pthread_mutex_lock( &(store->commitlock) );
+   while ( store->flushing ) { pthread_cond_wait( &(store->committed), &(store->commitlock) ); }
+   if ( store->failure ) {
+      pthread_mutex_unlock( &(store->commitlock) );
+      pthread_rwlock_unlock( &(store->lock) );
+      errno = store->failure;
+      return -1;
+   }
+   off_t target = KVSTORE_COMPACT_RATIO * (off_t)( KVSTORE_SEGHEAD + store->livebytes );
+   if ( target < KVSTORE_COMPACT_MIN ) { target = KVSTORE_COMPACT_MIN; }
+   if ( !(force)  &&  store->logsize <= target ) {
+      // the log consists primarily of live content, so don't bother
+      store->compactsize = target;
+      pthread_mutex_unlock( &(store->commitlock) );
+      pthread_rwlock_unlock( &(store->lock) );
+      return 0;
+   }
+   off_t newsize = 0;
+   int newfd = kvstore_snapshot( store, store->loggen + 1, &(newsize) );
+   if ( newfd < 0 ) {
+      // back off, rather than reattempting with every commit
+      store->compactsize = KVSTORE_COMPACT_RATIO * store->logsize;
+      pthread_mutex_unlock( &(store->commitlock) );
+      pthread_rwlock_unlock( &(store->lock) );
+      return -1;
+   }
+   LOG( LOG_INFO, "Compacted %zd byte log generation %llu to %zd bytes\n", store->logsize,
+        (unsigned long long)store->loggen, newsize );
+   char oldname[KVSTORE_NAMELEN];
+   kvstore_segname( oldname, store->loggen, 0 );
+   close( store->logfd );
+   if ( unlinkat( store->dirfd, oldname, 0 ) ) {
+      // this will be cleaned up by the next open
+      LOG( LOG_WARNING, "Failed to unlink superseded log segment: \"%s\"\n", oldname );
+   }
+   store->logfd = newfd;
+   store->loggen++;
+   store->logsize = newsize;
+   // the snapshot already includes the content of any pending ops
+   if ( store->pendinglen > KVSTORE_FRAMEHEAD ) {
+      store->pendinglen = KVSTORE_FRAMEHEAD;
+      store->durablebatch = store->openbatch;
+      store->openbatch++;
+      pthread_cond_broadcast( &(store->committed) );
+   }
+   store->compactsize = KVSTORE_COMPACT_RATIO * newsize;
+   if ( store->compactsize < KVSTORE_COMPACT_MIN ) { store->compactsize = KVSTORE_COMPACT_MIN; }
+   pthread_mutex_unlock( &(store->commitlock) );
+   pthread_rwlock_unlock( &(store->lock) );
+   return 0;
+}
+
+/**
+ * Persist the pending batch ( or wait for another thread to do so ), until the given batch is durable
+ * @param KVSTORE store : Store to operate on
+ * @param uint64_t batch : ID of the batch which must be made durable
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_sync( KVSTORE store, uint64_t batch ) {
+   pthread_mutex_lock( &(store->commitlock) );
+   char compact = 0;
+   while ( store->durablebatch < batch  &&  store->failure == 0 ) {
+      if ( store->flushing ) {
+         // another thread is already writing, and will wake us once done
+         pthread_cond_wait( &(store->committed), &(store->commitlock) );
+         continue;
+      }
+      // take ownership of the open batch, leaving an empty buffer for subsequent commits
+      store->flushing = 1;
+      uint64_t flushbatch = store->openbatch;
+      store->openbatch++;
+      char* frame = store->pending;
+      size_t framelen = store->pendinglen;
+      size_t framealloc = store->pendingalloc;
+      store->pending = store->spare;
+      store->pendingalloc = store->sparealloc;
+      store->pendinglen = KVSTORE_FRAMEHEAD;
+      store->spare = NULL;
+      store->sparealloc = 0;
+      pthread_mutex_unlock( &(store->commitlock) );
+
+      // write and sync the frame, while other commits accumulate into the next batch
+      off_t origsize = store->logsize;
+      int failure = 0;
+      if ( kvstore_writeframe( store->logfd, &(store->logsize), frame, framelen ) ) {
+         failure = errno;
+         // strip any partial frame, though replay would discard it regardless
+         if ( ftruncate( store->logfd, origsize ) ) {
+            LOG( LOG_WARNING, "Failed to truncate partial frame from the log\n" );
+         }
+      }
+      else if ( !(store->flags & KVSTORE_NOSYNC)  &&  fdatasync( store->logfd ) ) {
+         LOG( LOG_ERR, "Failed to sync the log ( %s )\n", strerror(errno) );
+         failure = errno;
+      }
+      LOG( LOG_INFO, "Wrote batch %llu as a %zu byte frame\n", (unsigned long long)flushbatch, framelen );
+
+      pthread_mutex_lock( &(store->commitlock) );
+      store->spare = frame;
+      store->sparealloc = framealloc;
+      if ( failure ) {
+         LOG( LOG_ERR, "Rejecting all further commits, due to log write failure\n" );
+         store->failure = failure;
+      }
+      else {
+         store->durablebatch = flushbatch;
+         if ( store->logsize > store->compactsize ) { compact = 1; }
+      }
+      store->flushing = 0;
+      pthread_cond_broadcast( &(store->committed) );
+   }
+   int failure = ( store->durablebatch < batch ) ? store->failure : 0;
+   pthread_mutex_unlock( &(store->commitlock) );
+   if ( failure ) {
+      errno = failure;
+      return -1;
+   }
+   // our batch is durable, regardless of any compaction result
+   if ( compact  &&  kvstore_compactlog( store, 0 ) ) {
+      LOG( LOG_WARNING, "Failed to compact the store log\n" );
+   }
+   return 0;
+}
+
+/**
+ * Wait for every op already applied to the index to become durable
+ * NOTE -- caller must hold the store lock, such that no further ops can be applied; the pending
+ *         batch will be persisted by its own committers, which hold no lock while doing so
+ * @param KVSTORE store : Store to operate on
+ * @return int : Zero on success, or -1 if the applied content can never become durable
+ */
+static int kvstore_waitdurable( KVSTORE store ) {
+   pthread_mutex_lock( &(store->commitlock) );
+   while ( store->durablebatch < store->appliedbatch  &&  store->failure == 0 ) {
+      pthread_cond_wait( &(store->committed), &(store->commitlock) );
+   }
+   int failure = ( store->durablebatch < store->appliedbatch ) ? store->failure : 0;
+   pthread_mutex_unlock( &(store->commitlock) );
+   if ( failure ) {
+      errno = failure;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Read and validate the frame at the given log offset
+ * @param int fd : Log segment to read from
+ * @param off_t offset : Offset of the frame
+ * @param off_t logend : Length of the log segment
+ * @param char** payload : Reference to a frame buffer, to be expanded as necessary
+ * @param size_t* payloadalloc : Reference to the allocated length of that buffer
+ * @param size_t* payloadlen : Reference to be populated with the payload length of the frame
+ * @return int : 1 if a complete and valid frame was read, 0 if the frame is incomplete or corrupt,
+ *               or -1 if a failure occurred
+ */
+static int kvstore_readframe( int fd, off_t offset, off_t logend, char** payload, size_t* payloadalloc, size_t* payloadlen ) {
+   uint32_t head[3];
+   if ( logend - offset < KVSTORE_FRAMEHEAD ) { return 0; }
+   ssize_t rres = kvstore_pread( fd, (char*)head, KVSTORE_FRAMEHEAD, offset );
+   if ( rres < 0 ) {
+      LOG( LOG_ERR, "Failed to read frame header at log offset %zd\n", offset );
+      return -1;
+   }
+   if ( rres < KVSTORE_FRAMEHEAD  ||  head[0] != KVSTORE_FRAMEMAGIC  ||  head[1] > KVSTORE_MAXFRAME  ||
+        (off_t)head[1] > logend - offset - KVSTORE_FRAMEHEAD ) {
+      return 0;
+   }
+   size_t framelen = head[1];
+   if ( framelen > *payloadalloc ) {
+      char* newpayload = realloc( *payload, framelen );
+      if ( newpayload == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a %zu byte frame buffer\n", framelen );
+         return -1;
+      }
+      *payload = newpayload;
+      *payloadalloc = framelen;
+   }
+   rres = kvstore_pread( fd, *payload, framelen, offset + KVSTORE_FRAMEHEAD );
+   if ( rres < 0 ) {
+      LOG( LOG_ERR, "Failed to read frame payload at log offset %zd\n", offset );
+      return -1;
+   }
+   if ( (size_t)rres < framelen  ||  kvstore_crc( *payload, framelen ) != head[2] ) { return 0; }
+   // verify the structure of every op, before any of them are applied
+   size_t parse = 0;
+   while ( parse + KVSTORE_OPHEAD <= framelen ) {
+      uint32_t lens[2];
+      memcpy( lens, *payload + parse + 1, sizeof(lens) );
+      char op = (*payload)[parse];
+      if ( ( op != KVSTORE_OP_PUT  &&  op != KVSTORE_OP_DEL )  ||  lens[0] == 0  ||
+           (size_t)lens[0] + lens[1] > framelen - parse - KVSTORE_OPHEAD ) {
+         break;
+      }
+      parse += KVSTORE_OPHEAD + lens[0] + lens[1];
+   }
+   if ( parse != framelen ) {
+      LOG( LOG_ERR, "Encountered a malformed frame at log offset %zd\n", offset );
+      return 0;
+   }
+   *payloadlen = framelen;
+   return 1;
+}
+
+/**
+ * Determine if the invalid frame at the given log offset is the tail of an interrupted append
+ * NOTE -- Such a frame either extends to the end of the log, or is followed only by zero bytes
+ *         ( as in an extent which was allocated, but never written ).
+ * @param int fd : Log segment to check
+ * @param off_t offset : Offset of the invalid frame
+ * @param off_t logend : Length of the log segment
+ * @return int : 1 if the frame is a torn tail, 0 if other content follows it, or -1 if a failure occurred
+ */
+static int kvstore_torntail( int fd, off_t offset, off_t logend ) {
+   if ( logend - offset < KVSTORE_FRAMEHEAD ) { return 1; }
+   uint32_t head[3];
+   if ( kvstore_pread( fd, (char*)head, KVSTORE_FRAMEHEAD, offset ) != KVSTORE_FRAMEHEAD ) {
+      LOG( LOG_ERR, "Failed to read frame header at log offset %zd\n", offset );
+      return -1;
+   }
+   if ( head[0] == KVSTORE_FRAMEMAGIC ) {
+      return ( (off_t)head[1] >= logend - offset - KVSTORE_FRAMEHEAD ) ? 1 : 0;
+   }
+   char* scanbuf = malloc( KVSTORE_SCANBUF );
+   if ( scanbuf == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a %lu byte log scan buffer\n", KVSTORE_SCANBUF );
+      return -1;
+   }
+   while ( offset < logend ) {
+      ssize_t rres = kvstore_pread( fd, scanbuf, KVSTORE_SCANBUF, offset );
+      if ( rres <= 0 ) {
+         LOG( LOG_ERR, "Failed to read the log at offset %zd\n", offset );
+         free( scanbuf );
+         return -1;
+      }
+      ssize_t index = 0;
+      for ( ; index < rres; index++ ) {
+         if ( scanbuf[index] ) { free( scanbuf ); return 0; }
+      }
+      offset += rres;
+   }
+   free( scanbuf );
+   return 1;
+}
+
+/**
+ * Replay all complete frames of the given log segment into the index
+ * NOTE -- A torn frame at the tail of the log is truncated.  Any other invalid frame indicates
+ *         corruption of committed content, which must be repaired before the store can be used.
+ * @param KVSTORE store : Store to populate
+ * @param int fd : Log segment to replay
+ * @param off_t* size : Reference to be populated with the resulting length of the segment
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_replay( KVSTORE store, int fd, off_t* size ) {
+   struct stat stval;
+   if ( fstat( fd, &(stval) ) ) {
+      LOG( LOG_ERR, "Failed to stat the log segment\n" );
+      return -1;
+   }
+   off_t logend = stval.st_size;
+   off_t offset = KVSTORE_SEGHEAD;
+   char* payload = NULL;
+   size_t payloadalloc = 0;
+   size_t frames = 0;
+   while ( offset < logend ) {
+      size_t payloadlen = 0;
+      int fres = kvstore_readframe( fd, offset, logend, &(payload), &(payloadalloc), &(payloadlen) );
+      if ( fres < 0 ) {
+         free( payload );
+         return -1;
+      }
+      if ( fres == 0 ) {
+         int tres = kvstore_torntail( fd, offset, logend );
+         if ( tres < 0 ) {
+            free( payload );
+            return -1;
+         }
+         if ( tres == 0 ) {
+            // later batches may depend upon this one, so none of them can be safely applied
+            LOG( LOG_ERR, "Log segment is corrupt at offset %zd, and requires repair\n", offset );
+            free( payload );
+            errno = EIO;
+            return -1;
+         }
+         // only an interrupted write could have produced this, so the content was never committed
+         LOG( LOG_WARNING, "Discarding incomplete log content, following offset %zd\n", offset );
+         if ( ftruncate( fd, offset )  ||  fdatasync( fd ) ) {
+            LOG( LOG_ERR, "Failed to truncate incomplete content from the log\n" );
+            free( payload );
+            return -1;
+         }
+         break;
+      }
+      size_t parse = 0;
+      while ( parse < payloadlen ) {
+         uint32_t lens[2];
+         memcpy( lens, payload + parse + 1, sizeof(lens) );
+         const char* key = payload + parse + KVSTORE_OPHEAD;
+         if ( kvstore_apply( store, payload[parse], key, lens[0], key + lens[0], lens[1] ) ) {
+            LOG( LOG_ERR, "Failed to apply op of frame at log offset %zd\n", offset );
+            free( payload );
+            errno = ENOMEM;
+            return -1;
+         }
+         parse += KVSTORE_OPHEAD + lens[0] + lens[1];
+      }
+      offset += KVSTORE_FRAMEHEAD + payloadlen;
+      frames++;
+   }
+   free( payload );
+   LOG( LOG_INFO, "Replayed %zu frames, producing %zu entries\n", frames, store->count );
+   *size = offset;
+   return 0;
+}
+
+/**
+ * Locate and replay the most recent log segment of the given store, or create an initial segment
+ * @param KVSTORE store : Store to recover
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_recover( KVSTORE store ) {
+   int scanfd = dup( store->dirfd );
+   DIR* dirp = ( scanfd < 0 ) ? NULL : fdopendir( scanfd );
+   if ( dirp == NULL ) {
+      LOG( LOG_ERR, "Failed to open a scanner for the store directory\n" );
+      if ( scanfd >= 0 ) { close( scanfd ); }
+      return -1;
+   }
+   // identify the most recent segment
+   uint64_t maxgen = 0;
+   struct dirent* dent;
+   while ( (dent = readdir( dirp )) != NULL ) {
+      if ( strncmp( dent->d_name, KVSTORE_LOGPREFX, strlen(KVSTORE_LOGPREFX) ) ) { continue; }
+      char* end = NULL;
+      unsigned long long gen = strtoull( dent->d_name + strlen(KVSTORE_LOGPREFX), &(end), 16 );
+      if ( *end == '\0'  &&  gen > maxgen ) { maxgen = gen; }
+   }
+   // remove any superseded segments or incomplete snapshots
+   rewinddir( dirp );
+   while ( (dent = readdir( dirp )) != NULL ) {
+      if ( strncmp( dent->d_name, KVSTORE_LOGPREFX, strlen(KVSTORE_LOGPREFX) ) ) { continue; }
+      char* end = NULL;
+      unsigned long long gen = strtoull( dent->d_name + strlen(KVSTORE_LOGPREFX), &(end), 16 );
+      if ( *end == '\0'  &&  gen == maxgen ) { continue; }
+      if ( *end == '\0'  ||  strcmp( end, KVSTORE_TMPSUFFX ) == 0 ) {
+         LOG( LOG_INFO, "Removing stale log segment: \"%s\"\n", dent->d_name );
+         if ( unlinkat( store->dirfd, dent->d_name, 0 ) ) {
+            LOG( LOG_WARNING, "Failed to remove stale log segment: \"%s\"\n", dent->d_name );
+         }
+      }
+   }
+   closedir( dirp );
+   if ( maxgen == 0 ) {
+      // this is a new store
+      LOG( LOG_INFO, "Initializing new store\n" );
+      store->logfd = kvstore_snapshot( store, 1, &(store->logsize) );
+      if ( store->logfd < 0 ) { return -1; }
+      store->loggen = 1;
+      return 0;
+   }
+   char name[KVSTORE_NAMELEN];
+   kvstore_segname( name, maxgen, 0 );
+   store->logfd = openat( store->dirfd, name, O_RDWR );
+   if ( store->logfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open log segment: \"%s\"\n", name );
+      return -1;
+   }
+   store->loggen = maxgen;
+   // verify the segment header
+   char head[KVSTORE_SEGHEAD];
+   uint64_t gen = 0;
+   if ( kvstore_pread( store->logfd, head, KVSTORE_SEGHEAD, 0 ) == KVSTORE_SEGHEAD ) {
+      memcpy( &(gen), head + 8, sizeof(uint64_t) );
+   }
+   if ( gen != maxgen  ||  memcmp( head, KVSTORE_SEGMAGIC, 8 ) ) {
+      LOG( LOG_ERR, "Log segment \"%s\" has an invalid header\n", name );
+      errno = EIO;
+      return -1;
+   }
+   return kvstore_replay( store, store->logfd, &(store->logsize) );
+}
+
+/**
+ * Free all state associated with the given store
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvstore_free( KVSTORE store ) {
+   int retval = 0;
+   if ( store->logfd >= 0  &&  close( store->logfd ) ) {
+      LOG( LOG_WARNING, "Failed to close the log segment\n" );
+      retval = -1;
+   }
+   if ( store->lockfd >= 0 ) { close( store->lockfd ); } // releases our flock()
+   if ( store->dirfd >= 0 ) { close( store->dirfd ); }
+   if ( store->head ) {
+      kvstore_entry* entry = store->head->next[0];
+      while ( entry ) {
+         kvstore_entry* next = entry->next[0];
+         free( entry->data );
+         free( entry );
+         entry = next;
+      }
+      free( store->head );
+   }
+   free( store->pending );
+   free( store->spare );
+   pthread_cond_destroy( &(store->committed) );
+   pthread_mutex_destroy( &(store->commitlock) );
+   pthread_rwlock_destroy( &(store->lock) );
+   free( store );
+   return retval;
+}
+
+/**
+ * Stage the given op within the given transaction
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int kvtxn_stage( KVTXN txn, char op, const void* key, size_t keylen, const void* value, size_t vallen ) {
+   if ( txn == NULL  ||  key == NULL  ||  keylen == 0  ||  ( value == NULL  &&  vallen ) ) {
+      LOG( LOG_ERR, "Received a NULL transaction, key, or value reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( !(txn->write) ) {
+      LOG( LOG_ERR, "Cannot modify the store via a read transaction\n" );
+      errno = EPERM;
+      return -1;
+   }
+   if ( keylen > UINT32_MAX  ||  vallen > KVSTORE_MAXTXN ) {
+      LOG( LOG_ERR, "Received an oversized key or value ( %zu / %zu bytes )\n", keylen, vallen );
+      errno = E2BIG;
+      return -1;
+   }
+   if ( txn->opcount == txn->opalloc ) {
+      size_t newalloc = ( txn->opalloc ) ? txn->opalloc * 2 : 8;
+      kvtxn_op* newops = realloc( txn->ops, sizeof(kvtxn_op) * newalloc );
+      if ( newops == NULL ) {
+         LOG( LOG_ERR, "Failed to expand transaction op list to %zu entries\n", newalloc );
+         return -1;
+      }
+      txn->ops = newops;
+      txn->opalloc = newalloc;
+   }
+   kvtxn_op* newop = txn->ops + txn->opcount;
+   newop->data = malloc( keylen + vallen + 1 );
+   if ( newop->data == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a %zu byte transaction op\n", keylen + vallen );
+      return -1;
+   }
+   memcpy( newop->data, key, keylen );
+   if ( vallen ) { memcpy( newop->data + keylen, value, vallen ); }
+   newop->op = op;
+   newop->keylen = keylen;
+   newop->vallen = vallen;
+   txn->opcount++;
+   return 0;
+}
+
+/**
+ * Release the store lock held by the given transaction, and free it
+ */
+static void kvtxn_free( KVTXN txn ) {
+   pthread_rwlock_unlock( &(txn->store->lock) );
+   size_t index = 0;
+   for ( ; index < txn->opcount; index++ ) { free( txn->ops[index].data ); }
+   free( txn->ops );
+   free( txn );
+}
+
+
+//   -------------    KVSTORE PUBLIC FUNCTIONS    -------------
+
+/**
+ * Open the store located beneath the given directory, creating it if necessary
+ * @param const char* path : Path of the store directory
+ * @param int flags : Zero, or KVSTORE_NOSYNC
+ * @return KVSTORE : Reference to the opened store, or NULL if a failure occurred
+ *                   NOTE -- errno=EWOULDBLOCK indicates that the store is in use by another process
+ *                           errno=EIO indicates that the store log is corrupt, and requires repair
+ */
+KVSTORE kvstore_open( const char* path, int flags ) {
+   // check for NULL path
+   if ( path == NULL ) {
+      LOG( LOG_ERR, "Received a NULL store path\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KVSTORE store = calloc( 1, sizeof( struct kvstore_struct ) );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new store structure\n" );
+      return NULL;
+   }
+   store->dirfd = -1;
+   store->lockfd = -1;
+   store->logfd = -1;
+   store->flags = flags;
+   pthread_rwlock_init( &(store->lock), NULL );
+   pthread_mutex_init( &(store->commitlock), NULL );
+   pthread_cond_init( &(store->committed), NULL );
+   store->level = 1;
+   store->randstate = ( (uint64_t)time( NULL ) << 20 ) ^ (uint64_t)(uintptr_t)store ^ (uint64_t)getpid();
+   if ( store->randstate == 0 ) { store->randstate = 1; }
+   store->head = calloc( 1, sizeof( struct kvstore_entry_struct ) + ( sizeof(kvstore_entry*) * KVSTORE_MAXLEVEL ) );
+   store->pending = malloc( KVSTORE_PENDING_INIT );
+   store->spare = malloc( KVSTORE_PENDING_INIT );
+   if ( store->head == NULL  ||  store->pending == NULL  ||  store->spare == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate store index and batch buffers\n" );
+      kvstore_free( store );
+      return NULL;
+   }
+   store->head->level = KVSTORE_MAXLEVEL;
+   store->pendingalloc = KVSTORE_PENDING_INIT;
+   store->sparealloc = KVSTORE_PENDING_INIT;
+   store->pendinglen = KVSTORE_FRAMEHEAD;
+   store->openbatch = 1;
+   store->compactsize = KVSTORE_COMPACT_MIN;
+
+   // open the store directory, creating it if missing
+   errno = 0;
+   if ( mkdir( path, S_IRWXU )  &&  errno != EEXIST ) {
+      LOG( LOG_ERR, "Failed to create store directory: \"%s\" ( %s )\n", path, strerror(errno) );
+      kvstore_free( store );
+      return NULL;
+   }
+   store->dirfd = open( path, O_RDONLY | O_DIRECTORY );
+   if ( store->dirfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open store directory: \"%s\" ( %s )\n", path, strerror(errno) );
+      kvstore_free( store );
+      return NULL;
+   }
+   // exclude any other process from the store
+   store->lockfd = openat( store->dirfd, KVSTORE_LOCKFILE, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR );
+   if ( store->lockfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open the lock file of store: \"%s\" ( %s )\n", path, strerror(errno) );
+      kvstore_free( store );
+      return NULL;
+   }
+   if ( flock( store->lockfd, LOCK_EX | LOCK_NB ) ) {
+      int olderrno = errno;
+      LOG( LOG_ERR, "Failed to lock store \"%s\" ( %s )\n", path,
+           ( errno == EWOULDBLOCK ) ? "in use by another process" : strerror(errno) );
+      kvstore_free( store );
+      errno = olderrno;
+      return NULL;
+   }
+   // reconstruct the index
+   if ( kvstore_recover( store ) ) {
+      int olderrno = errno;
+      LOG( LOG_ERR, "Failed to recover the content of store: \"%s\"\n", path );
+      kvstore_free( store );
+      errno = olderrno;
+      return NULL;
+   }
+   LOG( LOG_INFO, "Opened store \"%s\" with %zu entries ( log generation %llu is %zd bytes )\n", path,
+        store->count, (unsigned long long)store->loggen, store->logsize );
+   return store;
+}
+
+/**
+ * Close the given store
+ * NOTE -- The caller must ensure that no transactions remain active against the store.
+ * @param KVSTORE store : Store to be closed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_close( KVSTORE store ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL store reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvstore_free( store );
+}
+
+/**
+ * Replace the log of the given store with a compacted snapshot of its current content
+ * NOTE -- This occurs automatically as the log grows, and is not required for correctness.
+ * @param KVSTORE store : Store to be compacted
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_compact( KVSTORE store ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL store reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   return kvstore_compactlog( store, 1 );
+}
+
+/**
+ * Begin a new transaction against the given store
+ * NOTE -- A write transaction excludes all other transactions until committed or aborted, while
+ *         any number of read transactions may proceed concurrently.  A thread must not begin a
+ *         transaction while it has another active against the same store.
+ *         A read transaction only begins once all previously committed content is durable.
+ * @param KVSTORE store : Store to operate on
+ * @param char write : If non-zero, the transaction may modify the store
+ * @return KVTXN : Reference to the new transaction, or NULL if a failure occurred
+ */
+KVTXN kvstore_begin( KVSTORE store, char write ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL store reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KVTXN txn = calloc( 1, sizeof( struct kvtxn_struct ) );
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new transaction\n" );
+      return NULL;
+   }
+   txn->store = store;
+   txn->write = write;
+   if ( write ) { pthread_rwlock_wrlock( &(store->lock) ); }
+   else {
+      pthread_rwlock_rdlock( &(store->lock) );
+      // never expose content which may yet be lost to a log write failure
+      if ( kvstore_waitdurable( store ) ) {
+         LOG( LOG_ERR, "Store content was lost to a previous log write failure\n" );
+         int failure = errno;
+         kvtxn_free( txn );
+         errno = failure;
+         return NULL;
+      }
+   }
+   return txn;
+}
+
+/**
+ * Retrieve the value of the given key
+ * NOTE -- The returned reference remains valid until the transaction is committed or aborted.
+ * @param KVTXN txn : Transaction to operate within
+ * @param const void* key : Key to retrieve the value of
+ * @param size_t keylen : Length of the key
+ * @param size_t* vallen : Reference to be populated with the length of the value
+ * @return const void* : Reference to the value, or NULL w/ errno=ENOENT if the key does not exist
+ */
+const void* kvtxn_get( KVTXN txn, const void* key, size_t keylen, size_t* vallen ) {
+   // check for NULL args
+   if ( txn == NULL  ||  key == NULL  ||  vallen == NULL ) {
+      LOG( LOG_ERR, "Received a NULL transaction, key, or length reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // the most recent op of this transaction takes precedence
+   size_t index = txn->opcount;
+   while ( index ) {
+      index--;
+      kvtxn_op* op = txn->ops + index;
+      if ( kvstore_keycmp( op->data, op->keylen, key, keylen ) == 0 ) {
+         if ( op->op == KVSTORE_OP_DEL ) {
+            errno = ENOENT;
+            return NULL;
+         }
+         *vallen = op->vallen;
+         return op->data + op->keylen;
+      }
+   }
+   kvstore_entry* entry = kvstore_seek( txn->store, key, keylen, NULL );
+   if ( entry == NULL  ||  kvstore_keycmp( entry->data, entry->keylen, key, keylen ) ) {
+      errno = ENOENT;
+      return NULL;
+   }
+   *vallen = entry->vallen;
+   return entry->data + entry->keylen;
+}
+
+/**
+ * Locate the first key following the given key
+ * NOTE -- Keys are ordered bytewise, with any key sorting after each of its prefixes.
+ *         The search only includes content committed prior to the transaction, and not any
+ *         modifications already made by the transaction itself.
+ *         The produced references remain valid until the transaction is committed or aborted.
+ * @param KVTXN txn : Transaction to operate within
+ * @param const void* key : Key to search from ( may be NULL, if keylen is zero )
+ * @param size_t keylen : Length of the key
+ * @param char inclusive : If non-zero, the given key itself may be produced
+ * @param const void** nextkey : Reference to be populated with the located key
+ * @param size_t* nextkeylen : Reference to be populated with the length of the located key
+ * @param const void** value : Reference to be populated with the value of the located key
+ * @param size_t* vallen : Reference to be populated with the length of that value
+ * @return int : 1 if a key was located, 0 if no keys follow the given key, or -1 on failure
+ */
+int kvtxn_next( KVTXN txn, const void* key, size_t keylen, char inclusive,
+                const void** nextkey, size_t* nextkeylen, const void** value, size_t* vallen ) {
+   // check for NULL args
+   if ( txn == NULL  ||  ( key == NULL  &&  keylen )  ||  nextkey == NULL  ||  nextkeylen == NULL  ||
+        value == NULL  ||  vallen == NULL ) {
+      LOG( LOG_ERR, "Received a NULL transaction, key, or output reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   kvstore_entry* entry = txn->store->head->next[0];
+   if ( keylen ) {
+      entry = kvstore_seek( txn->store, key, keylen, NULL );
+      if ( entry  &&  !(inclusive)  &&  kvstore_keycmp( entry->data, entry->keylen, key, keylen ) == 0 ) {
+         entry = entry->next[0];
+      }
+   }
+   if ( entry == NULL ) { return 0; }
+   *nextkey = entry->data;
+   *nextkeylen = entry->keylen;
+   *value = entry->data + entry->keylen;
+   *vallen = entry->vallen;
+   return 1;
+}
+
+/**
+ * Set the value of the given key
+ * @param KVTXN txn : Write transaction to operate within
+ * @param const void* key : Key to set the value of
+ * @param size_t keylen : Length of the key ( must be non-zero )
+ * @param const void* value : New value of the key ( may be NULL, if vallen is zero )
+ * @param size_t vallen : Length of the value
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_put( KVTXN txn, const void* key, size_t keylen, const void* value, size_t vallen ) {
+   return kvtxn_stage( txn, KVSTORE_OP_PUT, key, keylen, value, vallen );
+}
+
+/**
+ * Delete the given key ( no error is produced if the key does not exist )
+ * @param KVTXN txn : Write transaction to operate within
+ * @param const void* key : Key to be deleted
+ * @param size_t keylen : Length of the key
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_delete( KVTXN txn, const void* key, size_t keylen ) {
+   return kvtxn_stage( txn, KVSTORE_OP_DEL, key, keylen, NULL, 0 );
+}
+
+/**
+ * Commit and end the given transaction
+ * NOTE -- For a write transaction, this function will not return until all modifications ( and
+ *         all content observed by the transaction ) have been persisted to the store log.
+ *         Regardless of the result, the transaction reference is freed by this call.
+ * @param KVTXN txn : Transaction to be committed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_commit( KVTXN txn ) {
+   // check for NULL txn
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Received a NULL transaction reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVSTORE store = txn->store;
+   if ( !(txn->write) ) {
+      kvtxn_free( txn );
+      return 0;
+   }
+   if ( txn->opcount == 0 ) {
+      // our outcome may still depend upon content which is not yet durable
+      uint64_t observed = store->appliedbatch; // stable, as we hold the store lock exclusively
+      kvtxn_free( txn );
+      return kvstore_sync( store, observed );
+   }
+   size_t txnlen = 0;
+   size_t index = 0;
+   for ( ; index < txn->opcount; index++ ) {
+      txnlen += KVSTORE_OPHEAD + txn->ops[index].keylen + txn->ops[index].vallen;
+   }
+   if ( txnlen > KVSTORE_MAXTXN ) {
+      LOG( LOG_ERR, "Transaction length of %zu bytes exceeds the limit of %lu bytes\n", txnlen, KVSTORE_MAXTXN );
+      kvtxn_free( txn );
+      errno = E2BIG;
+      return -1;
+   }
+   // append all ops to the open batch ( log order will match the order in which ops are applied )
+   pthread_mutex_lock( &(store->commitlock) );
+   while ( store->pendinglen + txnlen > KVSTORE_FRAMEHEAD + KVSTORE_MAXFRAME  &&  store->failure == 0 ) {
+      // the open batch is full, so wait for its own committers to flush it
+      pthread_cond_wait( &(store->committed), &(store->commitlock) );
+   }
+   if ( store->failure ) {
+      int failure = store->failure;
+      pthread_mutex_unlock( &(store->commitlock) );
+      LOG( LOG_ERR, "Store rejects all commits, following a previous log write failure\n" );
+      kvtxn_free( txn );
+      errno = failure;
+      return -1;
+   }
+   if ( store->pendinglen + txnlen > store->pendingalloc ) {
+      size_t newalloc = store->pendingalloc * 2;
+      if ( newalloc < store->pendinglen + txnlen ) { newalloc = store->pendinglen + txnlen; }
+      char* newpending = realloc( store->pending, newalloc );
+      if ( newpending == NULL ) {
+         pthread_mutex_unlock( &(store->commitlock) );
+         LOG( LOG_ERR, "Failed to expand the pending batch buffer to %zu bytes\n", newalloc );
+         kvtxn_free( txn );
+         errno = ENOMEM;
+         return -1;
+      }
+      store->pending = newpending;
+      store->pendingalloc = newalloc;
+   }
+   for ( index = 0; index < txn->opcount; index++ ) {
+      kvtxn_op* op = txn->ops + index;
+      store->pendinglen += kvstore_packop( store->pending + store->pendinglen, op->op, op->data, op->keylen,
+                                           op->data + op->keylen, op->vallen );
+   }
+   uint64_t batch = store->openbatch;
+   store->appliedbatch = batch; // readers will now wait for this batch to persist
+   pthread_mutex_unlock( &(store->commitlock) );
+   // apply all ops to the index
+   for ( index = 0; index < txn->opcount; index++ ) {
+      kvtxn_op* op = txn->ops + index;
+      if ( kvstore_apply( store, op->op, op->data, op->keylen, op->data + op->keylen, op->vallen ) ) {
+         // the index no longer reflects the log, so the store cannot accept any further commits
+         LOG( LOG_ERR, "Failed to apply a committed op to the index\n" );
+         pthread_mutex_lock( &(store->commitlock) );
+         store->failure = ENOMEM;
+         pthread_cond_broadcast( &(store->committed) );
+         pthread_mutex_unlock( &(store->commitlock) );
+         kvtxn_free( txn );
+         errno = ENOMEM;
+         return -1;
+      }
+   }
+   // release the store to other transactions, while we wait for our batch to persist
+   kvtxn_free( txn );
+   return kvstore_sync( store, batch );
+}
+
+/**
+ * Abort and end the given transaction, discarding all modifications
+ * NOTE -- For a write transaction, this function will not return until all content observed by
+ *         the transaction has been persisted to the store log, as that content may have
+ *         determined the decision to abort.
+ *         Regardless of the result, the transaction reference is freed by this call.
+ * @param KVTXN txn : Transaction to be aborted
+ * @return int : Zero on success, or -1 if observed content could not be persisted
+ */
+int kvtxn_abort( KVTXN txn ) {
+   // check for NULL txn
+   if ( txn == NULL ) {
+      LOG( LOG_ERR, "Received a NULL transaction reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   KVSTORE store = txn->store;
+   if ( !(txn->write) ) {
+      kvtxn_free( txn );
+      return 0;
+   }
+   uint64_t observed = store->appliedbatch; // stable, as we hold the store lock exclusively
+   kvtxn_free( txn );
+   return kvstore_sync( store, observed );
+}
+
@@ -0,0 +1,159 @@
+#ifndef _KVSTORE_H
+#define _KVSTORE_H
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+/**
+ * Embedded, log-structured key-value store
+ *
+ * All content of a store is held in memory, as an ordered index of byte-string keys.  Every
+ * modification is also appended to a log segment file beneath the store directory, which is
+ * replayed to reconstruct the index when the store is next opened.
+ *
+ * Modifications are grouped into transactions, each of which is applied atomically.  Concurrent
+ * commits are batched together ( 'group commit' ), such that a single log write and a single
+ * fdatasync() persist every transaction which is waiting at the time.  The ops of a transaction
+ * are applied to the index as it commits, but no other transaction will report an outcome based
+ * upon them until their batch is durable:  read transactions wait for durability before they
+ * begin, and write transactions wait for it before they commit or abort.
+ *
+ * Each batch is written as a checksummed frame.  During the next open, a frame left incomplete by
+ * a crash is discarded, so only whole, previously committed batches survive.  Any other corrupt
+ * frame causes the open to fail with errno=EIO, as the batches following it cannot be safely
+ * applied without it; the log must then be repaired or restored before the store can be used.
+ *
+ * Once the log has grown sufficiently beyond the size of the live content, it is replaced with a
+ * compacted snapshot of the index.
+ *
+ * A store directory can be opened by only a single process at a time.
+ */
+
+#include <stdlib.h>
+#include <sys/types.h>
+
+typedef struct kvstore_struct* KVSTORE;
+typedef struct kvtxn_struct* KVTXN;
+
+// kvstore_open() flag values
+#define KVSTORE_NOSYNC 0x1 // skip the fdatasync() of each committed batch
+                           // ( commits survive process failures, but not host failures )
+
+/**
+ * Open the store located beneath the given directory, creating it if necessary
+ * @param const char* path : Path of the store directory
+ * @param int flags : Zero, or KVSTORE_NOSYNC
+ * @return KVSTORE : Reference to the opened store, or NULL if a failure occurred
+ *                   NOTE -- errno=EWOULDBLOCK indicates that the store is in use by another process
+ *                           errno=EIO indicates that the store log is corrupt, and requires repair
+ */
+KVSTORE kvstore_open( const char* path, int flags );
+
+/**
+ * Close the given store
+ * NOTE -- The caller must ensure that no transactions remain active against the store.
+ * @param KVSTORE store : Store to be closed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_close( KVSTORE store );
+
+/**
+ * Replace the log of the given store with a compacted snapshot of its current content
+ * NOTE -- This occurs automatically as the log grows, and is not required for correctness.
+ * @param KVSTORE store : Store to be compacted
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_compact( KVSTORE store );
+
+/**
+ * Begin a new transaction against the given store
+ * NOTE -- A write transaction excludes all other transactions until committed or aborted, while
+ *         any number of read transactions may proceed concurrently.  A thread must not begin a
+ *         transaction while it has another active against the same store.
+ *         A read transaction only begins once all previously committed content is durable.
+ * @param KVSTORE store : Store to operate on
+ * @param char write : If non-zero, the transaction may modify the store
+ * @return KVTXN : Reference to the new transaction, or NULL if a failure occurred
+ */
+KVTXN kvstore_begin( KVSTORE store, char write );
+
+/**
+ * Retrieve the value of the given key
+ * NOTE -- The returned reference remains valid until the transaction is committed or aborted.
+ * @param KVTXN txn : Transaction to operate within
+ * @param const void* key : Key to retrieve the value of
+ * @param size_t keylen : Length of the key
+ * @param size_t* vallen : Reference to be populated with the length of the value
+ * @return const void* : Reference to the value, or NULL w/ errno=ENOENT if the key does not exist
+ */
+const void* kvtxn_get( KVTXN txn, const void* key, size_t keylen, size_t* vallen );
+
+/**
+ * Locate the first key following the given key
+ * NOTE -- Keys are ordered bytewise, with any key sorting after each of its prefixes.
+ *         The search only includes content committed prior to the transaction, and not any
+ *         modifications already made by the transaction itself.
+ *         The produced references remain valid until the transaction is committed or aborted.
+ * @param KVTXN txn : Transaction to operate within
+ * @param const void* key : Key to search from ( may be NULL, if keylen is zero )
+ * @param size_t keylen : Length of the key
+ * @param char inclusive : If non-zero, the given key itself may be produced
+ * @param const void** nextkey : Reference to be populated with the located key
+ * @param size_t* nextkeylen : Reference to be populated with the length of the located key
+ * @param const void** value : Reference to be populated with the value of the located key
+ * @param size_t* vallen : Reference to be populated with the length of that value
+ * @return int : 1 if a key was located, 0 if no keys follow the given key, or -1 on failure
+ */
+int kvtxn_next( KVTXN txn, const void* key, size_t keylen, char inclusive,
+                const void** nextkey, size_t* nextkeylen, const void** value, size_t* vallen );
+
+/**
+ * Set the value of the given key
+ * @param KVTXN txn : Write transaction to operate within
+ * @param const void* key : Key to set the value of
+ * @param size_t keylen : Length of the key ( must be non-zero )
+ * @param const void* value : New value of the key ( may be NULL, if vallen is zero )
+ * @param size_t vallen : Length of the value
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_put( KVTXN txn, const void* key, size_t keylen, const void* value, size_t vallen );
+
+/**
+ * Delete the given key ( no error is produced if the key does not exist )
+ * @param KVTXN txn : Write transaction to operate within
+ * @param const void* key : Key to be deleted
+ * @param size_t keylen : Length of the key
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_delete( KVTXN txn, const void* key, size_t keylen );
+
+/**
+ * Commit and end the given transaction
+ * NOTE -- For a write transaction, this function will not return until all modifications ( and
+ *         all content observed by the transaction ) have been persisted to the store log.
+ *         Regardless of the result, the transaction reference is freed by this call.
+ *         Following any failure to write the log, the store will reject all further commits, as
+ *         well as any read transaction which would observe content lost to that failure.
+ * @param KVTXN txn : Transaction to be committed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvtxn_commit( KVTXN txn );
+
+/**
+ * Abort and end the given transaction, discarding all modifications
+ * NOTE -- For a write transaction, this function will not return until all content observed by
+ *         the transaction has been persisted to the store log, as that content may have
+ *         determined the decision to abort.
+ *         Regardless of the result, the transaction reference is freed by this call.
+ * @param KVTXN txn : Transaction to be aborted
+ * @return int : Zero on success, or -1 if observed content could not be persisted
+ */
+int kvtxn_abort( KVTXN txn );
+
+#endif // _KVSTORE_H
+
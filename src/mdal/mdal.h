@@ -22,6 +22,7 @@
 #include <sys/xattr.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
 
 #ifndef LIBXML_TREE_ENABLED
 #error "Included Libxml2 does not support tree functionality!"
@@ -35,6 +36,28 @@ typedef void* MDAL_DHANDLE;
 typedef void* MDAL_SCANNER;
 typedef struct MDAL_struct* MDAL;
 
+// Directory entry, including entry attributes, as produced by readdirplus()
+typedef struct MDAL_direntplus_struct {
+   struct dirent ent;   // entry info, as would be produced by readdir()
+   struct stat   st;    // attributes of the entry ( symlinks are NOT followed )
+   int           sterr; // zero if 'st' is valid, otherwise the errno value of the failed stat
+   long          loc;   // location of the dir handle following this entry ( see telldir() )
+} MDAL_direntplus;
+
+// Field mask values of statmany() ( matching the corresponding STATX_* values of statx() )
+#define MDAL_STAT_TYPE   0x001U // st_mode & S_IFMT
+#define MDAL_STAT_MODE   0x002U // st_mode & ~S_IFMT
+#define MDAL_STAT_NLINK  0x004U // st_nlink
+#define MDAL_STAT_UID    0x008U // st_uid
+#define MDAL_STAT_GID    0x010U // st_gid
+#define MDAL_STAT_ATIME  0x020U // st_atim
+#define MDAL_STAT_MTIME  0x040U // st_mtim
+#define MDAL_STAT_CTIME  0x080U // st_ctim
+#define MDAL_STAT_INO    0x100U // st_ino
+#define MDAL_STAT_SIZE   0x200U // st_size
+#define MDAL_STAT_BLOCKS 0x400U // st_blocks
+#define MDAL_STAT_ALL    0x7ffU // all of the above
+
 #define MDAL_CACHEID "MEDIC" // reserve the name 'MEDIC' ( MetaData Inlined Cache ) for writing data to MDAL files
 
 typedef struct MDAL_struct {
@@ -431,6 +454,32 @@ typedef struct MDAL_struct {
     */
    struct dirent* (*readdir) ( MDAL_DHANDLE dh );
 
+   /**
+    * Iterate over the next entries of an open directory handle, retrieving the attributes of each
+    * NOTE -- This shares the position of the directory handle with readdir(), telldir(), etc.
+    * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+    * @param MDAL_direntplus* ents : Array of entries to be populated
+    * @param size_t count : Length of the 'ents' array
+    * @return ssize_t : Number of populated entries, zero if all entries have been read,
+    *                   or -1 if a failure occurred
+    */
+   ssize_t (*readdirplus) ( MDAL_DHANDLE dh, MDAL_direntplus* ents, size_t count );
+
+   /**
+    * Stat many entries of an open directory handle ( symlinks are NOT followed )
+    * @param MDAL_DHANDLE dh : MDAL_DHANDLE containing all entries
+    * @param size_t count : Number of entries to stat
+    * @param const char** names : Names of the entries to stat
+    * @param unsigned int mask : Bitwise OR of the MDAL_STAT_* fields required by the caller
+    *                            ( the value of all other stat fields is undefined )
+    * @param struct stat* sts : Array of stat structures to be populated
+    * @param int* errs : Array to be populated with the errno value of each stat ( zero on success )
+    * @param int threads : Maximum number of threads to stat with ( zero or one for the calling thread alone )
+    * @return ssize_t : Number of successfully stat'd entries, or -1 if a failure occurred
+    */
+   ssize_t (*statmany) ( MDAL_DHANDLE dh, size_t count, const char** names, unsigned int mask,
+                         struct stat* sts, int* errs, int threads );
+
    /**
     * Identify the ( abstract ) location of an open directory handle
     * NOTE -- This 'location' can be used via seekdir() to allow for the repeating
@@ -756,6 +805,7 @@ typedef struct MDAL_struct {
 
 // Forward decls of specific MDAL initializations
 MDAL posix_mdal_init( xmlNode* posix_mdal_conf_root );
+MDAL kv_mdal_init( xmlNode* kv_mdal_conf_root );
 
 
 // Function to provide specific MDAL initialization calls based on name
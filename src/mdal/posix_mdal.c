@@ -8,6 +8,9 @@
  * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for statx()
+#endif
 #include "marfs_auto_config.h"
 #ifdef DEBUG_MDAL
 #define DEBUG DEBUG_MDAL
@@ -26,6 +29,8 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <pthread.h>
+#include <sys/sysmacros.h>
 
 
 //   -------------    POSIX DEFINITIONS    -------------
@@ -34,6 +39,8 @@
 #define PMDAL_REF PMDAL_PREFX"reference"
 #define PMDAL_SUBSP PMDAL_PREFX"subspaces"
 #define PMDAL_SUBSTRLEN 14 // max length of all ref/path/subsp dir names
+#define PMDAL_STATMANY_MAXTHREADS 16 // max threads used by a single statmany() call
+#define PMDAL_STATMANY_PERTHREAD 32 // min entries per statmany() thread
 #define PMDAL_DUSE PMDAL_PREFX"datasize"
 #define PMDAL_IUSE PMDAL_PREFX"inodecount"
 #define PMDAL_XATTR "user."PMDAL_PREFX
@@ -45,6 +52,17 @@ typedef struct posixmdal_directory_handle_struct {
    DIR*     dirp; // Directory reference
 }* POSIX_DHANDLE;
 
+typedef struct statmany_state_struct {
+   int            dfd;       // FD of the containing dir
+   size_t         count;     // number of entries
+   const char**   names;     // entry names
+   unsigned int   mask;      // MDAL_STAT_* fields to request
+   struct stat*   sts;       // output stat structs
+   int*           errs;      // output errno values
+   size_t         next;      // index of the next entry to be stat'd ( atomic )
+   size_t         successes; // count of successful stats ( atomic )
+} statmany_state;
+
 typedef struct posixmdal_scanner_struct {
    DIR*     dirp; // Directory reference
 }* POSIX_SCANNER;
@@ -174,6 +192,69 @@ int xattrfilter( const char* name, char hidden ) {
    return 0;
 }
 
+/**
+ * Stat a single directory entry, requesting only the specified fields where possible
+ * @param int dfd : FD of the containing directory
+ * @param const char* name : Name of the entry
+ * @param unsigned int mask : Bitwise OR of the MDAL_STAT_* fields to request
+ * @param struct stat* st : Stat struct to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int statentry( int dfd, const char* name, unsigned int mask, struct stat* st ) {
+#ifdef HAVE_STATX
+   // NOTE -- statx() allows network filesystems to skip retrieval of unrequested fields
+   struct statx stx;
+   if ( statx( dfd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_SYNC_AS_STAT, mask, &(stx) ) ) {
+      return -1;
+   }
+   st->st_dev = makedev( stx.stx_dev_major, stx.stx_dev_minor );
+   st->st_ino = stx.stx_ino;
+   st->st_mode = stx.stx_mode;
+   st->st_nlink = stx.stx_nlink;
+   st->st_uid = stx.stx_uid;
+   st->st_gid = stx.stx_gid;
+   st->st_rdev = makedev( stx.stx_rdev_major, stx.stx_rdev_minor );
+   st->st_size = stx.stx_size;
+   st->st_blksize = stx.stx_blksize;
+   st->st_blocks = stx.stx_blocks;
+   st->st_atim.tv_sec = stx.stx_atime.tv_sec;
+   st->st_atim.tv_nsec = stx.stx_atime.tv_nsec;
+   st->st_mtim.tv_sec = stx.stx_mtime.tv_sec;
+   st->st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
+   st->st_ctim.tv_sec = stx.stx_ctime.tv_sec;
+   st->st_ctim.tv_nsec = stx.stx_ctime.tv_nsec;
+   return 0;
+#else
+   return fstatat( dfd, name, st, AT_SYMLINK_NOFOLLOW );
+#endif
+}
+
+/**
+ * Stat entries of a statmany() call, until none remain
+ * @param void* arg : Reference to the statmany_state struct of the call
+ * @return void* : Always NULL
+ */
+void* statmany_thread( void* arg ) {
+   statmany_state* smany = (statmany_state*) arg;
+   size_t index;
+   while ( (index = __atomic_fetch_add( &(smany->next), 1, __ATOMIC_RELAXED )) < smany->count ) {
+      smany->errs[index] = 0;
+      const char* name = smany->names[index];
+      if ( name == NULL  ||  *name == '\0'  ||  strchr( name, '/' ) ) {
+         LOG( LOG_ERR, "Invalid entry name at index %zu: \"%s\"\n", index, (name) ? name : "NULL" );
+         smany->errs[index] = EINVAL;
+      }
+      else if ( statentry( smany->dfd, name, smany->mask, smany->sts + index ) ) {
+         LOG( LOG_INFO, "Failed to stat entry \"%s\" ( %s )\n", name, strerror(errno) );
+         smany->errs[index] = errno;
+      }
+      else {
+         __atomic_add_fetch( &(smany->successes), 1, __ATOMIC_RELAXED );
+      }
+   }
+   return NULL;
+}
+
 
 //   -------------    POSIX IMPLEMENTATION    -------------
 
@@ -2261,6 +2342,110 @@ struct dirent* posixmdal_readdir( MDAL_DHANDLE dh ) {
 }
 
 
+/**
+ * Iterate over the next entries of an open directory handle, retrieving the attributes of each
+ * NOTE -- This shares the position of the directory handle with readdir(), telldir(), etc.
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @param MDAL_direntplus* ents : Array of entries to be populated
+ * @param size_t count : Length of the 'ents' array
+ * @return ssize_t : Number of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
+ */
+ssize_t posixmdal_readdirplus( MDAL_DHANDLE dh, MDAL_direntplus* ents, size_t count ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIX_DHANDLE pdh = (POSIX_DHANDLE) dh;
+   int dfd = dirfd( pdh->dirp );
+   if ( dfd < 0 ) {
+      LOG( LOG_ERR, "Failed to retrieve the FD from the provided directory handle\n" );
+      return -1;
+   }
+   // NOTE -- readdir() already pulls entries in large getdents64() batches, so continuing to use it
+   //         ( rather than issuing getdents64() directly ) costs nothing, while keeping our DIR
+   //         stream position consistent for any mix of readdir/readdirplus/telldir/seekdir calls.
+   //         The real savings come from stat'ing each entry relative to the open dir FD.
+   size_t populated = 0;
+   while ( populated < count ) {
+      errno = 0;
+      struct dirent* dent = readdir( pdh->dirp );
+      if ( dent == NULL ) {
+         if ( errno ) {
+            LOG( LOG_ERR, "Failed to read the next dir entry ( %s )\n", strerror(errno) );
+            // report what we have, and let the next call report the error
+            if ( populated == 0 ) { return -1; }
+         }
+         break;
+      }
+      MDAL_direntplus* tgtent = ents + populated;
+      tgtent->ent.d_ino = dent->d_ino;
+      tgtent->ent.d_off = dent->d_off;
+      tgtent->ent.d_reclen = dent->d_reclen;
+      tgtent->ent.d_type = dent->d_type;
+      snprintf( tgtent->ent.d_name, sizeof( tgtent->ent.d_name ), "%s", dent->d_name );
+      tgtent->sterr = 0;
+      if ( fstatat( dfd, dent->d_name, &(tgtent->st), AT_SYMLINK_NOFOLLOW ) ) {
+         // most likely, the entry was removed since listing, which the caller may decide to ignore
+         LOG( LOG_INFO, "Failed to stat dir entry \"%s\" ( %s )\n", dent->d_name, strerror(errno) );
+         tgtent->sterr = errno;
+      }
+      tgtent->loc = telldir( pdh->dirp );
+      populated++;
+   }
+   return (ssize_t)populated;
+}
+
+
+/**
+ * Stat many entries of an open directory handle ( symlinks are NOT followed )
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE containing all entries
+ * @param size_t count : Number of entries to stat
+ * @param const char** names : Names of the entries to stat
+ * @param unsigned int mask : Bitwise OR of the MDAL_STAT_* fields required by the caller
+ *                            ( the value of all other stat fields is undefined )
+ * @param struct stat* sts : Array of stat structures to be populated
+ * @param int* errs : Array to be populated with the errno value of each stat ( zero on success )
+ * @param int threads : Maximum number of threads to stat with ( zero or one for the calling thread alone )
+ * @return ssize_t : Number of successfully stat'd entries, or -1 if a failure occurred
+ */
+ssize_t posixmdal_statmany( MDAL_DHANDLE dh, size_t count, const char** names, unsigned int mask,
+                                    struct stat* sts, int* errs, int threads ) {
+   // check for NULL args
+   if ( !(dh)  ||  ( count  &&  ( !(names)  ||  !(sts)  ||  !(errs) ) ) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE or array reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIX_DHANDLE pdh = (POSIX_DHANDLE) dh;
+   statmany_state smany = { .dfd = dirfd( pdh->dirp ), .count = count, .names = names, .mask = mask,
+                                .sts = sts, .errs = errs, .next = 0, .successes = 0 };
+   if ( smany.dfd < 0 ) {
+      LOG( LOG_ERR, "Failed to retrieve the FD from the provided directory handle\n" );
+      return -1;
+   }
+   // limit our fan-out, such that each thread has a reasonable amount of work
+   if ( threads > PMDAL_STATMANY_MAXTHREADS ) { threads = PMDAL_STATMANY_MAXTHREADS; }
+   if ( (size_t)threads > count / PMDAL_STATMANY_PERTHREAD ) { threads = (int)(count / PMDAL_STATMANY_PERTHREAD); }
+   pthread_t tids[PMDAL_STATMANY_MAXTHREADS];
+   int started = 0;
+   for ( ; started < threads - 1; started++ ) {
+      if ( pthread_create( tids + started, NULL, statmany_thread, &(smany) ) ) {
+         LOG( LOG_WARNING, "Failed to start statmany thread %d, continuing with fewer threads\n", started );
+         break;
+      }
+   }
+   // the calling thread always participates
+   statmany_thread( &(smany) );
+   int index;
+   for ( index = 0; index < started; index++ ) { pthread_join( tids[index], NULL ); }
+   LOG( LOG_INFO, "Stat'd %zu of %zu entries, with %d threads\n", smany.successes, count, started + 1 );
+   return (ssize_t)smany.successes;
+}
+
+
 /**
  * Identify the ( abstract ) location of an open directory handle
  * NOTE -- This 'location' can be used via seekdir() to allow for the repeating
@@ -3253,6 +3438,8 @@ MDAL posix_mdal_init( xmlNode* root ) {
          pmdal->dremovexattr = posixmdal_dremovexattr;
          pmdal->dlistxattr = posixmdal_dlistxattr;
          pmdal->readdir = posixmdal_readdir;
+         pmdal->readdirplus = posixmdal_readdirplus;
+         pmdal->statmany = posixmdal_statmany;
          pmdal->telldir = posixmdal_telldir;
          pmdal->seekdir = posixmdal_seekdir;
          pmdal->rewinddir = posixmdal_rewinddir;
@@ -0,0 +1,1026 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+// directly including the C file allows more flexibility for these tests
+#include "mdal/kv_mdal.c"
+
+#define STORE_PATH "./test_kv_mdal_nsroot"
+#define CONFIG_PATH "./testing/kv_config.xml"
+#define RATE_THREADS 4
+#define RATE_FILES   2000
+
+typedef struct rate_thread_args_struct {
+   MDAL mdal;
+   MDAL_CTXT ctxt;
+   int tnum;
+   int failed;
+} rate_thread_args;
+
+// remove every file beneath the store dir, then the dir itself
+static void remove_store( void ) {
+   DIR* dirp = opendir( STORE_PATH );
+   if ( dirp == NULL ) { return; }
+   struct dirent* dent;
+   while ( (dent = readdir( dirp )) != NULL ) {
+      if ( strcmp( dent->d_name, "." ) == 0  ||  strcmp( dent->d_name, ".." ) == 0 ) { continue; }
+      unlinkat( dirfd( dirp ), dent->d_name, 0 );
+   }
+   closedir( dirp );
+   rmdir( STORE_PATH );
+}
+
+// produce a new MDAL instance from the test config
+static MDAL load_mdal( void ) {
+   xmlDoc* doc = xmlReadFile( CONFIG_PATH, NULL, XML_PARSE_NOBLANKS );
+   if ( doc == NULL ) {
+      printf( "could not parse file %s\n", CONFIG_PATH );
+      return NULL;
+   }
+   xmlNode* root_element = xmlDocGetRootElement( doc );
+   MDAL mdal = init_mdal( root_element );
+   xmlFreeDoc( doc );
+   xmlCleanupParser();
+   return mdal;
+}
+
+// append a partial frame to the tail of the store log, as if a process had crashed mid-write
+static int tear_log( void ) {
+   DIR* dirp = opendir( STORE_PATH );
+   if ( dirp == NULL ) { return -1; }
+   struct dirent* dent;
+   int retval = -1;
+   while ( (dent = readdir( dirp )) != NULL ) {
+      if ( strncmp( dent->d_name, "LOG.", 4 ) ) { continue; }
+      int fd = openat( dirfd( dirp ), dent->d_name, O_WRONLY | O_APPEND );
+      if ( fd < 0 ) { break; }
+      const char garbage[] = "\x4d\x46\x56\x4b\xff\xff\x00\x00torn";
+      if ( write( fd, garbage, sizeof(garbage) ) == sizeof(garbage) ) { retval = 0; }
+      close( fd );
+      break;
+   }
+   closedir( dirp );
+   return retval;
+}
+
+// invert the first byte of the given string within the store log, as if by a media error
+static int flip_log( const char* str ) {
+   DIR* dirp = opendir( STORE_PATH );
+   if ( dirp == NULL ) { return -1; }
+   struct dirent* dent;
+   int retval = -1;
+   while ( (dent = readdir( dirp )) != NULL ) {
+      if ( strncmp( dent->d_name, "LOG.", 4 ) ) { continue; }
+      int fd = openat( dirfd( dirp ), dent->d_name, O_RDWR );
+      if ( fd < 0 ) { break; }
+      char logbuf[65536];
+      ssize_t loglen = read( fd, logbuf, sizeof(logbuf) );
+      size_t strlength = strlen( str );
+      ssize_t offset = 0;
+      for ( ; offset + (ssize_t)strlength <= loglen; offset++ ) {
+         if ( memcmp( logbuf + offset, str, strlength ) ) { continue; }
+         char flipped = ~(logbuf[offset]);
+         if ( pwrite( fd, &(flipped), 1, offset ) == 1 ) { retval = 0; }
+         break;
+      }
+      close( fd );
+      break;
+   }
+   closedir( dirp );
+   return retval;
+}
+
+// repeatedly create, stat, and unlink reference files beneath a per-thread reference dir
+static void* rate_thread( void* arg ) {
+   rate_thread_args* targs = (rate_thread_args*) arg;
+   MDAL mdal = targs->mdal;
+   char path[64];
+   int fnum = 0;
+   for ( ; fnum < RATE_FILES; fnum++ ) {
+      snprintf( path, 64, "rate%d/file%d", targs->tnum, fnum );
+      MDAL_FHANDLE fh = mdal->openref( targs->ctxt, path, O_CREAT | O_EXCL | O_WRONLY, S_IRWXU );
+      if ( fh == NULL  ||  mdal->close( fh ) ) { targs->failed = 1; return NULL; }
+   }
+   struct stat st;
+   for ( fnum = 0; fnum < RATE_FILES; fnum++ ) {
+      snprintf( path, 64, "rate%d/file%d", targs->tnum, fnum );
+      if ( mdal->statref( targs->ctxt, path, &(st) ) ) { targs->failed = 1; return NULL; }
+   }
+   for ( fnum = 0; fnum < RATE_FILES; fnum++ ) {
+      snprintf( path, 64, "rate%d/file%d", targs->tnum, fnum );
+      if ( mdal->unlinkref( targs->ctxt, path ) ) { targs->failed = 1; return NULL; }
+   }
+   return NULL;
+}
+
+
+int main(int argc, char **argv)
+{
+   // NOTE -- I'm ignoring memory leaks for error contions which result in immediate termination
+
+   // start from an empty store
+   remove_store();
+
+   // Initialize the libxml lib and check for API mismatches
+   LIBXML_TEST_VERSION
+
+   // Initialize a kv mdal instance
+   MDAL mdal = load_mdal();
+   if ( mdal == NULL ) {
+      printf( "failed to initialize kv mdal\n" );
+      return -1;
+   }
+
+   // verify that a second instance shares the already opened store
+   MDAL mdal2 = load_mdal();
+   if ( mdal2 == NULL ) {
+      printf( "failed to initialize a second kv mdal against the same store\n" );
+      return -1;
+   }
+   if ( ((KV_MDAL_CTXT)mdal2->ctxt)->store != ((KV_MDAL_CTXT)mdal->ctxt)->store ) {
+      printf( "second kv mdal did not share the opened store\n" );
+      return -1;
+   }
+   if ( mdal2->cleanup( mdal2 ) ) {
+      printf( "failed to cleanup second kv mdal\n" );
+      return -1;
+   }
+
+   // create a root NS
+   if ( mdal->createnamespace( mdal->ctxt, "/." ) ) {
+      printf( "failed to create namespace \"/.\"\n" );
+      return -1;
+   }
+
+   // verify EINVAL case
+   errno = 0;
+   if ( mdal->createnamespace( mdal->ctxt, "." ) == 0  ||  errno != EINVAL ) {
+      printf( "expected EINVAL for relative NS path of unset ctxt\n" );
+      return -1;
+   }
+
+   // create a few subspaces
+   if ( mdal->createnamespace( mdal->ctxt, "/subsp1" ) ) {
+      printf( "failed to create subsp1\n" );
+      return -1;
+   }
+   if ( mdal->createnamespace( mdal->ctxt, "/subsp2" ) ) {
+      printf( "failed to create subsp2\n" );
+      return -1;
+   }
+   if ( mdal->createnamespace( mdal->ctxt, "/subsp1/subsp1" ) ) {
+      printf( "failed to create subsp1/subsp1\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->createnamespace( mdal->ctxt, "/subsp1" ) == 0  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for dup creation of subsp1\n" );
+      return -1;
+   }
+
+   // create a new context, referencing the root NS
+   MDAL_CTXT rootctxt = mdal->newctxt( "/.", mdal->ctxt );
+   if ( rootctxt == NULL ) {
+      printf( "failed to create new ctxt referencing \"/.\"\n" );
+      return -1;
+   }
+
+   // create a reference dir for this NS
+   if ( mdal->createrefdir( rootctxt, "ref0", S_IRWXU ) ) {
+      printf( "failed to create ref0 for the rootNS\n" );
+      return -1;
+   }
+
+   // set the data and inode usage of the NS
+   if ( mdal->setdatausage( rootctxt, 1048576 ) ) {
+      printf( "failed to set data usage of root NS\n" );
+      return -1;
+   }
+   if ( mdal->setinodeusage( rootctxt, 1024 ) ) {
+      printf( "failed to set inode usage of root NS\n" );
+      return -1;
+   }
+
+   // duplicate the base ctxt, then set it to the root NS as well
+   MDAL_CTXT dupctxt = mdal->dupctxt( mdal->ctxt );
+   if ( dupctxt == NULL ) {
+      printf( "failed to dup root ctxt\n" );
+      return -1;
+   }
+   if ( mdal->setnamespace( dupctxt, "/." ) ) {
+      printf( "failed to set dup ctxt to root NS\n" );
+      return -1;
+   }
+
+   // check for EEXIST from the same ref dir
+   errno = 0;
+   if ( mdal->createrefdir( dupctxt, "ref0", S_IRWXU ) == 0  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for dup creation of ref0\n" );
+      return -1;
+   }
+
+   // verify previous data / inode usage values
+   if ( mdal->getdatausage( dupctxt ) != 1048576 ) {
+      printf( "dupctxt recieved unexpected data usage value\n" );
+      return -1;
+   }
+   if ( mdal->getinodeusage( dupctxt ) != 1024 ) {
+      printf( "dupctxt recieved unexpected inode usage value\n" );
+      return -1;
+   }
+
+   // stat a subspace, and verify it is reported as a directory
+   struct stat stbuf;
+   if ( mdal->statnamespace( dupctxt, "subsp1", &(stbuf) )  ||  !(S_ISDIR(stbuf.st_mode)) ) {
+      printf( "failed to stat subsp1 as a directory\n" );
+      return -1;
+   }
+
+   // destroy a NS by relative path
+   if ( mdal->destroynamespace( dupctxt, "subsp2" ) ) {
+      printf( "failed to destory subsp2 NS\n" );
+      return -1;
+   }
+
+   // verify ENOTEMPTY for subsp1
+   errno = 0;
+   if ( mdal->destroynamespace( dupctxt, "subsp1" ) == 0  ||  errno != ENOTEMPTY ) {
+      printf( "expected ENOTEMPTY for destruction of subsp1\n" );
+      return -1;
+   }
+
+   // destroy subsp1/subsp1 by absolute path
+   if ( mdal->destroynamespace( mdal->ctxt, "/subsp1/subsp1" ) ) {
+      printf( "failed to destroy \"/subsp1/subsp1\"\n" );
+      return -1;
+   }
+
+   // actually destroy subsp1 by relative path
+   if ( mdal->destroynamespace( dupctxt, "subsp1" ) ) {
+      printf( "failed to destroy subsp1\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->statnamespace( dupctxt, "subsp1", &(stbuf) ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for stat of destroyed subsp1\n" );
+      return -1;
+   }
+
+   // destroy the dup ctxt
+   if ( mdal->destroyctxt( dupctxt ) ) {
+      printf( "failed to destroy dup ctxt\n" );
+      return -1;
+   }
+
+   // create a reference file in the root NS
+   MDAL_FHANDLE rootfh = mdal->openref( rootctxt, "ref0/reffile", O_CREAT | O_EXCL | O_WRONLY, S_IRWXU );
+   if ( !(rootfh) ) {
+      printf( "failed to open \"ref0/reffile\" in the root NS\n" );
+      return -1;
+   }
+   // verify EEXIST for an exclusive create of the same file
+   errno = 0;
+   if ( mdal->openref( rootctxt, "ref0/reffile", O_CREAT | O_EXCL | O_WRONLY, S_IRWXU )  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for exclusive create of existing reffile\n" );
+      return -1;
+   }
+   // truncate to a new size
+   if ( mdal->ftruncate( rootfh, 10234 ) ) {
+      printf( "failed to truncate reffile to new length\n" );
+      return -1;
+   }
+   // seek to the end of the file
+   if ( mdal->lseek( rootfh, 0, SEEK_END ) != 10234 ) {
+      printf( "unexpected offset for end of reffile\n" );
+      return -1;
+   }
+   // write to the end of the file
+   if ( mdal->write( rootfh, "CONTENT", (sizeof(char) * 8) ) != (sizeof(char) * 8) ) {
+      printf( "unexpected return for write of \"CONTENT\" to reffile\n" );
+      return -1;
+   }
+   // set a user visible xattr
+   if ( mdal->fsetxattr( rootfh, 0, "user.testname", "testnamecontent", sizeof(char) * 16, XATTR_CREATE ) ) {
+      printf( "failed to set testname xattr on reffile\n" );
+      return -1;
+   }
+   // verify EEXIST for a repeated XATTR_CREATE
+   errno = 0;
+   if ( mdal->fsetxattr( rootfh, 0, "user.testname", "other", sizeof(char) * 6, XATTR_CREATE ) == 0  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for repeated creation of testname xattr\n" );
+      return -1;
+   }
+   // set a hidden xattr
+   if ( mdal->fsetxattr( rootfh, 1, "hidename", "hidenamecontent", sizeof(char) * 16, 0 ) ) {
+      printf( "failed to set hidename hidden xattr on reffile\n" );
+      return -1;
+   }
+   // set utime values
+   struct timespec ftimevals[2];
+   ftimevals[0].tv_sec = 123456;
+   ftimevals[0].tv_nsec = 0;
+   ftimevals[1].tv_sec = 654321;
+   ftimevals[1].tv_nsec = 1;
+   if ( mdal->futimens( rootfh, ftimevals ) ) {
+      printf( "failed to set timevals on reffile\n" );
+      return -1;
+   }
+   // close the file handle
+   if ( mdal->close( rootfh ) ) {
+      printf( "failed to close reffile\n" );
+      return -1;
+   }
+
+   // link the reference file into the user namespace
+   if ( mdal->linkref( rootctxt, 0, "ref0/reffile", "userfile" ) ) {
+      printf( "failed to link \"ref0/reffile\" to user path \"userfile\"\n" );
+      return -1;
+   }
+
+   // stat the reference file directly
+   if ( mdal->statref( rootctxt, "ref0/reffile", &(stbuf) ) ) {
+      printf( "failed to stat \"ref0/reffile\"\n" );
+      return -1;
+   }
+   // verify link count
+   if ( stbuf.st_nlink != 2 ) {
+      printf( "\"ref0/reffile\" has unexpected link count\n" );
+      return -1;
+   }
+   // verify file size
+   if ( stbuf.st_size != (10234 + 8) ) {
+      printf( "reffline has unexpected size\n" );
+      return -1;
+   }
+   // verify perms
+   if ( (stbuf.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO)) != S_IRWXU ) {
+      printf( "unexpected perms for reffile\n" );
+      return -1;
+   }
+   // verify mtime values
+   if ( stbuf.st_mtime != ftimevals[1].tv_sec  ||  stbuf.st_mtim.tv_nsec != ftimevals[1].tv_nsec ) {
+      printf( "reffile has unexpected mtime values\n" );
+      return -1;
+   }
+
+   // verify ENOTEMPTY for ref0
+   errno = 0;
+   if ( mdal->destroyrefdir( rootctxt, "ref0" ) == 0  ||  errno != ENOTEMPTY ) {
+      printf( "expected ENOTEMPTY for destruction of ref0\n" );
+      return -1;
+   }
+
+   // open a scanner for ref0
+   MDAL_SCANNER sref0 = mdal->openscanner( rootctxt, "ref0" );
+   if ( !(sref0) ) {
+      printf( "failed to open scanner for ref0\n" );
+      return -1;
+   }
+
+   // scan over the ref dir
+   struct dirent* entry;
+   int entcount = 0;
+   errno = 0;
+   while ( (entry = mdal->scan( sref0 )) != NULL ) {
+      entcount++;
+      // look for '.', '..', and 'reffile'
+      if ( strncmp( ".", entry->d_name, 2 ) == 0  ||  strncmp( "..", entry->d_name, 3 ) == 0 ) {
+         continue;
+      }
+      if ( strncmp( "reffile", entry->d_name, 8 ) ) {
+         printf( "expected \"reffile\" scanner entry, but found \"%s\"\n", entry->d_name );
+         return -1;
+      }
+   }
+   if ( errno ) {
+      printf( "expected zero errno value following scan of ref0\n" );
+      return -1;
+   }
+   if ( entcount != 3 ) {
+      printf( "expected 3 scanner entries, but found %d\n", entcount );
+      return -1;
+   }
+
+   // open the file via the scanner, stat it via the file handle, and compare to the original stat struct
+   struct stat verstat;
+   MDAL_FHANDLE sfh = mdal->sopen( sref0, "reffile" );
+   if ( !(sfh) ) {
+      printf( "failed to open reffile via scanner\n" );
+      return -1;
+   }
+   if ( mdal->fstat( sfh, &(verstat) ) ) {
+      printf( "failed to stat reffile via scanner handle\n" );
+      return -1;
+   }
+   if ( memcmp( &(verstat), &(stbuf), sizeof(struct stat) ) ) {
+      printf( "scanner stat does not match reference stat for reffile\n" );
+      return -1;
+   }
+   // directly stat the userspace link, and verify the stat struct matches
+   if ( mdal->stat( rootctxt, "userfile", &(verstat), AT_SYMLINK_NOFOLLOW ) ) {
+      printf( "failed to stat userfile via rootctxt\n" );
+      return -1;
+   }
+   if ( memcmp( &(verstat), &(stbuf), sizeof(struct stat) ) ) {
+      printf( "userfile stat does not match reference stat\n" );
+      return -1;
+   }
+   // verify that the truncated region reads as zeroes
+   char buf[64];
+   if ( mdal->read( sfh, buf, 64 ) != 64 ) {
+      printf( "failed to read 64bytes from start of scanner reffile\n" );
+      return -1;
+   }
+   int bindex = 0;
+   for ( ; bindex < 64; bindex++ ) {
+      if ( buf[bindex] ) {
+         printf( "unexpected non-zero byte at offset %d of reffile\n", bindex );
+         return -1;
+      }
+   }
+   // seek to EOF minus 8, and verify the CONTENT string
+   if ( mdal->lseek( sfh, 10234, SEEK_SET ) != 10234 ) {
+      printf( "failed to seek to 10234 of scanner reffile\n" );
+      return -1;
+   }
+   if ( mdal->read( sfh, buf, 64 ) != 8 ) {
+      printf( "failed to read 8bytes from end of scanner reffile\n" );
+      return -1;
+   }
+   if ( strncmp( buf, "CONTENT", 8 ) ) {
+      printf( "retrieved bytes do not match CONTENT\n" );
+      return -1;
+   }
+   if ( mdal->read( sfh, buf, 64 ) != 0 ) {
+      printf( "expected EOF following read of CONTENT\n" );
+      return -1;
+   }
+   // verify EBADF for a write to a read-only handle
+   errno = 0;
+   if ( mdal->write( sfh, "X", 1 ) >= 0  ||  errno != EBADF ) {
+      printf( "expected EBADF for write to read-only scanner handle\n" );
+      return -1;
+   }
+   // list xattrs on the file and verify
+   ssize_t xlistsz = mdal->flistxattr( sfh, 0, buf, 64 );
+   if ( xlistsz != 14 ) {
+      printf( "list xattrs on scanner reffile gave unexpected return\n" );
+      return -1;
+   }
+   if ( strncmp( buf, "user.testname", 64 ) ) {
+      printf( "xattr list does not match \"user.testname\"\n" );
+      return -1;
+   }
+   // list hidden values on the file and verify
+   if ( mdal->flistxattr( sfh, 1, buf, 64 ) != 9 ) {
+      printf( "list hidden xattrs on scanner reffile gave unexpected return\n" );
+      return -1;
+   }
+   if ( strncmp( buf, "hidename", 64 ) ) {
+      printf( "hidden xattr list does not match \"hidename\"\n" );
+      return -1;
+   }
+   // retrieve the xattr val and verify
+   if ( mdal->fgetxattr( sfh, 0, "user.testname", buf, 64 ) != 16 ) {
+      printf( "value of user.testname has an unexpected length\n" );
+      return -1;
+   }
+   if ( strncmp( buf, "testnamecontent", 64 ) ) {
+      printf( "user.testname had unexpected content\n" );
+      return -1;
+   }
+   // retrieve the hidden xattr val and verify
+   if ( mdal->fgetxattr( sfh, 1, "hidename", buf, 64 ) != 16 ) {
+      printf( "value of hidename has an unexpected length\n" );
+      return -1;
+   }
+   if ( strncmp( buf, "hidenamecontent", 64 ) ) {
+      printf( "hidename had unexpected content\n" );
+      return -1;
+   }
+   // verify that hidden values are inaccessible as normal xattrs
+   errno = 0;
+   if ( mdal->fgetxattr( sfh, 0, KMDAL_XATTR"hidename", buf, 64 ) >= 0  ||  errno != EPERM ) {
+      printf( "expected EPERM for direct access of a hidden value\n" );
+      return -1;
+   }
+   // remove both values
+   if ( mdal->fremovexattr( sfh, 0, "user.testname" ) ) {
+      printf( "failed to remove user.testname value\n" );
+      return -1;
+   }
+   if ( mdal->fremovexattr( sfh, 1, "hidename" ) ) {
+      printf( "failed to remove hidename value\n" );
+      return -1;
+   }
+   // confirm absence of values
+   if ( mdal->flistxattr( sfh, 0, buf, 64 ) ) {
+      printf( "expected absence of any xattr vals\n" );
+      return -1;
+   }
+   if ( mdal->flistxattr( sfh, 1, buf, 64 ) ) {
+      printf( "expected absence of any hidden vals\n" );
+      return -1;
+   }
+   // close the file handle
+   if ( mdal->close( sfh ) ) {
+      printf( "failed to close scanner handle\n" );
+      return -1;
+   }
+   // create, stat, and unlink a file via the scanner
+   MDAL_FHANDLE tmpfh = mdal->openref( rootctxt, "ref0/tmpfile", O_CREAT | O_WRONLY, S_IRWXU );
+   if ( tmpfh == NULL  ||  mdal->close( tmpfh ) ) {
+      printf( "failed to create \"ref0/tmpfile\"\n" );
+      return -1;
+   }
+   if ( mdal->sstat( sref0, "tmpfile", &(verstat) )  ||  verstat.st_size ) {
+      printf( "failed to stat tmpfile via scanner\n" );
+      return -1;
+   }
+   if ( mdal->sunlink( sref0, "tmpfile" ) ) {
+      printf( "failed to unlink tmpfile via scanner\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->sstat( sref0, "tmpfile", &(verstat) ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for stat of unlinked tmpfile\n" );
+      return -1;
+   }
+   if ( mdal->closescanner( sref0 ) ) {
+      printf( "failed to close scanner\n" );
+      return -1;
+   }
+
+   // build a small user dir tree
+   if ( mdal->mkdir( rootctxt, "dir1", S_IRWXU ) ) {
+      printf( "failed to create dir1\n" );
+      return -1;
+   }
+   if ( mdal->mknod( rootctxt, "dir1/node", S_IFREG | S_IRUSR, 0 ) ) {
+      printf( "failed to create dir1/node\n" );
+      return -1;
+   }
+   if ( mdal->symlink( rootctxt, "node", "dir1/link" ) ) {
+      printf( "failed to create dir1/link\n" );
+      return -1;
+   }
+   if ( mdal->readlink( rootctxt, "dir1/link", buf, 64 ) != 4  ||  strncmp( buf, "node", 4 ) ) {
+      printf( "unexpected readlink result for dir1/link\n" );
+      return -1;
+   }
+   if ( mdal->stat( rootctxt, "dir1/link", &(verstat), 0 )  ||  !(S_ISREG(verstat.st_mode)) ) {
+      printf( "failed to stat dir1/link as a regular file\n" );
+      return -1;
+   }
+   if ( mdal->stat( rootctxt, "dir1/link", &(verstat), AT_SYMLINK_NOFOLLOW )  ||  !(S_ISLNK(verstat.st_mode)) ) {
+      printf( "failed to stat dir1/link as a symlink\n" );
+      return -1;
+   }
+   if ( mdal->access( rootctxt, "dir1/node", F_OK, 0 ) ) {
+      printf( "failed to check existence of dir1/node\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->rmdir( rootctxt, "dir1" ) == 0  ||  errno != ENOTEMPTY ) {
+      printf( "expected ENOTEMPTY for rmdir of dir1\n" );
+      return -1;
+   }
+
+   // read the dir tree, then verify that a seek repeats the same entries
+   MDAL_DHANDLE dh = mdal->opendir( rootctxt, "dir1" );
+   if ( dh == NULL ) {
+      printf( "failed to open dir1\n" );
+      return -1;
+   }
+   if ( (entry = mdal->readdir( dh )) == NULL  ||  strcmp( entry->d_name, "." )  ||
+        (entry = mdal->readdir( dh )) == NULL  ||  strcmp( entry->d_name, ".." ) ) {
+      printf( "expected '.' and '..' as the initial dir1 entries\n" );
+      return -1;
+   }
+   long loc = mdal->telldir( dh );
+   if ( (entry = mdal->readdir( dh )) == NULL  ||  strcmp( entry->d_name, "node" ) ) {
+      printf( "expected 'node' as the first dir1 entry\n" );
+      return -1;
+   }
+   if ( (entry = mdal->readdir( dh )) == NULL  ||  strcmp( entry->d_name, "link" ) ) {
+      printf( "expected 'link' as the second dir1 entry\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->readdir( dh ) != NULL  ||  errno ) {
+      printf( "expected end of dir1 entries\n" );
+      return -1;
+   }
+   if ( mdal->seekdir( dh, loc ) ) {
+      printf( "failed to seek dir1 handle\n" );
+      return -1;
+   }
+   MDAL_direntplus plusents[4];
+   if ( mdal->readdirplus( dh, plusents, 4 ) != 2 ) {
+      printf( "unexpected readdirplus entry count following seek of dir1\n" );
+      return -1;
+   }
+   if ( strcmp( plusents[0].ent.d_name, "node" )  ||  plusents[0].sterr  ||  !(S_ISREG(plusents[0].st.st_mode))  ||
+        strcmp( plusents[1].ent.d_name, "link" )  ||  plusents[1].sterr  ||  !(S_ISLNK(plusents[1].st.st_mode)) ) {
+      printf( "unexpected readdirplus results for dir1\n" );
+      return -1;
+   }
+   const char* statnames[3] = { "node", "link", "bad/name" };
+   struct stat statbufs[3];
+   int staterrs[3];
+   if ( mdal->statmany( dh, 3, statnames, MDAL_STAT_TYPE, statbufs, staterrs, 2 ) != 2 ) {
+      printf( "unexpected statmany success count for dir1\n" );
+      return -1;
+   }
+   if ( staterrs[0]  ||  staterrs[1]  ||  staterrs[2] != EINVAL  ||  !(S_ISLNK(statbufs[1].st_mode)) ) {
+      printf( "unexpected statmany results for dir1\n" );
+      return -1;
+   }
+   if ( mdal->rewinddir( dh )  ||  (entry = mdal->readdir( dh )) == NULL  ||  strcmp( entry->d_name, "." ) ) {
+      printf( "expected '.' as the first entry following rewind of dir1\n" );
+      return -1;
+   }
+   // rename an entry, and verify the order of entries remains consistent
+   if ( mdal->rename( rootctxt, "dir1/node", rootctxt, "dir1/node2" ) ) {
+      printf( "failed to rename dir1/node\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->stat( rootctxt, "dir1/node", &(verstat), 0 ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for stat of renamed dir1/node\n" );
+      return -1;
+   }
+   if ( mdal->readlink( rootctxt, "dir1/link", buf, 64 ) != 4 ) {
+      printf( "failed to readlink dir1/link following rename\n" );
+      return -1;
+   }
+   // change into the dir, and clean it out
+   if ( mdal->chdir( rootctxt, dh ) ) {
+      printf( "failed to chdir into dir1\n" );
+      return -1;
+   }
+   if ( mdal->unlink( rootctxt, "node2" )  ||  mdal->unlink( rootctxt, "link" ) ) {
+      printf( "failed to unlink dir1 content\n" );
+      return -1;
+   }
+   if ( mdal->setnamespace( rootctxt, "." ) ) {
+      printf( "failed to reset rootctxt to the root NS\n" );
+      return -1;
+   }
+   if ( mdal->rmdir( rootctxt, "dir1" ) ) {
+      printf( "failed to remove dir1\n" );
+      return -1;
+   }
+
+   // write a file large enough to span multiple write transactions
+   size_t bigsize = ( KMDAL_BLOCKSIZE * KMDAL_WRITECHUNK * 2 ) + 1234;
+   char* bigbuf = malloc( bigsize );
+   char* verbuf = malloc( bigsize );
+   if ( bigbuf == NULL  ||  verbuf == NULL ) {
+      printf( "failed to allocate large file buffers\n" );
+      return -1;
+   }
+   size_t bigindex = 0;
+   for ( ; bigindex < bigsize; bigindex++ ) { bigbuf[bigindex] = (char)( bigindex * 7 ); }
+   MDAL_FHANDLE bigfh = mdal->openref( rootctxt, "ref0/bigfile", O_CREAT | O_RDWR, S_IRWXU );
+   if ( bigfh == NULL ) {
+      printf( "failed to create \"ref0/bigfile\"\n" );
+      return -1;
+   }
+   if ( mdal->write( bigfh, bigbuf + 1, 10 ) != 10  ||  mdal->lseek( bigfh, 0, SEEK_SET )  ||
+        mdal->write( bigfh, bigbuf, bigsize ) != bigsize ) {
+      printf( "failed to write bigfile content\n" );
+      return -1;
+   }
+   // unlink the file while it remains open
+   if ( mdal->unlinkref( rootctxt, "ref0/bigfile" ) ) {
+      printf( "failed to unlink open bigfile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->statref( rootctxt, "ref0/bigfile", &(verstat) ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for stat of unlinked bigfile\n" );
+      return -1;
+   }
+   if ( mdal->fstat( bigfh, &(verstat) )  ||  verstat.st_size != bigsize  ||  verstat.st_nlink ) {
+      printf( "unexpected stat of open, unlinked bigfile\n" );
+      return -1;
+   }
+   if ( mdal->lseek( bigfh, 0, SEEK_SET )  ||  mdal->read( bigfh, verbuf, bigsize ) != bigsize  ||
+        memcmp( bigbuf, verbuf, bigsize ) ) {
+      printf( "failed to read back bigfile content\n" );
+      return -1;
+   }
+   if ( mdal->close( bigfh ) ) {
+      printf( "failed to close bigfile\n" );
+      return -1;
+   }
+   // verify that the final close purged all content of the file
+   KVSTORE kvs = ((KV_MDAL_CTXT)rootctxt)->store->kvs;
+   KVTXN txn = kvstore_begin( kvs, 0 );
+   char key[KMDAL_KEYMAX];
+   if ( txn == NULL  ||  kvtxn_get( txn, key, kvmdal_key( key, KMDAL_KEY_INODE, verstat.st_ino, NULL, 0 ), &(bigindex) )  ||
+        kvtxn_get( txn, key, kvmdal_numkey( key, KMDAL_KEY_BLOCK, verstat.st_ino, 0 ), &(bigindex) ) ) {
+      printf( "bigfile content persists following final close\n" );
+      return -1;
+   }
+   kvtxn_abort( txn );
+   free( bigbuf );
+   free( verbuf );
+
+   // drop every reference to the store, then re-open it, and verify that all state persists
+   if ( mdal->statref( rootctxt, "ref0/reffile", &(stbuf) ) ) {
+      printf( "failed to stat \"ref0/reffile\" prior to re-open\n" );
+      return -1;
+   }
+   if ( mdal->destroyctxt( rootctxt ) ) {
+      printf( "failed to destroy rootctxt\n" );
+      return -1;
+   }
+   if ( mdal->cleanup( mdal ) ) {
+      printf( "failed to cleanup kv mdal\n" );
+      return -1;
+   }
+   int pass = 0;
+   for ( ; pass < 4; pass++ ) {
+      if ( pass == 1  &&  tear_log() ) {
+         printf( "failed to append a torn frame to the store log\n" );
+         return -1;
+      }
+      if ( pass == 3 ) {
+         // a corrupt frame followed by later batches should prevent the store from opening
+         char corruptname[] = "corrupteddir";
+         if ( flip_log( corruptname ) ) {
+            printf( "failed to corrupt a frame of the store log\n" );
+            return -1;
+         }
+         mdal = load_mdal();
+         if ( mdal != NULL ) {
+            printf( "initialized kv mdal despite a corrupt log frame\n" );
+            return -1;
+         }
+         corruptname[0] = ~(corruptname[0]);
+         if ( flip_log( corruptname ) ) {
+            printf( "failed to repair a corrupt frame of the store log\n" );
+            return -1;
+         }
+      }
+      mdal = load_mdal();
+      if ( mdal == NULL ) {
+         printf( "failed to re-initialize kv mdal ( pass %d )\n", pass );
+         return -1;
+      }
+      rootctxt = mdal->newctxt( "/.", mdal->ctxt );
+      if ( rootctxt == NULL ) {
+         printf( "failed to create new ctxt referencing \"/.\" ( pass %d )\n", pass );
+         return -1;
+      }
+      if ( mdal->getdatausage( rootctxt ) != 1048576  ||  mdal->getinodeusage( rootctxt ) != 1024 ) {
+         printf( "unexpected usage values following re-open ( pass %d )\n", pass );
+         return -1;
+      }
+      if ( mdal->statref( rootctxt, "ref0/reffile", &(verstat) )  ||  memcmp( &(verstat), &(stbuf), sizeof(struct stat) ) ) {
+         printf( "reffile stat does not match following re-open ( pass %d )\n", pass );
+         return -1;
+      }
+      if ( pass == 1 ) {
+         // confirm that the store remains writable following recovery, then force a compaction
+         if ( mdal->mkdir( rootctxt, "postrecovery", S_IRWXU ) ) {
+            printf( "failed to create a dir following log recovery\n" );
+            return -1;
+         }
+         if ( kvstore_compact( ((KV_MDAL_CTXT)rootctxt)->store->kvs ) ) {
+            printf( "failed to compact the store\n" );
+            return -1;
+         }
+      }
+      if ( pass == 2 ) {
+         if ( mdal->rmdir( rootctxt, "postrecovery" ) ) {
+            printf( "failed to remove a dir following compaction\n" );
+            return -1;
+         }
+         // each of these is persisted as a distinct frame, the first of which will be corrupted
+         if ( mdal->mkdir( rootctxt, "corrupteddir", S_IRWXU )  ||  mdal->mkdir( rootctxt, "survivordir", S_IRWXU ) ) {
+            printf( "failed to create dirs prior to log corruption\n" );
+            return -1;
+         }
+      }
+      if ( pass == 3  &&  ( mdal->rmdir( rootctxt, "corrupteddir" )  ||  mdal->rmdir( rootctxt, "survivordir" ) ) ) {
+         printf( "failed to remove dirs following log repair\n" );
+         return -1;
+      }
+      if ( pass < 3 ) {
+         if ( mdal->destroyctxt( rootctxt ) ) {
+            printf( "failed to destroy rootctxt ( pass %d )\n", pass );
+            return -1;
+         }
+         if ( mdal->cleanup( mdal ) ) {
+            printf( "failed to cleanup kv mdal ( pass %d )\n", pass );
+            return -1;
+         }
+      }
+   }
+
+   // time concurrent create / stat / unlink of small reference files
+   pthread_t threads[RATE_THREADS];
+   rate_thread_args targs[RATE_THREADS];
+   int tnum = 0;
+   for ( ; tnum < RATE_THREADS; tnum++ ) {
+      snprintf( buf, 64, "rate%d", tnum );
+      targs[tnum].mdal = mdal;
+      targs[tnum].ctxt = mdal->dupctxt( rootctxt );
+      targs[tnum].tnum = tnum;
+      targs[tnum].failed = 0;
+      if ( targs[tnum].ctxt == NULL  ||  mdal->createrefdir( rootctxt, buf, S_IRWXU ) ) {
+         printf( "failed to prepare rate thread %d\n", tnum );
+         return -1;
+      }
+   }
+   struct timespec start, end;
+   clock_gettime( CLOCK_MONOTONIC, &(start) );
+   for ( tnum = 0; tnum < RATE_THREADS; tnum++ ) {
+      if ( pthread_create( threads + tnum, NULL, rate_thread, targs + tnum ) ) {
+         printf( "failed to launch rate thread %d\n", tnum );
+         return -1;
+      }
+   }
+   for ( tnum = 0; tnum < RATE_THREADS; tnum++ ) { pthread_join( threads[tnum], NULL ); }
+   clock_gettime( CLOCK_MONOTONIC, &(end) );
+   double elapsed = (double)( end.tv_sec - start.tv_sec ) + ( (double)( end.tv_nsec - start.tv_nsec ) / 1e9 );
+   for ( tnum = 0; tnum < RATE_THREADS; tnum++ ) {
+      snprintf( buf, 64, "rate%d", tnum );
+      if ( targs[tnum].failed  ||  mdal->destroyctxt( targs[tnum].ctxt )  ||  mdal->destroyrefdir( rootctxt, buf ) ) {
+         printf( "rate thread %d failed\n", tnum );
+         return -1;
+      }
+   }
+   printf( "%d threads created, stat'd, and unlinked %d files in %.3f sec ( %.0f ops/sec )\n",
+           RATE_THREADS, RATE_THREADS * RATE_FILES, elapsed, ( 3.0 * RATE_THREADS * RATE_FILES ) / elapsed );
+
+   // issue some ops directly against userfile
+   if ( mdal->chown( rootctxt, "userfile", geteuid(), getegid(), 0 ) ) {
+      printf( "failed to chown userfile\n" );
+      return -1;
+   }
+   if ( mdal->chmod( rootctxt, "userfile", S_IRWXG, 0 ) ) {
+      printf( "failed to chmod userfile\n" );
+      return -1;
+   }
+   if ( mdal->stat( rootctxt, "userfile", &(verstat), 0 )  ||  (verstat.st_mode & 07777) != S_IRWXG ) {
+      printf( "unexpected mode for userfile following chmod\n" );
+      return -1;
+   }
+
+   // verify that permissions are enforced against an unprivileged caller
+   if ( geteuid() == 0 ) {
+      if ( mdal->chmodnamespace( mdal->ctxt, "/.", S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH )  ||
+           mdal->mkdir( rootctxt, "permdir", S_IRWXU )  ||
+           mdal->mknod( rootctxt, "pubfile", S_IFREG | S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, 0 ) ) {
+         printf( "failed to prepare permission targets\n" );
+         return -1;
+      }
+      if ( setegid( 65534 )  ||  seteuid( 65534 ) ) {
+         printf( "failed to drop privileges\n" );
+         return -1;
+      }
+      MDAL_FHANDLE permfh = mdal->open( rootctxt, "pubfile", O_RDONLY );
+      if ( permfh == NULL  ||  mdal->close( permfh ) ) {
+         printf( "failed to open pubfile for read as an unprivileged user\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->open( rootctxt, "pubfile", O_WRONLY ) != NULL  ||  errno != EACCES ) {
+         printf( "expected EACCES for write open of pubfile\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->stat( rootctxt, "permdir/nofile", &(verstat), 0 ) == 0  ||  errno != EACCES ) {
+         printf( "expected EACCES for traversal of permdir\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->mkdir( rootctxt, "nobodydir", S_IRWXU ) == 0  ||  errno != EACCES ) {
+         printf( "expected EACCES for mkdir within a read-only dir\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->unlink( rootctxt, "pubfile" ) == 0  ||  errno != EACCES ) {
+         printf( "expected EACCES for unlink within a read-only dir\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->chmod( rootctxt, "pubfile", S_IRWXO, 0 ) == 0  ||  errno != EPERM ) {
+         printf( "expected EPERM for chmod of an unowned file\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->chown( rootctxt, "pubfile", 65534, -1, 0 ) == 0  ||  errno != EPERM ) {
+         printf( "expected EPERM for chown of an unowned file\n" );
+         return -1;
+      }
+      struct timespec permtimes[2] = { { .tv_sec = 1, .tv_nsec = 0 }, { .tv_sec = 1, .tv_nsec = 0 } };
+      errno = 0;
+      if ( mdal->utimens( rootctxt, "pubfile", permtimes, 0 ) == 0  ||  errno != EPERM ) {
+         printf( "expected EPERM for explicit utimens of an unowned file\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->utimens( rootctxt, "pubfile", NULL, 0 ) == 0  ||  errno != EACCES ) {
+         printf( "expected EACCES for utimens of an unwritable file\n" );
+         return -1;
+      }
+      if ( seteuid( 0 )  ||  setegid( 0 ) ) {
+         printf( "failed to restore privileges\n" );
+         return -1;
+      }
+      // within a sticky dir, only owners may remove entries
+      if ( mdal->chmodnamespace( mdal->ctxt, "/.", S_ISVTX | S_IRWXU | S_IRWXG | S_IRWXO ) ) {
+         printf( "failed to make the root NS sticky\n" );
+         return -1;
+      }
+      if ( setegid( 65534 )  ||  seteuid( 65534 ) ) {
+         printf( "failed to drop privileges\n" );
+         return -1;
+      }
+      if ( mdal->mknod( rootctxt, "nobodyfile", S_IFREG | S_IRUSR | S_IWUSR, 0 ) ) {
+         printf( "failed to create a file within a sticky dir\n" );
+         return -1;
+      }
+      errno = 0;
+      if ( mdal->unlink( rootctxt, "pubfile" ) == 0  ||  errno != EPERM ) {
+         printf( "expected EPERM for unlink of an unowned file within a sticky dir\n" );
+         return -1;
+      }
+      if ( mdal->unlink( rootctxt, "nobodyfile" ) ) {
+         printf( "failed to unlink an owned file within a sticky dir\n" );
+         return -1;
+      }
+      if ( seteuid( 0 )  ||  setegid( 0 ) ) {
+         printf( "failed to restore privileges\n" );
+         return -1;
+      }
+      if ( mdal->unlink( rootctxt, "pubfile" )  ||  mdal->rmdir( rootctxt, "permdir" )  ||
+           mdal->chmodnamespace( mdal->ctxt, "/.", S_IRWXU ) ) {
+         printf( "failed to cleanup permission targets\n" );
+         return -1;
+      }
+   }
+   else {
+      // the caller cannot give away their own files
+      errno = 0;
+      if ( mdal->chown( rootctxt, "userfile", 0, -1, 0 ) == 0  ||  errno != EPERM ) {
+         printf( "expected EPERM for chown of userfile to root\n" );
+         return -1;
+      }
+   }
+
+   // cleanup all previous state
+   if ( mdal->unlinkref( rootctxt, "ref0/reffile" ) ) {
+      printf( "failed to unlink reffile\n" );
+      return -1;
+   }
+   if ( mdal->destroyrefdir( rootctxt, "ref0" ) ) {
+      printf( "failed to destroy ref0 dir\n" );
+      return -1;
+   }
+   if ( mdal->unlink( rootctxt, "userfile" ) ) {
+      printf( "failed to unlink userfile\n" );
+      return -1;
+   }
+   if ( mdal->setdatausage( rootctxt, 0 ) ) {
+      printf( "failed to zero out root NS data usage\n" );
+      return -1;
+   }
+   if ( mdal->setinodeusage( rootctxt, 0 ) ) {
+      printf( "failed to zero out root NS inode usage\n" );
+      return -1;
+   }
+   if ( mdal->destroyctxt( rootctxt ) ) {
+      printf( "failed to destroy rootctxt\n" );
+      return -1;
+   }
+   if ( mdal->destroynamespace( mdal->ctxt, "/." ) ) {
+      printf( "failed to destroy the root NS reference tree\n" );
+      return -1;
+   }
+
+   // free the mdal itself
+   if ( mdal->cleanup( mdal ) ) {
+      printf( "failed to cleanup kv mdal\n" );
+      return -1;
+   }
+
+   // cleanup the store dir
+   remove_store();
+
+   return 0;
+}
@@ -7,6 +7,7 @@
  * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
  */
 
+#define _GNU_SOURCE // must precede all includes, as posix_mdal.c relies upon statx()
 #include <unistd.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -0,0 +1,715 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+/* ---------------------------------------------------------------------------
+
+This tool drives bulk rebuilds of erasure stripes following the loss of an
+entire cap or pod ( see also 'emerg_reb', which redirects the lost locations
+of a POSIX DAL prior to such a rebuild ).  All data access occurs through
+libne, and thus through the generic DAL interface, so any configured DAL type
+may be rebuilt.
+
+As the DAL interface offers no means of listing objects, the candidate
+objects are provided via an input list, with one object per line :
+
+   <pod> <cap> <scatter> <objID>
+
+The rebuild proceeds in two phases :
+
+   Survey   -- Every candidate object is stat'd, to determine its erasure
+               pattern and the number of blocks in error.  Healthy objects
+               are skipped.
+   Rebuild  -- Damaged objects are rebuilt in order of remaining redundancy
+               ( E - blocks in error ), such that the objects closest to data
+               loss are repaired first.  The number of rebuilds in flight
+               against any single device ( pod / block / cap ) is limited, so
+               that surviving devices are not overwhelmed.
+
+The outcome of every object is appended to a progress log as it completes :
+
+   <STATUS> <pod> <cap> <scatter> <objID>
+
+If the same progress log is provided to a later run, any object previously
+recorded as REBUILT or HEALTHY is skipped, allowing an interrupted bulk
+rebuild to be resumed.
+
+--------------------------------------------------------------------------- */
+
+#include "marfs_auto_config.h"
+#if defined(DEBUG_ALL) || defined(DEBUG_NE)
+#define DEBUG
+#endif
+#define preFMT "%s: "
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <libxml/tree.h>
+
+#include "ne.h"
+#include "dal/dal.h"
+#include "thread_queue.h"
+
+#define PROGNAME "bulk_reb"
+
+#define PRINTout(FMT, ...) fprintf(stdout, preFMT FMT, PROGNAME, ##__VA_ARGS__)
+#ifdef DEBUG
+#define PRINTdbg(FMT, ...) fprintf(stdout, preFMT FMT, PROGNAME, ##__VA_ARGS__)
+#else
+#define PRINTdbg(...)
+#endif
+
+#define DEFAULT_THREADS 8       // default number of survey/rebuild threads
+#define DEFAULT_DEVLIMIT 2      // default number of rebuilds in flight per device
+#define REBUILD_ATTEMPTS 4      // maximum ne_rebuild() calls per object
+#define MAX_LINE 8192           // maximum length of an object list / progress log line
+
+typedef enum {
+   OBJ_PENDING = 0,   // not yet processed
+   OBJ_HEALTHY,       // no errors found during survey
+   OBJ_DAMAGED,       // errors found during survey, awaiting rebuild
+   OBJ_REBUILT,       // successfully rebuilt
+   OBJ_FAILED,        // survey or rebuild failure
+   OBJ_DONE           // completed by a previous run
+} objstate;
+
+const char* state_names[] = { "PENDING", "HEALTHY", "DAMAGED", "REBUILT", "FAILED", "DONE" };
+
+typedef struct rebuild_object_struct {
+   char* objID;
+   ne_location loc;
+   ne_erasure epat;
+   int errcnt;       // number of blocks in error, as of the survey
+   size_t index;     // position within the object list
+   objstate state;
+   char dispatched;
+} rebuild_object;
+
+typedef struct scheduler_struct {
+   ne_ctxt ctxt;
+   int max_block;
+   pthread_mutex_t lock;
+   pthread_cond_t complete;  // signaled whenever a rebuild completes
+   int* devload;             // rebuilds in flight, per device
+   int caps;
+   int devlimit;
+   FILE* progress;
+   size_t inflight;
+} scheduler;
+
+// ---------------------- HELPER FUNCTIONS ----------------------
+
+/**
+ * Produce the progress log key of an object ( everything following the status field )
+ * @param rebuild_object* obj : Object to produce a key for
+ * @param char* buf : Buffer to be populated
+ * @param size_t len : Length of the buffer
+ * @return int : Zero on success, and -1 if the key was truncated
+ */
+int object_key(rebuild_object* obj, char* buf, size_t len) {
+   if (snprintf(buf, len, "%d %d %d %s", obj->loc.pod, obj->loc.cap, obj->loc.scatter, obj->objID) >= len) {
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Parse an object list file
+ * @param const char* path : Path of the object list
+ * @param size_t* count : Reference to be populated with the number of parsed objects
+ * @param ne_location* maxloc : Reference to be populated with the maximum location values of all objects
+ * @return rebuild_object* : Allocated array of objects, or NULL on failure
+ */
+rebuild_object* parse_object_list(const char* path, size_t* count, ne_location* maxloc) {
+   FILE* list = fopen(path, "r");
+   if (list == NULL) {
+      PRINTout("failed to open object list \"%s\" (%s)\n", path, strerror(errno));
+      return NULL;
+   }
+   size_t alloc = 1024;
+   size_t objcnt = 0;
+   rebuild_object* objects = malloc(sizeof(rebuild_object) * alloc);
+   if (objects == NULL) {
+      PRINTout("failed to allocate object list\n");
+      fclose(list);
+      return NULL;
+   }
+   maxloc->pod = 0;
+   maxloc->cap = 0;
+   maxloc->scatter = 0;
+   char line[MAX_LINE];
+   size_t lineno = 0;
+   while (fgets(line, MAX_LINE, list)) {
+      lineno++;
+      char* end = strchr(line, '\n');
+      if (end == NULL && !feof(list)) {
+         PRINTout("line %zu of object list exceeds max length of %d\n", lineno, MAX_LINE);
+         break;
+      }
+      if (end) {
+         *end = '\0';
+      }
+      if (*line == '\0' || *line == '#') {
+         continue; // skip blank lines and comments
+      }
+      int pod, cap, scatter, idoff = -1;
+      if (sscanf(line, "%d %d %d %n", &pod, &cap, &scatter, &idoff) != 3 || idoff < 0 || line[idoff] == '\0' ||
+          pod < 0 || cap < 0 || scatter < 0) {
+         PRINTout("failed to parse line %zu of object list: \"%s\"\n", lineno, line);
+         break;
+      }
+      if (objcnt == alloc) {
+         alloc *= 2;
+         rebuild_object* newobjs = realloc(objects, sizeof(rebuild_object) * alloc);
+         if (newobjs == NULL) {
+            PRINTout("failed to expand object list\n");
+            break;
+         }
+         objects = newobjs;
+      }
+      rebuild_object* obj = objects + objcnt;
+      bzero(obj, sizeof(rebuild_object));
+      obj->objID = strdup(line + idoff);
+      if (obj->objID == NULL) {
+         PRINTout("failed to duplicate object ID\n");
+         break;
+      }
+      obj->loc.pod = pod;
+      obj->loc.cap = cap;
+      obj->loc.scatter = scatter;
+      obj->index = objcnt;
+      if (pod > maxloc->pod) { maxloc->pod = pod; }
+      if (cap > maxloc->cap) { maxloc->cap = cap; }
+      if (scatter > maxloc->scatter) { maxloc->scatter = scatter; }
+      objcnt++;
+   }
+   if (!feof(list)) {
+      while (objcnt) {
+         objcnt--;
+         free(objects[objcnt].objID);
+      }
+      free(objects);
+      fclose(list);
+      return NULL;
+   }
+   fclose(list);
+   *count = objcnt;
+   return objects;
+}
+
+// comparison function for qsort/bsearch of progress log keys
+int strptrcmp(const void* a, const void* b) {
+   return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * Mark every object recorded as complete by a previous run's progress log
+ * @param const char* path : Path of the progress log
+ * @param rebuild_object* objects : Array of objects
+ * @param size_t count : Number of objects
+ * @return ssize_t : Number of objects marked as complete, or -1 on failure
+ */
+ssize_t apply_progress_log(const char* path, rebuild_object* objects, size_t count) {
+   FILE* log = fopen(path, "r");
+   if (log == NULL) {
+      if (errno == ENOENT) {
+         return 0; // no previous progress
+      }
+      PRINTout("failed to open progress log \"%s\" for read (%s)\n", path, strerror(errno));
+      return -1;
+   }
+   size_t alloc = 1024;
+   size_t keycnt = 0;
+   char** keys = malloc(sizeof(char*) * alloc);
+   if (keys == NULL) {
+      PRINTout("failed to allocate progress key list\n");
+      fclose(log);
+      return -1;
+   }
+   char line[MAX_LINE];
+   ssize_t retval = 0;
+   while (fgets(line, MAX_LINE, log)) {
+      char* end = strchr(line, '\n');
+      if (end == NULL) {
+         // likely an incomplete record, produced by an interrupted run
+         continue;
+      }
+      *end = '\0';
+      char* key = strchr(line, ' ');
+      if (key == NULL) {
+         continue;
+      }
+      *key = '\0';
+      key++;
+      if (strcmp(line, state_names[OBJ_REBUILT]) && strcmp(line, state_names[OBJ_HEALTHY])) {
+         continue; // only skip objects which do not require further work
+      }
+      if (keycnt == alloc) {
+         alloc *= 2;
+         char** newkeys = realloc(keys, sizeof(char*) * alloc);
+         if (newkeys == NULL) {
+            PRINTout("failed to expand progress key list\n");
+            retval = -1;
+            break;
+         }
+         keys = newkeys;
+      }
+      if ((keys[keycnt] = strdup(key)) == NULL) {
+         PRINTout("failed to duplicate progress key\n");
+         retval = -1;
+         break;
+      }
+      keycnt++;
+   }
+   fclose(log);
+   if (retval == 0 && keycnt) {
+      qsort(keys, keycnt, sizeof(char*), strptrcmp);
+      size_t index;
+      for (index = 0; index < count; index++) {
+         char keybuf[MAX_LINE];
+         char* keyref = keybuf;
+         if (object_key(objects + index, keybuf, MAX_LINE) == 0 &&
+             bsearch(&keyref, keys, keycnt, sizeof(char*), strptrcmp)) {
+            objects[index].state = OBJ_DONE;
+            retval++;
+         }
+      }
+   }
+   while (keycnt) {
+      keycnt--;
+      free(keys[keycnt]);
+   }
+   free(keys);
+   return retval;
+}
+
+/**
+ * Record the outcome of an object to the progress log ( scheduler lock must be held )
+ * @param scheduler* sched : Scheduler reference
+ * @param rebuild_object* obj : Object to record
+ */
+void record_progress(scheduler* sched, rebuild_object* obj) {
+   char keybuf[MAX_LINE];
+   if (object_key(obj, keybuf, MAX_LINE)) {
+      PRINTout("object key of \"%s\" is too long to be recorded\n", obj->objID);
+      return;
+   }
+   if (fprintf(sched->progress, "%s %s\n", state_names[obj->state], keybuf) < 0 || fflush(sched->progress)) {
+      PRINTout("failed to record progress of object \"%s\" (%s)\n", obj->objID, strerror(errno));
+   }
+}
+
+/**
+ * Identify the device load counter of a given block of an object
+ * @param scheduler* sched : Scheduler reference
+ * @param rebuild_object* obj : Object reference
+ * @param int block : Block index of the object
+ * @return int* : Reference to the device load counter
+ */
+int* device_load(scheduler* sched, rebuild_object* obj, int block) {
+   int devblock = (block + obj->epat.O) % (obj->epat.N + obj->epat.E);
+   return sched->devload + (((obj->loc.pod * sched->caps) + obj->loc.cap) * sched->max_block) + devblock;
+}
+
+// comparison function to order objects by remaining redundancy, then by list position
+int redundancy_cmp(const void* a, const void* b) {
+   const rebuild_object* obja = (const rebuild_object*)a;
+   const rebuild_object* objb = (const rebuild_object*)b;
+   int reda = obja->epat.E - obja->errcnt;
+   int redb = objb->epat.E - objb->errcnt;
+   if (reda != redb) {
+      return (reda < redb) ? -1 : 1;
+   }
+   if (obja->index != objb->index) {
+      return (obja->index < objb->index) ? -1 : 1;
+   }
+   return 0;
+}
+
+// ---------------------- THREAD BEHAVIOR ----------------------
+
+int bulk_thread_init(unsigned int tID, void* global_state, void** state) {
+   *state = global_state;
+   return 0;
+}
+
+/**
+ * Stat an object, populating its erasure pattern and error count
+ */
+int bulk_survey_consume(void** state, void** work_todo) {
+   scheduler* sched = (scheduler*)(*state);
+   rebuild_object* obj = (rebuild_object*)(*work_todo);
+   char* meta_status = calloc(sched->max_block, sizeof(char));
+   char* data_status = calloc(sched->max_block, sizeof(char));
+   ne_state nstate = { .meta_status = meta_status, .data_status = data_status, .csum = NULL };
+   ne_handle handle = NULL;
+   if (meta_status == NULL || data_status == NULL) {
+      PRINTout("failed to allocate status arrays for object \"%s\"\n", obj->objID);
+      obj->state = OBJ_FAILED;
+   }
+   else if ((handle = ne_stat(sched->ctxt, obj->objID, obj->loc)) == NULL) {
+      PRINTout("failed to stat object \"%s\" (%s)\n", obj->objID, strerror(errno));
+      obj->state = OBJ_FAILED;
+   }
+   else if (ne_get_info(handle, &(obj->epat), &nstate) < 0) {
+      PRINTout("failed to retrieve info of object \"%s\" (%s)\n", obj->objID, strerror(errno));
+      obj->state = OBJ_FAILED;
+      // ne_stat() produces an unusable handle for inconsistent meta info, which cannot safely be closed
+      handle = NULL;
+   }
+   else if (obj->epat.N + obj->epat.E > sched->max_block) {
+      PRINTout("stripe width of object \"%s\" ( %d ) exceeds max block value of %d\n",
+               obj->objID, obj->epat.N + obj->epat.E, sched->max_block);
+      obj->state = OBJ_FAILED;
+   }
+   else {
+      int block;
+      for (block = 0; block < obj->epat.N + obj->epat.E; block++) {
+         if (meta_status[block] || data_status[block]) {
+            obj->errcnt++;
+         }
+      }
+      obj->state = (obj->errcnt) ? OBJ_DAMAGED : OBJ_HEALTHY;
+      if (obj->errcnt > obj->epat.E) {
+         PRINTout("object \"%s\" has %d blocks in error, exceeding its erasure count of %d\n",
+                  obj->objID, obj->errcnt, obj->epat.E);
+         obj->state = OBJ_FAILED;
+      }
+   }
+   if (handle) {
+      ne_close(handle, NULL, NULL); // errors are expected for damaged objects
+   }
+   free(data_status);
+   free(meta_status);
+   if (obj->state != OBJ_DAMAGED) {
+      pthread_mutex_lock(&(sched->lock));
+      record_progress(sched, obj);
+      pthread_mutex_unlock(&(sched->lock));
+   }
+   *work_todo = NULL;
+   return 0;
+}
+
+/**
+ * Rebuild an object, then release its device reservations
+ */
+int bulk_rebuild_consume(void** state, void** work_todo) {
+   scheduler* sched = (scheduler*)(*state);
+   rebuild_object* obj = (rebuild_object*)(*work_todo);
+   obj->state = OBJ_FAILED;
+   ne_handle handle = ne_open(sched->ctxt, obj->objID, obj->loc, obj->epat, NE_REBUILD);
+   if (handle == NULL) {
+      PRINTout("failed to open rebuild handle for object \"%s\" (%s)\n", obj->objID, strerror(errno));
+   }
+   else {
+      int attempts = 0;
+      int rebuildres;
+      while ((rebuildres = ne_rebuild(handle, NULL, NULL)) > 0 && attempts < REBUILD_ATTEMPTS) {
+         attempts++;
+      }
+      if (rebuildres) {
+         PRINTout("failed to rebuild object \"%s\" ( result = %d )\n", obj->objID, rebuildres);
+         ne_abort(handle);
+      }
+      else if (ne_close(handle, NULL, NULL)) {
+         PRINTout("errors remain after rebuild of object \"%s\"\n", obj->objID);
+      }
+      else {
+         obj->state = OBJ_REBUILT;
+      }
+   }
+   pthread_mutex_lock(&(sched->lock));
+   int block;
+   for (block = 0; block < obj->epat.N + obj->epat.E; block++) {
+      (*device_load(sched, obj, block))--;
+   }
+   sched->inflight--;
+   record_progress(sched, obj);
+   pthread_cond_broadcast(&(sched->complete));
+   pthread_mutex_unlock(&(sched->lock));
+   *work_todo = NULL;
+   return 0;
+}
+
+void bulk_thread_term(void** state, void** prev_work, TQ_Control_Flags flg) {
+   return;
+}
+
+/**
+ * Run every one of the given objects through a consumer function, via a ThreadQueue
+ * @param scheduler* sched : Scheduler reference
+ * @param int threads : Number of threads to utilize
+ * @param int (*consume)(void**, void**) : Consumer function
+ * @param rebuild_object* objects : Array of objects
+ * @param size_t count : Number of objects
+ * @param char throttle : If non-zero, only process OBJ_DAMAGED objects, in order, and subject to device limits;
+ *                        otherwise, process every OBJ_PENDING object
+ * @return int : Zero on success, and -1 on failure
+ */
+int process_objects(scheduler* sched, int threads, int (*consume)(void**, void**),
+                    rebuild_object* objects, size_t count, char throttle) {
+   TQ_Init_Opts tqopts = {0};
+   tqopts.log_prefix = (throttle) ? "BulkRebuild" : "BulkSurvey";
+   tqopts.init_flags = TQ_NONE;
+   tqopts.max_qdepth = threads * 2;
+   tqopts.global_state = (void*)sched;
+   tqopts.num_threads = threads;
+   tqopts.num_prod_threads = 0;
+   tqopts.thread_init_func = bulk_thread_init;
+   tqopts.thread_consumer_func = consume;
+   tqopts.thread_term_func = bulk_thread_term;
+   ThreadQueue tq = tq_init(&tqopts);
+   if (tq == NULL) {
+      PRINTout("failed to initialize thread queue\n");
+      return -1;
+   }
+   if (tq_check_init(tq)) {
+      PRINTout("failed to initialize thread queue threads\n");
+      tq_set_flags(tq, TQ_ABORT);
+      while (tq_next_thread_status(tq, NULL) > 0) {}
+      tq_close(tq);
+      return -1;
+   }
+   int retval = 0;
+   size_t first = 0; // first object not yet dispatched
+   while (first < count) {
+      rebuild_object* obj = NULL;
+      if (!throttle) {
+         obj = objects + first;
+         first++;
+         if (obj->state != OBJ_PENDING) {
+            continue;
+         }
+      }
+      else {
+         pthread_mutex_lock(&(sched->lock));
+         // skip any leading objects which require no further scheduling
+         while (first < count && (objects[first].dispatched || objects[first].state != OBJ_DAMAGED)) {
+            first++;
+         }
+         // locate the most at-risk object whose devices all have capacity remaining
+         size_t index;
+         for (index = first; index < count && obj == NULL; index++) {
+            rebuild_object* cand = objects + index;
+            if (cand->dispatched || cand->state != OBJ_DAMAGED) {
+               continue;
+            }
+            int block;
+            for (block = 0; block < cand->epat.N + cand->epat.E; block++) {
+               if (*device_load(sched, cand, block) >= sched->devlimit) {
+                  break;
+               }
+            }
+            if (block == cand->epat.N + cand->epat.E) {
+               obj = cand;
+            }
+         }
+         if (obj == NULL) {
+            // wait for some in-flight rebuild to release its devices
+            if (first < count && sched->inflight) {
+               pthread_cond_wait(&(sched->complete), &(sched->lock));
+            }
+            pthread_mutex_unlock(&(sched->lock));
+            continue;
+         }
+         int block;
+         for (block = 0; block < obj->epat.N + obj->epat.E; block++) {
+            (*device_load(sched, obj, block))++;
+         }
+         obj->dispatched = 1;
+         sched->inflight++;
+         pthread_mutex_unlock(&(sched->lock));
+      }
+      if (tq_enqueue(tq, TQ_NONE, (void*)obj)) {
+         PRINTout("failed to enqueue object \"%s\"\n", obj->objID);
+         retval = -1;
+         break;
+      }
+   }
+   if (retval) {
+      tq_set_flags(tq, TQ_ABORT);
+   }
+   else if (tq_set_flags(tq, TQ_FINISHED)) {
+      PRINTout("failed to set a FINISHED state on thread queue\n");
+      tq_set_flags(tq, TQ_ABORT);
+      retval = -1;
+   }
+   while (tq_next_thread_status(tq, NULL) > 0) {}
+   if (tq_close(tq) > 0) {
+      // only possible following an abort, so just drop any remaining work
+      while (tq_dequeue(tq, TQ_ABORT, NULL) > 0) {}
+      tq_close(tq);
+   }
+   return retval;
+}
+
+// ---------------------- MAIN ----------------------
+
+void print_usage() {
+   PRINTout("Usage info --\n");
+   PRINTout("%s -c config_spec -l object_list -r progress_log -b max_block [-t threads] [-d device_limit] [-s]\n", PROGNAME);
+   PRINTout("   -c config_spec  : Specifies a XML file containing the DAL configuration. config_spec is of the form\n");
+   PRINTout("                       \"<file_path>:/<tag>[ <attribute>=<value> ]/...\" where the series of tags form a path through the\n");
+   PRINTout("                       configuration file to the DAL configuration node.\n");
+   PRINTout("   -l object_list  : File listing candidate objects, one \"<pod> <cap> <scatter> <objID>\" per line\n");
+   PRINTout("   -r progress_log : File to which per-object progress is appended ( completed objects from a previous run are skipped )\n");
+   PRINTout("   -b max_block    : Maximum stripe width ( N + E ) of any object\n");
+   PRINTout("   -t threads      : Number of survey/rebuild threads ( default = %d )\n", DEFAULT_THREADS);
+   PRINTout("   -d device_limit : Maximum number of rebuilds in flight against any one device ( default = %d )\n", DEFAULT_DEVLIMIT);
+   PRINTout("   -s              : Survey only; print the rebuild order, without rebuilding anything\n");
+   PRINTout("   -h              : Print this usage info\n");
+}
+
+int main(int argc, char** argv) {
+   char* config_spec = NULL;
+   char* list_path = NULL;
+   char* log_path = NULL;
+   int max_block = 0;
+   int threads = DEFAULT_THREADS;
+   int devlimit = DEFAULT_DEVLIMIT;
+   char survey_only = 0;
+
+   int c;
+   while ((c = getopt(argc, argv, "c:l:r:b:t:d:sh")) != -1) {
+      switch (c) {
+         case 'c':
+            config_spec = optarg;
+            break;
+         case 'l':
+            list_path = optarg;
+            break;
+         case 'r':
+            log_path = optarg;
+            break;
+         case 'b':
+            max_block = atoi(optarg);
+            break;
+         case 't':
+            threads = atoi(optarg);
+            break;
+         case 'd':
+            devlimit = atoi(optarg);
+            break;
+         case 's':
+            survey_only = 1;
+            break;
+         case 'h':
+            print_usage();
+            return 0;
+         default:
+            print_usage();
+            return -1;
+      }
+   }
+   if (config_spec == NULL || list_path == NULL || log_path == NULL || max_block <= 0 || threads <= 0 || devlimit <= 0) {
+      PRINTout("missing or invalid arguments\n");
+      print_usage();
+      return -1;
+   }
+
+   // parse our object list and apply any previous progress
+   size_t count = 0;
+   ne_location maxloc;
+   rebuild_object* objects = parse_object_list(list_path, &count, &maxloc);
+   if (objects == NULL) {
+      PRINTout("failed to parse object list \"%s\"\n", list_path);
+      return -1;
+   }
+   ssize_t prevdone = apply_progress_log(log_path, objects, count);
+   if (prevdone < 0) {
+      PRINTout("failed to apply previous progress log \"%s\"\n", log_path);
+      return -1;
+   }
+   PRINTout("%zu candidate objects ( %zd completed by a previous run )\n", count, prevdone);
+
+   // initialize our scheduler
+   scheduler sched;
+   bzero(&sched, sizeof(scheduler));
+   xmlDoc* doc = NULL;
+   xmlNode* dalnode = find_dal_config(config_spec, &doc);
+   if (dalnode == NULL) {
+      PRINTout("failed to locate DAL definition in \"%s\" (%s)\n", config_spec, strerror(errno));
+      return -1;
+   }
+   sched.ctxt = ne_init(dalnode, maxloc, max_block, NULL);
+   xmlFreeDoc(doc);
+   xmlCleanupParser();
+   if (sched.ctxt == NULL) {
+      PRINTout("failed to initialize ne_ctxt (%s)\n", strerror(errno));
+      return -1;
+   }
+   sched.max_block = max_block;
+   sched.caps = maxloc.cap + 1;
+   sched.devlimit = devlimit;
+   sched.devload = calloc((size_t)(maxloc.pod + 1) * sched.caps * max_block, sizeof(int));
+   if (sched.devload == NULL || pthread_mutex_init(&(sched.lock), NULL) || pthread_cond_init(&(sched.complete), NULL)) {
+      PRINTout("failed to initialize scheduler state\n");
+      return -1;
+   }
+   sched.progress = fopen(log_path, "a");
+   if (sched.progress == NULL) {
+      PRINTout("failed to open progress log \"%s\" (%s)\n", log_path, strerror(errno));
+      return -1;
+   }
+
+   // survey all remaining objects
+   if (process_objects(&sched, threads, bulk_survey_consume, objects, count, 0)) {
+      PRINTout("failed to survey objects\n");
+      return -1;
+   }
+
+   // order damaged objects by remaining redundancy
+   qsort(objects, count, sizeof(rebuild_object), redundancy_cmp);
+   size_t counts[OBJ_DONE + 1] = {0};
+   size_t index;
+   for (index = 0; index < count; index++) {
+      counts[objects[index].state]++;
+   }
+   PRINTout("survey complete : %zu healthy, %zu damaged, %zu failed\n",
+            counts[OBJ_HEALTHY], counts[OBJ_DAMAGED], counts[OBJ_FAILED]);
+   if (survey_only) {
+      for (index = 0; index < count; index++) {
+         rebuild_object* obj = objects + index;
+         if (obj->state == OBJ_DAMAGED) {
+            PRINTout("   redundancy %d ( %d of %d+%d blocks in error ) : %d %d %d %s\n",
+                     obj->epat.E - obj->errcnt, obj->errcnt, obj->epat.N, obj->epat.E,
+                     obj->loc.pod, obj->loc.cap, obj->loc.scatter, obj->objID);
+         }
+      }
+   }
+   else if (counts[OBJ_DAMAGED]) {
+      // rebuild all damaged objects
+      if (process_objects(&sched, threads, bulk_rebuild_consume, objects, count, 1)) {
+         PRINTout("failed to rebuild objects\n");
+         return -1;
+      }
+      bzero(counts, sizeof(counts));
+      for (index = 0; index < count; index++) {
+         counts[objects[index].state]++;
+      }
+      PRINTout("rebuild complete : %zu rebuilt, %zu failed\n", counts[OBJ_REBUILT], counts[OBJ_FAILED]);
+   }
+
+   // cleanup
+   fsync(fileno(sched.progress));
+   fclose(sched.progress);
+   pthread_cond_destroy(&(sched.complete));
+   pthread_mutex_destroy(&(sched.lock));
+   free(sched.devload);
+   ne_term(sched.ctxt);
+   for (index = 0; index < count; index++) {
+      free(objects[index].objID);
+   }
+   free(objects);
+
+   return (counts[OBJ_FAILED]) ? 1 : 0;
+}
@@ -0,0 +1,575 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+/* ---------------------------------------------------------------------------
+
+This tool benchmarks the complete libne data path ( ioqueues, CRCs, thread
+queues and erasure coding ) by driving ne_write(), ne_read() and ne_rebuild()
+against generated DAL configurations, sweeping every combination of :
+
+   DAL type        -- 'noop' ( no storage at all, isolating libne overhead )
+                      and/or 'posix' ( rooted at a, preferably tmpfs, dir )
+   N / E / partsz  -- erasure pattern of the benchmark objects
+   iosz            -- size of each ne_write() / ne_read() call
+   threads         -- number of concurrently accessed objects
+   degraded        -- number of data blocks removed prior to reading and
+                      rebuilding ( posix only, as noop has no block identity )
+   numa            -- NUMA placement of each handle ( 'none', 'balance' or a
+                      node number, see the DAL 'numa' attribute )
+
+One CSV line is output per combination and operation :
+
+   dal,numa,op,N,E,partsz,iosz,threads,degraded,bytes,seconds,GBps,cpu_s_per_GB,
+      lat_p50_us,lat_p99_us,lat_p999_us,lat_max_us
+
+Throughput is aggregate across all threads, CPU time includes all libne
+threads of this process, and latencies are those of individual
+ne_write() / ne_read() calls ( or of entire ne_rebuild() operations ).
+
+--------------------------------------------------------------------------- */
+
+#include "marfs_auto_config.h"
+#if defined(DEBUG_ALL) || defined(DEBUG_NE)
+#define DEBUG
+#endif
+#define preFMT "%s: "
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <libxml/tree.h>
+#include <libxml/parser.h>
+
+#include "ne.h"
+
+#define PROGNAME "erasureBench"
+
+// NOTE -- CSV output may go to stdout, so all messages go to stderr
+#define PRINTout(FMT, ...) fprintf(stderr, preFMT FMT, PROGNAME, ##__VA_ARGS__)
+#ifdef DEBUG
+#define PRINTdbg(FMT, ...) fprintf(stderr, preFMT FMT, PROGNAME, ##__VA_ARGS__)
+#else
+#define PRINTdbg(...)
+#endif
+
+#define MAX_SWEEP 32            // maximum number of values for any swept parameter
+#define BLOCK_TEMPLATE "blk{b}." // posix DAL block file prefix ( followed by the objID )
+#define CSV_HEADER "dal,numa,op,N,E,partsz,iosz,threads,degraded,bytes,seconds,GBps,cpu_s_per_GB,lat_p50_us,lat_p99_us,lat_p999_us,lat_max_us\n"
+
+typedef enum {
+   BENCH_WRITE = 0,
+   BENCH_READ,
+   BENCH_REBUILD
+} bench_op;
+
+const char* op_names[] = { "write", "read", "rebuild" };
+
+typedef struct sweep_struct {
+   size_t values[MAX_SWEEP];
+   int count;
+} sweep;
+
+typedef struct bench_run_struct {
+   // shared values
+   ne_ctxt ctxt;
+   const char* numa;     // NUMA placement ( for output only )
+   ne_erasure epat;
+   bench_op op;
+   size_t iosz;
+   size_t objsize;
+   int objects;          // objects per thread
+   pthread_barrier_t start;
+   // per-thread values
+   double** lat;         // per-thread latency values ( us )
+   size_t* latcnt;       // per-thread latency counts
+   int* failures;        // per-thread failure counts
+} bench_run;
+
+typedef struct bench_thread_struct {
+   bench_run* run;
+   int tID;
+} bench_thread;
+
+// ---------------------- HELPER FUNCTIONS ----------------------
+
+/**
+ * Parse a comma-separated list of sizes ( with optional K/M/G suffixes )
+ * @param const char* str : String to be parsed
+ * @param sweep* tgt : Sweep to be populated
+ * @return int : Zero on success, or -1 on failure
+ */
+int parse_sweep(const char* str, sweep* tgt) {
+   tgt->count = 0;
+   while (*str != '\0') {
+      if (tgt->count >= MAX_SWEEP) {
+         PRINTout("too many sweep values ( max = %d )\n", MAX_SWEEP);
+         return -1;
+      }
+      char* endptr = NULL;
+      unsigned long long value = strtoull(str, &endptr, 10);
+      if (endptr == str) {
+         PRINTout("failed to parse sweep value: \"%s\"\n", str);
+         return -1;
+      }
+      if (*endptr == 'K') { value *= 1024ULL; endptr++; }
+      else if (*endptr == 'M') { value *= 1048576ULL; endptr++; }
+      else if (*endptr == 'G') { value *= 1073741824ULL; endptr++; }
+      if (*endptr != ',' && *endptr != '\0') {
+         PRINTout("unexpected character in sweep value: \"%s\"\n", str);
+         return -1;
+      }
+      tgt->values[tgt->count] = (size_t)value;
+      tgt->count++;
+      str = (*endptr == ',') ? endptr + 1 : endptr;
+   }
+   if (tgt->count == 0) {
+      PRINTout("received an empty sweep list\n");
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Current monotonic time, in microseconds
+ * @return double : Current time
+ */
+double now_us() {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((double)ts.tv_sec * 1e6) + ((double)ts.tv_nsec / 1e3);
+}
+
+/**
+ * Total CPU time ( user + system ) consumed by all threads of this process
+ * @return double : CPU time, in seconds
+ */
+double cpu_seconds() {
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage)) { return 0.0; }
+   return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+          ((double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+}
+
+int compare_double(const void* a, const void* b) {
+   double da = *(const double*)a;
+   double db = *(const double*)b;
+   return (da > db) - (da < db);
+}
+
+/**
+ * Initialize a ne_ctxt, based on a generated DAL configuration
+ * @param const char* dal : Type of DAL ( "noop" or "posix" )
+ * @param const char* root : Root dir of the posix DAL
+ * @param ne_erasure epat : Erasure pattern to be benchmarked
+ * @param size_t objsize : Size of benchmark objects
+ * @param const char* numa : NUMA placement of handles ( "none", or a DAL 'numa' attribute value )
+ * @return ne_ctxt : New ne_ctxt, or NULL on failure
+ */
+ne_ctxt bench_init(const char* dal, const char* root, ne_erasure epat, size_t objsize, const char* numa) {
+   char numaattr[128] = "";
+   if (strcmp(numa, "none")) {
+      snprintf(numaattr, sizeof(numaattr), " numa=\"%s\"", numa);
+   }
+   char config[4096];
+   int len;
+   if (strcmp(dal, "noop") == 0) {
+      // the noop DAL must know the object structure to produce valid read data
+      len = snprintf(config, sizeof(config), "<DAL type=\"noop\"%s><N>%d</N><E>%d</E><PSZ>%zu</PSZ><max_size>%zu</max_size></DAL>",
+                     numaattr, epat.N, epat.E, epat.partsz, objsize);
+   }
+   else if (strcmp(dal, "posix") == 0) {
+      len = snprintf(config, sizeof(config), "<DAL type=\"posix\"%s><dir_template>%s</dir_template><sec_root>%s</sec_root></DAL>",
+                     numaattr, BLOCK_TEMPLATE, root);
+   }
+   else {
+      PRINTout("unsupported DAL type: \"%s\"\n", dal);
+      return NULL;
+   }
+   if (len < 0 || len >= sizeof(config)) {
+      PRINTout("failed to generate DAL config\n");
+      return NULL;
+   }
+
+   xmlDoc* doc = xmlReadMemory(config, len, NULL, NULL, XML_PARSE_NOBLANKS);
+   if (doc == NULL) {
+      PRINTout("failed to parse generated DAL config\n");
+      return NULL;
+   }
+   ne_location maxloc = { .pod = 0, .cap = 0, .scatter = 0 };
+   ne_ctxt ctxt = ne_init(xmlDocGetRootElement(doc), maxloc, epat.N + epat.E, NULL);
+   xmlFreeDoc(doc);
+   if (ctxt == NULL) {
+      PRINTout("failed to initialize ne_ctxt for \"%s\" DAL (%s)\n", dal, strerror(errno));
+   }
+   return ctxt;
+}
+
+/**
+ * Remove the first 'degraded' blocks of every benchmark object from a posix DAL root
+ * @param const char* root : Root dir of the posix DAL
+ * @param int threads : Number of threads ( and thus objects per object index )
+ * @param int objects : Number of objects per thread
+ * @param int degraded : Number of blocks to remove
+ * @return int : Zero on success, or -1 on failure
+ */
+int degrade_objects(const char* root, int threads, int objects, int degraded) {
+   char path[4096];
+   for (int tID = 0; tID < threads; tID++) {
+      for (int obj = 0; obj < objects; obj++) {
+         for (int block = 0; block < degraded; block++) {
+            snprintf(path, sizeof(path), "%s/blk%d.bench.t%d.o%d", root, block, tID, obj);
+            if (unlink(path)) {
+               PRINTout("failed to remove block file \"%s\" (%s)\n", path, strerror(errno));
+               return -1;
+            }
+            strncat(path, ".meta", sizeof(path) - strlen(path) - 1);
+            if (unlink(path)) {
+               PRINTout("failed to remove block meta file \"%s\" (%s)\n", path, strerror(errno));
+               return -1;
+            }
+         }
+      }
+   }
+   return 0;
+}
+
+// ---------------------- BENCHMARK THREAD ----------------------
+
+void* bench_thread_main(void* arg) {
+   bench_thread* bthread = (bench_thread*)arg;
+   bench_run* run = bthread->run;
+   int tID = bthread->tID;
+   ne_location loc = { .pod = 0, .cap = 0, .scatter = 0 };
+   double* lat = run->lat[tID];
+   size_t latcnt = 0;
+   int failures = 0;
+
+   void* iobuf = NULL;
+   if (run->op != BENCH_REBUILD) {
+      iobuf = malloc(run->iosz);
+      if (iobuf == NULL) { failures++; }
+      else {
+         // fill with a non-trivial pattern, to avoid any zero-page shortcuts
+         for (size_t pos = 0; pos < run->iosz; pos++) { ((unsigned char*)iobuf)[pos] = (unsigned char)(pos * 31 + tID); }
+      }
+   }
+
+   pthread_barrier_wait(&run->start);
+
+   char objID[64];
+   for (int obj = 0; obj < run->objects && !failures; obj++) {
+      snprintf(objID, sizeof(objID), "bench.t%d.o%d", tID, obj);
+      if (run->op == BENCH_REBUILD) {
+         double begin = now_us();
+         ne_handle handle = ne_open(run->ctxt, objID, loc, run->epat, NE_REBUILD);
+         if (handle == NULL) { PRINTout("failed to open rebuild handle for \"%s\"\n", objID); failures++; break; }
+         int rebuildres = ne_rebuild(handle, NULL, NULL);
+         if (rebuildres) { PRINTout("ne_rebuild of \"%s\" returned %d\n", objID, rebuildres); failures++; }
+         if (ne_close(handle, NULL, NULL) < 0) { PRINTout("failed to close rebuild handle for \"%s\"\n", objID); failures++; }
+         lat[latcnt++] = now_us() - begin;
+         continue;
+      }
+
+      ne_handle handle = ne_open(run->ctxt, objID, loc, run->epat, (run->op == BENCH_WRITE) ? NE_WRALL : NE_RDONLY);
+      if (handle == NULL) { PRINTout("failed to open handle for \"%s\"\n", objID); failures++; break; }
+      size_t remaining = run->objsize;
+      while (remaining) {
+         size_t iosz = (remaining < run->iosz) ? remaining : run->iosz;
+         double begin = now_us();
+         ssize_t iores = (run->op == BENCH_WRITE) ? ne_write(handle, iobuf, iosz) : ne_read(handle, iobuf, iosz);
+         lat[latcnt++] = now_us() - begin;
+         if (iores != iosz) {
+            PRINTout("unexpected %s result for \"%s\": %zd\n", op_names[run->op], objID, iores);
+            failures++;
+            break;
+         }
+         remaining -= iosz;
+      }
+      if (ne_close(handle, NULL, NULL) < 0) { PRINTout("failed to close handle for \"%s\"\n", objID); failures++; }
+   }
+
+   if (iobuf) { free(iobuf); }
+   run->latcnt[tID] = latcnt;
+   run->failures[tID] = failures;
+   return NULL;
+}
+
+/**
+ * Perform a single benchmark operation across all threads and output its CSV line
+ * @param bench_run* run : Run definition
+ * @param int threads : Number of threads
+ * @param const char* dal : DAL type name ( for output only )
+ * @param int degraded : Degraded block count ( for output only )
+ * @param FILE* out : CSV output stream
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_execute(bench_run* run, int threads, const char* dal, int degraded, FILE* out) {
+   size_t iocnt = (run->op == BENCH_REBUILD) ? 1 : ((run->objsize + run->iosz - 1) / run->iosz);
+   if (iocnt == 0) { iocnt = 1; }
+   int retval = 0;
+   pthread_t* tids = calloc(threads, sizeof(pthread_t));
+   bench_thread* targs = calloc(threads, sizeof(bench_thread));
+   run->lat = calloc(threads, sizeof(double*));
+   run->latcnt = calloc(threads, sizeof(size_t));
+   run->failures = calloc(threads, sizeof(int));
+   if (tids == NULL || targs == NULL || run->lat == NULL || run->latcnt == NULL || run->failures == NULL) {
+      PRINTout("failed to allocate thread state\n");
+      return -1;
+   }
+   for (int tID = 0; tID < threads; tID++) {
+      run->lat[tID] = calloc(iocnt * run->objects, sizeof(double));
+      if (run->lat[tID] == NULL) {
+         PRINTout("failed to allocate latency buffer\n");
+         return -1;
+      }
+   }
+   pthread_barrier_init(&run->start, NULL, threads + 1);
+
+   int started = 0;
+   for (; started < threads; started++) {
+      targs[started].run = run;
+      targs[started].tID = started;
+      if (pthread_create(tids + started, NULL, bench_thread_main, targs + started)) {
+         PRINTout("failed to create benchmark thread %d\n", started);
+         retval = -1;
+         break;
+      }
+   }
+   if (retval) {
+      // started threads are stuck at a barrier which can never be satisfied
+      exit(-1);
+   }
+
+   double cpubegin = cpu_seconds();
+   pthread_barrier_wait(&run->start);
+   double begin = now_us();
+   for (int tID = 0; tID < threads; tID++) { pthread_join(tids[tID], NULL); }
+   double elapsed = (now_us() - begin) / 1e6;
+   double cpu = cpu_seconds() - cpubegin;
+   pthread_barrier_destroy(&run->start);
+
+   // merge all latencies
+   size_t totlat = 0;
+   for (int tID = 0; tID < threads; tID++) {
+      if (run->failures[tID]) { retval = -1; }
+      totlat += run->latcnt[tID];
+   }
+   double* merged = calloc(totlat + 1, sizeof(double));
+   if (merged == NULL) {
+      PRINTout("failed to allocate latency buffer\n");
+      return -1;
+   }
+   size_t pos = 0;
+   for (int tID = 0; tID < threads; tID++) {
+      memcpy(merged + pos, run->lat[tID], run->latcnt[tID] * sizeof(double));
+      pos += run->latcnt[tID];
+      free(run->lat[tID]);
+   }
+   qsort(merged, totlat, sizeof(double), compare_double);
+
+   if (retval == 0) {
+      double bytes = (double)run->objsize * run->objects * threads;
+      double gb = bytes / 1e9;
+      #define PCT(P) ((totlat) ? merged[(size_t)((double)(totlat - 1) * (P))] : 0.0)
+      fprintf(out, "%s,%s,%s,%d,%d,%zu,%zu,%d,%d,%.0f,%.6f,%.4f,%.4f,%.1f,%.1f,%.1f,%.1f\n",
+              dal, run->numa, op_names[run->op], run->epat.N, run->epat.E, run->epat.partsz, run->iosz, threads, degraded,
+              bytes, elapsed, (elapsed > 0.0) ? gb / elapsed : 0.0, (gb > 0.0) ? cpu / gb : 0.0,
+              PCT(0.50), PCT(0.99), PCT(0.999), (totlat) ? merged[totlat - 1] : 0.0);
+      #undef PCT
+      fflush(out);
+   }
+   else {
+      PRINTout("%s benchmark failed ( %s, numa=%s, N=%d, E=%d, partsz=%zu, iosz=%zu, threads=%d, degraded=%d )\n",
+               op_names[run->op], dal, run->numa, run->epat.N, run->epat.E, run->epat.partsz, run->iosz, threads, degraded);
+   }
+
+   free(merged);
+   free(run->failures);
+   free(run->latcnt);
+   free(run->lat);
+   free(targs);
+   free(tids);
+   return retval;
+}
+
+// ---------------------- MAIN ----------------------
+
+void print_usage() {
+   PRINTout("Usage info --\n");
+   PRINTout("%s [-D dals] [-r root] [-N list] [-E list] [-p list] [-i list] [-t list] [-d list] [-n list] [-s objsize] [-c objects] [-o csv]\n", PROGNAME);
+   PRINTout("   All 'list' values are comma-separated, accepting K/M/G suffixes, and every combination is benchmarked\n");
+   PRINTout("   -D dals    : Comma-separated DAL types, from \"noop\" and \"posix\" ( default = noop,posix )\n");
+   PRINTout("   -r root    : Root dir of the posix DAL, which should be tmpfs to measure libne alone\n");
+   PRINTout("                ( default = /dev/shm/%s.<pid>, created and removed by this program )\n", PROGNAME);
+   PRINTout("   -N list    : Data block counts ( default = 10 )\n");
+   PRINTout("   -E list    : Erasure block counts ( default = 2 )\n");
+   PRINTout("   -p list    : Part sizes ( default = 64K )\n");
+   PRINTout("   -i list    : Sizes of individual ne_write() / ne_read() calls ( default = 1M )\n");
+   PRINTout("   -t list    : Thread counts, each accessing distinct objects ( default = 1 )\n");
+   PRINTout("   -d list    : Degraded data block counts for read/rebuild, ignored for noop ( default = 0 )\n");
+   PRINTout("   -n list    : NUMA placements, from \"none\", \"balance\" and node numbers ( default = none )\n");
+   PRINTout("   -s objsize : Size of each benchmark object ( default = 64M )\n");
+   PRINTout("   -c objects : Number of objects accessed by each thread ( default = 1 )\n");
+   PRINTout("   -o csv     : Output CSV file ( default = stdout )\n");
+   PRINTout("   -h         : Print this usage info\n");
+}
+
+int main(int argc, char** argv) {
+   const char* dallist = "noop,posix";
+   const char* numalist = "none";
+   char* root = NULL;
+   sweep Nsweep = { .values = { 10 }, .count = 1 };
+   sweep Esweep = { .values = { 2 }, .count = 1 };
+   sweep psweep = { .values = { 65536 }, .count = 1 };
+   sweep isweep = { .values = { 1048576 }, .count = 1 };
+   sweep tsweep = { .values = { 1 }, .count = 1 };
+   sweep dsweep = { .values = { 0 }, .count = 1 };
+   size_t objsize = 64 * 1048576;
+   int objects = 1;
+   const char* csvpath = NULL;
+
+   int c;
+   while ((c = getopt(argc, argv, "D:r:N:E:p:i:t:d:n:s:c:o:h")) != -1) {
+      sweep single;
+      switch (c) {
+         case 'D': dallist = optarg; break;
+         case 'r': root = optarg; break;
+         case 'N': if (parse_sweep(optarg, &Nsweep)) { return -1; } break;
+         case 'E': if (parse_sweep(optarg, &Esweep)) { return -1; } break;
+         case 'p': if (parse_sweep(optarg, &psweep)) { return -1; } break;
+         case 'i': if (parse_sweep(optarg, &isweep)) { return -1; } break;
+         case 't': if (parse_sweep(optarg, &tsweep)) { return -1; } break;
+         case 'd': if (parse_sweep(optarg, &dsweep)) { return -1; } break;
+         case 'n': numalist = optarg; break;
+         case 's':
+            if (parse_sweep(optarg, &single) || single.count != 1) { return -1; }
+            objsize = single.values[0];
+            break;
+         case 'c': objects = atoi(optarg); break;
+         case 'o': csvpath = optarg; break;
+         case 'h':
+            print_usage();
+            return 0;
+         default:
+            print_usage();
+            return -1;
+      }
+   }
+   if (objsize == 0 || objects <= 0) {
+      PRINTout("missing or invalid arguments\n");
+      print_usage();
+      return -1;
+   }
+
+   // establish our posix root, if necessary
+   char createdroot = 0;
+   char defroot[256];
+   if (strstr(dallist, "posix") && root == NULL) {
+      snprintf(defroot, sizeof(defroot), "/dev/shm/%s.%d", PROGNAME, (int)getpid());
+      root = defroot;
+   }
+   if (root) {
+      if (mkdir(root, S_IRWXU) == 0) { createdroot = 1; }
+      else if (errno != EEXIST) {
+         PRINTout("failed to create posix root \"%s\" (%s)\n", root, strerror(errno));
+         return -1;
+      }
+   }
+
+   FILE* out = stdout;
+   if (csvpath) {
+      out = fopen(csvpath, "w");
+      if (out == NULL) {
+         PRINTout("failed to open CSV output \"%s\" (%s)\n", csvpath, strerror(errno));
+         return -1;
+      }
+   }
+   fprintf(out, CSV_HEADER);
+
+   LIBXML_TEST_VERSION
+
+   int retval = 0;
+   char* dals = strdup(dallist);
+   char* saveptr = NULL;
+   for (char* dal = strtok_r(dals, ",", &saveptr); dal; dal = strtok_r(NULL, ",", &saveptr)) {
+      char isposix = (strcmp(dal, "posix") == 0);
+      char* numas = strdup(numalist);
+      char* numasave = NULL;
+      for (char* numa = strtok_r(numas, ",", &numasave); numa; numa = strtok_r(NULL, ",", &numasave)) {
+      for (int nidx = 0; nidx < Nsweep.count; nidx++) {
+      for (int eidx = 0; eidx < Esweep.count; eidx++) {
+      for (int pidx = 0; pidx < psweep.count; pidx++) {
+         ne_erasure epat = { .N = (int)Nsweep.values[nidx], .E = (int)Esweep.values[eidx], .O = 0, .partsz = psweep.values[pidx] };
+         ne_ctxt ctxt = bench_init(dal, root, epat, objsize, numa);
+         if (ctxt == NULL) { retval = -1; continue; }
+         PRINTout("benchmarking \"%s\" DAL with N=%d, E=%d, partsz=%zu, numa=%s\n", dal, epat.N, epat.E, epat.partsz, numa);
+
+         for (int iidx = 0; iidx < isweep.count; iidx++) {
+         for (int tidx = 0; tidx < tsweep.count; tidx++) {
+            int threads = (int)tsweep.values[tidx];
+            bench_run run = { .ctxt = ctxt, .numa = numa, .epat = epat, .iosz = isweep.values[iidx], .objsize = objsize, .objects = objects };
+
+            run.op = BENCH_WRITE;
+            if (bench_execute(&run, threads, dal, 0, out)) { retval = -1; continue; }
+
+            for (int didx = 0; didx < dsweep.count; didx++) {
+               int degraded = (int)dsweep.values[didx];
+               if (degraded && !isposix) { continue; } // noop blocks cannot be degraded
+               if (degraded > epat.E) {
+                  PRINTout("skipping degraded count %d, which exceeds E=%d\n", degraded, epat.E);
+                  continue;
+               }
+               if (degraded && degrade_objects(root, threads, objects, degraded)) { retval = -1; break; }
+               run.op = BENCH_READ;
+               if (bench_execute(&run, threads, dal, degraded, out)) { retval = -1; }
+               if (degraded) {
+                  // rebuild restores the removed blocks for the next degraded count
+                  run.op = BENCH_REBUILD;
+                  if (bench_execute(&run, threads, dal, degraded, out)) { retval = -1; break; }
+               }
+            }
+
+            // cleanup all objects
+            if (isposix) {
+               ne_location loc = { .pod = 0, .cap = 0, .scatter = 0 };
+               char objID[64];
+               for (int tID = 0; tID < threads; tID++) {
+                  for (int obj = 0; obj < objects; obj++) {
+                     snprintf(objID, sizeof(objID), "bench.t%d.o%d", tID, obj);
+                     if (ne_delete(ctxt, objID, loc)) {
+                        PRINTout("failed to delete benchmark object \"%s\"\n", objID);
+                     }
+                  }
+               }
+            }
+         }
+         }
+         ne_term(ctxt);
+      }
+      }
+      }
+      }
+      free(numas);
+   }
+   free(dals);
+
+   if (out != stdout) { fclose(out); }
+   xmlCleanupParser();
+   if (createdroot && rmdir(root)) {
+      PRINTout("failed to remove posix root \"%s\" (%s)\n", root, strerror(errno));
+   }
+   return retval;
+}
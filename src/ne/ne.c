@@ -57,6 +57,7 @@ underlying skt_etc() functions.
 #endif
 #define LOG_PREFIX "ne_core"
 #include "logging/logging.h"
+#include "logging/perfstats.h"
 
 #include "ne/ne.h"
 #include "io/io.h"
@@ -78,12 +79,25 @@ underlying skt_etc() functions.
 #include <pthread.h>
 
 // Some configurable values
-#define QDEPTH SUPER_BLOCK_CNT + 1
+#define REBUILD_THREADS 4 // default number of decode threads used by ne_rebuild()
+#define REBUILD_SETS 2 // number of stripe sets in flight during ne_rebuild() ( MUST be < MIN_QDEPTH )
+#define MIN_QDEPTH ( REBUILD_SETS + 1 ) // minimum ioqueue depth of any handle
+#define QUEUE_BATCH 16 // maximum number of queue elements moved per batch enqueue / dequeue
+#define NUMA_NONE -1 // 'numa' DAL attribute absent, no NUMA binding of handles
+#define NUMA_BALANCE -2 // 'numa="balance"', round-robin assignment of handles to NUMA nodes
 
 // NE context
 typedef struct ne_ctxt_struct {
    // Max Block value
    int max_block;
+   // Number of decode threads for rebuilds
+   int rebuild_threads;
+   // NUMA node of new handles ( or NUMA_NONE / NUMA_BALANCE ), and round-robin position
+   int numa_node;
+   unsigned int numa_next;
+   // Initial and maximum ioqueue depth of new handles
+   int qdepth;
+   int qdepthmax;
    // DAL definitions
    DAL dal;
    // Synchronization
@@ -98,6 +112,12 @@ typedef struct ne_handle_struct {
    /* Object Info */
    char* objID;
    ne_location loc;
+   int numa_node;
+
+   /* IOQueue Info */
+   int qdepth;
+   int qdepthmax;
+   ioqueue_stats qstats; // accumulated stats of all destroyed ioqueues
 
    /* Erasure Info */
    ne_erasure epat;
@@ -129,6 +149,70 @@ typedef struct ne_handle_struct {
 
 } *ne_handle;
 
+// Rebuild pipeline structures
+typedef struct rebuild_set_struct {
+   ioblock** iob;       // ioblock references for every block of this set of stripes
+   int stripecnt;       // number of stripes contained in this set
+   int errcnt;          // number of blocks with errors in this set
+   int pending;         // number of decode work packages still outstanding for this set
+   char failed;         // flag indicating that regeneration of some stripe has failed
+   struct rebuild_work_struct* work; // work packages for decode threads
+} rebuild_set;
+
+typedef struct rebuild_work_struct {
+   rebuild_set* set;
+   int start;           // first stripe of the set to be regenerated
+   int count;           // number of stripes to be regenerated
+} rebuild_work;
+
+typedef struct rebuild_global_struct {
+   int N;
+   int E;
+   size_t partsz;
+   int numa_node;
+   pthread_mutex_t* erasurelock;
+   pthread_mutex_t lock; // lock for set completion values
+   pthread_cond_t complete; // signaled whenever the last work package of a set completes
+} rebuild_gstate;
+
+typedef struct rebuild_thread_struct {
+   rebuild_gstate* gstate;
+   char e_ready;
+   char primed;
+   unsigned char* prev_in_err;
+   unsigned char* stripe_in_err;
+   unsigned char* stripe_err_list;
+   unsigned char* encode_matrix;
+   unsigned char* decode_matrix;
+   unsigned char* invert_matrix;
+   unsigned char* tmpmatrix;
+   unsigned char* decode_index;
+   unsigned char* g_tbls;
+   unsigned char** recov;
+   unsigned char** temp_buffs;
+} rebuild_tstate;
+
+// Process-wide cache of decode tables, keyed by erasure pattern and set of failed blocks
+#define DECODE_CACHE_BUCKETS 256 // number of hash buckets in the decode table cache
+#define DECODE_CACHE_MAX 4096 // maximum number of cached decode table sets
+
+typedef struct decode_entry_struct {
+   int N;
+   int E;
+   int nerrs;
+   unsigned char* err_list;     // indices of failed blocks, in ascending order
+   unsigned char* decode_index; // indices of the N blocks used for regeneration
+   unsigned char* g_tbls;       // expanded decode tables ( N * nerrs * 32 bytes )
+   struct decode_entry_struct* next;
+} decode_entry;
+
+// NOTE -- entries are immutable once inserted and are never evicted
+static struct decode_cache_struct {
+   pthread_rwlock_t lock;
+   size_t count; // only modified under the write lock, but always accessed atomically
+   decode_entry* buckets[DECODE_CACHE_BUCKETS];
+} decode_cache = { .lock = PTHREAD_RWLOCK_INITIALIZER, .count = 0 };
+
 static int gf_gen_decode_matrix_simple(unsigned char* encode_matrix,
    unsigned char* decode_matrix,
    unsigned char* invert_matrix,
@@ -163,6 +247,51 @@ void zero_state(ne_state* state, int num_blocks) {
    }
 }
 
+/**
+ * Discard all elements remaining on the given thread queue, in batches
+ * @param ThreadQueue tq : ThreadQueue to be emptied
+ * @param TQ_Control_Flags ignore_flags : Queue states to be bypassed while emptying the queue
+ * @param ioqueue* ioq : ioqueue to release one ioblock of, per discarded element ( ignored if NULL )
+ * @return int : Number of elements discarded, or -1 if any ioblock release failed
+ */
+static int drain_queue(ThreadQueue tq, TQ_Control_Flags ignore_flags, ioqueue* ioq) {
+   int drained = 0;
+   int dequeued;
+   while ((dequeued = tq_dequeue_batch(tq, ignore_flags, NULL, QUEUE_BATCH)) > 0) {
+      drained += dequeued;
+      for (; ioq && dequeued > 0; dequeued--) {
+         if (release_ioblock(ioq)) {
+            LOG(LOG_ERR, "Failed to release an ioblock of a discarded queue element\n");
+            return -1;
+         }
+      }
+   }
+   return drained;
+}
+
+/**
+ * Select a NUMA node for a new handle of the given context
+ * @param ne_ctxt ctxt : Context of the new handle
+ * @return int : NUMA node of the handle, or -1 if the handle should not be bound
+ */
+static int numa_select(ne_ctxt ctxt) {
+   if (ctxt->numa_node == NUMA_NONE) {
+      return -1;
+   }
+   int nodes = io_numa_nodes();
+   if (nodes <= 0) {
+      return -1;
+   }
+   if (ctxt->numa_node == NUMA_BALANCE) {
+      return (int)(__atomic_fetch_add(&(ctxt->numa_next), 1, __ATOMIC_RELAXED) % (unsigned int)nodes);
+   }
+   if (ctxt->numa_node >= nodes) {
+      LOG(LOG_WARNING, "Configured NUMA node %d is not available, ignoring\n", ctxt->numa_node);
+      return -1;
+   }
+   return ctxt->numa_node;
+}
+
 /**
  * Cleanup thread ioblock reference and set a finished state
  * @param ioblock** iobref : Reference to the ioblock pointer for the thread
@@ -223,6 +352,30 @@ int terminate_thread(ioblock** iobref, ThreadQueue tq, gthread_state* state, ne_
    return ret_val;
 }
 
+/**
+ * Destroy an ioqueue of the given handle, first adding its stats to those of the handle
+ * @param ne_handle handle : Handle owning the ioqueue
+ * @param ioqueue** ioq : Reference to the ioqueue to be destroyed ( set to NULL on success )
+ * @return int : Zero on success, or -1 on failure
+ */
+static int retire_ioqueue(ne_handle handle, ioqueue** ioq) {
+   ioqueue_stats qstats;
+   if (ioqueue_getstats(*ioq, &(qstats)) == 0) {
+      handle->qstats.stalls += qstats.stalls;
+      handle->qstats.stallns += qstats.stallns;
+      handle->qstats.grows += qstats.grows;
+      handle->qstats.shrinks += qstats.shrinks;
+      if (qstats.peakdepth > handle->qstats.peakdepth) {
+         handle->qstats.peakdepth = qstats.peakdepth;
+      }
+   }
+   if (destroy_ioqueue(*ioq)) {
+      return -1;
+   }
+   *ioq = NULL;
+   return 0;
+}
+
 /**
  * Allocate a new ne_handle structure
  * @param int max_block : Maximum block value
@@ -255,6 +408,9 @@ ne_handle allocate_handle(ne_ctxt ctxt, const char* objID, ne_location loc, meta
    handle->loc.pod = loc.pod;
    handle->loc.cap = loc.cap;
    handle->loc.scatter = loc.scatter;
+   handle->numa_node = numa_select(ctxt);
+   handle->qdepth = ctxt->qdepth;
+   handle->qdepthmax = ctxt->qdepthmax;
 
    // allocate context elements
    int num_blocks = consensus->N + consensus->E;
@@ -396,6 +552,9 @@ ne_handle allocate_handle(ne_ctxt ctxt, const char* objID, ne_location loc, meta
       handle->thread_states[i].minfo.totsz = consensus->totsz;
       handle->thread_states[i].meta_error = 0;
       handle->thread_states[i].data_error = 0;
+      handle->thread_states[i].numa_node = handle->numa_node;
+      handle->thread_states[i].qdepth = handle->qdepth;
+      handle->thread_states[i].qdepthmax = handle->qdepthmax;
       //      size_t iosz = consensus->versz;
       //      if ( iosz <= 0 ) { iosz = handle->dal->io_size; }
       //      handle->thread_states[i].ioq = create_ioqueue( iosz, consensus->partsz, mode );
@@ -587,11 +746,140 @@ int check_matches(meta_info** minfo_structs, int num_blocks, int max_blocks, met
    return retval;
 }
 
+/**
+ * Compute the decode cache bucket of a given erasure pattern and set of failed blocks
+ * @param int N : Data width of the stripe
+ * @param int E : Erasure width of the stripe
+ * @param unsigned char* err_list : Indices of failed blocks, in ascending order
+ * @param int nerrs : Number of failed blocks
+ * @return unsigned int : Bucket index
+ */
+static unsigned int decode_cache_bucket(int N, int E, unsigned char* err_list, int nerrs) {
+   unsigned int hash = 2166136261U; // FNV-1a
+   hash = (hash ^ (unsigned int)N) * 16777619U;
+   hash = (hash ^ (unsigned int)E) * 16777619U;
+   int i;
+   for (i = 0; i < nerrs; i++) {
+      hash = (hash ^ err_list[i]) * 16777619U;
+   }
+   return hash % DECODE_CACHE_BUCKETS;
+}
+
+/**
+ * Locate a matching decode cache entry ( decode_cache lock must be held )
+ * @param unsigned int bucket : Bucket of the entry
+ * @param int N : Data width of the stripe
+ * @param int E : Erasure width of the stripe
+ * @param unsigned char* err_list : Indices of failed blocks, in ascending order
+ * @param int nerrs : Number of failed blocks
+ * @return decode_entry* : Reference to the matching entry, or NULL if none exists
+ */
+static decode_entry* decode_cache_find(unsigned int bucket, int N, int E, unsigned char* err_list, int nerrs) {
+   decode_entry* entry = decode_cache.buckets[bucket];
+   while (entry) {
+      if (entry->N == N && entry->E == E && entry->nerrs == nerrs && !memcmp(entry->err_list, err_list, nerrs)) {
+         return entry;
+      }
+      entry = entry->next;
+   }
+   return NULL;
+}
+
+/**
+ * Populate decode tables for the given set of failed blocks, reusing tables from the process-wide
+ * decode cache if possible and generating ( then caching ) new tables otherwise
+ * @param pthread_mutex_t* erasurelock : Lock to be held while generating new tables
+ * @param int N : Data width of the stripe
+ * @param int E : Erasure width of the stripe
+ * @param unsigned char* err_list : Indices of failed blocks, in ascending order
+ * @param int nerrs : Number of failed blocks
+ * @param unsigned char* decode_index : Array to be populated with the indices of the N regeneration source blocks
+ * @param unsigned char* g_tbls : Array to be populated with expanded decode tables ( at least N * nerrs * 32 bytes )
+ * @param unsigned char* encode_matrix : Scratch space of at least ( (N + E) * N ) bytes
+ * @param unsigned char* decode_matrix : Scratch space of at least ( (N + E) * N ) bytes
+ * @param unsigned char* invert_matrix : Scratch space of at least ( (N + E) * N ) bytes
+ * @param unsigned char* tmpmatrix : Scratch space of at least ( N * N ) bytes
+ * @return int : Zero on success, and -1 on failure ( errno will be ENODATA if the blocks cannot be regenerated )
+ */
+int get_decode_tables(pthread_mutex_t* erasurelock, int N, int E, unsigned char* err_list, int nerrs,
+   unsigned char* decode_index, unsigned char* g_tbls, unsigned char* encode_matrix,
+   unsigned char* decode_matrix, unsigned char* invert_matrix, unsigned char* tmpmatrix) {
+   size_t tblsz = (size_t)N * nerrs * 32;
+   unsigned int bucket = decode_cache_bucket(N, E, err_list, nerrs);
+
+   // check for previously generated tables
+   pthread_rwlock_rdlock(&(decode_cache.lock));
+   decode_entry* entry = decode_cache_find(bucket, N, E, err_list, nerrs);
+   if (entry) {
+      memcpy(decode_index, entry->decode_index, N);
+      memcpy(g_tbls, entry->g_tbls, tblsz);
+      pthread_rwlock_unlock(&(decode_cache.lock));
+      return 0;
+   }
+   pthread_rwlock_unlock(&(decode_cache.lock));
+
+   // critical section : we are now going to call some inlined assembly erasure funcs
+   if (pthread_mutex_lock(erasurelock)) {
+      LOG(LOG_ERR, "Failed to acquire erasurelock prior to table generation\n");
+      return -1;
+   }
+   gf_gen_cauchy1_matrix(encode_matrix, N + E, N);
+   int ret_code = gf_gen_decode_matrix_simple(encode_matrix, decode_matrix, invert_matrix, tmpmatrix,
+      decode_index, err_list, nerrs, N, N + E);
+   if (ret_code == 0) {
+      LOG(LOG_INFO, "Initializing erasure tables ( nstripe_errors = %d )\n", nerrs);
+      ec_init_tables(N, nerrs, decode_matrix, g_tbls);
+   }
+   // exiting critical section
+   if (pthread_mutex_unlock(erasurelock)) {
+      LOG(LOG_ERR, "Failed to relinquish erasurelock after table generation\n");
+      return -1;
+   }
+   if (ret_code != 0) {
+      LOG(LOG_ERR, "Failure to generate decode matrix, errors may exceed erasure limits (%d)!\n", nerrs);
+      errno = ENODATA;
+      return -1;
+   }
+
+   // cache the new tables, if there is room
+   if (__atomic_load_n(&(decode_cache.count), __ATOMIC_RELAXED) >= DECODE_CACHE_MAX) {
+      return 0; // unlocked check is only an optimization, and is repeated below
+   }
+   entry = malloc(sizeof(struct decode_entry_struct) + nerrs + N + tblsz);
+   if (entry == NULL) {
+      LOG(LOG_WARNING, "Failed to allocate a decode cache entry\n");
+      return 0; // our own tables are still valid
+   }
+   entry->N = N;
+   entry->E = E;
+   entry->nerrs = nerrs;
+   entry->err_list = (unsigned char*)(entry + 1);
+   entry->decode_index = entry->err_list + nerrs;
+   entry->g_tbls = entry->decode_index + N;
+   memcpy(entry->err_list, err_list, nerrs);
+   memcpy(entry->decode_index, decode_index, N);
+   memcpy(entry->g_tbls, g_tbls, tblsz);
+   pthread_rwlock_wrlock(&(decode_cache.lock));
+   if (decode_cache.count >= DECODE_CACHE_MAX || decode_cache_find(bucket, N, E, err_list, nerrs)) {
+      // the cache has filled, or another thread has already inserted these same tables
+      pthread_rwlock_unlock(&(decode_cache.lock));
+      free(entry);
+      return 0;
+   }
+   entry->next = decode_cache.buckets[bucket];
+   decode_cache.buckets[bucket] = entry;
+   __atomic_add_fetch(&(decode_cache.count), 1, __ATOMIC_RELAXED); // atomic, as count is also checked without the lock
+   pthread_rwlock_unlock(&(decode_cache.lock));
+   LOG(LOG_INFO, "Cached decode tables for %d+%d stripe with %d failed blocks\n", N, E, nerrs);
+   return 0;
+}
+
 /**
  *
  *
  */
 int read_stripes(ne_handle handle) {
+   PERF_SPAN( span, PERF_NE_READ_STRIPES );
 
    // get some useful reference values
    int N = handle->epat.N;
@@ -644,14 +932,13 @@ int read_stripes(ne_handle handle) {
       if (cur_block >= N + handle->ethreads_running) {
          LOG(LOG_INFO, "Starting up thread %d to cope with errors beyond stripe %d\n", cur_block, start_stripe);
          // first, make sure to empty any ioblocks still on the queue
-         while (tq_dequeue(handle->thread_queues[cur_block], TQ_HALT, (void**)&(handle->iob[cur_block])) > 0) {
-            LOG(LOG_INFO, "Releasing ioblock from queue %d, prior to reseek\n", cur_block);
-            if (release_ioblock(handle->thread_states[cur_block].ioq)) {
-               LOG(LOG_ERR, "Failed to release ioblock from queue %d\n", cur_block);
-               errno = EBADF;
-               return -1;
-            }
+         int drained = drain_queue(handle->thread_queues[cur_block], TQ_HALT, handle->thread_states[cur_block].ioq);
+         if (drained < 0) {
+            LOG(LOG_ERR, "Failed to release ioblocks from queue %d\n", cur_block);
+            errno = EBADF;
+            return -1;
          }
+         LOG(LOG_INFO, "Released %d ioblocks from queue %d, prior to reseek\n", drained, cur_block);
          if ( tq_wait_for_pause( handle->thread_queues[cur_block] ) ) {
             LOG( LOG_ERR, "Failed to verify that thread %d paused, prior to restarting\n", cur_block );
             errno = EBADF;
@@ -770,7 +1057,7 @@ int read_stripes(ne_handle handle) {
 
             LOG(LOG_INFO, "Initializing erasure structs...\n");
 
-            unsigned char* tmpmatrix = calloc((N + E) * (N + E), sizeof(unsigned char));
+            unsigned char* tmpmatrix = calloc(N * N, sizeof(unsigned char));
             if (tmpmatrix == NULL) {
                LOG(LOG_ERR, "Failed to allocate space for a tmpmatrix!\n");
                free(stripe_in_err);
@@ -778,45 +1065,13 @@ int read_stripes(ne_handle handle) {
                return -1;
             }
 
-            // critical section : we are now going to call some inlined assembly erasure funcs
-            if ( pthread_mutex_lock( handle->ctxt->erasurelock ) ) {
-               LOG( LOG_ERR, "Failed to acquire erasurelock prior to table generation for stripe %d\n", cur_stripe + start_stripe );
-               free(tmpmatrix);
-               free( stripe_err_list );
-               free( stripe_in_err );
-               return -1;
-            }
-
-            // Generate an encoding matrix
-            gf_gen_cauchy1_matrix(handle->encode_matrix, N + E, N);
-
-            // Generate g_tbls from encode matrix
-            ec_init_tables(N, E, &(handle->encode_matrix[N * N]), handle->g_tbls);
-            int ret_code = gf_gen_decode_matrix_simple(handle->encode_matrix, handle->decode_matrix,
-               handle->invert_matrix, tmpmatrix, handle->decode_index, stripe_err_list,
-               nstripe_errors, N, N + E);
-
-            if (ret_code != 0) {
-               // this is the only error for which we will at least attempt to continue
-               LOG(LOG_ERR, "Failure to generate decode matrix, errors may exceed erasure limits (%d)!\n", nstripe_errors);
-               pthread_mutex_unlock( handle->ctxt->erasurelock );
+            if (get_decode_tables(handle->ctxt->erasurelock, N, E, stripe_err_list, nstripe_errors,
+                  handle->decode_index, handle->g_tbls, handle->encode_matrix, handle->decode_matrix,
+                  handle->invert_matrix, tmpmatrix)) {
+               LOG(LOG_ERR, "Failed to initialize erasure tables for stripe %d\n", cur_stripe + start_stripe);
                free(tmpmatrix);
                free(stripe_in_err);
                free(stripe_err_list);
-               // return the number of stripes we failed to regenerate
-               errno = ENODATA;
-               return -1;
-            }
-
-            LOG(LOG_INFO, "Initializing erasure tables ( nstripe_errors = %d )\n", nstripe_errors);
-            ec_init_tables(N, nstripe_errors, handle->decode_matrix, handle->g_tbls);
-
-            // exiting critical section
-            if ( pthread_mutex_unlock( handle->ctxt->erasurelock ) ) {
-               LOG( LOG_ERR, "Failed to relinquish erasurelock after table generation for stripe %d\n", cur_stripe + start_stripe );
-               free(tmpmatrix);
-               free( stripe_err_list );
-               free( stripe_in_err );
                return -1;
             }
             free(tmpmatrix);
@@ -870,7 +1125,9 @@ int read_stripes(ne_handle handle) {
             free( stripe_in_err );
             return -1;
          }
+         uint64_t perfbegin = perf_begin();
          ec_encode_data(partsz, N, nstripe_errors, handle->g_tbls, recov, &temp_buffs[0]);
+         perf_end( PERF_NE_DECODE, perfbegin, (size_t)partsz * nstripe_errors );
          // exiting critical section
          if ( pthread_mutex_unlock( handle->ctxt->erasurelock ) ) {
             LOG( LOG_ERR, "Failed to relinquish erasurelock after regeneration of stripe %d\n", cur_stripe + start_stripe );
@@ -893,6 +1150,325 @@ int read_stripes(ne_handle handle) {
    return 0;
 }
 
+/**
+ * Free all allocations associated with a rebuild thread state
+ * @param rebuild_tstate* tstate : Reference to the state to be freed
+ */
+void free_rebuild_tstate(rebuild_tstate* tstate) {
+   free(tstate->temp_buffs);
+   free(tstate->recov);
+   free(tstate->g_tbls);
+   free(tstate->decode_index);
+   free(tstate->tmpmatrix);
+   free(tstate->invert_matrix);
+   free(tstate->decode_matrix);
+   free(tstate->encode_matrix);
+   free(tstate->stripe_err_list);
+   free(tstate->stripe_in_err);
+   free(tstate->prev_in_err);
+   free(tstate);
+}
+
+/**
+ * Initialize the state of a rebuild decode thread, allocating private erasure structures
+ * @param unsigned int tID : The ID of this thread
+ * @param void* global_state : Reference to a rebuild_gstate struct
+ * @param void** state : Reference to be populated with this thread's state info
+ * @return int : Zero on success and -1 on failure
+ */
+int rebuild_init(unsigned int tID, void* global_state, void** state) {
+   rebuild_gstate* gstate = (rebuild_gstate*)global_state;
+   int N = gstate->N;
+   int E = gstate->E;
+   // run on the NUMA node of our handle, if any ( failure just costs locality )
+   if (gstate->numa_node >= 0 && io_numa_bind(gstate->numa_node)) {
+      LOG(LOG_WARNING, "Decode thread %u failed to bind to NUMA node %d\n", tID, gstate->numa_node);
+   }
+   rebuild_tstate* tstate = calloc(1, sizeof(struct rebuild_thread_struct));
+   if (tstate == NULL) {
+      LOG(LOG_ERR, "Failed to allocate state for decode thread %u\n", tID);
+      return -1;
+   }
+   tstate->gstate = gstate;
+   tstate->prev_in_err = calloc(N + E, sizeof(unsigned char));
+   tstate->stripe_in_err = calloc(N + E, sizeof(unsigned char));
+   tstate->stripe_err_list = calloc(N + E, sizeof(unsigned char));
+   tstate->encode_matrix = calloc((N + E) * N, sizeof(unsigned char));
+   tstate->decode_matrix = calloc((N + E) * N, sizeof(unsigned char));
+   tstate->invert_matrix = calloc((N + E) * N, sizeof(unsigned char));
+   tstate->tmpmatrix = calloc((N + E) * (N + E), sizeof(unsigned char));
+   tstate->decode_index = calloc(N + E, sizeof(unsigned char));
+   tstate->g_tbls = calloc(N * E * 32, sizeof(unsigned char));
+   tstate->recov = calloc(N + E, sizeof(unsigned char*));
+   tstate->temp_buffs = calloc(E, sizeof(unsigned char*));
+   if (tstate->prev_in_err == NULL || tstate->stripe_in_err == NULL || tstate->stripe_err_list == NULL ||
+       tstate->encode_matrix == NULL || tstate->decode_matrix == NULL || tstate->invert_matrix == NULL ||
+       tstate->tmpmatrix == NULL || tstate->decode_index == NULL || tstate->g_tbls == NULL ||
+       tstate->recov == NULL || tstate->temp_buffs == NULL) {
+      LOG(LOG_ERR, "Failed to allocate erasure structures for decode thread %u\n", tID);
+      free_rebuild_tstate(tstate);
+      return -1;
+   }
+   *state = (void*)tstate;
+   return 0;
+}
+
+/**
+ * Regenerate any bad data within a single stripe of the given set of ioblocks
+ * @param rebuild_tstate* tstate : State of the calling decode thread
+ * @param ioblock** iob : Array of ioblock references, one per block of the stripe
+ * @param int stripe : Index of the stripe ( within the ioblocks ) to be regenerated
+ * @return int : Zero on success, and -1 on failure
+ */
+int regenerate_stripe(rebuild_tstate* tstate, ioblock** iob, int stripe) {
+   rebuild_gstate* gstate = tstate->gstate;
+   int N = gstate->N;
+   int E = gstate->E;
+   off_t stripe_start = stripe * gstate->partsz;
+
+   // establish the error pattern of this stripe
+   // NOTE -- unlike read_stripes(), error_end values are never modified here, as other
+   //         threads may be concurrently regenerating other stripes of the same ioblocks
+   int nstripe_errors = 0;
+   int cur_block;
+   for (cur_block = 0; cur_block < N + E; cur_block++) {
+      tstate->stripe_in_err[cur_block] = 0;
+      if (stripe_start < iob[cur_block]->error_end) {
+         tstate->stripe_err_list[nstripe_errors] = cur_block;
+         nstripe_errors++;
+         tstate->stripe_in_err[cur_block] = 1;
+      }
+      // any change in our error pattern will require reinitializing erasure structs
+      if (tstate->prev_in_err[cur_block] != tstate->stripe_in_err[cur_block]) {
+         tstate->e_ready = 0;
+         tstate->prev_in_err[cur_block] = tstate->stripe_in_err[cur_block];
+      }
+   }
+   if (nstripe_errors == 0) {
+      return 0;
+   }
+   if (nstripe_errors > E) {
+      LOG(LOG_ERR, "Stripe %d has too many errors (%d) to be recovered\n", stripe, nstripe_errors);
+      errno = ENODATA;
+      return -1;
+   }
+
+   if (!(tstate->e_ready)) {
+      LOG(LOG_INFO, "Initializing erasure structs ( nstripe_errors = %d )\n", nstripe_errors);
+      if (get_decode_tables(gstate->erasurelock, N, E, tstate->stripe_err_list, nstripe_errors,
+            tstate->decode_index, tstate->g_tbls, tstate->encode_matrix, tstate->decode_matrix,
+            tstate->invert_matrix, tstate->tmpmatrix)) {
+         LOG(LOG_ERR, "Failed to initialize erasure tables for stripe %d\n", stripe);
+         return -1;
+      }
+      tstate->e_ready = 1;
+   }
+
+   for (cur_block = 0; cur_block < N; cur_block++) {
+      tstate->recov[cur_block] = iob[tstate->decode_index[cur_block]]->buff + stripe_start;
+   }
+   // regenerated data is written over the top of the faulty buffers
+   for (cur_block = 0; cur_block < nstripe_errors; cur_block++) {
+      tstate->temp_buffs[cur_block] = iob[tstate->stripe_err_list[cur_block]]->buff + stripe_start;
+   }
+
+   LOG(LOG_INFO, "Performing regeneration of stripe %d from erasure\n", stripe);
+   if (tstate->primed) {
+      // isa-l resolves its per-architecture implementation during the first call, which this thread
+      // has already performed under the erasurelock; from here on, concurrent calls are safe
+      uint64_t perfbegin = perf_begin();
+      ec_encode_data(gstate->partsz, N, nstripe_errors, tstate->g_tbls, tstate->recov, tstate->temp_buffs);
+      perf_end( PERF_NE_DECODE, perfbegin, (size_t)gstate->partsz * nstripe_errors );
+      return 0;
+   }
+   // critical section : we are now going to call some inlined assembly erasure funcs
+   if (pthread_mutex_lock(gstate->erasurelock)) {
+      LOG(LOG_ERR, "Failed to acquire erasurelock prior to regeneration of stripe %d\n", stripe);
+      return -1;
+   }
+   uint64_t perfbegin = perf_begin();
+   ec_encode_data(gstate->partsz, N, nstripe_errors, tstate->g_tbls, tstate->recov, tstate->temp_buffs);
+   perf_end( PERF_NE_DECODE, perfbegin, (size_t)gstate->partsz * nstripe_errors );
+   // exiting critical section
+   if (pthread_mutex_unlock(gstate->erasurelock)) {
+      LOG(LOG_ERR, "Failed to relinquish erasurelock after regeneration of stripe %d\n", stripe);
+      return -1;
+   }
+   tstate->primed = 1;
+   return 0;
+}
+
+/**
+ * Regenerate a range of stripes, then note the completion of that work against its stripe set
+ * @param void** state : Thread state reference
+ * @param void** work_todo : Reference to the rebuild_work package
+ * @return int : Zero ( failures are reported via the 'failed' flag of the stripe set )
+ */
+int rebuild_consume(void** state, void** work_todo) {
+   rebuild_tstate* tstate = (rebuild_tstate*)(*state);
+   rebuild_gstate* gstate = tstate->gstate;
+   rebuild_work* work = (rebuild_work*)(*work_todo);
+   rebuild_set* set = work->set;
+   char failed = 0;
+   int cur_stripe;
+   for (cur_stripe = work->start; cur_stripe < work->start + work->count; cur_stripe++) {
+      if (regenerate_stripe(tstate, set->iob, cur_stripe)) {
+         LOG(LOG_ERR, "Failed to regenerate stripe %d of set\n", cur_stripe);
+         failed = 1;
+         break;
+      }
+   }
+   pthread_mutex_lock(&(gstate->lock));
+   if (failed) {
+      set->failed = 1;
+   }
+   set->pending--;
+   if (set->pending == 0) {
+      pthread_cond_broadcast(&(gstate->complete));
+   }
+   pthread_mutex_unlock(&(gstate->lock));
+   *work_todo = NULL;
+   return 0;
+}
+
+/**
+ * Free the state of a rebuild decode thread
+ * @param void** state : Thread state reference
+ * @param void** prev_work : Reference to any unused previous work package
+ * @param TQ_Control_Flags flg : Control flags values at thread term
+ */
+void rebuild_term(void** state, void** prev_work, TQ_Control_Flags flg) {
+   free_rebuild_tstate((rebuild_tstate*)(*state));
+   *state = NULL;
+}
+
+/**
+ * Retrieve the next set of stripes for a rebuild, gathering an ioblock from every block of the handle
+ * @param ne_handle handle : Handle being rebuilt
+ * @param rebuild_set* set : Stripe set to be populated
+ * @return int : Zero on success, and -1 on failure
+ */
+int gather_rebuild_set(ne_handle handle, rebuild_set* set) {
+   int N = handle->epat.N;
+   int E = handle->epat.E;
+   set->errcnt = 0;
+   set->pending = 0;
+   set->failed = 0;
+   size_t datasz = 0;
+   int cur_block;
+   for (cur_block = 0; cur_block < N + E; cur_block++) {
+      if (handle->iob[cur_block]) {
+         // adopt any stripes already read in by a previous seek
+         set->iob[cur_block] = handle->iob[cur_block];
+         handle->iob[cur_block] = NULL;
+      }
+      else if (tq_dequeue(handle->thread_queues[cur_block], TQ_HALT, (void**)&(set->iob[cur_block])) < 0 ||
+               set->iob[cur_block] == NULL) {
+         LOG(LOG_ERR, "Failed to retrieve new buffer for block %d!\n", cur_block);
+         set->iob[cur_block] = NULL;
+         errno = EBADF;
+         return -1;
+      }
+      ioblock* cur_iob = set->iob[cur_block];
+      if (cur_iob->error_end > 0) {
+         LOG(LOG_WARNING, "Detected an error at offset %zu of ioblock %d\n", cur_iob->error_end, cur_block);
+         set->errcnt++;
+      }
+      if (cur_block == 0) {
+         datasz = cur_iob->data_size;
+      }
+      else if (cur_iob->data_size != datasz) {
+         LOG(LOG_ERR, "Detected a ioblock of size %zd from block %d which conflicts with expected value of %zd!\n",
+            cur_iob->data_size, cur_block, datasz);
+         errno = EBADF;
+         return -1;
+      }
+   }
+   if (datasz == 0) {
+      LOG(LOG_ERR, "Received empty ioblocks prior to reaching the end of the object\n");
+      errno = EBADF;
+      return -1;
+   }
+   if (set->errcnt > E) {
+      LOG(LOG_ERR, "Data has too many errors (%d) to be recovered\n", set->errcnt);
+      errno = ENODATA;
+      return -1;
+   }
+   set->stripecnt = datasz / handle->epat.partsz;
+   return 0;
+}
+
+/**
+ * Split a set of stripes into work packages and hand them off to the decode threads
+ * @param ThreadQueue tq : ThreadQueue of the decode threads
+ * @param rebuild_gstate* gstate : Global state of the decode threads
+ * @param rebuild_set* set : Set of stripes to be regenerated
+ * @param int threads : Number of decode threads
+ * @return int : Zero on success, and -1 on failure
+ */
+int dispatch_rebuild_set(ThreadQueue tq, rebuild_gstate* gstate, rebuild_set* set, int threads) {
+   // no need to involve the decode threads if all data is valid
+   if (set->errcnt == 0) {
+      return 0;
+   }
+   int perwork = (set->stripecnt + threads - 1) / threads;
+   int workcnt = 0;
+   int start;
+   for (start = 0; start < set->stripecnt; start += perwork) {
+      set->work[workcnt].set = set;
+      set->work[workcnt].start = start;
+      set->work[workcnt].count = (start + perwork > set->stripecnt) ? (set->stripecnt - start) : perwork;
+      workcnt++;
+   }
+   pthread_mutex_lock(&(gstate->lock));
+   set->pending = workcnt;
+   pthread_mutex_unlock(&(gstate->lock));
+   // hand off work packages in batches, to limit queue lock traffic and thread wakeups
+   int curwork = 0;
+   while (curwork < workcnt) {
+      void* batch[QUEUE_BATCH];
+      unsigned int batchcnt = 0;
+      for (; batchcnt < QUEUE_BATCH && (curwork + batchcnt) < workcnt; batchcnt++) {
+         batch[batchcnt] = (void*)&(set->work[curwork + batchcnt]);
+      }
+      int enqueued = tq_enqueue_batch(tq, TQ_NONE, batch, batchcnt);
+      if (enqueued > 0) {
+         curwork += enqueued;
+      }
+      else {
+         LOG(LOG_ERR, "Failed to enqueue decode work package %d\n", curwork);
+         // account for the packages we never handed off
+         pthread_mutex_lock(&(gstate->lock));
+         set->pending -= (workcnt - curwork);
+         set->failed = 1;
+         pthread_mutex_unlock(&(gstate->lock));
+         errno = EBADF;
+         return -1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * Wait for all outstanding decode work of the given set to complete
+ * @param rebuild_gstate* gstate : Global state of the decode threads
+ * @param rebuild_set* set : Set of stripes to wait on
+ * @return int : Zero if all stripes were regenerated, and -1 if a failure occurred
+ */
+int wait_rebuild_set(rebuild_gstate* gstate, rebuild_set* set) {
+   pthread_mutex_lock(&(gstate->lock));
+   while (set->pending) {
+      pthread_cond_wait(&(gstate->complete), &(gstate->lock));
+   }
+   char failed = set->failed;
+   pthread_mutex_unlock(&(gstate->lock));
+   if (failed) {
+      errno = ENODATA;
+      return -1;
+   }
+   return 0;
+}
+
 // ---------------------- CONTEXT CREATION/DESTRUCTION/VALIDATION ----------------------
 
 /**
@@ -964,6 +1540,9 @@ ne_ctxt ne_path_init(const char* path, ne_location max_loc, int max_block, pthre
    // fill in context elements
    ctxt->max_block = max_block;
    ctxt->dal = dal;
+   ctxt->rebuild_threads = REBUILD_THREADS;
+   ctxt->numa_node = NUMA_NONE; // no NUMA binding of handles
+   ne_set_qdepth(ctxt, 0, 0); // default ioqueue depths
    // verify or create our erasurelock
    if ( erasurelock ) {
       ctxt->erasurelock = erasurelock;
@@ -1033,6 +1612,49 @@ ne_ctxt ne_init(xmlNode* dal_root, ne_location max_loc, int max_block, pthread_m
    // fill in context values and return
    ctxt->max_block = max_block;
    ctxt->dal = dal;
+   ctxt->rebuild_threads = REBUILD_THREADS;
+   ctxt->numa_node = NUMA_NONE;
+   xmlChar* numaval = xmlGetProp(dal_root, (const xmlChar*)"numa");
+   if (numaval) {
+      char* endptr = NULL;
+      long node = strtol((char*)numaval, &endptr, 10);
+      if (strcmp((char*)numaval, "balance") == 0) {
+         ctxt->numa_node = NUMA_BALANCE;
+      }
+      else if (endptr != (char*)numaval && *endptr == '\0' && node >= 0 && node < INT_MAX) {
+         ctxt->numa_node = (int)node;
+      }
+      else {
+         LOG(LOG_WARNING, "Ignoring unrecognized DAL 'numa' value: \"%s\"\n", (char*)numaval);
+      }
+      xmlFree(numaval);
+      if (ctxt->numa_node != NUMA_NONE && io_numa_nodes() <= 0) {
+         LOG(LOG_WARNING, "No NUMA topology is available, handles will not be bound\n");
+      }
+   }
+   int qdepth = 0;
+   int qdepthmax = 0;
+   const char* qattrs[2] = { "qdepth", "qdepthmax" };
+   int* qvals[2] = { &(qdepth), &(qdepthmax) };
+   int qi;
+   for (qi = 0; qi < 2; qi++) {
+      xmlChar* qval = xmlGetProp(dal_root, (const xmlChar*)qattrs[qi]);
+      if (qval) {
+         char* endptr = NULL;
+         long depth = strtol((char*)qval, &endptr, 10);
+         if (endptr != (char*)qval && *endptr == '\0' && depth > 0 && depth <= IOQUEUE_MAX_DEPTH) {
+            *(qvals[qi]) = (int)depth;
+         }
+         else {
+            LOG(LOG_WARNING, "Ignoring invalid DAL '%s' value: \"%s\"\n", qattrs[qi], (char*)qval);
+         }
+         xmlFree(qval);
+      }
+   }
+   if (ne_set_qdepth(ctxt, qdepth, qdepthmax)) {
+      LOG(LOG_WARNING, "Ignoring unusable DAL ioqueue depth values ( %d - %d )\n", qdepth, qdepthmax);
+      ne_set_qdepth(ctxt, 0, 0);
+   }
 
    return ctxt;
 }
@@ -1048,6 +1670,60 @@ int ne_verify(ne_ctxt ctxt, char fix) {
    return ctxt->dal->verify(ctxt->dal->ctxt, fix);
 }
 
+/**
+ * Set the number of decode threads used by ne_rebuild() for handles of the given ne_ctxt
+ * @param ne_ctxt ctxt : Reference to the ne_ctxt to be updated
+ * @param int threads : Number of decode threads ( zero will restore the default value )
+ * @return int : Zero on a success, and -1 on a failure
+ */
+int ne_set_rebuild_threads(ne_ctxt ctxt, int threads) {
+   if (ctxt == NULL) {
+      LOG(LOG_ERR, "Received a NULL ne_ctxt argument!\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (threads < 0) {
+      LOG(LOG_ERR, "Received a negative thread count: %d\n", threads);
+      errno = EINVAL;
+      return -1;
+   }
+   if (threads == 0) {
+      threads = REBUILD_THREADS;
+   }
+   ctxt->rebuild_threads = threads;
+   return 0;
+}
+
+/**
+ * Set the initial and maximum ioqueue depth ( ioblocks per block thread ) for new handles of the given ne_ctxt
+ * @param ne_ctxt ctxt : Reference to the ne_ctxt to be updated
+ * @param int depth : Initial ( and minimum ) depth of each ioqueue ( zero will restore the default value )
+ * @param int maxdepth : Maximum depth of each ioqueue ( values <= depth disable adaptive growth )
+ * @return int : Zero on a success, and -1 on a failure
+ */
+int ne_set_qdepth(ne_ctxt ctxt, int depth, int maxdepth) {
+   if (ctxt == NULL) {
+      LOG(LOG_ERR, "Received a NULL ne_ctxt argument!\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (depth == 0) {
+      depth = SUPER_BLOCK_CNT;
+   }
+   if (maxdepth < depth) {
+      maxdepth = depth;
+   }
+   if (depth < MIN_QDEPTH || maxdepth > IOQUEUE_MAX_DEPTH) {
+      LOG(LOG_ERR, "IOQueue depth values ( %d - %d ) are outside the supported range ( %d - %d )\n",
+         depth, maxdepth, MIN_QDEPTH, IOQUEUE_MAX_DEPTH);
+      errno = EINVAL;
+      return -1;
+   }
+   ctxt->qdepth = depth;
+   ctxt->qdepthmax = maxdepth;
+   return 0;
+}
+
 /**
  * Destroys an existing ne_ctxt
  * @param ne_ctxt ctxt : Reference to the ne_ctxt to be destroyed
@@ -1299,7 +1975,7 @@ ne_handle ne_convert_handle(ne_handle handle, ne_mode mode) {
       preffmt = "WQ%d";
    }
    tqopts.init_flags = TQ_HALT; // initialize the threads in a HALTED state (essential for reads, doesn't hurt writes)
-   tqopts.max_qdepth = QDEPTH;
+   tqopts.max_qdepth = handle->qdepthmax + 1; // room for every ioblock the queue may hold
    tqopts.num_threads = 1;
    tqopts.num_prod_threads = (mode == NE_WRONLY || mode == NE_WRALL) ? 0 : 1;
    DAL_MODE dmode = DAL_READ;
@@ -1461,11 +2137,14 @@ ne_handle ne_convert_handle(ne_handle handle, ne_mode mode) {
       } // if we already have a versz, use that instead
 
       // initialize ioqueues
-      handle->thread_states[i].ioq = create_ioqueue(iosz, handle->epat.partsz, dmode);
+      handle->thread_states[i].ioq = create_ioqueue(iosz, handle->epat.partsz, dmode, handle->qdepth, handle->qdepthmax);
       if (handle->thread_states[i].ioq == NULL) {
          LOG(LOG_ERR, "Failed to create ioqueue for thread %d!\n", i);
          break;
       }
+      if (handle->numa_node >= 0) {
+         bind_ioqueue(handle->thread_states[i].ioq, handle->numa_node); // failure only costs locality
+      }
       // remove the PAUSE flag, allowing thread to begin processing
       if (i < handle->epat.N + handle->ethreads_running) {
          if (tq_unset_flags(handle->thread_queues[i], TQ_HALT)) {
@@ -1505,6 +2184,7 @@ ne_handle ne_convert_handle(ne_handle handle, ne_mode mode) {
  * @return ne_handle : Newly created ne_handle, or NULL if an error occured
  */
 ne_handle ne_open(ne_ctxt ctxt, const char* objID, ne_location loc, ne_erasure epat, ne_mode mode) {
+   PERF_SPAN( span, PERF_NE_OPEN );
    // verify our mode arg and context
    if (ctxt == NULL) {
       LOG(LOG_ERR, "Received a NULL ne_ctxt argument!\n");
@@ -1556,6 +2236,7 @@ ne_handle ne_open(ne_ctxt ctxt, const char* objID, ne_location loc, ne_erasure e
  * @return int : Number of blocks with errors on success, and -1 on a failure.
  */
 int ne_close(ne_handle handle, ne_erasure* epat, ne_state* sref) {
+   PERF_SPAN( span, PERF_NE_CLOSE );
    LOG(LOG_INFO, "Closing handle\n");
    // check error conditions
    if (!(handle)) {
@@ -1652,10 +2333,8 @@ int ne_close(ne_handle handle, ne_erasure* epat, ne_state* sref) {
             int waitres = 0;
             while ( (waitres = tq_wait_for_completion( handle->thread_queues[i] )) ) {
                if ( waitres > 0 ) {
-                  while ( tq_dequeue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, NULL) > 0 ) {
-                     LOG(LOG_INFO, "Releasing unused queue element prior to completion of queue %d\n", i);
-                     release_ioblock(handle->thread_states[i].ioq);
-                  }
+                  LOG(LOG_INFO, "Releasing unused queue elements prior to completion of queue %d\n", i);
+                  drain_queue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, handle->thread_states[i].ioq);
                }
                else {
                   LOG( LOG_ERR, "Failed to wait for thread %d completion\n", i );
@@ -1664,14 +2343,12 @@ int ne_close(ne_handle handle, ne_erasure* epat, ne_state* sref) {
                }
             }
             // we need to empty any remaining elements from the queue
-            while (tq_dequeue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, NULL) > 0) {
-               LOG(LOG_INFO, "Releasing unused queue element for thread %d\n", i);
-               release_ioblock(handle->thread_states[i].ioq);
-            }
+            LOG(LOG_INFO, "Releasing unused queue elements for thread %d\n", i);
+            drain_queue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, handle->thread_states[i].ioq);
          }
          tq_next_thread_status(handle->thread_queues[i], NULL);
          tq_close(handle->thread_queues[i]);
-         destroy_ioqueue(handle->thread_states[i].ioq);
+         retire_ioqueue(handle, &(handle->thread_states[i].ioq));
       }
    }
 
@@ -1733,15 +2410,14 @@ int ne_abort(ne_handle handle) {
          tq_set_flags(handle->thread_queues[i], TQ_ABORT);
          tq_unset_flags(handle->thread_queues[i], TQ_HALT);
          // we need to empty any remaining elements from the queue
-         while (tq_dequeue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, NULL) > 0) {
-            LOG(LOG_INFO, "Releasing unused thread queue element\n");
-         }
+         LOG(LOG_INFO, "Releasing unused thread queue elements\n");
+         drain_queue(handle->thread_queues[i], TQ_ABORT | TQ_HALT, NULL);
          while (release_ioblock(handle->thread_states[i].ioq) >= 0) {
             LOG(LOG_INFO, "Releasing unused ioblock\n");
          }
          tq_next_thread_status(handle->thread_queues[i], NULL);
          tq_close(handle->thread_queues[i]);
-         destroy_ioqueue(handle->thread_states[i].ioq);
+         retire_ioqueue(handle, &(handle->thread_states[i].ioq));
       }
    }
 
@@ -1812,6 +2488,30 @@ int ne_get_info(ne_handle handle, ne_erasure* epat, ne_state* sref) {
             sref->csum[i] = handle->thread_states[i].minfo.crcsum;
          }
       }
+      // combine stats of any live ioqueues with those already destroyed
+      ioqueue_stats total = handle->qstats;
+      if (handle->mode != NE_STAT) {
+         int i;
+         for (i = 0; i < handle->epat.N + handle->epat.E; i++) {
+            ioqueue_stats qstats;
+            if (handle->thread_states[i].ioq == NULL ||
+                ioqueue_getstats(handle->thread_states[i].ioq, &(qstats))) {
+               continue;
+            }
+            total.stalls += qstats.stalls;
+            total.stallns += qstats.stallns;
+            total.grows += qstats.grows;
+            total.shrinks += qstats.shrinks;
+            if (qstats.peakdepth > total.peakdepth) {
+               total.peakdepth = qstats.peakdepth;
+            }
+         }
+      }
+      sref->qstalls = total.stalls;
+      sref->qstallns = total.stallns;
+      sref->qgrows = total.grows;
+      sref->qshrinks = total.shrinks;
+      sref->qpeakdepth = total.peakdepth;
    }
 
    return 0;
@@ -1956,6 +2656,8 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
       outstates[i].minfo.totsz = 0;
       outstates[i].meta_error = 0;
       outstates[i].data_error = 0;
+      outstates[i].qdepth = handle->qdepth;
+      outstates[i].qdepthmax = handle->qdepthmax;
    }
 
    TQ_Init_Opts tqopts = {0};
@@ -1967,7 +2669,7 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
    tqopts.log_prefix = lprefstr;
    // create a format string for each thread queue
    tqopts.init_flags = TQ_HALT; // initialize the threads in a HALTED state (essential for reads, doesn't hurt writes)
-   tqopts.max_qdepth = QDEPTH;
+   tqopts.max_qdepth = handle->qdepthmax + 1; // room for every ioblock the queue may hold
    tqopts.num_threads = 1;
    tqopts.num_prod_threads = 0;
    tqopts.thread_init_func = write_init;
@@ -1979,6 +2681,7 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
    // finally, startup the output threads for each in-error block
    for (i = 0; i < handle->epat.N + handle->epat.E; i++) {
       outstates[i].dmode = DAL_REBUILD;
+      outstates[i].numa_node = handle->numa_node;
       tqopts.global_state = &(outstates[i]);
       // only initialize threads for blocks with errors
       if (handle->thread_states[i].data_error || handle->thread_states[i].meta_error) {
@@ -2032,11 +2735,14 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
       if (OutTQs[i] != NULL) {
          LOG(LOG_INFO, "Prepping block %d for output\n", i);
          // initialize ioqueues
-         outstates[i].ioq = create_ioqueue(handle->versz, handle->epat.partsz, DAL_REBUILD);
+         outstates[i].ioq = create_ioqueue(handle->versz, handle->epat.partsz, DAL_REBUILD, handle->qdepth, handle->qdepthmax);
          if (outstates[i].ioq == NULL) {
             LOG(LOG_ERR, "Failed to create ioqueue for thread %d!\n", i);
             break;
          }
+         if (handle->numa_node >= 0) {
+            bind_ioqueue(outstates[i].ioq, handle->numa_node); // failure only costs locality
+         }
          // remove the PAUSE flag, allowing thread to begin processing
          if (tq_unset_flags(OutTQs[i], TQ_HALT)) {
             LOG(LOG_ERR, "Failed to unset PAUSE flag for block %d\n", i);
@@ -2061,32 +2767,110 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
       return -1;
    }
 
+   // prepare our decode threads and stripe sets
+   // NOTE -- the rebuild is pipelined across three stages : the per-block read threads fill ioblocks
+   //         ahead of us, decode threads regenerate bad stripes of up to REBUILD_SETS sets of ioblocks
+   //         concurrently, and output threads write out the regenerated blocks
+   int threads = handle->ctxt->rebuild_threads;
+   rebuild_gstate dgstate = { .N = N, .E = E, .partsz = partsz, .numa_node = handle->numa_node, .erasurelock = handle->ctxt->erasurelock };
+   rebuild_set sets[REBUILD_SETS];
+   ThreadQueue DecodeTQ = NULL;
+   int failed = 0;
+   bzero(sets, sizeof(sets));
+   for (i = 0; i < REBUILD_SETS; i++) {
+      sets[i].iob = calloc(N + E, sizeof(ioblock*));
+      sets[i].work = calloc(threads, sizeof(rebuild_work));
+      if (sets[i].iob == NULL || sets[i].work == NULL) {
+         LOG(LOG_ERR, "Failed to allocate space for rebuild stripe sets!\n");
+         failed = 1;
+      }
+   }
+   if (!failed && pthread_mutex_init(&(dgstate.lock), NULL)) {
+      LOG(LOG_ERR, "Failed to initialize decode lock\n");
+      failed = 1;
+   }
+   else if (!failed && pthread_cond_init(&(dgstate.complete), NULL)) {
+      LOG(LOG_ERR, "Failed to initialize decode condition\n");
+      pthread_mutex_destroy(&(dgstate.lock));
+      failed = 1;
+   }
+   if (!failed) {
+      TQ_Init_Opts dopts = {0};
+      dopts.log_prefix = "RDQ";
+      dopts.init_flags = TQ_NONE;
+      dopts.max_qdepth = threads * REBUILD_SETS;
+      dopts.global_state = &(dgstate);
+      dopts.num_threads = threads;
+      dopts.num_prod_threads = 0;
+      dopts.thread_init_func = rebuild_init;
+      dopts.thread_consumer_func = rebuild_consume;
+      dopts.thread_term_func = rebuild_term;
+      DecodeTQ = tq_init(&dopts);
+      if (DecodeTQ == NULL) {
+         LOG(LOG_ERR, "Failed to initialize decode thread queue!\n");
+         failed = 1;
+      }
+      else if (tq_check_init(DecodeTQ)) {
+         LOG(LOG_ERR, "Detected init failure for decode thread queue\n");
+         tq_set_flags(DecodeTQ, TQ_ABORT);
+         while (tq_next_thread_status(DecodeTQ, NULL) > 0) {}
+         tq_close(DecodeTQ);
+         DecodeTQ = NULL;
+         failed = 1;
+      }
+      if (DecodeTQ == NULL) {
+         pthread_cond_destroy(&(dgstate.complete));
+         pthread_mutex_destroy(&(dgstate.lock));
+      }
+   }
+
    // actually perform the rebuild
+   size_t gathered = 0;
    size_t rebuilt = 0;
-   while (rebuilt < handle->totsz) {
-      LOG(LOG_INFO, "Performing rebuild of stripes %d - %d\n", (int)(rebuilt / stripesz), (int)((rebuilt + handle->iob_datasz) / stripesz));
-      // read in new ioblocks, if necessary
-      if (handle->sub_offset >= (handle->iob_datasz * N)) {
-         LOG(LOG_INFO, "Reading in additional stripes (rebuilt=%zu)\n", rebuilt);
-         if (read_stripes(handle)) {
+   int fillset = 0;
+   int drainset = 0;
+   int heldsets = 0;
+   size_t blockoff = handle->iob_offset;
+   while (!failed && rebuilt < handle->totsz) {
+      // read in and dispatch as many sets of stripes as our pipeline allows
+      while (heldsets < REBUILD_SETS && gathered < handle->totsz) {
+         rebuild_set* set = &(sets[fillset]);
+         if (gather_rebuild_set(handle, set)) {
             LOG(LOG_ERR, "Failed to read in additional stripes!\n");
-            for (i = 0; i < N + E; i++) {
-               if (OutTQs[i] != NULL) {
-                  tq_set_flags(OutTQs[i], TQ_ABORT);
-                  tq_next_thread_status(OutTQs[i], NULL);
-                  tq_close(OutTQs[i]);
-               }
-            }
-            return -1;
+            // the set may still hold some ioblocks; treat it as held, to be released below
+            heldsets++;
+            failed = 1;
+            break;
+         }
+         heldsets++;
+         fillset = (fillset + 1) % REBUILD_SETS;
+         LOG(LOG_INFO, "Dispatching rebuild of stripes %d - %d\n", (int)(gathered / stripesz), (int)((gathered / stripesz) + set->stripecnt));
+         gathered += set->iob[0]->data_size * N;
+         if (dispatch_rebuild_set(DecodeTQ, &(dgstate), set, threads)) {
+            LOG(LOG_ERR, "Failed to dispatch decode work!\n");
+            failed = 1;
+            break;
          }
       }
+      if (failed) {
+         break;
+      }
+
+      // complete the oldest set, overlapping with decode of any following set
+      rebuild_set* set = &(sets[drainset]);
+      if (wait_rebuild_set(&(dgstate), set)) {
+         LOG(LOG_ERR, "Failed to regenerate stripes!\n");
+         failed = 1;
+         break;
+      }
+      size_t iob_datasz = set->iob[0]->data_size;
 
       // copy ioblock data off to our writer threads
-      for (i = 0; i < N + E; i++) {
+      for (i = 0; i < N + E && !failed; i++) {
          // only copy to running output threads
          if (OutTQs[i] != NULL) {
             size_t block_cpy = 0;
-            while (block_cpy < handle->iob_datasz) {
+            while (block_cpy < iob_datasz) {
 
                // check that the current ioblock has room for our data
                int reserved;
@@ -2095,7 +2879,7 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
                   void* tgt = ioblock_write_target(outblocks[i]);
                   // copy caller data into our ioblock
                   LOG(LOG_INFO, "Copying %zu bytes out to block %d\n", partsz, i);
-                  memcpy(tgt, handle->iob[i]->buff + block_cpy, partsz); // no error check, SEGFAULT or nothing
+                  memcpy(tgt, set->iob[i]->buff + block_cpy, partsz); // no error check, SEGFAULT or nothing
                   block_cpy += partsz;
                   ioblock_update_fill(outblocks[i], partsz, 0);
                }
@@ -2104,35 +2888,79 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
                   // the block is full and must be pushed to our iothread
                   if (tq_enqueue(OutTQs[i], TQ_NONE, (void*)push_block)) {
                      LOG(LOG_ERR, "Failed to push ioblock to thread_queue %d\n", i);
-                     for (i = 0; i < N + E; i++) {
-                        if (OutTQs[i] != NULL) {
-                           tq_set_flags(OutTQs[i], TQ_ABORT);
-                           tq_next_thread_status(OutTQs[i], NULL);
-                           tq_close(OutTQs[i]);
-                        }
-                     }
-                     errno = EBADF;
-                     return -1;
+                     failed = 1;
+                     break;
                   }
                }
                else {
                   LOG(LOG_ERR, "Failed to reserve ioblock for position %d!\n", i);
-                  for (i = 0; i < N + E; i++) {
-                     if (OutTQs[i] != NULL) {
-                        tq_set_flags(OutTQs[i], TQ_ABORT);
-                        tq_next_thread_status(OutTQs[i], NULL);
-                        tq_close(OutTQs[i]);
-                     }
-                  }
-                  errno = EBADF;
-                  return -1;
+                  failed = 1;
+                  break;
                }
             }
          }
       } // end of per-block for-loop
-      rebuilt += (handle->iob_datasz * N);
-      handle->sub_offset += (handle->iob_datasz * N);
+      if (failed) {
+         errno = EBADF;
+         break;
+      }
+
+      // release our input ioblocks, allowing the read threads to proceed
+      for (i = 0; i < N + E; i++) {
+         if (release_ioblock(handle->thread_states[i].ioq)) {
+            LOG(LOG_ERR, "Failed to release ioblock reference for block %d!\n", i);
+            failed = 1;
+         }
+         set->iob[i] = NULL;
+      }
+      heldsets--;
+      drainset = (drainset + 1) % REBUILD_SETS;
+      blockoff += iob_datasz;
+      rebuilt += (iob_datasz * N);
+   }
+
+   // shut down our decode threads, allowing any outstanding work to complete
+   if (DecodeTQ) {
+      if (tq_set_flags(DecodeTQ, TQ_FINISHED)) {
+         LOG(LOG_ERR, "Failed to set a FINISHED state for decode threads!\n");
+         failed = 1;
+      }
+      while (tq_next_thread_status(DecodeTQ, NULL) > 0) {}
+      tq_close(DecodeTQ);
+      pthread_cond_destroy(&(dgstate.complete));
+      pthread_mutex_destroy(&(dgstate.lock));
+   }
+   // release any ioblocks still held by incomplete sets ( only possible on failure )
+   for (; heldsets > 0; heldsets--) {
+      for (i = 0; i < N + E; i++) {
+         if (sets[drainset].iob[i] != NULL) {
+            release_ioblock(handle->thread_states[i].ioq);
+            sets[drainset].iob[i] = NULL;
+         }
+      }
+      drainset = (drainset + 1) % REBUILD_SETS;
+   }
+   for (i = 0; i < REBUILD_SETS; i++) {
+      free(sets[i].iob);
+      free(sets[i].work);
+   }
+   if (failed) {
+      int origerrno = errno;
+      for (i = 0; i < N + E; i++) {
+         if (OutTQs[i] != NULL) {
+            tq_set_flags(OutTQs[i], TQ_ABORT);
+            tq_next_thread_status(OutTQs[i], NULL);
+            tq_close(OutTQs[i]);
+         }
+      }
+      handle->mode = NE_ERR; // read threads may be at any offset, so make sure no one tries to reuse this handle
+      errno = origerrno;
+      return -1;
    }
+   // record our new position, so that any rerun will reseek
+   handle->iob_offset = blockoff;
+   handle->iob_datasz = 0;
+   handle->sub_offset = 0;
 
    // finally, terminate the output threads
    //
@@ -2193,7 +3021,7 @@ int ne_rebuild(ne_handle handle, ne_erasure* epat, ne_state* sref) {
          LOG(LOG_INFO, "Terminating queue %d\n", i);
          tq_next_thread_status(OutTQs[i], NULL);
          tq_close(OutTQs[i]);
-         destroy_ioqueue(outstates[i].ioq);
+         retire_ioqueue(handle, &(outstates[i].ioq));
       }
       else if (handle->thread_states[i].meta_error || handle->thread_states[i].data_error) {
          // if errors exist for which we never started output threads, record them
@@ -2593,6 +3421,7 @@ ssize_t ne_read(ne_handle handle, void* buffer, size_t bytes) {
  * @return ssize_t : The number of bytes successfully written, or -1 on a failure
  */
 ssize_t ne_write(ne_handle handle, const void* buffer, size_t bytes) {
+   PERF_SPAN( span, PERF_NE_WRITE );
 
    // necessary?
    if (bytes > UINT_MAX) {
@@ -2710,7 +3539,9 @@ ssize_t ne_write(ne_handle handle, const void* buffer, size_t bytes) {
                return -1;
             }
             // generate erasure parts
+            uint64_t perfbegin = perf_begin();
             ec_encode_data(partsz, N, E, handle->g_tbls, (unsigned char**)tgt_refs, (unsigned char**)&(tgt_refs[N]));
+            perf_end( PERF_NE_ENCODE, perfbegin, (size_t)partsz * N );
             // exiting critical section
             if ( pthread_mutex_unlock( handle->ctxt->erasurelock ) ) {
                LOG( LOG_ERR, "Failed to relinquish erasurelock after encoding of stripe %d\n", stripenum );
@@ -2747,6 +3578,7 @@ ssize_t ne_write(ne_handle handle, const void* buffer, size_t bytes) {
 
    // we have output all data
    free(tgt_refs);
+   span.bytes = written;
    return written;
 }
 
@@ -91,6 +91,13 @@ typedef struct ne_state_struct
 
  // per-part info
  uint64_t *csum; // user allocated region, must be at least ( sizeof(uint64_t) * max_block ) bytes; ignored if NULL
+
+ // ioqueue behavior, summed over all blocks ( useful for tuning of 'qdepth' / 'qdepthmax' )
+ uint64_t qstalls;        // count of ioblock reservations which waited for an available ioblock
+ uint64_t qstallns;       // total time spent waiting for available ioblocks
+ unsigned int qgrows;     // count of ioblocks added to adaptive ioqueues
+ unsigned int qshrinks;   // count of ioblocks released by adaptive ioqueues, due to memory pressure
+ int qpeakdepth;          // greatest depth reached by any ioqueue
 } ne_state;
 
 // location struct
@@ -111,6 +118,13 @@ typedef struct ne_ctxt_struct *ne_ctxt; // forward decl.
 /**
  * Initializes a new ne_ctxt
  * @param xmlNode* dal_root : Root of a libxml2 DAL node describing data access
+ *                            NOTE -- an optional 'numa' attribute of this node binds the block threads,
+ *                            ioblock memory, and rebuild threads of each handle to a single NUMA node
+ *                            ( within their inherited CPU affinity ).  Calling threads are never rebound.
+ *                            Its value is either a node number, or "balance" to assign handles to
+ *                            all nodes in turn.
+ *                            NOTE -- optional 'qdepth' and 'qdepthmax' attributes set the initial and
+ *                            maximum number of ioblocks queued by each block thread ( see ne_set_qdepth() ).
  * @param ne_location max_loc : ne_location struct containing maximum allowable pod/cap/scatter
  *                              values for this context
  * @param int max_block : Integer maximum block value ( N + E ) for this context
@@ -151,6 +165,27 @@ ne_ctxt ne_path_init(const char *path, ne_location max_loc, int max_block, pthre
  */
 int ne_verify(ne_ctxt ctxt, char fix);
 
+/**
+ * Set the number of decode threads used by ne_rebuild() for handles of the given ne_ctxt
+ * @param ne_ctxt ctxt : Reference to the ne_ctxt to be updated
+ * @param int threads : Number of decode threads ( zero will restore the default value )
+ * @return int : Zero on a success, and -1 on a failure
+ */
+int ne_set_rebuild_threads(ne_ctxt ctxt, int threads);
+
+/**
+ * Set the initial and maximum ioqueue depth ( ioblocks per block thread ) for new handles of the given ne_ctxt
+ * NOTE -- A maximum greater than the initial depth allows ioqueues to grow whenever an ioblock reservation
+ *         has to wait for one, so as to hide the latency of slow backends.  Grown ioqueues shrink back
+ *         toward their initial depth when the system runs low on memory.  Resulting stall counters are
+ *         reported through ne_get_info() / ne_close().
+ * @param ne_ctxt ctxt : Reference to the ne_ctxt to be updated
+ * @param int depth : Initial ( and minimum ) depth of each ioqueue ( zero will restore the default value )
+ * @param int maxdepth : Maximum depth of each ioqueue ( values <= depth disable adaptive growth )
+ * @return int : Zero on a success, and -1 on a failure
+ */
+int ne_set_qdepth(ne_ctxt ctxt, int depth, int maxdepth);
+
 /**
  * Destroys an existing ne_ctxt
  * @param ne_ctxt ctxt : Reference to the ne_ctxt to be destroyed
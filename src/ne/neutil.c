@@ -36,6 +36,7 @@
 #include <time.h>
 
 #include "ne.h"
+#include "dal/dal.h"
 
 #define PRINTout(FMT, ...) fprintf(stdout, preFMT FMT, "neutil", ##__VA_ARGS__)
 #ifdef DEBUG
@@ -569,100 +570,9 @@ int main(int argc, const char** argv) {
    xmlNode* root = NULL;
    if (config_path) {
       xmlDoc* doc = NULL;
-
-      char* fields;
-      if (!(fields = strchr(config_path, ':'))) {
-         printf("error: could not separate path from fields %s\n", config_path);
-         return -1;
-      }
-      *fields = '\0';
-      fields += 2;
-
-      /*
-      * this initialize the library and check potential ABI mismatches
-      * between the version it was compiled for and the actual shared
-      * library used.
-      */
-      LIBXML_TEST_VERSION
-
-         /*parse the file and get the DOM */
-         doc = xmlReadFile(config_path, NULL, XML_PARSE_NOBLANKS);
-
-      if (doc == NULL) {
-         printf("error: could not parse file %s\n", config_path);
-         return -1;
-      }
-
-      /*Get the root element node */
-      root = xmlDocGetRootElement(doc);
-
-      char* tag = NULL;
-      char* attr = NULL;
-      char* val = NULL;
-      int last = 0;
-      while (root) {
-         char* next;
-         if (!tag) {
-            if (!(next = strchr(fields, '/'))) {
-               next = strchr(fields + 1, '\0');
-               last = 1;
-            }
-            *next = '\0';
-            if ((attr = strchr(fields, ' '))) {
-               *attr = '\0';
-               attr++;
-               if (!(val = strchr(attr, '='))) {
-                  printf("error: could not find field value for attribute %s in field with tag %s\n", attr, fields);
-                  return -1;
-               }
-               else {
-                  *val = '\0';
-                  val++;
-               }
-            }
-            tag = fields;
-            fields = next + 1;
-         }
-         if (root->type == XML_ELEMENT_NODE && !strcmp((char*)root->name, tag)) {
-            if (val) {
-               xmlAttr* type = root->properties;
-               while (type) {
-                  if (type->type == XML_ATTRIBUTE_NODE && !strcmp((char*)type->name, attr) && type->children->type == XML_TEXT_NODE && !strcmp((char*)type->children->content, val)) {
-                     if (!last) {
-                        root = root->children;
-                     }
-                     tag = NULL;
-                     attr = NULL;
-                     val = NULL;
-                     break;
-                  }
-                  type = type->next;
-               }
-               if (!type) {
-                  root = root->next;
-                  /*printf("error: could not find attribute %s with value %s in field %s within file %s\n", attr, val, tag, config_path);
-                  return -1;*/
-               }
-               if (last) {
-                  break;
-               }
-            }
-            else {
-               if (last) {
-                  break;
-               }
-               root = root->children;
-               tag = NULL;
-               attr = NULL;
-               val = NULL;
-            }
-         }
-         else {
-            root = root->next;
-         }
-      }
+      root = find_dal_config(config_path, &doc);
       if (!root) {
-         printf("error: could not find DAL in file %s\n", config_path);
+         printf("error: could not find DAL in file %s (%s)\n", config_path, strerror(errno));
          return -1;
       }
 
@@ -0,0 +1,200 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "ne/ne.c" // include C file directly, to allow access to the decode cache
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_N 6
+#define TEST_E 3
+#define TEST_THREADS 8
+#define TEST_ITERATIONS 20
+#define TEST_MAXPATTERNS 256
+
+typedef struct decode_pattern_struct {
+   int nerrs;
+   unsigned char err_list[TEST_E];
+} decode_pattern;
+
+typedef struct decode_tblset_struct {
+   unsigned char decode_index[TEST_N];
+   unsigned char g_tbls[TEST_N * TEST_E * 32];
+} decode_tblset;
+
+static decode_pattern patterns[TEST_MAXPATTERNS];
+static int patterncnt = 0;
+static pthread_mutex_t erasurelock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Scratch space for decode table generation
+ */
+typedef struct decode_scratch_struct {
+   unsigned char encode_matrix[(TEST_N + TEST_E) * TEST_N];
+   unsigned char decode_matrix[(TEST_N + TEST_E) * TEST_N];
+   unsigned char invert_matrix[(TEST_N + TEST_E) * TEST_N];
+   unsigned char tmpmatrix[TEST_N * TEST_N];
+} decode_scratch;
+
+int cached_tables(decode_pattern* pat, decode_tblset* tbls, decode_scratch* scratch) {
+   return get_decode_tables(&erasurelock, TEST_N, TEST_E, pat->err_list, pat->nerrs,
+      tbls->decode_index, tbls->g_tbls, scratch->encode_matrix, scratch->decode_matrix,
+      scratch->invert_matrix, scratch->tmpmatrix);
+}
+
+// generate tables directly, bypassing the decode cache
+int reference_tables(decode_pattern* pat, decode_tblset* tbls, decode_scratch* scratch) {
+   gf_gen_cauchy1_matrix(scratch->encode_matrix, TEST_N + TEST_E, TEST_N);
+   if (gf_gen_decode_matrix_simple(scratch->encode_matrix, scratch->decode_matrix, scratch->invert_matrix,
+          scratch->tmpmatrix, tbls->decode_index, pat->err_list, pat->nerrs, TEST_N, TEST_N + TEST_E)) {
+      return -1;
+   }
+   ec_init_tables(TEST_N, pat->nerrs, scratch->decode_matrix, tbls->g_tbls);
+   return 0;
+}
+
+int tblset_cmp(decode_pattern* pat, decode_tblset* tbls1, decode_tblset* tbls2) {
+   if (memcmp(tbls1->decode_index, tbls2->decode_index, TEST_N)) {
+      return -1;
+   }
+   return memcmp(tbls1->g_tbls, tbls2->g_tbls, (size_t)TEST_N * pat->nerrs * 32);
+}
+
+static decode_tblset reftbls[TEST_MAXPATTERNS];
+
+void* lookup_thread(void* arg) {
+   int tnum = *((int*)arg);
+   decode_scratch scratch;
+   decode_tblset tbls;
+   int iter;
+   for (iter = 0; iter < TEST_ITERATIONS; iter++) {
+      int index;
+      for (index = 0; index < patterncnt; index++) {
+         // each thread walks the patterns from a different starting point
+         int pnum = (index + (tnum * 17)) % patterncnt;
+         memset(&tbls, 0, sizeof(tbls));
+         if (cached_tables(patterns + pnum, &tbls, &scratch)) {
+            printf("ERROR: thread %d failed to retrieve tables of pattern %d\n", tnum, pnum);
+            return (void*)1;
+         }
+         if (tblset_cmp(patterns + pnum, &tbls, reftbls + pnum)) {
+            printf("ERROR: thread %d retrieved incorrect tables for pattern %d\n", tnum, pnum);
+            return (void*)1;
+         }
+      }
+   }
+   return NULL;
+}
+
+// count the cache entries matching the given pattern
+int cache_entries(decode_pattern* pat) {
+   int count = 0;
+   int bucket;
+   for (bucket = 0; bucket < DECODE_CACHE_BUCKETS; bucket++) {
+      decode_entry* entry = decode_cache.buckets[bucket];
+      for (; entry; entry = entry->next) {
+         if (entry->N == TEST_N && entry->E == TEST_E && entry->nerrs == pat->nerrs &&
+             !memcmp(entry->err_list, pat->err_list, pat->nerrs)) {
+            count++;
+         }
+      }
+   }
+   return count;
+}
+
+int main(int argc, char** argv) {
+   // enumerate every recoverable set of failed blocks ( in ascending order )
+   int a, b, c;
+   for (a = 0; a < TEST_N + TEST_E; a++) {
+      patterns[patterncnt].nerrs = 1;
+      patterns[patterncnt].err_list[0] = a;
+      patterncnt++;
+      for (b = a + 1; b < TEST_N + TEST_E; b++) {
+         patterns[patterncnt].nerrs = 2;
+         patterns[patterncnt].err_list[0] = a;
+         patterns[patterncnt].err_list[1] = b;
+         patterncnt++;
+         for (c = b + 1; c < TEST_N + TEST_E; c++) {
+            patterns[patterncnt].nerrs = 3;
+            patterns[patterncnt].err_list[0] = a;
+            patterns[patterncnt].err_list[1] = b;
+            patterns[patterncnt].err_list[2] = c;
+            patterncnt++;
+         }
+      }
+   }
+   decode_scratch scratch;
+   int index;
+   for (index = 0; index < patterncnt; index++) {
+      if (reference_tables(patterns + index, reftbls + index, &scratch)) {
+         printf("ERROR: failed to generate reference tables for pattern %d\n", index);
+         return -1;
+      }
+   }
+   printf("Generated reference tables for %d failure patterns\n", patterncnt);
+
+   // a first lookup should populate the cache, and a second should be served from it
+   decode_tblset tbls;
+   if (cached_tables(patterns, &tbls, &scratch) || tblset_cmp(patterns, &tbls, reftbls)) {
+      printf("ERROR: initial lookup produced incorrect tables\n");
+      return -1;
+   }
+   if (decode_cache.count != 1 || cache_entries(patterns) != 1) {
+      printf("ERROR: initial lookup did not populate the decode cache ( count = %zu )\n", decode_cache.count);
+      return -1;
+   }
+   // corrupt the cached tables, so that a cache hit is distinguishable from regeneration
+   decode_entry* entry = decode_cache_find(decode_cache_bucket(TEST_N, TEST_E, patterns->err_list, patterns->nerrs),
+      TEST_N, TEST_E, patterns->err_list, patterns->nerrs);
+   unsigned char savedbyte = entry->g_tbls[0];
+   entry->g_tbls[0] ^= 0xFF;
+   if (cached_tables(patterns, &tbls, &scratch) || tbls.g_tbls[0] != entry->g_tbls[0]) {
+      printf("ERROR: repeated lookup was not served from the decode cache\n");
+      return -1;
+   }
+   entry->g_tbls[0] = savedbyte;
+   if (decode_cache.count != 1) {
+      printf("ERROR: repeated lookup altered the decode cache count ( count = %zu )\n", decode_cache.count);
+      return -1;
+   }
+
+   // concurrent lookups, a mix of hits and racing insertions, should all produce correct tables
+   pthread_t threads[TEST_THREADS];
+   int tnums[TEST_THREADS];
+   for (index = 0; index < TEST_THREADS; index++) {
+      tnums[index] = index;
+      if (pthread_create(threads + index, NULL, lookup_thread, tnums + index)) {
+         printf("ERROR: failed to create lookup thread %d\n", index);
+         return -1;
+      }
+   }
+   int failures = 0;
+   for (index = 0; index < TEST_THREADS; index++) {
+      void* tres = NULL;
+      if (pthread_join(threads[index], &tres) || tres) {
+         failures++;
+      }
+   }
+   if (failures) {
+      printf("ERROR: %d lookup threads reported failures\n", failures);
+      return -1;
+   }
+   // every pattern should now be cached exactly once
+   if (decode_cache.count != (size_t)patterncnt) {
+      printf("ERROR: decode cache count ( %zu ) does not match pattern count ( %d )\n", decode_cache.count, patterncnt);
+      return -1;
+   }
+   for (index = 0; index < patterncnt; index++) {
+      if (cache_entries(patterns + index) != 1) {
+         printf("ERROR: pattern %d is cached %d times\n", index, cache_entries(patterns + index));
+         return -1;
+      }
+   }
+   printf("Decode cache served %d threads with %d failure patterns correctly\n", TEST_THREADS, patterncnt);
+   return 0;
+}
@@ -167,6 +167,15 @@ int test_values( ne_erasure* epat, size_t iosz, size_t partsz ) {
       printf( "ERROR: Failed to initialize ne_ctxt!\n" );
       return -1;
    }
+   // allow ioqueues to grow, rejecting depths too shallow for rebuilds
+   if ( ne_set_qdepth( ctxt, 2, 0 ) == 0 ) {
+      printf( "ERROR: Unexpected success of ne_set_qdepth() with an insufficient depth!\n" );
+      return -1;
+   }
+   if ( ne_set_qdepth( ctxt, 3, 16 ) ) {
+      printf( "ERROR: Failed to set ioqueue depth!\n" );
+      return -1;
+   }
 
    // open a write handle
    printf( "Writing out data stripe...\n" );
@@ -191,11 +200,17 @@ int test_values( ne_erasure* epat, size_t iosz, size_t partsz ) {
       }
    }
    // close our handle
-   if ( ne_close( write_handle, NULL, NULL ) ) {
+   ne_state wstate = {0};
+   if ( ne_close( write_handle, NULL, &wstate ) ) {
       printf( "ERROR: Failure of ne_close!\n" );
       return -1;
    }
-   printf( "...write handle closed...\n" );
+   if ( wstate.qpeakdepth < 3  ||  wstate.qpeakdepth > 16  ||  ( wstate.qgrows == 0 ) != ( wstate.qpeakdepth == 3 ) ) {
+      printf( "ERROR: Unexpected ioqueue depth stats ( peak %d, %u grows )!\n", wstate.qpeakdepth, wstate.qgrows );
+      return -1;
+   }
+   printf( "...write handle closed ( %llu ioqueue stalls, peak depth %d )...\n",
+           (unsigned long long)wstate.qstalls, wstate.qpeakdepth );
 
 
    // open a read handle to verify our data
@@ -305,6 +320,59 @@ int test_values( ne_erasure* epat, size_t iosz, size_t partsz ) {
       return -1;
    }
 
+   // damage some blocks and rebuild them, with both a single and multiple decode threads
+   int rthreads;
+   for ( rthreads = 1; rthreads <= 3; rthreads += 2 ) {
+      printf( "...Rebuilding damaged blocks with %d decode threads...\n", rthreads );
+      if ( ne_set_rebuild_threads( ctxt, rthreads ) ) {
+         printf( "ERROR: Failed to set rebuild thread count!\n" );
+         return -1;
+      }
+      int eblock;
+      for ( eblock = 0; eblock < epat->E; eblock++ ) {
+         char blockpath[1024];
+         snprintf( blockpath, 1024, "./test_libne_io.block%d.pod0.cap0.scatter0", (eblock * 3) + rthreads );
+         if ( unlink( blockpath ) ) {
+            printf( "ERROR: Failed to remove block file \"%s\"!\n", blockpath );
+            return -1;
+         }
+      }
+      ne_handle rebuild_handle = ne_open( ctxt, "", cur_loc, *epat, NE_REBUILD );
+      if ( rebuild_handle == NULL ) {
+         printf( "ERROR: Failed to open a rebuild handle!\n" );
+         return -1;
+      }
+      int rebuildres = ne_rebuild( rebuild_handle, NULL, NULL );
+      if ( rebuildres ) {
+         printf( "ERROR: Unexpected return value from ne_rebuild: %d\n", rebuildres );
+         return -1;
+      }
+      if ( ne_close( rebuild_handle, NULL, NULL ) ) {
+         printf( "ERROR: Failure of rebuild handle ne_close!\n" );
+         return -1;
+      }
+      // verify that all blocks are now intact
+      read_handle = ne_open( ctxt, "", cur_loc, *epat, NE_RDALL );
+      if ( read_handle == NULL ) {
+         printf( "ERROR: Failed to open a read handle!\n" );
+         return -1;
+      }
+      for ( i = 0; i < iocnt; i++ ) {
+         if ( iosz != ne_read( read_handle, iobuff, iosz ) ) {
+            printf( "ERROR: Unexpected return value from ne_read!\n" );
+            return -1;
+         }
+         if ( iosz != verify_data( iosz * i, partsz, iosz, iobuff ) ) {
+            printf( "ERROR: Failed to verify rebuilt data!\n" );
+            return -1;
+         }
+      }
+      if ( ne_close( read_handle, NULL, NULL ) ) {
+         printf( "ERROR: Errors remain after rebuild!\n" );
+         return -1;
+      }
+   }
+
    // delete our test object
    if ( ne_delete( ctxt, "", cur_loc ) ) {
       printf( "ERROR: Failed to delete written object!\n" );
@@ -32,8 +32,18 @@ typedef struct recovery_struct {
    RECOVERY_FINFO* fileinfo;
    void** filebuffers;
    size_t* buffersizes;
+   void* objbuffer;        // data content of the current object
+   RECOVERY_INDEX* index;  // INDEX of the current object ( NULL, if absent or unused )
+   size_t indexcount;
+   recovery_readfunc readfunc; // on-demand reader of the current object ( NULL, if in memory )
+   void* rctxt;
+   void* ownedbuffer;      // full object content, read by us ( unindexed reader objects only )
+   char* scratch;          // target of on-demand reads
+   size_t scratchsize;
 }* RECOVERY;
 
+#define RECOVERY_HEADER_READSIZE 4096 // initial read size, when searching for a header string
+
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
@@ -474,7 +484,90 @@ void* parse_recov_finfo( void* finfobuf, size_t bufsize, RECOVERY_FINFO* finfo )
    return parse + (taillen - 1);
 }
 
+void release_fileinfo( RECOVERY recov ) {
+   if ( recov->ownedbuffer ) {
+      free( recov->ownedbuffer );
+      recov->ownedbuffer = NULL;
+      recov->objbuffer = NULL;
+   }
+   // indexed objects only produce FINFO values as they are requested
+   if ( recov->index ) {
+      free( recov->index );
+      recov->index = NULL;
+      recov->indexcount = 0;
+      recov->curfile = 0;
+      return;
+   }
+   while ( recov->curfile ) {
+      free( recov->fileinfo[ recov->curfile - 1 ].path );
+      recov->curfile--;
+   }
+}
+
+// returns 1 if the INDEX string was attached, 0 if it is unusable, and -1 if it is not an INDEX at all
+int attach_index( RECOVERY recov, char* indexstr, size_t indexlen, size_t headerlen, size_t indexoffset ) {
+   // a FINFO path could coincidentally end in a length value, so check for a leading
+   //  index type string before assuming that the index occupies the object tail
+   size_t headlen = strlen( RECOVERY_MSGHEAD );
+   if ( strncmp( indexstr, RECOVERY_MSGHEAD, headlen )  ||
+        strncmp( indexstr + headlen, RECOVERY_INDEX_TYPE, strlen( RECOVERY_INDEX_TYPE ) ) ) {
+      LOG( LOG_INFO, "Object tail does not correspond to a RECOVERY_INDEX\n" );
+      return -1;
+   }
+   RECOVERY_INDEX* index = NULL;
+   size_t count = 0;
+   if ( recovery_indexfromstr( &(index), &(count), indexstr, indexlen ) ) {
+      LOG( LOG_WARNING, "Failed to parse RECOVERY_INDEX, falling back to a FINFO scan\n" );
+      return 0;
+   }
+   // verify that the index exactly describes the object content
+   size_t expected = headerlen;
+   size_t entry = 0;
+   for ( ; entry < count; entry++ ) {
+      RECOVERY_INDEX* ref = index + entry;
+      if ( ref->dataoffset != expected  ||  ref->finfooffset > indexoffset  ||
+           ref->finfooffset - ref->dataoffset != ref->datalength  ||
+           ref->finfolength == 0  ||  ref->finfolength > indexoffset - ref->finfooffset ) {
+         break;
+      }
+      expected = ref->finfooffset + ref->finfolength;
+   }
+   if ( entry != count  ||  expected != indexoffset ) {
+      LOG( LOG_WARNING, "RECOVERY_INDEX entry %zu is inconsistent with object content, "
+                        "falling back to a FINFO scan\n", entry );
+      free( index );
+      return 0;
+   }
+   recov->index = index;
+   recov->indexcount = count;
+   recov->curfile = count;
+   return 1;
+}
+
+int populate_index( RECOVERY recov, void* headerend, size_t* objsize ) {
+   // only newer objects may include an index
+   if ( recov->header.majorversion == 0  &&  recov->header.minorversion < 2 ) { return 0; }
+   size_t taillen = recovery_indextaillen();
+   if ( *objsize < taillen ) { return 0; }
+   void* objend = headerend + 1 + *objsize;
+   size_t indexlen = recovery_indexlength( objend - taillen, taillen );
+   if ( indexlen == 0 ) {
+      LOG( LOG_INFO, "Object does not include a RECOVERY_INDEX\n" );
+      return 0;
+   }
+   if ( indexlen > *objsize ) {
+      LOG( LOG_WARNING, "RECOVERY_INDEX length of %zu exceeds object bounds\n", indexlen );
+      return 0;
+   }
+   size_t headerlen = ( headerend - recov->objbuffer ) + 1;
+   int res = attach_index( recov, objend - indexlen, indexlen, headerlen, headerlen + ( *objsize - indexlen ) );
+   if ( res >= 0 ) { *objsize -= indexlen; } // never scan an INDEX string as if it were a FINFO
+   return ( res > 0 ) ? 1 : 0;
+}
+
 int populate_recovery( RECOVERY recov, void* headerend, size_t objsize ) {
+   // prefer the object index, if one is present
+   if ( populate_index( recov, headerend, &(objsize) ) ) { return 0; }
    // traverse files in reverse, populating references as we go
    recov->curfile = 0;
    char errorcond = 0;
@@ -546,6 +639,90 @@ int populate_recovery( RECOVERY recov, void* headerend, size_t objsize ) {
    return 0;
 }
 
+// read exactly 'count' bytes of the current object, at the given offset
+int read_object( RECOVERY recov, void* buf, size_t count, off_t offset ) {
+   size_t done = 0;
+   while ( done < count ) {
+      ssize_t res = recov->readfunc( recov->rctxt, buf + done, count - done, offset + done );
+      if ( res < 0 ) {
+         LOG( LOG_ERR, "Failed to read %zu bytes of object content at offset %zu\n",
+                       count - done, (size_t)offset + done );
+         return -1;
+      }
+      if ( res == 0 ) {
+         LOG( LOG_ERR, "Object content ends prior to offset %zu\n", (size_t)offset + count );
+         errno = EINVAL;
+         return -1;
+      }
+      done += res;
+   }
+   return 0;
+}
+
+// read object content into our scratch buffer, expanding it as necessary
+char* read_scratch( RECOVERY recov, size_t count, off_t offset ) {
+   if ( count >= recov->scratchsize ) {
+      char* newscratch = realloc( recov->scratch, count + 1 );
+      if ( newscratch == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a read buffer of %zu bytes\n", count + 1 );
+         return NULL;
+      }
+      recov->scratch = newscratch;
+      recov->scratchsize = count + 1;
+   }
+   if ( read_object( recov, recov->scratch, count, offset ) ) { return NULL; }
+   recov->scratch[count] = '\0'; // never allow string parsing to run off the end of our buffer
+   return recov->scratch;
+}
+
+// read and parse the RECOVERY_HEADER of the current object, returning its length ( zero on failure )
+size_t read_header( RECOVERY recov, size_t objsize, RECOVERY_HEADER* header ) {
+   size_t readsize = RECOVERY_HEADER_READSIZE;
+   while ( 1 ) {
+      if ( readsize > objsize ) { readsize = objsize; }
+      char* headerbuf = read_scratch( recov, readsize, 0 );
+      if ( headerbuf == NULL ) { return 0; }
+      // only parse once the complete header string is in hand
+      if ( strstr( headerbuf, RECOVERY_MSGTAIL )  ||  readsize == objsize ) {
+         char* headerend = parse_recov_header( headerbuf, readsize, header );
+         if ( headerend == NULL ) { return 0; }
+         return ( headerend - headerbuf ) + 1;
+      }
+      readsize *= 2;
+   }
+}
+
+int populate_reader( RECOVERY recov, size_t headerlen, size_t objsize ) {
+   recov->curfile = 0;
+   // prefer the object index, if one is present, reading only the INDEX string itself
+   size_t taillen = recovery_indextaillen();
+   if ( ( recov->header.majorversion  ||  recov->header.minorversion >= 2 )  &&
+        objsize - headerlen >= taillen ) {
+      char* tailstr = read_scratch( recov, taillen, objsize - taillen );
+      if ( tailstr == NULL ) { return -1; }
+      size_t indexlen = recovery_indexlength( tailstr, taillen );
+      if ( indexlen  &&  indexlen <= objsize - headerlen ) {
+         char* indexstr = read_scratch( recov, indexlen, objsize - indexlen );
+         if ( indexstr == NULL ) { return -1; }
+         if ( attach_index( recov, indexstr, indexlen, headerlen, objsize - indexlen ) > 0 ) { return 0; }
+      }
+   }
+   // otherwise, we have no choice but to scan the full object content
+   LOG( LOG_INFO, "Object lacks a usable RECOVERY_INDEX, reading all %zu bytes\n", objsize );
+   recov->ownedbuffer = malloc( objsize );
+   if ( recov->ownedbuffer == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a %zu byte object buffer\n", objsize );
+      return -1;
+   }
+   if ( read_object( recov, recov->ownedbuffer, objsize, 0 ) ) {
+      free( recov->ownedbuffer );
+      recov->ownedbuffer = NULL;
+      return -1;
+   }
+   recov->objbuffer = recov->ownedbuffer;
+   return populate_recovery( recov, recov->ownedbuffer + ( headerlen - 1 ), objsize - headerlen );
+}
+
 
 //   -------------   EXTERNAL FUNCTIONS    -------------
 
@@ -661,6 +838,215 @@ int recovery_finfofromstr( RECOVERY_FINFO* finfo, char* srcstr, size_t len ) {
    return 0;
 }
 
+/**
+ * Produce a string representation of the given recovery INDEX
+ * @param const RECOVERY_INDEX* index : Reference to the list of INDEX entries to be encoded
+ * @param size_t count : Number of INDEX entries in the list
+ * @param char* tgtstr : Reference to the string buffer to be populated
+ * @param size_t len : Size of the provided buffer
+ * @return size_t : Length of the produced string ( excluding NULL-terminator ), or zero if
+ *                  an error occurred.
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t recovery_indextostr( const RECOVERY_INDEX* index, size_t count, char* tgtstr, size_t size ) {
+   // check for NULL references
+   if ( index == NULL  &&  count ) {
+      LOG( LOG_ERR, "Received a NULL index reference\n" );
+      return 0;
+   }
+   if ( tgtstr == NULL  &&  size != 0 ) {
+      LOG( LOG_ERR, "Asked to populate a NULL tgtstr\n" );
+      return 0;
+   }
+   // identify the total string length, which is itself included in the string
+   int prres = snprintf( NULL, 0, "%s%s%zu", RECOVERY_MSGHEAD, RECOVERY_INDEX_TYPE, count );
+   if ( prres < 0 ) { return 0; }
+   size_t indexlen = (size_t)prres + recovery_indextaillen();
+   size_t entry = 0;
+   for ( ; entry < count; entry++ ) {
+      prres = snprintf( NULL, 0, "|%zu:%zu:%zu:%zu",
+                        index[entry].finfooffset, index[entry].finfolength,
+                        index[entry].dataoffset, index[entry].datalength );
+      if ( prres < 0 ) { return 0; }
+      indexlen += prres;
+   }
+   if ( size == 0 ) { return indexlen; }
+   // construct the output string, truncating if necessary
+   char* output = tgtstr;
+   size_t remaining = size;
+   for ( entry = 0; entry <= count + 1; entry++ ) {
+      if ( entry == 0 ) {
+         prres = snprintf( output, remaining, "%s%s%zu", RECOVERY_MSGHEAD, RECOVERY_INDEX_TYPE, count );
+      }
+      else if ( entry <= count ) {
+         const RECOVERY_INDEX* ref = index + (entry - 1);
+         prres = snprintf( output, remaining, "|%zu:%zu:%zu:%zu",
+                           ref->finfooffset, ref->finfolength, ref->dataoffset, ref->datalength );
+      }
+      else {
+         prres = snprintf( output, remaining, "|%.*zu%s", SIZE_DIGITS, indexlen, RECOVERY_MSGTAIL );
+      }
+      if ( prres < 0 ) { return 0; }
+      if ( (size_t)prres >= remaining ) { break; } // output has been truncated
+      output += prres;
+      remaining -= prres;
+   }
+   return indexlen;
+}
+
+/**
+ * Identify the number of trailing object bytes required to locate a recovery INDEX
+ * @return size_t : Minimum length of the tail string provided to recovery_indexlength()
+ */
+size_t recovery_indextaillen( void ) {
+   // '|' seperator, fixed-width length value, and msg tail
+   return 1 + SIZE_DIGITS + strlen( RECOVERY_MSGTAIL );
+}
+
+/**
+ * Identify the length of the recovery INDEX string terminating the given object tail
+ * @param const char* tailstr : Reference to the final bytes of a data object
+ * @param size_t len : Length of the given tail string ( must be >= recovery_indextaillen() )
+ * @return size_t : Length of the INDEX string ending at the end of the given tail, or zero
+ *                  if the tail does not terminate with an INDEX string
+ *                  NOTE -- the returned length may exceed that of the tail string itself,
+ *                  and the INDEX string content is not verified until it is parsed
+ */
+size_t recovery_indexlength( const char* tailstr, size_t len ) {
+   // check for invalid args
+   size_t taillen = recovery_indextaillen();
+   if ( tailstr == NULL  ||  len < taillen ) {
+      LOG( LOG_ERR, "Received a NULL or insufficient tail string\n" );
+      errno = EINVAL;
+      return 0;
+   }
+   const char* parse = tailstr + ( len - taillen );
+   if ( *parse != '|' ) { return 0; }
+   parse++;
+   // parse the fixed-width length value
+   size_t indexlen = 0;
+   int digit = 0;
+   for ( ; digit < SIZE_DIGITS; digit++ ) {
+      if ( *parse < '0'  ||  *parse > '9' ) { return 0; }
+      size_t digitval = *parse - '0';
+      if ( indexlen > ( SIZE_MAX - digitval ) / 10 ) { return 0; }
+      indexlen = ( indexlen * 10 ) + digitval;
+      parse++;
+   }
+   if ( strncmp( parse, RECOVERY_MSGTAIL, strlen( RECOVERY_MSGTAIL ) ) ) { return 0; }
+   // the string must at least include its own header, type, and entry count
+   if ( indexlen < strlen( RECOVERY_MSGHEAD ) + strlen( RECOVERY_INDEX_TYPE ) + 1 + taillen ) {
+      return 0;
+   }
+   return indexlen;
+}
+
+/**
+ * Parse the given string representation of a recovery INDEX and populate a new list of
+ * RECOVERY_INDEX entries
+ * @param RECOVERY_INDEX** index : Reference to be populated with the new entry list
+ *                                 ( caller is responsible for freeing this list )
+ * @param size_t* count : Reference to be populated with the number of entries
+ * @param char* srcstr : Reference to the string to be parsed
+ * @param size_t len : Length of the given string ( excluding NULL-terminator )
+ * @return int : Zero on success, or -1 on failure
+ */
+int recovery_indexfromstr( RECOVERY_INDEX** index, size_t* count, char* srcstr, size_t len ) {
+   // check for NULL references
+   if ( index == NULL  ||  count == NULL ) {
+      LOG( LOG_ERR, "Received a NULL index or count reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( srcstr == NULL  ||  len < 1 ) {
+      LOG( LOG_ERR, "Asked to parse a NULL or empty srcstr\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // the string must terminate with its own length, which also bounds all numeric parsing
+   size_t taillen = recovery_indextaillen();
+   if ( len < taillen  ||  recovery_indexlength( srcstr + ( len - taillen ), taillen ) != len ) {
+      LOG( LOG_ERR, "RECOVERY_INDEX string has an inconsistent length value\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* bodyend = srcstr + ( len - taillen ); // '|' preceding the length value
+   char* parse = srcstr;
+   // validate the msg header and index type strings
+   size_t complen = strlen( RECOVERY_MSGHEAD );
+   if ( strncmp( parse, RECOVERY_MSGHEAD, complen ) ) {
+      LOG( LOG_ERR, "Failed to validate msg header of RECOVERY_INDEX string\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   parse += complen;
+   complen = strlen( RECOVERY_INDEX_TYPE );
+   if ( strncmp( parse, RECOVERY_INDEX_TYPE, complen ) ) {
+      LOG( LOG_ERR, "Failed to validate the RECOVERY_INDEX type string\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   parse += complen;
+   // parse the entry count
+   if ( *parse < '0'  ||  *parse > '9' ) {
+      LOG( LOG_ERR, "Failed to parse the RECOVERY_INDEX entry count\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* endptr = NULL;
+   unsigned long long parseval = strtoull( parse, &(endptr), 10 );
+   // each entry requires at least 8 characters ( "|0:0:0:0" )
+   if ( endptr > bodyend  ||  parseval > (unsigned long long)( bodyend - endptr ) / 8 ) {
+      LOG( LOG_ERR, "RECOVERY_INDEX entry count exceeds string bounds\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   size_t entrycount = (size_t)parseval;
+   parse = endptr;
+   RECOVERY_INDEX* entries = malloc( sizeof(RECOVERY_INDEX) * ( (entrycount) ? entrycount : 1 ) );
+   if ( entries == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate %zu RECOVERY_INDEX entries\n", entrycount );
+      return -1;
+   }
+   // parse all entry values
+   size_t entry = 0;
+   for ( ; entry < entrycount; entry++ ) {
+      size_t* values[4] = { &(entries[entry].finfooffset), &(entries[entry].finfolength),
+                            &(entries[entry].dataoffset), &(entries[entry].datalength) };
+      char seperator = '|';
+      int valindex = 0;
+      for ( ; valindex < 4; valindex++ ) {
+         if ( *parse != seperator  ||  parse[1] < '0'  ||  parse[1] > '9' ) {
+            LOG( LOG_ERR, "RECOVERY_INDEX entry %zu has an unexpected format\n", entry );
+            free( entries );
+            errno = EINVAL;
+            return -1;
+         }
+         parseval = strtoull( parse + 1, &(endptr), 10 );
+         if ( endptr > bodyend  ||  parseval > SIZE_MAX ) {
+            LOG( LOG_ERR, "RECOVERY_INDEX entry %zu value exceeds bounds\n", entry );
+            free( entries );
+            errno = ERANGE;
+            return -1;
+         }
+         *(values[valindex]) = (size_t)parseval;
+         parse = endptr;
+         seperator = ':';
+      }
+   }
+   if ( parse != bodyend ) {
+      LOG( LOG_ERR, "RECOVERY_INDEX string has unexpected trailing characters\n" );
+      free( entries );
+      errno = EINVAL;
+      return -1;
+   }
+   *index = entries;
+   *count = entrycount;
+   return 0;
+}
+
 /**
  * Initialize a RECOVERY reference for a data stream, based on the given object data,
  * and populate a RECOVERY_HEADER reference with the stream info
@@ -714,6 +1100,14 @@ RECOVERY recovery_init( void* objbuffer, size_t objsize, RECOVERY_HEADER* header
    recov->fileinfo = NULL;
    recov->filebuffers = NULL;
    recov->buffersizes = NULL;
+   recov->objbuffer = objbuffer;
+   recov->index = NULL;
+   recov->indexcount = 0;
+   recov->readfunc = NULL;
+   recov->rctxt = NULL;
+   recov->ownedbuffer = NULL;
+   recov->scratch = NULL;
+   recov->scratchsize = 0;
    if ( populate_recovery( recov, headerend, objsize ) ) {
       LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
       if ( recov->fileinfo ) { free( recov->fileinfo ); }
@@ -775,11 +1169,11 @@ int recovery_cont( RECOVERY recovery, void* objbuffer, size_t objsize ) {
    free( newheader.ctag );
    free( newheader.streamid );
    // cleanup existing per-file info
-   while ( recovery->curfile ) {
-      free( recovery->fileinfo[ recovery->curfile - 1 ].path );
-      recovery->curfile--;
-   }
+   release_fileinfo( recovery );
    // populate per-file info
+   recovery->objbuffer = objbuffer;
+   recovery->readfunc = NULL;
+   recovery->rctxt = NULL;
    if ( populate_recovery( recovery, headerend, objsize ) ) {
       LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
       return -1;
@@ -788,13 +1182,141 @@ int recovery_cont( RECOVERY recovery, void* objbuffer, size_t objsize ) {
    return 0;
 }
 
+/**
+ * Initialize a RECOVERY reference for a data stream, reading object content on demand, and
+ * populate a RECOVERY_HEADER reference with the stream info
+ * NOTE -- If the object includes a RECOVERY_INDEX, only the object header, INDEX, and
+ *         requested FINFO strings are ever read.  Objects lacking a usable INDEX are read in
+ *         full, as recovery_init() would require.
+ * @param recovery_readfunc readfunc : Function used to read object content
+ * @param void* rctxt : Context argument, passed to each readfunc call
+ * @param size_t objsize : Total size of the object
+ * @param RECOVERY_HEADER* header : Reference to a RECOVERY_HEADER struct to be populated,
+ *                                  ignored if NULL
+ * @return RECOVERY : Newly created RECOVERY reference, or NULL if a failure occurred
+ */
+RECOVERY recovery_initreader( recovery_readfunc readfunc, void* rctxt, size_t objsize, RECOVERY_HEADER* header ) {
+   // check for NULL refs
+   if ( readfunc == NULL ) {
+      LOG( LOG_ERR, "Received a NULL reader function\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // create our RECOVERY struct
+   RECOVERY recov = calloc( 1, sizeof( struct recovery_struct ) );
+   if ( recov == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a RECOVERY struct\n" );
+      return NULL;
+   }
+   recov->readfunc = readfunc;
+   recov->rctxt = rctxt;
+   // attempt to read in the header info
+   size_t headerlen = read_header( recov, objsize, &(recov->header) );
+   if ( headerlen == 0 ) {
+      LOG( LOG_ERR, "Failed to parse the RECOVERY_HEADER of the object\n" );
+      if ( recov->scratch ) { free( recov->scratch ); }
+      free( recov );
+      return NULL;
+   }
+   // populate the caller's header struct, if provided
+   if ( header ) {
+      header->majorversion = recov->header.majorversion;
+      header->minorversion = recov->header.minorversion;
+      header->ctag = strdup( recov->header.ctag );
+      header->streamid = strdup( recov->header.streamid );
+      if ( header->ctag == NULL  ||  header->streamid == NULL ) {
+         LOG( LOG_ERR, "Failed to duplicate header strings into caller struct\n" );
+         if ( header->ctag ) { free( header->ctag ); }
+         if ( header->streamid ) { free( header->streamid ); }
+         header->ctag = NULL;
+         header->streamid = NULL;
+         recovery_close( recov );
+         return NULL;
+      }
+   }
+   // populate per-file info
+   if ( populate_reader( recov, headerlen, objsize ) ) {
+      LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
+      recovery_close( recov );
+      if ( header ) {
+         free( header->ctag );
+         free( header->streamid );
+         header->ctag = NULL;
+         header->streamid = NULL;
+      }
+      return NULL;
+   }
+   // all done
+   return recov;
+}
+
+/**
+ * Shift a given RECOVERY reference to a new object, read on demand
+ * @param RECOVERY recovery : RECOVERY reference to be updated
+ * @param recovery_readfunc readfunc : Function used to read object content
+ * @param void* rctxt : Context argument, passed to each readfunc call
+ * @param size_t objsize : Total size of the new object
+ * @return int : Zero on success, or -1 if a failure occurred
+ *               NOTE -- an error condition will be produced if the given object
+ *               includes differing RECOVERY_HEADER info
+ */
+int recovery_contreader( RECOVERY recovery, recovery_readfunc readfunc, void* rctxt, size_t objsize ) {
+   // check for NULL refs
+   if ( readfunc == NULL ) {
+      LOG( LOG_ERR, "Received a NULL reader function\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( recovery == NULL ) {
+      LOG( LOG_ERR, "Received a NULL RECOVERY reference\n" );
+      return -1;
+   }
+   // cleanup existing per-file info, as it may reference content of the previous object
+   release_fileinfo( recovery );
+   recovery->objbuffer = NULL;
+   recovery->readfunc = readfunc;
+   recovery->rctxt = rctxt;
+   // attempt to read in the header info
+   RECOVERY_HEADER newheader;
+   size_t headerlen = read_header( recovery, objsize, &(newheader) );
+   if ( headerlen == 0 ) {
+      LOG( LOG_ERR, "Failed to parse the RECOVERY_HEADER of the object\n" );
+      return -1;
+   }
+   // verify that header info hasn't changed in this new object
+   if ( newheader.majorversion != recovery->header.majorversion ||
+        newheader.minorversion != recovery->header.minorversion ||
+        strcmp( newheader.ctag, recovery->header.ctag )  ||
+        strcmp( newheader.streamid, recovery->header.streamid ) ) {
+      LOG( LOG_ERR, "Header info differs in new object\n" );
+      free( newheader.ctag );
+      free( newheader.streamid );
+      return -1;
+   }
+   // we're done with new header info
+   free( newheader.ctag );
+   free( newheader.streamid );
+   // populate per-file info
+   if ( populate_reader( recovery, headerlen, objsize ) ) {
+      LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
+      return -1;
+   }
+   // all done
+   return 0;
+}
+
 /**
  * Iterate over file info and content included in the current object data buffer
+ * NOTE -- If the object includes a RECOVERY_INDEX, each FINFO is only parsed as it is
+ *         requested, and no scan of object content is required.
  * @param RECOVERY recovery : RECOVERY reference to iterate over
  * @param RECOVERY_FINFO* : Reference to the RECOVERY_FINFO struct to be populated with
  *                          info for the next file in the stream; ignored if NULL
  * @param void** databuf : Reference to a void*, to be updated with a reference to the data
  *                         content of the next recovery file; ignored if NULL
+ *                         NOTE -- for an indexed object opened via recovery_initreader(),
+ *                         file data is only read if requested, and the buffer is only valid
+ *                         until the next call
  * @param size_t* bufsize : Size of the data content buffer of the next recovery file;
  *                          ignored if NULL
  * @return int : One, if another set of file info was produced;
@@ -812,6 +1334,52 @@ int recovery_nextfile( RECOVERY recovery, RECOVERY_FINFO* finfo, void** databuf,
       LOG( LOG_INFO, "No files remain in this recovery object\n" );
       return 0;
    }
+   // indexed objects allow us to jump directly to the next file
+   //  ( entries are in object order, while 'curfile' counts down the remaining files )
+   if ( recovery->index ) {
+      RECOVERY_INDEX* entry = recovery->index + ( recovery->indexcount - recovery->curfile );
+      if ( finfo ) {
+         // objects opened via recovery_initreader() are read on demand
+         char* finfostr = ( recovery->objbuffer ) ? (char*)recovery->objbuffer + entry->finfooffset :
+                          read_scratch( recovery, entry->finfolength, entry->finfooffset );
+         if ( finfostr == NULL ) {
+            LOG( LOG_ERR, "Failed to read indexed FINFO string at offset %zu\n", entry->finfooffset );
+            return -1;
+         }
+         char* finfoend = parse_recov_finfo( finfostr, entry->finfolength, finfo );
+         if ( finfoend == NULL ) {
+            LOG( LOG_ERR, "Failed to parse indexed FINFO string at offset %zu\n", entry->finfooffset );
+            return -1;
+         }
+         // the FINFO string may only be followed by zero padding
+         for ( finfoend++; finfoend < finfostr + entry->finfolength; finfoend++ ) {
+            if ( *finfoend != '\0' ) {
+               LOG( LOG_ERR, "Indexed FINFO string at offset %zu has trailing characters\n",
+                             entry->finfooffset );
+               free( finfo->path );
+               finfo->path = NULL;
+               errno = EINVAL;
+               return -1;
+            }
+         }
+      }
+      if ( databuf ) {
+         if ( recovery->objbuffer ) { *databuf = recovery->objbuffer + entry->dataoffset; }
+         else if ( (*databuf = read_scratch( recovery, entry->datalength, entry->dataoffset )) == NULL ) {
+            LOG( LOG_ERR, "Failed to read indexed file data at offset %zu\n", entry->dataoffset );
+            if ( finfo ) {
+               free( finfo->path );
+               finfo->path = NULL;
+            }
+            return -1;
+         }
+      }
+      if ( bufsize ) {
+         *bufsize = entry->datalength;
+      }
+      recovery->curfile--;
+      return 1;
+   }
    // populate the next file info set
    if ( finfo ) {
       finfo->inode = recovery->fileinfo[ recovery->curfile - 1 ].inode;
@@ -853,13 +1421,11 @@ int recovery_close( RECOVERY recovery ) {
       return -1;
    }
    // free all allocated memory
-   while ( recovery->curfile ) {
-      free( recovery->fileinfo[ recovery->curfile - 1 ].path );
-      recovery->curfile--;
-   }
+   release_fileinfo( recovery );
    if ( recovery->fileinfo ) { free( recovery->fileinfo ); }
    if ( recovery->filebuffers ) { free( recovery->filebuffers ); }
    if ( recovery->buffersizes ) { free( recovery->buffersizes ); }
+   if ( recovery->scratch ) { free( recovery->scratch ); }
    free( recovery->header.ctag );
    free( recovery->header.streamid );
    free( recovery );
@@ -11,7 +11,7 @@
 
 
 #define RECOVERY_CURRENT_MAJORVERSION 0
-#define RECOVERY_CURRENT_MINORVERSION 1
+#define RECOVERY_CURRENT_MINORVERSION 2
 #define RECOVERY_MINORVERSION_PADDING 3
 
 #include <sys/types.h>
@@ -43,9 +43,26 @@ typedef struct recovery_finfo_struct {
 } RECOVERY_FINFO;
 #define RECOVERY_FINFO_TYPE "FINFO||"
 
+
+// OPTIONAL PER-OBJECT INDEX ( minor version 2+ ), FOLLOWING THE FINAL FINFO OF AN OBJECT
+// Each entry describes one FINFO string and the file data immediately preceding it,
+// allowing readers to locate any file's info directly, rather than by reverse scan.
+// The index string terminates with its own total length, as a fixed-width value, so
+// that it can be located from the final recovery_indextaillen() bytes of an object.
+typedef struct recovery_index_struct {
+   size_t finfooffset;  // object offset of the FINFO string
+   size_t finfolength;  // length of the FINFO string ( including any padding )
+   size_t dataoffset;   // object offset of the file data preceding the FINFO string
+   size_t datalength;   // length of the file data preceding the FINFO string
+} RECOVERY_INDEX;
+#define RECOVERY_INDEX_TYPE "INDEX||"
+
 // forward decl, for type safety
 typedef struct recovery_struct* RECOVERY;
 
+// Object reader, with pread() semantics, allowing recovery from objects not held in memory
+typedef ssize_t (*recovery_readfunc)( void* rctxt, void* buf, size_t count, off_t offset );
+
 /**
  * Produce a string representation of the given recovery header
  * @param const RECOVERY_HEADER* header : Reference to the header to be encoded
@@ -81,6 +98,49 @@ size_t recovery_finfotostr( const RECOVERY_FINFO* finfo, char* tgtstr, size_t si
  */
 int recovery_finfofromstr( RECOVERY_FINFO* finfo, char* srcstr, size_t len );
 
+/**
+ * Produce a string representation of the given recovery INDEX
+ * @param const RECOVERY_INDEX* index : Reference to the list of INDEX entries to be encoded
+ * @param size_t count : Number of INDEX entries in the list
+ * @param char* tgtstr : Reference to the string buffer to be populated
+ * @param size_t len : Size of the provided buffer
+ * @return size_t : Length of the produced string ( excluding NULL-terminator ), or zero if
+ *                  an error occurred.
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t recovery_indextostr( const RECOVERY_INDEX* index, size_t count, char* tgtstr, size_t size );
+
+/**
+ * Identify the number of trailing object bytes required to locate a recovery INDEX
+ * @return size_t : Minimum length of the tail string provided to recovery_indexlength()
+ */
+size_t recovery_indextaillen( void );
+
+/**
+ * Identify the length of the recovery INDEX string terminating the given object tail
+ * @param const char* tailstr : Reference to the final bytes of a data object
+ * @param size_t len : Length of the given tail string ( must be >= recovery_indextaillen() )
+ * @return size_t : Length of the INDEX string ending at the end of the given tail, or zero
+ *                  if the tail does not terminate with an INDEX string
+ *                  NOTE -- the returned length may exceed that of the tail string itself,
+ *                  and the INDEX string content is not verified until it is parsed
+ */
+size_t recovery_indexlength( const char* tailstr, size_t len );
+
+/**
+ * Parse the given string representation of a recovery INDEX and populate a new list of
+ * RECOVERY_INDEX entries
+ * @param RECOVERY_INDEX** index : Reference to be populated with the new entry list
+ *                                 ( caller is responsible for freeing this list )
+ * @param size_t* count : Reference to be populated with the number of entries
+ * @param char* srcstr : Reference to the string to be parsed
+ * @param size_t len : Length of the given string ( excluding NULL-terminator )
+ * @return int : Zero on success, or -1 on failure
+ */
+int recovery_indexfromstr( RECOVERY_INDEX** index, size_t* count, char* srcstr, size_t len );
+
 /**
  * Initialize a RECOVERY reference for a data stream, based on the given object data, 
  * and populate a RECOVERY_HEADER reference with the stream info
@@ -104,13 +164,45 @@ RECOVERY recovery_init( void* objbuffer, size_t objsize, RECOVERY_HEADER* header
  */
 int recovery_cont( RECOVERY recovery, void* objbuffer, size_t objsize );
 
+/**
+ * Initialize a RECOVERY reference for a data stream, reading object content on demand, and
+ * populate a RECOVERY_HEADER reference with the stream info
+ * NOTE -- If the object includes a RECOVERY_INDEX, only the object header, INDEX, and
+ *         requested FINFO strings are ever read.  Objects lacking a usable INDEX are read in
+ *         full, as recovery_init() would require.
+ * @param recovery_readfunc readfunc : Function used to read object content
+ * @param void* rctxt : Context argument, passed to each readfunc call
+ * @param size_t objsize : Total size of the object
+ * @param RECOVERY_HEADER* header : Reference to a RECOVERY_HEADER struct to be populated,
+ *                                  ignored if NULL
+ * @return RECOVERY : Newly created RECOVERY reference, or NULL if a failure occurred
+ */
+RECOVERY recovery_initreader( recovery_readfunc readfunc, void* rctxt, size_t objsize, RECOVERY_HEADER* header );
+
+/**
+ * Shift a given RECOVERY reference to a new object, read on demand
+ * @param RECOVERY recovery : RECOVERY reference to be updated
+ * @param recovery_readfunc readfunc : Function used to read object content
+ * @param void* rctxt : Context argument, passed to each readfunc call
+ * @param size_t objsize : Total size of the new object
+ * @return int : Zero on success, or -1 if a failure occurred
+ *               NOTE -- an error condition will be produced if the given object
+ *               includes differing RECOVERY_HEADER info
+ */
+int recovery_contreader( RECOVERY recovery, recovery_readfunc readfunc, void* rctxt, size_t objsize );
+
 /**
  * Iterate over file info and content included in the current object data buffer
+ * NOTE -- If the object includes a RECOVERY_INDEX, each FINFO is only parsed as it is
+ *         requested, and no scan of object content is required.
  * @param RECOVERY recovery : RECOVERY reference to iterate over
  * @param RECOVERY_FINFO* : Reference to the RECOVERY_FINFO struct to be populated with
  *                          info for the next file in the stream; ignored if NULL
  * @param void** databuf : Reference to a void*, to be updated with a reference to the data
  *                         content of the next recovery file; ignored if NULL
+ *                         NOTE -- for an indexed object opened via recovery_initreader(),
+ *                         file data is only read if requested, and the buffer is only valid
+ *                         until the next call
  * @param size_t* bufsize : Size of the data content buffer of the next recovery file;
  *                          ignored if NULL
  * @return int : One, if another set of file info was produced;
@@ -12,6 +12,24 @@
 // directly including the C file allows more flexibility for these tests
 #include "recovery/recovery.c"
 
+// in-memory object, read via recovery_initreader()
+typedef struct memobj_struct {
+   void* buffer;
+   size_t size;
+   size_t bytesread;
+} memobj;
+
+ssize_t memobj_read( void* rctxt, void* buf, size_t count, off_t offset ) {
+   memobj* obj = (memobj*)rctxt;
+   if ( offset >= obj->size ) { return 0; }
+   if ( count > obj->size - offset ) { count = obj->size - offset; }
+   // return short reads, to verify that callers retry
+   if ( count > 4096 ) { count = 4096; }
+   memcpy( buf, obj->buffer + offset, count );
+   obj->bytesread += count;
+   return count;
+}
+
 int main(int argc, char **argv)
 {
    // NOTE -- I'm ignoring memory leaks for error conditions 
@@ -444,6 +462,152 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   // append a RECOVERY_INDEX to the same object content
+   RECOVERY_INDEX index[3] = {
+      { .finfooffset = headerstrlen + 10240, .finfolength = finfo3strlen,
+        .dataoffset = headerstrlen, .datalength = 10240 },
+      { .finfooffset = headerstrlen + 10240 + finfo3strlen, .finfolength = finfo2strlen,
+        .dataoffset = headerstrlen + 10240 + finfo3strlen, .datalength = 0 },
+      { .finfooffset = objlen - finfostrlen, .finfolength = finfostrlen,
+        .dataoffset = headerstrlen + 10240 + finfo3strlen + finfo2strlen, .datalength = 10485760 }
+   };
+   size_t taillen = recovery_indextaillen();
+   size_t indexstrlen = recovery_indextostr( index, 3, NULL, 0 );
+   if ( indexstrlen <= taillen ) {
+      printf( "Failed to generate the length of the index string\n" );
+      return -1;
+   }
+   void* indexedobj = realloc( objbuffer, objlen + indexstrlen + 1 );
+   if ( indexedobj == NULL ) {
+      printf( "Failed to extend object buffer for index string\n" );
+      return -1;
+   }
+   objbuffer = indexedobj;
+   if ( recovery_indextostr( index, 3, objbuffer + objlen, indexstrlen + 1 ) != indexstrlen ) {
+      printf( "Inconsistent length of index string\n" );
+      return -1;
+   }
+   printf( "Index String: \"%s\"\n", (char*)objbuffer + objlen );
+
+   // locate and parse the index string, then compare to orig
+   if ( recovery_indexlength( objbuffer + objlen + indexstrlen - taillen, taillen ) != indexstrlen ) {
+      printf( "Failed to identify index string length from object tail\n" );
+      return -1;
+   }
+   if ( recovery_indexlength( objbuffer + objlen - taillen, taillen ) ) {
+      printf( "Unindexed object tail was mistaken for an index\n" );
+      return -1;
+   }
+   RECOVERY_INDEX* cmpindex = NULL;
+   size_t cmpcount = 0;
+   if ( recovery_indexfromstr( &(cmpindex), &(cmpcount), objbuffer + objlen, indexstrlen ) ) {
+      printf( "Failure of recovery_indexfromstr()\n" );
+      return -1;
+   }
+   if ( cmpcount != 3  ||  memcmp( cmpindex, index, sizeof(index) ) ) {
+      printf( "Parsed index differs from the original ( count=%zu )\n", cmpcount );
+      return -1;
+   }
+   free( cmpindex );
+
+   // recovery of the indexed object should use the index, and produce identical results
+   recov = recovery_init( objbuffer, objlen + indexstrlen, NULL );
+   if ( recov == NULL  ||  recov->index == NULL ) {
+      printf( "Failed to init indexed recov against fake object\n" );
+      return -1;
+   }
+   const char* indexpaths[3] = { finfo3.path, finfo2.path, finfo.path };
+   int pass = 0;
+   for ( ; pass < 2; pass++ ) {
+      int fileindex = 0;
+      for ( ; fileindex < 3; fileindex++ ) {
+         if ( recovery_nextfile( recov, &(cmpfinfo), &(databuf), &(bufsize) ) != 1 ) {
+            printf( "Failed to retrieve indexed file %d info ( pass %d )\n", fileindex, pass );
+            return -1;
+         }
+         if ( bufsize != index[fileindex].datalength  ||
+              databuf != objbuffer + index[fileindex].dataoffset  ||
+              strcmp( cmpfinfo.path, indexpaths[fileindex] ) ) {
+            printf( "Unexpected values for indexed file %d ( pass %d ): bsz=%zu, path=\"%s\"\n",
+                    fileindex, pass, bufsize, cmpfinfo.path );
+            return -1;
+         }
+         free( cmpfinfo.path );
+      }
+      if ( recovery_nextfile( recov, &(cmpfinfo), &(databuf), &(bufsize) ) != 0 ) {
+         printf( "Trailing indexed file or misc failure ( pass %d )\n", pass );
+         return -1;
+      }
+      if ( pass ) { break; }
+      // corrupt the index entry count, which should produce a fallback to a FINFO scan
+      *((char*)objbuffer + objlen + strlen( RECOVERY_MSGHEAD ) + strlen( RECOVERY_INDEX_TYPE )) = '4';
+      if ( recovery_cont( recov, objbuffer, objlen + indexstrlen )  ||  recov->index != NULL ) {
+         printf( "Failed to fall back to a FINFO scan of a corrupt index\n" );
+         return -1;
+      }
+   }
+   if ( recovery_close( recov ) ) {
+      printf( "Failed to close indexed recovery ref\n" );
+      return -1;
+   }
+
+   // reading the indexed object on demand should only access the FINFO and data we request
+   char* countstr = (char*)objbuffer + objlen + strlen( RECOVERY_MSGHEAD ) + strlen( RECOVERY_INDEX_TYPE );
+   *countstr = '3'; // undo the previous corruption
+   memobj mobj = { .buffer = objbuffer, .size = objlen + indexstrlen, .bytesread = 0 };
+   RECOVERY_HEADER rheader;
+   recov = recovery_initreader( memobj_read, &(mobj), mobj.size, &(rheader) );
+   if ( recov == NULL  ||  recov->index == NULL  ||  recov->ownedbuffer ) {
+      printf( "Failed to init indexed recov via a reader\n" );
+      return -1;
+   }
+   if ( rheader.majorversion != header.majorversion  ||  rheader.minorversion != header.minorversion  ||
+        strcmp( rheader.ctag, header.ctag )  ||  strcmp( rheader.streamid, header.streamid ) ) {
+      printf( "Reader header differs from the original\n" );
+      return -1;
+   }
+   free( rheader.ctag );
+   free( rheader.streamid );
+   for ( pass = 0; pass < 2; pass++ ) {
+      int fileindex = 0;
+      for ( ; fileindex < 3; fileindex++ ) {
+         // skip the data content of the final, large file
+         void** dataref = ( fileindex < 2 ) ? &(databuf) : NULL;
+         if ( recovery_nextfile( recov, &(cmpfinfo), dataref, &(bufsize) ) != 1 ) {
+            printf( "Failed to retrieve reader file %d info ( pass %d )\n", fileindex, pass );
+            return -1;
+         }
+         if ( bufsize != index[fileindex].datalength  ||  strcmp( cmpfinfo.path, indexpaths[fileindex] )  ||
+              ( dataref  &&  memcmp( databuf, objbuffer + index[fileindex].dataoffset, bufsize ) ) ) {
+            printf( "Unexpected values for reader file %d ( pass %d ): bsz=%zu, path=\"%s\"\n",
+                    fileindex, pass, bufsize, cmpfinfo.path );
+            return -1;
+         }
+         free( cmpfinfo.path );
+      }
+      if ( recovery_nextfile( recov, &(cmpfinfo), &(databuf), &(bufsize) ) != 0 ) {
+         printf( "Trailing reader file or misc failure ( pass %d )\n", pass );
+         return -1;
+      }
+      if ( pass ) { break; }
+      if ( mobj.bytesread >= objlen / 2 ) {
+         printf( "Indexed reader accessed %zu of %zu object bytes\n", mobj.bytesread, mobj.size );
+         return -1;
+      }
+      // a corrupt index should produce a full read of the object, and a FINFO scan
+      *countstr = '4';
+      mobj.bytesread = 0;
+      if ( recovery_contreader( recov, memobj_read, &(mobj), mobj.size )  ||
+           recov->index != NULL  ||  mobj.bytesread < mobj.size ) {
+         printf( "Failed to fall back to a full read of a corrupt index\n" );
+         return -1;
+      }
+   }
+   if ( recovery_close( recov ) ) {
+      printf( "Failed to close reader recovery ref\n" );
+      return -1;
+   }
+
    // cleanup object refs
    free( finfo2.path );
    free( finfo3.path );
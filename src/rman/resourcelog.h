@@ -121,6 +121,8 @@ typedef struct operation_summary_struct {
    size_t rebuild_failures;
    size_t repack_count;
    size_t repack_failures;
+   size_t repack_bytes;  // bytes written to repack streams
+   size_t repack_usecs;  // time during which any repack stream was active
 } operation_summary;
 
 typedef struct resourcelog_struct* RESOURCELOG;
@@ -365,6 +365,10 @@ void outputinfo( FILE* output, marfs_ns* ns, streamwalker_report* report , opera
       fprintf( output, "      File Repack Count = %zu ( %zu Failures )\n",
                summary->repack_count, summary->repack_failures );
    }
+   if ( !(userout) || summary->repack_usecs ) {
+      fprintf( output, "      File Repack Bytes = %zu ( %.2f MB/s per rank )\n", summary->repack_bytes,
+               ( summary->repack_usecs ) ? (double)summary->repack_bytes / (double)summary->repack_usecs : 0.0 );
+   }
    fprintf( output, "\n" );
    fflush( output );
    return;
@@ -1221,6 +1225,16 @@ int handlerequest( rmanstate* rman, workrequest* request, workresponse* response
       if ( outlogpath ) { free( outlogpath ); }
       if (rlogret) { response->errorlog = 1; } // note if our log was preserved due to errors being present
       if ( rman->gstate.rpst ) {
+         // all threads have terminated, so repack throughput values are now stable
+         if ( repackstreamer_throughput( rman->gstate.rpst, &(response->summary.repack_bytes),
+                                         &(response->summary.repack_usecs) ) ) {
+            LOG( LOG_WARNING, "Failed to retrieve repack throughput values of NS \"%s\"\n", rman->gstate.pos.ns->idstr );
+         }
+         else if ( response->summary.repack_usecs ) {
+            LOG( LOG_INFO, "Rank %zu repacked %zu bytes of NS \"%s\" at %.2f MB/s\n", rman->ranknum,
+                 response->summary.repack_bytes, rman->gstate.pos.ns->idstr,
+                 (double)response->summary.repack_bytes / (double)response->summary.repack_usecs );
+         }
          if ( repackstreamer_complete( rman->gstate.rpst ) ) {
             LOG( LOG_ERR, "Failed to complete repack streamer during completion of NS \"%s\"\n", rman->gstate.pos.ns->idstr );
             snprintf( response->errorstr, MAX_ERROR_BUFFER,
@@ -1308,7 +1322,14 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
    }
    else if ( response->request.type == COMPLETE_WORK ) {
       if ( response->request.nsindex != rman->nscount ) { // only perform processing / cleanup for real completions
-         printf( "  Rank %zu completed work on NS \"%s\"\n", ranknum, rman->nslist[response->request.nsindex]->idstr );
+         if ( response->haveinfo  &&  response->summary.repack_usecs ) {
+            printf( "  Rank %zu completed work on NS \"%s\" ( repacked at %.2f MB/s )\n", ranknum,
+                    rman->nslist[response->request.nsindex]->idstr,
+                    (double)response->summary.repack_bytes / (double)response->summary.repack_usecs );
+         }
+         else {
+            printf( "  Rank %zu completed work on NS \"%s\"\n", ranknum, rman->nslist[response->request.nsindex]->idstr );
+         }
          // possibly process info from the rank
          if ( response->haveinfo ) {
             // incorporate walk report
@@ -1335,6 +1356,8 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
             rman->logsummary[response->request.nsindex].rebuild_failures += response->summary.rebuild_failures;
             rman->logsummary[response->request.nsindex].repack_count += response->summary.repack_count;
             rman->logsummary[response->request.nsindex].repack_failures += response->summary.repack_failures;
+            rman->logsummary[response->request.nsindex].repack_bytes += response->summary.repack_bytes;
+            rman->logsummary[response->request.nsindex].repack_usecs += response->summary.repack_usecs;
             // output all gathered info, prior to possible log deletion
             outputinfo( rman->summarylog, rman->nslist[response->request.nsindex], &(response->report) , &(response->summary) );
          }
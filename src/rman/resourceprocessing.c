@@ -89,6 +89,11 @@ typedef struct repackstreamer_struct {
    size_t streamcount;
    DATASTREAM* streamlist;
    char* streamstatus;
+   // throughput info
+   size_t activecount;          // count of currently checked out datastreams
+   struct timespec activestart; // start of the current period of activity
+   size_t bytes;                // total bytes written to repack datastreams
+   size_t usecs;                // total time during which any datastream was checked out
 }* REPACKSTREAMER;
 
 typedef struct streamwalker_struct {
@@ -126,6 +131,23 @@ typedef struct streamwalker_struct {
 
 //   -------------   REPACKSTREAMER FUNCTIONS    -------------
 
+// note checkout of a datastream ( repackst lock must be held )
+static void repackstreamer_activate( REPACKSTREAMER repackst ) {
+   if ( repackst->activecount == 0 ) { clock_gettime( CLOCK_MONOTONIC, &(repackst->activestart) ); }
+   repackst->activecount++;
+}
+
+// note return of a datastream ( repackst lock must be held )
+static void repackstreamer_deactivate( REPACKSTREAMER repackst ) {
+   repackst->activecount--;
+   if ( repackst->activecount == 0 ) {
+      struct timespec now;
+      clock_gettime( CLOCK_MONOTONIC, &(now) );
+      repackst->usecs += (size_t)( now.tv_sec - repackst->activestart.tv_sec ) * 1000000 +
+                         (size_t)( ( now.tv_nsec - repackst->activestart.tv_nsec ) / 1000 );
+   }
+}
+
 /**
  * Initialize a new repackstreamer
  * @return REPACKSTREAMER : New repackstreamer, or NULL on failure
@@ -159,6 +181,9 @@ REPACKSTREAMER repackstreamer_init(void) {
       free( repackst );
       return NULL;
    }
+   repackst->activecount = 0;
+   repackst->bytes = 0;
+   repackst->usecs = 0;
    return repackst;
 }
 
@@ -184,6 +209,7 @@ DATASTREAM* repackstreamer_getstream( REPACKSTREAMER repackst ) {
    for ( ; index < repackst->streamcount; index++ ) {
       if ( repackst->streamstatus[index] == 0 ) {
          repackst->streamstatus[index] = 1;
+         repackstreamer_activate( repackst );
          pthread_mutex_unlock( &(repackst->lock) );
          LOG( LOG_INFO, "Handing out available stream at position %zu\n", index );
          return repackst->streamlist + index;
@@ -214,6 +240,7 @@ DATASTREAM* repackstreamer_getstream( REPACKSTREAMER repackst ) {
    }
    // hand out a newly-allocated stream
    repackst->streamstatus[newpos] = 1;
+   repackstreamer_activate( repackst );
    pthread_mutex_unlock( &(repackst->lock) );
    LOG( LOG_INFO, "Handing out newly-allocated position %zu\n", newpos );
    return repackst->streamlist + newpos;
@@ -258,11 +285,37 @@ int repackstreamer_returnstream( REPACKSTREAMER repackst, DATASTREAM* stream ) {
    }
    // update status and return
    repackst->streamstatus[index] = 0;
+   repackstreamer_deactivate( repackst );
    pthread_mutex_unlock( &(repackst->lock) );
    LOG( LOG_INFO, "Stream %zu has been returned\n", index );
    return 0;
 }
 
+/**
+ * Retrieve the throughput values of the given repackstreamer
+ * @param REPACKSTREAMER repackst : Repackstreamer to retrieve values from
+ * @param size_t* bytes : Reference to be populated with the count of bytes written to repack datastreams
+ * @param size_t* usecs : Reference to be populated with the time during which any datastream was checked out
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackstreamer_throughput( REPACKSTREAMER repackst, size_t* bytes, size_t* usecs ) {
+   // check for NULL args
+   if ( repackst == NULL  ||  bytes == NULL  ||  usecs == NULL ) {
+      LOG( LOG_ERR, "Received a NULL repackstreamer or value ref\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // acquire struct lock
+   if ( pthread_mutex_lock( &(repackst->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire repackstreamer lock\n" );
+      return -1;
+   }
+   *bytes = repackst->bytes;
+   *usecs = repackst->usecs;
+   pthread_mutex_unlock( &(repackst->lock) );
+   return 0;
+}
+
 /**
  * Terminate the given repackstreamer and close all associated datastreams
  * @param REPACKSTREAMER repackst : Repackstreamer to close
@@ -731,6 +784,137 @@ void process_rebuild( const marfs_position* pos, opinfo* op ) {
    return;
 }
 
+// repack data is staged through a small ring of buffers, allowing a read-ahead thread to
+// retrieve ( and erasure decode ) upcoming file content while earlier content is being
+// encoded and written out to the repack stream
+#define REPACK_BUFSIZE (1024 * 1024)
+#define REPACK_BUFCOUNT 4
+
+typedef struct repack_chunk_struct {
+   void*   buf;    // data buffer ( REPACK_BUFSIZE bytes )
+   ssize_t len;    // bytes of file data, zero at end of file, or -1 on read error
+   int     errval; // errno value associated with a read error
+} repack_chunk;
+
+typedef struct repack_pipeline_struct {
+   // synchronization and access control
+   pthread_mutex_t lock;
+   pthread_cond_t  filled;   // signaled when a chunk is filled by the reader
+   pthread_cond_t  emptied;  // signaled when a chunk is consumed by the writer ( or on abort )
+   // chunk ring
+   repack_chunk    chunks[REPACK_BUFCOUNT];
+   unsigned int    head;     // index of the next chunk to be consumed
+   unsigned int    count;    // count of filled chunks
+   char            abort;    // flag indicating that the writer has ceased consuming chunks
+   // reader state
+   marfs_position* pos;
+   HASH_TABLE      reftable;
+   opinfo*         ops;
+} repack_pipeline;
+
+static inline double repack_seconds( const struct timespec* start, const struct timespec* end ) {
+   return (double)( end->tv_sec - start->tv_sec ) + ( (double)( end->tv_nsec - start->tv_nsec ) / 1000000000.0 );
+}
+
+static repack_chunk* repack_claimchunk( repack_pipeline* rpipe ) {
+   pthread_mutex_lock( &(rpipe->lock) );
+   while ( rpipe->count == REPACK_BUFCOUNT  &&  !(rpipe->abort) ) {
+      pthread_cond_wait( &(rpipe->emptied), &(rpipe->lock) );
+   }
+   repack_chunk* chunk = NULL;
+   if ( !(rpipe->abort) ) { chunk = rpipe->chunks + ( (rpipe->head + rpipe->count) % REPACK_BUFCOUNT ); }
+   pthread_mutex_unlock( &(rpipe->lock) );
+   return chunk;
+}
+
+static void repack_fillchunk( repack_pipeline* rpipe ) {
+   pthread_mutex_lock( &(rpipe->lock) );
+   rpipe->count++;
+   pthread_cond_signal( &(rpipe->filled) );
+   pthread_mutex_unlock( &(rpipe->lock) );
+}
+
+static repack_chunk* repack_nextchunk( repack_pipeline* rpipe ) {
+   pthread_mutex_lock( &(rpipe->lock) );
+   while ( rpipe->count == 0 ) {
+      pthread_cond_wait( &(rpipe->filled), &(rpipe->lock) );
+   }
+   repack_chunk* chunk = rpipe->chunks + rpipe->head;
+   pthread_mutex_unlock( &(rpipe->lock) );
+   return chunk;
+}
+
+static void repack_consumechunk( repack_pipeline* rpipe ) {
+   pthread_mutex_lock( &(rpipe->lock) );
+   rpipe->head = ( rpipe->head + 1 ) % REPACK_BUFCOUNT;
+   rpipe->count--;
+   pthread_cond_signal( &(rpipe->emptied) );
+   pthread_mutex_unlock( &(rpipe->lock) );
+}
+
+static void repack_abort( repack_pipeline* rpipe ) {
+   pthread_mutex_lock( &(rpipe->lock) );
+   rpipe->abort = 1;
+   pthread_cond_signal( &(rpipe->emptied) );
+   pthread_mutex_unlock( &(rpipe->lock) );
+}
+
+static void* repack_readahead( void* arg ) {
+   repack_pipeline* rpipe = (repack_pipeline*)arg;
+   DATASTREAM readstream = NULL;
+   char readerror = 0;
+   // NOTE -- A READ stream will continue to see original file content until the repack stream
+   //         progresses beyond that file.  As the writer cannot progress beyond a file prior to
+   //         consuming its final chunk, it is safe for us to open files ahead of the writer.
+   opinfo* op = rpipe->ops;
+   for ( ; op; op = op->next ) {
+      int errval = 0;
+      // identify the reference path of the target file
+      char* reftgt = datastream_genrpath( &(op->ftag), rpipe->reftable, NULL, NULL );
+      if ( reftgt == NULL ) {
+         LOG( LOG_ERR, "Failed to identify reference path of active fileno %zu of stream \"%s\"\n", op->ftag.fileno, op->ftag.streamid );
+         errval = (errno) ? errno : ENOTRECOVERABLE;
+      }
+      // open a read datastream for the target file ( by reference path )
+      else if ( datastream_scan( &(readstream), reftgt, rpipe->pos ) ) {
+         LOG( LOG_ERR, "Failed to open read stream for reference target: \"%s\"\n", reftgt );
+         errval = (errno) ? errno : ENOTRECOVERABLE;
+      }
+      // read all data from the file, terminating it with an empty ( or error ) chunk
+      ssize_t iores = 1;
+      while ( iores > 0 ) {
+         repack_chunk* chunk = repack_claimchunk( rpipe );
+         if ( chunk == NULL ) { break; } // writer has aborted
+         if ( errval ) { iores = -1; }
+         else {
+            iores = datastream_read( &(readstream), chunk->buf, REPACK_BUFSIZE );
+            if ( iores < 0 ) {
+               LOG( LOG_ERR, "Failed to read from reference target: \"%s\"\n", reftgt );
+               errval = (errno) ? errno : ENOTRECOVERABLE;
+            }
+         }
+         chunk->len = iores;
+         chunk->errval = errval;
+         repack_fillchunk( rpipe );
+      }
+      if ( reftgt ) { free( reftgt ); }
+      if ( iores ) { readerror = 1; break; } // no further progress is possible
+   }
+   // terminate our read stream
+   if ( readstream ) {
+      if ( readerror ) {
+         if ( datastream_release( &(readstream) ) ) {
+            LOG( LOG_WARNING, "Failed to abort read stream after previous failure\n" );
+         }
+      }
+      else if ( datastream_close( &(readstream) ) ) {
+         // this isn't worth aborting over, it's just... odd
+         LOG( LOG_WARNING, "Failed to close read stream\n" );
+      }
+   }
+   return NULL;
+}
+
 void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, const char* ctagsuf ) {
    // check out a repack stream reference
    DATASTREAM* rpckstream = repackstreamer_getstream( rpckstr );
@@ -757,13 +941,40 @@ void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, co
          rpckerror = 1;
       }
    }
-   // allocate a 1MiB buffer to use for data migration
-   void* iobuf = malloc( 1024 * 1024 );
-   if ( iobuf == NULL ) {
-      LOG( LOG_ERR, "Failed to allocate an IOBuffer for repack\n" );
-      rpckerror = 1;
+   // allocate buffers to use for data migration
+   repack_pipeline rpipe = {
+      .head = 0,
+      .count = 0,
+      .abort = 0,
+      .pos = pos,
+      .reftable = reftable,
+      .ops = op
+   };
+   pthread_mutex_init( &(rpipe.lock), NULL );
+   pthread_cond_init( &(rpipe.filled), NULL );
+   pthread_cond_init( &(rpipe.emptied), NULL );
+   int index = 0;
+   for ( ; index < REPACK_BUFCOUNT; index++ ) {
+      rpipe.chunks[index].buf = malloc( REPACK_BUFSIZE );
+      if ( rpipe.chunks[index].buf == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate repack buffer %d\n", index );
+         rpckerror = 1;
+      }
    }
-   DATASTREAM readstream = NULL;
+   // start reading ahead
+   pthread_t reader;
+   char readerstarted = 0;
+   if ( !(rpckerror) ) {
+      if ( pthread_create( &(reader), NULL, repack_readahead, &(rpipe) ) ) {
+         LOG( LOG_ERR, "Failed to start repack read-ahead thread\n" );
+         rpckerror = 1;
+      }
+      else { readerstarted = 1; }
+   }
+   struct timespec starttime;
+   clock_gettime( CLOCK_MONOTONIC, &(starttime) );
+   size_t rpckbytes = 0;
+   size_t rpckfiles = 0;
    opinfo* prevop = op;
 
    for ( ; op; op = op->next ) {
@@ -775,6 +986,7 @@ void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, co
       if ( reftgt == NULL ) {
          LOG( LOG_ERR, "Failed to identify reference path of active fileno %zu of stream \"%s\"\n", op->ftag.fileno, op->ftag.streamid );
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
+         repack_abort( &(rpipe) );
          rpckerror = 1;
          continue;
       }
@@ -790,6 +1002,8 @@ void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, co
       if ( ctag == NULL ) {
          LOG( LOG_ERR, "Failed to allocate a client tag string for repack\n" );
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
+         free( reftgt );
+         repack_abort( &(rpipe) );
          rpckerror = 1;
          continue;
       }
@@ -805,57 +1019,69 @@ void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, co
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
          free( ctag );
          free( reftgt );
+         repack_abort( &(rpipe) );
          rpckerror = 1;
          continue;
       }
       free( ctag );
-      // open a read datastream for the target file
-      if ( datastream_open( &(readstream), READ_STREAM, reftgt, pos, NULL ) ) {
-         LOG( LOG_ERR, "Failed to open read stream for reference target: \"%s\"\n", reftgt );
-         if ( datastream_release( rpckstream ) ) {
-            LOG( LOG_WARNING, "Failed to abort repack stream after previous failure\n" );
-         }
-         op->errval = (errno) ? errno : ENOTRECOVERABLE;
-         free( reftgt );
-         rpckerror = 1;
-         continue;
-      }
-      // read all data from the file, writing it out to the repack stream
-      ssize_t iores = 1024 * 1024;
-      while ( iores ) {
-         iores = datastream_read( &(readstream), iobuf, 1024 * 1024 );
+      // write all read-ahead data of the file out to the repack stream
+      int errval = 0;
+      ssize_t iores = 1;
+      while ( iores > 0 ) {
+         repack_chunk* chunk = repack_nextchunk( &(rpipe) );
+         iores = chunk->len;
          if ( iores < 0 ) {
             LOG( LOG_ERR, "Failed to read from reference target: \"%s\"\n", reftgt );
-            break;
+            errval = chunk->errval;
          }
-         if ( iores != datastream_write( rpckstream, iobuf, (size_t)iores ) ) {
+         else if ( iores  &&  iores != datastream_write( rpckstream, chunk->buf, (size_t)iores ) ) {
             LOG( LOG_ERR, "Failed to write to repack stream of reference target: \"%s\"\n", reftgt );
-            break;
+            errval = errno;
+            iores = -1;
          }
+         else { rpckbytes += (size_t)iores; }
+         repack_consumechunk( &(rpipe) );
       }
       if ( iores ) {
          // cleanup from previous errors
          if ( datastream_release( rpckstream ) ) {
             LOG( LOG_WARNING, "Failed to abort repack stream after previous failure\n" );
          }
-         if ( datastream_release( &(readstream) ) ) {
-            LOG( LOG_WARNING, "Failed to abort read stream after previous failure\n" );
-         }
-         op->errval = (errno) ? errno : ENOTRECOVERABLE;
+         op->errval = (errval) ? errval : ENOTRECOVERABLE;
          free( reftgt );
+         repack_abort( &(rpipe) );
          rpckerror = 1;
          continue;
       }
 
       free( reftgt );
+      rpckfiles++;
       prevop = op;
    }
 
-   // cleanup our iobuffer
-   if ( iobuf ) { free( iobuf ); }
+   // wait for read-ahead to terminate ( closing its read stream )
+   if ( readerstarted ) { pthread_join( reader, NULL ); }
+
+   // report our throughput ( computed entirely within LOG(), as nothing else requires it )
+   struct timespec endtime;
+   clock_gettime( CLOCK_MONOTONIC, &(endtime) );
+   if ( rpckbytes ) {
+      LOG( LOG_INFO, "Repacked %zu bytes of %zu files in %.3fs ( %.2f MB/s )\n",
+           rpckbytes, rpckfiles, repack_seconds( &(starttime), &(endtime) ),
+           ( repack_seconds( &(starttime), &(endtime) ) > 0.0 ) ?
+              ( (double)rpckbytes / 1000000.0 ) / repack_seconds( &(starttime), &(endtime) ) : 0.0 );
+   }
+
+   // cleanup our iobuffers
+   for ( index = 0; index < REPACK_BUFCOUNT; index++ ) {
+      if ( rpipe.chunks[index].buf ) { free( rpipe.chunks[index].buf ); }
+   }
+   pthread_cond_destroy( &(rpipe.emptied) );
+   pthread_cond_destroy( &(rpipe.filled) );
+   pthread_mutex_destroy( &(rpipe.lock) );
 
    // potentially destroy our custom hash table
-   if ( reftable != pos->ns->prepo->metascheme.reftable ) {
+   if ( reftable  &&  reftable != pos->ns->prepo->metascheme.reftable ) {
       HASH_NODE* nodelist = NULL;
       size_t count = 0;
       if ( hash_term( reftable, &(nodelist), &(count) ) ) {
@@ -870,13 +1096,13 @@ void process_repack( marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, co
          free( nodelist );
       }
    }
-
-   // close our read stream
-   if ( readstream  &&  datastream_close( &(readstream) ) ) {
-      // this isn't worth aborting over, it's just... odd
-      LOG( LOG_WARNING, "Failed to close read stream\n" );
+   // account for our written bytes, then check in our repack stream reference
+   // ( will only be closed when the repackstreamer is terminated )
+   if ( rpckbytes ) {
+      pthread_mutex_lock( &(rpckstr->lock) );
+      rpckstr->bytes += rpckbytes;
+      pthread_mutex_unlock( &(rpckstr->lock) );
    }
-   // check in our repack stream reference ( will only be closed when the repackstreamer is terminated )
    if ( rpckstr  &&  repackstreamer_returnstream( rpckstr, rpckstream ) ) {
       // this is a problem, so at least mark our final op as being in error
       LOG( LOG_ERR, "Failed to return our repack stream\n" );
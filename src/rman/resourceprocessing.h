@@ -127,6 +127,15 @@ DATASTREAM* repackstreamer_getstream( REPACKSTREAMER repackst );
  */
 int repackstreamer_returnstream( REPACKSTREAMER repackst, DATASTREAM* stream );
 
+/**
+ * Retrieve the throughput values of the given repackstreamer
+ * @param REPACKSTREAMER repackst : Repackstreamer to retrieve values from
+ * @param size_t* bytes : Reference to be populated with the count of bytes written to repack datastreams
+ * @param size_t* usecs : Reference to be populated with the time during which any datastream was checked out
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackstreamer_throughput( REPACKSTREAMER repackst, size_t* bytes, size_t* usecs );
+
 /**
  * Terminate the given repackstreamer and close all associated datastreams
  * @param REPACKSTREAMER repackst : Repackstreamer to close
@@ -116,6 +116,179 @@ int deletesubdirs( const char* basepath ) {
 }
 
 
+// sizes of the files of the repack test, spanning more chunks than the read-ahead ring
+#define REPACK_TESTFILES 3
+static const size_t repacksizes[REPACK_TESTFILES] = { (1024 * 1024) + 512, 100, (1024 * 1024) + 3000 };
+
+// delete data objects zero through 'lastobj' of the stream referenced by the given FTAG
+int deletestreamobjs( marfs_position* pos, const FTAG* ftag, size_t lastobj ) {
+   FTAG tgttag = *ftag;
+   for ( tgttag.objno = 0; tgttag.objno <= lastobj; tgttag.objno++ ) {
+      char* objname = NULL;
+      ne_erasure erasure;
+      ne_location location;
+      if ( datastream_objtarget( &(tgttag), &(pos->ns->prepo->datascheme), &(objname), &(erasure), &(location) ) ) {
+         printf( "Failed to identify data object %zu of stream \"%s\"\n", tgttag.objno, tgttag.streamid );
+         return -1;
+      }
+      if ( ne_delete( pos->ns->prepo->datascheme.nectxt, objname, location ) ) {
+         printf( "Failed to delete data object \"%s\"\n", objname );
+         free( objname );
+         return -1;
+      }
+      free( objname );
+   }
+   return 0;
+}
+
+// repack a set of packed files via process_repack(), verifying their content afterwards
+int repacktest( marfs_position* pos, const char* databuf ) {
+   MDAL mdal = pos->ns->prepo->metascheme.mdal;
+   DATASTREAM stream = NULL;
+   char fname[64];
+   int index;
+   // create all files off of a single stream
+   for ( index = 0; index < REPACK_TESTFILES; index++ ) {
+      snprintf( fname, 64, "rfile%d", index );
+      if ( datastream_create( &(stream), fname, pos, 0700, "REPACK-CLIENT" ) ) {
+         printf( "create failure for '%s' of repack\n", fname );
+         return -1;
+      }
+      if ( datastream_write( &(stream), databuf, repacksizes[index] ) != repacksizes[index] ) {
+         printf( "write failure for '%s' of repack\n", fname );
+         return -1;
+      }
+   }
+   size_t origlastobj = stream->objno;
+   if ( datastream_close( &(stream) ) ) {
+      printf( "failed to close repack create stream\n" );
+      return -1;
+   }
+
+   // generate a repack op for each file
+   opinfo* ops = NULL;
+   opinfo** optail = &(ops);
+   FTAG origtags[REPACK_TESTFILES];
+   for ( index = 0; index < REPACK_TESTFILES; index++ ) {
+      snprintf( fname, 64, "rfile%d", index );
+      if ( datastream_open( &(stream), READ_STREAM, fname, pos, NULL ) ) {
+         printf( "failed to open '%s' of repack for read\n", fname );
+         return -1;
+      }
+      opinfo* op = calloc( 1, sizeof( opinfo ) );
+      repack_info* rinfo = calloc( 1, sizeof( repack_info ) );
+      if ( op == NULL  ||  rinfo == NULL ) {
+         printf( "failed to allocate repack op\n" );
+         return -1;
+      }
+      op->type = MARFS_REPACK_OP;
+      op->extendedinfo = rinfo;
+      op->start = 1;
+      op->count = 1;
+      op->ftag = stream->files[stream->curfile].ftag;
+      op->ftag.ctag = strdup( op->ftag.ctag );
+      op->ftag.streamid = strdup( op->ftag.streamid );
+      rinfo->totalbytes = op->ftag.bytes;
+      origtags[index] = op->ftag;
+      *optail = op;
+      optail = &(op->next);
+   }
+   if ( datastream_close( &(stream) ) ) {
+      printf( "failed to close repack read stream\n" );
+      return -1;
+   }
+
+   // repack all files at once
+   REPACKSTREAMER rpckstr = repackstreamer_init();
+   if ( rpckstr == NULL ) {
+      printf( "failed to initialize repackstreamer\n" );
+      return -1;
+   }
+   process_repack( pos, ops, rpckstr, "TestClient" );
+   opinfo* op = ops;
+   for ( index = 0; op; op = op->next, index++ ) {
+      if ( op->errval ) {
+         printf( "repack op %d failed with \"%s\"\n", index, strerror(op->errval) );
+         return -1;
+      }
+   }
+   // every repacked byte should be accounted for in the throughput values
+   size_t rpckbytes = 0;
+   size_t rpckusecs = 0;
+   size_t expectedbytes = 0;
+   for ( index = 0; index < REPACK_TESTFILES; index++ ) { expectedbytes += repacksizes[index]; }
+   if ( repackstreamer_throughput( rpckstr, &(rpckbytes), &(rpckusecs) )  ||
+        rpckbytes != expectedbytes  ||  rpckusecs == 0 ) {
+      printf( "unexpected repack throughput values ( %zu bytes of %zu, %zu usecs )\n",
+              rpckbytes, expectedbytes, rpckusecs );
+      return -1;
+   }
+   if ( repackstreamer_complete( rpckstr ) ) {
+      printf( "failed to complete repackstreamer\n" );
+      return -1;
+   }
+
+   // every file should now reference a new stream, with unaltered content
+   FTAG newtag;
+   for ( index = 0; index < REPACK_TESTFILES; index++ ) {
+      snprintf( fname, 64, "rfile%d", index );
+      if ( datastream_open( &(stream), READ_STREAM, fname, pos, NULL ) ) {
+         printf( "failed to open repacked '%s' for read\n", fname );
+         return -1;
+      }
+      newtag = stream->files[stream->curfile].ftag;
+      if ( strcmp( newtag.streamid, origtags[index].streamid ) == 0 ) {
+         printf( "'%s' still references its original stream\n", fname );
+         return -1;
+      }
+      size_t verified = 0;
+      char readbuf[4096];
+      ssize_t iores;
+      while ( (iores = datastream_read( &(stream), readbuf, 4096 )) > 0 ) {
+         if ( verified + iores > repacksizes[index]  ||  memcmp( readbuf, databuf + verified, iores ) ) {
+            printf( "unexpected content of repacked '%s' at offset %zu\n", fname, verified );
+            return -1;
+         }
+         verified += iores;
+      }
+      if ( iores  ||  verified != repacksizes[index] ) {
+         printf( "unexpected length of repacked '%s': %zu\n", fname, verified );
+         return -1;
+      }
+      // cleanup the file, along with its new and original references
+      char* newrpath = datastream_genrpath( &(newtag), pos->ns->prepo->metascheme.reftable, NULL, NULL );
+      char* origrpath = datastream_genrpath( origtags + index, pos->ns->prepo->metascheme.reftable, NULL, NULL );
+      if ( newrpath == NULL  ||  origrpath == NULL ) {
+         printf( "failed to identify rpaths of repacked '%s'\n", fname );
+         return -1;
+      }
+      if ( mdal->unlink( pos->ctxt, fname )  ||  mdal->unlinkref( pos->ctxt, newrpath )  ||
+           mdal->unlinkref( pos->ctxt, origrpath ) ) {
+         printf( "failed to cleanup repacked '%s'\n", fname );
+         return -1;
+      }
+      free( newrpath );
+      free( origrpath );
+   }
+   size_t newlastobj = stream->objno; // the final file was read in its entirety
+   newtag.ctag = strdup( newtag.ctag );
+   newtag.streamid = strdup( newtag.streamid );
+   if ( datastream_close( &(stream) ) ) {
+      printf( "failed to close repacked read stream\n" );
+      return -1;
+   }
+
+   // cleanup the data objects of both streams
+   if ( deletestreamobjs( pos, origtags, origlastobj )  ||  deletestreamobjs( pos, &(newtag), newlastobj ) ) {
+      printf( "failed to delete data objects of repack streams\n" );
+      return -1;
+   }
+   free( newtag.ctag );
+   free( newtag.streamid );
+   resourcelog_freeopinfo( ops );
+   return 0;
+}
+
 int main(int argc, char **argv)
 {
    // NOTE -- I'm ignoring memory leaks for error conditions 
@@ -1416,6 +1589,12 @@ int main(int argc, char **argv)
 
 
 
+// REPACK TEST
+   if ( repacktest( &(pos), databuf ) ) {
+      printf( "repack of packed files failed\n" );
+      return -1;
+   }
+
 // PARALLEL WRITE TEST
    // create a new stream
    if ( datastream_create( &(stream), "file1", &(pos), 0700, "PARLLEL-CLIENT" ) ) {
@@ -81,6 +81,10 @@ void outputinfo(FILE* output, marfs_ns* ns, streamwalker_report* report, operati
       fprintf(output, "      File Repack Count = %zu (%zu Failures)\n",
                summary->repack_count, summary->repack_failures);
    }
+   if (!userout || summary->repack_usecs) {
+      fprintf(output, "      File Repack Bytes = %zu (%.2f MB/s per rank)\n", summary->repack_bytes,
+               (summary->repack_usecs) ? (double)summary->repack_bytes / (double)summary->repack_usecs : 0.0);
+   }
    fprintf(output, "\n");
    fflush(output);
    return;
@@ -26,6 +26,9 @@ REPACKSTREAMER repackstreamer_init(void) {
    repackst->streamcount = 10;
    repackst->streamlist = calloc(repackst->streamcount, sizeof(DATASTREAM));
    repackst->streamstatus = calloc(10, sizeof(char));
+   repackst->activecount = 0;
+   repackst->bytes = 0;
+   repackst->usecs = 0;
    return repackst;
 }
 
@@ -36,6 +39,23 @@ static void repackstreamer_destroy(REPACKSTREAMER repackst) {
    free(repackst);
 }
 
+// note checkout of a datastream ( repackst lock must be held )
+static void repackstreamer_activate(REPACKSTREAMER repackst) {
+   if (repackst->activecount == 0) { clock_gettime(CLOCK_MONOTONIC, &repackst->activestart); }
+   repackst->activecount++;
+}
+
+// note return of a datastream ( repackst lock must be held )
+static void repackstreamer_deactivate(REPACKSTREAMER repackst) {
+   repackst->activecount--;
+   if (repackst->activecount == 0) {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      repackst->usecs += (size_t)(now.tv_sec - repackst->activestart.tv_sec) * 1000000 +
+                         (size_t)((now.tv_nsec - repackst->activestart.tv_nsec) / 1000);
+   }
+}
+
 /**
  * Checkout a repack datastream
  * @param REPACKSTREAMER repackst : Repackstreamer to checkout from
@@ -57,6 +77,7 @@ DATASTREAM* repackstreamer_getstream(REPACKSTREAMER repackst) {
    for (; index < repackst->streamcount; index++) {
       if (repackst->streamstatus[index] == 0) {
          repackst->streamstatus[index] = 1;
+         repackstreamer_activate(repackst);
          pthread_mutex_unlock(&repackst->lock);
          LOG(LOG_INFO, "Handing out available stream at position %zu\n", index);
          return repackst->streamlist + index;
@@ -92,6 +113,7 @@ DATASTREAM* repackstreamer_getstream(REPACKSTREAMER repackst) {
 
    // hand out a newly-allocated stream
    repackst->streamstatus[newpos] = 1;
+   repackstreamer_activate(repackst);
    pthread_mutex_unlock(&repackst->lock);
    LOG(LOG_INFO, "Handing out newly-allocated position %zu\n", newpos);
    return repackst->streamlist + newpos;
@@ -138,12 +160,25 @@ int repackstreamer_returnstream(REPACKSTREAMER repackst, DATASTREAM* stream) {
 
    // update status and return
    repackst->streamstatus[index] = 0;
+   repackstreamer_deactivate(repackst);
    pthread_mutex_unlock(&repackst->lock);
    LOG(LOG_INFO, "Stream %zu has been returned\n", index);
 
    return 0;
 }
 
+/**
+ * Record data volume written to a checked out repack datastream
+ * @param REPACKSTREAMER repackst : Repackstreamer the datastream was checked out from
+ * @param size_t bytes : Count of bytes written
+ */
+void repackstreamer_account(REPACKSTREAMER repackst, size_t bytes) {
+   if (repackst == NULL) { return; }
+   pthread_mutex_lock(&repackst->lock);
+   repackst->bytes += bytes;
+   pthread_mutex_unlock(&repackst->lock);
+}
+
 /**
  * Terminate the given repackstreamer and close all associated datastreams
  * @param REPACKSTREAMER repackst : Repackstreamer to close
@@ -10,6 +10,7 @@
  */
 
 #include <pthread.h>
+#include <time.h>
 
 #include "datastream/datastream.h"
 
@@ -21,6 +22,12 @@ typedef struct repackstreamer {
    size_t streamcount;
    DATASTREAM* streamlist;
    char* streamstatus;
+
+   // throughput info
+   size_t activecount;          // count of currently checked out datastreams
+   struct timespec activestart; // start of the current period of activity
+   size_t bytes;                // total bytes written to repack datastreams
+   size_t usecs;                // total time during which any datastream was checked out
 }* REPACKSTREAMER;
 
 /**
@@ -44,6 +51,13 @@ DATASTREAM* repackstreamer_getstream( REPACKSTREAMER repackst );
  */
 int repackstreamer_returnstream( REPACKSTREAMER repackst, DATASTREAM* stream );
 
+/**
+ * Record data volume written to a checked out repack datastream
+ * @param REPACKSTREAMER repackst : Repackstreamer the datastream was checked out from
+ * @param size_t bytes : Count of bytes written
+ */
+void repackstreamer_account( REPACKSTREAMER repackst, size_t bytes );
+
 /**
  * Terminate the given repackstreamer and close all associated datastreams
  * @param REPACKSTREAMER repackst : Repackstreamer to close
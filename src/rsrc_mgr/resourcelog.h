@@ -35,6 +35,8 @@ typedef struct {
    size_t rebuild_failures;
    size_t repack_count;
    size_t repack_failures;
+   size_t repack_bytes;  // bytes written to repack streams
+   size_t repack_usecs;  // time during which repack streams were active
 } operation_summary;
 
 
@@ -8,7 +8,9 @@
  */
 
 #include <dirent.h>
+#include <pthread.h>
 #include <string.h>
+#include <time.h>
 
 #include "datastream/datastream.h"
 #include "resourceprocessing.h"
@@ -438,6 +440,144 @@ static void process_rebuild(const marfs_position* pos, opinfo* op) {
    return;
 }
 
+// repack data is staged through a small ring of buffers, allowing a read-ahead thread to
+// retrieve ( and erasure decode ) upcoming file content while earlier content is being
+// encoded and written out to the repack stream
+#define REPACK_BUFSIZE (1024 * 1024)
+#define REPACK_BUFCOUNT 4
+
+typedef struct repack_chunk_struct {
+   void*   buf;    // data buffer ( REPACK_BUFSIZE bytes )
+   ssize_t len;    // bytes of file data, zero at end of file, or -1 on read error
+   int     errval; // errno value associated with a read error
+} repack_chunk;
+
+typedef struct repack_pipeline_struct {
+   // synchronization and access control
+   pthread_mutex_t lock;
+   pthread_cond_t  filled;   // signaled when a chunk is filled by the reader
+   pthread_cond_t  emptied;  // signaled when a chunk is consumed by the writer ( or on abort )
+   // chunk ring
+   repack_chunk    chunks[REPACK_BUFCOUNT];
+   unsigned int    head;     // index of the next chunk to be consumed
+   unsigned int    count;    // count of filled chunks
+   char            abort;    // flag indicating that the writer has ceased consuming chunks
+   // reader state
+   marfs_position* pos;
+   HASH_TABLE      reftable;
+   opinfo*         ops;
+} repack_pipeline;
+
+static inline double repack_seconds(const struct timespec* start, const struct timespec* end) {
+   return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1000000000.0);
+}
+
+static repack_chunk* repack_claimchunk(repack_pipeline* rpipe) {
+   pthread_mutex_lock(&rpipe->lock);
+   while (rpipe->count == REPACK_BUFCOUNT && !rpipe->abort) {
+      pthread_cond_wait(&rpipe->emptied, &rpipe->lock);
+   }
+   repack_chunk* chunk = NULL;
+   if (!rpipe->abort) { chunk = rpipe->chunks + ((rpipe->head + rpipe->count) % REPACK_BUFCOUNT); }
+   pthread_mutex_unlock(&rpipe->lock);
+   return chunk;
+}
+
+static void repack_fillchunk(repack_pipeline* rpipe) {
+   pthread_mutex_lock(&rpipe->lock);
+   rpipe->count++;
+   pthread_cond_signal(&rpipe->filled);
+   pthread_mutex_unlock(&rpipe->lock);
+}
+
+static repack_chunk* repack_nextchunk(repack_pipeline* rpipe) {
+   pthread_mutex_lock(&rpipe->lock);
+   while (rpipe->count == 0) {
+      pthread_cond_wait(&rpipe->filled, &rpipe->lock);
+   }
+   repack_chunk* chunk = rpipe->chunks + rpipe->head;
+   pthread_mutex_unlock(&rpipe->lock);
+   return chunk;
+}
+
+static void repack_consumechunk(repack_pipeline* rpipe) {
+   pthread_mutex_lock(&rpipe->lock);
+   rpipe->head = (rpipe->head + 1) % REPACK_BUFCOUNT;
+   rpipe->count--;
+   pthread_cond_signal(&rpipe->emptied);
+   pthread_mutex_unlock(&rpipe->lock);
+}
+
+static void repack_abort(repack_pipeline* rpipe) {
+   pthread_mutex_lock(&rpipe->lock);
+   rpipe->abort = 1;
+   pthread_cond_signal(&rpipe->emptied);
+   pthread_mutex_unlock(&rpipe->lock);
+}
+
+static void* repack_readahead(void* arg) {
+   repack_pipeline* rpipe = (repack_pipeline*)arg;
+   DATASTREAM readstream = NULL;
+   char readerror = 0;
+
+   // NOTE -- A READ stream will continue to see original file content until the repack stream
+   //         progresses beyond that file.  As the writer cannot progress beyond a file prior to
+   //         consuming its final chunk, it is safe for us to open files ahead of the writer.
+   for (opinfo* op = rpipe->ops; op; op = op->next) {
+      int errval = 0;
+
+      // identify the reference path of the target file
+      char* reftgt = datastream_genrpath(&op->ftag, rpipe->reftable, NULL, NULL);
+      if (reftgt == NULL) {
+         errval = (errno) ? errno : ENOTRECOVERABLE;
+         LOG(LOG_ERR, "Failed to identify reference path of active fileno %zu of stream \"%s\"\n", op->ftag.fileno, op->ftag.streamid);
+      }
+      // open a read datastream for the target file ( by reference path )
+      else if (datastream_scan(&readstream, reftgt, rpipe->pos)) {
+         errval = (errno) ? errno : ENOTRECOVERABLE;
+         LOG(LOG_ERR, "Failed to open read stream for reference target: \"%s\"\n", reftgt);
+      }
+
+      // read all data from the file, terminating it with an empty ( or error ) chunk
+      ssize_t iores = 1;
+      while (iores > 0) {
+         repack_chunk* chunk = repack_claimchunk(rpipe);
+         if (chunk == NULL) { break; } // writer has aborted
+
+         if (errval) { iores = -1; }
+         else {
+            iores = datastream_read(&readstream, chunk->buf, REPACK_BUFSIZE);
+            if (iores < 0) {
+               errval = (errno) ? errno : ENOTRECOVERABLE;
+               LOG(LOG_ERR, "Failed to read from reference target: \"%s\"\n", reftgt);
+            }
+         }
+
+         chunk->len = iores;
+         chunk->errval = errval;
+         repack_fillchunk(rpipe);
+      }
+
+      if (reftgt) { free(reftgt); }
+      if (iores) { readerror = 1; break; } // no further progress is possible
+   }
+
+   // terminate our read stream
+   if (readstream) {
+      if (readerror) {
+         if (datastream_release(&readstream)) {
+            LOG(LOG_WARNING, "Failed to abort read stream after previous failure\n");
+         }
+      }
+      else if (datastream_close(&readstream)) {
+         // this isn't worth aborting over, it's just... odd
+         LOG(LOG_WARNING, "Failed to close read stream\n");
+      }
+   }
+
+   return NULL;
+}
+
 static void process_repack(marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, const char* ctagsuf) {
    // check out a repack stream reference
    DATASTREAM* rpckstream = repackstreamer_getstream(rpckstr);
@@ -465,9 +605,41 @@ static void process_repack(marfs_position* pos, opinfo* op, REPACKSTREAMER rpcks
       }
    }
 
-   // allocate a 1MiB buffer to use for data migration
-   void* iobuf = malloc(1024 * 1024);
-   DATASTREAM readstream = NULL;
+   // allocate buffers to use for data migration
+   repack_pipeline rpipe = {
+      .head = 0,
+      .count = 0,
+      .abort = 0,
+      .pos = pos,
+      .reftable = reftable,
+      .ops = op
+   };
+   pthread_mutex_init(&rpipe.lock, NULL);
+   pthread_cond_init(&rpipe.filled, NULL);
+   pthread_cond_init(&rpipe.emptied, NULL);
+   for (int index = 0; index < REPACK_BUFCOUNT; index++) {
+      rpipe.chunks[index].buf = malloc(REPACK_BUFSIZE);
+      if (rpipe.chunks[index].buf == NULL) {
+         LOG(LOG_ERR, "Failed to allocate repack buffer %d\n", index);
+         rpckerror = 1;
+      }
+   }
+
+   // start reading ahead
+   pthread_t reader;
+   char readerstarted = 0;
+   if (!rpckerror) {
+      if (pthread_create(&reader, NULL, repack_readahead, &rpipe)) {
+         LOG(LOG_ERR, "Failed to start repack read-ahead thread\n");
+         rpckerror = 1;
+      }
+      else { readerstarted = 1; }
+   }
+
+   struct timespec starttime;
+   clock_gettime(CLOCK_MONOTONIC, &starttime);
+   size_t rpckbytes = 0;
+   size_t rpckfiles = 0;
    opinfo* prevop = op;
 
    for (; op; op = op->next) {
@@ -479,6 +651,7 @@ static void process_repack(marfs_position* pos, opinfo* op, REPACKSTREAMER rpcks
       if (reftgt == NULL) {
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
          LOG(LOG_ERR, "Failed to identify reference path of active fileno %zu of stream \"%s\"\n", op->ftag.fileno, op->ftag.streamid);
+         repack_abort(&rpipe);
          rpckerror = 1;
          continue;
       }
@@ -507,62 +680,74 @@ static void process_repack(marfs_position* pos, opinfo* op, REPACKSTREAMER rpcks
          LOG(LOG_ERR, "Failed to open repack stream for reference target: \"%s\"\n", reftgt);
          free(ctag);
          free(reftgt);
+         repack_abort(&rpipe);
          rpckerror = 1;
          continue;
       }
 
       free(ctag);
 
-      // open a read datastream for the target file
-      if (datastream_open(&readstream, READ_STREAM, reftgt, pos, NULL)) {
-         op->errval = (errno) ? errno : ENOTRECOVERABLE;
-         LOG(LOG_ERR, "Failed to open read stream for reference target: \"%s\"\n", reftgt);
-         if (datastream_release(rpckstream)) {
-            LOG(LOG_WARNING, "Failed to abort repack stream after previous failure\n");
-         }
-         free(reftgt);
-         rpckerror = 1;
-         continue;
-      }
-
-      // read all data from the file, writing it out to the repack stream
-      ssize_t iores = 1024 * 1024;
-      while (iores) {
-         iores = datastream_read(&readstream, iobuf, 1024 * 1024);
+      // write all read-ahead data of the file out to the repack stream
+      int errval = 0;
+      ssize_t iores = 1;
+      while (iores > 0) {
+         repack_chunk* chunk = repack_nextchunk(&rpipe);
+         iores = chunk->len;
 
          if (iores < 0) {
+            errval = chunk->errval;
             LOG(LOG_ERR, "Failed to read from reference target: \"%s\"\n", reftgt);
-            break;
          }
-
-         if (iores != datastream_write(rpckstream, iobuf, (size_t)iores)) {
+         else if (iores && iores != datastream_write(rpckstream, chunk->buf, (size_t)iores)) {
+            errval = errno;
             LOG(LOG_ERR, "Failed to write to repack stream of reference target: \"%s\"\n", reftgt);
-            break;
+            iores = -1;
          }
+         else { rpckbytes += (size_t)iores; }
+
+         repack_consumechunk(&rpipe);
       }
 
       if (iores) {
-         op->errval = (errno) ? errno : ENOTRECOVERABLE;
+         op->errval = (errval) ? errval : ENOTRECOVERABLE;
 
          // cleanup from previous errors
          if (datastream_release(rpckstream)) {
             LOG(LOG_WARNING, "Failed to abort repack stream after previous failure\n");
          }
-         if (datastream_release(&readstream)) {
-            LOG(LOG_WARNING, "Failed to abort read stream after previous failure\n");
-         }
 
          free(reftgt);
+         repack_abort(&rpipe);
          rpckerror = 1;
          continue;
       }
 
       free(reftgt);
+      rpckfiles++;
       prevop = op;
    }
 
-   // cleanup our iobuffer
-   if (iobuf) { free(iobuf); }
+   // wait for read-ahead to terminate ( closing its read stream )
+   if (readerstarted) { pthread_join(reader, NULL); }
+
+   // report our throughput ( computed entirely within LOG(), as nothing else requires it )
+   struct timespec endtime;
+   clock_gettime(CLOCK_MONOTONIC, &endtime);
+   if (rpckbytes) {
+      LOG(LOG_INFO, "Repacked %zu bytes of %zu files in %.3fs ( %.2f MB/s )\n",
+          rpckbytes, rpckfiles, repack_seconds(&starttime, &endtime),
+          (repack_seconds(&starttime, &endtime) > 0.0) ?
+             ((double)rpckbytes / 1000000.0) / repack_seconds(&starttime, &endtime) : 0.0);
+   }
+   if (rpckstr) { repackstreamer_account(rpckstr, rpckbytes); }
+
+   // cleanup our iobuffers
+   for (int index = 0; index < REPACK_BUFCOUNT; index++) {
+      if (rpipe.chunks[index].buf) { free(rpipe.chunks[index].buf); }
+   }
+   pthread_cond_destroy(&rpipe.emptied);
+   pthread_cond_destroy(&rpipe.filled);
+   pthread_mutex_destroy(&rpipe.lock);
 
    // potentially destroy our custom hash table
    if (reftable != pos->ns->prepo->metascheme.reftable) {
@@ -581,12 +766,6 @@ static void process_repack(marfs_position* pos, opinfo* op, REPACKSTREAMER rpcks
       }
    }
 
-   // close our read stream
-   if (readstream && datastream_close(&readstream)) {
-      // this isn't worth aborting over, it's just... odd
-      LOG(LOG_WARNING, "Failed to close read stream\n");
-   }
-
    // check in our repack stream reference (will only be closed when the repackstreamer is terminated)
    if (rpckstr && repackstreamer_returnstream(rpckstr, rpckstream)) {
       // this is a problem, so at least mark our final op as being in error
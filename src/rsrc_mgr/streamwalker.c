@@ -10,9 +10,33 @@
 #include "rsrc_mgr/common.h"
 #include "rsrc_mgr/streamwalker.h"
 
+static void freefileinfo(streamwalker_fileinfo* info) {
+   if (info->gctagstr) { free(info->gctagstr); }
+   if (info->ftagstr) { free(info->ftagstr); }
+}
+
 static void destroystreamwalker(streamwalker walker) {
    if (walker) {
       marfs_ms* ms = &walker->pos.ns->prepo->metascheme;
+      if (walker->prefetchtq) {
+         // halt all helper threads, discarding any outstanding prefetches
+         tq_set_flags(walker->prefetchtq, TQ_ABORT);
+         while (tq_next_thread_status(walker->prefetchtq, NULL) > 0) {}
+         if (tq_close(walker->prefetchtq) > 0) {
+            while (tq_dequeue(walker->prefetchtq, TQ_ABORT, NULL) > 0) {}
+            tq_close(walker->prefetchtq);
+         }
+      }
+      if (walker->prefetch) {
+         int slot;
+         for (slot = 0; slot < SW_PREFETCH_DEPTH; slot++) {
+            if (walker->prefetch[slot].reftgt) { free(walker->prefetch[slot].reftgt); }
+            freefileinfo(&walker->prefetch[slot].info);
+         }
+         free(walker->prefetch);
+         pthread_cond_destroy(&walker->prefetchdone);
+         pthread_mutex_destroy(&walker->prefetchlock);
+      }
       if (walker->reftable && walker->reftable != ms->reftable) {
          // destroy the custom hash table
          HASH_NODE* nodelist = NULL;
@@ -29,7 +53,7 @@ static void destroystreamwalker(streamwalker walker) {
          }
       }
 
-      if (walker->ftagstr) { free(walker->ftagstr); }
+      freefileinfo(&walker->fileinfo);
       if (walker->gcops) { resourcelog_freeopinfo(walker->gcops); }
       if (walker->rpckops) { resourcelog_freeopinfo(walker->rpckops); }
       if (walker->rbldops) { resourcelog_freeopinfo(walker->rbldops); }
@@ -39,157 +63,368 @@ static void destroystreamwalker(streamwalker walker) {
    }
 }
 
-static int process_getfileinfo(const char* reftgt, char getxattrs, streamwalker walker, char* filestate) {
-   MDAL mdal = walker->pos.ns->prepo->metascheme.mdal;
-   if (getxattrs) {
+static ssize_t fetch_xattr(MDAL mdal, MDAL_FHANDLE handle, const char* name, char** strbuf, size_t* stralloc, const char* reftgt) {
+   ssize_t getres = mdal->fgetxattr(handle, 1, name, *strbuf, *stralloc - 1);
+
+   // check for overflow
+   if (getres > 0 && ((size_t) getres) >= *stralloc) {
+      // increase our allocated string length
+      char* newstr = malloc(sizeof(char) * (getres + 1));
+      if (newstr == NULL) {
+         LOG(LOG_ERR, "Failed to allocate a %zd byte \"%s\" buffer\n", getres + 1, name);
+         return -1;
+      }
+
+      // swap the new reference in
+      free(*strbuf);
+      *strbuf = newstr;
+      *stralloc = getres + 1;
+
+      // pull the xattr again
+      if (mdal->fgetxattr(handle, 1, name, *strbuf, *stralloc - 1) != getres) {
+         LOG(LOG_ERR, "Inconsistent length for \"%s\" of reference file target: \"%s\"\n", name, reftgt);
+         return -1;
+      }
+   }
+
+   // check for error (missing xattr is acceptable here though)
+   if (getres <= 0) {
+      if (errno != ENODATA) {
+         LOG(LOG_ERR, "Failed to retrieve \"%s\" of reference file target: \"%s\"\n", name, reftgt);
+         return -1;
+      }
+      return 0;
+   }
+
+   (*strbuf)[getres] = '\0'; // ensure our string is NULL terminated
+   return getres;
+}
+
+/**
+ * Retrieve the info of a reference file, without reference to any walker state
+ * NOTE -- This func is safe to call from helper threads, so long as each uses a distinct info struct
+ * @param MDAL mdal : MDAL to be used
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to be used
+ * @param const char* reftgt : Reference path of the target file
+ * @param streamwalker_fileinfo* info : Info struct to be populated ( getxattrs value indicates whether to pull xattrs )
+ * @return int : Zero on success ( including a missing file ), or -1 on failure
+ */
+static int fetch_fileinfo(MDAL mdal, MDAL_CTXT ctxt, const char* reftgt, streamwalker_fileinfo* info) {
+   info->gctaglen = 0;
+   info->ftaglen = 0;
+   if (info->getxattrs) {
+      // make sure we have xattr buffers
+      if (info->gctagstr == NULL) {
+         if ((info->gctagstr = malloc(sizeof(char) * 1024)) == NULL) {
+            LOG(LOG_ERR, "Failed to allocate a GCTAG string buffer\n");
+            return -1;
+         }
+         info->gctagalloc = 1024;
+      }
+      if (info->ftagstr == NULL) {
+         if ((info->ftagstr = malloc(sizeof(char) * 1024)) == NULL) {
+            LOG(LOG_ERR, "Failed to allocate a FTAG string buffer\n");
+            return -1;
+         }
+         info->ftagalloc = 1024;
+      }
+
       // open the target file
-      MDAL_FHANDLE handle = mdal->openref(walker->pos.ctxt, reftgt, O_RDONLY, 0);
+      MDAL_FHANDLE handle = mdal->openref(ctxt, reftgt, O_RDONLY, 0);
       if (handle == NULL) {
          if (errno == ENOENT) {
             LOG(LOG_INFO, "Reference file does not exist: \"%s\"\n", reftgt);
-            *filestate = 0;
+            info->filestate = 0;
             return 0;
          }
          LOG(LOG_ERR, "Failed to open current reference file target: \"%s\"\n", reftgt);
          return -1;
       }
 
-      // attempt to retrieve the GC tag
-      // NOTE -- it is ESSENTIAL to do this prior to the FTAG, so that ftagstr always contains the actual FTAG string
-      ssize_t getres = mdal->fgetxattr(handle, 1, GCTAG_NAME, walker->ftagstr, walker->ftagstralloc - 1);
-
-      // check for overflow
-      if (getres > 0 && ((size_t) getres) >= walker->ftagstralloc) {
-         // increase our allocated string length
-         char* newstr = malloc(sizeof(char) * (getres + 1));
-
-         // swap the new reference in
-         free(walker->ftagstr);
-         walker->ftagstr = newstr;
-         walker->ftagstralloc = getres + 1;
-
-         // pull the xattr again
-         if (mdal->fgetxattr(handle, 1, GCTAG_NAME, walker->ftagstr, walker->ftagstralloc - 1) != getres) {
-            LOG(LOG_ERR, "Inconsistent length for gctag of reference file target: \"%s\"\n", reftgt);
-            mdal->close(handle);
-            return -1;
-         }
+      // attempt to retrieve the GC tag and FTAG
+      if ((info->gctaglen = fetch_xattr(mdal, handle, GCTAG_NAME, &info->gctagstr, &info->gctagalloc, reftgt)) < 0  ||
+          (info->ftaglen = fetch_xattr(mdal, handle, FTAG_NAME, &info->ftagstr, &info->ftagalloc, reftgt)) < 0) {
+         mdal->close(handle);
+         return -1;
       }
 
-      // check for error (missing xattr is acceptable here though)
-      if (getres <= 0 && errno != ENODATA) {
-         LOG(LOG_ERR, "Failed to retrieve gctag of reference file target: \"%s\"\n", reftgt);
+      // stat the file
+      if (mdal->fstat(handle, &info->stval)) {
+         LOG(LOG_ERR, "Failed to stat reference file target via handle: \"%s\"\n", reftgt);
          mdal->close(handle);
          return -1;
       }
-      else if (getres > 0) {
-         // we must parse the GC tag value
-         walker->ftagstr[getres] = '\0'; // ensure our string is NULL terminated
-         if (gctag_initstr(&walker->gctag, walker->ftagstr)) {
-            LOG(LOG_ERR, "Failed to parse GCTAG for reference file target: \"%s\"\n", reftgt);
-            mdal->close(handle);
-            return -1;
-         }
+
+      // finally, close the file
+      if (mdal->close(handle)) {
+         // just complain
+         LOG(LOG_WARNING, "Failed to close handle for reference target: \"%s\"\n", reftgt);
       }
-      else {
-         // no GCTAG, so zero out values
-         walker->gctag.refcnt = 0;
-         walker->gctag.eos = 0;
-         walker->gctag.inprog = 0;
-         walker->gctag.delzero = 0;
+   }
+   // stat the file by path
+   else if (mdal->statref(ctxt, reftgt, &info->stval)) {
+      if (errno == ENOENT) {
+         LOG(LOG_INFO, "Reference file does not exist: \"%s\"\n", reftgt);
+         info->filestate = 0;
+         return 0;
       }
 
-      // retrieve FTAG of the current file
-      getres = mdal->fgetxattr(handle, 1, FTAG_NAME, walker->ftagstr, walker->ftagstralloc - 1);
-
-      // check for overflow
-      if (getres > 0 && ((size_t) getres) >= walker->ftagstralloc) {
-         // double our allocated string length
-         char* newstr = malloc(sizeof(char) * (getres + 1));
+      LOG(LOG_ERR, "Failed to stat reference file target via handle: \"%s\"\n", reftgt);
+      return -1;
+   }
 
-         // swap the new reference in
-         free(walker->ftagstr);
-         walker->ftagstr = newstr;
-         walker->ftagstralloc = getres + 1;
+   // populate state value based on link count
+   info->filestate = (info->stval.st_nlink > 1) ? 2 : 1;
+   return 0;
+}
 
-         // pull the xattr again
-         if (mdal->fgetxattr(handle, 1, FTAG_NAME, walker->ftagstr, walker->ftagstralloc - 1) != getres) {
-            LOG(LOG_ERR, "Inconsistent length for ftag of reference file target: \"%s\"\n", reftgt);
-            mdal->close(handle);
-            return -1;
-         }
-      }
+/**
+ * Update walker state to reflect the retrieved info of a reference file
+ * @param streamwalker walker : Walker to be updated
+ * @param streamwalker_fileinfo* info : Info of the reference file
+ * @param const char* reftgt : Reference path of the file
+ * @param char* filestate : Reference to be populated with the state of the file
+ * @return int : Zero on success, 1 if the file lacks an FTAG value, or -1 on failure
+ */
+static int apply_fileinfo(streamwalker walker, streamwalker_fileinfo* info, const char* reftgt, char* filestate) {
+   if (info->filestate == 0) {
+      *filestate = 0;
+      return 0;
+   }
 
-      // check for error (missing xattr is acceptable here though)
-      if (getres <= 0 && errno != ENODATA) {
-         LOG(LOG_ERR, "Failed to retrieve ftag of reference file target: \"%s\"\n", reftgt);
-         mdal->close(handle);
+   int retval = 0;
+   if (info->getxattrs && info->gctaglen) {
+      // we must parse the GC tag value
+      if (gctag_initstr(&walker->gctag, info->gctagstr)) {
+         LOG(LOG_ERR, "Failed to parse GCTAG for reference file target: \"%s\"\n", reftgt);
          return -1;
       }
+   }
+   else {
+      // no GCTAG, so zero out values
+      walker->gctag.refcnt = 0;
+      walker->gctag.eos = 0;
+      walker->gctag.inprog = 0;
+      walker->gctag.delzero = 0;
+   }
 
+   if (info->getxattrs) {
       // potentially parse the ftag
-      int retval = 1; // assume missing ftag
-      if (getres > 0) {
+      retval = 1; // assume missing ftag
+      if (info->ftaglen) {
          // potentially clear old ftag values
          if (walker->ftag.ctag) { free(walker->ftag.ctag); walker->ftag.ctag = NULL; }
          if (walker->ftag.streamid) { free(walker->ftag.streamid); walker->ftag.streamid = NULL; }
-         walker->ftagstr[getres] = '\0'; // ensure our string is NULL terminated
-         if (ftag_initstr(&walker->ftag, walker->ftagstr)) {
+         if (ftag_initstr(&walker->ftag, info->ftagstr)) {
             LOG(LOG_ERR, "Failed to parse ftag value of reference file target: \"%s\"\n", reftgt);
-            mdal->close(handle);
             return -1;
          }
          retval = 0; // indicate unmitigated success
       }
+   }
 
-      // stat the file
-      if (mdal->fstat(handle, &walker->stval)) {
-         LOG(LOG_ERR, "Failed to stat reference file target via handle: \"%s\"\n", reftgt);
-         mdal->close(handle);
-         return -1;
-      }
+   // NOTE -- The resource manager will skip pulling RTAG xattrs, in this specific case.
+   //         The 'location-based' rebuild, performed by this code, is intended for worst-case data damage situations.
+   //         It is intended to rebuild all objects tied to a specific location, without the need for a client to read
+   //         and tag those objects in advance.  As such, the expectation is that no RTAG values will exist.
+   //         If they do, they will be rebuilt seperately, via their rebuild marker file.
+   walker->stval = info->stval;
+   *filestate = info->filestate;
+   return retval;
+}
 
-      // finally, close the file
-      if (mdal->close(handle)) {
-         // just complain
-         LOG(LOG_WARNING, "Failed to close handle for reference target: \"%s\"\n", reftgt);
-      }
+static int process_getfileinfo(const char* reftgt, char getxattrs, streamwalker walker, char* filestate) {
+   walker->fileinfo.getxattrs = getxattrs;
+   if (fetch_fileinfo(walker->pos.ns->prepo->metascheme.mdal, walker->pos.ctxt, reftgt, &walker->fileinfo)) {
+      return -1;
+   }
+   return apply_fileinfo(walker, &walker->fileinfo, reftgt, filestate);
+}
 
-      // NOTE -- The resource manager will skip pulling RTAG xattrs, in this specific case.
-      //         The 'location-based' rebuild, performed by this code, is intended for worst-case data damage situations.
-      //         It is intended to rebuild all objects tied to a specific location, without the need for a client to read
-      //         and tag those objects in advance.  As such, the expectation is that no RTAG values will exist.
-      //         If they do, they will be rebuilt seperately, via their rebuild marker file.
-      // populate state value based on link count
-      *filestate = (walker->stval.st_nlink > 1) ? 2 : 1;
+static int prefetch_threadinit(unsigned int tID, void* global_state, void** state) {
+   (void) tID;
+   *state = global_state;
+   return 0;
+}
 
-      return retval;
+static int prefetch_consume(void** state, void** work_todo) {
+   streamwalker walker = (streamwalker)(*state);
+   streamwalker_prefetch* slot = (streamwalker_prefetch*)(*work_todo);
+   int result = fetch_fileinfo(walker->pos.ns->prepo->metascheme.mdal, walker->pos.ctxt, slot->reftgt, &slot->info);
+   int error = errno;
+   pthread_mutex_lock(&walker->prefetchlock);
+   slot->result = result;
+   slot->error = error;
+   slot->pending = 0;
+   pthread_cond_broadcast(&walker->prefetchdone);
+   pthread_mutex_unlock(&walker->prefetchlock);
+   *work_todo = NULL;
+   return 0;
+}
+
+static void prefetch_threadterm(void** state, void** prev_work, TQ_Control_Flags flg) {
+   (void) state;
+   (void) prev_work;
+   (void) flg;
+}
+
+static int prefetch_init(streamwalker walker) {
+   walker->prefetch = calloc(SW_PREFETCH_DEPTH, sizeof(streamwalker_prefetch));
+   if (walker->prefetch == NULL) {
+      LOG(LOG_ERR, "Failed to allocate prefetch slots\n");
+      return -1;
    }
 
-   // stat the file by path
-   if (mdal->statref(walker->pos.ctxt, reftgt, &walker->stval)) {
-      if (errno == ENOENT) {
-         LOG(LOG_INFO, "Reference file does not exist: \"%s\"\n", reftgt);
-         *filestate = 0;
-         return 0;
-      }
+   if (pthread_mutex_init(&walker->prefetchlock, NULL)) {
+      LOG(LOG_ERR, "Failed to initialize prefetch lock\n");
+      free(walker->prefetch);
+      walker->prefetch = NULL;
+      return -1;
+   }
 
-      LOG(LOG_ERR, "Failed to stat reference file target via handle: \"%s\"\n", reftgt);
+   if (pthread_cond_init(&walker->prefetchdone, NULL)) {
+      LOG(LOG_ERR, "Failed to initialize prefetch condition\n");
+      pthread_mutex_destroy(&walker->prefetchlock);
+      free(walker->prefetch);
+      walker->prefetch = NULL;
       return -1;
    }
 
-   // zero out some xattr values, so we don't get confused
-   walker->gctag.refcnt = 0;
-   walker->gctag.eos = 0;
-   walker->gctag.delzero = 0;
-   walker->gctag.inprog = 0;
+   TQ_Init_Opts tqopts = {
+      .log_prefix = "SWPrefetch",
+      .init_flags = TQ_NONE,
+      .max_qdepth = SW_PREFETCH_DEPTH,
+      .global_state = walker,
+      .num_threads = SW_PREFETCH_THREADS,
+      .num_prod_threads = 0,
+      .thread_init_func = prefetch_threadinit,
+      .thread_consumer_func = prefetch_consume,
+      .thread_producer_func = NULL,
+      .thread_pause_func = NULL,
+      .thread_resume_func = NULL,
+      .thread_term_func = prefetch_threadterm
+   };
 
-   // populate state value based on link count
-   *filestate = (walker->stval.st_nlink > 1) ? 2 : 1;
+   walker->prefetchtq = tq_init(&tqopts);
+   if (walker->prefetchtq == NULL) {
+      LOG(LOG_ERR, "Failed to initialize prefetch thread queue\n");
+      return -1; // slots are cleaned up along with the walker
+   }
+
+   if (tq_check_init(walker->prefetchtq)) {
+      LOG(LOG_ERR, "Failed to initialize prefetch threads\n");
+      tq_set_flags(walker->prefetchtq, TQ_ABORT);
+      while (tq_next_thread_status(walker->prefetchtq, NULL) > 0) {}
+      tq_close(walker->prefetchtq);
+      walker->prefetchtq = NULL;
+      return -1;
+   }
 
    return 0;
 }
 
+/**
+ * Queue up fetches of the info of all reference files following the given target, which are not already
+ * outstanding
+ * NOTE -- Reference paths are predicted by assuming no GCTAG skips, so any file following a GCTAG refcnt
+ *         will simply fall back to a synchronous fetch
+ * @param streamwalker walker : Walker to issue prefetches for
+ * @param size_t curfileno : File number of the current reference target
+ * @param char getxattrs : Flag indicating whether xattrs should be retrieved
+ */
+static void prefetch_schedule(streamwalker walker, size_t curfileno, char getxattrs) {
+   // NOTE -- the walker's FTAG is used as our template, as any FTAG of this stream will produce the same paths
+   FTAG tmptag = walker->ftag;
+   size_t fileno;
+   for (fileno = curfileno + 1; fileno < curfileno + SW_PREFETCH_DEPTH; fileno++) {
+      streamwalker_prefetch* slot = walker->prefetch + (fileno % SW_PREFETCH_DEPTH);
+
+      pthread_mutex_lock(&walker->prefetchlock);
+      char pending = slot->pending;
+      pthread_mutex_unlock(&walker->prefetchlock);
+
+      if (slot->reftgt && slot->fileno == fileno && slot->info.getxattrs == getxattrs) {
+         continue; // this file has already been fetched / is being fetched
+      }
+
+      if (pending) {
+         continue; // this slot is still occupied by a stale prefetch
+      }
+
+      if (slot->reftgt) {
+         free(slot->reftgt);
+         slot->reftgt = NULL;
+      }
+
+      tmptag.fileno = fileno;
+      slot->reftgt = datastream_genrpath(&tmptag, walker->reftable, NULL, NULL);
+      if (slot->reftgt == NULL) {
+         LOG(LOG_WARNING, "Failed to generate reference path for prefetch of file %zu\n", fileno);
+         return;
+      }
+
+      slot->fileno = fileno;
+      slot->info.getxattrs = getxattrs;
+      slot->pending = 1; // no helper thread can be referencing this slot, so no need for the lock
+      if (tq_enqueue(walker->prefetchtq, TQ_NONE, slot)) {
+         LOG(LOG_WARNING, "Failed to enqueue prefetch of file %zu\n", fileno);
+         slot->pending = 0;
+         free(slot->reftgt);
+         slot->reftgt = NULL;
+         return;
+      }
+   }
+}
+
+/**
+ * Retrieve info of the given reference target, preferring previously prefetched info and issuing prefetches of
+ * subsequent reference targets
+ * @param streamwalker walker : Walker to retrieve file info for
+ * @param FTAG* tgttag : FTAG of the reference target
+ * @param const char* reftgt : Reference path of the target
+ * @param char getxattrs : Flag indicating whether xattrs should be retrieved
+ * @param char* filestate : Reference to be populated with the state of the file
+ * @return int : Zero on success, 1 if the file lacks an FTAG value, or -1 on failure
+ */
+static int prefetch_getfileinfo(streamwalker walker, FTAG* tgttag, const char* reftgt, char getxattrs, char* filestate) {
+   // lazily start our helper threads
+   if (walker->prefetch == NULL && prefetch_init(walker)) {
+      LOG(LOG_WARNING, "Failed to initialize prefetching, falling back to synchronous fetches\n");
+   }
+
+   if (walker->prefetchtq == NULL) {
+      return process_getfileinfo(reftgt, getxattrs, walker, filestate);
+   }
+
+   // wait for any outstanding fetch of our target slot
+   streamwalker_prefetch* slot = walker->prefetch + (tgttag->fileno % SW_PREFETCH_DEPTH);
+   pthread_mutex_lock(&walker->prefetchlock);
+   while (slot->pending) {
+      pthread_cond_wait(&walker->prefetchdone, &walker->prefetchlock);
+   }
+   pthread_mutex_unlock(&walker->prefetchlock);
+
+   int retval;
+   if (slot->reftgt && slot->fileno == tgttag->fileno && slot->info.getxattrs == getxattrs &&
+       slot->result == 0 && strcmp(slot->reftgt, reftgt) == 0) {
+      retval = apply_fileinfo(walker, &slot->info, reftgt, filestate);
+   }
+   else {
+      // either an unpredicted target, or a failed prefetch ( which is retried, to report the actual error )
+      retval = process_getfileinfo(reftgt, getxattrs, walker, filestate);
+   }
+
+   if (slot->reftgt) {
+      free(slot->reftgt);
+      slot->reftgt = NULL;
+   }
+
+   // queue up fetches for subsequent files
+   prefetch_schedule(walker, tgttag->fileno, getxattrs);
+
+   return retval;
+}
+
 static int searchoperations(opinfo** opchain, operation_type type, FTAG* ftag, opinfo** optgt) {
    opinfo* prevop = NULL;
    if (opchain && *opchain) {
@@ -380,8 +615,9 @@ int streamwalker_open(streamwalker* swalker, marfs_position* pos, const char* re
    memset(&walker->ftag, 0, sizeof(FTAG));
    memset(&walker->gctag, 0, sizeof(GCTAG));
    walker->headerlen = 0;
-   walker->ftagstr = malloc(sizeof(char) * 1024);
-   walker->ftagstralloc = 1024;
+   memset(&walker->fileinfo, 0, sizeof(streamwalker_fileinfo));
+   walker->prefetchtq = NULL;
+   walker->prefetch = NULL;
    walker->gcops = NULL;
    walker->activefiles = 0;
    walker->activeindex = 0;
@@ -394,7 +630,7 @@ int streamwalker_open(streamwalker* swalker, marfs_position* pos, const char* re
    int getres = process_getfileinfo(reftgt, 1, walker, &filestate);
    if (getres < 0 || !(filestate)) {
       LOG(LOG_ERR, "Failed to get info from initial reference target: \"%s\"\n", reftgt);
-      free(walker->ftagstr);
+      freefileinfo(&walker->fileinfo);
       free(walker);
       return -1;
    }
@@ -415,7 +651,7 @@ int streamwalker_open(streamwalker* swalker, marfs_position* pos, const char* re
          retval = 1;
       }
 
-      free(walker->ftagstr);
+      freefileinfo(&walker->fileinfo);
       free(walker);
 
       // this is not a fatal condition
@@ -741,7 +977,7 @@ int streamwalker_iterate(streamwalker* swalker, opinfo** gcops, opinfo** repacko
       char filestate = -1;
       char prevdelzero = walker->gctag.delzero;
       char haveftag = pullxattrs;
-      int getres = process_getfileinfo(reftgt, pullxattrs, walker, &filestate);
+      int getres = prefetch_getfileinfo(walker, &tmptag, reftgt, pullxattrs, &filestate);
       if (getres < 0) {
          LOG(LOG_ERR, "Failed to get info for reference target: \"%s\"\n", reftgt);
          free(reftgt);
@@ -9,11 +9,14 @@
  * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
  */
 
+#include <pthread.h>
 #include <stdint.h>
+#include <sys/stat.h>
 #include <time.h>
 
 #include "datastream/datastream.h"
 #include "resourcelog.h"
+#include "thread_queue/thread_queue.h"
 
 //   -------------   INTERNAL DEFINITIONS    -------------
 
@@ -58,6 +61,30 @@ typedef struct {
    size_t rbldbytes;  // count of rebuilt bytes
 } streamwalker_report;
 
+#define SW_PREFETCH_DEPTH 16  // number of reference file info slots ( files are fetched up to DEPTH - 1 ahead of iteration )
+#define SW_PREFETCH_THREADS 4 // number of helper threads used to fetch reference file info
+
+typedef struct {
+   char        getxattrs;  // flag indicating that GCTAG/FTAG values were ( or are to be ) retrieved
+   char        filestate;  // 0 -> file does not exist, 1 -> file has a single link, 2 -> file has multiple links
+   struct stat stval;      // stat value of the file
+   ssize_t     gctaglen;   // length of the retrieved GCTAG string ( zero, if none was found )
+   char*       gctagstr;   // GCTAG string buffer
+   size_t      gctagalloc; // allocated length of the GCTAG string buffer
+   ssize_t     ftaglen;    // length of the retrieved FTAG string ( zero, if none was found )
+   char*       ftagstr;    // FTAG string buffer
+   size_t      ftagalloc;  // allocated length of the FTAG string buffer
+} streamwalker_fileinfo;
+
+typedef struct {
+   size_t      fileno;     // file number targeted by this slot
+   char*       reftgt;     // reference path targeted by this slot ( NULL, if the slot is unused )
+   char        pending;    // flag indicating that a helper thread has yet to complete this fetch
+   int         result;     // result of the fetch ( zero on success, -1 on failure )
+   int         error;      // errno value of a failed fetch
+   streamwalker_fileinfo info;
+} streamwalker_prefetch;
+
 typedef struct streamwalker {
    // initialization info
    marfs_position pos;
@@ -77,8 +104,12 @@ typedef struct streamwalker {
    GCTAG       gctag;     // GCTAG value of the most recently checked file (not necessarily previous)
    // cached info
    size_t      headerlen;    // recovery header length for the active datastream
-   char*       ftagstr;      // FTAG string buffer
-   size_t      ftagstralloc; // allocated length of the FTAG string buffer
+   streamwalker_fileinfo fileinfo; // info buffer for synchronous reference file fetches
+   // prefetch info
+   ThreadQueue prefetchtq;   // helper threads fetching info of upcoming reference files ( NULL, until first needed )
+   streamwalker_prefetch* prefetch; // ring of prefetch slots, indexed by file number
+   pthread_mutex_t prefetchlock; // lock protecting the 'pending' state of prefetch slots
+   pthread_cond_t prefetchdone;  // signaled upon completion of any prefetch
    // GC info
    opinfo*     gcops;        // garbage collection operation list
    size_t      activefiles;  // count of active files referencing the current object
@@ -402,6 +402,14 @@ static int handle_complete_request(rmanstate* rman, workrequest* request, workre
 
    if (rlogret) { response->errorlog = 1; } // note if our log was preserved due to errors being present
    if (rman->gstate.rpst) {
+      // all threads have terminated, so repack throughput values are now stable
+      response->summary.repack_bytes = rman->gstate.rpst->bytes;
+      response->summary.repack_usecs = rman->gstate.rpst->usecs;
+      if (response->summary.repack_usecs) {
+         LOG(LOG_INFO, "Rank %zu repacked %zu bytes of NS \"%s\" at %.2f MB/s\n", rman->ranknum,
+             response->summary.repack_bytes, rman->gstate.pos.ns->idstr,
+             (double)response->summary.repack_bytes / (double)response->summary.repack_usecs);
+      }
       if (repackstreamer_complete(rman->gstate.rpst)) {
          LOG(LOG_ERR, "Failed to complete repack streamer during completion of NS \"%s\"\n", rman->gstate.pos.ns->idstr);
          snprintf(response->errorstr, MAX_ERROR_BUFFER,
@@ -511,6 +519,8 @@ static void update_log_summary(rmanstate* rman, workresponse* response) {
     rman->logsummary[response->request.nsindex].rebuild_failures            += response->summary.rebuild_failures;
     rman->logsummary[response->request.nsindex].repack_count                += response->summary.repack_count;
     rman->logsummary[response->request.nsindex].repack_failures             += response->summary.repack_failures;
+    rman->logsummary[response->request.nsindex].repack_bytes                += response->summary.repack_bytes;
+    rman->logsummary[response->request.nsindex].repack_usecs                += response->summary.repack_usecs;
 }
 
 static int handle_rlog_ns_response(rmanstate* rman, const size_t ranknum, workresponse* response, workrequest* request) {
@@ -587,7 +597,14 @@ static int handle_rlog_ns_response(rmanstate* rman, const size_t ranknum, workre
 
 static int handle_complete_response(rmanstate* rman, const size_t ranknum, workresponse* response, workrequest* request) {
    if (response->request.nsindex != rman->nscount) { // only perform processing / cleanup for real completions
-      printf("  Rank %zu completed work on NS \"%s\"\n", ranknum, rman->nslist[response->request.nsindex]->idstr);
+      if (response->haveinfo && response->summary.repack_usecs) {
+         printf("  Rank %zu completed work on NS \"%s\" ( repacked at %.2f MB/s )\n", ranknum,
+                rman->nslist[response->request.nsindex]->idstr,
+                (double)response->summary.repack_bytes / (double)response->summary.repack_usecs);
+      }
+      else {
+         printf("  Rank %zu completed work on NS \"%s\"\n", ranknum, rman->nslist[response->request.nsindex]->idstr);
+      }
       // possibly process info from the rank
       if (response->haveinfo) {
          update_walk_report(rman, response);
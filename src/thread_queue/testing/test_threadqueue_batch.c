@@ -0,0 +1,425 @@
+/**
+ * Copyright 2015. Triad National Security, LLC. All rights reserved.
+ *
+ * Full details and licensing terms can be found in the License file in the main development branch
+ * of the repository.
+ *
+ * MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier: LA-CC-15-039.
+ */
+
+#include "thread_queue/thread_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#define NUM_CONS 4
+#define QDEPTH 64
+#define TOT_WRK 200000
+#define BATCH_CNT 16
+
+typedef struct thread_state_struct
+{
+   unsigned int tID;
+   size_t wkcnt;
+   size_t wksum;
+   size_t nextpkg;
+   char misordered;
+} * ThreadState;
+
+// work packages are simply package numbers, offset by one to avoid NULL values
+#define PKG_TO_WORK(pkgnum) ((void *)(uintptr_t)((pkgnum) + 1))
+#define WORK_TO_PKG(work) ((size_t)(uintptr_t)(work)-1)
+
+int my_thread_init(unsigned int tID, void *global_state, void **state)
+{
+   *state = calloc(1, sizeof(struct thread_state_struct));
+   if (*state == NULL)
+   {
+      return -1;
+   }
+   ((ThreadState)*state)->tID = tID;
+   return 0;
+}
+
+int my_consumer(void **state, void **work)
+{
+   ThreadState tstate = ((ThreadState)*state);
+   tstate->wkcnt++;
+   tstate->wksum += WORK_TO_PKG(*work);
+   *work = NULL;
+   return 0;
+}
+
+// single consumer, verifying that packages arrive in exactly the order they were enqueued
+int order_consumer(void **state, void **work)
+{
+   ThreadState tstate = ((ThreadState)*state);
+   if (tstate->wkcnt && WORK_TO_PKG(*work) != tstate->nextpkg)
+   {
+      printf("Consumer received package %zu, but expected package %zu\n", WORK_TO_PKG(*work), tstate->nextpkg);
+      tstate->misordered = 1;
+   }
+   tstate->nextpkg = WORK_TO_PKG(*work) + 1;
+   tstate->wkcnt++;
+   *work = NULL;
+   return 0;
+}
+
+int my_producer(void **state, void **work)
+{
+   ThreadState tstate = ((ThreadState)*state);
+   *work = PKG_TO_WORK(tstate->nextpkg);
+   tstate->wkcnt++;
+   tstate->nextpkg++;
+   if (tstate->nextpkg >= TOT_WRK)
+   {
+      return 1;
+   }
+   return 0;
+}
+
+void my_thread_term(void **state, void **prev_work, TQ_Control_Flags flg)
+{
+   return;
+}
+
+// elapsed nanoseconds between two timespec values
+static double elapsed_ns(struct timespec *start, struct timespec *end)
+{
+   return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+// collect all thread states from a completed queue, totalling their work counts and sums
+static int collect_states(ThreadQueue tq, size_t *wkcnt, size_t *wksum)
+{
+   *wkcnt = 0;
+   *wksum = 0;
+   int tres = 0;
+   ThreadState tstate = NULL;
+   while ((tres = tq_next_thread_status(tq, (void **)&tstate)) > 0)
+   {
+      if (tstate == NULL)
+      {
+         printf("Received NULL thread status\n");
+         return -1;
+      }
+      *wkcnt += tstate->wkcnt;
+      *wksum += tstate->wksum;
+      free(tstate);
+   }
+   if (tres != 0)
+   {
+      printf("Failure of tq_next_thread_status()!\n");
+      return -1;
+   }
+   return 0;
+}
+
+// verify batch insertion limits, discards, and ordering against a single consumer
+static int check_batch_order(void)
+{
+   TQ_Init_Opts tqopts = {0};
+   tqopts.log_prefix = "BatchOrderTQ";
+   tqopts.init_flags = TQ_HALT; // keep our consumer idle, until we have inspected the queue
+   tqopts.num_threads = 1;
+   tqopts.num_prod_threads = 0;
+   tqopts.max_qdepth = QDEPTH;
+   tqopts.thread_init_func = my_thread_init;
+   tqopts.thread_consumer_func = order_consumer;
+   tqopts.thread_term_func = my_thread_term;
+   ThreadQueue tq = tq_init(&tqopts);
+   if (tq == NULL)
+   {
+      printf("tq_init() failed!\n");
+      return -1;
+   }
+
+   // a batch beyond the available queue space should only be partially inserted
+   void *workbuffs[QDEPTH + BATCH_CNT];
+   size_t pkgnum = 0;
+   for (; pkgnum < QDEPTH + BATCH_CNT; pkgnum++)
+   {
+      workbuffs[pkgnum] = PKG_TO_WORK(pkgnum);
+   }
+   int res = tq_enqueue_batch(tq, TQ_HALT, workbuffs, QDEPTH + BATCH_CNT);
+   if (res != QDEPTH || tq_depth(tq) != QDEPTH)
+   {
+      printf("Batch enqueue of %d packages to an empty queue inserted %d ( depth %d ), expected %d\n",
+             QDEPTH + BATCH_CNT, res, tq_depth(tq), QDEPTH);
+      return -1;
+   }
+   // a NULL work list should discard packages from the head of the queue
+   res = tq_dequeue_batch(tq, TQ_HALT, NULL, BATCH_CNT);
+   if (res != BATCH_CNT || tq_depth(tq) != QDEPTH - BATCH_CNT)
+   {
+      printf("Batch discard of %d packages returned %d ( depth %d )\n", BATCH_CNT, res, tq_depth(tq));
+      return -1;
+   }
+   // the next batch should continue from exactly where the discard ended
+   res = tq_dequeue_batch(tq, TQ_HALT, workbuffs, BATCH_CNT);
+   if (res != BATCH_CNT)
+   {
+      printf("Batch dequeue of %d packages returned %d\n", BATCH_CNT, res);
+      return -1;
+   }
+   int index = 0;
+   for (; index < res; index++)
+   {
+      if (WORK_TO_PKG(workbuffs[index]) != (size_t)(BATCH_CNT + index))
+      {
+         printf("Batch dequeue element %d holds package %zu, expected %d\n",
+                index, WORK_TO_PKG(workbuffs[index]), BATCH_CNT + index);
+         return -1;
+      }
+   }
+
+   // the consumer should receive every remaining package in order, including partial batches
+   if (tq_unset_flags(tq, TQ_HALT))
+   {
+      printf("Failed to unset HALT flag\n");
+      return -1;
+   }
+   pkgnum = QDEPTH;
+   while (pkgnum < TOT_WRK)
+   {
+      unsigned int count = 0;
+      for (; count < BATCH_CNT - 1 && (pkgnum + count) < TOT_WRK; count++)
+      {
+         workbuffs[count] = PKG_TO_WORK(pkgnum + count);
+      }
+      res = tq_enqueue_batch(tq, 0, workbuffs, count);
+      if (res <= 0 || res > (int)count)
+      {
+         printf("Batch enqueue of %u packages returned %d\n", count, res);
+         return -1;
+      }
+      pkgnum += res;
+   }
+   if (tq_set_flags(tq, TQ_FINISHED) || tq_wait_for_completion(tq))
+   {
+      printf("Failed to complete ordered queue\n");
+      return -1;
+   }
+   ThreadState tstate = NULL;
+   if (tq_next_thread_status(tq, (void **)&tstate) <= 0 || tstate == NULL)
+   {
+      printf("Failed to retrieve the ordered consumer state\n");
+      return -1;
+   }
+   int misordered = tstate->misordered;
+   size_t wkcnt = tstate->wkcnt;
+   size_t nextpkg = tstate->nextpkg;
+   free(tstate);
+   if (tq_next_thread_status(tq, (void **)&tstate) != 0 || tq_close(tq))
+   {
+      printf("Unexpected thread status or close result of ordered queue\n");
+      return -1;
+   }
+   if (misordered || wkcnt != TOT_WRK - (2 * BATCH_CNT) || nextpkg != TOT_WRK)
+   {
+      printf("Ordered consumer processed %zu packages, ending at %zu ( misordered = %d )\n", wkcnt, nextpkg, misordered);
+      return -1;
+   }
+   return 0;
+}
+
+// enqueue all work packages to consumer threads, either individually or in batches, returning ns per package
+static double time_enqueue(int batch)
+{
+   TQ_Init_Opts tqopts = {0};
+   tqopts.log_prefix = "BatchEnqTQ";
+   tqopts.init_flags = 0;
+   tqopts.num_threads = NUM_CONS;
+   tqopts.num_prod_threads = 0;
+   tqopts.max_qdepth = QDEPTH;
+   tqopts.thread_init_func = my_thread_init;
+   tqopts.thread_consumer_func = my_consumer;
+   tqopts.thread_term_func = my_thread_term;
+   ThreadQueue tq = tq_init(&tqopts);
+   if (tq == NULL)
+   {
+      printf("tq_init() failed!\n");
+      return -1.0;
+   }
+
+   struct timespec start, end;
+   clock_gettime(CLOCK_MONOTONIC, &(start));
+   size_t pkgnum = 0;
+   while (pkgnum < TOT_WRK)
+   {
+      if (batch)
+      {
+         void *workbuffs[BATCH_CNT];
+         unsigned int count = 0;
+         for (; count < BATCH_CNT && (pkgnum + count) < TOT_WRK; count++)
+         {
+            workbuffs[count] = PKG_TO_WORK(pkgnum + count);
+         }
+         int res = tq_enqueue_batch(tq, 0, workbuffs, count);
+         if (res <= 0)
+         {
+            printf("Failed to batch enqueue at package %zu\n", pkgnum);
+            return -1.0;
+         }
+         pkgnum += res;
+      }
+      else
+      {
+         if (tq_enqueue(tq, 0, PKG_TO_WORK(pkgnum)))
+         {
+            printf("Failed to enqueue package %zu\n", pkgnum);
+            return -1.0;
+         }
+         pkgnum++;
+      }
+   }
+   if (tq_set_flags(tq, TQ_FINISHED) || tq_wait_for_completion(tq))
+   {
+      printf("Failed to complete enqueue queue\n");
+      return -1.0;
+   }
+   clock_gettime(CLOCK_MONOTONIC, &(end));
+
+   // a FINISHED queue should reject any further work
+   void *extra = PKG_TO_WORK(TOT_WRK);
+   if (tq_enqueue_batch(tq, 0, &extra, 1) != -1)
+   {
+      printf("Batch enqueue to a FINISHED queue did not fail\n");
+      return -1.0;
+   }
+
+   size_t wkcnt = 0;
+   size_t wksum = 0;
+   if (collect_states(tq, &wkcnt, &wksum))
+   {
+      return -1.0;
+   }
+   if (tq_close(tq))
+   {
+      printf("Received unexpected return from tq_close()\n");
+      return -1.0;
+   }
+   if (wkcnt != TOT_WRK || wksum != ((size_t)TOT_WRK * (TOT_WRK - 1)) / 2)
+   {
+      printf("Consumers processed %zu packages ( sum %zu ), expected %d\n", wkcnt, wksum, TOT_WRK);
+      return -1.0;
+   }
+   return elapsed_ns(&(start), &(end)) / TOT_WRK;
+}
+
+// dequeue all work packages from a producer thread, either individually or in batches, returning ns per package
+static double time_dequeue(int batch)
+{
+   TQ_Init_Opts tqopts = {0};
+   tqopts.log_prefix = "BatchDeqTQ";
+   tqopts.init_flags = 0;
+   tqopts.num_threads = 1;
+   tqopts.num_prod_threads = 1;
+   tqopts.max_qdepth = QDEPTH;
+   tqopts.thread_init_func = my_thread_init;
+   tqopts.thread_producer_func = my_producer;
+   tqopts.thread_term_func = my_thread_term;
+   ThreadQueue tq = tq_init(&tqopts);
+   if (tq == NULL)
+   {
+      printf("tq_init() failed!\n");
+      return -1.0;
+   }
+
+   // with a single producer, packages must be received in exactly the order they were produced
+   struct timespec start, end;
+   clock_gettime(CLOCK_MONOTONIC, &(start));
+   size_t pkgnum = 0;
+   int res = 1;
+   while (res > 0)
+   {
+      void *workbuffs[BATCH_CNT];
+      if (batch)
+      {
+         res = tq_dequeue_batch(tq, 0, workbuffs, BATCH_CNT);
+      }
+      else
+      {
+         res = tq_dequeue(tq, 0, workbuffs);
+         if (res > 0)
+         {
+            res = 1;
+         }
+      }
+      if (res > BATCH_CNT)
+      {
+         printf("Batch dequeue produced %d packages, beyond the requested %d\n", res, BATCH_CNT);
+         return -1.0;
+      }
+      int index = 0;
+      for (; index < res; index++)
+      {
+         if (WORK_TO_PKG(workbuffs[index]) != pkgnum)
+         {
+            printf("Received package %zu, but expected package %zu\n", WORK_TO_PKG(workbuffs[index]), pkgnum);
+            return -1.0;
+         }
+         pkgnum++;
+      }
+   }
+   clock_gettime(CLOCK_MONOTONIC, &(end));
+   if (res < 0)
+   {
+      printf("Failed to dequeue at package %zu\n", pkgnum);
+      return -1.0;
+   }
+   if (pkgnum != TOT_WRK)
+   {
+      printf("Dequeued %zu packages, expected %d\n", pkgnum, TOT_WRK);
+      return -1.0;
+   }
+
+   // an ABORTED queue should reject dequeues, unless that state is ignored
+   void *workbuffs[BATCH_CNT];
+   if (tq_set_flags(tq, TQ_ABORT) || tq_dequeue_batch(tq, 0, workbuffs, BATCH_CNT) != -1 ||
+       tq_dequeue_batch(tq, TQ_ABORT, workbuffs, BATCH_CNT) != 0)
+   {
+      printf("Unexpected batch dequeue behavior for an empty ABORTED queue\n");
+      return -1.0;
+   }
+
+   size_t wkcnt = 0;
+   size_t wksum = 0;
+   if (collect_states(tq, &wkcnt, &wksum))
+   {
+      return -1.0;
+   }
+   if (tq_close(tq))
+   {
+      printf("Received unexpected return from tq_close()\n");
+      return -1.0;
+   }
+   return elapsed_ns(&(start), &(end)) / TOT_WRK;
+}
+
+int main(int argc, char **argv)
+{
+   if (check_batch_order())
+   {
+      return -1;
+   }
+   double enqns = time_enqueue(0);
+   double enqbatchns = time_enqueue(1);
+   double deqns = time_dequeue(0);
+   double deqbatchns = time_dequeue(1);
+   if (enqns < 0 || enqbatchns < 0 || deqns < 0 || deqbatchns < 0)
+   {
+      return -1;
+   }
+   printf("%d packages ( qdepth %d, batch %d )\n", TOT_WRK, QDEPTH, BATCH_CNT);
+   printf("tq_enqueue:         %8.1f ns per package\n", enqns);
+   printf("tq_enqueue_batch:   %8.1f ns per package\n", enqbatchns);
+   printf("tq_dequeue:         %8.1f ns per package\n", deqns);
+   printf("tq_dequeue_batch:   %8.1f ns per package\n", deqbatchns);
+
+   printf("Done\n");
+   return 0;
+}
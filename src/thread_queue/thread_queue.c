@@ -1032,6 +1032,179 @@ int tq_dequeue(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuff)
    return depth;
 }
 
+/**
+ * Insert multiple elements of work into the ThreadQueue, under a single acquisition of the queue lock
+ *  Note that, if the queue is full, this call will block until at least one element can be inserted.
+ *  Any remaining elements, beyond the available queue space, will not be inserted.
+ * @param ThreadQueue tq : ThreadQueue in which to insert work
+ * @param TQ_Control_Flags ignore_flags : Indicates which queue states should be bypassed during this operation
+ *                                        (By default, any queue state will result in a failure)
+ * @param void** workbuffs : List of new work elements to be inserted, in order
+ * @param unsigned int count : Number of elements in the 'workbuffs' list
+ * @return int : The number of elements inserted (from the start of the list) on success,
+ *               -1 on failure (such as, if the queue is ABORTED and TQ_ABORT was not specified)
+ */
+int tq_enqueue_batch(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuffs, unsigned int count)
+{
+   if (workbuffs == NULL || count == 0)
+   {
+      LOG(LOG_ERR, "%s received an empty work list to enqueue\n", tq->log_prefix);
+      errno = EINVAL;
+      return -1;
+   }
+
+   pthread_mutex_lock(&tq->qlock);
+
+   // wait for an opening in the queue or for work to be canceled
+   while ((tq->qdepth == tq->max_qdepth) && !(tq->con_flags & ~(ignore_flags)))
+   {
+      LOG(LOG_INFO, "%s master proc is waiting for an opening to batch enqueue into\n", tq->log_prefix);
+      pthread_cond_broadcast(&tq->consumer_resume); // our queue is full!  Make sure all consumers are running
+      pthread_cond_wait(&tq->producer_resume, &tq->qlock);
+      LOG(LOG_INFO, "%s master proc has woken up\n", tq->log_prefix);
+   }
+
+   // check for any oddball conditions which would prevent this work from completing
+   if (tq->con_flags & ~(ignore_flags))
+   {
+      LOG(LOG_ERR, "%s queue state prevents enqueueing!\n", tq->log_prefix);
+      pthread_mutex_unlock(&tq->qlock);
+      errno = EINVAL;
+      return -1;
+   }
+
+   // insert as much of the new work as will fit at the tail of the queue
+   unsigned int prevdepth = tq->qdepth;
+   unsigned int inserted = 0;
+   for (; inserted < count && tq->qdepth < tq->max_qdepth; inserted++)
+   {
+      tq->workpkg[tq->tail] = workbuffs[inserted];
+      tq->tail = (tq->tail + 1) % tq->max_qdepth;
+      tq->qdepth++;
+   }
+   LOG(LOG_INFO, "%s master proc has successfully enqueued %u of %u work packages\n", tq->log_prefix, inserted, count);
+
+   // wake as many additional threads as are needed to process the new work, with a single signal
+   if (tq->cons_pool != NULL)
+   {
+      if (tq->qdepth > tq->cons_pool->act_thrds && tq->cons_pool->act_thrds < tq->cons_pool->num_thrds)
+      {
+         unsigned int wanted = tq->qdepth - tq->cons_pool->act_thrds;
+         LOG(LOG_INFO, "%s master signaling %s %s threads ( running=%u, depth=%u )\n",
+             tq->log_prefix, (wanted > 1 && inserted > 1) ? "all" : "an additional",
+             tq->cons_pool->pname, tq->cons_pool->act_thrds, tq->qdepth);
+         if (wanted > 1 && inserted > 1)
+            pthread_cond_broadcast(&tq->consumer_resume);
+         else
+            pthread_cond_signal(&tq->consumer_resume);
+      }
+   }
+   else if (prevdepth == 0)
+   { // no consumer threads and the queue was empty, signal
+      LOG(LOG_INFO, "%s master blindly signaling a consumer\n", tq->log_prefix);
+      pthread_cond_signal(&tq->consumer_resume);
+   }
+
+   pthread_mutex_unlock(&tq->qlock);
+
+   return (int)inserted;
+}
+
+/**
+ * Retrieve multiple elements of work from the ThreadQueue, under a single acquisition of the queue lock
+ *  Note that, if the Queue is empty and has no state flags set, this call will block.
+ *  However, if the Queue is empty and has any state flags set, this call will return zero.
+ * @param ThreadQueue tq : ThreadQueue from which to retrieve work
+ * @param TQ_Control_Flags ignore_flags : Indicates which queue states should be bypassed during this operation
+ *                                        (By default, only a TQ_FINISHED state will not result in a failure)
+ * @param void** workbuffs : List to be populated with the retrieved work element pointers, in queue order
+ *                           (may be NULL, in which case retrieved elements are simply discarded)
+ * @param unsigned int count : Maximum number of elements to retrieve
+ * @return int : The number of elements retrieved on success ( never more than 'count' ),
+ *               Zero if the queue is both empty and has ANY control flags set (deadlock protection),
+ *               and -1 on failure (such as, if the queue is HALTED or ABORTED, and those flags were not ignored)
+ */
+int tq_dequeue_batch(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuffs, unsigned int count)
+{
+   if (count == 0)
+   {
+      LOG(LOG_ERR, "%s received a zero element count to dequeue\n", tq->log_prefix);
+      errno = EINVAL;
+      return -1;
+   }
+
+   pthread_mutex_lock(&tq->qlock);
+
+   ignore_flags |= TQ_FINISHED; // a FINISHED queue can still be dequeued from
+
+   // wait for a queue element or for any state flags which could prevent work from being created
+   while ((tq->qdepth == 0 && !(tq->con_flags)))
+   {
+      LOG(LOG_INFO, "%s master proc is waiting for elements to batch dequeue\n", tq->log_prefix);
+      pthread_cond_broadcast(&tq->producer_resume); // our queue is empty!  Make sure all producers are running
+      pthread_cond_wait(&tq->consumer_resume, &tq->qlock);
+      LOG(LOG_INFO, "%s master proc has woken up\n", tq->log_prefix);
+   }
+
+   // check for any oddball conditions which should prevent this work
+   if (tq->con_flags & ~(ignore_flags))
+   {
+      LOG(LOG_ERR, "%s queue state prevents dequeueing!\n", tq->log_prefix);
+      pthread_mutex_unlock(&tq->qlock);
+      errno = EINVAL;
+      return -1;
+   }
+
+   // check for an empty queue
+   if (tq->qdepth == 0)
+   {
+      LOG(LOG_INFO, "%s master proc can't dequeue while queue is empty and has flags: %d\n", tq->log_prefix, tq->con_flags);
+      pthread_mutex_unlock(&tq->qlock);
+      return 0;
+   }
+
+   // remove as many work pkgs as are available from the head of the queue
+   unsigned int prevdepth = tq->qdepth;
+   unsigned int removed = 0;
+   for (; removed < count && tq->qdepth; removed++)
+   {
+      if (workbuffs)
+         workbuffs[removed] = tq->workpkg[tq->head];
+      tq->head = (tq->head + 1) % tq->max_qdepth;
+      tq->qdepth--;
+   }
+   LOG(LOG_INFO, "%s master proc has successfully dequeued %u work packages\n", tq->log_prefix, removed);
+
+   // only wake producers if the queue is in a standard state
+   if (!(tq->con_flags))
+   {
+      // wake as many additional threads as are needed to refill the queue, with a single signal
+      if (tq->prod_pool != NULL)
+      {
+         if ((tq->max_qdepth - tq->qdepth) > tq->prod_pool->act_thrds && tq->prod_pool->act_thrds < tq->prod_pool->num_thrds)
+         {
+            unsigned int wanted = (tq->max_qdepth - tq->qdepth) - tq->prod_pool->act_thrds;
+            LOG(LOG_INFO, "%s master signaling %s %s threads ( running=%u, depth=%u )\n",
+                tq->log_prefix, (wanted > 1 && removed > 1) ? "all" : "an additional",
+                tq->prod_pool->pname, tq->prod_pool->act_thrds, tq->qdepth);
+            if (wanted > 1 && removed > 1)
+               pthread_cond_broadcast(&tq->producer_resume);
+            else
+               pthread_cond_signal(&tq->producer_resume);
+         }
+      }
+      else if (prevdepth == tq->max_qdepth)
+      { // no producer threads and the queue was full, signal
+         LOG(LOG_INFO, "%s master blindly signaling a producer\n", tq->log_prefix);
+         pthread_cond_signal(&tq->producer_resume);
+      }
+   }
+
+   pthread_mutex_unlock(&tq->qlock);
+
+   return (int)removed;
+}
+
 /**
  * Determine the current depth (number of enqueued elements) of the given ThreadQueue
  * @param ThreadQueue tq : ThreadQueue for which to determine depth
@@ -174,6 +174,36 @@ int tq_enqueue(ThreadQueue tq, TQ_Control_Flags ignore_flags, void *workbuff);
  */
 int tq_dequeue(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuff);
 
+/**
+ * Insert multiple elements of work into the ThreadQueue, under a single acquisition of the queue lock
+ *  Note that, if the queue is full, this call will block until at least one element can be inserted.
+ *  Any remaining elements, beyond the available queue space, will not be inserted.
+ * @param ThreadQueue tq : ThreadQueue in which to insert work
+ * @param TQ_Control_Flags ignore_flags : Indicates which queue states should be bypassed during this operation
+ *                                        (By default, any queue state will result in a failure)
+ * @param void** workbuffs : List of new work elements to be inserted, in order
+ * @param unsigned int count : Number of elements in the 'workbuffs' list
+ * @return int : The number of elements inserted (from the start of the list) on success,
+ *               -1 on failure (such as, if the queue is ABORTED and TQ_ABORT was not specified)
+ */
+int tq_enqueue_batch(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuffs, unsigned int count);
+
+/**
+ * Retrieve multiple elements of work from the ThreadQueue, under a single acquisition of the queue lock
+ *  Note that, if the Queue is empty and has no state flags set, this call will block.
+ *  However, if the Queue is empty and has any state flags set, this call will return zero.
+ * @param ThreadQueue tq : ThreadQueue from which to retrieve work
+ * @param TQ_Control_Flags ignore_flags : Indicates which queue states should be bypassed during this operation
+ *                                        (By default, only a TQ_FINISHED state will not result in a failure)
+ * @param void** workbuffs : List to be populated with the retrieved work element pointers, in queue order
+ *                           (may be NULL, in which case retrieved elements are simply discarded)
+ * @param unsigned int count : Maximum number of elements to retrieve
+ * @return int : The number of elements retrieved on success ( never more than 'count' ),
+ *               Zero if the queue is both empty and has ANY control flags set (deadlock protection),
+ *               and -1 on failure (such as, if the queue is HALTED or ABORTED, and those flags were not ignored)
+ */
+int tq_dequeue_batch(ThreadQueue tq, TQ_Control_Flags ignore_flags, void **workbuffs, unsigned int count);
+
 /**
  * Determine the current depth (number of enqueued elements) of the given ThreadQueue
  * @param ThreadQueue tq : ThreadQueue for which to determine depth